@@ -24,6 +24,9 @@
 #include <DepthTarget.h>
 #include <CommandList.h>
 #include <Fence.h>
+#include <FramePacer.h>
+#include <FrameLimiter.h>
+#include <FrameStats.h>
 #include <Mesh.h>
 #include <Texture.h>
 #include <InlineUtil.h>
@@ -35,6 +38,14 @@
 #pragma comment( lib, "dxgi.lib" )
 #pragma comment( lib, "dxguid.lib" )
 #pragma comment( lib, "d3dcompiler.lib" )
+#pragma comment( lib, "winmm.lib" )
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+#ifndef APP_FRAME_COUNT
+#define APP_FRAME_COUNT     2       // 同時に処理するフレーム数です(2 または 3).
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////
 // Global Instance
@@ -54,7 +65,9 @@ public:
 	//=========================================================================
 	// public variables.
 	//=========================================================================
-	static const uint32_t FrameCount = 2;   // フレームバッファ数です.
+	static const uint32_t FrameCount = APP_FRAME_COUNT;   // フレームバッファ数です. 同時に処理するフレーム数を兼ねます.
+	static_assert(FrameCount >= 2 && FrameCount <= 3, "APP_FRAME_COUNT must be 2 or 3.");
+	static const uint32_t FrameStatsCount = 256; // フレーム統計のサンプル数です.
 
 	//=========================================================================
 	// public methods.
@@ -106,6 +119,7 @@ protected:
 	DescriptorPool*				m_pPool[POOL_COUNT];         // ディスクリプタプールです.
 	CommandList                 m_CommandList;               // コマンドリストです.
 	Fence                       m_Fence;                     // フェンスです.
+	FramePacer                  m_FramePacer;                // フレームごとのフェンス値です.
 	uint32_t                    m_FrameIndex;                // フレーム番号です.
 	D3D12_VIEWPORT              m_Viewport;                  // ビューポートです.
 	D3D12_RECT                  m_Scissor;                   // シザー矩形です.
@@ -115,10 +129,19 @@ protected:
 	CommandList                 m_ImGuiCommandList;          // ImGui用のコマンドリストです.
 	DescriptorHandle*			m_ImGuiHandle;
 
+	SystemClock                 m_Clock;                     // フレームペーシング用のクロックです.
+	FrameLimiter                m_FrameLimiter;              // フレームレート制限です.
+	FrameStats                  m_FrameStats;                // フレーム時間(ミリ秒)の統計です.
+	FrameStats                  m_PresentStats;              // Present() にかかった時間(ミリ秒)の統計です.
+	FrameStats                  m_FrameWaitStats;            // フレーム開始前の待機時間(ミリ秒)の統計です.
+	uint32_t                    m_SyncInterval;              // 垂直同期の間隔です.
+
 	//=========================================================================
 	// protected methods.
 	//=========================================================================
 	void Present(uint32_t interval);
+	void SetMaxFrameLatency(uint32_t latency);
+	uint32_t GetMaxFrameLatency() const;
 	bool  IsSupportHDR() const;
 	float GetMaxLuminance() const;
 	float GetMinLuminance() const;
@@ -151,6 +174,9 @@ private:
 	bool    m_SupportHDR;   // HDRディスプレイをサポートしているかどうか?
 	float   m_MaxLuminance; // ディスプレイの最大輝度値.
 	float   m_MinLuminance; // ディスプレイの裁量輝度値.
+	HANDLE  m_FrameLatencyWaitable; // スワップチェインが次のフレームを受け付けるとシグナル状態になります.
+	uint32_t m_MaxFrameLatency;     // 最大フレームレイテンシーです.
+	double  m_FrameStartMicroSec;   // 前のフレームの開始時刻です.
 
 	//=========================================================================
 	// private methods.
@@ -166,6 +192,7 @@ private:
 	bool InitD3D();
 	void TermD3D();
 	void MainLoop();
+	void WaitFrame();
 	void CheckSupportHDR();
 
 protected:
@@ -0,0 +1,116 @@
+﻿//-----------------------------------------------------------------------------
+// File : CascadedShadow.h
+// Desc : Cascaded Shadow Map Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <DirectXMath.h>
+#include <cstdint>
+
+///////////////////////////////////////////////////////////////////////////////
+// CascadedShadow class
+///////////////////////////////////////////////////////////////////////////////
+class CascadedShadow
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const uint32_t MaxCascadeCount = 4;     //!< 最大カスケード数です.
+	static const uint32_t AtlasTileCount  = 2;     //!< アトラスの1辺に並べるタイル数です.
+
+	///////////////////////////////////////////////////////////////////////////
+	// Desc structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Desc
+	{
+		uint32_t    CascadeCount;       //!< カスケード数です(1 ～ MaxCascadeCount).
+		float       Lambda;             //!< 対数分割と線形分割の混合比です(1 で対数分割).
+		float       NearClip;           //!< カメラのニアクリップです.
+		float       FarClip;            //!< 影を落とす最大距離です.
+		uint32_t    TileSize;           //!< 1カスケードあたりのシャドウマップサイズです.
+		float       CasterDistance;     //!< 分割範囲の外からも影を落とせるように, ライト側へ伸ばす距離です.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// Cascade structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Cascade
+	{
+		DirectX::XMFLOAT4X4 View;           //!< ライトのビュー行列です.
+		DirectX::XMFLOAT4X4 Proj;           //!< テクセルに揃えた正射影行列です.
+		DirectX::XMFLOAT4X4 ViewProj;       //!< 行ベクトル形式(v * M)のビュー射影行列です.
+		DirectX::XMFLOAT3   Center;         //!< 分割範囲を囲む球の中心(ワールド空間)です.
+		float               Radius;         //!< 分割範囲を囲む球の半径です.
+		float               SplitNear;      //!< 分割範囲の手前の奥行きです.
+		float               SplitFar;       //!< 分割範囲の奥の奥行きです.
+		float               TexelSize;      //!< 1テクセルのワールド空間での大きさです.
+	};
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      実用分割法で視錐台の分割位置を求めます.
+	//!
+	//! @param[in]      count       カスケード数です.
+	//! @param[in]      nearClip    ニアクリップです.
+	//! @param[in]      farClip     ファークリップです.
+	//! @param[in]      lambda      対数分割と線形分割の混合比です.
+	//! @param[out]     pSplits     分割位置の格納先です(count + 1 個, 先頭は nearClip, 末尾は farClip).
+	//-------------------------------------------------------------------------
+	static void ComputeSplits(uint32_t count, float nearClip, float farClip, float lambda, float* pSplits);
+
+	//-------------------------------------------------------------------------
+	//! @brief      カメラの視錐台の分割範囲ごとにライトのビュー射影行列を求めます.
+	//!
+	//! @param[in]      view        カメラのビュー行列です.
+	//! @param[in]      proj        カメラの透視投影行列です.
+	//! @param[in]      lightDir    ライトへ向かう方向です.
+	//! @param[in]      desc        設定です.
+	//! @param[out]     pCascades   カスケードの格納先です(desc.CascadeCount 個).
+	//! @retval true    計算に成功.
+	//! @retval false   計算に失敗.
+	//! @note       分割範囲は半径がカメラの向きに依存しない球で囲み, 原点をテクセルに揃えるので,
+	//!             カメラを回転・移動しても影の輪郭が揺れません.
+	//-------------------------------------------------------------------------
+	static bool Compute
+	(
+		const DirectX::XMFLOAT4X4&  view,
+		const DirectX::XMFLOAT4X4&  proj,
+		const DirectX::XMFLOAT3&    lightDir,
+		const Desc&                 desc,
+		Cascade*                    pCascades
+	);
+
+	//-------------------------------------------------------------------------
+	//! @brief      アトラス上のタイル位置を取得します.
+	//!
+	//! @param[in]      index       カスケード番号です.
+	//! @param[out]     x           タイルの列の格納先です.
+	//! @param[out]     y           タイルの行の格納先です.
+	//-------------------------------------------------------------------------
+	static void GetTile(uint32_t index, uint32_t& x, uint32_t& y);
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	/* NOTHING */
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	CascadedShadow() = delete;
+	~CascadedShadow() = delete;
+};
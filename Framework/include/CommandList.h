@@ -66,6 +66,15 @@ public:
 	//-------------------------------------------------------------------------
 	ID3D12GraphicsCommandList* Reset();
 
+	//-------------------------------------------------------------------------
+	//! @brief      指定したアロケータでリセット処理を行ったコマンドリストを取得します.
+	//!
+	//! @param[in]      index       アロケータ番号です. フレーム番号を指定します.
+	//! @return     リセット処理を行ったコマンドリストを返却します.
+	//! @note       アロケータ番号のフレームがGPUで実行済みになってから呼び出します.
+	//-------------------------------------------------------------------------
+	ID3D12GraphicsCommandList* Reset(uint32_t index);
+
 private:
 	//=========================================================================
 	// private variables.
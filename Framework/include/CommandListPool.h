@@ -0,0 +1,123 @@
+﻿//-----------------------------------------------------------------------------
+// File : CommandListPool.h
+// Desc : Per Thread Command List Pool Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <d3d12.h>
+#include <ComPtr.h>
+#include <cstdint>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// CommandListPool class
+///////////////////////////////////////////////////////////////////////////////
+class CommandListPool
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	/* NOTHING */
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	CommandListPool();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~CommandListPool();
+
+	//-------------------------------------------------------------------------
+	//! @brief      初期化処理を行います.
+	//!
+	//! @param[in]      pDevice         デバイスです.
+	//! @param[in]      type            コマンドリストタイプです.
+	//! @param[in]      frameCount      フレーム数です.
+	//! @param[in]      workerCount     記録するスレッド数です.
+	//! @retval true    初期化に成功.
+	//! @retval false   初期化に失敗.
+	//-------------------------------------------------------------------------
+	bool Init(ID3D12Device* pDevice, D3D12_COMMAND_LIST_TYPE type, uint32_t frameCount, uint32_t workerCount);
+
+	//-------------------------------------------------------------------------
+	//! @brief      終了処理を行います.
+	//-------------------------------------------------------------------------
+	void Term();
+
+	//-------------------------------------------------------------------------
+	//! @brief      フレームを開始します.
+	//!
+	//! @param[in]      frameIndex      フレーム番号です.
+	//! @note       同じフレーム番号のアロケータをリセットするので, GPUの実行完了後に呼び出します.
+	//-------------------------------------------------------------------------
+	void BeginFrame(uint32_t frameIndex);
+
+	//-------------------------------------------------------------------------
+	//! @brief      リセット処理を行ったコマンドリストを取得します.
+	//!
+	//! @param[in]      worker          呼び出し元のスレッド番号です.
+	//! @return     リセット処理を行ったコマンドリストを返却します. 失敗した場合は nullptr です.
+	//! @note       同じスレッド番号を複数のスレッドから同時に使用しないでください.
+	//!             記録後は呼び出し元で Close() します.
+	//-------------------------------------------------------------------------
+	ID3D12GraphicsCommandList* Acquire(uint32_t worker);
+
+	//-------------------------------------------------------------------------
+	//! @brief      記録するスレッド数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetWorkerCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      現在のフレームで取得したコマンドリスト数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetUsedCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      生成済みのコマンドリスト数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetListCount() const;
+
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// Slot structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Slot
+	{
+		ComPtr<ID3D12CommandAllocator>                  pAllocator;     //!< コマンドアロケータです.
+		std::vector<ComPtr<ID3D12GraphicsCommandList>>  pLists;         //!< コマンドリストです.
+		uint32_t                                        Used;           //!< 取得済みのコマンドリスト数です.
+		uint8_t                                         Padding[52];    //!< 他のスレッドの Used と同じキャッシュラインに載らないようにします.
+	};
+
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	ComPtr<ID3D12Device>    m_pDevice;          //!< デバイスです.
+	D3D12_COMMAND_LIST_TYPE m_Type;             //!< コマンドリストタイプです.
+	std::vector<Slot>       m_Slots;            //!< [フレーム][スレッド] のスロットです.
+	uint32_t                m_FrameCount;       //!< フレーム数です.
+	uint32_t                m_WorkerCount;      //!< 記録するスレッド数です.
+	uint32_t                m_FrameIndex;       //!< 現在のフレーム番号です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	CommandListPool (const CommandListPool&) = delete;
+	void operator = (const CommandListPool&) = delete;
+};
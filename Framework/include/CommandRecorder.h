@@ -0,0 +1,249 @@
+﻿//-----------------------------------------------------------------------------
+// File : CommandRecorder.h
+// Desc : Parallel Command Recording Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <JobSystem.h>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+
+///////////////////////////////////////////////////////////////////////////////
+// RecordSlot structure
+///////////////////////////////////////////////////////////////////////////////
+struct RecordSlot
+{
+	uint32_t    Pass;       //!< パス番号です.
+	uint32_t    Chunk;      //!< パス内の分割番号です.
+	uint32_t    Begin;      //!< 記録するアイテムの先頭です.
+	uint32_t    End;        //!< 記録するアイテムの終端(含まない)です.
+	uint32_t    Worker;     //!< 記録したスレッド番号です.
+	double      MicroSec;   //!< 記録にかかった時間(マイクロ秒)です.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// CommandRecorder class
+///////////////////////////////////////////////////////////////////////////////
+template<typename ListType>
+class CommandRecorder
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	using RecordFunc  = std::function<void(ListType* pList, const RecordSlot& slot)>;
+	using AcquireFunc = std::function<ListType*(uint32_t worker)>;
+	using CloseFunc   = std::function<void(ListType* pList)>;
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	CommandRecorder()
+	{ /* DO_NOTHING */ }
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~CommandRecorder()
+	{ /* DO_NOTHING */ }
+
+	//-------------------------------------------------------------------------
+	//! @brief      登録したパスを全て破棄します.
+	//-------------------------------------------------------------------------
+	void Clear()
+	{
+		m_Passes.clear();
+		m_Slots .clear();
+		m_Lists .clear();
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      1つのコマンドリストに記録するパスを追加します.
+	//!
+	//! @param[in]      name        名前です.
+	//! @param[in]      func        記録する関数です.
+	//! @return     パス番号を返却します.
+	//-------------------------------------------------------------------------
+	uint32_t AddPass(const char* name, RecordFunc func)
+	{
+		auto pass = AddPassInfo(name, func);
+		AddSlot(pass, 0, 0, 0);
+		return pass;
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      アイテムを分割して複数のコマンドリストに記録するパスを追加します.
+	//!
+	//! @param[in]      name        名前です.
+	//! @param[in]      count       アイテム数です. 0 の場合は何も記録しません.
+	//! @param[in]      minItems    1つのコマンドリストに記録する最小アイテム数です.
+	//! @param[in]      maxChunks   最大分割数です.
+	//! @param[in]      func        [slot.Begin, slot.End) を記録する関数です.
+	//! @return     パス番号を返却します.
+	//-------------------------------------------------------------------------
+	uint32_t AddChunkedPass(const char* name, uint32_t count, uint32_t minItems, uint32_t maxChunks, RecordFunc func)
+	{
+		auto pass   = AddPassInfo(name, func);
+		auto chunks = GetChunkCount(count, minItems, maxChunks);
+		for (auto i = 0u; i < chunks; ++i)
+		{
+			// 端数を前から順に1つずつ割り振ります.
+			auto begin = uint32_t(uint64_t(count) * i       / chunks);
+			auto end   = uint32_t(uint64_t(count) * (i + 1) / chunks);
+			AddSlot(pass, i, begin, end);
+		}
+		return pass;
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      全てのパスを記録します.
+	//!
+	//! @param[in]      pJobs       ジョブシステムです. nullptr の場合は呼び出し元で順に記録します.
+	//! @param[in]      acquire     記録可能な状態のリストを取得する関数です.
+	//! @param[in]      close       記録を終えたリストを閉じる関数です.
+	//! @retval true    全てのリストを取得できました.
+	//! @retval false   取得できなかったリストがあります.
+	//! @note       どのスレッドが記録しても, GetLists() は登録順(パス順・分割順)に並びます.
+	//!             ジョブシステムを初期化したスレッドから呼び出してください.
+	//-------------------------------------------------------------------------
+	bool Record(JobSystem* pJobs, const AcquireFunc& acquire, const CloseFunc& close)
+	{
+		m_Lists.assign(m_Slots.size(), nullptr);
+
+		auto record = [&](uint32_t begin, uint32_t end)
+		{
+			auto worker = (pJobs != nullptr) ? pJobs->GetWorkerIndex() : 0u;
+			for (auto i = begin; i < end; ++i)
+			{
+				auto& slot  = m_Slots[i];
+				auto  pList = acquire(worker);
+				if (pList == nullptr)
+				{
+					continue;
+				}
+
+				auto t0 = std::chrono::high_resolution_clock::now();
+				m_Passes[slot.Pass].Func(pList, slot);
+				close(pList);
+				auto t1 = std::chrono::high_resolution_clock::now();
+
+				slot.Worker   = worker;
+				slot.MicroSec = std::chrono::duration<double, std::micro>(t1 - t0).count();
+				m_Lists[i]    = pList;
+			}
+		};
+
+		if (pJobs != nullptr)
+		{
+			pJobs->ParallelFor(uint32_t(m_Slots.size()), 1, record);
+		}
+		else
+		{
+			record(0, uint32_t(m_Slots.size()));
+		}
+
+		return std::find(m_Lists.begin(), m_Lists.end(), nullptr) == m_Lists.end();
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      記録したリストを提出順に取得します.
+	//-------------------------------------------------------------------------
+	const std::vector<ListType*>& GetLists() const
+	{ return m_Lists; }
+
+	//-------------------------------------------------------------------------
+	//! @brief      記録単位を提出順に取得します.
+	//-------------------------------------------------------------------------
+	const std::vector<RecordSlot>& GetSlots() const
+	{ return m_Slots; }
+
+	//-------------------------------------------------------------------------
+	//! @brief      パス名を取得します.
+	//-------------------------------------------------------------------------
+	const char* GetPassName(uint32_t pass) const
+	{ return (pass < m_Passes.size()) ? m_Passes[pass].Name.c_str() : ""; }
+
+	//-------------------------------------------------------------------------
+	//! @brief      パス数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetPassCount() const
+	{ return uint32_t(m_Passes.size()); }
+
+	//-------------------------------------------------------------------------
+	//! @brief      分割数を求めます.
+	//!
+	//! @param[in]      count       アイテム数です.
+	//! @param[in]      minItems    1つのコマンドリストに記録する最小アイテム数です.
+	//! @param[in]      maxChunks   最大分割数です.
+	//! @return     1つあたり minItems 以上になる, maxChunks 以下の分割数を返却します.
+	//-------------------------------------------------------------------------
+	static uint32_t GetChunkCount(uint32_t count, uint32_t minItems, uint32_t maxChunks)
+	{
+		if (count == 0)
+		{ return 0; }
+
+		auto chunks = count / std::max(1u, minItems);
+		return std::max(1u, std::min(chunks, std::max(1u, maxChunks)));
+	}
+
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// PassInfo structure
+	///////////////////////////////////////////////////////////////////////////
+	struct PassInfo
+	{
+		std::string     Name;   //!< 名前です.
+		RecordFunc      Func;   //!< 記録する関数です.
+	};
+
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	std::vector<PassInfo>   m_Passes;   //!< 登録順のパスです.
+	std::vector<RecordSlot> m_Slots;    //!< 提出順の記録単位です.
+	std::vector<ListType*>  m_Lists;    //!< 記録単位ごとのリストです.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	uint32_t AddPassInfo(const char* name, RecordFunc& func)
+	{
+		PassInfo info;
+		info.Name = (name != nullptr) ? name : "";
+		info.Func = std::move(func);
+		m_Passes.push_back(std::move(info));
+		return uint32_t(m_Passes.size() - 1);
+	}
+
+	void AddSlot(uint32_t pass, uint32_t chunk, uint32_t begin, uint32_t end)
+	{
+		RecordSlot slot;
+		slot.Pass     = pass;
+		slot.Chunk    = chunk;
+		slot.Begin    = begin;
+		slot.End      = end;
+		slot.Worker   = 0;
+		slot.MicroSec = 0.0;
+		m_Slots.push_back(slot);
+	}
+
+	CommandRecorder (const CommandRecorder&) = delete;
+	void operator = (const CommandRecorder&) = delete;
+};
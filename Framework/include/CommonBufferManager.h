@@ -7,6 +7,7 @@
 #include <RootSignature.h>
 #include <RootSignature.h>
 #include <CommonRTVManager.h>
+#include <CascadedShadow.h>
 
 using namespace DirectX::SimpleMath;
 
@@ -16,7 +17,7 @@ namespace CommonCb {
 	///////////////////////////////////////////////////////////////////////////////
 	struct alignas(256) CbMesh
 	{
-		Matrix   World;      //!< [hsł.
+		Matrix   World;      //!< ワールド行列です.
 	};
 
 	///////////////////////////////////////////////////////////////////////////////
@@ -24,8 +25,8 @@ namespace CommonCb {
 	///////////////////////////////////////////////////////////////////////////////
 	struct alignas(256) CbTransform
 	{
-		Matrix   View;       //!< r[sł.
-		Matrix   Proj;       //!< ˉesł.
+		Matrix   View;       //!< ビュー行列です.
+		Matrix   Proj;       //!< 射影行列です.
 	};
 
 	///////////////////////////////////////////////////////////////////////////////
@@ -33,15 +34,22 @@ namespace CommonCb {
 	///////////////////////////////////////////////////////////////////////////////
 	struct alignas(256) CbLight
 	{
-		float		TextureSize;		//!< L[u}bvTCYł.
-		float		MipCount;			//!< ~bvł.
-		float		LightIntensity;		//!< Cgxł.
-		float		Padding0;			//!< pfBO.
-		Vector3		LightDirection;		//!< fBNViCg̕.
-		float		Padding1;			//!< pfBO.
-		Matrix		LightVP;			//!< fBNViCgViewProjection
+		float		TextureSize;		//!< キューブマップサイズです.
+		float		MipCount;			//!< ミップ数です.
+		float		LightIntensity;		//!< ライト強度です.
+		float		Padding0;			//!< パディング.
+		Vector3		LightDirection;		//!< ディレクショナルライトの方向.
+		float		Padding1;			//!< パディング.
+		Matrix		LightVP;			//!< 最も手前のカスケードのViewProjection.
 		float		ShadowBias;			//!< Bias
 		float		ShadowStrength;		//!< Strength
+		float		EnableIrradianceSH;	//!< ディフューズIBLに球面調和関数を使うかどうか.
+		float		Padding2;			//!< パディング.
+		Vector4		IrradianceSH[9];	//!< 放射照度 / π の球面調和関数の係数(xyz = RGB)です.
+		Matrix		CascadeVP[CascadedShadow::MaxCascadeCount];	//!< カスケードごとのViewProjectionです.
+		Vector4		CascadeSplits;		//!< カスケードごとの奥側の分割位置(カメラからの奥行き)です.
+		Vector3		CameraForward;		//!< 奥行きを求めるカメラの前方向です.
+		float		CascadeCount;		//!< カスケード数です.
 	};
 
 	///////////////////////////////////////////////////////////////////////////////
@@ -49,7 +57,7 @@ namespace CommonCb {
 	///////////////////////////////////////////////////////////////////////////////
 	struct alignas(256) CbCommon
 	{
-		Vector3  CameraPosition;    //!< Jʒuł.
+		Vector3  CameraPosition;    //!< カメラ位置です.
 		float	 Padding0;
 		Vector2  FogArea;
 		float	 Padding1;
@@ -78,6 +86,12 @@ namespace CommonCb {
 		Vector4  Param13;
 		Vector4  Param14;
 		Vector4  Param15;
+
+		// バインドレス描画用のテクスチャ番号(リソースヒープ先頭からのインデックス).
+		uint32_t BaseColorMap;		//!< ベースカラーマップです.
+		uint32_t MetallicMap;		//!< メタリックマップです.
+		uint32_t RoughnessMap;		//!< ラフネスマップです.
+		uint32_t NormalMap;			//!< 法線マップです.
 	};
 } // namespace
 
@@ -86,7 +100,7 @@ public:
 	bool Init(ComPtr<ID3D12Device> pDevice, DescriptorPool* pool, float width, float height);
 
 	
-	void UpdateShadowBuffer(int frameindex, Vector3 direction,  float shadowLightPosDist, Vector4& OrthographParam);
+	void UpdateShadowBuffer(int frameindex, const CascadedShadow::Cascade* pCascades, uint32_t cascadeCount, const Vector3& cameraForward);
 	void UpdateCommonBuffer(int frameindex, CommonCb::CbCommon& cb);
 	void UpdateLightBuffer(int frameindex, CommonCb::CbLight& cb);
 	void UpdateViewProjMatrix(int frameindex, CommonCb::CbTransform& cbt);
@@ -99,11 +113,11 @@ public:
 	CommonCb::CbCommon* GetCommonProperty(int frameindex);
 	void SetCommonProperty(int frameindex, CommonCb::CbCommon& prop);
 
-	VertexBuffer        m_QuadVB;                            //!< _obt@ł.
-	ConstantBuffer      m_LightCB[App::FrameCount];          //!< Cgobt@ł.
-	ConstantBuffer      m_CommonCB[App::FrameCount];         //!< ʃobt@ł.
-	ConstantBuffer      m_TransformCB[App::FrameCount];      //!< ϊpobt@ł.
-	ConstantBuffer		m_MeshCB[App::FrameCount];           //!< bVpobt@ł.
+	VertexBuffer        m_QuadVB;                            //!< 頂点バッファです.
+	ConstantBuffer      m_LightCB[App::FrameCount];          //!< ライトバッファです.
+	ConstantBuffer      m_CommonCB[App::FrameCount];         //!< 一般バッファです.
+	ConstantBuffer      m_TransformCB[App::FrameCount];      //!< 変換用バッファです.
+	ConstantBuffer		m_MeshCB[App::FrameCount];           //!< メッシュ用バッファです.
 	
 	CommonRTManager*	m_RTManager;
 
@@ -5,26 +5,14 @@
 class CommonRTManager {
 public:
 
-	ColorTarget                     m_SceneColorTarget;             //!< V[p_[^[Qbg
-	ColorTarget                     m_TempColorTarget;				//!<  ꎞIɎgpꍇ̃^[Qbg
-	ColorTarget                     m_NormalTarget;					//!<  NormalMap
-	
+	DepthTarget                     m_SceneShadowTarget;			//!< シャドウ用深度ターゲット(カスケードを並べたアトラス)
+	DepthTarget                     m_StaticShadowTarget;			//!< 静的な遮蔽物だけを描いたアトラスのキャッシュ
 
+	// シーン用・ポストプロセス用のターゲットはレンダーグラフで管理する.
 
-	DepthTarget                     m_SceneDepthTarget;				//!< V[p[x^[Qbg
-	DepthTarget                     m_PreDepthTarget;				//!< PreDepth
-
-	DepthTarget                     m_SceneShadowTarget;			//!< VhEp[x^[Qbg
-
-	ColorTarget                     m_BloomColorTarget[4];             //!<  Bloomp
-
-
-	bool Init(ComPtr<ID3D12Device> pDevice, DescriptorPool* rtvpool, DescriptorPool* respool, DescriptorPool* dsvpool, uint32_t width, uint32_t height);
+	bool Init(ComPtr<ID3D12Device> pDevice, DescriptorPool* rtvpool, DescriptorPool* respool, DescriptorPool* dsvpool, uint32_t width, uint32_t height, uint32_t shadowSize);
 
 	void Term();
 private:
-	bool CreateColorTarget(ComPtr<ID3D12Device> pDevice, DescriptorPool* rtvpool, DescriptorPool* respool, uint32_t width, uint32_t height);
-	bool CreateTempTarget(ColorTarget& temp, ComPtr<ID3D12Device> pDevice, DescriptorPool* rtvpool, DescriptorPool* respool, uint32_t width, uint32_t height);
-	bool CreateDepthTarget(ComPtr<ID3D12Device> pDevice, DescriptorPool* dsvpool, DescriptorPool* respool, uint32_t width, uint32_t height);
-	bool CreateShadowTarget(ComPtr<ID3D12Device> pDevice, DescriptorPool* dsvpool, DescriptorPool* respool, uint32_t width, uint32_t height);
+	bool CreateShadowTarget(ComPtr<ID3D12Device> pDevice, DescriptorPool* dsvpool, DescriptorPool* respool, uint32_t size);
 };
\ No newline at end of file
@@ -4,6 +4,6 @@ class Component {
 public:
     virtual ~Component() {}
 
-    // \bh
+    // メソッド
     virtual void Update(float deltaTime) = 0;
 };
\ No newline at end of file
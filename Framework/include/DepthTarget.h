@@ -72,6 +72,29 @@ public:
 	
 	);
 
+	//-------------------------------------------------------------------------
+	//! @brief      ヒープ内に配置して初期化処理を行います.
+	//!
+	//! @param[in]      pHeap       配置先のヒープです. nullptr の場合は Init() と同じです.
+	//! @param[in]      heapOffset  ヒープ内のオフセットです.
+	//! @retval true    初期化に成功.
+	//! @retval false   初期化に失敗.
+	//! @note       同じメモリを共有するリソースは, 使用開始時にエイリアシングバリアと初期化が必要です.
+	//-------------------------------------------------------------------------
+	bool InitPlaced(
+		ID3D12Device* pDevice,
+		DescriptorPool* pPoolDSV,
+		DescriptorPool* pPoolSRV,
+		uint32_t        width,
+		uint32_t        height,
+		DXGI_FORMAT     format,
+		float           clearDepth,
+		uint8_t         clearStencil,
+		ID3D12Heap*     pHeap,
+		UINT64          heapOffset,
+		D3D12_RESOURCE_STATES initialResourceState
+	);
+
 	//-------------------------------------------------------------------------
 	//! @brief      終了処理を行います.
 	//-------------------------------------------------------------------------
@@ -126,6 +126,14 @@ public:
 	//-------------------------------------------------------------------------
 	ID3D12DescriptorHeap* const GetHeap() const;
 
+	//-------------------------------------------------------------------------
+	//! @brief      ヒープ先頭からのディスクリプタ番号を取得します.
+	//!
+	//! @param[in]      handle      このプールから割り当てたGPUディスクリプタハンドルです.
+	//! @return     シェーダからディスクリプタ配列として参照する際のインデックスを返却します.
+	//-------------------------------------------------------------------------
+	uint32_t GetHandleIndex(D3D12_GPU_DESCRIPTOR_HANDLE handle) const;
+
 private:
 	//=========================================================================
 	// private varaibles.
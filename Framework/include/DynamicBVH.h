@@ -0,0 +1,214 @@
+﻿//-----------------------------------------------------------------------------
+// File : DynamicBVH.h
+// Desc : Dynamic Bounding Volume Hierarchy Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <FrustumCuller.h>
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+#include <utility>
+
+///////////////////////////////////////////////////////////////////////////////
+// DynamicBVH class
+///////////////////////////////////////////////////////////////////////////////
+class DynamicBVH
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	///////////////////////////////////////////////////////////////////////////
+	// Node structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Node
+	{
+		DirectX::XMFLOAT3   Min;        //!< AABBの最小値です.
+		int32_t             Parent;     //!< 親ノードです(未使用時は空きリストの次のノード).
+		DirectX::XMFLOAT3   Max;        //!< AABBの最大値です.
+		int32_t             Height;     //!< 葉からの高さです(葉は0, 未使用は-1).
+		int32_t             Child[2];   //!< 子ノードです(葉は NullNode).
+		uint32_t            UserData;   //!< 葉に関連付けた値です.
+		uint32_t            Reserved;   //!< 予約領域です.
+	};
+
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const int32_t NullNode = -1;     //!< 無効なノード番号です.
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	DynamicBVH();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~DynamicBVH();
+
+	//-------------------------------------------------------------------------
+	//! @brief      全てのノードを破棄します.
+	//-------------------------------------------------------------------------
+	void Clear();
+
+	//-------------------------------------------------------------------------
+	//! @brief      ノード領域を予約します.
+	//!
+	//! @param[in]      proxyCount  登録する予定の葉の数です.
+	//-------------------------------------------------------------------------
+	void Reserve(size_t proxyCount);
+
+	//-------------------------------------------------------------------------
+	//! @brief      葉の AABB を膨らませる量を設定します.
+	//!
+	//! @param[in]      margin      膨らませる量です. 移動が小さい間は木を更新しません.
+	//-------------------------------------------------------------------------
+	void SetMargin(float margin);
+
+	//-------------------------------------------------------------------------
+	//! @brief      葉を追加します.
+	//!
+	//! @param[in]      boundsMin   ワールド空間のAABBの最小値です.
+	//! @param[in]      boundsMax   ワールド空間のAABBの最大値です.
+	//! @param[in]      userData    葉に関連付ける値です.
+	//! @param[in]      insert      false の場合は木に繋がず, 次の Rebuild() でまとめて構築します.
+	//! @return     葉のノード番号を返却します. 以降の操作ではこの番号を使用します.
+	//! @note       insert が true の場合は SAH コストが最小となる兄弟を探して挿入します.
+	//-------------------------------------------------------------------------
+	int32_t CreateProxy(
+		const DirectX::XMFLOAT3&    boundsMin,
+		const DirectX::XMFLOAT3&    boundsMax,
+		uint32_t                    userData,
+		bool                        insert = true);
+
+	//-------------------------------------------------------------------------
+	//! @brief      葉を削除します.
+	//!
+	//! @param[in]      proxy       CreateProxy() で取得したノード番号です.
+	//-------------------------------------------------------------------------
+	void DestroyProxy(int32_t proxy);
+
+	//-------------------------------------------------------------------------
+	//! @brief      葉の AABB を更新します.
+	//!
+	//! @param[in]      proxy       CreateProxy() で取得したノード番号です.
+	//! @param[in]      boundsMin   ワールド空間のAABBの最小値です.
+	//! @param[in]      boundsMax   ワールド空間のAABBの最大値です.
+	//! @retval true    木を更新しました.
+	//! @retval false   膨らませた AABB に収まっていたため何もしませんでした.
+	//! @note       祖先をたどって AABB を再計算し, 各ノードで回転を試みます.
+	//!             コストは移動した葉の数 x 木の深さに比例します.
+	//-------------------------------------------------------------------------
+	bool MoveProxy(
+		int32_t                     proxy,
+		const DirectX::XMFLOAT3&    boundsMin,
+		const DirectX::XMFLOAT3&    boundsMax);
+
+	//-------------------------------------------------------------------------
+	//! @brief      全ての葉から SAH(ビン分割)で木を構築し直します.
+	//-------------------------------------------------------------------------
+	void Rebuild();
+
+	//-------------------------------------------------------------------------
+	//! @brief      視錐台と交差する葉を列挙します.
+	//!
+	//! @param[in]      frustum     視錐台です.
+	//! @param[out]     userData    交差した葉の値の格納先です.
+	//! @return     走査したノード数を返却します.
+	//! @note       完全に内側にある部分木は判定せずに全ての葉を列挙します.
+	//-------------------------------------------------------------------------
+	uint32_t Query(const Frustum& frustum, std::vector<uint32_t>& userData) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      レイと最初に交差する葉を探します.
+	//!
+	//! @param[in]      origin      レイの始点です.
+	//! @param[in]      direction   レイの方向です.
+	//! @param[in]      maxDistance レイの最大距離です.
+	//! @param[out]     pUserData   交差した葉の値の格納先です.
+	//! @param[out]     pDistance   交差位置までの距離の格納先です.
+	//! @retval true    交差しました.
+	//! @retval false   交差しませんでした.
+	//-------------------------------------------------------------------------
+	bool RayCast(
+		const DirectX::XMFLOAT3&    origin,
+		const DirectX::XMFLOAT3&    direction,
+		float                       maxDistance,
+		uint32_t*                   pUserData,
+		float*                      pDistance) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      葉の数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetProxyCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      使用中のノード数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetNodeCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      木の高さを取得します.
+	//-------------------------------------------------------------------------
+	int32_t GetHeight() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      SAH コスト(内部ノードの表面積の和 / ルートの表面積)を計算します.
+	//-------------------------------------------------------------------------
+	float ComputeCost() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      ノードを取得します.
+	//-------------------------------------------------------------------------
+	const Node& GetNode(int32_t index) const;
+
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// BuildEntry structure
+	///////////////////////////////////////////////////////////////////////////
+	struct BuildEntry
+	{
+		int32_t             Leaf;       //!< 葉のノード番号です.
+		DirectX::XMFLOAT3   Centroid;   //!< AABBの中心です.
+	};
+
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	std::vector<Node>                       m_Nodes;        //!< ノードです.
+	std::vector<BuildEntry>                 m_BuildEntries; //!< 構築用の作業領域です.
+	std::vector<std::pair<int32_t, float>>  m_CostStack;    //!< 挿入先探索用の作業領域です.
+	mutable std::vector<int32_t>            m_Stack;        //!< 走査用の作業領域です.
+	int32_t                                 m_Root;         //!< ルートノードです.
+	int32_t                                 m_FreeList;     //!< 空きノードの先頭です.
+	uint32_t                                m_NodeCount;    //!< 使用中のノード数です.
+	uint32_t                                m_ProxyCount;   //!< 葉の数です.
+	float                                   m_Margin;       //!< 葉の AABB を膨らませる量です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	int32_t AllocNode();
+	void    FreeNode(int32_t index);
+	void    InsertLeaf(int32_t leaf);
+	void    RemoveLeaf(int32_t leaf);
+	int32_t FindBestSibling(int32_t leaf);
+	void    Refit(int32_t index);
+	void    Rotate(int32_t index);
+	int32_t BuildRange(uint32_t begin, uint32_t end);
+
+	DynamicBVH      (const DynamicBVH&) = delete;
+	void operator = (const DynamicBVH&) = delete;
+};
@@ -0,0 +1,447 @@
+﻿//-----------------------------------------------------------------------------
+// File : EntityRegistry.h
+// Desc : Sparse Set Entity Component Storage Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cassert>
+#include <vector>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <initializer_list>
+
+//-----------------------------------------------------------------------------
+// Type Definitions.
+//-----------------------------------------------------------------------------
+using Entity = uint32_t;    //!< 下位24bitが番号, 上位8bitが世代のエンティティです.
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const Entity     NullEntity          = 0xffffffff;   //!< 無効なエンティティです.
+static const uint32_t   EntityIndexBits     = 24;           //!< 番号のビット数です.
+static const uint32_t   EntityIndexMask     = (1u << EntityIndexBits) - 1;
+static const uint32_t   EntityGenerationMask= 0xff;
+
+//-----------------------------------------------------------------------------
+//! @brief      エンティティの番号を取得します.
+//-----------------------------------------------------------------------------
+inline uint32_t GetEntityIndex(Entity entity)
+{
+	return entity & EntityIndexMask;
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      エンティティの世代を取得します.
+//-----------------------------------------------------------------------------
+inline uint32_t GetEntityGeneration(Entity entity)
+{
+	return (entity >> EntityIndexBits) & EntityGenerationMask;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// ComponentPoolBase class
+///////////////////////////////////////////////////////////////////////////////
+class ComponentPoolBase
+{
+public:
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	virtual ~ComponentPoolBase()
+	{ /* DO_NOTHING */ }
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンポーネントを持っていれば削除します.
+	//-------------------------------------------------------------------------
+	virtual void Remove(Entity entity) = 0;
+
+	//-------------------------------------------------------------------------
+	//! @brief      全てのコンポーネントを削除します.
+	//-------------------------------------------------------------------------
+	virtual void Clear() = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ComponentPool class
+///////////////////////////////////////////////////////////////////////////////
+template<typename T>
+class ComponentPool : public ComponentPoolBase
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const uint32_t NullIndex = 0xffffffff;   //!< 未登録を表す密配列の番号です.
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	ComponentPool()
+	{ /* DO_NOTHING */ }
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~ComponentPool()
+	{ /* DO_NOTHING */ }
+
+	//-------------------------------------------------------------------------
+	//! @brief      領域を予約します.
+	//-------------------------------------------------------------------------
+	void Reserve(size_t count)
+	{
+		m_Entities.reserve(count);
+		m_Data.reserve(count);
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンポーネントを追加します. 既にある場合は上書きします.
+	//-------------------------------------------------------------------------
+	template<typename... Args>
+	T& Add(Entity entity, Args&&... args)
+	{
+		auto index = GetEntityIndex(entity);
+		if (index >= m_Sparse.size())
+		{
+			m_Sparse.resize(index + 1, uint32_t(NullIndex));
+		}
+
+		auto dense = m_Sparse[index];
+		if (dense != NullIndex)
+		{
+			m_Entities[dense] = entity;
+			m_Data[dense] = T{ std::forward<Args>(args)... };
+			return m_Data[dense];
+		}
+
+		m_Sparse[index] = uint32_t(m_Data.size());
+		m_Entities.push_back(entity);
+		m_Data.push_back(T{ std::forward<Args>(args)... });
+		return m_Data.back();
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンポーネントを削除します.
+	//!
+	//! @note       末尾の要素で穴を埋めるので, 密配列の並びは変わります.
+	//-------------------------------------------------------------------------
+	void Remove(Entity entity) override
+	{
+		if (!Has(entity))
+		{
+			return;
+		}
+
+		auto index = GetEntityIndex(entity);
+		auto dense = m_Sparse[index];
+		auto last  = uint32_t(m_Data.size() - 1);
+
+		if (dense != last)
+		{
+			m_Entities[dense] = m_Entities[last];
+			m_Data[dense]     = std::move(m_Data[last]);
+			m_Sparse[GetEntityIndex(m_Entities[dense])] = dense;
+		}
+
+		m_Entities.pop_back();
+		m_Data.pop_back();
+		m_Sparse[index] = NullIndex;
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      全てのコンポーネントを削除します.
+	//-------------------------------------------------------------------------
+	void Clear() override
+	{
+		m_Sparse.clear();
+		m_Entities.clear();
+		m_Data.clear();
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンポーネントを持っているかどうかを判定します.
+	//-------------------------------------------------------------------------
+	bool Has(Entity entity) const
+	{
+		auto index = GetEntityIndex(entity);
+		if (index >= m_Sparse.size())
+		{
+			return false;
+		}
+
+		auto dense = m_Sparse[index];
+		return (dense != NullIndex) && (m_Entities[dense] == entity);
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンポーネントを取得します. 持っていない場合は nullptr を返却します.
+	//-------------------------------------------------------------------------
+	T* Find(Entity entity)
+	{
+		if (!Has(entity))
+		{
+			return nullptr;
+		}
+
+		return &m_Data[m_Sparse[GetEntityIndex(entity)]];
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンポーネントを取得します. 持っていることが前提です.
+	//-------------------------------------------------------------------------
+	T& Get(Entity entity)
+	{
+		assert(Has(entity));
+		return m_Data[m_Sparse[GetEntityIndex(entity)]];
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンポーネント数を取得します.
+	//-------------------------------------------------------------------------
+	size_t GetCount() const
+	{
+		return m_Data.size();
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      密配列のエンティティを取得します.
+	//-------------------------------------------------------------------------
+	const Entity* GetEntities() const
+	{
+		return m_Entities.data();
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      密配列のコンポーネントを取得します.
+	//-------------------------------------------------------------------------
+	T* GetData()
+	{
+		return m_Data.data();
+	}
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	std::vector<uint32_t>   m_Sparse;       //!< エンティティ番号から密配列の番号への対応です.
+	std::vector<Entity>     m_Entities;     //!< 密配列のエンティティです.
+	std::vector<T>          m_Data;         //!< 密配列のコンポーネントです.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	ComponentPool   (const ComponentPool&) = delete;
+	void operator = (const ComponentPool&) = delete;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// EntityRegistry class
+///////////////////////////////////////////////////////////////////////////////
+class EntityRegistry
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	/* NOTHING */
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	EntityRegistry();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~EntityRegistry();
+
+	//-------------------------------------------------------------------------
+	//! @brief      エンティティを生成します.
+	//!
+	//! @return     生成したエンティティを返却します. 上限に達した場合は NullEntity です.
+	//-------------------------------------------------------------------------
+	Entity Create();
+
+	//-------------------------------------------------------------------------
+	//! @brief      エンティティと全てのコンポーネントを破棄します.
+	//-------------------------------------------------------------------------
+	void Destroy(Entity entity);
+
+	//-------------------------------------------------------------------------
+	//! @brief      エンティティが有効かどうかを判定します.
+	//-------------------------------------------------------------------------
+	bool IsAlive(Entity entity) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      全てのエンティティとコンポーネントを破棄します.
+	//-------------------------------------------------------------------------
+	void Clear();
+
+	//-------------------------------------------------------------------------
+	//! @brief      有効なエンティティ数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンポーネントを追加します.
+	//-------------------------------------------------------------------------
+	template<typename T, typename... Args>
+	T& Add(Entity entity, Args&&... args)
+	{
+		assert(IsAlive(entity));
+		return GetPool<T>().Add(entity, std::forward<Args>(args)...);
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンポーネントを削除します.
+	//-------------------------------------------------------------------------
+	template<typename T>
+	void Remove(Entity entity)
+	{
+		GetPool<T>().Remove(entity);
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンポーネントを持っているかどうかを判定します.
+	//-------------------------------------------------------------------------
+	template<typename T>
+	bool Has(Entity entity)
+	{
+		return GetPool<T>().Has(entity);
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンポーネントを取得します. 持っていない場合は nullptr を返却します.
+	//-------------------------------------------------------------------------
+	template<typename T>
+	T* Find(Entity entity)
+	{
+		return GetPool<T>().Find(entity);
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンポーネントを取得します. 持っていることが前提です.
+	//-------------------------------------------------------------------------
+	template<typename T>
+	T& Get(Entity entity)
+	{
+		return GetPool<T>().Get(entity);
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      型ごとのコンポーネント配列を取得します.
+	//-------------------------------------------------------------------------
+	template<typename T>
+	ComponentPool<T>& GetPool()
+	{
+		auto id = GetTypeId<T>();
+		if (id >= m_Pools.size())
+		{
+			m_Pools.resize(id + 1);
+		}
+
+		if (!m_Pools[id])
+		{
+			m_Pools[id].reset(new ComponentPool<T>());
+		}
+
+		return *static_cast<ComponentPool<T>*>(m_Pools[id].get());
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      指定した全てのコンポーネントを持つエンティティを列挙します.
+	//!
+	//! @param[in]      func        void(Entity, T&, Others&...) の関数です.
+	//! @note       先頭の型の密配列を順に走査し, 残りの型は疎配列で引きます.
+	//!             最も数の少ない型を先頭に指定してください.
+	//!             列挙中にコンポーネントの追加・削除はできません.
+	//-------------------------------------------------------------------------
+	template<typename T, typename... Others, typename Func>
+	void Each(Func func)
+	{
+		auto& pool = GetPool<T>();
+		auto  others = std::make_tuple(&GetPool<Others>()...);
+
+		const auto  count    = pool.GetCount();
+		const auto* entities = pool.GetEntities();
+		auto*       data     = pool.GetData();
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto entity = entities[i];
+			if (!HasAll(entity, others, std::index_sequence_for<Others...>()))
+			{
+				continue;
+			}
+
+			Invoke(func, entity, data[i], others, std::index_sequence_for<Others...>());
+		}
+	}
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	std::vector<uint8_t>                            m_Generations;  //!< 番号ごとの世代です.
+	std::vector<uint8_t>                            m_Alive;        //!< 番号ごとの生存フラグです.
+	std::vector<uint32_t>                           m_FreeIndices;  //!< 再利用できる番号です.
+	std::vector<std::unique_ptr<ComponentPoolBase>> m_Pools;        //!< 型ごとのコンポーネント配列です.
+	uint32_t                                        m_Count;        //!< 有効なエンティティ数です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	static uint32_t NextTypeId();
+
+	template<typename T>
+	static uint32_t GetTypeId()
+	{
+		static const uint32_t id = NextTypeId();
+		return id;
+	}
+
+	template<typename Tuple, size_t... I>
+	static bool HasAll(Entity entity, const Tuple& pools, std::index_sequence<I...>)
+	{
+		bool result = true;
+		(void)std::initializer_list<int>{ (result = result && std::get<I>(pools)->Has(entity), 0)... };
+		(void)entity;
+		(void)pools;
+		return result;
+	}
+
+	template<typename Func, typename T, typename Tuple, size_t... I>
+	static void Invoke(Func& func, Entity entity, T& value, const Tuple& pools, std::index_sequence<I...>)
+	{
+		(void)pools;
+		func(entity, value, std::get<I>(pools)->Get(entity)...);
+	}
+
+	EntityRegistry  (const EntityRegistry&) = delete;
+	void operator = (const EntityRegistry&) = delete;
+};
@@ -0,0 +1,216 @@
+﻿//-----------------------------------------------------------------------------
+// File : FakeCommandList.h
+// Desc : Recording Fake Command List Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <d3d12.h>
+#include <cstdint>
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////
+// FakeCommandList class
+///////////////////////////////////////////////////////////////////////////////
+class FakeCommandList : public ID3D12GraphicsCommandList
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	///////////////////////////////////////////////////////////////////////////
+	// Counters structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Counters
+	{
+		uint32_t    RootSignatureSets;      //!< グラフィックスのルートシグニチャの設定回数です.
+		uint32_t    PipelineStateSets;      //!< パイプラインステートの設定回数です.
+		uint32_t    RootParameterSets;      //!< グラフィックスのルート引数の設定回数です(下の3つの合計).
+		uint32_t    DescriptorTableSets;    //!< ディスクリプタテーブルの設定回数です.
+		uint32_t    RootDescriptorSets;     //!< ルートCBV・SRV・UAVの設定回数です.
+		uint32_t    RootConstantSets;       //!< ルート定数の設定回数です.
+		uint32_t    RedundantSets;          //!< 既に設定されている値と同じ値を設定した回数です.
+		uint32_t    VertexBufferSets;       //!< 頂点バッファの設定回数です.
+		uint32_t    IndexBufferSets;        //!< インデックスバッファの設定回数です.
+		uint32_t    DrawCalls;              //!< ドローコール数です.
+		uint32_t    OtherCalls;             //!< 上記以外のコマンド数です.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// DrawRecord structure
+	///////////////////////////////////////////////////////////////////////////
+	struct DrawRecord
+	{
+		uint64_t    StateHash;      //!< ドロー時点で設定されていたステートのハッシュ値です.
+		uint32_t    Count;          //!< 頂点数またはインデックス数です.
+		uint32_t    InstanceCount;  //!< インスタンス数です.
+		uint32_t    Start;          //!< 開始頂点または開始インデックスです.
+		int32_t     BaseVertex;     //!< ベース頂点です.
+		uint32_t    StartInstance;  //!< 開始インスタンスです.
+	};
+
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const uint32_t MaxRootParameters = 64;   //!< 記録するルート引数の最大数です.
+	static const uint32_t MaxRootConstants  = 16;   //!< ルート引数1つあたりに記録するルート定数の最大数です.
+	static const uint32_t MaxVertexBuffers  = 4;    //!< 記録する頂点バッファの最大数です.
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	FakeCommandList();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	virtual ~FakeCommandList();
+
+	//-------------------------------------------------------------------------
+	//! @brief      記録とステートを初期状態に戻します.
+	//-------------------------------------------------------------------------
+	void Clear();
+
+	//-------------------------------------------------------------------------
+	//! @brief      コマンドの回数を取得します.
+	//-------------------------------------------------------------------------
+	const Counters& GetCounters() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      ドローの記録を取得します.
+	//-------------------------------------------------------------------------
+	const std::vector<DrawRecord>& GetDraws() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      ドローの記録を残すかどうかを設定します.
+	//!
+	//! @param[in]      enable      true の場合はドローごとにステートのハッシュ値を記録します.
+	//-------------------------------------------------------------------------
+	void SetRecordDraws(bool enable);
+
+	//=========================================================================
+	// IUnknown / ID3D12Object / ID3D12DeviceChild / ID3D12CommandList
+	//=========================================================================
+	HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override;
+	ULONG   STDMETHODCALLTYPE AddRef() override;
+	ULONG   STDMETHODCALLTYPE Release() override;
+	HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID guid, UINT* pDataSize, void* pData) override;
+	HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID guid, UINT DataSize, const void* pData) override;
+	HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID guid, const IUnknown* pData) override;
+	HRESULT STDMETHODCALLTYPE SetName(LPCWSTR Name) override;
+	HRESULT STDMETHODCALLTYPE GetDevice(REFIID riid, void** ppvDevice) override;
+	D3D12_COMMAND_LIST_TYPE STDMETHODCALLTYPE GetType() override;
+
+	//=========================================================================
+	// ID3D12GraphicsCommandList
+	//=========================================================================
+	HRESULT STDMETHODCALLTYPE Close() override;
+	HRESULT STDMETHODCALLTYPE Reset(ID3D12CommandAllocator* pAllocator, ID3D12PipelineState* pInitialState) override;
+	void STDMETHODCALLTYPE ClearState(ID3D12PipelineState* pPipelineState) override;
+	void STDMETHODCALLTYPE DrawInstanced(UINT VertexCountPerInstance, UINT InstanceCount, UINT StartVertexLocation, UINT StartInstanceLocation) override;
+	void STDMETHODCALLTYPE DrawIndexedInstanced(UINT IndexCountPerInstance, UINT InstanceCount, UINT StartIndexLocation, INT BaseVertexLocation, UINT StartInstanceLocation) override;
+	void STDMETHODCALLTYPE Dispatch(UINT ThreadGroupCountX, UINT ThreadGroupCountY, UINT ThreadGroupCountZ) override;
+	void STDMETHODCALLTYPE CopyBufferRegion(ID3D12Resource* pDstBuffer, UINT64 DstOffset, ID3D12Resource* pSrcBuffer, UINT64 SrcOffset, UINT64 NumBytes) override;
+	void STDMETHODCALLTYPE CopyTextureRegion(const D3D12_TEXTURE_COPY_LOCATION* pDst, UINT DstX, UINT DstY, UINT DstZ, const D3D12_TEXTURE_COPY_LOCATION* pSrc, const D3D12_BOX* pSrcBox) override;
+	void STDMETHODCALLTYPE CopyResource(ID3D12Resource* pDstResource, ID3D12Resource* pSrcResource) override;
+	void STDMETHODCALLTYPE CopyTiles(ID3D12Resource* pTiledResource, const D3D12_TILED_RESOURCE_COORDINATE* pTileRegionStartCoordinate, const D3D12_TILE_REGION_SIZE* pTileRegionSize, ID3D12Resource* pBuffer, UINT64 BufferStartOffsetInBytes, D3D12_TILE_COPY_FLAGS Flags) override;
+	void STDMETHODCALLTYPE ResolveSubresource(ID3D12Resource* pDstResource, UINT DstSubresource, ID3D12Resource* pSrcResource, UINT SrcSubresource, DXGI_FORMAT Format) override;
+	void STDMETHODCALLTYPE IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY PrimitiveTopology) override;
+	void STDMETHODCALLTYPE RSSetViewports(UINT NumViewports, const D3D12_VIEWPORT* pViewports) override;
+	void STDMETHODCALLTYPE RSSetScissorRects(UINT NumRects, const D3D12_RECT* pRects) override;
+	void STDMETHODCALLTYPE OMSetBlendFactor(const FLOAT BlendFactor[4]) override;
+	void STDMETHODCALLTYPE OMSetStencilRef(UINT StencilRef) override;
+	void STDMETHODCALLTYPE SetPipelineState(ID3D12PipelineState* pPipelineState) override;
+	void STDMETHODCALLTYPE ResourceBarrier(UINT NumBarriers, const D3D12_RESOURCE_BARRIER* pBarriers) override;
+	void STDMETHODCALLTYPE ExecuteBundle(ID3D12GraphicsCommandList* pCommandList) override;
+	void STDMETHODCALLTYPE SetDescriptorHeaps(UINT NumDescriptorHeaps, ID3D12DescriptorHeap* const* ppDescriptorHeaps) override;
+	void STDMETHODCALLTYPE SetComputeRootSignature(ID3D12RootSignature* pRootSignature) override;
+	void STDMETHODCALLTYPE SetGraphicsRootSignature(ID3D12RootSignature* pRootSignature) override;
+	void STDMETHODCALLTYPE SetComputeRootDescriptorTable(UINT RootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE BaseDescriptor) override;
+	void STDMETHODCALLTYPE SetGraphicsRootDescriptorTable(UINT RootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE BaseDescriptor) override;
+	void STDMETHODCALLTYPE SetComputeRoot32BitConstant(UINT RootParameterIndex, UINT SrcData, UINT DestOffsetIn32BitValues) override;
+	void STDMETHODCALLTYPE SetGraphicsRoot32BitConstant(UINT RootParameterIndex, UINT SrcData, UINT DestOffsetIn32BitValues) override;
+	void STDMETHODCALLTYPE SetComputeRoot32BitConstants(UINT RootParameterIndex, UINT Num32BitValuesToSet, const void* pSrcData, UINT DestOffsetIn32BitValues) override;
+	void STDMETHODCALLTYPE SetGraphicsRoot32BitConstants(UINT RootParameterIndex, UINT Num32BitValuesToSet, const void* pSrcData, UINT DestOffsetIn32BitValues) override;
+	void STDMETHODCALLTYPE SetComputeRootConstantBufferView(UINT RootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS BufferLocation) override;
+	void STDMETHODCALLTYPE SetGraphicsRootConstantBufferView(UINT RootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS BufferLocation) override;
+	void STDMETHODCALLTYPE SetComputeRootShaderResourceView(UINT RootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS BufferLocation) override;
+	void STDMETHODCALLTYPE SetGraphicsRootShaderResourceView(UINT RootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS BufferLocation) override;
+	void STDMETHODCALLTYPE SetComputeRootUnorderedAccessView(UINT RootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS BufferLocation) override;
+	void STDMETHODCALLTYPE SetGraphicsRootUnorderedAccessView(UINT RootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS BufferLocation) override;
+	void STDMETHODCALLTYPE IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* pView) override;
+	void STDMETHODCALLTYPE IASetVertexBuffers(UINT StartSlot, UINT NumViews, const D3D12_VERTEX_BUFFER_VIEW* pViews) override;
+	void STDMETHODCALLTYPE SOSetTargets(UINT StartSlot, UINT NumViews, const D3D12_STREAM_OUTPUT_BUFFER_VIEW* pViews) override;
+	void STDMETHODCALLTYPE OMSetRenderTargets(UINT NumRenderTargetDescriptors, const D3D12_CPU_DESCRIPTOR_HANDLE* pRenderTargetDescriptors, BOOL RTsSingleHandleToDescriptorRange, const D3D12_CPU_DESCRIPTOR_HANDLE* pDepthStencilDescriptor) override;
+	void STDMETHODCALLTYPE ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE DepthStencilView, D3D12_CLEAR_FLAGS ClearFlags, FLOAT Depth, UINT8 Stencil, UINT NumRects, const D3D12_RECT* pRects) override;
+	void STDMETHODCALLTYPE ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE RenderTargetView, const FLOAT ColorRGBA[4], UINT NumRects, const D3D12_RECT* pRects) override;
+	void STDMETHODCALLTYPE ClearUnorderedAccessViewUint(D3D12_GPU_DESCRIPTOR_HANDLE ViewGPUHandleInCurrentHeap, D3D12_CPU_DESCRIPTOR_HANDLE ViewCPUHandle, ID3D12Resource* pResource, const UINT Values[4], UINT NumRects, const D3D12_RECT* pRects) override;
+	void STDMETHODCALLTYPE ClearUnorderedAccessViewFloat(D3D12_GPU_DESCRIPTOR_HANDLE ViewGPUHandleInCurrentHeap, D3D12_CPU_DESCRIPTOR_HANDLE ViewCPUHandle, ID3D12Resource* pResource, const FLOAT Values[4], UINT NumRects, const D3D12_RECT* pRects) override;
+	void STDMETHODCALLTYPE DiscardResource(ID3D12Resource* pResource, const D3D12_DISCARD_REGION* pRegion) override;
+	void STDMETHODCALLTYPE BeginQuery(ID3D12QueryHeap* pQueryHeap, D3D12_QUERY_TYPE Type, UINT Index) override;
+	void STDMETHODCALLTYPE EndQuery(ID3D12QueryHeap* pQueryHeap, D3D12_QUERY_TYPE Type, UINT Index) override;
+	void STDMETHODCALLTYPE ResolveQueryData(ID3D12QueryHeap* pQueryHeap, D3D12_QUERY_TYPE Type, UINT StartIndex, UINT NumQueries, ID3D12Resource* pDestinationBuffer, UINT64 AlignedDestinationBufferOffset) override;
+	void STDMETHODCALLTYPE SetPredication(ID3D12Resource* pBuffer, UINT64 AlignedBufferOffset, D3D12_PREDICATION_OP Operation) override;
+	void STDMETHODCALLTYPE SetMarker(UINT Metadata, const void* pData, UINT Size) override;
+	void STDMETHODCALLTYPE BeginEvent(UINT Metadata, const void* pData, UINT Size) override;
+	void STDMETHODCALLTYPE EndEvent() override;
+	void STDMETHODCALLTYPE ExecuteIndirect(ID3D12CommandSignature* pCommandSignature, UINT MaxCommandCount, ID3D12Resource* pArgumentBuffer, UINT64 ArgumentBufferOffset, ID3D12Resource* pCountBuffer, UINT64 CountBufferOffset) override;
+
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// PARAM_KIND enum
+	///////////////////////////////////////////////////////////////////////////
+	enum PARAM_KIND : uint32_t
+	{
+		PARAM_KIND_NONE = 0,    //!< 未設定です.
+		PARAM_KIND_TABLE,       //!< ディスクリプタテーブルです.
+		PARAM_KIND_CBV,         //!< ルートCBVです.
+		PARAM_KIND_SRV,         //!< ルートSRVです.
+		PARAM_KIND_UAV,         //!< ルートUAVです.
+		PARAM_KIND_CONSTANTS,   //!< ルート定数です.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// State structure
+	///////////////////////////////////////////////////////////////////////////
+	struct State
+	{
+		const void*                 pRootSignature;                                 //!< ルートシグニチャです.
+		const void*                 pPipelineState;                                 //!< パイプラインステートです.
+		uint32_t                    Topology;                                       //!< プリミティブトポロジーです.
+		uint32_t                    Kinds[MaxRootParameters];                       //!< ルート引数の種類です.
+		uint64_t                    Params[MaxRootParameters];                      //!< ディスクリプタハンドル・GPU仮想アドレスです.
+		uint32_t                    Constants[MaxRootParameters][MaxRootConstants]; //!< ルート定数です.
+		D3D12_VERTEX_BUFFER_VIEW    VertexBuffers[MaxVertexBuffers];                //!< 頂点バッファです.
+		D3D12_INDEX_BUFFER_VIEW     IndexBuffer;                                    //!< インデックスバッファです.
+	};
+
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	State                       m_State;        //!< 現在のステートです.
+	Counters                    m_Counters;     //!< コマンドの回数です.
+	std::vector<DrawRecord>     m_Draws;        //!< ドローの記録です.
+	bool                        m_RecordDraws;  //!< ドローの記録を残すかどうか.
+	ULONG                       m_RefCount;     //!< 参照カウントです.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	void SetRootParam(UINT index, PARAM_KIND kind, uint64_t value);
+	void SetRootConstants(UINT index, UINT count, const uint32_t* pValues, UINT offset);
+	void RecordDraw(UINT count, UINT instanceCount, UINT start, INT baseVertex, UINT startInstance);
+
+	FakeCommandList (const FakeCommandList&) = delete;
+	void operator = (const FakeCommandList&) = delete;
+};
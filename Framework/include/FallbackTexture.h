@@ -0,0 +1,107 @@
+﻿//-----------------------------------------------------------------------------
+// File : FallbackTexture.h
+// Desc : Shared Fallback Texture Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <d3d12.h>
+#include <ComPtr.h>
+#include <Texture.h>
+
+//-----------------------------------------------------------------------------
+// Forward Declarations.
+//-----------------------------------------------------------------------------
+class DescriptorPool;
+
+///////////////////////////////////////////////////////////////////////////////
+// FallbackTexture class
+///////////////////////////////////////////////////////////////////////////////
+class FallbackTexture
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	///////////////////////////////////////////////////////////////////////////
+	// TYPE enum
+	///////////////////////////////////////////////////////////////////////////
+	enum TYPE
+	{
+		TYPE_WHITE = 0,		//!< (1, 1, 1, 1) です.
+		TYPE_BLACK,			//!< (0, 0, 0, 1) です.
+		TYPE_FLAT_NORMAL,	//!< 接線空間で +Z を向く法線です.
+		TYPE_COUNT
+	};
+
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	/* NOTHING */
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      インスタンスを取得します.
+	//-------------------------------------------------------------------------
+	static FallbackTexture& GetInstance()
+	{
+		static FallbackTexture instance;
+		return instance;
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      初期化処理を行います.
+	//!
+	//! @param[in]      pDevice     デバイスです.
+	//! @param[in]      pPool       ディスクリプタプールです(CBV_UAV_SRV用のものを設定します).
+	//! @param[in]      pQueue      アップロードに使用するコマンドキューです.
+	//! @retval true    初期化に成功.
+	//! @retval false   初期化に失敗.
+	//-------------------------------------------------------------------------
+	bool Init(ID3D12Device* pDevice, DescriptorPool* pPool, ID3D12CommandQueue* pQueue);
+
+	//-------------------------------------------------------------------------
+	//! @brief      終了処理を行います.
+	//-------------------------------------------------------------------------
+	void Term();
+
+	//-------------------------------------------------------------------------
+	//! @brief      テクスチャを取得します.
+	//!
+	//! @param[in]      type        取得するテクスチャの種類です.
+	//! @return     初期化前であれば nullptr を返却します.
+	//-------------------------------------------------------------------------
+	Texture* Get(TYPE type);
+
+	//-------------------------------------------------------------------------
+	//! @brief      GPUディスクリプタハンドルを取得します.
+	//!
+	//! @param[in]      type        取得するテクスチャの種類です.
+	//! @return     初期化前であれば ptr が 0 のハンドルを返却します.
+	//-------------------------------------------------------------------------
+	D3D12_GPU_DESCRIPTOR_HANDLE GetHandleGPU(TYPE type) const;
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	Texture     m_Texture[TYPE_COUNT];      //!< テクスチャです.
+	bool        m_IsValid = false;          //!< 初期化済みかどうか.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	FallbackTexture() = default;
+	~FallbackTexture() = default;
+
+	FallbackTexture(const FallbackTexture&) = delete;
+	void operator = (const FallbackTexture&) = delete;
+};
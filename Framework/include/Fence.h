@@ -70,13 +70,36 @@ public:
 	//-------------------------------------------------------------------------
 	void Sync(ID3D12CommandQueue* pQueue);
 
+	//-------------------------------------------------------------------------
+	//! @brief      待機せずにシグナル処理を行います.
+	//!
+	//! @param[in]      pQueue          コマンドキューです.
+	//! @return     シグナルしたフェンス値を返却します. 失敗した場合は 0 です.
+	//-------------------------------------------------------------------------
+	UINT64 Signal(ID3D12CommandQueue* pQueue);
+
+	//-------------------------------------------------------------------------
+	//! @brief      指定したフェンス値が完了するまで待機します.
+	//!
+	//! @param[in]      value           待機するフェンス値です. 0 の場合は待機しません.
+	//! @param[in]      timeout         タイムアウト時間(ミリ秒).
+	//! @retval true    完了しました.
+	//! @retval false   タイムアウトまたは失敗しました.
+	//-------------------------------------------------------------------------
+	bool WaitValue(UINT64 value, UINT timeout);
+
+	//-------------------------------------------------------------------------
+	//! @brief      GPUが完了したフェンス値を取得します.
+	//-------------------------------------------------------------------------
+	UINT64 GetCompletedValue() const;
+
 private:
 	//=========================================================================
 	// private variables.
 	//=========================================================================
 	ComPtr<ID3D12Fence> m_pFence;           //!< フェンスです.
 	HANDLE              m_Event;            //!< イベントです.
-	UINT                m_Counter;          //!< 現在のカウンターです.
+	UINT64              m_Counter;          //!< 現在のカウンターです.
 
 	//=========================================================================
 	// private methods.
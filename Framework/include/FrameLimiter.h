@@ -0,0 +1,146 @@
+﻿//-----------------------------------------------------------------------------
+// File : FrameLimiter.h
+// Desc : Frame Rate Limiter Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+
+///////////////////////////////////////////////////////////////////////////////
+// FrameClock class
+///////////////////////////////////////////////////////////////////////////////
+class FrameClock
+{
+public:
+	virtual ~FrameClock() {}
+
+	//-------------------------------------------------------------------------
+	//! @brief      単調増加する現在時刻(マイクロ秒)を取得します.
+	//-------------------------------------------------------------------------
+	virtual double GetMicroSec() = 0;
+
+	//-------------------------------------------------------------------------
+	//! @brief      スレッドを休止します. 指定時間より長く休止する場合があります.
+	//!
+	//! @param[in]      microSec        休止する時間(マイクロ秒)です.
+	//-------------------------------------------------------------------------
+	virtual void Sleep(double microSec) = 0;
+
+	//-------------------------------------------------------------------------
+	//! @brief      休止せずに僅かな時間待機します.
+	//-------------------------------------------------------------------------
+	virtual void Spin() = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// SystemClock class
+///////////////////////////////////////////////////////////////////////////////
+class SystemClock : public FrameClock
+{
+public:
+	double GetMicroSec() override;
+	void   Sleep(double microSec) override;
+	void   Spin() override;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// FrameLimiter class
+///////////////////////////////////////////////////////////////////////////////
+class FrameLimiter
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const double DefaultSpinMicroSec;    //!< 休止せずに待機する時間の既定値です.
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	FrameLimiter();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~FrameLimiter();
+
+	//-------------------------------------------------------------------------
+	//! @brief      初期化処理を行います.
+	//!
+	//! @param[in]      pClock          時刻を取得するクロックです.
+	//! @retval true    初期化に成功.
+	//! @retval false   初期化に失敗.
+	//-------------------------------------------------------------------------
+	bool Init(FrameClock* pClock);
+
+	//-------------------------------------------------------------------------
+	//! @brief      終了処理を行います.
+	//-------------------------------------------------------------------------
+	void Term();
+
+	//-------------------------------------------------------------------------
+	//! @brief      目標フレームレートを設定します.
+	//!
+	//! @param[in]      fps             目標フレームレートです. 0 以下の場合は制限しません.
+	//-------------------------------------------------------------------------
+	void SetTargetFps(double fps);
+
+	//-------------------------------------------------------------------------
+	//! @brief      休止せずに待機する時間を設定します.
+	//!
+	//! @param[in]      microSec        目標時刻までの残りがこの時間以下になったら休止をやめます.
+	//! @note       クロックの休止の精度より長くしてください.
+	//-------------------------------------------------------------------------
+	void SetSpinMicroSec(double microSec);
+
+	//-------------------------------------------------------------------------
+	//! @brief      次のフレームを開始する時刻まで待機します.
+	//!
+	//! @return     待機した時間(マイクロ秒)を返却します.
+	//-------------------------------------------------------------------------
+	double Wait();
+
+	//-------------------------------------------------------------------------
+	//! @brief      次のフレームの目標時刻を破棄します.
+	//-------------------------------------------------------------------------
+	void Reset();
+
+	//-------------------------------------------------------------------------
+	//! @brief      目標フレームレートを取得します.
+	//-------------------------------------------------------------------------
+	double GetTargetFps() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      休止せずに待機する時間を取得します.
+	//-------------------------------------------------------------------------
+	double GetSpinMicroSec() const;
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	FrameClock*     m_pClock;           //!< クロックです.
+	double          m_TargetFps;        //!< 目標フレームレートです.
+	double          m_SpinMicroSec;     //!< 休止せずに待機する時間です.
+	double          m_FrameMicroSec;    //!< 前のフレームの開始時刻です.
+	bool            m_HasFrame;         //!< 前のフレームの開始時刻が有効かどうか.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	FrameLimiter    (const FrameLimiter&) = delete;
+	void operator = (const FrameLimiter&) = delete;
+};
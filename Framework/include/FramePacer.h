@@ -0,0 +1,113 @@
+﻿//-----------------------------------------------------------------------------
+// File : FramePacer.h
+// Desc : Frames In Flight Pacing Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// FramePacer class
+///////////////////////////////////////////////////////////////////////////////
+class FramePacer
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	/* NOTHING */
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	FramePacer();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~FramePacer();
+
+	//-------------------------------------------------------------------------
+	//! @brief      初期化処理を行います.
+	//!
+	//! @param[in]      frameCount      同時に処理するフレーム数です.
+	//! @retval true    初期化に成功.
+	//! @retval false   初期化に失敗.
+	//-------------------------------------------------------------------------
+	bool Init(uint32_t frameCount);
+
+	//-------------------------------------------------------------------------
+	//! @brief      終了処理を行います.
+	//-------------------------------------------------------------------------
+	void Term();
+
+	//-------------------------------------------------------------------------
+	//! @brief      フレームの提出を記録します.
+	//!
+	//! @param[in]      frameIndex      提出したフレーム番号です.
+	//! @param[in]      fenceValue      提出後にキューへシグナルしたフェンス値です.
+	//-------------------------------------------------------------------------
+	void EndFrame(uint32_t frameIndex, uint64_t fenceValue);
+
+	//-------------------------------------------------------------------------
+	//! @brief      フレーム番号を再利用する前に完了を待つフェンス値を取得します.
+	//!
+	//! @param[in]      frameIndex      再利用するフレーム番号です.
+	//! @return     待機するフェンス値を返却します. 一度も提出していない場合は 0 です.
+	//-------------------------------------------------------------------------
+	uint64_t GetWaitValue(uint32_t frameIndex) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      フレーム番号を再利用できるかどうかを判定します.
+	//!
+	//! @param[in]      frameIndex      再利用するフレーム番号です.
+	//! @param[in]      completedValue  GPUが完了したフェンス値です.
+	//! @retval true    再利用できます.
+	//! @retval false   GPUが実行中です.
+	//-------------------------------------------------------------------------
+	bool IsReady(uint32_t frameIndex, uint64_t completedValue) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      GPUが実行中のフレーム数を取得します.
+	//!
+	//! @param[in]      completedValue  GPUが完了したフェンス値です.
+	//-------------------------------------------------------------------------
+	uint32_t GetInFlightCount(uint64_t completedValue) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      同時に処理するフレーム数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetFrameCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      最後に提出したフェンス値を取得します.
+	//-------------------------------------------------------------------------
+	uint64_t GetLastValue() const;
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	std::vector<uint64_t>   m_FenceValues;  //!< フレーム番号ごとの最後に提出したフェンス値です.
+	uint64_t                m_LastValue;    //!< 最後に提出したフェンス値です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	FramePacer      (const FramePacer&) = delete;
+	void operator = (const FramePacer&) = delete;
+};
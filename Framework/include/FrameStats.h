@@ -0,0 +1,106 @@
+﻿//-----------------------------------------------------------------------------
+// File : FrameStats.h
+// Desc : Frame Time Statistics Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// FrameStats class
+///////////////////////////////////////////////////////////////////////////////
+class FrameStats
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	/* NOTHING */
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	FrameStats();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~FrameStats();
+
+	//-------------------------------------------------------------------------
+	//! @brief      初期化処理を行います.
+	//!
+	//! @param[in]      capacity        保持するサンプル数です. 古いものから上書きします.
+	//! @retval true    初期化に成功.
+	//! @retval false   初期化に失敗.
+	//-------------------------------------------------------------------------
+	bool Init(uint32_t capacity);
+
+	//-------------------------------------------------------------------------
+	//! @brief      終了処理を行います.
+	//-------------------------------------------------------------------------
+	void Term();
+
+	//-------------------------------------------------------------------------
+	//! @brief      サンプルを追加します.
+	//-------------------------------------------------------------------------
+	void Push(double value);
+
+	//-------------------------------------------------------------------------
+	//! @brief      サンプルを全て破棄します.
+	//-------------------------------------------------------------------------
+	void Clear();
+
+	//-------------------------------------------------------------------------
+	//! @brief      パーセンタイル値を取得します.
+	//!
+	//! @param[in]      percent         パーセント(0 ~ 100)です.
+	//! @return     最近順位法で求めた値を返却します. サンプルが無い場合は 0 です.
+	//-------------------------------------------------------------------------
+	double GetPercentile(double percent) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      平均値を取得します.
+	//-------------------------------------------------------------------------
+	double GetAverage() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      最後に追加したサンプルを取得します.
+	//-------------------------------------------------------------------------
+	double GetLast() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      保持しているサンプル数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetCount() const;
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	std::vector<double>         m_Samples;  //!< リングバッファです.
+	mutable std::vector<double> m_Sorted;   //!< パーセンタイル計算用の作業領域です.
+	uint32_t                    m_Count;    //!< 保持しているサンプル数です.
+	uint32_t                    m_Next;     //!< 次に書き込む位置です.
+	double                      m_Last;     //!< 最後に追加したサンプルです.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	FrameStats      (const FrameStats&) = delete;
+	void operator = (const FrameStats&) = delete;
+};
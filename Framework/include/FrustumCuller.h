@@ -0,0 +1,171 @@
+﻿//-----------------------------------------------------------------------------
+// File : FrustumCuller.h
+// Desc : SIMD Frustum Culling Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// Frustum structure
+///////////////////////////////////////////////////////////////////////////////
+struct Frustum
+{
+	///////////////////////////////////////////////////////////////////////////
+	// PLANE enum
+	///////////////////////////////////////////////////////////////////////////
+	enum PLANE
+	{
+		PLANE_LEFT = 0,
+		PLANE_RIGHT,
+		PLANE_BOTTOM,
+		PLANE_TOP,
+		PLANE_NEAR,
+		PLANE_FAR,
+		PLANE_COUNT
+	};
+
+	DirectX::XMFLOAT4   Planes[PLANE_COUNT];    //!< 内側を正とする正規化済みの平面(xyz:法線, w:距離)です.
+
+	//-------------------------------------------------------------------------
+	//! @brief      ビュー射影行列から平面を抽出します.
+	//!
+	//! @param[in]      viewProj    行ベクトル形式(v * M)のビュー射影行列です.
+	//! @note       Direct3D のクリップ空間(0 <= z <= w)を前提とします.
+	//-------------------------------------------------------------------------
+	void Extract(const DirectX::XMFLOAT4X4& viewProj);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// FrustumCuller class
+///////////////////////////////////////////////////////////////////////////////
+class FrustumCuller
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	/* NOTHING */
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	FrustumCuller();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~FrustumCuller();
+
+	//-------------------------------------------------------------------------
+	//! @brief      登録済みの境界ボリュームを破棄します.
+	//-------------------------------------------------------------------------
+	void Clear();
+
+	//-------------------------------------------------------------------------
+	//! @brief      領域を予約します.
+	//!
+	//! @param[in]      count       境界ボリューム数です.
+	//-------------------------------------------------------------------------
+	void Reserve(size_t count);
+
+	//-------------------------------------------------------------------------
+	//! @brief      ワールド空間のAABBを追加します.
+	//!
+	//! @param[in]      center      中心です.
+	//! @param[in]      extent      各軸の半分の大きさです.
+	//! @return     追加した境界ボリュームの番号を返却します.
+	//-------------------------------------------------------------------------
+	uint32_t Add(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extent);
+
+	//-------------------------------------------------------------------------
+	//! @brief      ローカル空間のAABBをワールド空間に変換して追加します.
+	//!
+	//! @param[in]      localMin    ローカル空間のAABBの最小値です.
+	//! @param[in]      localMax    ローカル空間のAABBの最大値です.
+	//! @param[in]      world       ワールド行列です.
+	//! @return     追加した境界ボリュームの番号を返却します.
+	//-------------------------------------------------------------------------
+	uint32_t Add(const DirectX::XMFLOAT3& localMin, const DirectX::XMFLOAT3& localMax, const DirectX::XMFLOAT4X4& world);
+
+	//-------------------------------------------------------------------------
+	//! @brief      視錐台と交差する境界ボリュームを SSE で4つずつ判定します.
+	//!
+	//! @param[in]      frustum     視錐台です.
+	//! @param[out]     visible     可視と判定された番号の格納先です(昇順).
+	//! @return     可視と判定された数を返却します.
+	//-------------------------------------------------------------------------
+	size_t Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      視錐台と交差する境界ボリュームを1つずつ判定します.
+	//!
+	//! @param[in]      frustum     視錐台です.
+	//! @param[out]     visible     可視と判定された番号の格納先です(昇順).
+	//! @return     可視と判定された数を返却します.
+	//! @note       Cull() の検証用の参照実装です.
+	//-------------------------------------------------------------------------
+	size_t CullReference(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      登録済みの境界ボリューム数を取得します.
+	//-------------------------------------------------------------------------
+	size_t GetCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      登録済みの境界ボリュームを取得します.
+	//!
+	//! @param[in]      index       番号です.
+	//! @param[out]     center      中心の格納先です.
+	//! @param[out]     extent      半分の大きさの格納先です.
+	//-------------------------------------------------------------------------
+	void GetBounds(uint32_t index, DirectX::XMFLOAT3& center, DirectX::XMFLOAT3& extent) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      ローカル空間のAABBをワールド空間のAABBに変換します.
+	//!
+	//! @param[in]      localMin    ローカル空間のAABBの最小値です.
+	//! @param[in]      localMax    ローカル空間のAABBの最大値です.
+	//! @param[in]      world       ワールド行列です.
+	//! @param[out]     center      ワールド空間の中心の格納先です.
+	//! @param[out]     extent      ワールド空間の半分の大きさの格納先です.
+	//-------------------------------------------------------------------------
+	static void TransformAABB(
+		const DirectX::XMFLOAT3&    localMin,
+		const DirectX::XMFLOAT3&    localMax,
+		const DirectX::XMFLOAT4X4&  world,
+		DirectX::XMFLOAT3&          center,
+		DirectX::XMFLOAT3&          extent);
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	std::vector<float>  m_CenterX;      //!< 中心のX成分です.
+	std::vector<float>  m_CenterY;      //!< 中心のY成分です.
+	std::vector<float>  m_CenterZ;      //!< 中心のZ成分です.
+	std::vector<float>  m_ExtentX;      //!< 半分の大きさのX成分です.
+	std::vector<float>  m_ExtentY;      //!< 半分の大きさのY成分です.
+	std::vector<float>  m_ExtentZ;      //!< 半分の大きさのZ成分です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	FrustumCuller   (const FrustumCuller&) = delete;
+	void operator = (const FrustumCuller&) = delete;
+};
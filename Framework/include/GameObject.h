@@ -3,6 +3,7 @@
 #include <TransformComponent.h>
 #include <SimpleMath.h>
 #include <vector>
+#include <memory>
 #include <MakeRandom.h>
 #include <ModelLoader.h>
 
@@ -20,7 +21,7 @@ public:
     TransformComponent& Transform() const;
     std::int64_t GetId() const { return m_Id; }
 
-    // eXgp
+    // テスト用
     Model   m_Model;
 private:
     
@@ -29,4 +30,23 @@ private:
     std::uint64_t m_Id;
 
 
-};
\ No newline at end of file
+};
+
+// テンプレートは利用側でインスタンス化されるのでヘッダーに定義する.
+template<typename T>
+std::shared_ptr<T> GameObject::GetComponent() {
+    for (auto& component : m_components) {
+        std::shared_ptr<T> castedComponent = std::dynamic_pointer_cast<T>(component);
+        if (castedComponent) {
+            return castedComponent;
+        }
+    }
+    return nullptr;
+}
+
+template<typename T, typename... Args>
+std::shared_ptr<T> GameObject::AddComponent(Args&&... args) {
+    std::shared_ptr<T> newComponent = std::make_shared<T>(std::forward<Args>(args)...);
+    m_components.push_back(newComponent);
+    return newComponent;
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+﻿//-----------------------------------------------------------------------------
+// File : GpuProfiler.h
+// Desc : GPU Timestamp Profiler Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <d3d12.h>
+#include <ComPtr.h>
+#include <Profiler.h>
+#include <cstdint>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// GpuProfiler class
+///////////////////////////////////////////////////////////////////////////////
+class GpuProfiler
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const uint32_t InvalidScope = ~0u;   //!< 計測しないスコープ番号です.
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	GpuProfiler();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~GpuProfiler();
+
+	//-------------------------------------------------------------------------
+	//! @brief      初期化処理を行います.
+	//!
+	//! @param[in]      pDevice         デバイスです.
+	//! @param[in]      pQueue          計測するコマンドを実行するキューです.
+	//! @param[in]      frameCount      フレーム数です.
+	//! @param[in]      maxScopes       1フレームあたりの最大スコープ数です.
+	//! @retval true    初期化に成功.
+	//! @retval false   初期化に失敗.
+	//-------------------------------------------------------------------------
+	bool Init(ID3D12Device* pDevice, ID3D12CommandQueue* pQueue, uint32_t frameCount, uint32_t maxScopes);
+
+	//-------------------------------------------------------------------------
+	//! @brief      終了処理を行います.
+	//-------------------------------------------------------------------------
+	void Term();
+
+	//-------------------------------------------------------------------------
+	//! @brief      フレームを開始します.
+	//!
+	//! @param[in]      frameIndex      フレーム番号です.
+	//! @param[in]      pProfiler       前回このフレーム番号で計測した結果の追加先です. nullptr の場合は破棄します.
+	//! @note       同じフレーム番号の結果を読み戻すので, GPUの実行完了後に呼び出します.
+	//-------------------------------------------------------------------------
+	void BeginFrame(uint32_t frameIndex, Profiler* pProfiler);
+
+	//-------------------------------------------------------------------------
+	//! @brief      スコープを追加します.
+	//!
+	//! @param[in]      name        名前です. 文字列リテラルなど, 破棄されない文字列を渡してください.
+	//! @param[in]      depth       入れ子の深さです.
+	//! @return     スコープ番号を返却します. 追加できない場合は InvalidScope です.
+	//! @note       記録を始める前に, 記録を開始したスレッドから呼び出します.
+	//-------------------------------------------------------------------------
+	uint32_t AddScope(const char* name, uint32_t depth);
+
+	//-------------------------------------------------------------------------
+	//! @brief      スコープの開始時刻を書き込むコマンドを記録します.
+	//!
+	//! @param[in]      pCmd        コマンドリストです.
+	//! @param[in]      scope       スコープ番号です. InvalidScope の場合は何もしません.
+	//! @note       スコープ番号ごとに異なるクエリを使うので, 複数のスレッドから呼び出せます.
+	//-------------------------------------------------------------------------
+	void Begin(ID3D12GraphicsCommandList* pCmd, uint32_t scope);
+
+	//-------------------------------------------------------------------------
+	//! @brief      スコープの終了時刻を書き込むコマンドを記録します.
+	//!
+	//! @param[in]      pCmd        コマンドリストです.
+	//! @param[in]      scope       スコープ番号です. InvalidScope の場合は何もしません.
+	//-------------------------------------------------------------------------
+	void End(ID3D12GraphicsCommandList* pCmd, uint32_t scope);
+
+	//-------------------------------------------------------------------------
+	//! @brief      計測結果を読み戻し用のバッファへ書き込むコマンドを記録します.
+	//!
+	//! @param[in]      pCmd        全てのスコープより後に実行されるコマンドリストです.
+	//-------------------------------------------------------------------------
+	void Resolve(ID3D12GraphicsCommandList* pCmd);
+
+	//-------------------------------------------------------------------------
+	//! @brief      現在のフレームのスコープ数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetScopeCount() const;
+
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// Scope structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Scope
+	{
+		const char* Name;   //!< 名前です.
+		uint32_t    Depth;  //!< 入れ子の深さです.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// Frame structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Frame
+	{
+		std::vector<Scope>  Scopes;     //!< 追加したスコープです.
+		bool                Resolved;   //!< 読み戻しを記録したかどうかです.
+	};
+
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	ComPtr<ID3D12QueryHeap>     m_pHeap;        //!< タイムスタンプのクエリヒープです.
+	ComPtr<ID3D12Resource>      m_pReadback;    //!< 読み戻し用のバッファです.
+	ComPtr<ID3D12CommandQueue>  m_pQueue;       //!< 計測するキューです.
+	std::vector<Frame>          m_Frames;       //!< フレームごとのスコープです.
+	uint32_t                    m_MaxScopes;    //!< 1フレームあたりの最大スコープ数です.
+	uint32_t                    m_FrameIndex;   //!< 現在のフレーム番号です.
+	uint64_t                    m_Frequency;    //!< タイムスタンプの周波数です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	GpuProfiler     (const GpuProfiler&) = delete;
+	void operator = (const GpuProfiler&) = delete;
+};
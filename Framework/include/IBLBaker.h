@@ -29,6 +29,8 @@ public:
 	static const int    DFGTextureSize = 512;
 	static const int    LDTextureSize = 256;
 	static const int    MipCount = 8;
+	static const int    DFGSampleCount = 1024;     //!< IntegrateDFG_PS のサンプル数と一致させます.
+	static const int    LDSampleCount = 128;       //!< BakeUtil.hlsli の SampleCount と一致させます.
 
 	//=========================================================================
 	// public methods.
@@ -124,6 +126,28 @@ public:
 	//-------------------------------------------------------------------------
 	D3D12_GPU_DESCRIPTOR_HANDLE GetHandleGPU_SpecularLD() const;
 
+	//-------------------------------------------------------------------------
+	//! @brief      DFGテクスチャを取得します.
+	//-------------------------------------------------------------------------
+	ID3D12Resource* GetTextureDFG() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      DiffuseLDテクスチャを取得します.
+	//-------------------------------------------------------------------------
+	ID3D12Resource* GetTextureDiffuseLD() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      SpecularLDテクスチャを取得します.
+	//-------------------------------------------------------------------------
+	ID3D12Resource* GetTextureSpecularLD() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      積分に使用するシェーダのハッシュ値を求めます.
+	//!
+	//! @return     シェーダを変更するとベイク結果のキャッシュが無効になるよう, バイトコードから求めた値を返却します.
+	//-------------------------------------------------------------------------
+	static uint64_t GetShaderHash();
+
 private:
 	//=========================================================================
 	// private variables.
@@ -0,0 +1,183 @@
+﻿//-----------------------------------------------------------------------------
+// File : IBLCache.h
+// Desc : Baked IBL Texture Cache Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////
+// IBLCache class
+///////////////////////////////////////////////////////////////////////////////
+class IBLCache
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	///////////////////////////////////////////////////////////////////////////
+	// FORMAT enum
+	///////////////////////////////////////////////////////////////////////////
+	// DDSファイルにそのまま書き込むので, 値は DXGI_FORMAT と同じです.
+	enum FORMAT : uint32_t
+	{
+		FORMAT_UNKNOWN              = 0,    //!< 不明なフォーマットです.
+		FORMAT_R32G32B32A32_FLOAT   = 2,    //!< DXGI_FORMAT_R32G32B32A32_FLOAT です.
+		FORMAT_R16G16B16A16_FLOAT   = 10,   //!< DXGI_FORMAT_R16G16B16A16_FLOAT です.
+		FORMAT_R32G32_FLOAT         = 16,   //!< DXGI_FORMAT_R32G32_FLOAT です.
+		FORMAT_R16G16_FLOAT         = 34,   //!< DXGI_FORMAT_R16G16_FLOAT です.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// Key structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Key
+	{
+		uint64_t    SourceHash;     //!< 元テクスチャの内容のハッシュ値です.
+		uint64_t    ShaderHash;     //!< 積分シェーダのハッシュ値です.
+		uint32_t    CubeSize;       //!< 入力キューブマップのサイズです.
+		uint32_t    CubeMipCount;   //!< 入力キューブマップのミップレベル数です.
+		uint32_t    DFGSize;        //!< DFGテクスチャのサイズです.
+		uint32_t    DFGSamples;     //!< DFG項のサンプル数です.
+		uint32_t    LDSize;         //!< LDテクスチャのサイズです.
+		uint32_t    LDMipCount;     //!< SpecularLDテクスチャのミップレベル数です.
+		uint32_t    LDSamples;      //!< LD項のサンプル数です.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// Texture structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Texture
+	{
+		FORMAT                  Format      = FORMAT_UNKNOWN;       //!< フォーマットです.
+		uint32_t                Width       = 0;                    //!< 横幅です.
+		uint32_t                Height      = 0;                    //!< 縦幅です.
+		uint32_t                ArraySize   = 0;                    //!< 配列数です. キューブマップは6です.
+		uint32_t                MipLevels   = 0;                    //!< ミップレベル数です.
+		bool                    Cube        = false;                //!< キューブマップかどうか.
+		std::vector<uint8_t>    Pixels;                             //!< 配列番号・ミップレベルの順に詰めたピクセルです.
+	};
+
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const uint32_t CacheMagic   = 0x434C4249;   //!< DDSの予約領域に書き込む識別子('IBLC')です.
+	static const uint32_t CacheVersion = 1;            //!< ベイク方法やファイル構成を変えたら更新します.
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      DFGテクスチャのキャッシュキーを求めます.
+	//!
+	//! @param[in]      key         ベイク条件です.
+	//! @return     元テクスチャに依存しない項目だけから求めたハッシュ値を返却します.
+	//-------------------------------------------------------------------------
+	static uint64_t HashDFG(const Key& key);
+
+	//-------------------------------------------------------------------------
+	//! @brief      LDテクスチャのキャッシュキーを求めます.
+	//!
+	//! @param[in]      key         ベイク条件です.
+	//! @return     全ての項目から求めたハッシュ値を返却します.
+	//-------------------------------------------------------------------------
+	static uint64_t HashLD(const Key& key);
+
+	//-------------------------------------------------------------------------
+	//! @brief      ファイルの内容のハッシュ値を求めます.
+	//!
+	//! @param[in]      path        ファイルパスです.
+	//! @param[out]     hash        ハッシュ値の格納先です.
+	//! @retval true    計算に成功.
+	//! @retval false   ファイルを読み込めません.
+	//-------------------------------------------------------------------------
+	static bool HashFile(const std::wstring& path, uint64_t& hash);
+
+	//-------------------------------------------------------------------------
+	//! @brief      キャッシュファイルのパスを求めます.
+	//!
+	//! @param[in]      dir         キャッシュディレクトリです.
+	//! @param[in]      tag         テクスチャの種類です.
+	//! @param[in]      hash        キャッシュキーです.
+	//! @return     "dir/tag_0123456789abcdef.dds" 形式のパスを返却します.
+	//-------------------------------------------------------------------------
+	static std::wstring MakePath(const std::wstring& dir, const wchar_t* tag, uint64_t hash);
+
+	//-------------------------------------------------------------------------
+	//! @brief      1ピクセルあたりのバイト数を取得します.
+	//!
+	//! @param[in]      format      フォーマットです.
+	//! @return     1ピクセルあたりのバイト数を返却します. 対応していないフォーマットの場合は 0 です.
+	//-------------------------------------------------------------------------
+	static size_t GetPixelSize(FORMAT format);
+
+	//-------------------------------------------------------------------------
+	//! @brief      テクスチャのピクセルデータのサイズを求めます.
+	//!
+	//! @param[in]      texture     テクスチャです. Pixels は参照しません.
+	//! @return     ピクセルデータのサイズを返却します. 対応していないフォーマットの場合は 0 です.
+	//-------------------------------------------------------------------------
+	static size_t GetDataSize(const Texture& texture);
+
+	//-------------------------------------------------------------------------
+	//! @brief      DDSファイルのデータを構築します.
+	//!
+	//! @param[in]      texture     テクスチャです.
+	//! @param[in]      hash        キャッシュキーです.
+	//! @param[out]     file        ファイルに書き出すデータです.
+	//! @retval true    構築に成功.
+	//! @retval false   フォーマットかピクセルデータのサイズが正しくありません.
+	//-------------------------------------------------------------------------
+	static bool BuildDDS(const Texture& texture, uint64_t hash, std::vector<uint8_t>& file);
+
+	//-------------------------------------------------------------------------
+	//! @brief      DDSファイルのデータを検証して取り出します.
+	//!
+	//! @param[in]      file        ファイルから読み込んだデータです.
+	//! @param[in]      hash        キャッシュキーです.
+	//! @param[in]      expected    期待する構成です. Pixels は参照しません.
+	//! @param[out]     texture     テクスチャの格納先です.
+	//! @retval true    有効なデータです.
+	//! @retval false   識別子・キャッシュキー・構成・サイズのいずれかが一致しません.
+	//-------------------------------------------------------------------------
+	static bool ParseDDS(const std::vector<uint8_t>& file, uint64_t hash, const Texture& expected, Texture& texture);
+
+	//-------------------------------------------------------------------------
+	//! @brief      テクスチャをキャッシュファイルに保存します.
+	//!
+	//! @param[in]      path        ファイルパスです.
+	//! @param[in]      hash        キャッシュキーです.
+	//! @param[in]      texture     テクスチャです.
+	//! @retval true    保存に成功.
+	//! @retval false   保存に失敗.
+	//-------------------------------------------------------------------------
+	static bool Save(const std::wstring& path, uint64_t hash, const Texture& texture);
+
+	//-------------------------------------------------------------------------
+	//! @brief      キャッシュファイルからテクスチャを読み込みます.
+	//!
+	//! @param[in]      path        ファイルパスです.
+	//! @param[in]      hash        キャッシュキーです.
+	//! @param[in]      expected    期待する構成です.
+	//! @param[out]     texture     テクスチャの格納先です.
+	//! @retval true    読み込みに成功.
+	//! @retval false   ファイルが無いか, 内容が一致しません.
+	//-------------------------------------------------------------------------
+	static bool Load(const std::wstring& path, uint64_t hash, const Texture& expected, Texture& texture);
+
+private:
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	IBLCache() = delete;
+	~IBLCache() = delete;
+};
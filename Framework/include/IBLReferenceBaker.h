@@ -0,0 +1,119 @@
+﻿//-----------------------------------------------------------------------------
+// File : IBLReferenceBaker.h
+// Desc : CPU Reference Baker For IBL Textures.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <IBLCache.h>
+#include <cstdint>
+
+///////////////////////////////////////////////////////////////////////////////
+// IBLReferenceBaker class
+///////////////////////////////////////////////////////////////////////////////
+class IBLReferenceBaker
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const uint32_t SequenceCount = 128;  //!< Hammersley点列の1成分目の分母です. BakeUtil.hlsli の SampleCount と一致させます.
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      ビットを反転した値を [0, 1) に変換します.
+	//!
+	//! @param[in]      index       番号です.
+	//! @return     HLSL の reversebits(index) * 2^-32 と同じ値を返却します.
+	//-------------------------------------------------------------------------
+	static float RadicalInverse(uint32_t index);
+
+	//-------------------------------------------------------------------------
+	//! @brief      DFG項を積分します.
+	//!
+	//! @param[in]      size            テクスチャの縦横のサイズです.
+	//! @param[in]      sampleCount     1テクセルあたりのサンプル数です.
+	//! @param[in]      threadCount     使用するスレッド数です. 0 の場合はハードウェアスレッド数です.
+	//! @param[out]     result          IBLBaker の DFG テクスチャと同じ R32G32_FLOAT のテクスチャです.
+	//! @retval true    積分に成功.
+	//! @retval false   引数が不正です.
+	//! @note       IntegrateDFG_PS と同じく, 横方向が NdotV, 縦方向が上から 1 -> 0 の線形ラフネスです.
+	//!             4サンプルずつ SSE で処理し, 行ごとにスレッドへ分配します.
+	//-------------------------------------------------------------------------
+	static bool IntegrateDFG(uint32_t size, uint32_t sampleCount, uint32_t threadCount, IBLCache::Texture& result);
+
+	//-------------------------------------------------------------------------
+	//! @brief      スペキュラーのLD項を積分します.
+	//!
+	//! @param[in]      input           入力キューブマップです(RGBA32F, ミップ付き).
+	//! @param[in]      size            出力の最上位ミップのサイズです.
+	//! @param[in]      mipCount        出力のミップレベル数です. 2 以上を指定します.
+	//! @param[in]      sampleCount     1テクセルあたりのサンプル数です.
+	//! @param[in]      threadCount     使用するスレッド数です. 0 の場合はハードウェアスレッド数です.
+	//! @param[out]     result          IBLBaker の SpecularLD テクスチャと同じ構成のキューブマップです.
+	//! @retval true    積分に成功.
+	//! @retval false   引数が不正です.
+	//! @note       IBLBaker::IntegrateLD() と同じく, ミップごとにラフネスを 1 / (mipCount - 1) ずつ上げます.
+	//!             N = V なのでサンプル方向・重み・ミップレベルは接空間ではテクセルに依らず, ミップごとに一度だけ求めます.
+	//-------------------------------------------------------------------------
+	static bool IntegrateSpecularLD(const IBLCache::Texture& input, uint32_t size, uint32_t mipCount, uint32_t sampleCount, uint32_t threadCount, IBLCache::Texture& result);
+
+	//-------------------------------------------------------------------------
+	//! @brief      1テクセル分のDFG項を IntegrateDFG_PS と同じ手順で積分します.
+	//!
+	//! @note       検証用の参照実装です.
+	//-------------------------------------------------------------------------
+	static void IntegrateDFGTexel(float NdotV, float roughness, uint32_t sampleCount, float result[2]);
+
+	//-------------------------------------------------------------------------
+	//! @brief      1テクセル分のスペキュラーのLD項を IntegrateSpecularLD_PS と同じ手順で積分します.
+	//!
+	//! @param[in]      input           入力キューブマップです.
+	//! @param[in]      dir             テクセルの方向です(正規化済み).
+	//! @param[in]      a               ラフネスの2乗です(CbBake::Roughness).
+	//! @param[in]      sampleCount     サンプル数です.
+	//! @param[out]     result          RGB です.
+	//! @note       検証用の参照実装です.
+	//-------------------------------------------------------------------------
+	static void IntegrateSpecularTexel(const IBLCache::Texture& input, const float dir[3], float a, uint32_t sampleCount, float result[3]);
+
+	//-------------------------------------------------------------------------
+	//! @brief      キューブマップをトライリニアでサンプルします.
+	//!
+	//! @param[in]      input           キューブマップです(RGBA32F).
+	//! @param[in]      dir             方向です.
+	//! @param[in]      lod             ミップレベルです.
+	//! @param[out]     result          RGBA です.
+	//! @note       面の境界はまたがずにクランプします.
+	//-------------------------------------------------------------------------
+	static void SampleCube(const IBLCache::Texture& input, const float dir[3], float lod, float result[4]);
+
+	//-------------------------------------------------------------------------
+	//! @brief      キューブマップのテクセルの方向を BakeUtil.hlsli の CalcDirection() と同じく求めます.
+	//!
+	//! @param[in]      face            面番号です.
+	//! @param[in]      x               横方向のテクセル番号です.
+	//! @param[in]      y               縦方向のテクセル番号です.
+	//! @param[in]      size            面のサイズです.
+	//! @param[out]     dir             正規化した方向です.
+	//-------------------------------------------------------------------------
+	static void GetTexelDirection(uint32_t face, uint32_t x, uint32_t y, uint32_t size, float dir[3]);
+
+private:
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	IBLReferenceBaker() = delete;
+	~IBLReferenceBaker() = delete;
+};
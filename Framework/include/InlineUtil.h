@@ -5,6 +5,12 @@
 //-----------------------------------------------------------------------------
 #pragma once
 
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstddef>
+
 //-----------------------------------------------------------------------------
 //      nullptr を考慮して delete 処理を行います.
 //-----------------------------------------------------------------------------
@@ -56,4 +62,28 @@ inline void SafeTerm(T*& ptr)
 		delete ptr;
 		ptr = nullptr;
 	}
-}
\ No newline at end of file
+}
+
+//-----------------------------------------------------------------------------
+//      バイト列のハッシュ値を求めます(FNV-1a 64bit).
+//-----------------------------------------------------------------------------
+inline uint64_t HashBytes(const void* pData, size_t size, uint64_t seed = 14695981039346656037ull)
+{
+	auto ptr  = static_cast<const uint8_t*>(pData);
+	auto hash = seed;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= ptr[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+//-----------------------------------------------------------------------------
+//      値をハッシュ値に結合します.
+//-----------------------------------------------------------------------------
+template<typename T>
+inline uint64_t HashCombine(uint64_t seed, const T& value)
+{
+	return HashBytes(&value, sizeof(value), seed);
+}
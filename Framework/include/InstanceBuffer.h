@@ -0,0 +1,129 @@
+﻿//-----------------------------------------------------------------------------
+// File : InstanceBuffer.h
+// Desc : Per-Frame Instance Data Buffer Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <d3d12.h>
+#include <ComPtr.h>
+#include <SimpleMath.h>
+#include <App.h>
+#include <atomic>
+
+//-----------------------------------------------------------------------------
+// Forward Declarations.
+//-----------------------------------------------------------------------------
+class DescriptorHandle;
+class DescriptorPool;
+
+///////////////////////////////////////////////////////////////////////////////
+// InstanceData structure
+///////////////////////////////////////////////////////////////////////////////
+struct InstanceData
+{
+	DirectX::SimpleMath::Matrix     World;              //!< ワールド行列です.
+	uint32_t                        MaterialIndex;      //!< マテリアルパラメータブロックの番号です.
+	uint32_t                        Reserved[3];        //!< 16byte境界に揃えるための予約領域です.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// InstanceBuffer class
+///////////////////////////////////////////////////////////////////////////////
+class InstanceBuffer
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	/* NOTHING */
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	InstanceBuffer();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~InstanceBuffer();
+
+	//-------------------------------------------------------------------------
+	//! @brief      初期化処理を行います.
+	//!
+	//! @param[in]      pDevice     デバイスです.
+	//! @param[in]      pPool       ディスクリプタプールです(CBV_UAV_SRV用のものを設定します).
+	//! @param[in]      capacity    1フレームに書き込めるインスタンスの最大数です.
+	//! @retval true    初期化に成功.
+	//! @retval false   初期化に失敗.
+	//-------------------------------------------------------------------------
+	bool Init(ID3D12Device* pDevice, DescriptorPool* pPool, uint32_t capacity);
+
+	//-------------------------------------------------------------------------
+	//! @brief      終了処理を行います.
+	//-------------------------------------------------------------------------
+	void Term();
+
+	//-------------------------------------------------------------------------
+	//! @brief      フレームの書き込みを開始します.
+	//!
+	//! @param[in]      frameIndex  フレーム番号です.
+	//! @note       前回同じフレーム番号で書き込んだ領域は破棄されます.
+	//-------------------------------------------------------------------------
+	void Begin(uint32_t frameIndex);
+
+	//-------------------------------------------------------------------------
+	//! @brief      連続したインスタンス領域を割り当てます.
+	//!
+	//! @param[in]      count       インスタンス数です.
+	//! @param[out]     pFirst      先頭のインスタンス番号の格納先です.
+	//! @return     書き込み先のポインタを返却します. 空きが無い場合は nullptr を返却します.
+	//! @note       複数のスレッドから同時に呼び出せます.
+	//-------------------------------------------------------------------------
+	InstanceData* Alloc(uint32_t count, uint32_t* pFirst);
+
+	//-------------------------------------------------------------------------
+	//! @brief      書き込み中のフレーム用のシェーダリソースビューを取得します.
+	//-------------------------------------------------------------------------
+	D3D12_GPU_DESCRIPTOR_HANDLE GetHandleGPU() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      書き込み中のフレームで割り当てたインスタンス数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetUsedCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      1フレームに書き込めるインスタンスの最大数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetCapacity() const;
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	ComPtr<ID3D12Resource>  m_pBuffer;                      //!< 全フレーム分のバッファです.
+	uint8_t*                m_pMappedPtr;                   //!< マップ済みポインタです.
+	DescriptorHandle*       m_pHandle[App::FrameCount];     //!< フレームごとのビューです.
+	DescriptorPool*         m_pPool;                        //!< ディスクリプタプールです.
+	uint32_t                m_Capacity;                     //!< 1フレームの最大インスタンス数です.
+	uint32_t                m_FrameIndex;                   //!< 書き込み中のフレーム番号です.
+	std::atomic<uint32_t>   m_Used;                         //!< 割り当て済みのインスタンス数です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	InstanceBuffer(const InstanceBuffer&) = delete;
+	void operator = (const InstanceBuffer&) = delete;
+};
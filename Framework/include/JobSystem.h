@@ -0,0 +1,299 @@
+﻿//-----------------------------------------------------------------------------
+// File : JobSystem.h
+// Desc : Work Stealing Job System Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+
+//-----------------------------------------------------------------------------
+// Forward Declarations.
+//-----------------------------------------------------------------------------
+class JobSystem;
+class TaskGraph;
+
+///////////////////////////////////////////////////////////////////////////////
+// Task structure
+///////////////////////////////////////////////////////////////////////////////
+struct Task
+{
+	std::function<void()>   Func;           //!< 実行する関数です.
+	std::vector<Task*>      Successors;     //!< このタスクの完了を待つタスクです.
+	std::atomic<int32_t>    Pending;        //!< 未完了の先行タスク数です.
+	int32_t                 Predecessors;   //!< 先行タスク数です.
+	TaskGraph*              pGraph;         //!< 所属するグラフです.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// WorkStealingDeque class
+///////////////////////////////////////////////////////////////////////////////
+class WorkStealingDeque
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const int64_t Capacity = 4096;   //!< 格納できるタスク数です(2のべき乗).
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	WorkStealingDeque();
+
+	//-------------------------------------------------------------------------
+	//! @brief      所有スレッドが末尾に積みます.
+	//!
+	//! @retval true    積みました.
+	//! @retval false   満杯のため積めませんでした.
+	//-------------------------------------------------------------------------
+	bool Push(Task* pTask);
+
+	//-------------------------------------------------------------------------
+	//! @brief      所有スレッドが末尾から取り出します.
+	//!
+	//! @return     取り出したタスクを返却します. 空の場合は nullptr です.
+	//-------------------------------------------------------------------------
+	Task* Pop();
+
+	//-------------------------------------------------------------------------
+	//! @brief      他のスレッドが先頭から盗みます.
+	//!
+	//! @return     盗んだタスクを返却します. 空か競合した場合は nullptr です.
+	//-------------------------------------------------------------------------
+	Task* Steal();
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	// 盗む側と所有スレッドが同じキャッシュラインを奪い合わないように離して配置します.
+	std::atomic<int64_t>    m_Top;                  //!< 盗まれる側の位置です.
+	uint8_t                 m_Padding0[56];         //!< パディングです.
+	std::atomic<int64_t>    m_Bottom;               //!< 所有スレッド側の位置です.
+	uint8_t                 m_Padding1[56];         //!< パディングです.
+	std::atomic<Task*>      m_Buffer[Capacity];     //!< リングバッファです.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	WorkStealingDeque   (const WorkStealingDeque&) = delete;
+	void operator =     (const WorkStealingDeque&) = delete;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// TaskGraph class
+///////////////////////////////////////////////////////////////////////////////
+class TaskGraph
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	friend class JobSystem;
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	/* NOTHING */
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	TaskGraph();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~TaskGraph();
+
+	//-------------------------------------------------------------------------
+	//! @brief      タスクを追加します.
+	//!
+	//! @param[in]      func        実行する関数です.
+	//! @return     追加したタスクの番号を返却します.
+	//-------------------------------------------------------------------------
+	uint32_t Add(std::function<void()> func);
+
+	//-------------------------------------------------------------------------
+	//! @brief      before の完了後に after を実行するように設定します.
+	//!
+	//! @note       循環させないでください.
+	//-------------------------------------------------------------------------
+	void Precede(uint32_t before, uint32_t after);
+
+	//-------------------------------------------------------------------------
+	//! @brief      全てのタスクを破棄します.
+	//!
+	//! @note       実行中のグラフは破棄できません.
+	//-------------------------------------------------------------------------
+	void Clear();
+
+	//-------------------------------------------------------------------------
+	//! @brief      タスク数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      全てのタスクが完了したかどうかを判定します.
+	//-------------------------------------------------------------------------
+	bool IsDone() const;
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	std::deque<Task>        m_Tasks;        //!< タスクです(追加しても要素は移動しません).
+	std::atomic<uint32_t>   m_Remaining;    //!< 未完了のタスク数です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	TaskGraph       (const TaskGraph&) = delete;
+	void operator = (const TaskGraph&) = delete;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// JobSystem class
+///////////////////////////////////////////////////////////////////////////////
+class JobSystem
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	using RangeFunc = std::function<void(uint32_t begin, uint32_t end)>;
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	JobSystem();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~JobSystem();
+
+	//-------------------------------------------------------------------------
+	//! @brief      初期化処理を行います.
+	//!
+	//! @param[in]      workerCount     呼び出し元を含むワーカー数です. 0 の場合はコア数です.
+	//! @retval true    初期化に成功.
+	//! @retval false   初期化に失敗.
+	//! @note       呼び出し元のスレッドがワーカー0になり, Run() や Wait() はこのスレッドから呼び出します.
+	//-------------------------------------------------------------------------
+	bool Init(uint32_t workerCount = 0);
+
+	//-------------------------------------------------------------------------
+	//! @brief      終了処理を行います.
+	//-------------------------------------------------------------------------
+	void Term();
+
+	//-------------------------------------------------------------------------
+	//! @brief      グラフの実行を開始します.
+	//!
+	//! @note       先行タスクのないタスクから積み, 完了に合わせて後続を積みます.
+	//-------------------------------------------------------------------------
+	void Run(TaskGraph& graph);
+
+	//-------------------------------------------------------------------------
+	//! @brief      グラフの完了を待ちます.
+	//!
+	//! @note       待つ間は呼び出し元もタスクを実行します. タスクの中から呼び出しても構いません.
+	//-------------------------------------------------------------------------
+	void Wait(TaskGraph& graph);
+
+	//-------------------------------------------------------------------------
+	//! @brief      [0, count) を grain 個ずつに分けて並列に実行し, 完了を待ちます.
+	//!
+	//! @param[in]      count       要素数です.
+	//! @param[in]      grain       1タスクあたりの要素数です.
+	//! @param[in]      func        [begin, end) を処理する関数です.
+	//-------------------------------------------------------------------------
+	void ParallelFor(uint32_t count, uint32_t grain, const RangeFunc& func);
+
+	//-------------------------------------------------------------------------
+	//! @brief      ワーカー数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetWorkerCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      呼び出し元のワーカー番号を取得します. ワーカー以外は GetWorkerCount() を返却します.
+	//-------------------------------------------------------------------------
+	uint32_t GetWorkerIndex() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      他のワーカーから盗んだタスク数を取得します.
+	//-------------------------------------------------------------------------
+	uint64_t GetStealCount() const;
+
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// Worker structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Worker
+	{
+		WorkStealingDeque   Deque;          //!< タスクの両端キューです.
+		std::thread         Thread;         //!< スレッドです(ワーカー0は呼び出し元).
+		uint32_t            Random;         //!< 盗む相手を選ぶ乱数の状態です.
+	};
+
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	std::vector<std::unique_ptr<Worker>>    m_Workers;      //!< ワーカーです.
+	std::mutex                              m_Mutex;        //!< 待機・外部キュー用のミューテックスです.
+	std::condition_variable                 m_WakeCV;       //!< 待機中のワーカーを起こします.
+	std::deque<Task*>                       m_Overflow;     //!< 満杯時やワーカー以外から積まれたタスクです.
+	std::atomic<int32_t>                    m_Overflows;    //!< 外部キューのタスク数です.
+	std::atomic<int32_t>                    m_Queued;       //!< 積まれて未取得のタスク数です.
+	std::atomic<int32_t>                    m_Sleepers;     //!< 待機中のワーカー数です.
+	std::atomic<uint64_t>                   m_Steals;       //!< 盗んだタスク数です.
+	std::atomic<bool>                       m_Quit;         //!< 終了要求です.
+	JobSystem*                              m_pPrevSystem;  //!< Init() 前に呼び出し元が属していたジョブシステムです.
+	uint32_t                                m_PrevIndex;    //!< Init() 前の呼び出し元のワーカー番号です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	void  Push(Task* pTask);
+	Task* Acquire(uint32_t index);
+	void  Execute(Task* pTask);
+	void  WorkerMain(uint32_t index);
+
+	JobSystem       (const JobSystem&) = delete;
+	void operator = (const JobSystem&) = delete;
+};
@@ -5,7 +5,7 @@
 static std::random_device   rd;
 static std::mt19937         gen(rd());
 
-// N\
+// クソが
 #ifdef max
 #undef max
 #endif
@@ -16,6 +16,8 @@
 #include <ModelShader.h>
 #include <CommonBufferManager.h>
 #include <SkyTextureManager.h>
+#include <FallbackTexture.h>
+#include <MaterialInstance.h>
 
 class ModelShader;
 class CommonBufferManager;
@@ -28,7 +30,7 @@ class Material
 	//=========================================================================
 	// list of friend classes and method.
 	//=========================================================================
-	/* NOTHING */
+	friend class MaterialInstance;
 
 public:
 	///////////////////////////////////////////////////////////////////////////
@@ -80,7 +82,7 @@ public:
 	//! @param[in]      pDevice         デバイスです.
 	//! @param[in]      pPool           ディスクリプタプールです(CBV_UAV_SRV用のものを設定します).
 	//! @param[in]      bufferSize      1マテリアルあたりの定数バッファのサイズです.
-	//! @param[in]      count           マテリアル数です.
+	//! @param[in]      count           サブセット数です.
 	//! @retval true    初期化に成功.
 	//! @retval false   初期化に失敗.
 	//-------------------------------------------------------------------------
@@ -96,7 +98,32 @@ public:
 	void Term();
 
 	bool SetShaderPtr(ModelShader* pShader);
-	bool SetMaterial(ID3D12GraphicsCommandList* pCmd, int frameindex, Material& mat, int id, const ConstantBuffer* meshCB, const CommonBufferManager& commonbufmanager, const SkyManager& skyManager);
+	ModelShader* GetShaderPtr() const;
+	bool SetMaterial(ID3D12GraphicsCommandList* pCmd, int frameindex, Material& mat, int id, const MaterialInstance* pInstance, const ConstantBuffer* meshCB, const CommonBufferManager& commonbufmanager, const SkyManager& skyManager);
+
+	//-------------------------------------------------------------------------
+	//! @brief      インスタンスの既定パラメータを設定します.
+	//!
+	//! @param[in]      slot        パラメータ番号です.
+	//! @param[in]      value       設定する値です.
+	//! @note       上書きしていないインスタンスにのみ反映されます.
+	//-------------------------------------------------------------------------
+	void SetDefaultParam(uint32_t slot, const DirectX::SimpleMath::Vector4& value);
+
+	//-------------------------------------------------------------------------
+	//! @brief      インスタンスの既定パラメータを取得します.
+	//-------------------------------------------------------------------------
+	const DirectX::SimpleMath::Vector4& GetDefaultParam(uint32_t slot) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      インスタンスの既定パラメータブロックを取得します.
+	//-------------------------------------------------------------------------
+	const MaterialParamBlock& GetDefaultParams() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      このマテリアルを参照しているインスタンス数を取得します.
+	//-------------------------------------------------------------------------
+	size_t GetInstanceCount() const;
 
 	//-------------------------------------------------------------------------
 	//! @brief      テクスチャを設定します.
@@ -125,6 +152,20 @@ public:
 		DirectX::ResourceUploadBatch& batch,
 		bool isSRGB);
 
+	//-------------------------------------------------------------------------
+	//! @brief      共有のフォールバックテクスチャを設定します.
+	//!
+	//! @param[in]      index       マテリアル番号です.
+	//! @param[in]      usage       テクスチャの使用用途です.
+	//! @param[in]      type        フォールバックテクスチャの種類です.
+	//! @retval true    設定に成功.
+	//! @retval false   設定に失敗.
+	//-------------------------------------------------------------------------
+	bool SetFallbackTexture(
+		size_t                          index,
+		TEXTURE_USAGE                   usage,
+		FallbackTexture::TYPE           type);
+
 	//-------------------------------------------------------------------------
 	//! @brief      定数バッファのポインタを取得します.
 	//!
@@ -172,6 +213,15 @@ public:
 	//-------------------------------------------------------------------------
 	D3D12_GPU_DESCRIPTOR_HANDLE GetTextureHandle(size_t index, TEXTURE_USAGE usage) const;
 
+	//-------------------------------------------------------------------------
+	//! @brief      バインドレス描画用のテクスチャ番号を取得します.
+	//!
+	//! @param[in]      index       取得するマテリアル番号です.
+	//! @param[in]      usage       取得するテクスチャの使用用途です.
+	//! @return     ディスクリプタヒープ先頭からのテクスチャ番号を返却します.
+	//-------------------------------------------------------------------------
+	uint32_t GetTextureIndex(size_t index, TEXTURE_USAGE usage) const;
+
 	//-------------------------------------------------------------------------
 	//! @brief      マテリアル数を取得します.
 	//!
@@ -179,6 +229,15 @@ public:
 	//-------------------------------------------------------------------------
 	size_t GetCount() const;
 
+	//-------------------------------------------------------------------------
+	//! @brief      所有しているリソース数を取得します.
+	//!
+	//! @return     定数バッファとテクスチャのコミットリソース数を返却します.
+	//! @note       共有のフォールバックテクスチャは含みません.
+	//!             どのリソースもディスクリプタを1つずつ使用します.
+	//-------------------------------------------------------------------------
+	size_t GetResourceCount() const;
+
 	DescriptorPool* GetPool() {
 		return m_pPool;
 	};
@@ -199,12 +258,17 @@ private:
 	std::map<std::wstring, Texture*>    m_pTexture;     //!< テクスチャです.
 	std::vector<Subset>                 m_Subset;       //!< サブセットです.
 	ModelShader*								m_pShader;
+	MaterialParamBlock                  m_DefaultParam; //!< インスタンスの既定パラメータです.
+	std::vector<MaterialInstance*>      m_Instances;    //!< 参照しているインスタンスです.
 	ID3D12Device* m_pDevice;      //!< デバイスです.
 	DescriptorPool* m_pPool;        //!< ディスクリプタプールです(CBV_UAV_SRV).
 
 	//=========================================================================
 	// private methods.
 	//=========================================================================
+	void AddInstance(MaterialInstance* pInstance);
+	void RemoveInstance(MaterialInstance* pInstance);
+
 	Material(const Material&) = delete;
 	void operator = (const Material&) = delete;
 };
\ No newline at end of file
@@ -0,0 +1,125 @@
+﻿//-----------------------------------------------------------------------------
+// File : MaterialInstance.h
+// Desc : Material Instance Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <MaterialParamBuffer.h>
+
+//-----------------------------------------------------------------------------
+// Forward Declarations.
+//-----------------------------------------------------------------------------
+class Material;
+
+///////////////////////////////////////////////////////////////////////////////
+// MaterialInstance class
+///////////////////////////////////////////////////////////////////////////////
+//! テンプレート(Material)の既定パラメータに対して, 変更したスロットだけを保持します.
+//! 解決済みのパラメータは MaterialParamBuffer 上の1ブロックに詰めて配置されます.
+class MaterialInstance
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	friend class Material;
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	/* NOTHING */
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	MaterialInstance();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~MaterialInstance();
+
+	//-------------------------------------------------------------------------
+	//! @brief      初期化処理を行います.
+	//!
+	//! @param[in]      pTemplate   参照するテンプレートです.
+	//! @param[in]      pBuffer     パラメータを格納するバッファです.
+	//! @retval true    初期化に成功.
+	//! @retval false   初期化に失敗.
+	//-------------------------------------------------------------------------
+	bool Init(Material* pTemplate, MaterialParamBuffer* pBuffer);
+
+	//-------------------------------------------------------------------------
+	//! @brief      終了処理を行います.
+	//-------------------------------------------------------------------------
+	void Term();
+
+	//-------------------------------------------------------------------------
+	//! @brief      パラメータを上書きします.
+	//-------------------------------------------------------------------------
+	void SetParam(uint32_t slot, const DirectX::SimpleMath::Vector4& value);
+
+	//-------------------------------------------------------------------------
+	//! @brief      上書きを解除し, テンプレートの既定値に戻します.
+	//-------------------------------------------------------------------------
+	void ResetParam(uint32_t slot);
+
+	//-------------------------------------------------------------------------
+	//! @brief      解決済みのパラメータを取得します.
+	//-------------------------------------------------------------------------
+	DirectX::SimpleMath::Vector4 GetParam(uint32_t slot) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      指定スロットを上書きしているかどうか.
+	//-------------------------------------------------------------------------
+	bool IsOverridden(uint32_t slot) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      テンプレートを取得します.
+	//-------------------------------------------------------------------------
+	Material* GetTemplate() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      パラメータバッファ上のブロック番号を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetIndex() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      パラメータバッファを取得します.
+	//-------------------------------------------------------------------------
+	MaterialParamBuffer* GetBuffer() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      インスタンスが使用しているCPUメモリのバイト数を取得します.
+	//!
+	//! @note       パラメータバッファ側のブロックは含みません.
+	//-------------------------------------------------------------------------
+	size_t GetMemorySize() const;
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	Material*                                   m_pTemplate;        //!< テンプレートです.
+	MaterialParamBuffer*                        m_pBuffer;          //!< パラメータバッファです.
+	uint32_t                                    m_Index;            //!< ブロック番号です.
+	uint16_t                                    m_OverrideMask;     //!< 上書きしているスロットのビットマスクです.
+	std::vector<DirectX::SimpleMath::Vector4>   m_Overrides;        //!< 上書き値です(スロット番号順).
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	uint32_t GetOverrideOffset(uint32_t slot) const;
+	void Resolve();
+
+	MaterialInstance(const MaterialInstance&) = delete;
+	void operator = (const MaterialInstance&) = delete;
+};
@@ -0,0 +1,156 @@
+﻿//-----------------------------------------------------------------------------
+// File : MaterialParamBuffer.h
+// Desc : Packed Material Parameter Buffer Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <d3d12.h>
+#include <ComPtr.h>
+#include <SimpleMath.h>
+#include <App.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Forward Declarations.
+//-----------------------------------------------------------------------------
+class DescriptorHandle;
+class DescriptorPool;
+
+///////////////////////////////////////////////////////////////////////////////
+// MaterialParamBlock structure
+///////////////////////////////////////////////////////////////////////////////
+struct MaterialParamBlock
+{
+	static const uint32_t ParamCount = 16;                  //!< パラメータ数です.
+
+	DirectX::SimpleMath::Vector4    Param[ParamCount];      //!< パラメータです.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// MaterialParamBuffer class
+///////////////////////////////////////////////////////////////////////////////
+class MaterialParamBuffer
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	/* NOTHING */
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	MaterialParamBuffer();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~MaterialParamBuffer();
+
+	//-------------------------------------------------------------------------
+	//! @brief      初期化処理を行います.
+	//!
+	//! @param[in]      pDevice     デバイスです.
+	//! @param[in]      pPool       ディスクリプタプールです(CBV_UAV_SRV用のものを設定します).
+	//! @param[in]      capacity    格納できるパラメータブロックの最大数です.
+	//! @retval true    初期化に成功.
+	//! @retval false   初期化に失敗.
+	//-------------------------------------------------------------------------
+	bool Init(ID3D12Device* pDevice, DescriptorPool* pPool, uint32_t capacity);
+
+	//-------------------------------------------------------------------------
+	//! @brief      終了処理を行います.
+	//-------------------------------------------------------------------------
+	void Term();
+
+	//-------------------------------------------------------------------------
+	//! @brief      パラメータブロックを割り当てます.
+	//!
+	//! @return     ブロック番号を返却します. 空きが無い場合は UINT32_MAX を返却します.
+	//-------------------------------------------------------------------------
+	uint32_t Alloc();
+
+	//-------------------------------------------------------------------------
+	//! @brief      パラメータブロックを解放します.
+	//-------------------------------------------------------------------------
+	void Free(uint32_t index);
+
+	//-------------------------------------------------------------------------
+	//! @brief      パラメータブロックを書き込み, 全フレーム分の転送を予約します.
+	//-------------------------------------------------------------------------
+	void Write(uint32_t index, const MaterialParamBlock& block);
+
+	//-------------------------------------------------------------------------
+	//! @brief      指定フレーム用のバッファへ変更されたブロックのみを転送します.
+	//-------------------------------------------------------------------------
+	void Update(uint32_t frameIndex);
+
+	//-------------------------------------------------------------------------
+	//! @brief      指定フレーム用のシェーダリソースビューを取得します.
+	//-------------------------------------------------------------------------
+	D3D12_GPU_DESCRIPTOR_HANDLE GetHandleGPU(uint32_t frameIndex) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      CPU側のパラメータブロックを取得します.
+	//-------------------------------------------------------------------------
+	const MaterialParamBlock& GetBlock(uint32_t index) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      割り当て済みのブロック数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetAllocatedCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      いずれかのフレームへの転送が残っているブロック数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetPendingCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      直前の Update() で転送したブロック数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetLastUploadCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      CPU側で確保しているバイト数を取得します.
+	//-------------------------------------------------------------------------
+	size_t GetCpuMemorySize() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      GPU側で確保しているバイト数を取得します(全フレーム分).
+	//-------------------------------------------------------------------------
+	size_t GetGpuMemorySize() const;
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	ComPtr<ID3D12Resource>              m_pBuffer;                          //!< 全フレーム分のバッファです.
+	uint8_t*                            m_pMappedPtr;                       //!< マップ済みポインタです.
+	DescriptorHandle*                   m_pHandle[App::FrameCount];         //!< フレームごとのビューです.
+	DescriptorPool*                     m_pPool;                            //!< ディスクリプタプールです.
+	uint32_t                            m_Capacity;                         //!< 最大ブロック数です.
+	std::vector<MaterialParamBlock>     m_Blocks;                           //!< 連続配置したパラメータブロックです.
+	std::vector<uint8_t>                m_DirtyFrames;                      //!< 未転送のフレームのビットマスクです.
+	std::vector<uint32_t>               m_DirtyList;                        //!< 未転送のブロック番号です.
+	std::vector<uint32_t>               m_FreeList;                         //!< 空きブロック番号です.
+	uint32_t                            m_LastUploadCount;                  //!< 直前に転送したブロック数です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	MaterialParamBuffer(const MaterialParamBuffer&) = delete;
+	void operator = (const MaterialParamBuffer&) = delete;
+};
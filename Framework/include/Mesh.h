@@ -64,6 +64,14 @@ public:
 	//-------------------------------------------------------------------------
 	void Draw(ID3D12GraphicsCommandList* pCmdList);
 
+	//-------------------------------------------------------------------------
+	//! @brief      インスタンス描画を行います.
+	//!
+	//! @param[in]      pCmdList        コマンドリストです.
+	//! @param[in]      instanceCount   インスタンス数です.
+	//-------------------------------------------------------------------------
+	void Draw(ID3D12GraphicsCommandList* pCmdList, uint32_t instanceCount);
+
 	//-------------------------------------------------------------------------
 	//! @brief      マテリアルIDを取得します.
 	//!
@@ -71,6 +79,23 @@ public:
 	//-------------------------------------------------------------------------
 	uint32_t GetMaterialId() const;
 
+	//-------------------------------------------------------------------------
+	//! @brief      ローカル空間でのAABBの最小値を取得します.
+	//-------------------------------------------------------------------------
+	const DirectX::XMFLOAT3& GetBoundsMin() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      ローカル空間でのAABBの最大値を取得します.
+	//-------------------------------------------------------------------------
+	const DirectX::XMFLOAT3& GetBoundsMax() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      ローカル空間での境界球を取得します.
+	//!
+	//! @return     xyz に中心, w に半径を格納した値を返却します.
+	//-------------------------------------------------------------------------
+	const DirectX::XMFLOAT4& GetBoundingSphere() const;
+
 private:
 	//=========================================================================
 	// private variables.
@@ -79,6 +104,9 @@ private:
 	IndexBuffer     m_IB;               //!< インデックスバッファです.
 	uint32_t        m_MaterialId;       //!< マテリアルIDです.
 	uint32_t        m_IndexCount;       //!< インデックス数です.
+	DirectX::XMFLOAT3 m_BoundsMin;      //!< AABBの最小値です.
+	DirectX::XMFLOAT3 m_BoundsMax;      //!< AABBの最大値です.
+	DirectX::XMFLOAT4 m_BoundingSphere; //!< 境界球です.
 
 	//=========================================================================
 	// private methods.
@@ -7,6 +7,8 @@
 #include <ModelShader.h>
 #include <ResourceManager.h>
 #include <SkyTextureManager.h>
+#include <MaterialInstance.h>
+#include <RenderQueue.h>
 
 class Model
 {
@@ -15,12 +17,18 @@ public:
 	~Model() = default;
 	void Release();
 
-	ConstantBuffer		m_MeshCB[App::FrameCount];           //!< bVpobt@ł.
+	ConstantBuffer		m_MeshCB[App::FrameCount];           //!< メッシュ用バッファです.
 	std::wstring		m_ModelPath;
+	std::vector<MaterialInstance*>	m_MaterialInstances;	//!< マテリアルごとのインスタンスです.
+	DirectX::XMFLOAT3	m_BoundsMin = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);	//!< 全メッシュを囲むローカル空間のAABBの最小値です.
+	DirectX::XMFLOAT3	m_BoundsMax = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);	//!< 全メッシュを囲むローカル空間のAABBの最大値です.
 
 
-	bool LoadModel(std::wstring filePath, ComPtr<ID3D12Device> pDevice, DescriptorPool* resPool, ComPtr<ID3D12CommandQueue> commandQueue);
+	bool LoadModel(std::wstring filePath, ComPtr<ID3D12Device> pDevice, DescriptorPool* resPool, ComPtr<ID3D12CommandQueue> commandQueue, MaterialParamBuffer* pParamBuffer);
 	std::vector<Material*> GetMaterials();
+	const std::vector<MaterialInstance*>& GetMaterialInstances() const;
+	const DirectX::XMFLOAT3& GetBoundsMin() const;
+	const DirectX::XMFLOAT3& GetBoundsMax() const;
 	void SetTexture(Material* mat, Material::TEXTURE_USAGE usage, std::wstring path, ComPtr<ID3D12Device> pDevice, DescriptorPool* resPool, bool isSRGB, DirectX::ResourceUploadBatch& batch, AppResourceManager& manager);
 	
 	bool CreateMeshBuffer(ComPtr<ID3D12Device> pDevice, DescriptorPool* resPool);
@@ -28,6 +36,8 @@ public:
 	
 	void DrawModel(ID3D12GraphicsCommandList* pCmd, int frameIndex, CommonBufferManager& commonBufferManager, const SkyManager& manager);
 	void DrawModelRaw(ID3D12GraphicsCommandList* pCmd, int frameIndex);
+	void DrawModelInstanced(ID3D12GraphicsCommandList* pCmd, uint32_t instanceCount);
+	void PushDrawItems(RenderQueue& queue, RenderQueue::PASS pass, const DirectX::XMFLOAT4X4& world, float viewDepth);
 private:
 
 };
\ No newline at end of file
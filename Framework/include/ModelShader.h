@@ -12,6 +12,7 @@
 #include <Renderer.h>
 
 class Material;
+class MaterialInstance;
 class CommonBufferManager;
 
 class ModelShader : public Renderer {
@@ -23,8 +24,56 @@ public:
 		int frameindex,
 		Material& mat,
 		int id,
+		const MaterialInstance* pInstance,
 		const ConstantBuffer* meshCB,
 		const CommonBufferManager& commonbufmanager,
 		const SkyManager& manager
-	)  = 0;
+	);
+
+	// ルートシグニチャ・PSOとパス内で共通のバッファを設定する.
+	// ルートシグニチャを設定し直すため、以降のマテリアル・ドローの設定は全てやり直しになる.
+	virtual void SetPassState(
+		ID3D12GraphicsCommandList* pCmd,
+		int frameindex,
+		const CommonBufferManager& commonbufmanager,
+		const SkyManager& manager
+	) = 0;
+
+	// マテリアルごとに異なる定数バッファ・テクスチャを設定する.
+	virtual void SetMaterialState(
+		ID3D12GraphicsCommandList* pCmd,
+		int frameindex,
+		Material& mat,
+		int id,
+		const MaterialInstance* pInstance
+	) = 0;
+
+	// ドローごとに異なるメッシュバッファを設定する.
+	virtual void SetMeshState(
+		ID3D12GraphicsCommandList* pCmd,
+		int frameindex,
+		const ConstantBuffer* meshCB
+	) = 0;
+
+	// ドローごとに異なるインスタンス番号を設定する.
+	virtual void SetInstanceState(
+		ID3D12GraphicsCommandList* pCmd,
+		const MaterialInstance* pInstance
+	) = 0;
+
+	// インスタンス描画用のPSOを持つかどうか.
+	virtual bool SupportsInstancing() const;
+
+	// 通常描画とインスタンス描画のPSOを切り替える.
+	virtual void SetPipelineVariant(
+		ID3D12GraphicsCommandList* pCmd,
+		bool instanced
+	);
+
+	// インスタンスバッファと, このドローの先頭インスタンス番号を設定する.
+	virtual void SetInstanceRange(
+		ID3D12GraphicsCommandList* pCmd,
+		D3D12_GPU_DESCRIPTOR_HANDLE instances,
+		uint32_t offset
+	);
 };
\ No newline at end of file
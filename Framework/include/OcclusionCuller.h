@@ -0,0 +1,239 @@
+﻿//-----------------------------------------------------------------------------
+// File : OcclusionCuller.h
+// Desc : Software Occlusion Culling Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <ResMesh.h>
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+///////////////////////////////////////////////////////////////////////////////
+// OcclusionCuller class
+///////////////////////////////////////////////////////////////////////////////
+class OcclusionCuller
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	///////////////////////////////////////////////////////////////////////////
+	// Occluder structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Occluder
+	{
+		std::vector<DirectX::XMFLOAT3>  Positions;      //!< ローカル空間の頂点位置です.
+		std::vector<uint32_t>           Indices;        //!< 三角形リストの頂点番号です.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// Stats structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Stats
+	{
+		uint32_t    Occluders;          //!< 描画した遮蔽物の数です.
+		uint32_t    Triangles;          //!< 入力された三角形数です.
+		uint32_t    Rasterized;         //!< クリップ後に描画した三角形数です.
+		uint32_t    Tested;             //!< 判定した被遮蔽物の数です.
+		uint32_t    Occluded;           //!< 遮蔽されていると判定した数です.
+		double      SetupMicroSec;      //!< 頂点変換・ビニングにかかった時間(マイクロ秒)です.
+		double      RasterMicroSec;     //!< ラスタライズ・階層深度の構築にかかった時間(マイクロ秒)です.
+	};
+
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const uint32_t TileWidth   = 32;     //!< タイルの横幅(ピクセル)です.
+	static const uint32_t TileHeight  = 32;     //!< タイルの縦幅(ピクセル)です.
+	static const uint32_t BlockSize   = 8;      //!< 階層深度の1要素が受け持つ縦横のピクセル数です.
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	OcclusionCuller();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~OcclusionCuller();
+
+	//-------------------------------------------------------------------------
+	//! @brief      初期化処理を行います.
+	//!
+	//! @param[in]      width       深度バッファの横幅です.
+	//! @param[in]      height      深度バッファの縦幅です.
+	//! @param[in]      threadCount 呼び出し元以外に起動するワーカースレッド数です.
+	//! @retval true    初期化に成功.
+	//! @retval false   初期化に失敗.
+	//-------------------------------------------------------------------------
+	bool Init(uint32_t width, uint32_t height, uint32_t threadCount);
+
+	//-------------------------------------------------------------------------
+	//! @brief      終了処理を行います.
+	//-------------------------------------------------------------------------
+	void Term();
+
+	//-------------------------------------------------------------------------
+	//! @brief      フレームを開始します.
+	//!
+	//! @param[in]      viewProj    行ベクトル形式(v * M)のビュー射影行列です.
+	//-------------------------------------------------------------------------
+	void Begin(const DirectX::XMFLOAT4X4& viewProj);
+
+	//-------------------------------------------------------------------------
+	//! @brief      遮蔽物を追加します.
+	//!
+	//! @param[in]      pOccluder   遮蔽物です. Render() まで保持してください.
+	//! @param[in]      world       ワールド行列です.
+	//-------------------------------------------------------------------------
+	void AddOccluder(const Occluder* pOccluder, const DirectX::XMFLOAT4X4& world);
+
+	//-------------------------------------------------------------------------
+	//! @brief      遮蔽物を深度バッファに描画し, 階層深度を構築します.
+	//!
+	//! @note       タイルごとにワーカースレッドへ分配し, 4ピクセルずつ SSE で処理します.
+	//-------------------------------------------------------------------------
+	void Render();
+
+	//-------------------------------------------------------------------------
+	//! @brief      ワールド空間のAABBが見えるかどうかを判定します.
+	//!
+	//! @param[in]      center      中心です.
+	//! @param[in]      extent      半分の大きさです.
+	//! @retval true    見える可能性があります.
+	//! @retval false   遮蔽物に完全に隠れています.
+	//-------------------------------------------------------------------------
+	bool TestAABB(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extent);
+
+	//-------------------------------------------------------------------------
+	//! @brief      Render() と同じ三角形を1スレッド・1ピクセルずつ描画します.
+	//!
+	//! @param[out]     depth       深度の格納先です(GetPitch() x GetHeight()).
+	//! @note       Render() の検証用の参照実装です.
+	//-------------------------------------------------------------------------
+	void RenderReference(std::vector<float>& depth) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      ResMesh から遮蔽物を生成します.
+	//!
+	//! @param[in]      meshes          メッシュです.
+	//! @param[in]      maxTriangles    許容する三角形数です.
+	//! @param[out]     occluder        遮蔽物の格納先です.
+	//! @retval true    生成に成功.
+	//! @retval false   三角形数が多すぎるため遮蔽物にしません.
+	//-------------------------------------------------------------------------
+	static bool BuildOccluder(const std::vector<ResMesh>& meshes, uint32_t maxTriangles, Occluder& occluder);
+
+	//-------------------------------------------------------------------------
+	//! @brief      深度バッファを取得します.
+	//-------------------------------------------------------------------------
+	const float* GetDepth() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      深度バッファの1行の要素数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetPitch() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      深度バッファの横幅を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetWidth() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      深度バッファの縦幅を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetHeight() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      ワーカースレッド数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetThreadCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      直前のフレームの統計情報を取得します.
+	//-------------------------------------------------------------------------
+	const Stats& GetStats() const;
+
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// Triangle structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Triangle
+	{
+		float       EdgeA[3];   //!< 辺関数の x の係数です.
+		float       EdgeB[3];   //!< 辺関数の y の係数です.
+		float       EdgeC[3];   //!< 辺関数の定数項です.
+		float       DepthA;     //!< 深度平面の x の係数です.
+		float       DepthB;     //!< 深度平面の y の係数です.
+		float       DepthC;     //!< 深度平面の定数項です.
+		int32_t     MinX;       //!< 外接矩形の左端です.
+		int32_t     MinY;       //!< 外接矩形の上端です.
+		int32_t     MaxX;       //!< 外接矩形の右端です.
+		int32_t     MaxY;       //!< 外接矩形の下端です.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// DrawOccluder structure
+	///////////////////////////////////////////////////////////////////////////
+	struct DrawOccluder
+	{
+		const Occluder*     pOccluder;  //!< 遮蔽物です.
+		DirectX::XMFLOAT4X4 World;      //!< ワールド行列です.
+	};
+
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	uint32_t                            m_Width;        //!< 横幅です.
+	uint32_t                            m_Height;       //!< 縦幅です.
+	uint32_t                            m_Pitch;        //!< タイル境界に揃えた横幅です.
+	uint32_t                            m_PaddedHeight; //!< タイル境界に揃えた縦幅です.
+	uint32_t                            m_TilesX;       //!< 横方向のタイル数です.
+	uint32_t                            m_TilesY;       //!< 縦方向のタイル数です.
+	uint32_t                            m_BlocksX;      //!< 横方向の階層深度の要素数です.
+	uint32_t                            m_BlocksY;      //!< 縦方向の階層深度の要素数です.
+	DirectX::XMFLOAT4X4                 m_ViewProj;     //!< ビュー射影行列です.
+	std::vector<float>                  m_Depth;        //!< 深度バッファです.
+	std::vector<float>                  m_HiZ;          //!< ブロックごとの最大深度です.
+	std::vector<Triangle>               m_Triangles;    //!< セットアップ済みの三角形です.
+	std::vector<std::vector<uint32_t>>  m_Bins;         //!< タイルごとの三角形番号です.
+	std::vector<DrawOccluder>           m_Occluders;    //!< 描画する遮蔽物です.
+	std::vector<DirectX::XMFLOAT4>      m_ClipPositions;//!< クリップ空間の頂点位置の作業領域です.
+	Stats                               m_Stats;        //!< 統計情報です.
+
+	std::vector<std::thread>            m_Workers;      //!< ワーカースレッドです.
+	std::mutex                          m_Mutex;        //!< 開始・完了通知用のミューテックスです.
+	std::condition_variable             m_StartCV;      //!< 開始通知です.
+	std::condition_variable             m_DoneCV;       //!< 完了通知です.
+	std::atomic<uint32_t>               m_NextTile;     //!< 次に処理するタイル番号です.
+	uint32_t                            m_Generation;   //!< 処理の世代番号です.
+	uint32_t                            m_Running;      //!< 処理中のワーカー数です.
+	bool                                m_Quit;         //!< 終了要求です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	void SetupTriangles();
+	void AddTriangle(const DirectX::XMFLOAT4& c0, const DirectX::XMFLOAT4& c1, const DirectX::XMFLOAT4& c2);
+	void RasterizeTiles();
+	void RasterizeTile(uint32_t tile);
+	void WorkerMain();
+
+	OcclusionCuller (const OcclusionCuller&) = delete;
+	void operator = (const OcclusionCuller&) = delete;
+};
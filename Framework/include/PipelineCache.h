@@ -0,0 +1,233 @@
+﻿//-----------------------------------------------------------------------------
+// File : PipelineCache.h
+// Desc : Pipeline State Cache Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <d3d12.h>
+#include <ComPtr.h>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+
+///////////////////////////////////////////////////////////////////////////////
+// PipelineCache class
+///////////////////////////////////////////////////////////////////////////////
+class PipelineCache
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	///////////////////////////////////////////////////////////////////////////
+	// Stats structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Stats
+	{
+		uint32_t    Requests;       //!< 要求されたパイプラインステート数です.
+		uint32_t    MemoryHits;     //!< 生成済みのものを共有した数です.
+		uint32_t    LibraryHits;    //!< パイプラインライブラリから読み込んだ数です.
+		uint32_t    Compiled;       //!< ドライバでコンパイルした数です.
+		uint32_t    Stored;         //!< パイプラインライブラリに追加した数です.
+		double      MilliSec;       //!< 読み込みとコンパイルにかかった時間(ミリ秒)です.
+		uint32_t    RootRequests;   //!< 要求されたルートシグニチャ数です.
+		uint32_t    RootHits;       //!< 生成済みのルートシグニチャを共有した数です.
+	};
+
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const uint32_t FileMagic   = 0x4C4F5350;    //!< ファイル識別子('PSOL')です.
+	static const uint32_t FileVersion = 1;             //!< ハッシュの計算方法を変えたら更新します.
+	static const size_t   NameLength  = 21;            //!< 終端を含む名前の長さです.
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      インスタンスを取得します.
+	//-------------------------------------------------------------------------
+	static PipelineCache& GetInstance()
+	{
+		static PipelineCache instance;
+		return instance;
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      初期化処理を行います.
+	//!
+	//! @param[in]      pDevice     デバイスです.
+	//! @param[in]      path        パイプラインライブラリのファイルパスです.
+	//! @retval true    初期化に成功.
+	//! @retval false   初期化に失敗.
+	//! @note       パイプラインライブラリに対応していない場合もメモリ上の共有は行います.
+	//-------------------------------------------------------------------------
+	bool Init(ID3D12Device* pDevice, const wchar_t* path);
+
+	//-------------------------------------------------------------------------
+	//! @brief      終了処理を行います.
+	//-------------------------------------------------------------------------
+	void Term();
+
+	//-------------------------------------------------------------------------
+	//! @brief      追加したパイプラインステートをファイルに保存します.
+	//!
+	//! @retval true    保存に成功したか, 保存する必要がありません.
+	//! @retval false   保存に失敗.
+	//-------------------------------------------------------------------------
+	bool Save();
+
+	//-------------------------------------------------------------------------
+	//! @brief      ルートシグニチャを取得します.
+	//!
+	//! @param[in]      pDevice     デバイスです.
+	//! @param[in]      pBlob       シリアライズしたルートシグニチャです.
+	//! @param[in]      size        シリアライズしたルートシグニチャのサイズです.
+	//! @param[out]     pRootSig    ルートシグニチャの格納先です.
+	//! @retval true    取得に成功.
+	//! @retval false   取得に失敗.
+	//! @note       シリアライズ結果が同じであれば生成済みのものを返却します.
+	//!             ここで取得していないルートシグニチャを使うパイプラインステートはファイルに保存しません.
+	//-------------------------------------------------------------------------
+	bool GetRootSignature(ID3D12Device* pDevice, const void* pBlob, size_t size, ComPtr<ID3D12RootSignature>& pRootSig);
+
+	//-------------------------------------------------------------------------
+	//! @brief      ルートシグニチャのシリアライズ結果を取得します.
+	//!
+	//! @param[in]      pRootSig    GetRootSignature() で取得したルートシグニチャです.
+	//! @param[out]     blob        シリアライズ結果の格納先です.
+	//! @retval true    取得に成功.
+	//! @retval false   ここで生成していないルートシグニチャです.
+	//-------------------------------------------------------------------------
+	bool GetRootSignatureBlob(ID3D12RootSignature* pRootSig, std::vector<uint8_t>& blob) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      パイプラインステートを取得します.
+	//!
+	//! @param[in]      pDevice     デバイスです.
+	//! @param[in]      desc        パイプラインステートの構成です.
+	//! @param[out]     pPSO        パイプラインステートの格納先です.
+	//! @retval true    取得に成功.
+	//! @retval false   取得に失敗.
+	//! @note       同じ構成であれば生成済みのものを返却し, 無ければパイプラインライブラリから読み込みます.
+	//-------------------------------------------------------------------------
+	bool GetGraphicsPipeline(ID3D12Device* pDevice, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, ComPtr<ID3D12PipelineState>& pPSO);
+
+	//-------------------------------------------------------------------------
+	//! @brief      統計情報を取得します.
+	//-------------------------------------------------------------------------
+	const Stats& GetStats() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      生成済みのパイプラインステート数を取得します.
+	//-------------------------------------------------------------------------
+	size_t GetCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      生成済みのルートシグニチャ数を取得します.
+	//-------------------------------------------------------------------------
+	size_t GetRootSignatureCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      パイプラインライブラリを使用しているかどうかチェックします.
+	//-------------------------------------------------------------------------
+	bool HasLibrary() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      パイプラインステートの構成のハッシュ値を求めます.
+	//!
+	//! @param[in]      desc            パイプラインステートの構成です.
+	//! @param[in]      rootSigHash     シリアライズしたルートシグニチャのハッシュ値です.
+	//! @return     ポインタの値には依存せず, 参照先の内容から求めたハッシュ値を返却します.
+	//-------------------------------------------------------------------------
+	static uint64_t HashDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSigHash);
+
+	//-------------------------------------------------------------------------
+	//! @brief      メモリ上で共有するためのキーを求めます.
+	//!
+	//! @param[in]      descHash    パイプラインステートの構成のハッシュ値です.
+	//! @param[in]      pRootSig    ルートシグニチャです.
+	//! @return     生成時のルートシグニチャを区別したキーを返却します.
+	//-------------------------------------------------------------------------
+	static uint64_t MakeKey(uint64_t descHash, const ID3D12RootSignature* pRootSig);
+
+	//-------------------------------------------------------------------------
+	//! @brief      パイプラインライブラリに登録する名前を求めます.
+	//!
+	//! @param[in]      descHash    パイプラインステートの構成のハッシュ値です.
+	//! @param[out]     name        名前の格納先です.
+	//-------------------------------------------------------------------------
+	static void MakeName(uint64_t descHash, wchar_t (&name)[NameLength]);
+
+	//-------------------------------------------------------------------------
+	//! @brief      ファイルに書き出すデータを構築します.
+	//!
+	//! @param[in]      pBlob       シリアライズしたパイプラインライブラリです.
+	//! @param[in]      size        シリアライズしたパイプラインライブラリのサイズです.
+	//! @param[out]     file        ファイルに書き出すデータです.
+	//-------------------------------------------------------------------------
+	static void BuildFile(const void* pBlob, size_t size, std::vector<uint8_t>& file);
+
+	//-------------------------------------------------------------------------
+	//! @brief      ファイルから読み込んだデータを検証します.
+	//!
+	//! @param[in]      file        ファイルから読み込んだデータです.
+	//! @param[out]     offset      パイプラインライブラリの先頭位置です.
+	//! @param[out]     size        パイプラインライブラリのサイズです.
+	//! @retval true    有効なデータです.
+	//! @retval false   識別子・バージョン・サイズのいずれかが一致しません.
+	//-------------------------------------------------------------------------
+	static bool ParseFile(const std::vector<uint8_t>& file, size_t& offset, size_t& size);
+
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// RootEntry structure
+	///////////////////////////////////////////////////////////////////////////
+	struct RootEntry
+	{
+		ComPtr<ID3D12RootSignature> pRootSig;   //!< ルートシグニチャです.
+		std::vector<uint8_t>        Blob;       //!< ハッシュ値の衝突を判定するためのシリアライズ結果です.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// FileHeader structure
+	///////////////////////////////////////////////////////////////////////////
+	struct FileHeader
+	{
+		uint32_t    Magic;      //!< ファイル識別子です.
+		uint32_t    Version;    //!< ファイルバージョンです.
+		uint64_t    Size;       //!< パイプラインライブラリのサイズです.
+	};
+
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	ComPtr<ID3D12Device1>                                       m_pDevice;          //!< パイプラインライブラリ対応のデバイスです.
+	ComPtr<ID3D12PipelineLibrary>                               m_pLibrary;         //!< パイプラインライブラリです.
+	std::vector<uint8_t>                                        m_File;             //!< ライブラリが参照するファイルの内容です.
+	std::wstring                                                m_Path;             //!< ファイルパスです.
+	std::unordered_map<uint64_t, ComPtr<ID3D12PipelineState>>   m_Pipelines;        //!< 生成済みのパイプラインステートです.
+	std::unordered_map<uint64_t, RootEntry>                     m_RootSigs;         //!< シリアライズ結果のハッシュ値ごとのルートシグニチャです.
+	std::unordered_map<ID3D12RootSignature*, uint64_t>          m_RootSigHash;      //!< ルートシグニチャのハッシュ値です.
+	Stats                                                       m_Stats = {};       //!< 統計情報です.
+	bool                                                        m_Dirty = false;    //!< 保存していない追加があるかどうか.
+	mutable std::mutex                                          m_Mutex;            //!< 排他制御用です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	PipelineCache() = default;
+	~PipelineCache() = default;
+
+	PipelineCache(const PipelineCache&) = delete;
+	void operator = (const PipelineCache&) = delete;
+};
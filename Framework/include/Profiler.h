@@ -0,0 +1,328 @@
+﻿//-----------------------------------------------------------------------------
+// File : Profiler.h
+// Desc : Hierarchical CPU Profiler Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <FrameStats.h>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+
+//-----------------------------------------------------------------------------
+// Macros
+//-----------------------------------------------------------------------------
+#define PROFILE_CONCAT_IMPL( a, b ) a##b
+#define PROFILE_CONCAT( a, b ) PROFILE_CONCAT_IMPL( a, b )
+
+#ifndef PROFILE_SCOPE
+#define PROFILE_SCOPE( name ) ProfileScope PROFILE_CONCAT( profileScope, __LINE__ )( Profiler::GetInstance(), name )
+#endif//PROFILE_SCOPE
+
+///////////////////////////////////////////////////////////////////////////////
+// Profiler class
+///////////////////////////////////////////////////////////////////////////////
+class Profiler
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const uint32_t RingSize     = 4096;      //!< スレッドごとに保持できるイベント数です.
+	static const uint32_t MaxDepth     = 32;        //!< 記録する入れ子の深さです. これより深いスコープは記録しません.
+	static const uint32_t StatsCount   = 120;       //!< 統計に使うフレーム数です.
+	static const uint32_t GpuThread    = 0xFFFF;    //!< GPU のイベントを並べるスレッド番号です.
+	static const uint32_t InvalidIndex = ~0u;       //!< 親が無いことを表す番号です.
+
+	///////////////////////////////////////////////////////////////////////////
+	// Node structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Node
+	{
+		const char* Name;           //!< 名前です.
+		uint64_t    Path;           //!< 親からの名前の並びから求めたハッシュです.
+		uint32_t    Thread;         //!< スレッド番号です.
+		uint32_t    Parent;         //!< 親のノード番号です. 無い場合は InvalidIndex です.
+		uint32_t    Depth;          //!< 入れ子の深さです.
+		double      StartMs;        //!< スレッドの先頭からの開始時刻(ミリ秒)です.
+		double      DurationMs;     //!< 処理時間(ミリ秒)です.
+		double      AvgMs;          //!< 同じパスのフレーム合計の平均(ミリ秒)です.
+		double      MinMs;          //!< 同じパスのフレーム合計の最小(ミリ秒)です.
+		double      MaxMs;          //!< 同じパスのフレーム合計の最大(ミリ秒)です.
+	};
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      インスタンスを取得します.
+	//-------------------------------------------------------------------------
+	static Profiler& GetInstance()
+	{
+		static Profiler instance;
+		return instance;
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	Profiler();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~Profiler();
+
+	//-------------------------------------------------------------------------
+	//! @brief      記録するかどうかを設定します.
+	//-------------------------------------------------------------------------
+	void SetEnable(bool enable);
+
+	//-------------------------------------------------------------------------
+	//! @brief      記録するかどうかを取得します.
+	//-------------------------------------------------------------------------
+	bool IsEnabled() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      呼び出し元のスレッドの名前を設定します.
+	//-------------------------------------------------------------------------
+	void SetThreadName(const char* name);
+
+	//-------------------------------------------------------------------------
+	//! @brief      スレッドの名前を取得します.
+	//!
+	//! @param[in]      thread      スレッド番号です.
+	//! @return     名前を返却します. 設定されていない場合は空文字です.
+	//-------------------------------------------------------------------------
+	std::string GetThreadName(uint32_t thread) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      フレームを開始します.
+	//-------------------------------------------------------------------------
+	void BeginFrame();
+
+	//-------------------------------------------------------------------------
+	//! @brief      フレームを終了し, 全スレッドのイベントから階層と統計を求めます.
+	//!
+	//! @note       BeginFrame() と同じスレッドから呼び出してください.
+	//-------------------------------------------------------------------------
+	void EndFrame();
+
+	//-------------------------------------------------------------------------
+	//! @brief      呼び出し元のスレッドでスコープを開始します.
+	//!
+	//! @param[in]      name        名前です. 文字列リテラルなど, 破棄されない文字列を渡してください.
+	//-------------------------------------------------------------------------
+	void Push(const char* name);
+
+	//-------------------------------------------------------------------------
+	//! @brief      呼び出し元のスレッドで最後に開始したスコープを終了します.
+	//-------------------------------------------------------------------------
+	void Pop();
+
+	//-------------------------------------------------------------------------
+	//! @brief      計測済みのイベントを追加します.
+	//!
+	//! @param[in]      name        名前です. 文字列リテラルなど, 破棄されない文字列を渡してください.
+	//! @param[in]      thread      スレッド番号です. GPU の場合は GpuThread です.
+	//! @param[in]      begin       開始時刻(GetTicks() と同じ単位)です.
+	//! @param[in]      end         終了時刻(GetTicks() と同じ単位)です.
+	//! @param[in]      depth       入れ子の深さです.
+	//! @note       どのスレッドからも呼び出せます. 次の EndFrame() で集計します.
+	//-------------------------------------------------------------------------
+	void AddEvent(const char* name, uint32_t thread, int64_t begin, int64_t end, uint32_t depth);
+
+	//-------------------------------------------------------------------------
+	//! @brief      直前のフレームのノードを取得します.
+	//!
+	//! @return     スレッド番号, 開始時刻の順に並んだノードを返却します.
+	//-------------------------------------------------------------------------
+	const std::vector<Node>& GetNodes() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      直前のフレームの長さ(ミリ秒)を取得します.
+	//-------------------------------------------------------------------------
+	double GetFrameMs() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      リングバッファが溢れて破棄したイベント数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetDroppedCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      指定フレーム数のイベントの取り込みを開始します.
+	//!
+	//! @param[in]      frames      取り込むフレーム数です.
+	//-------------------------------------------------------------------------
+	void Capture(uint32_t frames);
+
+	//-------------------------------------------------------------------------
+	//! @brief      取り込み中かどうかを取得します.
+	//-------------------------------------------------------------------------
+	bool IsCapturing() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      取り込んだフレーム数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetCapturedFrames() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      取り込んだイベントを Chrome Trace Event 形式の JSON で出力します.
+	//!
+	//! @param[out]     json        出力先です.
+	//-------------------------------------------------------------------------
+	void ExportChromeTrace(std::string& json) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      取り込んだイベントを Chrome Trace Event 形式のファイルに保存します.
+	//!
+	//! @param[in]      path        ファイルパスです.
+	//! @retval true    保存に成功.
+	//! @retval false   保存に失敗.
+	//-------------------------------------------------------------------------
+	bool SaveChromeTrace(const char* path) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      現在時刻(ナノ秒)を取得します.
+	//-------------------------------------------------------------------------
+	static int64_t GetTicks();
+
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// Event structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Event
+	{
+		const char* Name;       //!< 名前です.
+		int64_t     Begin;      //!< 開始時刻です.
+		int64_t     End;        //!< 終了時刻です.
+		uint32_t    Thread;     //!< スレッド番号です.
+		uint32_t    Depth;      //!< 入れ子の深さです.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// ThreadBuffer structure
+	///////////////////////////////////////////////////////////////////////////
+	struct ThreadBuffer
+	{
+		std::vector<Event>      Ring;                   //!< 終了したイベントのリングバッファです.
+		std::atomic<uint64_t>   Write;                  //!< 所有スレッドが次に書き込む位置です.
+		std::atomic<uint64_t>   Read;                   //!< 集計側が次に読み込む位置です.
+		std::atomic<uint32_t>   Dropped;                //!< 溢れて破棄したイベント数です.
+		const char*             StackName [MaxDepth];   //!< 開始したスコープの名前です.
+		int64_t                 StackBegin[MaxDepth];   //!< 開始したスコープの時刻です.
+		uint32_t                Depth;                  //!< 現在の入れ子の深さです.
+		uint32_t                Index;                  //!< スレッド番号です.
+		std::thread::id         Id;                     //!< 所有スレッドです.
+		std::string             Name;                   //!< スレッドの名前です.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// PathStats structure
+	///////////////////////////////////////////////////////////////////////////
+	struct PathStats
+	{
+		FrameStats  Stats;      //!< フレーム合計の統計です.
+		double      Total;      //!< 現在のフレームの合計です.
+		double      Avg;        //!< 平均です.
+		double      Min;        //!< 最小です.
+		double      Max;        //!< 最大です.
+		uint32_t    Frame;      //!< 合計を求めたフレームです. 0 の場合は未初期化です.
+	};
+
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	uint64_t                                    m_Id;               //!< スレッドローカルのキャッシュと照合する識別子です.
+	std::atomic<bool>                           m_Enable;           //!< 記録するかどうかです.
+	mutable std::mutex                          m_Mutex;            //!< スレッドの登録と外部イベントを保護します.
+	std::vector<std::unique_ptr<ThreadBuffer>>  m_Threads;          //!< 登録されたスレッドです.
+	std::vector<Event>                          m_External;         //!< AddEvent() で追加されたイベントです.
+	std::vector<Event>                          m_FrameEvents;      //!< 集計中のイベントです.
+	std::vector<Node>                           m_Nodes;            //!< 直前のフレームのノードです.
+	std::unordered_map<uint64_t, PathStats>     m_Stats;            //!< パスごとの統計です.
+	std::vector<Event>                          m_Captured;         //!< 取り込んだイベントです.
+	uint32_t                                    m_CaptureRemain;    //!< 取り込む残りフレーム数です.
+	uint32_t                                    m_CapturedFrames;   //!< 取り込んだフレーム数です.
+	uint32_t                                    m_FrameCount;       //!< 集計したフレーム数です.
+	int64_t                                     m_FrameBegin;       //!< 現在のフレームの開始時刻です.
+	double                                      m_FrameMs;          //!< 直前のフレームの長さ(ミリ秒)です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	ThreadBuffer* GetThreadBuffer();
+
+	Profiler        (const Profiler&) = delete;
+	void operator = (const Profiler&) = delete;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ProfileScope class
+///////////////////////////////////////////////////////////////////////////////
+class ProfileScope
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	/* NOTHING */
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      スコープを開始します.
+	//!
+	//! @param[in]      profiler    記録先です.
+	//! @param[in]      name        名前です. 文字列リテラルなど, 破棄されない文字列を渡してください.
+	//-------------------------------------------------------------------------
+	ProfileScope(Profiler& profiler, const char* name)
+	: m_pProfiler(profiler.IsEnabled() ? &profiler : nullptr)
+	{
+		if (m_pProfiler != nullptr)
+		{ m_pProfiler->Push(name); }
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      スコープを終了します.
+	//-------------------------------------------------------------------------
+	~ProfileScope()
+	{
+		if (m_pProfiler != nullptr)
+		{ m_pProfiler->Pop(); }
+	}
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	Profiler*   m_pProfiler;    //!< 開始時に有効だった記録先です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	ProfileScope    (const ProfileScope&) = delete;
+	void operator = (const ProfileScope&) = delete;
+};
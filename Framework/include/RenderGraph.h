@@ -0,0 +1,335 @@
+﻿//-----------------------------------------------------------------------------
+// File : RenderGraph.h
+// Desc : Render Graph Compiler Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <d3d12.h>
+#include <cstdint>
+#include <vector>
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////
+// RenderGraph class
+///////////////////////////////////////////////////////////////////////////////
+class RenderGraph
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const uint32_t InvalidIndex      = UINT32_MAX;           //!< 無効な番号です.
+	static const uint64_t DefaultAlignment  = 64 * 1024;            //!< 配置の既定のアライメントです.
+
+	///////////////////////////////////////////////////////////////////////////
+	// TextureDesc structure
+	///////////////////////////////////////////////////////////////////////////
+	struct TextureDesc
+	{
+		uint32_t        Width       = 0;                        //!< 横幅です.
+		uint32_t        Height      = 0;                        //!< 縦幅です.
+		DXGI_FORMAT     Format      = DXGI_FORMAT_UNKNOWN;      //!< ピクセルフォーマットです.
+		bool            Depth       = false;                    //!< 深度ターゲットかどうか.
+		uint64_t        Size        = 0;                        //!< メモリサイズです. 0 の場合は推定値を使います.
+		uint64_t        Alignment   = 0;                        //!< アライメントです. 0 の場合は 64KB です.
+		float           ClearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f }; //!< クリアカラーです. 深度の場合は [0] がクリア深度です.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// BARRIER_TYPE enum
+	///////////////////////////////////////////////////////////////////////////
+	enum BARRIER_TYPE
+	{
+		BARRIER_TRANSITION = 0,     //!< 状態遷移です.
+		BARRIER_ALIASING,           //!< メモリを共有するリソースの切り替えです.
+		BARRIER_UAV,                //!< UAV書き込みの完了待ちです.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// Barrier structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Barrier
+	{
+		BARRIER_TYPE            Type;       //!< 種類です.
+		uint32_t                Resource;   //!< リソース番号です.
+		D3D12_RESOURCE_STATES   Before;     //!< 遷移前の状態です.
+		D3D12_RESOURCE_STATES   After;      //!< 遷移後の状態です.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// Report structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Report
+	{
+		uint32_t    PassCount           = 0;    //!< 登録されたパス数です.
+		uint32_t    CulledCount         = 0;    //!< 削除されたパス数です.
+		uint32_t    TransientCount      = 0;    //!< 使用される一時リソース数です.
+		uint32_t    AliasedCount        = 0;    //!< 他とメモリを共有する一時リソース数です.
+		uint32_t    TransitionCount     = 0;    //!< 状態遷移バリア数です.
+		uint32_t    AliasingCount       = 0;    //!< エイリアシングバリア数です.
+		uint32_t    UAVCount            = 0;    //!< UAVバリア数です.
+		uint32_t    BatchCount          = 0;    //!< ResourceBarrier() の呼び出し回数です.
+		uint32_t    ManualCount         = 0;    //!< 書き込むパスごとに遷移して戻した場合の遷移バリア数です.
+		uint64_t    TransientBytes      = 0;    //!< 一時リソースを個別に確保した場合のメモリサイズです.
+		uint64_t    HeapBytes           = 0;    //!< エイリアシング後のヒープサイズです.
+	};
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	RenderGraph();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~RenderGraph();
+
+	//-------------------------------------------------------------------------
+	//! @brief      登録したパスとリソースを全て破棄します.
+	//-------------------------------------------------------------------------
+	void Clear();
+
+	//-------------------------------------------------------------------------
+	//! @brief      グラフ内でのみ使用する一時テクスチャを作成します.
+	//!
+	//! @param[in]      name        名前です.
+	//! @param[in]      desc        テクスチャ設定です.
+	//! @return     リソース番号を返却します.
+	//! @note       最初のアクセスは書き込みである必要があります.
+	//-------------------------------------------------------------------------
+	uint32_t CreateTexture(const char* name, const TextureDesc& desc);
+
+	//-------------------------------------------------------------------------
+	//! @brief      グラフ外で管理するテクスチャを登録します.
+	//!
+	//! @param[in]      name            名前です.
+	//! @param[in]      initialState    グラフ実行前の状態です.
+	//! @param[in]      finalState      グラフ実行後に戻す状態です.
+	//! @return     リソース番号を返却します.
+	//! @note       書き込んだ内容はグラフの出力として扱い, 書き込むパスは削除しません.
+	//-------------------------------------------------------------------------
+	uint32_t ImportTexture(const char* name, D3D12_RESOURCE_STATES initialState, D3D12_RESOURCE_STATES finalState);
+
+	//-------------------------------------------------------------------------
+	//! @brief      一時テクスチャをグラフの出力にします.
+	//!
+	//! @param[in]      resource    リソース番号です.
+	//! @param[in]      finalState  グラフ実行後の状態です.
+	//! @note       フレームの最後まで他のリソースとメモリを共有しません.
+	//-------------------------------------------------------------------------
+	void Export(uint32_t resource, D3D12_RESOURCE_STATES finalState = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+	//-------------------------------------------------------------------------
+	//! @brief      パスを追加します.
+	//!
+	//! @param[in]      name        名前です.
+	//! @param[in]      sideEffect  出力を読まれなくても削除しない場合は true を指定します.
+	//! @return     パス番号を返却します.
+	//-------------------------------------------------------------------------
+	uint32_t AddPass(const char* name, bool sideEffect = false);
+
+	//-------------------------------------------------------------------------
+	//! @brief      パスが読み込むリソースを宣言します.
+	//!
+	//! @param[in]      pass        パス番号です.
+	//! @param[in]      resource    リソース番号です.
+	//! @param[in]      state       読み込むときの状態です.
+	//-------------------------------------------------------------------------
+	void Read(uint32_t pass, uint32_t resource, D3D12_RESOURCE_STATES state);
+
+	//-------------------------------------------------------------------------
+	//! @brief      パスが書き込むリソースを宣言します.
+	//!
+	//! @param[in]      pass        パス番号です.
+	//! @param[in]      resource    リソース番号です.
+	//! @param[in]      state       書き込むときの状態です.
+	//-------------------------------------------------------------------------
+	void Write(uint32_t pass, uint32_t resource, D3D12_RESOURCE_STATES state);
+
+	//-------------------------------------------------------------------------
+	//! @brief      グラフをコンパイルします.
+	//!
+	//! @param[in]      enableAliasing  寿命が重ならない一時リソースのメモリを共有する場合は true.
+	//! @retval true    コンパイルに成功.
+	//! @retval false   コンパイルに失敗.
+	//! @note       出力に寄与しないパスの削除, バリアの計算, ヒープ内の配置を行います.
+	//-------------------------------------------------------------------------
+	bool Compile(bool enableAliasing = true);
+
+	//-------------------------------------------------------------------------
+	//! @brief      パスが削除されたかどうかを判定します.
+	//-------------------------------------------------------------------------
+	bool IsCulled(uint32_t pass) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      パスの実行前にまとめて発行するバリアを取得します.
+	//-------------------------------------------------------------------------
+	const std::vector<Barrier>& GetBarriers(uint32_t pass) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      パスの実行前に内容を破棄する一時リソースを取得します.
+	//!
+	//! @note       メモリを共有するリソースは使用開始時に Discard か Clear で初期化が必要です.
+	//-------------------------------------------------------------------------
+	const std::vector<uint32_t>& GetActivations(uint32_t pass) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      最後のパスの実行後に発行するバリアを取得します.
+	//-------------------------------------------------------------------------
+	const std::vector<Barrier>& GetFinalBarriers() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      削除されなかった最後のパス番号を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetLastPass() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      パス数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetPassCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      パス名を取得します.
+	//-------------------------------------------------------------------------
+	const char* GetPassName(uint32_t pass) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      リソース数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetResourceCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      リソース名を取得します.
+	//-------------------------------------------------------------------------
+	const char* GetResourceName(uint32_t resource) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      一時リソースかどうかを判定します.
+	//-------------------------------------------------------------------------
+	bool IsTransient(uint32_t resource) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      一時リソースがコンパイル後のグラフで使用されるかどうかを判定します.
+	//-------------------------------------------------------------------------
+	bool IsUsed(uint32_t resource) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      テクスチャ設定を取得します.
+	//-------------------------------------------------------------------------
+	const TextureDesc& GetDesc(uint32_t resource) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      一時リソースのヒープ内のオフセットを取得します.
+	//-------------------------------------------------------------------------
+	uint64_t GetHeapOffset(uint32_t resource) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      リソースを使用するパスの範囲を取得します.
+	//!
+	//! @param[in]      resource    リソース番号です.
+	//! @param[out]     first       最初に使用するパス番号です.
+	//! @param[out]     last        最後に使用するパス番号です. 出力はパス数になります.
+	//! @retval true    使用されます.
+	//! @retval false   使用されません.
+	//-------------------------------------------------------------------------
+	bool GetLifetime(uint32_t resource, uint32_t& first, uint32_t& last) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      一時リソースを生成するときの状態を取得します.
+	//!
+	//! @note       毎フレーム同じバリアを発行するので, フレーム終了時の状態と同じです.
+	//-------------------------------------------------------------------------
+	D3D12_RESOURCE_STATES GetCreateState(uint32_t resource) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      一時リソースを配置するヒープのサイズを取得します.
+	//-------------------------------------------------------------------------
+	uint64_t GetHeapSize() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンパイル結果の統計情報を取得します.
+	//-------------------------------------------------------------------------
+	const Report& GetReport() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      デバイスを使わずにテクスチャのメモリサイズを推定します.
+	//-------------------------------------------------------------------------
+	static uint64_t EstimateSize(const TextureDesc& desc);
+
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// Access structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Access
+	{
+		uint32_t                Resource;   //!< リソース番号です.
+		D3D12_RESOURCE_STATES   State;      //!< アクセスするときの状態です.
+		bool                    Write;      //!< 書き込むかどうか.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// PassInfo structure
+	///////////////////////////////////////////////////////////////////////////
+	struct PassInfo
+	{
+		std::string             Name;           //!< 名前です.
+		bool                    SideEffect;     //!< 削除しないかどうか.
+		bool                    Culled;         //!< 削除されたかどうか.
+		std::vector<Access>     Accesses;       //!< アクセスするリソースです.
+		std::vector<Barrier>    Barriers;       //!< 実行前に発行するバリアです.
+		std::vector<uint32_t>   Activations;    //!< 実行前に内容を破棄するリソースです.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// ResourceInfo structure
+	///////////////////////////////////////////////////////////////////////////
+	struct ResourceInfo
+	{
+		std::string             Name;           //!< 名前です.
+		TextureDesc             Desc;           //!< テクスチャ設定です.
+		bool                    Imported;       //!< グラフ外で管理するかどうか.
+		bool                    Exported;       //!< グラフの出力かどうか.
+		D3D12_RESOURCE_STATES   InitialState;   //!< グラフ実行前の状態です.
+		D3D12_RESOURCE_STATES   FinalState;     //!< グラフ実行後の状態です.
+		D3D12_RESOURCE_STATES   CreateState;    //!< 一時リソースを生成するときの状態です.
+		uint32_t                First;          //!< 最初に使用するパス番号です.
+		uint32_t                Last;           //!< 最後に使用するパス番号です.
+		uint64_t                Offset;         //!< ヒープ内のオフセットです.
+		bool                    Aliased;        //!< 他のリソースとメモリを共有するかどうか.
+	};
+
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	std::vector<PassInfo>       m_Passes;           //!< 登録順のパスです.
+	std::vector<ResourceInfo>   m_Resources;        //!< リソースです.
+	std::vector<Barrier>        m_FinalBarriers;    //!< 最後に発行するバリアです.
+	uint32_t                    m_LastPass;         //!< 削除されなかった最後のパス番号です.
+	uint64_t                    m_HeapSize;         //!< ヒープサイズです.
+	Report                      m_Report;           //!< 統計情報です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	void AddAccess(uint32_t pass, uint32_t resource, D3D12_RESOURCE_STATES state, bool write);
+	void CullPasses();
+	bool ComputeLifetimes();
+	void PlaceResources(bool enableAliasing);
+	void ComputeBarriers();
+
+	RenderGraph     (const RenderGraph&) = delete;
+	void operator = (const RenderGraph&) = delete;
+};
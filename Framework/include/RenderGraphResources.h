@@ -0,0 +1,168 @@
+﻿//-----------------------------------------------------------------------------
+// File : RenderGraphResources.h
+// Desc : Render Graph Transient Resource Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <d3d12.h>
+#include <ComPtr.h>
+#include <RenderGraph.h>
+#include <ColorTarget.h>
+#include <DepthTarget.h>
+#include <cstdint>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Forward Declarations.
+//-----------------------------------------------------------------------------
+class DescriptorPool;
+
+///////////////////////////////////////////////////////////////////////////////
+// RenderGraphResources class
+///////////////////////////////////////////////////////////////////////////////
+class RenderGraphResources
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	/* NOTHING */
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	RenderGraphResources();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~RenderGraphResources();
+
+	//-------------------------------------------------------------------------
+	//! @brief      初期化処理を行います.
+	//!
+	//! @param[in]      pDevice     デバイスです.
+	//! @param[in]      pPoolRTV    ディスクリプタプール(RTV用)です.
+	//! @param[in]      pPoolDSV    ディスクリプタプール(DSV用)です.
+	//! @param[in]      pPoolSRV    ディスクリプタプール(SRV用)です.
+	//! @retval true    初期化に成功.
+	//! @retval false   初期化に失敗.
+	//-------------------------------------------------------------------------
+	bool Init(ID3D12Device* pDevice, DescriptorPool* pPoolRTV, DescriptorPool* pPoolDSV, DescriptorPool* pPoolSRV);
+
+	//-------------------------------------------------------------------------
+	//! @brief      終了処理を行います.
+	//-------------------------------------------------------------------------
+	void Term();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デバイスから取得したメモリサイズを設定したテクスチャ設定を作成します.
+	//!
+	//! @param[in]      width       横幅です.
+	//! @param[in]      height      縦幅です.
+	//! @param[in]      format      ピクセルフォーマットです.
+	//! @param[in]      depth       深度ターゲットの場合は true を指定します.
+	//! @return     テクスチャ設定を返却します.
+	//-------------------------------------------------------------------------
+	RenderGraph::TextureDesc MakeDesc(uint32_t width, uint32_t height, DXGI_FORMAT format, bool depth) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンパイル済みのグラフの一時リソースを生成します.
+	//!
+	//! @param[in]      graph       コンパイル済みのグラフです.
+	//! @retval true    生成に成功.
+	//! @retval false   生成に失敗.
+	//! @note       以前に生成したリソースは破棄するので, GPUの実行完了後に呼び出します.
+	//-------------------------------------------------------------------------
+	bool Create(const RenderGraph& graph);
+
+	//-------------------------------------------------------------------------
+	//! @brief      生成した一時リソースを破棄します.
+	//-------------------------------------------------------------------------
+	void Release();
+
+	//-------------------------------------------------------------------------
+	//! @brief      グラフ外で管理するリソースを設定します.
+	//!
+	//! @param[in]      resource    リソース番号です.
+	//! @param[in]      pResource   リソースです. バックバッファのようにフレームごとに変わる場合は毎フレーム設定します.
+	//-------------------------------------------------------------------------
+	void SetImported(uint32_t resource, ID3D12Resource* pResource);
+
+	//-------------------------------------------------------------------------
+	//! @brief      リソースを取得します.
+	//-------------------------------------------------------------------------
+	ID3D12Resource* GetResource(uint32_t resource) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      一時カラーターゲットを取得します.
+	//!
+	//! @return     使用されない場合や深度ターゲットの場合は nullptr を返却します.
+	//-------------------------------------------------------------------------
+	ColorTarget* GetColorTarget(uint32_t resource) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      一時深度ターゲットを取得します.
+	//!
+	//! @return     使用されない場合やカラーターゲットの場合は nullptr を返却します.
+	//-------------------------------------------------------------------------
+	DepthTarget* GetDepthTarget(uint32_t resource) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      パスの実行前のバリアを発行します.
+	//!
+	//! @param[in]      pCmd        コマンドリストです.
+	//! @param[in]      graph       コンパイル済みのグラフです.
+	//! @param[in]      pass        パス番号です.
+	//! @note       読み取り専用なので, 複数のスレッドから同時に呼び出せます.
+	//-------------------------------------------------------------------------
+	void RecordBarriers(ID3D12GraphicsCommandList* pCmd, const RenderGraph& graph, uint32_t pass) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      最後のパスの実行後のバリアを発行します.
+	//!
+	//! @param[in]      pCmd        コマンドリストです.
+	//! @param[in]      graph       コンパイル済みのグラフです.
+	//-------------------------------------------------------------------------
+	void RecordFinalBarriers(ID3D12GraphicsCommandList* pCmd, const RenderGraph& graph) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      ヒープサイズを取得します.
+	//-------------------------------------------------------------------------
+	uint64_t GetHeapSize() const;
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	ComPtr<ID3D12Device>                m_pDevice;          //!< デバイスです.
+	ComPtr<ID3D12Heap>                  m_pHeap;            //!< 一時リソースを配置するヒープです.
+	DescriptorPool*                     m_pPoolRTV;         //!< ディスクリプタプール(RTV用)です.
+	DescriptorPool*                     m_pPoolDSV;         //!< ディスクリプタプール(DSV用)です.
+	DescriptorPool*                     m_pPoolSRV;         //!< ディスクリプタプール(SRV用)です.
+	std::vector<ColorTarget*>           m_pColors;          //!< リソース番号ごとのカラーターゲットです.
+	std::vector<DepthTarget*>           m_pDepths;          //!< リソース番号ごとの深度ターゲットです.
+	std::vector<ID3D12Resource*>        m_pResources;       //!< リソース番号ごとのリソースです.
+	uint64_t                            m_HeapSize;         //!< ヒープサイズです.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	void Record(ID3D12GraphicsCommandList* pCmd, const std::vector<RenderGraph::Barrier>& barriers, const std::vector<uint32_t>* pActivations) const;
+
+	RenderGraphResources    (const RenderGraphResources&) = delete;
+	void operator =         (const RenderGraphResources&) = delete;
+};
@@ -0,0 +1,274 @@
+﻿//-----------------------------------------------------------------------------
+// File : RenderQueue.h
+// Desc : Sorted Draw Submission Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <d3d12.h>
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+//-----------------------------------------------------------------------------
+// Forward Declarations.
+//-----------------------------------------------------------------------------
+class Mesh;
+class Material;
+class MaterialInstance;
+class ModelShader;
+class ConstantBuffer;
+class CommonBufferManager;
+class SkyManager;
+class InstanceBuffer;
+
+///////////////////////////////////////////////////////////////////////////////
+// DrawItem structure
+///////////////////////////////////////////////////////////////////////////////
+struct DrawItem
+{
+	uint64_t                SortKey;        //!< ソートキーです.
+	Mesh*                   pMesh;          //!< 描画するメッシュです.
+	Material*               pMaterial;      //!< マテリアルです.
+	const MaterialInstance* pInstance;      //!< マテリアルインスタンスです.
+	const ConstantBuffer*   pMeshCB;        //!< メッシュ用定数バッファです(フレーム数分の配列).
+	DirectX::XMFLOAT4X4     World;          //!< インスタンス描画で使用するワールド行列です.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// RenderQueue class
+///////////////////////////////////////////////////////////////////////////////
+class RenderQueue
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	///////////////////////////////////////////////////////////////////////////
+	// PASS enum
+	///////////////////////////////////////////////////////////////////////////
+	enum PASS
+	{
+		PASS_OPAQUE = 0,        //!< 不透明(手前から奥へ描画).
+		PASS_TRANSPARENT,       //!< 半透明(奥から手前へ描画).
+		PASS_COUNT
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// Stats structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Stats
+	{
+		uint32_t    ItemCount;          //!< 描画アイテム数です.
+		uint32_t    PipelineChanges;    //!< パイプライン(ルートシグニチャ・PSO)の切り替え回数です.
+		uint32_t    MaterialChanges;    //!< マテリアルの切り替え回数です.
+		uint32_t    MeshBufferChanges;  //!< メッシュ定数バッファの切り替え回数です.
+		uint32_t    InstanceChanges;    //!< インスタンス番号の切り替え回数です.
+		uint32_t    DrawCalls;          //!< ドローコール数です.
+		uint32_t    InstancedItems;     //!< インスタンス描画にまとめたアイテム数です.
+		uint32_t    SortPasses;         //!< 実際に走査した基数ソートのパス数です.
+		double      SortMicroSec;       //!< ソートにかかった時間(マイクロ秒)です.
+		double      SubmitMicroSec;     //!< コマンド発行にかかった時間(マイクロ秒)です.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// SortEntry structure
+	///////////////////////////////////////////////////////////////////////////
+	struct SortEntry
+	{
+		uint64_t    Key;        //!< ソートキーです.
+		uint32_t    Index;      //!< 描画アイテムの添字です.
+	};
+
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const uint32_t PassBits      = 4;    //!< パスのビット数です.
+	static const uint32_t PipelineBits  = 10;   //!< パイプライン番号のビット数です.
+	static const uint32_t MaterialBits  = 18;   //!< マテリアル番号のビット数です.
+	static const uint32_t MeshBits      = 16;   //!< メッシュ番号のビット数です.
+	static const uint32_t DepthBits     = 16;   //!< 深度バケットのビット数です.
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	RenderQueue();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~RenderQueue();
+
+	//-------------------------------------------------------------------------
+	//! @brief      アイテムの収集を開始します.
+	//!
+	//! @param[in]      nearClip    深度バケットの最小距離です.
+	//! @param[in]      farClip     深度バケットの最大距離です.
+	//-------------------------------------------------------------------------
+	void Begin(float nearClip, float farClip);
+
+	//-------------------------------------------------------------------------
+	//! @brief      描画アイテムを追加します.
+	//!
+	//! @param[in]      pass        描画パスです.
+	//! @param[in]      pMesh       メッシュです.
+	//! @param[in]      pMaterial   マテリアルです.
+	//! @param[in]      pInstance   マテリアルインスタンスです.
+	//! @param[in]      pMeshCB     メッシュ用定数バッファです.
+	//! @param[in]      world       ワールド行列です.
+	//! @param[in]      viewDepth   ビュー空間での深度です.
+	//-------------------------------------------------------------------------
+	void Push(
+		PASS                        pass,
+		Mesh*                       pMesh,
+		Material*                   pMaterial,
+		const MaterialInstance*     pInstance,
+		const ConstantBuffer*       pMeshCB,
+		const DirectX::XMFLOAT4X4&  world,
+		float                       viewDepth);
+
+	//-------------------------------------------------------------------------
+	//! @brief      ソートキーの昇順に並べ替えます.
+	//-------------------------------------------------------------------------
+	void Sort();
+
+	//-------------------------------------------------------------------------
+	//! @brief      並べ替えたアイテムを描画します.
+	//!
+	//! @param[in]      pCmd                コマンドリストです.
+	//! @param[in]      frameIndex          フレーム番号です.
+	//! @param[in]      commonBufferManager 共通バッファです.
+	//! @param[in]      skyManager          IBLリソースです.
+	//! @note       直前と同じステートの設定は省略します.
+	//!             インスタンスバッファが設定されていれば, 同じメッシュ・マテリアルの
+	//!             連続したアイテムを1回のインスタンス描画にまとめます.
+	//-------------------------------------------------------------------------
+	void Submit(
+		ID3D12GraphicsCommandList*  pCmd,
+		int                         frameIndex,
+		const CommonBufferManager&  commonBufferManager,
+		const SkyManager&           skyManager);
+
+	//-------------------------------------------------------------------------
+	//! @brief      並べ替えたアイテムの [rangeBegin, rangeEnd) を描画します.
+	//!
+	//! @param[in]      pCmd                コマンドリストです.
+	//! @param[in]      frameIndex          フレーム番号です.
+	//! @param[in]      commonBufferManager 共通バッファです.
+	//! @param[in]      skyManager          IBLリソースです.
+	//! @param[in]      rangeBegin          描画する範囲の先頭です.
+	//! @param[in]      rangeEnd            描画する範囲の終端(含まない)です.
+	//! @param[out]     stats               この範囲の統計情報の格納先です.
+	//! @note       Sort() 後であれば, 範囲が重ならない限り複数のスレッドから同時に呼び出せます.
+	//!             コマンドリストにはステートが引き継がれないので, 範囲の先頭で全て設定し直します.
+	//-------------------------------------------------------------------------
+	void Submit(
+		ID3D12GraphicsCommandList*  pCmd,
+		int                         frameIndex,
+		const CommonBufferManager&  commonBufferManager,
+		const SkyManager&           skyManager,
+		size_t                      rangeBegin,
+		size_t                      rangeEnd,
+		Stats&                      stats);
+
+	//-------------------------------------------------------------------------
+	//! @brief      範囲ごとの統計情報をまとめて GetStats() に反映します.
+	//!
+	//! @param[in]      pStats      範囲ごとの統計情報です.
+	//! @param[in]      count       範囲の数です.
+	//-------------------------------------------------------------------------
+	void MergeStats(const Stats* pStats, size_t count);
+
+	//-------------------------------------------------------------------------
+	//! @brief      ソートキーを生成します.
+	//!
+	//! @param[in]      pass        描画パスです.
+	//! @param[in]      pipelineId  パイプライン番号です.
+	//! @param[in]      materialId  マテリアル番号です.
+	//! @param[in]      meshId      メッシュ番号です.
+	//! @param[in]      depthBucket 深度バケットです.
+	//! @return     上位から パス | パイプライン | マテリアル | メッシュ | 深度 の順に詰めたキーを返却します.
+	//! @note       同じメッシュが隣接するようにメッシュを深度より上位に置きます.
+	//-------------------------------------------------------------------------
+	static uint64_t MakeSortKey(uint32_t pass, uint32_t pipelineId, uint32_t materialId, uint32_t meshId, uint32_t depthBucket);
+
+	//-------------------------------------------------------------------------
+	//! @brief      キーと添字の組を安定な基数ソート(8bit x 8パス)で並べ替えます.
+	//!
+	//! @param[in,out]  pEntries    ソート対象です.
+	//! @param[in]      pTemp       作業領域です(pEntries と同じ要素数).
+	//! @param[in]      count       要素数です.
+	//! @return     実際に走査したパス数を返却します.
+	//! @note       全要素で同じ値になる桁は走査を省略します.
+	//-------------------------------------------------------------------------
+	static uint32_t RadixSort(SortEntry* pEntries, SortEntry* pTemp, size_t count);
+
+	//-------------------------------------------------------------------------
+	//! @brief      インスタンス描画に使用するバッファを設定します.
+	//!
+	//! @param[in]      pBuffer     インスタンスバッファです. nullptr の場合はインスタンス描画を行いません.
+	//-------------------------------------------------------------------------
+	void SetInstanceBuffer(InstanceBuffer* pBuffer);
+
+	//-------------------------------------------------------------------------
+	//! @brief      同じメッシュ・マテリアルをまとめて描画するかどうかを設定します.
+	//!
+	//! @param[in]      enable      false の場合は1アイテムごとにドローを発行します.
+	//-------------------------------------------------------------------------
+	void SetBatching(bool enable);
+
+	//-------------------------------------------------------------------------
+	//! @brief      同じメッシュ・マテリアルをまとめて描画するかどうか.
+	//-------------------------------------------------------------------------
+	bool IsBatching() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      アイテム数を取得します.
+	//-------------------------------------------------------------------------
+	size_t GetCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      並べ替えたアイテムを取得します.
+	//-------------------------------------------------------------------------
+	const DrawItem& GetItem(size_t index) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      直前のフレームの統計情報を取得します.
+	//-------------------------------------------------------------------------
+	const Stats& GetStats() const;
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	std::vector<DrawItem>                           m_Items;        //!< 描画アイテムです.
+	std::vector<SortEntry>                          m_Entries;      //!< ソート済みの並び順です.
+	std::vector<SortEntry>                          m_Temp;         //!< ソート用の作業領域です.
+	std::unordered_map<const void*, uint32_t>       m_PipelineIds;  //!< このフレームのパイプライン番号です.
+	std::unordered_map<const void*, uint32_t>       m_MaterialIds;  //!< このフレームのマテリアル番号です.
+	std::unordered_map<const void*, uint32_t>       m_MeshIds;      //!< このフレームのメッシュ番号です.
+	InstanceBuffer*                                 m_pInstances;   //!< インスタンスバッファです.
+	bool                                            m_Batching;     //!< インスタンス描画にまとめるかどうか.
+	float                                           m_NearClip;     //!< 深度バケットの最小距離です.
+	float                                           m_InvRange;     //!< 深度バケットの範囲の逆数です.
+	bool                                            m_Sorted;       //!< ソート済みかどうか.
+	Stats                                           m_Stats;        //!< 統計情報です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	uint32_t GetId(std::unordered_map<const void*, uint32_t>& ids, const void* ptr, uint32_t bits);
+
+	RenderQueue     (const RenderQueue&) = delete;
+	void operator = (const RenderQueue&) = delete;
+};
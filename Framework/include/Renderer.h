@@ -5,6 +5,9 @@
 
 class Renderer {
 
+public:
+	const RootSignature& GetRootSig() const { return m_RootSig; }
+
 protected:
 	ComPtr<ID3D12PipelineState>     m_pPSO;
 	RootSignature                   m_RootSig;
@@ -70,9 +70,12 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 struct ResMesh
 {
-	std::vector<MeshVertex>     Vertices;     //!< 頂点データです.
-	std::vector<uint32_t>       Indices;      //!< 頂点インデックスです.
-	uint32_t                    MaterialId;   //!< マテリアル番号です.
+	std::vector<MeshVertex>     Vertices;        //!< 頂点データです.
+	std::vector<uint32_t>       Indices;         //!< 頂点インデックスです.
+	uint32_t                    MaterialId;      //!< マテリアル番号です.
+	DirectX::XMFLOAT3           BoundsMin;       //!< ローカル空間でのAABBの最小値です.
+	DirectX::XMFLOAT3           BoundsMax;       //!< ローカル空間でのAABBの最大値です.
+	DirectX::XMFLOAT4           BoundingSphere;  //!< ローカル空間での境界球です(xyz:中心, w:半径).
 };
 
 //-----------------------------------------------------------------------------
@@ -90,4 +93,12 @@ namespace Res {
 		const wchar_t* filename,
 		std::vector<ResMesh>& meshes,
 		std::vector<ResMaterial>& materials);
+
+	//-------------------------------------------------------------------------
+	//! @brief      頂点データから境界ボリュームを計算します.
+	//!
+	//! @param[in,out]  mesh            計算対象のメッシュです.
+	//! @note       AABB の中心を球の中心とし, 最も遠い頂点までの距離を半径とします.
+	//-------------------------------------------------------------------------
+	void ComputeBounds(ResMesh& mesh);
 }
\ No newline at end of file
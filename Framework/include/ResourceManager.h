@@ -10,7 +10,7 @@
 #include <Material.h>
 #include <CommonBufferManager.h>
 
-// ResourceManagerNX
+// ResourceManagerクラス
 class AppResourceManager {
 public:
 
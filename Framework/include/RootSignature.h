@@ -11,18 +11,19 @@
 #include <ComPtr.h>
 #include <d3d12.h>
 #include <vector>
+#include <string>
 
 ///////////////////////////////////////////////////////////////////////////
 // ShaderState enum
 ///////////////////////////////////////////////////////////////////////////
 enum ShaderStage
 {
-	ALL = 0,     //!< SXe[W.
-	VS = 1,     //!< _VF[_.
-	HS = 2,     //!< nVF[_.
-	DS = 3,     //!< hCVF[_.
-	GS = 4,     //!< WIgVF[_.
-	PS = 5,     //!< sNZVF[_.
+	ALL = 0,     //!< 全ステージ.
+	VS = 1,     //!< 頂点シェーダ.
+	HS = 2,     //!< ハルシェーダ.
+	DS = 3,     //!< ドメインシェーダ.
+	GS = 4,     //!< ジオメトリシェーダ.
+	PS = 5,     //!< ピクセルシェーダ.
 };
 
 ///////////////////////////////////////////////////////////////////////////
@@ -30,12 +31,12 @@ enum ShaderStage
 ///////////////////////////////////////////////////////////////////////////
 enum SamplerState
 {
-	PointWrap,          //!< |CgTvO - JԂ.
-	PointClamp,         //!< |CgTvO - Nv.
-	LinearWrap,         //!< gCjATvO - JԂ.
-	LinearClamp,        //!< gCjATvO - Nv.
-	AnisotropicWrap,    //!< ٕTvO - JԂ.
-	AnisotropicClamp,   //!< ٕTvO - Nv.
+	PointWrap,          //!< ポイントサンプリング - 繰り返し.
+	PointClamp,         //!< ポイントサンプリング - クランプ.
+	LinearWrap,         //!< トライリニアサンプリング - 繰り返し.
+	LinearClamp,        //!< トライリニアサンプリング - クランプ.
+	AnisotropicWrap,    //!< 異方性サンプリング - 繰り返し.
+	AnisotropicClamp,   //!< 異方性サンプリング - クランプ.
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -50,6 +51,22 @@ class RootSignature
 
 public:
 
+	///////////////////////////////////////////////////////////////////////////
+	// Layout structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Layout
+	{
+		uint32_t                    DWords;             //!< ルート引数のDWORD数です.
+		uint32_t                    Tables;             //!< ディスクリプタテーブル数です.
+		uint32_t                    SingleTables;       //!< ディスクリプタ1つだけのテーブル数です.
+		uint32_t                    CBVTables;          //!< 定数バッファを参照するテーブル数です.
+		uint32_t                    RootDescriptors;    //!< ルートディスクリプタ数です.
+		uint32_t                    Constants;          //!< ルート定数のDWORD数です.
+		uint32_t                    StaticSamplers;     //!< スタティックサンプラー数です.
+		uint32_t                    SuggestedDWords;    //!< 提案したレイアウトのDWORD数です.
+		std::vector<std::string>    Suggestions;        //!< レイアウトの提案です.
+	};
+
 	///////////////////////////////////////////////////////////////////////////
 	// Desc class
 	///////////////////////////////////////////////////////////////////////////
@@ -63,6 +80,10 @@ public:
 		Desc& SetSRV(ShaderStage stage, int index, uint32_t reg);
 		Desc& SetUAV(ShaderStage stage, int index, uint32_t reg);
 		Desc& SetSmp(ShaderStage stage, int index, uint32_t reg);
+		Desc& SetSRVRange(ShaderStage stage, int index, uint32_t reg, uint32_t count, uint32_t space);
+		Desc& SetConstants(ShaderStage stage, int index, uint32_t reg, uint32_t count);
+		Desc& SetRootCBV(ShaderStage stage, int index, uint32_t reg);
+		Desc& AddRange(ShaderStage stage, int index, D3D12_DESCRIPTOR_RANGE_TYPE type, uint32_t reg, uint32_t count, uint32_t space = 0);
 		Desc& AddStaticSmp(ShaderStage stage, uint32_t reg, SamplerState state);
 		Desc& AllowIL();
 		Desc& AllowSO();
@@ -70,7 +91,7 @@ public:
 		const D3D12_ROOT_SIGNATURE_DESC* GetDesc() const;
 
 	private:
-		std::vector<D3D12_DESCRIPTOR_RANGE>     m_Ranges;
+		std::vector<std::vector<D3D12_DESCRIPTOR_RANGE>> m_Ranges;
 		std::vector<D3D12_STATIC_SAMPLER_DESC>  m_Samplers;
 		std::vector<D3D12_ROOT_PARAMETER>       m_Params;
 		D3D12_ROOT_SIGNATURE_DESC               m_Desc;
@@ -78,7 +99,7 @@ public:
 		uint32_t                                m_Flags;
 
 		void CheckStage(ShaderStage stage);
-		void SetParam(ShaderStage, int index, uint32_t reg, D3D12_DESCRIPTOR_RANGE_TYPE type);
+		void SetParam(ShaderStage, int index, uint32_t reg, D3D12_DESCRIPTOR_RANGE_TYPE type, uint32_t count = 1, uint32_t space = 0);
 	};
 
 	//=========================================================================
@@ -89,12 +110,17 @@ public:
 	bool Init(ID3D12Device* pDevice, const D3D12_ROOT_SIGNATURE_DESC* pDesc);
 	void Term();
 	ID3D12RootSignature* GetPtr() const;
+	const Layout& GetLayout() const;
+
+	static bool Serialize(const D3D12_ROOT_SIGNATURE_DESC* pDesc, ComPtr<ID3DBlob>& pBlob);
+	static Layout Analyze(const D3D12_ROOT_SIGNATURE_DESC* pDesc);
 
 private:
 	//=========================================================================
 	// private variables.
 	//=========================================================================
 	ComPtr<ID3D12RootSignature>     m_RootSignature;
+	Layout                          m_Layout = {};
 
 	//=========================================================================
 	// private methods.
@@ -0,0 +1,121 @@
+﻿//-----------------------------------------------------------------------------
+// File : SHProjector.h
+// Desc : Spherical Harmonics Irradiance Projection Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+
+///////////////////////////////////////////////////////////////////////////////
+// SHProjector class
+///////////////////////////////////////////////////////////////////////////////
+class SHProjector
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const uint32_t CoeffCount = 9;   //!< 3次(l <= 2)の係数の数です.
+
+	///////////////////////////////////////////////////////////////////////////
+	// SH9 structure
+	///////////////////////////////////////////////////////////////////////////
+	struct SH9
+	{
+		float   Coeffs[CoeffCount][4];      //!< 係数です. xyz が RGB, w は未使用で, シェーダの float4[9] と同じ配置です.
+	};
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      正距円筒図法(スフィアマップ)の環境マップを射影します.
+	//!
+	//! @param[in]      pPixels         RGBA32F のピクセルです.
+	//! @param[in]      width           横幅です.
+	//! @param[in]      height          縦幅です.
+	//! @param[in]      threadCount     使用するスレッド数です. 0 の場合はハードウェアスレッド数です.
+	//! @param[out]     result          放射輝度の係数です.
+	//! @note       行ごとにスレッドへ分配し, 4ピクセルずつ SSE で処理します.
+	//!             方向は SphereMapConverter の球と同じく, v = 0 が +Y, u = 0 が +Z です.
+	//-------------------------------------------------------------------------
+	static void ProjectEquirect(const float* pPixels, uint32_t width, uint32_t height, uint32_t threadCount, SH9& result);
+
+	//-------------------------------------------------------------------------
+	//! @brief      キューブマップの環境マップを射影します.
+	//!
+	//! @param[in]      pPixels         +X, -X, +Y, -Y, +Z, -Z の順に詰めた RGBA32F のピクセルです.
+	//! @param[in]      size            1面の縦横のサイズです.
+	//! @param[in]      threadCount     使用するスレッド数です. 0 の場合はハードウェアスレッド数です.
+	//! @param[out]     result          放射輝度の係数です.
+	//-------------------------------------------------------------------------
+	static void ProjectCube(const float* pPixels, uint32_t size, uint32_t threadCount, SH9& result);
+
+	//-------------------------------------------------------------------------
+	//! @brief      ProjectEquirect() と同じ射影を1スレッド・1ピクセルずつ倍精度で行います.
+	//!
+	//! @note       検証用の参照実装です.
+	//-------------------------------------------------------------------------
+	static void ProjectEquirectReference(const float* pPixels, uint32_t width, uint32_t height, SH9& result);
+
+	//-------------------------------------------------------------------------
+	//! @brief      ProjectCube() と同じ射影を1スレッド・1ピクセルずつ倍精度で行います.
+	//!
+	//! @note       検証用の参照実装です.
+	//-------------------------------------------------------------------------
+	static void ProjectCubeReference(const float* pPixels, uint32_t size, SH9& result);
+
+	//-------------------------------------------------------------------------
+	//! @brief      全ピクセルを総当たりで積分してディフューズのLD項を求めます.
+	//!
+	//! @param[in]      pPixels         RGBA32F のピクセルです.
+	//! @param[in]      width           横幅です.
+	//! @param[in]      height          縦幅です.
+	//! @param[in]      dir             法線ベクトルです(正規化済み).
+	//! @param[out]     result          放射照度 / π です.
+	//! @note       検証用の参照実装です. 1方向あたり全ピクセルを走査します.
+	//-------------------------------------------------------------------------
+	static void IntegrateEquirectReference(const float* pPixels, uint32_t width, uint32_t height, const float dir[3], float result[3]);
+
+	//-------------------------------------------------------------------------
+	//! @brief      放射輝度の係数をランバートの余弦ローブで畳み込みます.
+	//!
+	//! @param[in,out]  sh              放射輝度の係数です. 放射照度 / π の係数になります.
+	//! @note       IntegrateDiffuseLD_PS と同じく, Lambert BRDF を掛けた値(放射照度 / π)にします.
+	//-------------------------------------------------------------------------
+	static void ConvolveLambert(SH9& sh);
+
+	//-------------------------------------------------------------------------
+	//! @brief      基底関数の値を求めます.
+	//!
+	//! @param[in]      dir             方向ベクトルです(正規化済み).
+	//! @param[out]     basis           基底関数の値です.
+	//-------------------------------------------------------------------------
+	static void EvaluateBasis(const float dir[3], float basis[CoeffCount]);
+
+	//-------------------------------------------------------------------------
+	//! @brief      係数から指定方向の値を復元します.
+	//!
+	//! @param[in]      sh              係数です.
+	//! @param[in]      dir             方向ベクトルです(正規化済み).
+	//! @param[out]     result          RGB です.
+	//-------------------------------------------------------------------------
+	static void Evaluate(const SH9& sh, const float dir[3], float result[3]);
+
+private:
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	SHProjector() = delete;
+	~SHProjector() = delete;
+};
@@ -0,0 +1,66 @@
+﻿//-----------------------------------------------------------------------------
+// File : SceneComponents.h
+// Desc : Scene Components And Systems For EntityRegistry.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <EntityRegistry.h>
+#include <SimpleMath.h>
+
+//-----------------------------------------------------------------------------
+// Forward Declarations.
+//-----------------------------------------------------------------------------
+class Model;
+
+///////////////////////////////////////////////////////////////////////////////
+// LocalTransform structure
+///////////////////////////////////////////////////////////////////////////////
+struct LocalTransform
+{
+	DirectX::SimpleMath::Vector3    Position;   //!< 位置です.
+	DirectX::SimpleMath::Quaternion Rotation;   //!< 回転です.
+	DirectX::SimpleMath::Vector3    Scale;      //!< 拡大率です.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// WorldTransform structure
+///////////////////////////////////////////////////////////////////////////////
+struct WorldTransform
+{
+	DirectX::SimpleMath::Matrix     World;      //!< ワールド行列です.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// TransformNode structure
+///////////////////////////////////////////////////////////////////////////////
+struct TransformNode
+{
+	uint32_t                        Node;       //!< TransformHierarchy のノードです.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ModelRenderer structure
+///////////////////////////////////////////////////////////////////////////////
+struct ModelRenderer
+{
+	Model*                          pModel;     //!< 描画するモデルです.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// SceneSystems namespace
+///////////////////////////////////////////////////////////////////////////////
+namespace SceneSystems {
+
+//-----------------------------------------------------------------------------
+//! @brief      LocalTransform から WorldTransform を計算します.
+//!
+//! @param[in]      registry    エンティティの格納先です.
+//! @param[in]      deltaTime   経過時間(秒)です. 使用しません.
+//-----------------------------------------------------------------------------
+void UpdateWorldTransforms(EntityRegistry& registry, float deltaTime);
+
+} // namespace SceneSystems
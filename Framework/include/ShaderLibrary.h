@@ -0,0 +1,263 @@
+﻿//-----------------------------------------------------------------------------
+// File : ShaderLibrary.h
+// Desc : Compiled Shader Library Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <d3d12.h>
+#include <ComPtr.h>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+
+///////////////////////////////////////////////////////////////////////////////
+// ShaderLibrary class
+///////////////////////////////////////////////////////////////////////////////
+class ShaderLibrary
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	///////////////////////////////////////////////////////////////////////////
+	// Binding structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Binding
+	{
+		std::string             Name;       //!< リソース名です.
+		D3D_SHADER_INPUT_TYPE   Type;       //!< リソースの種類です.
+		uint32_t                Register;   //!< 先頭のレジスタ番号です.
+		uint32_t                Count;      //!< レジスタ数です. 0 はサイズ指定なしの配列です.
+		uint32_t                Space;      //!< レジスタスペースです.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// ArchiveItem structure
+	///////////////////////////////////////////////////////////////////////////
+	struct ArchiveItem
+	{
+		std::wstring    Name;       //!< シェーダファイル名です.
+		const void*     pData;      //!< バイトコードです.
+		size_t          Size;       //!< バイトコードのサイズです.
+		uint64_t        Hash;       //!< バイトコードのハッシュ値です.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// Stats structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Stats
+	{
+		uint32_t    Requests;       //!< 要求されたシェーダ数です.
+		uint32_t    NameHits;       //!< 読み込み済みのものを返却した数です.
+		uint32_t    ArchiveHits;    //!< アーカイブから取り出した数です.
+		uint32_t    FileReads;      //!< 個別のファイルから読み込んだ数です.
+		uint32_t    Interned;       //!< 名前は異なるが内容が同じで共有した数です.
+		uint32_t    Reflected;      //!< リフレクション情報を取得した数です.
+		uint64_t    Bytes;          //!< 保持しているバイトコードの合計サイズです.
+		double      MilliSec;       //!< 読み込みにかかった時間(ミリ秒)です.
+	};
+
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const uint32_t ArchiveMagic   = 0x42494C53;  //!< ファイル識別子('SLIB')です.
+	static const uint32_t ArchiveVersion = 1;           //!< ファイル構成を変えたら更新します.
+	static const size_t   DataAlignment  = 16;          //!< バイトコードの配置境界です.
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      インスタンスを取得します.
+	//-------------------------------------------------------------------------
+	static ShaderLibrary& GetInstance()
+	{
+		static ShaderLibrary instance;
+		return instance;
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	ShaderLibrary() = default;
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~ShaderLibrary() = default;
+
+	//-------------------------------------------------------------------------
+	//! @brief      シェーダアーカイブを読み込みます.
+	//!
+	//! @param[in]      path        アーカイブのファイルパスです.
+	//! @retval true    読み込みに成功.
+	//! @retval false   ファイルが無いか, 内容が正しくありません.
+	//! @note       ファイル全体を1回で読み込み, 以降はアーカイブに含まれる名前をファイルより優先します.
+	//!             シェーダを再コンパイルした場合は WriteArchive() で作り直してください.
+	//-------------------------------------------------------------------------
+	bool MountArchive(const wchar_t* path);
+
+	//-------------------------------------------------------------------------
+	//! @brief      読み込んだシェーダとアーカイブを全て破棄します.
+	//-------------------------------------------------------------------------
+	void Term();
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンパイル済みシェーダを取得します.
+	//!
+	//! @param[in]      name        シェーダファイル名です.
+	//! @param[out]     pBlob       バイトコードの格納先です.
+	//! @retval true    取得に成功.
+	//! @retval false   取得に失敗.
+	//! @note       同じ名前は1度だけ読み込み, 内容が同じものは名前が異なっても同じブロブを返却します.
+	//-------------------------------------------------------------------------
+	bool Load(const std::wstring& name, ComPtr<ID3DBlob>& pBlob);
+
+	//-------------------------------------------------------------------------
+	//! @brief      読み込み済みのシェーダをアーカイブに書き出します.
+	//!
+	//! @param[in]      path        アーカイブのファイルパスです.
+	//! @retval true    書き出しに成功.
+	//! @retval false   書き出しに失敗.
+	//-------------------------------------------------------------------------
+	bool WriteArchive(const wchar_t* path) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      シェーダが使用するリソースを取得します.
+	//!
+	//! @param[in]      shader      バイトコードです.
+	//! @param[out]     bindings    リソースの格納先です.
+	//! @retval true    取得に成功.
+	//! @retval false   取得に失敗.
+	//! @note       リフレクション結果はバイトコードのハッシュ値ごとに保持します.
+	//-------------------------------------------------------------------------
+	bool GetBindings(const D3D12_SHADER_BYTECODE& shader, std::vector<Binding>& bindings);
+
+	//-------------------------------------------------------------------------
+	//! @brief      パイプラインステートのシェーダがルートシグニチャに収まっているか検証します.
+	//!
+	//! @param[in]      desc        パイプラインステートの構成です.
+	//! @param[in]      pRootSig    シリアライズしたルートシグニチャです.
+	//! @param[in]      size        シリアライズしたルートシグニチャのサイズです.
+	//! @retval true    全てのリソースがバインドされています.
+	//! @retval false   バインドされていないリソースがあります. 内容はログに出力します.
+	//-------------------------------------------------------------------------
+	bool ValidatePipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, const void* pRootSig, size_t size);
+
+	//-------------------------------------------------------------------------
+	//! @brief      統計情報を取得します.
+	//-------------------------------------------------------------------------
+	const Stats& GetStats() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      読み込み済みのシェーダ名の数を取得します.
+	//-------------------------------------------------------------------------
+	size_t GetCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      内容が異なるバイトコードの数を取得します.
+	//-------------------------------------------------------------------------
+	size_t GetBlobCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      アーカイブを読み込んでいるかどうかチェックします.
+	//-------------------------------------------------------------------------
+	bool HasArchive() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      アーカイブに書き出すデータを構築します.
+	//!
+	//! @param[in]      items       格納するシェーダです. Hash は無視して計算し直します.
+	//! @param[out]     archive     ファイルに書き出すデータです.
+	//! @note       内容が同じバイトコードは1つだけ格納します.
+	//-------------------------------------------------------------------------
+	static void BuildArchive(const std::vector<ArchiveItem>& items, std::vector<uint8_t>& archive);
+
+	//-------------------------------------------------------------------------
+	//! @brief      アーカイブの内容を検証して取り出します.
+	//!
+	//! @param[in]      archive     ファイルから読み込んだデータです.
+	//! @param[out]     items       格納されているシェーダです. pData は archive を参照します.
+	//! @retval true    有効なデータです.
+	//! @retval false   識別子・バージョン・範囲・ハッシュ値のいずれかが一致しません.
+	//-------------------------------------------------------------------------
+	static bool ParseArchive(const std::vector<uint8_t>& archive, std::vector<ArchiveItem>& items);
+
+	//-------------------------------------------------------------------------
+	//! @brief      リソースがルートシグニチャに収まっているか検証します.
+	//!
+	//! @param[in]      desc        ルートシグニチャの構成です.
+	//! @param[in]      visibility  シェーダステージです.
+	//! @param[in]      bindings    シェーダが使用するリソースです.
+	//! @param[out]     errors      バインドされていないリソースの説明の格納先です.
+	//! @retval true    全てのリソースがバインドされています.
+	//! @retval false   バインドされていないリソースがあります.
+	//-------------------------------------------------------------------------
+	static bool ValidateBindings(
+		const D3D12_ROOT_SIGNATURE_DESC&    desc,
+		D3D12_SHADER_VISIBILITY             visibility,
+		const std::vector<Binding>&         bindings,
+		std::vector<std::string>&           errors);
+
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// BlobEntry structure
+	///////////////////////////////////////////////////////////////////////////
+	struct BlobEntry
+	{
+		ComPtr<ID3DBlob>        pBlob;              //!< バイトコードです.
+		std::vector<Binding>    Bindings;           //!< リフレクション結果です.
+		bool                    Reflected = false;  //!< リフレクション済みかどうか.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// ArchiveHeader structure
+	///////////////////////////////////////////////////////////////////////////
+	struct ArchiveHeader
+	{
+		uint32_t    Magic;      //!< ファイル識別子です.
+		uint32_t    Version;    //!< ファイルバージョンです.
+		uint32_t    Count;      //!< 名前の数です.
+		uint32_t    NameSize;   //!< 名前テーブルのサイズ(文字数)です.
+		uint64_t    Size;       //!< ファイル全体のサイズです.
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// ArchiveEntry structure
+	///////////////////////////////////////////////////////////////////////////
+	struct ArchiveEntry
+	{
+		uint64_t    Hash;           //!< バイトコードのハッシュ値です.
+		uint64_t    Offset;         //!< バイトコードの先頭位置です.
+		uint64_t    Size;           //!< バイトコードのサイズです.
+		uint32_t    NameOffset;     //!< 名前テーブル内の先頭位置(文字数)です.
+		uint32_t    NameLength;     //!< 名前の長さ(文字数)です.
+	};
+
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	std::unordered_map<std::wstring, uint64_t>      m_Names;        //!< 名前ごとのバイトコードのハッシュ値です.
+	std::unordered_map<uint64_t, BlobEntry>         m_Blobs;        //!< ハッシュ値ごとのバイトコードです.
+	std::unordered_map<std::wstring, ArchiveItem>   m_Archived;     //!< アーカイブに含まれるシェーダです.
+	std::vector<uint8_t>                            m_Archive;      //!< アーカイブの内容です.
+	Stats                                           m_Stats = {};   //!< 統計情報です.
+	mutable std::mutex                              m_Mutex;        //!< 排他制御用です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	bool Reflect(BlobEntry& entry, const D3D12_SHADER_BYTECODE& shader);
+
+	ShaderLibrary(const ShaderLibrary&) = delete;
+	void operator = (const ShaderLibrary&) = delete;
+};
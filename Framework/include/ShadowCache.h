@@ -0,0 +1,224 @@
+﻿//-----------------------------------------------------------------------------
+// File : ShadowCache.h
+// Desc : Static Shadow Cache Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <CascadedShadow.h>
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// ShadowCache class
+///////////////////////////////////////////////////////////////////////////////
+class ShadowCache
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const uint32_t RegionCount         = 8;     //!< 1タイルを RegionCount x RegionCount の領域に分けて無効化します.
+	static const uint32_t DefaultSettleFrames = 30;    //!< 動かなくなってから静的とみなすまでのフレーム数の既定値です.
+
+	///////////////////////////////////////////////////////////////////////////
+	// Rect structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Rect
+	{
+		uint32_t    Left;       //!< タイル内の左端のテクセルです.
+		uint32_t    Top;        //!< タイル内の上端のテクセルです.
+		uint32_t    Right;      //!< タイル内の右端のテクセルです(含まない).
+		uint32_t    Bottom;     //!< タイル内の下端のテクセルです(含まない).
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// Stats structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Stats
+	{
+		uint32_t    StaticCasters;      //!< 静的な遮蔽物の数です.
+		uint32_t    DynamicCasters;     //!< 動的な遮蔽物の数です.
+		uint32_t    InvalidCascades;    //!< ライトの変化で全体を描き直すカスケード数です.
+		uint32_t    DirtyRegions;       //!< 描き直す領域の数です.
+		uint32_t    StaticDraws;        //!< キャッシュに描画する静的な遮蔽物の数です(カスケードごとに数えます).
+		uint32_t    DynamicDraws;       //!< キャッシュに重ねる動的な遮蔽物の数です(カスケードごとに数えます).
+		uint32_t    UncachedDraws;      //!< キャッシュしない場合の描画数です.
+	};
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	ShadowCache();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~ShadowCache();
+
+	//-------------------------------------------------------------------------
+	//! @brief      キャッシュ全体を無効にします.
+	//!
+	//! @note       描画を行わなかったフレームの後や, キャッシュを使い始めるときに呼び出します.
+	//-------------------------------------------------------------------------
+	void Invalidate();
+
+	//-------------------------------------------------------------------------
+	//! @brief      動かなくなってから静的とみなすまでのフレーム数を設定します.
+	//-------------------------------------------------------------------------
+	void SetSettleFrames(uint32_t frames);
+
+	//-------------------------------------------------------------------------
+	//! @brief      フレームの更新を開始します.
+	//!
+	//! @param[in]      pCascades       カスケードです.
+	//! @param[in]      cascadeCount    カスケード数です.
+	//! @param[in]      tileSize        1カスケードあたりのシャドウマップサイズです.
+	//! @note       描き直す範囲は CommitFrame() を呼び出すまで残ります.
+	//!             ビュー射影行列が変わったカスケードは全体を描き直します.
+	//-------------------------------------------------------------------------
+	void BeginFrame(const CascadedShadow::Cascade* pCascades, uint32_t cascadeCount, uint32_t tileSize);
+
+	//-------------------------------------------------------------------------
+	//! @brief      遮蔽物の現在の状態を設定します.
+	//!
+	//! @param[in]      index       遮蔽物の番号です.
+	//! @param[in]      world       ワールド行列です.
+	//! @param[in]      center      ワールド空間のAABBの中心です.
+	//! @param[in]      extent      ワールド空間のAABBの半分の大きさです.
+	//! @note       動いた静的な遮蔽物は動的に切り替え, 動く前の範囲を描き直します.
+	//!             動的な遮蔽物が一定フレーム動かなければ静的に戻し, 現在の範囲を描き直します.
+	//-------------------------------------------------------------------------
+	void UpdateCaster
+	(
+		uint32_t                    index,
+		const DirectX::XMFLOAT4X4&  world,
+		const DirectX::XMFLOAT3&    center,
+		const DirectX::XMFLOAT3&    extent
+	);
+
+	//-------------------------------------------------------------------------
+	//! @brief      遮蔽物の更新を終了します.
+	//!
+	//! @param[in]      casterCount     遮蔽物の数です. これ以降の番号は削除し, その範囲を描き直します.
+	//-------------------------------------------------------------------------
+	void EndUpdate(uint32_t casterCount);
+
+	//-------------------------------------------------------------------------
+	//! @brief      カスケードの描画リストを作成します.
+	//!
+	//! @param[in]      cascade         カスケード番号です.
+	//! @param[in]      visible         カスケードから可視な遮蔽物の番号です.
+	//! @param[out]     staticDraws     描き直す範囲に掛かる静的な遮蔽物の番号の格納先です.
+	//! @param[out]     dynamicDraws    動的な遮蔽物の番号の格納先です.
+	//! @note       EndUpdate() の後に, カスケードごとに1回呼び出します.
+	//-------------------------------------------------------------------------
+	void BuildDrawList
+	(
+		uint32_t                        cascade,
+		const std::vector<uint32_t>&    visible,
+		std::vector<uint32_t>&          staticDraws,
+		std::vector<uint32_t>&          dynamicDraws
+	);
+
+	//-------------------------------------------------------------------------
+	//! @brief      フレームの描画結果を確定します.
+	//!
+	//! @note       描画コマンドを提出した後に呼び出します. 描き直す範囲を描画済みとし,
+	//!             動的な遮蔽物を重ねたかどうかを次のフレームの複製の判定に使います.
+	//-------------------------------------------------------------------------
+	void CommitFrame();
+
+	//-------------------------------------------------------------------------
+	//! @brief      キャッシュをアトラスへ複製する必要があるかどうかを判定します.
+	//!
+	//! @retval true    描き直す範囲があるか, 最後に確定したフレームで動的な遮蔽物を重ねました.
+	//! @retval false   アトラスはキャッシュと同じ内容です.
+	//-------------------------------------------------------------------------
+	bool NeedsCopy() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      描き直すタイル内の範囲を取得します.
+	//!
+	//! @param[in]      cascade     カスケード番号です.
+	//! @return     描き直す範囲を返却します. 描き直さない場合は空(Left == Right)です.
+	//-------------------------------------------------------------------------
+	const Rect& GetDirtyRect(uint32_t cascade) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      描き直す領域を取得します.
+	//!
+	//! @param[in]      cascade     カスケード番号です.
+	//! @return     領域ごとのビット(行 * RegionCount + 列)を返却します.
+	//-------------------------------------------------------------------------
+	uint64_t GetDirtyMask(uint32_t cascade) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      遮蔽物が静的かどうかを取得します.
+	//-------------------------------------------------------------------------
+	bool IsStatic(uint32_t index) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      現在のフレームの統計を取得します.
+	//-------------------------------------------------------------------------
+	const Stats& GetStats() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      ワールド空間のAABBが掛かる領域を求めます.
+	//!
+	//! @param[in]      viewProj    カスケードのビュー射影行列です.
+	//! @param[in]      center      ワールド空間のAABBの中心です.
+	//! @param[in]      extent      ワールド空間のAABBの半分の大きさです.
+	//! @return     領域ごとのビット(行 * RegionCount + 列)を返却します. 投影範囲外の場合は 0 です.
+	//-------------------------------------------------------------------------
+	static uint64_t CalcRegionMask(const DirectX::XMFLOAT4X4& viewProj, const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extent);
+
+private:
+	///////////////////////////////////////////////////////////////////////////
+	// Caster structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Caster
+	{
+		DirectX::XMFLOAT4X4 World;          //!< 前回のワールド行列です.
+		DirectX::XMFLOAT3   Center;         //!< 前回のAABBの中心です.
+		DirectX::XMFLOAT3   Extent;         //!< 前回のAABBの半分の大きさです.
+		uint32_t            StillFrames;    //!< 動いていないフレーム数です.
+		bool                Static;         //!< キャッシュに描画されているかどうかです.
+	};
+
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	std::vector<Caster>     m_Casters;                                          //!< 遮蔽物です.
+	DirectX::XMFLOAT4X4     m_ViewProj [CascadedShadow::MaxCascadeCount];      //!< キャッシュを描画したビュー射影行列です.
+	uint64_t                m_Dirty    [CascadedShadow::MaxCascadeCount];      //!< 描き直す領域です.
+	Rect                    m_DirtyRect[CascadedShadow::MaxCascadeCount];      //!< 描き直すタイル内の範囲です.
+	uint32_t                m_CascadeCount;                                     //!< キャッシュのカスケード数です.
+	uint32_t                m_TileSize;                                         //!< キャッシュのタイルサイズです.
+	uint32_t                m_SettleFrames;                                     //!< 静的とみなすまでのフレーム数です.
+	bool                    m_Valid;                                            //!< キャッシュが有効かどうかです.
+	bool                    m_FrameDynamic;                                     //!< 現在のフレームで動的な遮蔽物を重ねるかどうかです.
+	bool                    m_AtlasDynamic;                                     //!< 確定したフレームで動的な遮蔽物を重ねたかどうかです.
+	Stats                   m_Stats;                                            //!< 現在のフレームの統計です.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	void MarkDirty(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extent);
+
+	ShadowCache         (const ShadowCache&) = delete;
+	void operator =     (const ShadowCache&) = delete;
+};
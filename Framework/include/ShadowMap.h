@@ -7,6 +7,10 @@
 #include <Renderer.h>
 #include <CommonBufferManager.h>
 #include <GameObject.h>
+#include <InstanceBuffer.h>
+#include <CascadedShadow.h>
+#include <ShadowCache.h>
+#include <unordered_map>
 
 class ShadowMap : public Renderer {
 public:
@@ -18,22 +22,37 @@ public:
 	struct DrawSource {
 		DepthTarget&						DepthDest;
 		const CommonBufferManager&			Commonbufmanager;
-		const std::vector<GameObject*>&		GameObjects;
+		const std::vector<GameObject*>*		pCascadeObjects;	// カスケードごとの描画オブジェクト(CascadeCount 個).
+		uint32_t							CascadeCount;
+		uint32_t							TileSize;			// 1カスケードあたりのシャドウマップサイズ.
 		const Vector3&						LightDirection;
+		InstanceBuffer*						pInstances;		// nullptr の場合はオブジェクトごとに描画する.
+		DepthTarget*						pStaticDest;		// 静的な遮蔽物のキャッシュ. nullptr の場合はキャッシュしない.
+		const std::vector<GameObject*>*		pStaticObjects;		// カスケードごとの描き直す静的なオブジェクト(CascadeCount 個).
+		const ShadowCache::Rect*			pDirtyRects;		// カスケードごとの描き直すタイル内の範囲(CascadeCount 個).
 	};
 
 	bool Init(ComPtr<ID3D12Device> pDevice, DescriptorPool* pool, DXGI_FORMAT rtv_format, DXGI_FORMAT dsv_format);
-	void Term();
+	void Term() override;
 	void DrawShadowMap(ID3D12GraphicsCommandList* pCmd,	int frameindex, DrawSource & s);
+	void DrawStaticShadowMap(ID3D12GraphicsCommandList* pCmd, int frameindex, DrawSource& s);	// pStaticDest を深度書き込み状態で呼び出す.
+	void CopyStaticShadowMap(ID3D12GraphicsCommandList* pCmd, DrawSource& s);					// pStaticDest を複製元, DepthDest を複製先の状態で呼び出す.
 	
 protected:
 
 	const wchar_t*	m_VSPath = L"DepthShadow.cso";
 	const wchar_t*	m_PSPath = L"";
+	const wchar_t*	m_InstancedVSPath = L"DepthShadowInstanced.cso";
 	ConstantBuffer	m_CB[App::FrameCount];		
 
+	ComPtr<ID3D12PipelineState>									m_pInstancedPSO;	// ワールド行列をインスタンスバッファから読むPSO.
+	std::unordered_map<std::wstring, std::vector<GameObject*>>	m_Batches;			// モデルごとにまとめたオブジェクト.
+
 	bool CreateRootSig(ComPtr<ID3D12Device> pDevice) override;
 	void UpdateConstantBuffer(int frameindex, Vector3 lighrDir);
+	void SetPipeline(ID3D12GraphicsCommandList* pCmd, int frameindex, DrawSource& s);
+	void SetTile(ID3D12GraphicsCommandList* pCmd, uint32_t cascade, uint32_t tileSize, const D3D12_RECT* pScissor);
+	void DrawObjects(ID3D12GraphicsCommandList* pCmd, int frameindex, const std::vector<GameObject*>& objects, InstanceBuffer* pInstances);
 	bool CreatePipeLineState(ComPtr<ID3D12Device> pDevice, DXGI_FORMAT rtv_format, DXGI_FORMAT dsv_format) override;
 };
 
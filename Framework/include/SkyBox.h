@@ -13,6 +13,7 @@
 #include <ConstantBuffer.h>
 #include <VertexBuffer.h>
 #include <SimpleMath.h>
+#include <App.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 // SkyBox class
@@ -69,6 +70,7 @@ public:
 	//! @brief      描画処理を行います.
 	//!
 	//! @param[in]      pCmd            グラフィックスコマンドリストです.
+	//! @param[in]      frameIndex      フレーム番号です.
 	//! @param[in]      handleCubeMap   キューブマップのディスクリプタハンドルです.
 	//! @param[in]      viewMatrix      ビュー行列です.
 	//! @param[in]      projMatrix      射影行列です.
@@ -76,6 +78,7 @@ public:
 	//-------------------------------------------------------------------------
 	void Draw(
 		ID3D12GraphicsCommandList* pCmd,
+		uint32_t                                frameIndex,
 		D3D12_GPU_DESCRIPTOR_HANDLE             handleCubeMap,
 		const DirectX::SimpleMath::Matrix& viewMatrix,
 		const DirectX::SimpleMath::Matrix& projMatrix,
@@ -88,9 +91,8 @@ private:
 	DescriptorPool* m_pPoolRes;     //!< CBV用ディスクリプタプールです.
 	ComPtr<ID3D12RootSignature>     m_pRootSig;     //!< ルートシグニチャ.
 	ComPtr<ID3D12PipelineState>     m_pPSO;         //!< パイプラインステートです.
-	ConstantBuffer                  m_CB[2];        //!< 定数バッファです.
+	ConstantBuffer                  m_CB[App::FrameCount];  //!< フレームごとの定数バッファです.
 	VertexBuffer                    m_VB;           //!< 頂点バッファです.
-	int                             m_Index;        //!< バッファ番号です.
 
 	//=========================================================================
 	// private methods.
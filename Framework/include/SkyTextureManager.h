@@ -6,11 +6,48 @@
 #include <IBLBaker.h>
 #include <Fence.h>
 #include <CommandList.h>
+#include <IBLCache.h>
+#include <SHProjector.h>
+#include <IBLReferenceBaker.h>
+#include <SphereMapCpuConverter.h>
+#include <future>
 
 class SkyManager {
 
 public:
-	IBLBaker                        m_IBLBaker;                     //!< IBLxCN.
+	//! ベイク結果のキャッシュの状態です.
+	struct CacheStats
+	{
+		bool        DFGHit;             //!< DFGテクスチャをキャッシュから読み込んだかどうか.
+		bool        LDHit;              //!< LDテクスチャをキャッシュから読み込んだかどうか.
+		uint32_t    Saved;              //!< 保存したファイル数です.
+		double      PrepareMilliSec;    //!< ハッシュ計算とキャッシュの読み込みにかかった時間(ミリ秒)です.
+		double      BakeMilliSec;       //!< IBLBake() にかかった時間(ミリ秒)です.
+	};
+
+	//! CPU参照ベイクとGPUベイクの比較結果です.
+	struct ReferenceStats
+	{
+		bool        Valid;              //!< 比較したかどうか.
+		float       DFGMaxError;        //!< DFGテクスチャの最大絶対誤差です.
+		float       DFGRmsError;        //!< DFGテクスチャの二乗平均平方根誤差です.
+		float       LDMaxError;         //!< SpecularLDテクスチャの最大相対誤差です.
+		float       LDRmsError;         //!< SpecularLDテクスチャの相対誤差の二乗平均平方根です.
+		double      DFGMilliSec;        //!< CPUでのDFG項の積分にかかった時間(ミリ秒)です.
+		double      LDMilliSec;         //!< CPUでのLD項の積分にかかった時間(ミリ秒)です.
+	};
+
+	//! CPUとGPUのキューブマップ変換の比較結果です.
+	struct ConvertStats
+	{
+		bool        Valid;              //!< 比較したかどうか.
+		uint32_t    Size;               //!< キューブマップのサイズです.
+		float       MaxError;           //!< 最上位ミップの最大相対誤差です.
+		float       RmsError;           //!< 最上位ミップの相対誤差の二乗平均平方根です.
+		double      MilliSec;           //!< CPUでの変換にかかった時間(ミリ秒)です.
+	};
+
+	IBLBaker                        m_IBLBaker;                     //!< IBLベイク.
 
 	bool Init(ComPtr<ID3D12Device> pDevice, DescriptorPool* rtvPool, DescriptorPool* resPool, ComPtr<ID3D12CommandQueue> commandQueue, std::wstring path);
 	bool IBLBake(ComPtr<ID3D12Device> pDevice, DescriptorPool* rtvPool, DescriptorPool* resPool, CommandList& commandList, ComPtr<ID3D12CommandQueue> commandQueue, Fence& fence);
@@ -20,14 +57,50 @@ public:
 
 	void Term();
 
+	const CacheStats& GetCacheStats() const { return m_CacheStats; }
+	bool IsCacheSaving() const;
+
+	const SHProjector::SH9& GetIrradianceSH() const { return m_IrradianceSH; }
+	bool HasIrradianceSH() const { return m_HasIrradianceSH; }
+	double GetIrradianceMilliSec() const { return m_IrradianceMilliSec; }
+
+	bool CompareReferenceBake(ID3D12Device* pDevice, CommandList& commandList, ID3D12CommandQueue* pQueue, Fence& fence, uint32_t threadCount);
+	const ReferenceStats& GetReferenceStats() const { return m_ReferenceStats; }
+
+	bool CompareCpuCubeMap(ID3D12Device* pDevice, CommandList& commandList, ID3D12CommandQueue* pQueue, Fence& fence, uint32_t threadCount);
+	const ConvertStats& GetConvertStats() const { return m_ConvertStats; }
+
 private:
-	SkyBox                          m_SkyBox;                       //!< XJC{bNXł.
-	Texture                         m_SphereMap;                    //!< XtBA}bvł.
-	SphereMapConverter              m_SphereMapConverter;           //!< XtBA}bvRo[^.
+	SkyBox                          m_SkyBox;                       //!< スカイボックスです.
+	Texture                         m_SphereMap;                    //!< スフィアマップです.
+	SphereMapConverter              m_SphereMapConverter;           //!< スフィアマップコンバータ.
 
 	std::wstring m_SkyTexturePath;
+	std::wstring m_SkyTextureFullPath;
+	std::wstring m_CacheDir = L"IBLCache";                          //!< ベイク結果の保存先です.
+
+	IBLCache::Key                   m_CacheKey = {};                //!< ベイク条件です.
+	IBLCache::Texture               m_CachedDFG;                    //!< キャッシュから読み込んだDFGテクスチャです.
+	IBLCache::Texture               m_CachedDiffuseLD;              //!< キャッシュから読み込んだDiffuseLDテクスチャです.
+	IBLCache::Texture               m_CachedSpecularLD;             //!< キャッシュから読み込んだSpecularLDテクスチャです.
+	std::future<void>               m_LoadTask;                     //!< キャッシュの読み込み処理です.
+	std::future<uint32_t>           m_SaveTask;                     //!< キャッシュの保存処理です.
+	CacheStats                      m_CacheStats = {};              //!< キャッシュの状態です.
+
+	SHProjector::SH9                m_IrradianceSH = {};            //!< ディフューズIBL用の放射照度 / π の係数です.
+	bool                            m_HasIrradianceSH = false;      //!< 係数を求めたかどうか.
+	double                          m_IrradianceMilliSec = 0.0;     //!< 射影にかかった時間(ミリ秒)です.
+
+	ReferenceStats                  m_ReferenceStats = {};          //!< CPU参照ベイクとの比較結果です.
+	ConvertStats                    m_ConvertStats = {};            //!< CPUでのキューブマップ変換との比較結果です.
 
 	bool InitSphereMapTexture(ComPtr<ID3D12Device> pDevice, DescriptorPool* resPool, ComPtr<ID3D12CommandQueue> commandQueue, std::wstring path);
 	bool InitSphereMapConverter(ComPtr<ID3D12Device> pDevice, DescriptorPool* rtvPool, DescriptorPool* resPool);
 	bool InitSkyBox(ComPtr<ID3D12Device> pDevice, DescriptorPool* resPool);
+
+	void StartCacheLoad();
+	bool UploadCache(ID3D12Device* pDevice, ID3D12CommandQueue* pQueue);
+	bool SaveCache(ID3D12Device* pDevice, CommandList& commandList, ID3D12CommandQueue* pQueue, Fence& fence, bool saveDFG, bool saveLD);
+	bool ReadbackTextures(ID3D12Device* pDevice, CommandList& commandList, ID3D12CommandQueue* pQueue, Fence& fence, ID3D12Resource* const* ppResources, IBLCache::Texture* const* ppTextures, uint32_t count);
+	bool ProjectIrradiance(ID3D12Device* pDevice, CommandList& commandList, ID3D12CommandQueue* pQueue, Fence& fence);
 };
\ No newline at end of file
@@ -83,6 +83,13 @@ public:
 	//-------------------------------------------------------------------------
 	D3D12_RESOURCE_DESC GetCubeMapDesc() const;
 
+	//-------------------------------------------------------------------------
+	//! @brief      キューブマップを取得します.
+	//!
+	//! @return     キューブマップを返却します.
+	//-------------------------------------------------------------------------
+	ID3D12Resource* GetCubeMap() const;
+
 	//-------------------------------------------------------------------------
 	//! @brief      キューブマップのCPUディスクリプタハンドルを取得します.
 	//!
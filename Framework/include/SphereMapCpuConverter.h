@@ -0,0 +1,103 @@
+﻿//-----------------------------------------------------------------------------
+// File : SphereMapCpuConverter.h
+// Desc : Convert Sphere Map To Cube Map On CPU.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <IBLCache.h>
+#include <cstdint>
+
+///////////////////////////////////////////////////////////////////////////////
+// SphereMapCpuConverter class
+///////////////////////////////////////////////////////////////////////////////
+class SphereMapCpuConverter
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const uint32_t MaxHalfValue = 65504;    //!< BC6H(UF16) で表現できる最大値です.
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      キューブマップのサイズとミップレベル数を求めます.
+	//!
+	//! @param[in]      sphereWidth     スフィアマップの横幅です.
+	//! @param[in]      mapSize         希望するサイズです. -1 の場合は横幅の 1/4 です.
+	//! @param[out]     pMipLevels      1x1 までのミップレベル数の格納先です. nullptr の場合は格納しません.
+	//! @return     希望するサイズ以上で最小の2のべき乗を返却します.
+	//! @note       SphereMapConverter::Init() と同じサイズになります.
+	//-------------------------------------------------------------------------
+	static uint32_t CalcCubeSize(uint32_t sphereWidth, int mapSize, uint32_t* pMipLevels);
+
+	//-------------------------------------------------------------------------
+	//! @brief      スフィアマップをキューブマップに変換します.
+	//!
+	//! @param[in]      pPixels         スフィアマップのピクセルです(RGBA32F, 行優先).
+	//! @param[in]      width           スフィアマップの横幅です.
+	//! @param[in]      height          スフィアマップの縦幅です.
+	//! @param[in]      size            キューブマップの最上位ミップのサイズです.
+	//! @param[in]      mipLevels       ミップレベル数です.
+	//! @param[in]      format          出力フォーマットです. R32G32B32A32_FLOAT か R16G16B16A16_FLOAT を指定します.
+	//! @param[in]      threadCount     使用するスレッド数です. 0 の場合はハードウェアスレッド数です.
+	//! @param[out]     result          SphereMapConverter のキューブマップと同じ向き・配置のテクスチャです.
+	//! @retval true    変換に成功.
+	//! @retval false   引数が不正です.
+	//! @note       最上位ミップは4テクセルずつ SSE でバイリニアサンプルし, 面と行をスレッドに分配します.
+	//!             下位のミップは 2x2 の平均で求めます.
+	//!             R16G16B16A16_FLOAT の場合は BC6H(UF16) の圧縮にそのまま渡せるよう,
+	//!             RGB を [0, MaxHalfValue] に収めて負値と NaN を取り除き, アルファを 1 にします.
+	//-------------------------------------------------------------------------
+	static bool Convert(
+		const float*        pPixels,
+		uint32_t            width,
+		uint32_t            height,
+		uint32_t            size,
+		uint32_t            mipLevels,
+		IBLCache::FORMAT    format,
+		uint32_t            threadCount,
+		IBLCache::Texture&  result);
+
+	//-------------------------------------------------------------------------
+	//! @brief      スフィアマップを1方向だけサンプルします.
+	//!
+	//! @param[in]      pPixels         スフィアマップのピクセルです(RGBA32F, 行優先).
+	//! @param[in]      width           スフィアマップの横幅です.
+	//! @param[in]      height          スフィアマップの縦幅です.
+	//! @param[in]      dir             キューブマップをサンプルする方向です.
+	//! @param[out]     result          RGBA の格納先です.
+	//! @note       検証用の参照実装です. atan2f() / acosf() で座標を求めます.
+	//-------------------------------------------------------------------------
+	static void SampleReference(const float* pPixels, uint32_t width, uint32_t height, const float dir[3], float result[4]);
+
+	//-------------------------------------------------------------------------
+	//! @brief      32bit浮動小数を16bit浮動小数に変換します.
+	//!
+	//! @note       最近接偶数丸めです. 範囲外は無限大になります.
+	//-------------------------------------------------------------------------
+	static uint16_t FloatToHalf(float value);
+
+	//-------------------------------------------------------------------------
+	//! @brief      16bit浮動小数を32bit浮動小数に変換します.
+	//-------------------------------------------------------------------------
+	static float HalfToFloat(uint16_t value);
+
+private:
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	SphereMapCpuConverter() = delete;
+	~SphereMapCpuConverter() = delete;
+};
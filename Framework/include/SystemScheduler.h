@@ -0,0 +1,109 @@
+﻿//-----------------------------------------------------------------------------
+// File : SystemScheduler.h
+// Desc : Entity System Scheduling Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <EntityRegistry.h>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <functional>
+
+///////////////////////////////////////////////////////////////////////////////
+// SystemScheduler class
+///////////////////////////////////////////////////////////////////////////////
+class SystemScheduler
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	using SystemFunc = std::function<void(EntityRegistry&, float)>;
+
+	///////////////////////////////////////////////////////////////////////////
+	// PHASE enum
+	///////////////////////////////////////////////////////////////////////////
+	enum PHASE
+	{
+		PHASE_PRE_UPDATE = 0,   //!< 入力やスポーンなど.
+		PHASE_UPDATE,           //!< ゲームロジック.
+		PHASE_TRANSFORM,        //!< ワールド行列の更新.
+		PHASE_PRE_RENDER,       //!< カリングや描画リストの構築.
+		PHASE_COUNT
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// SystemInfo structure
+	///////////////////////////////////////////////////////////////////////////
+	struct SystemInfo
+	{
+		std::string     Name;       //!< 名前です.
+		PHASE           Phase;      //!< 実行するフェーズです.
+		SystemFunc      Func;       //!< 実行する関数です.
+		bool            Enable;     //!< 実行するかどうか.
+		double          MicroSec;   //!< 直前の実行時間(マイクロ秒)です.
+	};
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	SystemScheduler();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~SystemScheduler();
+
+	//-------------------------------------------------------------------------
+	//! @brief      システムを登録します.
+	//!
+	//! @param[in]      name        名前です.
+	//! @param[in]      phase       実行するフェーズです. 同じフェーズ内は登録順に実行します.
+	//! @param[in]      func        実行する関数です.
+	//-------------------------------------------------------------------------
+	void Add(const char* name, PHASE phase, SystemFunc func);
+
+	//-------------------------------------------------------------------------
+	//! @brief      全てのシステムを破棄します.
+	//-------------------------------------------------------------------------
+	void Clear();
+
+	//-------------------------------------------------------------------------
+	//! @brief      有効なシステムをフェーズ順に実行します.
+	//!
+	//! @param[in]      registry    エンティティの格納先です.
+	//! @param[in]      deltaTime   経過時間(秒)です.
+	//-------------------------------------------------------------------------
+	void Run(EntityRegistry& registry, float deltaTime);
+
+	//-------------------------------------------------------------------------
+	//! @brief      システムを取得します.
+	//-------------------------------------------------------------------------
+	std::vector<SystemInfo>& GetSystems();
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+	std::vector<SystemInfo>     m_Systems;      //!< フェーズ順に並べたシステムです.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	SystemScheduler (const SystemScheduler&) = delete;
+	void operator = (const SystemScheduler&) = delete;
+};
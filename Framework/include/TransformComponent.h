@@ -9,7 +9,7 @@ public:
     TransformComponent();
     TransformComponent(const Matrix& transform);
 
-    Matrix GetTransform() const { return m_transform; }
+    const Matrix& GetTransform() const { return m_transform; }
     void SetTransform(const Matrix& transform) { m_transform = transform; }
 
     Vector3 GetPosition() const { return m_transform.Translation(); }
@@ -53,7 +53,7 @@ public:
         else                m_transform.Forward(m_transform.Forward() / m_transform.Forward().Length() * 0.001f);
     }
 
-    // \bh
+    // メソッド
     void Move(const Vector3& offset) {
         m_transform.Translation(m_transform.Translation() + offset);
     }
@@ -65,5 +65,5 @@ public:
     void Update(float deltaTime) override {}
 
 private:
-    Matrix m_transform; // Transforms
+    Matrix m_transform; // Transform行列
 };
\ No newline at end of file
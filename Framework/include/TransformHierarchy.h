@@ -0,0 +1,198 @@
+﻿//-----------------------------------------------------------------------------
+// File : TransformHierarchy.h
+// Desc : Hierarchical Transform Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// TransformHierarchy class
+///////////////////////////////////////////////////////////////////////////////
+class TransformHierarchy
+{
+	//=========================================================================
+	// list of friend classes and methods.
+	//=========================================================================
+	/* NOTHING */
+
+public:
+	//=========================================================================
+	// public variables.
+	//=========================================================================
+	static const uint32_t NullNode = 0xffffffff;    //!< 無効なノードです.
+
+	//=========================================================================
+	// public methods.
+	//=========================================================================
+
+	//-------------------------------------------------------------------------
+	//! @brief      コンストラクタです.
+	//-------------------------------------------------------------------------
+	TransformHierarchy();
+
+	//-------------------------------------------------------------------------
+	//! @brief      デストラクタです.
+	//-------------------------------------------------------------------------
+	~TransformHierarchy();
+
+	//-------------------------------------------------------------------------
+	//! @brief      全てのノードを破棄します.
+	//-------------------------------------------------------------------------
+	void Clear();
+
+	//-------------------------------------------------------------------------
+	//! @brief      領域を予約します.
+	//-------------------------------------------------------------------------
+	void Reserve(size_t count);
+
+	//-------------------------------------------------------------------------
+	//! @brief      ノードを生成します.
+	//!
+	//! @param[in]      parent      親ノードです. NullNode の場合はルートになります.
+	//! @return     生成したノードを返却します. 以降の操作ではこの番号を使用します.
+	//-------------------------------------------------------------------------
+	uint32_t Create(uint32_t parent = NullNode);
+
+	//-------------------------------------------------------------------------
+	//! @brief      ノードと全ての子孫を破棄します.
+	//-------------------------------------------------------------------------
+	void Destroy(uint32_t node);
+
+	//-------------------------------------------------------------------------
+	//! @brief      親ノードを変更します.
+	//!
+	//! @retval true    変更しました.
+	//! @retval false   自分自身か子孫を親に指定したため変更しませんでした.
+	//-------------------------------------------------------------------------
+	bool SetParent(uint32_t node, uint32_t parent);
+
+	//-------------------------------------------------------------------------
+	//! @brief      親ノードを取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetParent(uint32_t node) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      親空間での位置を設定します.
+	//-------------------------------------------------------------------------
+	void SetPosition(uint32_t node, const DirectX::XMFLOAT3& position);
+
+	//-------------------------------------------------------------------------
+	//! @brief      親空間での回転(クォータニオン)を設定します.
+	//-------------------------------------------------------------------------
+	void SetRotation(uint32_t node, const DirectX::XMFLOAT4& rotation);
+
+	//-------------------------------------------------------------------------
+	//! @brief      親空間での拡大率を設定します.
+	//-------------------------------------------------------------------------
+	void SetScale(uint32_t node, const DirectX::XMFLOAT3& scale);
+
+	//-------------------------------------------------------------------------
+	//! @brief      親空間での位置・回転・拡大率をまとめて設定します.
+	//-------------------------------------------------------------------------
+	void SetLocal(
+		uint32_t                    node,
+		const DirectX::XMFLOAT3&    position,
+		const DirectX::XMFLOAT4&    rotation,
+		const DirectX::XMFLOAT3&    scale);
+
+	//-------------------------------------------------------------------------
+	//! @brief      親空間での位置を取得します.
+	//-------------------------------------------------------------------------
+	const DirectX::XMFLOAT3& GetPosition(uint32_t node) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      親空間での回転を取得します.
+	//-------------------------------------------------------------------------
+	const DirectX::XMFLOAT4& GetRotation(uint32_t node) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      親空間での拡大率を取得します.
+	//-------------------------------------------------------------------------
+	const DirectX::XMFLOAT3& GetScale(uint32_t node) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      ワールド行列を取得します.
+	//!
+	//! @note       Update() 以降の変更は反映されていません.
+	//-------------------------------------------------------------------------
+	const DirectX::XMFLOAT4X4& GetWorld(uint32_t node) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      変更されたノードとその子孫のワールド行列を再計算します.
+	//!
+	//! @return     再計算したノード数を返却します.
+	//! @note       配列は親が子より前に並ぶ深さ優先順に保たれ, 部分木は連続した範囲になります.
+	//!             変更されたノードの部分木だけを先頭から順に計算します.
+	//-------------------------------------------------------------------------
+	uint32_t Update();
+
+	//-------------------------------------------------------------------------
+	//! @brief      全てのワールド行列を1ノードずつ親をたどって計算します.
+	//!
+	//! @param[out]     worlds      ノード番号順のワールド行列の格納先です.
+	//! @note       Update() の検証用の参照実装です.
+	//-------------------------------------------------------------------------
+	void ComputeReference(std::vector<DirectX::XMFLOAT4X4>& worlds) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      有効なノード数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetCount() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      ノード番号の上限を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t GetCapacity() const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      ノードが有効かどうかを判定します.
+	//-------------------------------------------------------------------------
+	bool IsValid(uint32_t node) const;
+
+private:
+	//=========================================================================
+	// private variables.
+	//=========================================================================
+
+	// ノード番号ごとのデータ.
+	std::vector<uint32_t>               m_SlotOf;           //!< ノード番号から配列位置への対応です.
+	std::vector<uint32_t>               m_FreeNodes;        //!< 再利用できるノード番号です.
+
+	// 配列位置ごとのデータ(SoA).
+	std::vector<uint32_t>               m_NodeOf;           //!< 配列位置からノード番号への対応です.
+	std::vector<uint32_t>               m_ParentNode;       //!< 親のノード番号です.
+	std::vector<uint32_t>               m_ParentSlot;       //!< 親の配列位置です.
+	std::vector<uint32_t>               m_SubtreeEnd;       //!< 部分木の終端(含まない)です.
+	std::vector<DirectX::XMFLOAT3>      m_Positions;        //!< 位置です.
+	std::vector<DirectX::XMFLOAT4>      m_Rotations;        //!< 回転です.
+	std::vector<DirectX::XMFLOAT3>      m_Scales;           //!< 拡大率です.
+	std::vector<DirectX::XMFLOAT4X4>    m_Worlds;           //!< ワールド行列です.
+	std::vector<uint8_t>                m_Dirty;            //!< 変更フラグです.
+
+	std::vector<uint32_t>               m_DirtyNodes;       //!< 変更されたノード番号です.
+	std::vector<uint32_t>               m_DirtySlots;       //!< 更新用の作業領域です.
+	std::vector<uint32_t>               m_Order;            //!< 並べ替え用の作業領域です.
+	std::vector<uint32_t>               m_ChildStart;       //!< 並べ替え用の作業領域です.
+	std::vector<uint32_t>               m_Children;         //!< 並べ替え用の作業領域です.
+	std::vector<uint32_t>               m_Stack;            //!< 並べ替え用の作業領域です.
+	uint32_t                            m_Count;            //!< 有効なノード数です.
+	bool                                m_LayoutDirty;      //!< 並べ直しが必要かどうか.
+
+	//=========================================================================
+	// private methods.
+	//=========================================================================
+	void MarkDirty(uint32_t slot);
+	void RebuildLayout();
+	template<typename T>
+	void Permute(std::vector<T>& values);
+
+	TransformHierarchy  (const TransformHierarchy&) = delete;
+	void operator =     (const TransformHierarchy&) = delete;
+};
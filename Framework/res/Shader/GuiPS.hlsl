@@ -9,9 +9,9 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 struct VSOutput
 {
-    float4 Position : SV_POSITION;      //!< ʒuW
-    float4 Color    : COLOR;            //!< J[
-    float2 TexCoord : TEXCOORD;         //!< eNX`W.
+    float4 Position : SV_POSITION;      //!< 位置座標
+    float4 Color    : COLOR;            //!< カラー
+    float2 TexCoord : TEXCOORD;         //!< テクスチャ座標.
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -19,18 +19,18 @@ struct VSOutput
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 struct PSOutput
 {
-    float4 Target0  : SV_TARGET0;       //!< _[^[Qbg0.
+    float4 Target0  : SV_TARGET0;       //!< レンダーターゲット0.
 };
 
 //=================================================================================================
 // Samplers and Textures.
 //=================================================================================================
-SamplerState    ColorSmp : register(s0);      //!< J[Tv[.
-Texture2D       ColorMap : register(t0);      //!< J[eNX`.
+SamplerState    ColorSmp : register(s0);      //!< カラーサンプラー.
+Texture2D       ColorMap : register(t0);      //!< カラーテクスチャ.
 
 
 //-------------------------------------------------------------------------------------------------
-//      sNZVF[_CGg[|Cgł.
+//      ピクセルシェーダメインエントリーポイントです.
 //-------------------------------------------------------------------------------------------------
 PSOutput main(VSOutput input)
 {
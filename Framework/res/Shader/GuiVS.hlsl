@@ -9,9 +9,9 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 struct VSInput
 {
-    float2 Position : POSITION;     //!< ʒuW.
-    float2 TexCoord : TEXCOORD;     //!< eNX`W.
-    float4 Color    : COLOR;        //!< J[.    
+    float2 Position : POSITION;     //!< 位置座標.
+    float2 TexCoord : TEXCOORD;     //!< テクスチャ座標.
+    float4 Color    : COLOR;        //!< カラー.    
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -19,9 +19,9 @@ struct VSInput
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 struct VSOutput
 {
-    float4 Position : SV_POSITION;  //!< ʒuW.
-    float4 Color    : COLOR;        //!< J[.
-    float2 TexCoord : TEXCOORD;     //!< eNX`W.
+    float4 Position : SV_POSITION;  //!< 位置座標.
+    float4 Color    : COLOR;        //!< カラー.
+    float2 TexCoord : TEXCOORD;     //!< テクスチャ座標.
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -29,11 +29,11 @@ struct VSOutput
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 cbuffer Transform : register(b0)
 {
-    float4x4 Proj;      //!< ˉes.
+    float4x4 Proj;      //!< 射影行列.
 };
 
 //-------------------------------------------------------------------------------------------------
-//      _VF[_CGg[|Cg.
+//      頂点シェーダメインエントリーポイント.
 //-------------------------------------------------------------------------------------------------
 VSOutput main(VSInput input)
 {
@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <ResourceManager.h>
 #include <iostream>
+#include <timeapi.h>
 
 namespace /* anonymous */ {
 	//-----------------------------------------------------------------------------
@@ -48,6 +49,10 @@ App::App(uint32_t width, uint32_t height, DXGI_FORMAT format)
 	, m_Height(height)
 	, m_FrameIndex(0)
 	, m_BackBufferFormat(format)
+	, m_SyncInterval(1)
+	, m_FrameLatencyWaitable(nullptr)
+	, m_MaxFrameLatency(FrameCount)
+	, m_FrameStartMicroSec(0.0)
 { /* DO_NOTHING */
 }
 
@@ -92,6 +97,19 @@ bool App::InitApp()
 		return false;
 	}
 
+	// フレームペーシングの初期化. 休止の精度を上げるためタイマー分解能を 1ms にします.
+	{
+		timeBeginPeriod(1);
+
+		if (!m_FrameLimiter.Init(&m_Clock)
+		 || !m_FrameStats.Init(FrameStatsCount)
+		 || !m_PresentStats.Init(FrameStatsCount)
+		 || !m_FrameWaitStats.Init(FrameStatsCount))
+		{
+			return false;
+		}
+	}
+
 	// Direct3D 12の初期化.
 	if (!InitD3D())
 	{
@@ -129,6 +147,9 @@ bool App::InitApp()
 //-----------------------------------------------------------------------------
 void App::TermApp()
 {
+	// 実行中のフレームが参照しているリソースを破棄する前にGPU処理の完了を待機.
+	m_Fence.Sync(m_pQueue.Get());
+
 	// アプリケーション固有の終了処理.
 	OnTerm();
 
@@ -138,6 +159,13 @@ void App::TermApp()
 	// Imguiの処理
 	TermIMGUI();
 
+	// フレームペーシングの終了処理.
+	m_FrameLimiter.Term();
+	m_FrameStats.Term();
+	m_PresentStats.Term();
+	m_FrameWaitStats.Term();
+	timeEndPeriod(1);
+
 	// ウィンドウの終了処理.
 	TermWnd();
 
@@ -306,7 +334,7 @@ bool App::InitD3D()
 		desc.OutputWindow                       = m_hWnd;
 		desc.Windowed                           = TRUE;
 		desc.SwapEffect                         = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-		desc.Flags                              = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
+		desc.Flags                              = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH | DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
 
 		// スワップチェインの生成.
 		ComPtr<IDXGISwapChain> pSwapChain;
@@ -326,6 +354,20 @@ bool App::InitD3D()
 		// バックバッファ番号を取得.
 		m_FrameIndex = m_pSwapChain->GetCurrentBackBufferIndex();
 
+		// フレームレイテンシーの設定.
+		hr = m_pSwapChain->SetMaximumFrameLatency(m_MaxFrameLatency);
+		if (FAILED(hr))
+		{
+			return false;
+		}
+
+		// 待機可能オブジェクトを取得.
+		m_FrameLatencyWaitable = m_pSwapChain->GetFrameLatencyWaitableObject();
+		if (m_FrameLatencyWaitable == nullptr)
+		{
+			return false;
+		}
+
 		// 不要になったので解放.
 		pSwapChain.Reset();
 	}
@@ -422,6 +464,12 @@ bool App::InitD3D()
 		return false;
 	}
 
+	// フレームペーサーの初期化.
+	if (!m_FramePacer.Init(FrameCount))
+	{
+		return false;
+	}
+
 	// ビューポートの設定.
 	{
 		m_Viewport.TopLeftX = 0.0f;
@@ -519,6 +567,7 @@ void App::TermD3D()
 
 	// フェンス破棄.
 	m_Fence.Term();
+	m_FramePacer.Term();
 
 	// レンダーターゲットビューの破棄.
 	for (auto i = 0u; i < FrameCount; ++i)
@@ -541,6 +590,13 @@ void App::TermD3D()
 		}
 	}
 
+	// 待機可能オブジェクトを閉じる.
+	if (m_FrameLatencyWaitable != nullptr)
+	{
+		CloseHandle(m_FrameLatencyWaitable);
+		m_FrameLatencyWaitable = nullptr;
+	}
+
 	// スワップチェインの破棄.
 	m_pSwapChain.Reset();
 
@@ -571,24 +627,98 @@ void App::MainLoop()
 		}
 		else
 		{
-			OnRender();
+			// 次のフレームを開始できるまで待機.
+			WaitFrame();
+
+			// 待機中に届いた入力を記録の直前に反映する.
+			while (WM_QUIT != msg.message && PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE) == TRUE)
+			{
+				TranslateMessage(&msg);
+				DispatchMessage(&msg);
+			}
+
+			if (WM_QUIT != msg.message)
+			{
+				OnRender();
+			}
 		}
 	}
 }
 
+//-----------------------------------------------------------------------------
+//      次のフレームを開始できるまで待機します.
+//-----------------------------------------------------------------------------
+void App::WaitFrame()
+{
+	auto start = m_Clock.GetMicroSec();
+
+	// スワップチェインが次のフレームを受け付けるまで待機.
+	if (m_FrameLatencyWaitable != nullptr)
+	{
+		WaitForSingleObjectEx(m_FrameLatencyWaitable, 1000, TRUE);
+	}
+
+	// フレームレート制限.
+	m_FrameLimiter.Wait();
+
+	auto now = m_Clock.GetMicroSec();
+	m_FrameWaitStats.Push((now - start) * 0.001);
+	if (m_FrameStartMicroSec > 0.0)
+	{
+		m_FrameStats.Push((now - m_FrameStartMicroSec) * 0.001);
+	}
+	m_FrameStartMicroSec = now;
+}
+
 //-----------------------------------------------------------------------------
 //      画面に表示し，次のフレームの準備を行います.
 //-----------------------------------------------------------------------------
 void App::Present(uint32_t interval)
 {
+	auto start = m_Clock.GetMicroSec();
+
 	// 画面に表示.
 	m_pSwapChain->Present(interval, 0);
 
-	// 完了待ち.
-	m_Fence.Wait(m_pQueue.Get(), INFINITE);
+	// 提出したフレームのフェンス値を記録. ここでは完了を待たない.
+	m_FramePacer.EndFrame(m_FrameIndex, m_Fence.Signal(m_pQueue.Get()));
 
 	// フレーム番号を更新.
 	m_FrameIndex = m_pSwapChain->GetCurrentBackBufferIndex();
+
+	// 再利用するフレームの完了だけを待つ. CPUは最大 FrameCount フレーム先行します.
+	m_Fence.WaitValue(m_FramePacer.GetWaitValue(m_FrameIndex), INFINITE);
+
+	m_PresentStats.Push((m_Clock.GetMicroSec() - start) * 0.001);
+}
+
+//-----------------------------------------------------------------------------
+//      最大フレームレイテンシーを設定します.
+//-----------------------------------------------------------------------------
+void App::SetMaxFrameLatency(uint32_t latency)
+{
+	// DXGI で設定できる範囲に収めます.
+	latency = std::max(1u, std::min(latency, uint32_t(DXGI_MAX_SWAP_CHAIN_BUFFERS)));
+	if (latency == m_MaxFrameLatency || m_pSwapChain == nullptr)
+	{
+		return;
+	}
+
+	auto hr = m_pSwapChain->SetMaximumFrameLatency(latency);
+	if (FAILED(hr))
+	{
+		return;
+	}
+
+	m_MaxFrameLatency = latency;
+}
+
+//-----------------------------------------------------------------------------
+//      最大フレームレイテンシーを取得します.
+//-----------------------------------------------------------------------------
+uint32_t App::GetMaxFrameLatency() const
+{
+	return m_MaxFrameLatency;
 }
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,146 @@
+﻿//-----------------------------------------------------------------------------
+// File : CascadedShadow.cpp
+// Desc : Cascaded Shadow Map Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <CascadedShadow.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const float RadiusStep = 16.0f;    // 半径を 1/16 単位で切り上げ, 浮動小数点誤差で揺れないようにします.
+
+} // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+// CascadedShadow class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      実用分割法で視錐台の分割位置を求めます.
+//-----------------------------------------------------------------------------
+void CascadedShadow::ComputeSplits(uint32_t count, float nearClip, float farClip, float lambda, float* pSplits)
+{
+	if (count == 0 || pSplits == nullptr)
+	{ return; }
+
+	lambda = std::min(std::max(lambda, 0.0f), 1.0f);
+
+	pSplits[0] = nearClip;
+	for (auto i = 1u; i < count; ++i)
+	{
+		// 対数分割は透視による解像度の偏りを打ち消し, 線形分割は手前に寄りすぎないようにします.
+		auto t       = float(i) / float(count);
+		auto logDist = nearClip * std::pow(farClip / nearClip, t);
+		auto uniDist = nearClip + (farClip - nearClip) * t;
+		pSplits[i]   = lambda * logDist + (1.0f - lambda) * uniDist;
+	}
+	pSplits[count] = farClip;
+}
+
+//-----------------------------------------------------------------------------
+//      カメラの視錐台の分割範囲ごとにライトのビュー射影行列を求めます.
+//-----------------------------------------------------------------------------
+bool CascadedShadow::Compute
+(
+	const XMFLOAT4X4&   view,
+	const XMFLOAT4X4&   proj,
+	const XMFLOAT3&     lightDir,
+	const Desc&         desc,
+	Cascade*            pCascades
+)
+{
+	if (pCascades == nullptr
+	 || desc.CascadeCount == 0 || desc.CascadeCount > MaxCascadeCount
+	 || desc.TileSize == 0
+	 || desc.NearClip <= 0.0f || desc.FarClip <= desc.NearClip
+	 || proj._11 == 0.0f || proj._22 == 0.0f || proj._34 == 0.0f)
+	{ return false; }
+
+	auto L = XMLoadFloat3(&lightDir);
+	if (XMVectorGetX(XMVector3LengthSq(L)) <= 0.0f)
+	{ return false; }
+	L = XMVector3Normalize(L);
+
+	// ライトの向きだけで決まる上方向を使い, カメラが動いてもライト空間の軸を変えないようにします.
+	auto up = (std::abs(XMVectorGetY(L)) > 0.99f) ? XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f) : XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+
+	// 視錐台の広がり(奥行き1あたり)です. 右手系では _34 = -1 なので前方はビュー空間の -Z です.
+	auto tanX    = 1.0f / proj._11;
+	auto tanY    = 1.0f / proj._22;
+	auto k2      = tanX * tanX + tanY * tanY;
+	auto forward = (proj._34 > 0.0f) ? 1.0f : -1.0f;
+
+	XMVECTOR det;
+	auto invView = XMMatrixInverse(&det, XMLoadFloat4x4(&view));
+
+	float splits[MaxCascadeCount + 1];
+	ComputeSplits(desc.CascadeCount, desc.NearClip, desc.FarClip, desc.Lambda, splits);
+
+	auto halfTile = float(desc.TileSize) * 0.5f;
+
+	for (auto i = 0u; i < desc.CascadeCount; ++i)
+	{
+		auto& cascade = pCascades[i];
+		auto  n = splits[i];
+		auto  f = splits[i + 1];
+
+		// 分割範囲の8頂点を通る, 視線上に中心を持つ球です.
+		// 手前と奥の頂点までの距離が等しくなる位置が範囲を超える場合は奥の面の中心に置きます.
+		auto c = std::min((n + f) * 0.5f * (1.0f + k2), f);
+		auto r = std::sqrt((f - c) * (f - c) + k2 * f * f);
+
+		// 半径はカメラの向きに依存しないので, 丸めておけば投影範囲は一定です.
+		r = std::ceil(r * RadiusStep) / RadiusStep;
+
+		auto center = XMVector3TransformCoord(XMVectorSet(0.0f, 0.0f, c * forward, 1.0f), invView);
+
+		// 球の手前にある遮蔽物も含めるよう, ライト側へ伸ばした位置から見ます.
+		auto back   = r + std::max(desc.CasterDistance, 0.0f);
+		auto eye    = XMVectorAdd(center, XMVectorScale(L, back));
+		auto lightV = XMMatrixLookAtLH(eye, center, up);
+		auto lightP = XMMatrixOrthographicOffCenterLH(-r, r, -r, r, 0.0f, back + r);
+
+		// ワールド原点がテクセルの境界に乗るように射影行列を平行移動します.
+		auto origin  = XMVector3TransformCoord(XMVectorZero(), XMMatrixMultiply(lightV, lightP));
+		origin       = XMVectorScale(origin, halfTile);
+		auto offset  = XMVectorSubtract(XMVectorRound(origin), origin);
+		offset       = XMVectorScale(offset, 1.0f / halfTile);
+		lightP.r[3]  = XMVectorAdd(lightP.r[3], XMVectorSet(XMVectorGetX(offset), XMVectorGetY(offset), 0.0f, 0.0f));
+
+		XMStoreFloat4x4(&cascade.View,     lightV);
+		XMStoreFloat4x4(&cascade.Proj,     lightP);
+		XMStoreFloat4x4(&cascade.ViewProj, XMMatrixMultiply(lightV, lightP));
+		XMStoreFloat3  (&cascade.Center,   center);
+
+		cascade.Radius    = r;
+		cascade.SplitNear = n;
+		cascade.SplitFar  = f;
+		cascade.TexelSize = 2.0f * r / float(desc.TileSize);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      アトラス上のタイル位置を取得します.
+//-----------------------------------------------------------------------------
+void CascadedShadow::GetTile(uint32_t index, uint32_t& x, uint32_t& y)
+{
+	x = index % AtlasTileCount;
+	y = index / AtlasTileCount;
+}
@@ -99,6 +99,36 @@ bool ColorTarget::Init
 	float           clearColor[4],
 	D3D12_RESOURCE_STATES InitialResourceState
 )
+{
+	return InitPlaced(
+		pDevice,
+		pPoolRTV,
+		pPoolSRV,
+		width,
+		height,
+		format,
+		clearColor,
+		nullptr,
+		0,
+		InitialResourceState);
+}
+
+//-----------------------------------------------------------------------------
+//      ヒープ内に配置して初期化処理を行います.
+//-----------------------------------------------------------------------------
+bool ColorTarget::InitPlaced
+(
+	ID3D12Device* pDevice,
+	DescriptorPool* pPoolRTV,
+	DescriptorPool* pPoolSRV,
+	uint32_t        width,
+	uint32_t        height,
+	DXGI_FORMAT     format,
+	float           clearColor[4],
+	ID3D12Heap*     pHeap,
+	UINT64          heapOffset,
+	D3D12_RESOURCE_STATES InitialResourceState
+)
 {
 	if (pDevice == nullptr || pPoolRTV == nullptr || width == 0 || height == 0)
 	{
@@ -161,13 +191,27 @@ bool ColorTarget::Init
 	clearValue.Color[2] = clearColor[2];
 	clearValue.Color[3] = clearColor[3];
 
-	auto hr = pDevice->CreateCommittedResource(
-		&prop,
-		D3D12_HEAP_FLAG_NONE,
-		&desc,
-		InitialResourceState,
-		&clearValue,
-		IID_PPV_ARGS(m_pTarget.GetAddressOf()));
+	HRESULT hr = S_OK;
+	if (pHeap != nullptr)
+	{
+		hr = pDevice->CreatePlacedResource(
+			pHeap,
+			heapOffset,
+			&desc,
+			InitialResourceState,
+			&clearValue,
+			IID_PPV_ARGS(m_pTarget.GetAddressOf()));
+	}
+	else
+	{
+		hr = pDevice->CreateCommittedResource(
+			&prop,
+			D3D12_HEAP_FLAG_NONE,
+			&desc,
+			InitialResourceState,
+			&clearValue,
+			IID_PPV_ARGS(m_pTarget.GetAddressOf()));
+	}
 	if (FAILED(hr))
 	{
 		return false;
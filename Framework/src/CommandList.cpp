@@ -93,18 +93,39 @@ void CommandList::Term()
 //-----------------------------------------------------------------------------
 ID3D12GraphicsCommandList* CommandList::Reset()
 {
-	auto hr = m_pAllocators[m_Index]->Reset();
+	auto pCmdList = Reset(m_Index);
+	if (pCmdList == nullptr)
+	{
+		return nullptr;
+	}
+
+	m_Index = (m_Index + 1) % uint32_t(m_pAllocators.size());
+	return pCmdList;
+}
+
+//-----------------------------------------------------------------------------
+//      指定したアロケータでリセット処理を行います.
+//-----------------------------------------------------------------------------
+ID3D12GraphicsCommandList* CommandList::Reset(uint32_t index)
+{
+	if (m_pAllocators.empty())
+	{
+		return nullptr;
+	}
+
+	index %= uint32_t(m_pAllocators.size());
+
+	auto hr = m_pAllocators[index]->Reset();
 	if (FAILED(hr))
 	{
 		return nullptr;
 	}
 
-	hr = m_pCmdList->Reset(m_pAllocators[m_Index].Get(), nullptr);
+	hr = m_pCmdList->Reset(m_pAllocators[index].Get(), nullptr);
 	if (FAILED(hr))
 	{
 		return nullptr;
 	}
 
-	m_Index = (m_Index + 1) % uint32_t(m_pAllocators.size());
 	return m_pCmdList.Get();
 }
\ No newline at end of file
@@ -0,0 +1,191 @@
+﻿//-----------------------------------------------------------------------------
+// File : CommandListPool.cpp
+// Desc : Per Thread Command List Pool Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <CommandListPool.h>
+#include <Logger.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// CommandListPool class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+CommandListPool::CommandListPool()
+: m_pDevice     (nullptr)
+, m_Type        (D3D12_COMMAND_LIST_TYPE_DIRECT)
+, m_FrameCount  (0)
+, m_WorkerCount (0)
+, m_FrameIndex  (0)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+CommandListPool::~CommandListPool()
+{
+	Term();
+}
+
+//-----------------------------------------------------------------------------
+//      初期化処理を行います.
+//-----------------------------------------------------------------------------
+bool CommandListPool::Init(ID3D12Device* pDevice, D3D12_COMMAND_LIST_TYPE type, uint32_t frameCount, uint32_t workerCount)
+{
+	if (pDevice == nullptr || frameCount == 0 || workerCount == 0)
+	{
+		return false;
+	}
+
+	Term();
+
+	m_pDevice     = pDevice;
+	m_Type        = type;
+	m_FrameCount  = frameCount;
+	m_WorkerCount = workerCount;
+	m_FrameIndex  = 0;
+
+	m_Slots.resize(size_t(frameCount) * workerCount);
+	for (auto& slot : m_Slots)
+	{
+		auto hr = pDevice->CreateCommandAllocator(type, IID_PPV_ARGS(slot.pAllocator.GetAddressOf()));
+		if (FAILED(hr))
+		{
+			ELOG("Error : ID3D12Device::CreateCommandAllocator() Failed. retcode = 0x%x", hr);
+			return false;
+		}
+
+		slot.Used = 0;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      終了処理を行います.
+//-----------------------------------------------------------------------------
+void CommandListPool::Term()
+{
+	m_Slots.clear();
+	m_Slots.shrink_to_fit();
+	m_pDevice.Reset();
+
+	m_FrameCount  = 0;
+	m_WorkerCount = 0;
+	m_FrameIndex  = 0;
+}
+
+//-----------------------------------------------------------------------------
+//      フレームを開始します.
+//-----------------------------------------------------------------------------
+void CommandListPool::BeginFrame(uint32_t frameIndex)
+{
+	if (m_FrameCount == 0)
+	{
+		return;
+	}
+
+	m_FrameIndex = frameIndex % m_FrameCount;
+
+	for (auto i = 0u; i < m_WorkerCount; ++i)
+	{
+		auto& slot = m_Slots[size_t(m_FrameIndex) * m_WorkerCount + i];
+		if (slot.Used == 0)
+		{
+			continue;
+		}
+
+		// 前回このフレーム番号で記録したコマンドはGPUで実行済みです.
+		slot.pAllocator->Reset();
+		slot.Used = 0;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      リセット処理を行ったコマンドリストを取得します.
+//-----------------------------------------------------------------------------
+ID3D12GraphicsCommandList* CommandListPool::Acquire(uint32_t worker)
+{
+	if (worker >= m_WorkerCount)
+	{
+		return nullptr;
+	}
+
+	auto& slot = m_Slots[size_t(m_FrameIndex) * m_WorkerCount + worker];
+
+	// 1つのアロケータを複数のコマンドリストで共有しますが,
+	// 同じスレッドが1つずつ記録するので同時に記録されることはありません.
+	if (slot.Used < slot.pLists.size())
+	{
+		auto pCmd = slot.pLists[slot.Used].Get();
+		auto hr = pCmd->Reset(slot.pAllocator.Get(), nullptr);
+		if (FAILED(hr))
+		{
+			ELOG("Error : ID3D12GraphicsCommandList::Reset() Failed. retcode = 0x%x", hr);
+			return nullptr;
+		}
+
+		slot.Used++;
+		return pCmd;
+	}
+
+	// 足りなければ追加します. 生成直後は記録可能な状態です.
+	ComPtr<ID3D12GraphicsCommandList> pCmd;
+	auto hr = m_pDevice->CreateCommandList(
+		0,
+		m_Type,
+		slot.pAllocator.Get(),
+		nullptr,
+		IID_PPV_ARGS(pCmd.GetAddressOf()));
+	if (FAILED(hr))
+	{
+		ELOG("Error : ID3D12Device::CreateCommandList() Failed. retcode = 0x%x", hr);
+		return nullptr;
+	}
+
+	slot.pLists.push_back(pCmd);
+	slot.Used++;
+	return pCmd.Get();
+}
+
+//-----------------------------------------------------------------------------
+//      記録するスレッド数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t CommandListPool::GetWorkerCount() const
+{
+	return m_WorkerCount;
+}
+
+//-----------------------------------------------------------------------------
+//      現在のフレームで取得したコマンドリスト数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t CommandListPool::GetUsedCount() const
+{
+	uint32_t count = 0;
+	for (auto i = 0u; i < m_WorkerCount; ++i)
+	{
+		count += m_Slots[size_t(m_FrameIndex) * m_WorkerCount + i].Used;
+	}
+
+	return count;
+}
+
+//-----------------------------------------------------------------------------
+//      生成済みのコマンドリスト数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t CommandListPool::GetListCount() const
+{
+	uint32_t count = 0;
+	for (const auto& slot : m_Slots)
+	{
+		count += uint32_t(slot.pLists.size());
+	}
+
+	return count;
+}
@@ -88,23 +88,23 @@ bool CommonBufferManager::CreateVertexBuffer(ComPtr<ID3D12Device> pDevice) {
 bool CommonBufferManager::CreateMatrixConstantBuffer(ComPtr<ID3D12Device> pDevice, DescriptorPool* pool, float width, float height) {
 	for (auto i = 0u; i < App::FrameCount; ++i)
 	{
-		// 萔obt@.
+		// 定数バッファ初期化.
 		if (!m_TransformCB[i].Init(pDevice.Get(), pool, sizeof(CommonCb::CbTransform)))
 		{
 			ELOG("Error : ConstantBuffer::Init() Failed.");
 			return false;
 		}
 
-		// Jݒ.
+		// カメラ設定.
 		auto eyePos = Vector3(0.0f, 0.0f, 1.0f);
 		auto targetPos = Vector3::Zero;
 		auto upward = Vector3::UnitY;
 
-		// pƃAXyNg̐ݒ.
+		// 垂直画角とアスペクト比の設定.
 		auto fovY = DirectX::XMConvertToRadians(37.5f);
 		auto aspect = static_cast<float>(width) / static_cast<float>(height);
 
-		// ϊsݒ.
+		// 変換行列を設定.
 		auto ptr = m_TransformCB[i].GetPtr<CommonCb::CbTransform>();
 		ptr->View = Matrix::CreateLookAt(eyePos, targetPos, upward);
 		ptr->Proj = Matrix::CreatePerspectiveFieldOfView(fovY, aspect, 0.1f, 1000.0f);
@@ -123,33 +123,28 @@ void CommonBufferManager::UpdateCommonBuffer(int frameindex, CommonCb::CbCommon&
 	memcpy(ptr, &cb, sizeof(CommonCb::CbCommon));
 }
 
-void CommonBufferManager::UpdateShadowBuffer(int frameindex, Vector3 direction, float lightPosDistance, Vector4& OrthographParam) {
+void CommonBufferManager::UpdateShadowBuffer(int frameindex, const CascadedShadow::Cascade* pCascades, uint32_t cascadeCount, const Vector3& cameraForward) {
 	auto ptr = m_LightCB[frameindex].GetPtr<CommonCb::CbLight>();
-	
-	// LVP̍XV
-	if (direction.Length() == 0) {
+
+	// カスケードが無い場合は影を落とさない.
+	if (pCascades == nullptr || cascadeCount == 0) {
+		ptr->CascadeCount = 0.0f;
 		return;
 	}
+	if (cascadeCount > CascadedShadow::MaxCascadeCount) cascadeCount = CascadedShadow::MaxCascadeCount;
+
+	// 使わないカスケードには最後のカスケードを入れておく.
+	float splits[CascadedShadow::MaxCascadeCount];
+	for (auto i = 0u; i < CascadedShadow::MaxCascadeCount; ++i) {
+		const auto& cascade = pCascades[(i < cascadeCount) ? i : cascadeCount - 1];
+		ptr->CascadeVP[i] = cascade.ViewProj;
+		splits[i]         = cascade.SplitFar;
+	}
 
-	if (lightPosDistance == 0.0f) lightPosDistance = 0.0001f;
-	XMFLOAT3 lightPos = direction * (lightPosDistance);
-
-	XMFLOAT3 lightDest = { 0.0f, 0.0f, 0.0f };
-	
-	XMMATRIX view = XMMatrixLookAtLH(
-		{ lightPos.x, lightPos.y, lightPos.z },
-		{ lightDest.x, lightDest.y, lightDest.z },
-		{ 0.0f, 1.0f, 0.0f }
-	);
-
-	XMMATRIX projection = XMMatrixOrthographicLH(OrthographParam.x, OrthographParam.y, OrthographParam.z, OrthographParam.w);
-	// XMMATRIX projection = XMMatrixPerspectiveFovLH(XMConvertToRadians(45.0f), 1.0f, 1.0f, 100.0f);
-
-
-	XMFLOAT4X4 mat;
-	XMStoreFloat4x4(&mat, view * XMMatrixTranspose(projection) );
-
-	ptr->LightVP = mat;
+	ptr->LightVP       = pCascades[0].ViewProj;
+	ptr->CascadeSplits = Vector4(splits);
+	ptr->CameraForward = cameraForward;
+	ptr->CascadeCount  = float(cascadeCount);
 }
 
 
@@ -49,6 +49,38 @@ bool DepthTarget::Init
 	uint8_t         clearStencil,
 	D3D12_RESOURCE_STATES initialResourceState
 )
+{
+	return InitPlaced(
+		pDevice,
+		pPoolRTV,
+		pPoolSRV,
+		width,
+		height,
+		format,
+		clearDepth,
+		clearStencil,
+		nullptr,
+		0,
+		initialResourceState);
+}
+
+//-----------------------------------------------------------------------------
+//      ヒープ内に配置して初期化処理を行います.
+//-----------------------------------------------------------------------------
+bool DepthTarget::InitPlaced
+(
+	ID3D12Device* pDevice,
+	DescriptorPool* pPoolRTV,
+	DescriptorPool* pPoolSRV,
+	uint32_t        width,
+	uint32_t        height,
+	DXGI_FORMAT     format,
+	float           clearDepth,
+	uint8_t         clearStencil,
+	ID3D12Heap*     pHeap,
+	UINT64          heapOffset,
+	D3D12_RESOURCE_STATES initialResourceState
+)
 {
 	if (pDevice == nullptr || pPoolRTV == nullptr || width == 0 || height == 0)
 	{
@@ -107,13 +139,27 @@ bool DepthTarget::Init
 	clearValue.DepthStencil.Depth   = m_ClearDepth;
 	clearValue.DepthStencil.Stencil = m_ClearStencil;
 
-	auto hr = pDevice->CreateCommittedResource(
-		&prop,
-		D3D12_HEAP_FLAG_NONE,
-		&desc,
-		initialResourceState,
-		&clearValue,
-		IID_PPV_ARGS(m_pTarget.GetAddressOf()));
+	HRESULT hr = S_OK;
+	if (pHeap != nullptr)
+	{
+		hr = pDevice->CreatePlacedResource(
+			pHeap,
+			heapOffset,
+			&desc,
+			initialResourceState,
+			&clearValue,
+			IID_PPV_ARGS(m_pTarget.GetAddressOf()));
+	}
+	else
+	{
+		hr = pDevice->CreateCommittedResource(
+			&prop,
+			D3D12_HEAP_FLAG_NONE,
+			&desc,
+			initialResourceState,
+			&clearValue,
+			IID_PPV_ARGS(m_pTarget.GetAddressOf()));
+	}
 	if (FAILED(hr))
 	{
 		HRESULT result = pDevice->GetDeviceRemovedReason();
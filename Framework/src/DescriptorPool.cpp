@@ -131,6 +131,15 @@ ID3D12DescriptorHeap* const DescriptorPool::GetHeap() const
 	return m_pHeap.Get();
 }
 
+//-----------------------------------------------------------------------------
+//      ヒープ先頭からのディスクリプタ番号を取得します.
+//-----------------------------------------------------------------------------
+uint32_t DescriptorPool::GetHandleIndex(D3D12_GPU_DESCRIPTOR_HANDLE handle) const
+{
+	auto start = m_pHeap->GetGPUDescriptorHandleForHeapStart();
+	return uint32_t((handle.ptr - start.ptr) / m_DescriptorSize);
+}
+
 //-----------------------------------------------------------------------------
 //      生成処理を行います.
 //-----------------------------------------------------------------------------
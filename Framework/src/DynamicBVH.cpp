@@ -0,0 +1,898 @@
+﻿//-----------------------------------------------------------------------------
+// File : DynamicBVH.cpp
+// Desc : Dynamic Bounding Volume Hierarchy Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <DynamicBVH.h>
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const uint32_t kBinCount = 16;      // SAH 構築時のビン数.
+
+//-----------------------------------------------------------------------------
+//      2つのAABBを結合します.
+//-----------------------------------------------------------------------------
+inline void Union
+(
+	const DirectX::XMFLOAT3& aMin, const DirectX::XMFLOAT3& aMax,
+	const DirectX::XMFLOAT3& bMin, const DirectX::XMFLOAT3& bMax,
+	DirectX::XMFLOAT3& outMin, DirectX::XMFLOAT3& outMax
+)
+{
+	outMin = DirectX::XMFLOAT3(std::min(aMin.x, bMin.x), std::min(aMin.y, bMin.y), std::min(aMin.z, bMin.z));
+	outMax = DirectX::XMFLOAT3(std::max(aMax.x, bMax.x), std::max(aMax.y, bMax.y), std::max(aMax.z, bMax.z));
+}
+
+//-----------------------------------------------------------------------------
+//      AABBの表面積を求めます.
+//-----------------------------------------------------------------------------
+inline float Area(const DirectX::XMFLOAT3& bmin, const DirectX::XMFLOAT3& bmax)
+{
+	auto dx = bmax.x - bmin.x;
+	auto dy = bmax.y - bmin.y;
+	auto dz = bmax.z - bmin.z;
+	return 2.0f * (dx * dy + dy * dz + dz * dx);
+}
+
+//-----------------------------------------------------------------------------
+//      2つのAABBを結合した表面積を求めます.
+//-----------------------------------------------------------------------------
+inline float UnionArea
+(
+	const DirectX::XMFLOAT3& aMin, const DirectX::XMFLOAT3& aMax,
+	const DirectX::XMFLOAT3& bMin, const DirectX::XMFLOAT3& bMax
+)
+{
+	DirectX::XMFLOAT3 umin, umax;
+	Union(aMin, aMax, bMin, bMax, umin, umax);
+	return Area(umin, umax);
+}
+
+//-----------------------------------------------------------------------------
+//      外側のAABBが内側のAABBを含むかどうか.
+//-----------------------------------------------------------------------------
+inline bool Contains
+(
+	const DirectX::XMFLOAT3& outerMin, const DirectX::XMFLOAT3& outerMax,
+	const DirectX::XMFLOAT3& innerMin, const DirectX::XMFLOAT3& innerMax
+)
+{
+	return outerMin.x <= innerMin.x && outerMin.y <= innerMin.y && outerMin.z <= innerMin.z
+		&& innerMax.x <= outerMax.x && innerMax.y <= outerMax.y && innerMax.z <= outerMax.z;
+}
+
+//-----------------------------------------------------------------------------
+//      ベクトルの成分を軸番号で取得します.
+//-----------------------------------------------------------------------------
+inline float Axis(const DirectX::XMFLOAT3& v, int axis)
+{
+	return (axis == 0) ? v.x : ((axis == 1) ? v.y : v.z);
+}
+
+//-----------------------------------------------------------------------------
+//      レイとAABBの交差判定を行います.
+//-----------------------------------------------------------------------------
+inline bool IntersectRay
+(
+	const DirectX::XMFLOAT3& origin,
+	const DirectX::XMFLOAT3& invDir,
+	float                    maxDistance,
+	const DirectX::XMFLOAT3& bmin,
+	const DirectX::XMFLOAT3& bmax,
+	float&                   distance
+)
+{
+	auto tx0 = (bmin.x - origin.x) * invDir.x;
+	auto tx1 = (bmax.x - origin.x) * invDir.x;
+	auto ty0 = (bmin.y - origin.y) * invDir.y;
+	auto ty1 = (bmax.y - origin.y) * invDir.y;
+	auto tz0 = (bmin.z - origin.z) * invDir.z;
+	auto tz1 = (bmax.z - origin.z) * invDir.z;
+
+	auto tmin = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)), std::max(std::min(tz0, tz1), 0.0f));
+	auto tmax = std::min(std::min(std::max(tx0, tx1), std::max(ty0, ty1)), std::min(std::max(tz0, tz1), maxDistance));
+
+	distance = tmin;
+	return tmin <= tmax;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// DynamicBVH class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+DynamicBVH::DynamicBVH()
+	: m_Root      (NullNode)
+	, m_FreeList  (NullNode)
+	, m_NodeCount (0)
+	, m_ProxyCount(0)
+	, m_Margin    (0.05f)
+{ /* DO_NOTHING */
+}
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+DynamicBVH::~DynamicBVH()
+{
+	Clear();
+}
+
+//-----------------------------------------------------------------------------
+//      全てのノードを破棄します.
+//-----------------------------------------------------------------------------
+void DynamicBVH::Clear()
+{
+	m_Nodes.clear();
+	m_BuildEntries.clear();
+	m_CostStack.clear();
+	m_Stack.clear();
+
+	m_Root       = NullNode;
+	m_FreeList   = NullNode;
+	m_NodeCount  = 0;
+	m_ProxyCount = 0;
+}
+
+//-----------------------------------------------------------------------------
+//      ノード領域を予約します.
+//-----------------------------------------------------------------------------
+void DynamicBVH::Reserve(size_t proxyCount)
+{
+	// 葉が N 個の二分木の内部ノードは N - 1 個.
+	m_Nodes.reserve(proxyCount * 2);
+}
+
+//-----------------------------------------------------------------------------
+//      葉の AABB を膨らませる量を設定します.
+//-----------------------------------------------------------------------------
+void DynamicBVH::SetMargin(float margin)
+{
+	m_Margin = std::max(margin, 0.0f);
+}
+
+//-----------------------------------------------------------------------------
+//      葉を追加します.
+//-----------------------------------------------------------------------------
+int32_t DynamicBVH::CreateProxy
+(
+	const DirectX::XMFLOAT3&    boundsMin,
+	const DirectX::XMFLOAT3&    boundsMax,
+	uint32_t                    userData,
+	bool                        insert
+)
+{
+	auto leaf = AllocNode();
+
+	auto& node = m_Nodes[leaf];
+	node.Min      = DirectX::XMFLOAT3(boundsMin.x - m_Margin, boundsMin.y - m_Margin, boundsMin.z - m_Margin);
+	node.Max      = DirectX::XMFLOAT3(boundsMax.x + m_Margin, boundsMax.y + m_Margin, boundsMax.z + m_Margin);
+	node.Height   = 0;
+	node.UserData = userData;
+
+	m_ProxyCount++;
+
+	if (insert)
+	{
+		InsertLeaf(leaf);
+	}
+
+	return leaf;
+}
+
+//-----------------------------------------------------------------------------
+//      葉を削除します.
+//-----------------------------------------------------------------------------
+void DynamicBVH::DestroyProxy(int32_t proxy)
+{
+	assert(0 <= proxy && proxy < int32_t(m_Nodes.size()));
+	assert(m_Nodes[proxy].Height == 0);
+
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+
+	m_ProxyCount--;
+}
+
+//-----------------------------------------------------------------------------
+//      葉の AABB を更新します.
+//-----------------------------------------------------------------------------
+bool DynamicBVH::MoveProxy
+(
+	int32_t                     proxy,
+	const DirectX::XMFLOAT3&    boundsMin,
+	const DirectX::XMFLOAT3&    boundsMax
+)
+{
+	assert(0 <= proxy && proxy < int32_t(m_Nodes.size()));
+	assert(m_Nodes[proxy].Height == 0);
+
+	auto& node = m_Nodes[proxy];
+
+	// 膨らませた AABB に収まっている間は何もしない.
+	if (Contains(node.Min, node.Max, boundsMin, boundsMax))
+	{
+		return false;
+	}
+
+	node.Min = DirectX::XMFLOAT3(boundsMin.x - m_Margin, boundsMin.y - m_Margin, boundsMin.z - m_Margin);
+	node.Max = DirectX::XMFLOAT3(boundsMax.x + m_Margin, boundsMax.y + m_Margin, boundsMax.z + m_Margin);
+
+	// 祖先の AABB を更新し, 途中で回転して木の質を保つ.
+	Refit(node.Parent);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      全ての葉から SAH で木を構築し直します.
+//-----------------------------------------------------------------------------
+void DynamicBVH::Rebuild()
+{
+	m_BuildEntries.clear();
+	m_BuildEntries.reserve(m_ProxyCount);
+
+	// 内部ノードは全て捨てて, 葉だけを集める.
+	for (auto i = 0; i < int32_t(m_Nodes.size()); ++i)
+	{
+		auto& node = m_Nodes[i];
+		if (node.Height == 0)
+		{
+			BuildEntry entry;
+			entry.Leaf     = i;
+			entry.Centroid = DirectX::XMFLOAT3(
+				(node.Min.x + node.Max.x) * 0.5f,
+				(node.Min.y + node.Max.y) * 0.5f,
+				(node.Min.z + node.Max.z) * 0.5f);
+			m_BuildEntries.push_back(entry);
+		}
+		else if (node.Height > 0)
+		{
+			FreeNode(i);
+		}
+	}
+
+	m_Root = NullNode;
+	if (m_BuildEntries.empty())
+	{
+		return;
+	}
+
+	m_Root = BuildRange(0, uint32_t(m_BuildEntries.size()));
+	m_Nodes[m_Root].Parent = NullNode;
+}
+
+//-----------------------------------------------------------------------------
+//      視錐台と交差する葉を列挙します.
+//-----------------------------------------------------------------------------
+uint32_t DynamicBVH::Query(const Frustum& frustum, std::vector<uint32_t>& userData) const
+{
+	userData.clear();
+
+	if (m_Root == NullNode)
+	{
+		return 0;
+	}
+
+	uint32_t visited = 0;
+
+	// 完全に内側と分かった部分木はビット反転した番号で積む.
+	m_Stack.clear();
+	m_Stack.push_back(m_Root);
+
+	while (!m_Stack.empty())
+	{
+		auto value = m_Stack.back();
+		m_Stack.pop_back();
+		visited++;
+
+		if (value < 0)
+		{
+			const auto& node = m_Nodes[~value];
+			if (node.Height == 0)
+			{
+				userData.push_back(node.UserData);
+			}
+			else
+			{
+				m_Stack.push_back(~node.Child[0]);
+				m_Stack.push_back(~node.Child[1]);
+			}
+			continue;
+		}
+
+		const auto& node = m_Nodes[value];
+
+		auto cx = (node.Min.x + node.Max.x) * 0.5f;
+		auto cy = (node.Min.y + node.Max.y) * 0.5f;
+		auto cz = (node.Min.z + node.Max.z) * 0.5f;
+		auto ex = (node.Max.x - node.Min.x) * 0.5f;
+		auto ey = (node.Max.y - node.Min.y) * 0.5f;
+		auto ez = (node.Max.z - node.Min.z) * 0.5f;
+
+		auto outside = false;
+		auto inside  = true;
+		for (auto p = 0; p < Frustum::PLANE_COUNT; ++p)
+		{
+			const auto& plane = frustum.Planes[p];
+			auto d = (plane.x * cx + plane.y * cy) + (plane.z * cz + plane.w);
+			auto r = (std::fabs(plane.x) * ex + std::fabs(plane.y) * ey) + std::fabs(plane.z) * ez;
+			if (d + r < 0.0f)
+			{
+				outside = true;
+				break;
+			}
+			if (d - r < 0.0f)
+			{
+				inside = false;
+			}
+		}
+
+		if (outside)
+		{
+			continue;
+		}
+
+		if (node.Height == 0)
+		{
+			userData.push_back(node.UserData);
+		}
+		else if (inside)
+		{
+			m_Stack.push_back(~node.Child[0]);
+			m_Stack.push_back(~node.Child[1]);
+		}
+		else
+		{
+			m_Stack.push_back(node.Child[0]);
+			m_Stack.push_back(node.Child[1]);
+		}
+	}
+
+	return visited;
+}
+
+//-----------------------------------------------------------------------------
+//      レイと最初に交差する葉を探します.
+//-----------------------------------------------------------------------------
+bool DynamicBVH::RayCast
+(
+	const DirectX::XMFLOAT3&    origin,
+	const DirectX::XMFLOAT3&    direction,
+	float                       maxDistance,
+	uint32_t*                   pUserData,
+	float*                      pDistance
+) const
+{
+	if (m_Root == NullNode)
+	{
+		return false;
+	}
+
+	const DirectX::XMFLOAT3 invDir(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+	auto best  = maxDistance;
+	auto found = false;
+
+	m_Stack.clear();
+	m_Stack.push_back(m_Root);
+
+	while (!m_Stack.empty())
+	{
+		auto index = m_Stack.back();
+		m_Stack.pop_back();
+
+		const auto& node = m_Nodes[index];
+
+		float t;
+		if (!IntersectRay(origin, invDir, best, node.Min, node.Max, t))
+		{
+			continue;
+		}
+
+		if (node.Height == 0)
+		{
+			best  = t;
+			found = true;
+			if (pUserData != nullptr)
+			{
+				*pUserData = node.UserData;
+			}
+			continue;
+		}
+
+		// 近い方の子を先に調べるため, 遠い方から積む.
+		const auto& c0 = m_Nodes[node.Child[0]];
+		const auto& c1 = m_Nodes[node.Child[1]];
+		float t0, t1;
+		auto hit0 = IntersectRay(origin, invDir, best, c0.Min, c0.Max, t0);
+		auto hit1 = IntersectRay(origin, invDir, best, c1.Min, c1.Max, t1);
+
+		if (hit0 && hit1)
+		{
+			if (t0 <= t1)
+			{
+				m_Stack.push_back(node.Child[1]);
+				m_Stack.push_back(node.Child[0]);
+			}
+			else
+			{
+				m_Stack.push_back(node.Child[0]);
+				m_Stack.push_back(node.Child[1]);
+			}
+		}
+		else if (hit0)
+		{
+			m_Stack.push_back(node.Child[0]);
+		}
+		else if (hit1)
+		{
+			m_Stack.push_back(node.Child[1]);
+		}
+	}
+
+	if (found && pDistance != nullptr)
+	{
+		*pDistance = best;
+	}
+
+	return found;
+}
+
+//-----------------------------------------------------------------------------
+//      葉の数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t DynamicBVH::GetProxyCount() const
+{
+	return m_ProxyCount;
+}
+
+//-----------------------------------------------------------------------------
+//      使用中のノード数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t DynamicBVH::GetNodeCount() const
+{
+	return m_NodeCount;
+}
+
+//-----------------------------------------------------------------------------
+//      木の高さを取得します.
+//-----------------------------------------------------------------------------
+int32_t DynamicBVH::GetHeight() const
+{
+	if (m_Root == NullNode)
+	{
+		return 0;
+	}
+
+	return m_Nodes[m_Root].Height;
+}
+
+//-----------------------------------------------------------------------------
+//      SAH コストを計算します.
+//-----------------------------------------------------------------------------
+float DynamicBVH::ComputeCost() const
+{
+	if (m_Root == NullNode)
+	{
+		return 0.0f;
+	}
+
+	auto rootArea = Area(m_Nodes[m_Root].Min, m_Nodes[m_Root].Max);
+	if (rootArea <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	auto total = 0.0f;
+	for (const auto& node : m_Nodes)
+	{
+		if (node.Height > 0)
+		{
+			total += Area(node.Min, node.Max);
+		}
+	}
+
+	return total / rootArea;
+}
+
+//-----------------------------------------------------------------------------
+//      ノードを取得します.
+//-----------------------------------------------------------------------------
+const DynamicBVH::Node& DynamicBVH::GetNode(int32_t index) const
+{
+	return m_Nodes[index];
+}
+
+//-----------------------------------------------------------------------------
+//      ノードを確保します.
+//-----------------------------------------------------------------------------
+int32_t DynamicBVH::AllocNode()
+{
+	int32_t index;
+	if (m_FreeList != NullNode)
+	{
+		index      = m_FreeList;
+		m_FreeList = m_Nodes[index].Parent;
+	}
+	else
+	{
+		index = int32_t(m_Nodes.size());
+		m_Nodes.emplace_back();
+	}
+
+	auto& node = m_Nodes[index];
+	node.Min      = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+	node.Max      = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+	node.Parent   = NullNode;
+	node.Height   = 0;
+	node.Child[0] = NullNode;
+	node.Child[1] = NullNode;
+	node.UserData = 0;
+	node.Reserved = 0;
+
+	m_NodeCount++;
+	return index;
+}
+
+//-----------------------------------------------------------------------------
+//      ノードを解放します.
+//-----------------------------------------------------------------------------
+void DynamicBVH::FreeNode(int32_t index)
+{
+	auto& node = m_Nodes[index];
+	node.Parent = m_FreeList;
+	node.Height = -1;
+	m_FreeList  = index;
+
+	m_NodeCount--;
+}
+
+//-----------------------------------------------------------------------------
+//      葉を木に挿入します.
+//-----------------------------------------------------------------------------
+void DynamicBVH::InsertLeaf(int32_t leaf)
+{
+	if (m_Root == NullNode)
+	{
+		m_Root = leaf;
+		m_Nodes[leaf].Parent = NullNode;
+		return;
+	}
+
+	auto sibling   = FindBestSibling(leaf);
+	auto oldParent = m_Nodes[sibling].Parent;
+	auto newParent = AllocNode();
+
+	// AllocNode() で配列が伸びる可能性があるので参照はここから取る.
+	auto& parent = m_Nodes[newParent];
+	Union(m_Nodes[leaf].Min, m_Nodes[leaf].Max, m_Nodes[sibling].Min, m_Nodes[sibling].Max, parent.Min, parent.Max);
+	parent.Parent   = oldParent;
+	parent.Height   = m_Nodes[sibling].Height + 1;
+	parent.Child[0] = sibling;
+	parent.Child[1] = leaf;
+
+	m_Nodes[sibling].Parent = newParent;
+	m_Nodes[leaf].Parent    = newParent;
+
+	if (oldParent != NullNode)
+	{
+		auto& op = m_Nodes[oldParent];
+		op.Child[(op.Child[0] == sibling) ? 0 : 1] = newParent;
+		Refit(oldParent);
+	}
+	else
+	{
+		m_Root = newParent;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      葉を木から外します.
+//-----------------------------------------------------------------------------
+void DynamicBVH::RemoveLeaf(int32_t leaf)
+{
+	if (leaf == m_Root)
+	{
+		m_Root = NullNode;
+		return;
+	}
+
+	auto parent = m_Nodes[leaf].Parent;
+	if (parent == NullNode)
+	{
+		// Rebuild() 待ちで木に繋がっていない.
+		return;
+	}
+
+	auto grandParent = m_Nodes[parent].Parent;
+	auto sibling     = (m_Nodes[parent].Child[0] == leaf) ? m_Nodes[parent].Child[1] : m_Nodes[parent].Child[0];
+
+	if (grandParent != NullNode)
+	{
+		auto& gp = m_Nodes[grandParent];
+		gp.Child[(gp.Child[0] == parent) ? 0 : 1] = sibling;
+		m_Nodes[sibling].Parent = grandParent;
+		FreeNode(parent);
+		Refit(grandParent);
+	}
+	else
+	{
+		m_Root = sibling;
+		m_Nodes[sibling].Parent = NullNode;
+		FreeNode(parent);
+	}
+
+	m_Nodes[leaf].Parent = NullNode;
+}
+
+//-----------------------------------------------------------------------------
+//      挿入後の表面積の増分が最小となる兄弟を分枝限定法で探します.
+//-----------------------------------------------------------------------------
+int32_t DynamicBVH::FindBestSibling(int32_t leaf)
+{
+	const auto leafMin  = m_Nodes[leaf].Min;
+	const auto leafMax  = m_Nodes[leaf].Max;
+	const auto leafArea = Area(leafMin, leafMax);
+
+	auto best     = m_Root;
+	auto bestCost = UnionArea(m_Nodes[m_Root].Min, m_Nodes[m_Root].Max, leafMin, leafMax);
+
+	// 祖先が広がる分の表面積を継承コストとして持ち回る.
+	m_CostStack.clear();
+	m_CostStack.push_back(std::make_pair(m_Root, 0.0f));
+
+	while (!m_CostStack.empty())
+	{
+		auto index     = m_CostStack.back().first;
+		auto inherited = m_CostStack.back().second;
+		m_CostStack.pop_back();
+
+		const auto& node = m_Nodes[index];
+
+		auto direct = UnionArea(node.Min, node.Max, leafMin, leafMax);
+		auto cost   = direct + inherited;
+		if (cost < bestCost)
+		{
+			best     = index;
+			bestCost = cost;
+		}
+
+		if (node.Height == 0)
+		{
+			continue;
+		}
+
+		// 子孫を兄弟にしてもこれ以上安くならなければ打ち切る.
+		auto childInherited = inherited + direct - Area(node.Min, node.Max);
+		if (leafArea + childInherited < bestCost)
+		{
+			m_CostStack.push_back(std::make_pair(node.Child[0], childInherited));
+			m_CostStack.push_back(std::make_pair(node.Child[1], childInherited));
+		}
+	}
+
+	return best;
+}
+
+//-----------------------------------------------------------------------------
+//      指定ノードから祖先の AABB と高さを更新します.
+//-----------------------------------------------------------------------------
+void DynamicBVH::Refit(int32_t index)
+{
+	while (index != NullNode)
+	{
+		auto& node = m_Nodes[index];
+		const auto& c0 = m_Nodes[node.Child[0]];
+		const auto& c1 = m_Nodes[node.Child[1]];
+
+		Union(c0.Min, c0.Max, c1.Min, c1.Max, node.Min, node.Max);
+		node.Height = 1 + std::max(c0.Height, c1.Height);
+
+		Rotate(index);
+
+		index = node.Parent;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      子と孫を入れ替えて表面積が減る場合は回転します.
+//-----------------------------------------------------------------------------
+void DynamicBVH::Rotate(int32_t index)
+{
+	auto& a = m_Nodes[index];
+
+	int32_t bestSlot  = -1;     // 入れ替える子の位置.
+	int32_t bestGrand = -1;     // 入れ替える孫の位置.
+	float   bestDiff  = 0.0f;
+
+	// 子 slot を, もう一方の子の孫 g と入れ替えた場合の表面積の変化を調べる.
+	for (auto slot = 0; slot < 2; ++slot)
+	{
+		const auto& child = m_Nodes[a.Child[slot]];
+		const auto& other = m_Nodes[a.Child[1 - slot]];
+		if (other.Height == 0)
+		{
+			continue;
+		}
+
+		for (auto g = 0; g < 2; ++g)
+		{
+			const auto& remain = m_Nodes[other.Child[1 - g]];
+			auto diff = UnionArea(child.Min, child.Max, remain.Min, remain.Max) - Area(other.Min, other.Max);
+			if (diff < bestDiff)
+			{
+				bestDiff  = diff;
+				bestSlot  = slot;
+				bestGrand = g;
+			}
+		}
+	}
+
+	if (bestSlot < 0)
+	{
+		return;
+	}
+
+	auto iChild = a.Child[bestSlot];
+	auto iOther = a.Child[1 - bestSlot];
+	auto& other = m_Nodes[iOther];
+	auto iGrand  = other.Child[bestGrand];
+	auto iRemain = other.Child[1 - bestGrand];
+
+	// 孫を a の直下へ, 子を other の下へ.
+	a.Child[bestSlot]       = iGrand;
+	other.Child[bestGrand]  = iChild;
+	m_Nodes[iGrand].Parent  = index;
+	m_Nodes[iChild].Parent  = iOther;
+
+	Union(m_Nodes[iChild].Min, m_Nodes[iChild].Max, m_Nodes[iRemain].Min, m_Nodes[iRemain].Max, other.Min, other.Max);
+	other.Height = 1 + std::max(m_Nodes[iChild].Height, m_Nodes[iRemain].Height);
+	a.Height     = 1 + std::max(m_Nodes[iGrand].Height, other.Height);
+}
+
+//-----------------------------------------------------------------------------
+//      構築用エントリの範囲から部分木を構築します.
+//-----------------------------------------------------------------------------
+int32_t DynamicBVH::BuildRange(uint32_t begin, uint32_t end)
+{
+	if (end - begin == 1)
+	{
+		return m_BuildEntries[begin].Leaf;
+	}
+
+	// 中心の範囲が最も広い軸で分割する.
+	auto cmin = m_BuildEntries[begin].Centroid;
+	auto cmax = cmin;
+	for (auto i = begin + 1; i < end; ++i)
+	{
+		const auto& c = m_BuildEntries[i].Centroid;
+		cmin = DirectX::XMFLOAT3(std::min(cmin.x, c.x), std::min(cmin.y, c.y), std::min(cmin.z, c.z));
+		cmax = DirectX::XMFLOAT3(std::max(cmax.x, c.x), std::max(cmax.y, c.y), std::max(cmax.z, c.z));
+	}
+
+	auto ext  = DirectX::XMFLOAT3(cmax.x - cmin.x, cmax.y - cmin.y, cmax.z - cmin.z);
+	auto axis = (ext.x >= ext.y && ext.x >= ext.z) ? 0 : ((ext.y >= ext.z) ? 1 : 2);
+	auto axisMin    = Axis(cmin, axis);
+	auto axisExtent = Axis(ext, axis);
+
+	auto mid = begin + (end - begin) / 2;
+
+	if (axisExtent > 0.0f)
+	{
+		struct Bin
+		{
+			DirectX::XMFLOAT3   Min;
+			DirectX::XMFLOAT3   Max;
+			uint32_t            Count;
+		};
+
+		Bin bins[kBinCount];
+		for (auto& bin : bins)
+		{
+			bin.Min   = DirectX::XMFLOAT3( FLT_MAX,  FLT_MAX,  FLT_MAX);
+			bin.Max   = DirectX::XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+			bin.Count = 0;
+		}
+
+		auto scale = float(kBinCount) / axisExtent;
+		auto toBin = [&](const BuildEntry& e)
+		{
+			auto b = uint32_t((Axis(e.Centroid, axis) - axisMin) * scale);
+			return std::min(b, kBinCount - 1);
+		};
+
+		for (auto i = begin; i < end; ++i)
+		{
+			const auto& leaf = m_Nodes[m_BuildEntries[i].Leaf];
+			auto& bin = bins[toBin(m_BuildEntries[i])];
+			Union(bin.Min, bin.Max, leaf.Min, leaf.Max, bin.Min, bin.Max);
+			bin.Count++;
+		}
+
+		// 右側から累積した表面積と個数.
+		float    rightArea [kBinCount];
+		uint32_t rightCount[kBinCount];
+		{
+			auto bmin  = DirectX::XMFLOAT3( FLT_MAX,  FLT_MAX,  FLT_MAX);
+			auto bmax  = DirectX::XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+			uint32_t n = 0;
+			for (auto i = kBinCount - 1; i > 0; --i)
+			{
+				Union(bmin, bmax, bins[i].Min, bins[i].Max, bmin, bmax);
+				n += bins[i].Count;
+				rightArea [i] = (n > 0) ? Area(bmin, bmax) : 0.0f;
+				rightCount[i] = n;
+			}
+		}
+
+		// 左側を累積しながら「ビン i の後ろで分割」のコストを評価.
+		auto     bestCost  = FLT_MAX;
+		uint32_t bestSplit = 0;
+		{
+			auto bmin  = DirectX::XMFLOAT3( FLT_MAX,  FLT_MAX,  FLT_MAX);
+			auto bmax  = DirectX::XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+			uint32_t n = 0;
+			for (auto i = 0u; i < kBinCount - 1; ++i)
+			{
+				Union(bmin, bmax, bins[i].Min, bins[i].Max, bmin, bmax);
+				n += bins[i].Count;
+				if (n == 0 || rightCount[i + 1] == 0)
+				{
+					continue;
+				}
+
+				auto cost = Area(bmin, bmax) * n + rightArea[i + 1] * rightCount[i + 1];
+				if (cost < bestCost)
+				{
+					bestCost  = cost;
+					bestSplit = i;
+				}
+			}
+		}
+
+		if (bestCost < FLT_MAX)
+		{
+			auto itr = std::partition(
+				m_BuildEntries.begin() + begin,
+				m_BuildEntries.begin() + end,
+				[&](const BuildEntry& e) { return toBin(e) <= bestSplit; });
+			mid = uint32_t(itr - m_BuildEntries.begin());
+		}
+	}
+
+	// 分割できなかった場合は個数で二等分する.
+	if (mid == begin || mid == end)
+	{
+		mid = begin + (end - begin) / 2;
+	}
+
+	auto left  = BuildRange(begin, mid);
+	auto right = BuildRange(mid, end);
+
+	auto index = AllocNode();
+	auto& node = m_Nodes[index];
+	Union(m_Nodes[left].Min, m_Nodes[left].Max, m_Nodes[right].Min, m_Nodes[right].Max, node.Min, node.Max);
+	node.Child[0] = left;
+	node.Child[1] = right;
+	node.Height   = 1 + std::max(m_Nodes[left].Height, m_Nodes[right].Height);
+
+	m_Nodes[left].Parent  = index;
+	m_Nodes[right].Parent = index;
+
+	return index;
+}
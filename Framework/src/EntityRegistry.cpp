@@ -0,0 +1,137 @@
+﻿//-----------------------------------------------------------------------------
+// File : EntityRegistry.cpp
+// Desc : Sparse Set Entity Component Storage Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <EntityRegistry.h>
+#include <atomic>
+
+///////////////////////////////////////////////////////////////////////////////
+// EntityRegistry class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+EntityRegistry::EntityRegistry()
+: m_Count(0)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+EntityRegistry::~EntityRegistry()
+{
+	Clear();
+}
+
+//-----------------------------------------------------------------------------
+//      エンティティを生成します.
+//-----------------------------------------------------------------------------
+Entity EntityRegistry::Create()
+{
+	uint32_t index;
+	if (!m_FreeIndices.empty())
+	{
+		index = m_FreeIndices.back();
+		m_FreeIndices.pop_back();
+	}
+	else
+	{
+		if (m_Generations.size() >= EntityIndexMask)
+		{
+			return NullEntity;
+		}
+
+		index = uint32_t(m_Generations.size());
+		m_Generations.push_back(0);
+		m_Alive.push_back(0);
+	}
+
+	m_Alive[index] = 1;
+	m_Count++;
+
+	return (uint32_t(m_Generations[index]) << EntityIndexBits) | index;
+}
+
+//-----------------------------------------------------------------------------
+//      エンティティと全てのコンポーネントを破棄します.
+//-----------------------------------------------------------------------------
+void EntityRegistry::Destroy(Entity entity)
+{
+	if (!IsAlive(entity))
+	{
+		return;
+	}
+
+	for (auto& pool : m_Pools)
+	{
+		if (pool)
+		{
+			pool->Remove(entity);
+		}
+	}
+
+	// 世代を進めて, 古いハンドルを無効にする.
+	auto index = GetEntityIndex(entity);
+	m_Generations[index] = uint8_t((m_Generations[index] + 1) & EntityGenerationMask);
+	m_Alive[index] = 0;
+	m_FreeIndices.push_back(index);
+	m_Count--;
+}
+
+//-----------------------------------------------------------------------------
+//      エンティティが有効かどうかを判定します.
+//-----------------------------------------------------------------------------
+bool EntityRegistry::IsAlive(Entity entity) const
+{
+	if (entity == NullEntity)
+	{
+		return false;
+	}
+
+	auto index = GetEntityIndex(entity);
+	return (index < m_Alive.size())
+		&& (m_Alive[index] != 0)
+		&& (m_Generations[index] == GetEntityGeneration(entity));
+}
+
+//-----------------------------------------------------------------------------
+//      全てのエンティティとコンポーネントを破棄します.
+//-----------------------------------------------------------------------------
+void EntityRegistry::Clear()
+{
+	for (auto& pool : m_Pools)
+	{
+		if (pool)
+		{
+			pool->Clear();
+		}
+	}
+
+	m_Generations.clear();
+	m_Alive      .clear();
+	m_FreeIndices.clear();
+	m_Count = 0;
+}
+
+//-----------------------------------------------------------------------------
+//      有効なエンティティ数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t EntityRegistry::GetCount() const
+{
+	return m_Count;
+}
+
+//-----------------------------------------------------------------------------
+//      コンポーネントの型番号を払い出します.
+//-----------------------------------------------------------------------------
+uint32_t EntityRegistry::NextTypeId()
+{
+	static std::atomic<uint32_t> s_Counter(0);
+	return s_Counter++;
+}
@@ -0,0 +1,397 @@
+﻿//-----------------------------------------------------------------------------
+// File : FakeCommandList.cpp
+// Desc : Recording Fake Command List Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <FakeCommandList.h>
+#include <cstring>
+#include <cassert>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      FNV-1a でハッシュ値を更新します.
+//-----------------------------------------------------------------------------
+uint64_t HashBytes(uint64_t hash, const void* pData, size_t size)
+{
+	auto pBytes = static_cast<const uint8_t*>(pData);
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= pBytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+} // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+// FakeCommandList class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+FakeCommandList::FakeCommandList()
+: m_RecordDraws (true)
+, m_RefCount    (1)
+{ Clear(); }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+FakeCommandList::~FakeCommandList()
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      記録とステートを初期状態に戻します.
+//-----------------------------------------------------------------------------
+void FakeCommandList::Clear()
+{
+	memset(&m_State,    0, sizeof(m_State));
+	memset(&m_Counters, 0, sizeof(m_Counters));
+	m_Draws.clear();
+}
+
+//-----------------------------------------------------------------------------
+//      コマンドの回数を取得します.
+//-----------------------------------------------------------------------------
+const FakeCommandList::Counters& FakeCommandList::GetCounters() const
+{ return m_Counters; }
+
+//-----------------------------------------------------------------------------
+//      ドローの記録を取得します.
+//-----------------------------------------------------------------------------
+const std::vector<FakeCommandList::DrawRecord>& FakeCommandList::GetDraws() const
+{ return m_Draws; }
+
+//-----------------------------------------------------------------------------
+//      ドローの記録を残すかどうかを設定します.
+//-----------------------------------------------------------------------------
+void FakeCommandList::SetRecordDraws(bool enable)
+{ m_RecordDraws = enable; }
+
+//-----------------------------------------------------------------------------
+//      ルート引数を設定します.
+//-----------------------------------------------------------------------------
+void FakeCommandList::SetRootParam(UINT index, PARAM_KIND kind, uint64_t value)
+{
+	m_Counters.RootParameterSets++;
+	if (kind == PARAM_KIND_TABLE)
+	{ m_Counters.DescriptorTableSets++; }
+	else
+	{ m_Counters.RootDescriptorSets++; }
+
+	assert(index < MaxRootParameters);
+	if (index >= MaxRootParameters)
+	{ return; }
+
+	if (m_State.Kinds[index] == kind && m_State.Params[index] == value)
+	{ m_Counters.RedundantSets++; }
+
+	m_State.Kinds [index] = kind;
+	m_State.Params[index] = value;
+}
+
+//-----------------------------------------------------------------------------
+//      ルート定数を設定します.
+//-----------------------------------------------------------------------------
+void FakeCommandList::SetRootConstants(UINT index, UINT count, const uint32_t* pValues, UINT offset)
+{
+	m_Counters.RootParameterSets++;
+	m_Counters.RootConstantSets++;
+
+	assert(index < MaxRootParameters && offset + count <= MaxRootConstants);
+	if (index >= MaxRootParameters || offset + count > MaxRootConstants)
+	{ return; }
+
+	auto pDst = &m_State.Constants[index][offset];
+	if (m_State.Kinds[index] == PARAM_KIND_CONSTANTS && memcmp(pDst, pValues, sizeof(uint32_t) * count) == 0)
+	{ m_Counters.RedundantSets++; }
+
+	m_State.Kinds[index] = PARAM_KIND_CONSTANTS;
+	memcpy(pDst, pValues, sizeof(uint32_t) * count);
+}
+
+//-----------------------------------------------------------------------------
+//      ドローを記録します.
+//-----------------------------------------------------------------------------
+void FakeCommandList::RecordDraw(UINT count, UINT instanceCount, UINT start, INT baseVertex, UINT startInstance)
+{
+	m_Counters.DrawCalls++;
+	if (!m_RecordDraws)
+	{ return; }
+
+	// パディングを含めないようにメンバーごとにハッシュを取る.
+	auto hash = 14695981039346656037ull;
+	hash = HashBytes(hash, &m_State.pRootSignature, sizeof(m_State.pRootSignature));
+	hash = HashBytes(hash, &m_State.pPipelineState, sizeof(m_State.pPipelineState));
+	hash = HashBytes(hash, &m_State.Topology,       sizeof(m_State.Topology));
+	hash = HashBytes(hash, m_State.Kinds,           sizeof(m_State.Kinds));
+	hash = HashBytes(hash, m_State.Params,          sizeof(m_State.Params));
+	hash = HashBytes(hash, m_State.Constants,       sizeof(m_State.Constants));
+	hash = HashBytes(hash, m_State.VertexBuffers,   sizeof(m_State.VertexBuffers));
+	hash = HashBytes(hash, &m_State.IndexBuffer,    sizeof(m_State.IndexBuffer));
+
+	DrawRecord record;
+	record.StateHash     = hash;
+	record.Count         = count;
+	record.InstanceCount = instanceCount;
+	record.Start         = start;
+	record.BaseVertex    = baseVertex;
+	record.StartInstance = startInstance;
+	m_Draws.push_back(record);
+}
+
+//-----------------------------------------------------------------------------
+//      IUnknown / ID3D12Object / ID3D12DeviceChild / ID3D12CommandList
+//-----------------------------------------------------------------------------
+HRESULT FakeCommandList::QueryInterface(REFIID, void** ppvObject)
+{
+	if (ppvObject != nullptr)
+	{ *ppvObject = nullptr; }
+	return E_NOINTERFACE;
+}
+
+// 呼び出し側が所有するので, 参照カウントが 0 になっても破棄しない.
+ULONG FakeCommandList::AddRef()
+{ return ++m_RefCount; }
+
+ULONG FakeCommandList::Release()
+{ return (m_RefCount > 0) ? --m_RefCount : 0; }
+
+HRESULT FakeCommandList::GetPrivateData(REFGUID, UINT*, void*)
+{ return E_NOTIMPL; }
+
+HRESULT FakeCommandList::SetPrivateData(REFGUID, UINT, const void*)
+{ return E_NOTIMPL; }
+
+HRESULT FakeCommandList::SetPrivateDataInterface(REFGUID, const IUnknown*)
+{ return E_NOTIMPL; }
+
+HRESULT FakeCommandList::SetName(LPCWSTR)
+{ return S_OK; }
+
+HRESULT FakeCommandList::GetDevice(REFIID, void** ppvDevice)
+{
+	if (ppvDevice != nullptr)
+	{ *ppvDevice = nullptr; }
+	return E_NOTIMPL;
+}
+
+D3D12_COMMAND_LIST_TYPE FakeCommandList::GetType()
+{ return D3D12_COMMAND_LIST_TYPE_DIRECT; }
+
+//-----------------------------------------------------------------------------
+//      ステートを変更するコマンドです.
+//-----------------------------------------------------------------------------
+HRESULT FakeCommandList::Close()
+{ return S_OK; }
+
+HRESULT FakeCommandList::Reset(ID3D12CommandAllocator*, ID3D12PipelineState* pInitialState)
+{
+	Clear();
+	m_State.pPipelineState = pInitialState;
+	return S_OK;
+}
+
+void FakeCommandList::ClearState(ID3D12PipelineState* pPipelineState)
+{
+	memset(&m_State, 0, sizeof(m_State));
+	m_State.pPipelineState = pPipelineState;
+	m_Counters.OtherCalls++;
+}
+
+void FakeCommandList::IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY PrimitiveTopology)
+{
+	m_State.Topology = uint32_t(PrimitiveTopology);
+	m_Counters.OtherCalls++;
+}
+
+void FakeCommandList::SetPipelineState(ID3D12PipelineState* pPipelineState)
+{
+	m_State.pPipelineState = pPipelineState;
+	m_Counters.PipelineStateSets++;
+}
+
+void FakeCommandList::SetGraphicsRootSignature(ID3D12RootSignature* pRootSignature)
+{
+	// 異なるルートシグニチャを設定するとルート引数は全て未定義になる.
+	if (m_State.pRootSignature != pRootSignature)
+	{
+		memset(m_State.Kinds,     0, sizeof(m_State.Kinds));
+		memset(m_State.Params,    0, sizeof(m_State.Params));
+		memset(m_State.Constants, 0, sizeof(m_State.Constants));
+	}
+	m_State.pRootSignature = pRootSignature;
+	m_Counters.RootSignatureSets++;
+}
+
+void FakeCommandList::SetGraphicsRootDescriptorTable(UINT RootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE BaseDescriptor)
+{ SetRootParam(RootParameterIndex, PARAM_KIND_TABLE, BaseDescriptor.ptr); }
+
+void FakeCommandList::SetGraphicsRoot32BitConstant(UINT RootParameterIndex, UINT SrcData, UINT DestOffsetIn32BitValues)
+{
+	uint32_t value = SrcData;
+	SetRootConstants(RootParameterIndex, 1, &value, DestOffsetIn32BitValues);
+}
+
+void FakeCommandList::SetGraphicsRoot32BitConstants(UINT RootParameterIndex, UINT Num32BitValuesToSet, const void* pSrcData, UINT DestOffsetIn32BitValues)
+{ SetRootConstants(RootParameterIndex, Num32BitValuesToSet, static_cast<const uint32_t*>(pSrcData), DestOffsetIn32BitValues); }
+
+void FakeCommandList::SetGraphicsRootConstantBufferView(UINT RootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS BufferLocation)
+{ SetRootParam(RootParameterIndex, PARAM_KIND_CBV, BufferLocation); }
+
+void FakeCommandList::SetGraphicsRootShaderResourceView(UINT RootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS BufferLocation)
+{ SetRootParam(RootParameterIndex, PARAM_KIND_SRV, BufferLocation); }
+
+void FakeCommandList::SetGraphicsRootUnorderedAccessView(UINT RootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS BufferLocation)
+{ SetRootParam(RootParameterIndex, PARAM_KIND_UAV, BufferLocation); }
+
+void FakeCommandList::IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* pView)
+{
+	if (pView != nullptr)
+	{ m_State.IndexBuffer = *pView; }
+	else
+	{ memset(&m_State.IndexBuffer, 0, sizeof(m_State.IndexBuffer)); }
+	m_Counters.IndexBufferSets++;
+}
+
+void FakeCommandList::IASetVertexBuffers(UINT StartSlot, UINT NumViews, const D3D12_VERTEX_BUFFER_VIEW* pViews)
+{
+	for (auto i = 0u; i < NumViews; ++i)
+	{
+		auto slot = StartSlot + i;
+		if (slot >= MaxVertexBuffers)
+		{ break; }
+
+		if (pViews != nullptr)
+		{ m_State.VertexBuffers[slot] = pViews[i]; }
+		else
+		{ memset(&m_State.VertexBuffers[slot], 0, sizeof(m_State.VertexBuffers[slot])); }
+	}
+	m_Counters.VertexBufferSets++;
+}
+
+//-----------------------------------------------------------------------------
+//      ドローコマンドです.
+//-----------------------------------------------------------------------------
+void FakeCommandList::DrawInstanced(UINT VertexCountPerInstance, UINT InstanceCount, UINT StartVertexLocation, UINT StartInstanceLocation)
+{ RecordDraw(VertexCountPerInstance, InstanceCount, StartVertexLocation, 0, StartInstanceLocation); }
+
+void FakeCommandList::DrawIndexedInstanced(UINT IndexCountPerInstance, UINT InstanceCount, UINT StartIndexLocation, INT BaseVertexLocation, UINT StartInstanceLocation)
+{ RecordDraw(IndexCountPerInstance, InstanceCount, StartIndexLocation, BaseVertexLocation, StartInstanceLocation); }
+
+//-----------------------------------------------------------------------------
+//      回数だけを数えるコマンドです.
+//-----------------------------------------------------------------------------
+void FakeCommandList::Dispatch(UINT, UINT, UINT)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::CopyBufferRegion(ID3D12Resource*, UINT64, ID3D12Resource*, UINT64, UINT64)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::CopyTextureRegion(const D3D12_TEXTURE_COPY_LOCATION*, UINT, UINT, UINT, const D3D12_TEXTURE_COPY_LOCATION*, const D3D12_BOX*)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::CopyResource(ID3D12Resource*, ID3D12Resource*)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::CopyTiles(ID3D12Resource*, const D3D12_TILED_RESOURCE_COORDINATE*, const D3D12_TILE_REGION_SIZE*, ID3D12Resource*, UINT64, D3D12_TILE_COPY_FLAGS)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::ResolveSubresource(ID3D12Resource*, UINT, ID3D12Resource*, UINT, DXGI_FORMAT)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::RSSetViewports(UINT, const D3D12_VIEWPORT*)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::RSSetScissorRects(UINT, const D3D12_RECT*)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::OMSetBlendFactor(const FLOAT[4])
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::OMSetStencilRef(UINT)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::ResourceBarrier(UINT, const D3D12_RESOURCE_BARRIER*)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::ExecuteBundle(ID3D12GraphicsCommandList*)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::SetDescriptorHeaps(UINT, ID3D12DescriptorHeap* const*)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::SetComputeRootSignature(ID3D12RootSignature*)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::SetComputeRootDescriptorTable(UINT, D3D12_GPU_DESCRIPTOR_HANDLE)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::SetComputeRoot32BitConstant(UINT, UINT, UINT)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::SetComputeRoot32BitConstants(UINT, UINT, const void*, UINT)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::SetComputeRootConstantBufferView(UINT, D3D12_GPU_VIRTUAL_ADDRESS)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::SetComputeRootShaderResourceView(UINT, D3D12_GPU_VIRTUAL_ADDRESS)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::SetComputeRootUnorderedAccessView(UINT, D3D12_GPU_VIRTUAL_ADDRESS)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::SOSetTargets(UINT, UINT, const D3D12_STREAM_OUTPUT_BUFFER_VIEW*)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::OMSetRenderTargets(UINT, const D3D12_CPU_DESCRIPTOR_HANDLE*, BOOL, const D3D12_CPU_DESCRIPTOR_HANDLE*)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE, D3D12_CLEAR_FLAGS, FLOAT, UINT8, UINT, const D3D12_RECT*)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE, const FLOAT[4], UINT, const D3D12_RECT*)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::ClearUnorderedAccessViewUint(D3D12_GPU_DESCRIPTOR_HANDLE, D3D12_CPU_DESCRIPTOR_HANDLE, ID3D12Resource*, const UINT[4], UINT, const D3D12_RECT*)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::ClearUnorderedAccessViewFloat(D3D12_GPU_DESCRIPTOR_HANDLE, D3D12_CPU_DESCRIPTOR_HANDLE, ID3D12Resource*, const FLOAT[4], UINT, const D3D12_RECT*)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::DiscardResource(ID3D12Resource*, const D3D12_DISCARD_REGION*)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::BeginQuery(ID3D12QueryHeap*, D3D12_QUERY_TYPE, UINT)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::EndQuery(ID3D12QueryHeap*, D3D12_QUERY_TYPE, UINT)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::ResolveQueryData(ID3D12QueryHeap*, D3D12_QUERY_TYPE, UINT, UINT, ID3D12Resource*, UINT64)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::SetPredication(ID3D12Resource*, UINT64, D3D12_PREDICATION_OP)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::SetMarker(UINT, const void*, UINT)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::BeginEvent(UINT, const void*, UINT)
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::EndEvent()
+{ m_Counters.OtherCalls++; }
+
+void FakeCommandList::ExecuteIndirect(ID3D12CommandSignature*, UINT, ID3D12Resource*, UINT64, ID3D12Resource*, UINT64)
+{ m_Counters.OtherCalls++; }
@@ -0,0 +1,126 @@
+﻿//-----------------------------------------------------------------------------
+// File : FallbackTexture.cpp
+// Desc : Shared Fallback Texture Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <FallbackTexture.h>
+#include <DescriptorPool.h>
+#include <Logger.h>
+
+namespace {
+	//-----------------------------------------------------------------------------
+	// Constant Values.
+	//-----------------------------------------------------------------------------
+	// 各テクスチャの1テクセル分の値(R8G8B8A8_UNORM).
+	constexpr uint8_t TexelValue[FallbackTexture::TYPE_COUNT][4] = {
+		{ 255, 255, 255, 255 },		// TYPE_WHITE
+		{   0,   0,   0, 255 },		// TYPE_BLACK
+		{ 128, 128, 255, 255 },		// TYPE_FLAT_NORMAL
+	};
+}// namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// FallbackTexture class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      初期化処理を行います.
+//-----------------------------------------------------------------------------
+bool FallbackTexture::Init(ID3D12Device* pDevice, DescriptorPool* pPool, ID3D12CommandQueue* pQueue)
+{
+	if (pDevice == nullptr || pPool == nullptr || pQueue == nullptr)
+	{
+		ELOG("Error : Invalid Argument.");
+		return false;
+	}
+
+	// 既に生成済みであれば共有する.
+	if (m_IsValid)
+	{
+		return true;
+	}
+
+	D3D12_RESOURCE_DESC desc = {};
+	desc.Dimension          = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	desc.Width              = 1;
+	desc.Height             = 1;
+	desc.DepthOrArraySize   = 1;
+	desc.MipLevels          = 1;
+	desc.Format             = DXGI_FORMAT_R8G8B8A8_UNORM;
+	desc.Layout             = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+	desc.SampleDesc.Count   = 1;
+	desc.SampleDesc.Quality = 0;
+
+	DirectX::ResourceUploadBatch batch(pDevice);
+	batch.Begin();
+
+	for (auto i = 0; i < TYPE_COUNT; ++i)
+	{
+		if (!m_Texture[i].Init(pDevice, pPool, &desc, D3D12_RESOURCE_STATE_COPY_DEST, false))
+		{
+			ELOG("Error : Texture::Init() Failed.");
+			Term();
+			return false;
+		}
+
+		D3D12_SUBRESOURCE_DATA data = {};
+		data.pData      = TexelValue[i];
+		data.RowPitch   = sizeof(TexelValue[i]);
+		data.SlicePitch = sizeof(TexelValue[i]);
+
+		batch.Upload(m_Texture[i].GetResource(), 0, &data, 1);
+		batch.Transition(
+			m_Texture[i].GetResource(),
+			D3D12_RESOURCE_STATE_COPY_DEST,
+			D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	}
+
+	auto future = batch.End(pQueue);
+	future.wait();
+
+	m_IsValid = true;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      終了処理を行います.
+//-----------------------------------------------------------------------------
+void FallbackTexture::Term()
+{
+	for (auto i = 0; i < TYPE_COUNT; ++i)
+	{
+		m_Texture[i].Term();
+	}
+
+	m_IsValid = false;
+}
+
+//-----------------------------------------------------------------------------
+//      テクスチャを取得します.
+//-----------------------------------------------------------------------------
+Texture* FallbackTexture::Get(TYPE type)
+{
+	if (!m_IsValid || type >= TYPE_COUNT)
+	{
+		return nullptr;
+	}
+
+	return &m_Texture[type];
+}
+
+//-----------------------------------------------------------------------------
+//      GPUディスクリプタハンドルを取得します.
+//-----------------------------------------------------------------------------
+D3D12_GPU_DESCRIPTOR_HANDLE FallbackTexture::GetHandleGPU(TYPE type) const
+{
+	if (!m_IsValid || type >= TYPE_COUNT)
+	{
+		return D3D12_GPU_DESCRIPTOR_HANDLE();
+	}
+
+	return m_Texture[type].GetHandleGPU();
+}
@@ -156,4 +156,59 @@ void Fence::Sync(ID3D12CommandQueue* pQueue)
 
 	// カウンターを増やす.
 	m_Counter++;
-}
\ No newline at end of file
+}
+
+//-----------------------------------------------------------------------------
+//      待機せずにシグナル処理を行います.
+//-----------------------------------------------------------------------------
+UINT64 Fence::Signal(ID3D12CommandQueue* pQueue)
+{
+	if (pQueue == nullptr)
+	{
+		return 0;
+	}
+
+	const auto fenceValue = m_Counter;
+
+	// シグナル処理.
+	auto hr = pQueue->Signal(m_pFence.Get(), fenceValue);
+	if (FAILED(hr))
+	{
+		return 0;
+	}
+
+	// カウンターを増やす.
+	m_Counter++;
+
+	return fenceValue;
+}
+
+//-----------------------------------------------------------------------------
+//      指定したフェンス値が完了するまで待機します.
+//-----------------------------------------------------------------------------
+bool Fence::WaitValue(UINT64 value, UINT timeout)
+{
+	// 完了済みであれば待機しない.
+	if (value == 0 || m_pFence->GetCompletedValue() >= value)
+	{
+		return true;
+	}
+
+	// 完了時にイベントを設定.
+	auto hr = m_pFence->SetEventOnCompletion(value, m_Event);
+	if (FAILED(hr))
+	{
+		return false;
+	}
+
+	// 待機処理.
+	return WAIT_OBJECT_0 == WaitForSingleObjectEx(m_Event, timeout, FALSE);
+}
+
+//-----------------------------------------------------------------------------
+//      GPUが完了したフェンス値を取得します.
+//-----------------------------------------------------------------------------
+UINT64 Fence::GetCompletedValue() const
+{
+	return (m_pFence != nullptr) ? m_pFence->GetCompletedValue() : 0;
+}
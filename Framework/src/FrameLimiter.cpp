@@ -0,0 +1,188 @@
+﻿//-----------------------------------------------------------------------------
+// File : FrameLimiter.cpp
+// Desc : Frame Rate Limiter Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <FrameLimiter.h>
+#include <chrono>
+#include <thread>
+
+///////////////////////////////////////////////////////////////////////////////
+// SystemClock class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      現在時刻を取得します.
+//-----------------------------------------------------------------------------
+double SystemClock::GetMicroSec()
+{
+	auto now = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double, std::micro>(now.time_since_epoch()).count();
+}
+
+//-----------------------------------------------------------------------------
+//      スレッドを休止します.
+//-----------------------------------------------------------------------------
+void SystemClock::Sleep(double microSec)
+{
+	std::this_thread::sleep_for(std::chrono::duration<double, std::micro>(microSec));
+}
+
+//-----------------------------------------------------------------------------
+//      休止せずに僅かな時間待機します.
+//-----------------------------------------------------------------------------
+void SystemClock::Spin()
+{
+	std::this_thread::yield();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// FrameLimiter class
+///////////////////////////////////////////////////////////////////////////////
+
+// タイマー分解能を 1ms に設定しても休止は 1ms 程度遅れることがあるため, 余裕を持たせます.
+const double FrameLimiter::DefaultSpinMicroSec = 2000.0;
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+FrameLimiter::FrameLimiter()
+: m_pClock          (nullptr)
+, m_TargetFps       (0.0)
+, m_SpinMicroSec    (DefaultSpinMicroSec)
+, m_FrameMicroSec   (0.0)
+, m_HasFrame        (false)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+FrameLimiter::~FrameLimiter()
+{
+	Term();
+}
+
+//-----------------------------------------------------------------------------
+//      初期化処理を行います.
+//-----------------------------------------------------------------------------
+bool FrameLimiter::Init(FrameClock* pClock)
+{
+	if (pClock == nullptr)
+	{
+		return false;
+	}
+
+	m_pClock = pClock;
+	Reset();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      終了処理を行います.
+//-----------------------------------------------------------------------------
+void FrameLimiter::Term()
+{
+	m_pClock = nullptr;
+	Reset();
+}
+
+//-----------------------------------------------------------------------------
+//      目標フレームレートを設定します.
+//-----------------------------------------------------------------------------
+void FrameLimiter::SetTargetFps(double fps)
+{
+	m_TargetFps = (fps > 0.0) ? fps : 0.0;
+}
+
+//-----------------------------------------------------------------------------
+//      休止せずに待機する時間を設定します.
+//-----------------------------------------------------------------------------
+void FrameLimiter::SetSpinMicroSec(double microSec)
+{
+	m_SpinMicroSec = (microSec > 0.0) ? microSec : 0.0;
+}
+
+//-----------------------------------------------------------------------------
+//      次のフレームを開始する時刻まで待機します.
+//-----------------------------------------------------------------------------
+double FrameLimiter::Wait()
+{
+	if (m_pClock == nullptr)
+	{
+		return 0.0;
+	}
+
+	auto start = m_pClock->GetMicroSec();
+	auto now   = start;
+
+	if (m_TargetFps <= 0.0)
+	{
+		m_FrameMicroSec = now;
+		m_HasFrame      = true;
+		return 0.0;
+	}
+
+	auto period = 1000000.0 / m_TargetFps;
+	auto target = m_FrameMicroSec + period;
+
+	if (m_HasFrame)
+	{
+		// 休止は遅れることがあるので, 残りが僅かになるまで休止します.
+		while (target - now > m_SpinMicroSec)
+		{
+			m_pClock->Sleep(target - now - m_SpinMicroSec);
+			now = m_pClock->GetMicroSec();
+		}
+
+		// 残りは休止せずに待機します.
+		while (now < target)
+		{
+			m_pClock->Spin();
+			now = m_pClock->GetMicroSec();
+		}
+	}
+
+	// 目標時刻を基準にして誤差が積み重ならないようにします.
+	// 大きく遅れた場合は取り戻そうとせず, 現在時刻から数え直します.
+	if (m_HasFrame && now - target < period * 0.5)
+	{
+		m_FrameMicroSec = target;
+	}
+	else
+	{
+		m_FrameMicroSec = now;
+	}
+	m_HasFrame = true;
+
+	return now - start;
+}
+
+//-----------------------------------------------------------------------------
+//      次のフレームの目標時刻を破棄します.
+//-----------------------------------------------------------------------------
+void FrameLimiter::Reset()
+{
+	m_FrameMicroSec = 0.0;
+	m_HasFrame      = false;
+}
+
+//-----------------------------------------------------------------------------
+//      目標フレームレートを取得します.
+//-----------------------------------------------------------------------------
+double FrameLimiter::GetTargetFps() const
+{
+	return m_TargetFps;
+}
+
+//-----------------------------------------------------------------------------
+//      休止せずに待機する時間を取得します.
+//-----------------------------------------------------------------------------
+double FrameLimiter::GetSpinMicroSec() const
+{
+	return m_SpinMicroSec;
+}
@@ -0,0 +1,128 @@
+﻿//-----------------------------------------------------------------------------
+// File : FramePacer.cpp
+// Desc : Frames In Flight Pacing Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <FramePacer.h>
+#include <cassert>
+
+///////////////////////////////////////////////////////////////////////////////
+// FramePacer class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+FramePacer::FramePacer()
+: m_LastValue(0)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+FramePacer::~FramePacer()
+{
+	Term();
+}
+
+//-----------------------------------------------------------------------------
+//      初期化処理を行います.
+//-----------------------------------------------------------------------------
+bool FramePacer::Init(uint32_t frameCount)
+{
+	if (frameCount == 0)
+	{
+		return false;
+	}
+
+	m_FenceValues.assign(frameCount, 0);
+	m_LastValue = 0;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      終了処理を行います.
+//-----------------------------------------------------------------------------
+void FramePacer::Term()
+{
+	m_FenceValues.clear();
+	m_FenceValues.shrink_to_fit();
+	m_LastValue = 0;
+}
+
+//-----------------------------------------------------------------------------
+//      フレームの提出を記録します.
+//-----------------------------------------------------------------------------
+void FramePacer::EndFrame(uint32_t frameIndex, uint64_t fenceValue)
+{
+	// シグナルに失敗した場合は記録しません.
+	if (frameIndex >= m_FenceValues.size() || fenceValue == 0)
+	{
+		return;
+	}
+
+	// フェンス値は単調増加している必要があります.
+	assert(fenceValue > m_LastValue);
+
+	m_FenceValues[frameIndex] = fenceValue;
+	m_LastValue = fenceValue;
+}
+
+//-----------------------------------------------------------------------------
+//      フレーム番号を再利用する前に完了を待つフェンス値を取得します.
+//-----------------------------------------------------------------------------
+uint64_t FramePacer::GetWaitValue(uint32_t frameIndex) const
+{
+	if (frameIndex >= m_FenceValues.size())
+	{
+		return 0;
+	}
+
+	return m_FenceValues[frameIndex];
+}
+
+//-----------------------------------------------------------------------------
+//      フレーム番号を再利用できるかどうかを判定します.
+//-----------------------------------------------------------------------------
+bool FramePacer::IsReady(uint32_t frameIndex, uint64_t completedValue) const
+{
+	return GetWaitValue(frameIndex) <= completedValue;
+}
+
+//-----------------------------------------------------------------------------
+//      GPUが実行中のフレーム数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t FramePacer::GetInFlightCount(uint64_t completedValue) const
+{
+	uint32_t count = 0;
+	for (auto value : m_FenceValues)
+	{
+		if (value > completedValue)
+		{
+			count++;
+		}
+	}
+
+	return count;
+}
+
+//-----------------------------------------------------------------------------
+//      同時に処理するフレーム数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t FramePacer::GetFrameCount() const
+{
+	return uint32_t(m_FenceValues.size());
+}
+
+//-----------------------------------------------------------------------------
+//      最後に提出したフェンス値を取得します.
+//-----------------------------------------------------------------------------
+uint64_t FramePacer::GetLastValue() const
+{
+	return m_LastValue;
+}
@@ -0,0 +1,144 @@
+﻿//-----------------------------------------------------------------------------
+// File : FrameStats.cpp
+// Desc : Frame Time Statistics Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <FrameStats.h>
+#include <algorithm>
+#include <cmath>
+
+///////////////////////////////////////////////////////////////////////////////
+// FrameStats class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+FrameStats::FrameStats()
+: m_Count   (0)
+, m_Next    (0)
+, m_Last    (0.0)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+FrameStats::~FrameStats()
+{
+	Term();
+}
+
+//-----------------------------------------------------------------------------
+//      初期化処理を行います.
+//-----------------------------------------------------------------------------
+bool FrameStats::Init(uint32_t capacity)
+{
+	if (capacity == 0)
+	{
+		return false;
+	}
+
+	m_Samples.assign(capacity, 0.0);
+	m_Sorted.reserve(capacity);
+	Clear();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      終了処理を行います.
+//-----------------------------------------------------------------------------
+void FrameStats::Term()
+{
+	m_Samples.clear();
+	m_Samples.shrink_to_fit();
+	m_Sorted.clear();
+	m_Sorted.shrink_to_fit();
+	Clear();
+}
+
+//-----------------------------------------------------------------------------
+//      サンプルを追加します.
+//-----------------------------------------------------------------------------
+void FrameStats::Push(double value)
+{
+	if (m_Samples.empty())
+	{
+		return;
+	}
+
+	m_Samples[m_Next] = value;
+	m_Next = (m_Next + 1) % uint32_t(m_Samples.size());
+	m_Count = std::min(m_Count + 1, uint32_t(m_Samples.size()));
+	m_Last = value;
+}
+
+//-----------------------------------------------------------------------------
+//      サンプルを全て破棄します.
+//-----------------------------------------------------------------------------
+void FrameStats::Clear()
+{
+	m_Count = 0;
+	m_Next  = 0;
+	m_Last  = 0.0;
+}
+
+//-----------------------------------------------------------------------------
+//      パーセンタイル値を取得します.
+//-----------------------------------------------------------------------------
+double FrameStats::GetPercentile(double percent) const
+{
+	if (m_Count == 0)
+	{
+		return 0.0;
+	}
+
+	// 最近順位法: 昇順に並べたときの ceil(p / 100 * N) 番目の値です.
+	auto p    = std::max(0.0, std::min(percent, 100.0));
+	auto rank = uint32_t(std::ceil(p * 0.01 * m_Count));
+	auto idx  = (rank > 0) ? rank - 1 : 0;
+
+	m_Sorted.assign(m_Samples.begin(), m_Samples.begin() + m_Count);
+	std::nth_element(m_Sorted.begin(), m_Sorted.begin() + idx, m_Sorted.end());
+
+	return m_Sorted[idx];
+}
+
+//-----------------------------------------------------------------------------
+//      平均値を取得します.
+//-----------------------------------------------------------------------------
+double FrameStats::GetAverage() const
+{
+	if (m_Count == 0)
+	{
+		return 0.0;
+	}
+
+	double sum = 0.0;
+	for (auto i = 0u; i < m_Count; ++i)
+	{
+		sum += m_Samples[i];
+	}
+
+	return sum / double(m_Count);
+}
+
+//-----------------------------------------------------------------------------
+//      最後に追加したサンプルを取得します.
+//-----------------------------------------------------------------------------
+double FrameStats::GetLast() const
+{
+	return m_Last;
+}
+
+//-----------------------------------------------------------------------------
+//      保持しているサンプル数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t FrameStats::GetCount() const
+{
+	return m_Count;
+}
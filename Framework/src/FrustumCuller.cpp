@@ -0,0 +1,303 @@
+﻿//-----------------------------------------------------------------------------
+// File : FrustumCuller.cpp
+// Desc : SIMD Frustum Culling Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <FrustumCuller.h>
+#include <xmmintrin.h>
+#include <cmath>
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+
+// 4bitの可視マスクから, 可視レーンを前詰めにした並びと個数を引く表.
+static const uint8_t kLaneTable[16][4] = {
+	{ 0, 0, 0, 0 }, { 0, 0, 0, 0 }, { 1, 0, 0, 0 }, { 0, 1, 0, 0 },
+	{ 2, 0, 0, 0 }, { 0, 2, 0, 0 }, { 1, 2, 0, 0 }, { 0, 1, 2, 0 },
+	{ 3, 0, 0, 0 }, { 0, 3, 0, 0 }, { 1, 3, 0, 0 }, { 0, 1, 3, 0 },
+	{ 2, 3, 0, 0 }, { 0, 2, 3, 0 }, { 1, 2, 3, 0 }, { 0, 1, 2, 3 },
+};
+static const uint8_t kLaneCount[16] = {
+	0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+};
+
+//-----------------------------------------------------------------------------
+//      平面を正規化します.
+//-----------------------------------------------------------------------------
+DirectX::XMFLOAT4 NormalizePlane(float a, float b, float c, float d)
+{
+	auto len = std::sqrt(a * a + b * b + c * c);
+	auto inv = (len > 0.0f) ? 1.0f / len : 0.0f;
+	return DirectX::XMFLOAT4(a * inv, b * inv, c * inv, d * inv);
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// Frustum structure
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      ビュー射影行列から平面を抽出します.
+//-----------------------------------------------------------------------------
+void Frustum::Extract(const DirectX::XMFLOAT4X4& m)
+{
+	// clip = v * M なので, クリップ座標の各成分は M の列との内積になる.
+	Planes[PLANE_LEFT]   = NormalizePlane(m._14 + m._11, m._24 + m._21, m._34 + m._31, m._44 + m._41);
+	Planes[PLANE_RIGHT]  = NormalizePlane(m._14 - m._11, m._24 - m._21, m._34 - m._31, m._44 - m._41);
+	Planes[PLANE_BOTTOM] = NormalizePlane(m._14 + m._12, m._24 + m._22, m._34 + m._32, m._44 + m._42);
+	Planes[PLANE_TOP]    = NormalizePlane(m._14 - m._12, m._24 - m._22, m._34 - m._32, m._44 - m._42);
+	Planes[PLANE_NEAR]   = NormalizePlane(m._13,         m._23,         m._33,         m._43);
+	Planes[PLANE_FAR]    = NormalizePlane(m._14 - m._13, m._24 - m._23, m._34 - m._33, m._44 - m._43);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// FrustumCuller class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+FrustumCuller::FrustumCuller()
+{ /* DO_NOTHING */
+}
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+FrustumCuller::~FrustumCuller()
+{ /* DO_NOTHING */
+}
+
+//-----------------------------------------------------------------------------
+//      登録済みの境界ボリュームを破棄します.
+//-----------------------------------------------------------------------------
+void FrustumCuller::Clear()
+{
+	m_CenterX.clear();
+	m_CenterY.clear();
+	m_CenterZ.clear();
+	m_ExtentX.clear();
+	m_ExtentY.clear();
+	m_ExtentZ.clear();
+}
+
+//-----------------------------------------------------------------------------
+//      領域を予約します.
+//-----------------------------------------------------------------------------
+void FrustumCuller::Reserve(size_t count)
+{
+	m_CenterX.reserve(count);
+	m_CenterY.reserve(count);
+	m_CenterZ.reserve(count);
+	m_ExtentX.reserve(count);
+	m_ExtentY.reserve(count);
+	m_ExtentZ.reserve(count);
+}
+
+//-----------------------------------------------------------------------------
+//      ワールド空間のAABBを追加します.
+//-----------------------------------------------------------------------------
+uint32_t FrustumCuller::Add(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extent)
+{
+	auto index = uint32_t(m_CenterX.size());
+
+	m_CenterX.push_back(center.x);
+	m_CenterY.push_back(center.y);
+	m_CenterZ.push_back(center.z);
+	m_ExtentX.push_back(extent.x);
+	m_ExtentY.push_back(extent.y);
+	m_ExtentZ.push_back(extent.z);
+
+	return index;
+}
+
+//-----------------------------------------------------------------------------
+//      ローカル空間のAABBをワールド空間に変換して追加します.
+//-----------------------------------------------------------------------------
+uint32_t FrustumCuller::Add
+(
+	const DirectX::XMFLOAT3&    localMin,
+	const DirectX::XMFLOAT3&    localMax,
+	const DirectX::XMFLOAT4X4&  world
+)
+{
+	DirectX::XMFLOAT3 center;
+	DirectX::XMFLOAT3 extent;
+	TransformAABB(localMin, localMax, world, center, extent);
+	return Add(center, extent);
+}
+
+//-----------------------------------------------------------------------------
+//      視錐台と交差する境界ボリュームを SSE で4つずつ判定します.
+//-----------------------------------------------------------------------------
+size_t FrustumCuller::Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const
+{
+	const auto count = m_CenterX.size();
+
+	// 4要素ずつ無条件に書き込むので末尾に余裕を持たせておく.
+	visible.resize(count + 4);
+	auto pOut = visible.data();
+	size_t n  = 0;
+
+	// 平面ごとの係数をあらかじめ4レーンに複製しておく.
+	__m128 nx[Frustum::PLANE_COUNT], ny[Frustum::PLANE_COUNT], nz[Frustum::PLANE_COUNT], nw[Frustum::PLANE_COUNT];
+	__m128 ax[Frustum::PLANE_COUNT], ay[Frustum::PLANE_COUNT], az[Frustum::PLANE_COUNT];
+	for (auto p = 0; p < Frustum::PLANE_COUNT; ++p)
+	{
+		const auto& plane = frustum.Planes[p];
+		nx[p] = _mm_set1_ps(plane.x);
+		ny[p] = _mm_set1_ps(plane.y);
+		nz[p] = _mm_set1_ps(plane.z);
+		nw[p] = _mm_set1_ps(plane.w);
+		ax[p] = _mm_set1_ps(std::fabs(plane.x));
+		ay[p] = _mm_set1_ps(std::fabs(plane.y));
+		az[p] = _mm_set1_ps(std::fabs(plane.z));
+	}
+
+	const auto zero = _mm_setzero_ps();
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		auto cx = _mm_loadu_ps(&m_CenterX[i]);
+		auto cy = _mm_loadu_ps(&m_CenterY[i]);
+		auto cz = _mm_loadu_ps(&m_CenterZ[i]);
+		auto ex = _mm_loadu_ps(&m_ExtentX[i]);
+		auto ey = _mm_loadu_ps(&m_ExtentY[i]);
+		auto ez = _mm_loadu_ps(&m_ExtentZ[i]);
+
+		// いずれかの平面の完全に外側にあれば不可視.
+		auto outside = _mm_setzero_ps();
+		for (auto p = 0; p < Frustum::PLANE_COUNT; ++p)
+		{
+			auto d = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy)),
+				_mm_add_ps(_mm_mul_ps(nz[p], cz), nw[p]));
+			auto r = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(ax[p], ex), _mm_mul_ps(ay[p], ey)),
+				_mm_mul_ps(az[p], ez));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(d, r), zero));
+		}
+
+		// 可視レーンの番号を前詰めで書き込む.
+		auto mask  = ~_mm_movemask_ps(outside) & 0xF;
+		auto lanes = kLaneTable[mask];
+		pOut[n + 0] = uint32_t(i) + lanes[0];
+		pOut[n + 1] = uint32_t(i) + lanes[1];
+		pOut[n + 2] = uint32_t(i) + lanes[2];
+		pOut[n + 3] = uint32_t(i) + lanes[3];
+		n += kLaneCount[mask];
+	}
+
+	// 端数はスカラーで判定.
+	for (; i < count; ++i)
+	{
+		auto inside = true;
+		for (auto p = 0; p < Frustum::PLANE_COUNT; ++p)
+		{
+			const auto& plane = frustum.Planes[p];
+			auto d = (plane.x * m_CenterX[i] + plane.y * m_CenterY[i]) + (plane.z * m_CenterZ[i] + plane.w);
+			auto r = (std::fabs(plane.x) * m_ExtentX[i] + std::fabs(plane.y) * m_ExtentY[i]) + std::fabs(plane.z) * m_ExtentZ[i];
+			if (d + r < 0.0f)
+			{
+				inside = false;
+				break;
+			}
+		}
+
+		if (inside)
+		{
+			pOut[n++] = uint32_t(i);
+		}
+	}
+
+	visible.resize(n);
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+//      視錐台と交差する境界ボリュームを1つずつ判定します.
+//-----------------------------------------------------------------------------
+size_t FrustumCuller::CullReference(const Frustum& frustum, std::vector<uint32_t>& visible) const
+{
+	visible.clear();
+
+	for (size_t i = 0; i < m_CenterX.size(); ++i)
+	{
+		auto inside = true;
+		for (auto p = 0; p < Frustum::PLANE_COUNT; ++p)
+		{
+			const auto& plane = frustum.Planes[p];
+
+			// 中心の符号付き距離に, 法線方向へ投影した半径を足しても負なら不可視.
+			auto d = (plane.x * m_CenterX[i] + plane.y * m_CenterY[i]) + (plane.z * m_CenterZ[i] + plane.w);
+			auto r = (std::fabs(plane.x) * m_ExtentX[i] + std::fabs(plane.y) * m_ExtentY[i]) + std::fabs(plane.z) * m_ExtentZ[i];
+			if (d + r < 0.0f)
+			{
+				inside = false;
+				break;
+			}
+		}
+
+		if (inside)
+		{
+			visible.push_back(uint32_t(i));
+		}
+	}
+
+	return visible.size();
+}
+
+//-----------------------------------------------------------------------------
+//      登録済みの境界ボリューム数を取得します.
+//-----------------------------------------------------------------------------
+size_t FrustumCuller::GetCount() const
+{
+	return m_CenterX.size();
+}
+
+//-----------------------------------------------------------------------------
+//      登録済みの境界ボリュームを取得します.
+//-----------------------------------------------------------------------------
+void FrustumCuller::GetBounds(uint32_t index, DirectX::XMFLOAT3& center, DirectX::XMFLOAT3& extent) const
+{
+	center = DirectX::XMFLOAT3(m_CenterX[index], m_CenterY[index], m_CenterZ[index]);
+	extent = DirectX::XMFLOAT3(m_ExtentX[index], m_ExtentY[index], m_ExtentZ[index]);
+}
+
+//-----------------------------------------------------------------------------
+//      ローカル空間のAABBをワールド空間のAABBに変換します.
+//-----------------------------------------------------------------------------
+void FrustumCuller::TransformAABB
+(
+	const DirectX::XMFLOAT3&    localMin,
+	const DirectX::XMFLOAT3&    localMax,
+	const DirectX::XMFLOAT4X4&  world,
+	DirectX::XMFLOAT3&          center,
+	DirectX::XMFLOAT3&          extent
+)
+{
+	auto vmin = DirectX::XMLoadFloat3(&localMin);
+	auto vmax = DirectX::XMLoadFloat3(&localMax);
+	auto c    = DirectX::XMVectorScale(DirectX::XMVectorAdd(vmin, vmax), 0.5f);
+	auto e    = DirectX::XMVectorScale(DirectX::XMVectorSubtract(vmax, vmin), 0.5f);
+
+	auto m = DirectX::XMLoadFloat4x4(&world);
+
+	// 中心は平行移動込みで変換し, 大きさは回転・拡縮成分の絶対値で変換する.
+	auto wc = DirectX::XMVector3Transform(c, m);
+	auto we = DirectX::XMVectorMultiply(DirectX::XMVectorSplatX(e), DirectX::XMVectorAbs(m.r[0]));
+	we = DirectX::XMVectorMultiplyAdd(DirectX::XMVectorSplatY(e), DirectX::XMVectorAbs(m.r[1]), we);
+	we = DirectX::XMVectorMultiplyAdd(DirectX::XMVectorSplatZ(e), DirectX::XMVectorAbs(m.r[2]), we);
+
+	DirectX::XMStoreFloat3(&center, wc);
+	DirectX::XMStoreFloat3(&extent, we);
+}
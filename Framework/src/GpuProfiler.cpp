@@ -0,0 +1,290 @@
+﻿//-----------------------------------------------------------------------------
+// File : GpuProfiler.cpp
+// Desc : GPU Timestamp Profiler Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <GpuProfiler.h>
+#include <Logger.h>
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      カウンタ値をナノ秒に変換します.
+//-----------------------------------------------------------------------------
+int64_t ToNanoSec(uint64_t counter, uint64_t frequency)
+{
+	// 桁あふれしないよう秒と端数に分けて変換します.
+	auto sec  = counter / frequency;
+	auto frac = counter % frequency;
+	return int64_t(sec * 1000000000ull + frac * 1000000000ull / frequency);
+}
+
+} // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+// GpuProfiler class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+GpuProfiler::GpuProfiler()
+: m_MaxScopes   (0)
+, m_FrameIndex  (0)
+, m_Frequency   (0)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+GpuProfiler::~GpuProfiler()
+{
+	Term();
+}
+
+//-----------------------------------------------------------------------------
+//      初期化処理を行います.
+//-----------------------------------------------------------------------------
+bool GpuProfiler::Init(ID3D12Device* pDevice, ID3D12CommandQueue* pQueue, uint32_t frameCount, uint32_t maxScopes)
+{
+	if (pDevice == nullptr || pQueue == nullptr || frameCount == 0 || maxScopes == 0)
+	{
+		return false;
+	}
+
+	Term();
+
+	// 開始と終了の2つをフレームごとに連続して確保します.
+	const auto queryCount = frameCount * maxScopes * 2;
+
+	D3D12_QUERY_HEAP_DESC heapDesc = {};
+	heapDesc.Type     = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+	heapDesc.Count    = queryCount;
+	heapDesc.NodeMask = 0;
+
+	auto hr = pDevice->CreateQueryHeap(&heapDesc, IID_PPV_ARGS(m_pHeap.GetAddressOf()));
+	if (FAILED(hr))
+	{
+		ELOG("Error : ID3D12Device::CreateQueryHeap() Failed. retcode = 0x%x", hr);
+		return false;
+	}
+
+	D3D12_HEAP_PROPERTIES prop = {};
+	prop.Type                 = D3D12_HEAP_TYPE_READBACK;
+	prop.CPUPageProperty      = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	prop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	prop.CreationNodeMask     = 1;
+	prop.VisibleNodeMask      = 1;
+
+	D3D12_RESOURCE_DESC desc = {};
+	desc.Dimension          = D3D12_RESOURCE_DIMENSION_BUFFER;
+	desc.Alignment          = 0;
+	desc.Width              = UINT64(sizeof(uint64_t)) * queryCount;
+	desc.Height             = 1;
+	desc.DepthOrArraySize   = 1;
+	desc.MipLevels          = 1;
+	desc.Format             = DXGI_FORMAT_UNKNOWN;
+	desc.SampleDesc.Count   = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Layout             = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	desc.Flags              = D3D12_RESOURCE_FLAG_NONE;
+
+	hr = pDevice->CreateCommittedResource(
+		&prop,
+		D3D12_HEAP_FLAG_NONE,
+		&desc,
+		D3D12_RESOURCE_STATE_COPY_DEST,
+		nullptr,
+		IID_PPV_ARGS(m_pReadback.GetAddressOf()));
+	if (FAILED(hr))
+	{
+		ELOG("Error : ID3D12Device::CreateCommittedResource() Failed. retcode = 0x%x", hr);
+		Term();
+		return false;
+	}
+
+	hr = pQueue->GetTimestampFrequency(&m_Frequency);
+	if (FAILED(hr) || m_Frequency == 0)
+	{
+		ELOG("Error : ID3D12CommandQueue::GetTimestampFrequency() Failed. retcode = 0x%x", hr);
+		Term();
+		return false;
+	}
+
+	m_pQueue     = pQueue;
+	m_MaxScopes  = maxScopes;
+	m_FrameIndex = 0;
+	m_Frames.resize(frameCount);
+	for (auto& frame : m_Frames)
+	{
+		frame.Scopes.reserve(maxScopes);
+		frame.Resolved = false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      終了処理を行います.
+//-----------------------------------------------------------------------------
+void GpuProfiler::Term()
+{
+	m_Frames.clear();
+	m_pReadback.Reset();
+	m_pHeap.Reset();
+	m_pQueue.Reset();
+
+	m_MaxScopes  = 0;
+	m_FrameIndex = 0;
+	m_Frequency  = 0;
+}
+
+//-----------------------------------------------------------------------------
+//      フレームを開始します.
+//-----------------------------------------------------------------------------
+void GpuProfiler::BeginFrame(uint32_t frameIndex, Profiler* pProfiler)
+{
+	if (m_Frames.empty())
+	{
+		return;
+	}
+
+	m_FrameIndex = frameIndex % uint32_t(m_Frames.size());
+	auto& frame  = m_Frames[m_FrameIndex];
+
+	if (frame.Resolved && !frame.Scopes.empty() && pProfiler != nullptr)
+	{
+		const auto first = SIZE_T(m_FrameIndex) * m_MaxScopes * 2;
+		const auto count = SIZE_T(frame.Scopes.size()) * 2;
+
+		D3D12_RANGE readRange = { first * sizeof(uint64_t), (first + count) * sizeof(uint64_t) };
+		void* pData = nullptr;
+		auto hr = m_pReadback->Map(0, &readRange, &pData);
+		if (SUCCEEDED(hr))
+		{
+			// GPU の時刻を CPU の時刻に合わせます. CPU 側は QueryPerformanceCounter を
+			// ナノ秒にしたもので, high_resolution_clock と同じ基準です.
+			UINT64 gpuBase = 0;
+			UINT64 cpuBase = 0;
+			LARGE_INTEGER qpf = {};
+			if (SUCCEEDED(m_pQueue->GetClockCalibration(&gpuBase, &cpuBase)) && QueryPerformanceFrequency(&qpf))
+			{
+				auto baseNs     = ToNanoSec(cpuBase, uint64_t(qpf.QuadPart));
+				auto pTimestamp = static_cast<const uint64_t*>(pData) + first;
+				auto toCpu      = [&](uint64_t timestamp)
+				{
+					auto delta = double(int64_t(timestamp - gpuBase)) * 1e9 / double(m_Frequency);
+					return baseNs + int64_t(delta);
+				};
+
+				for (size_t i = 0; i < frame.Scopes.size(); ++i)
+				{
+					auto begin = pTimestamp[i * 2 + 0];
+					auto end   = pTimestamp[i * 2 + 1];
+					if (end < begin)
+					{ continue; }
+
+					pProfiler->AddEvent(frame.Scopes[i].Name, Profiler::GpuThread, toCpu(begin), toCpu(end), frame.Scopes[i].Depth);
+				}
+			}
+
+			D3D12_RANGE writeRange = { 0, 0 };
+			m_pReadback->Unmap(0, &writeRange);
+		}
+	}
+
+	frame.Scopes.clear();
+	frame.Resolved = false;
+}
+
+//-----------------------------------------------------------------------------
+//      スコープを追加します.
+//-----------------------------------------------------------------------------
+uint32_t GpuProfiler::AddScope(const char* name, uint32_t depth)
+{
+	if (m_Frames.empty())
+	{
+		return InvalidScope;
+	}
+
+	auto& frame = m_Frames[m_FrameIndex];
+	if (frame.Scopes.size() >= m_MaxScopes)
+	{
+		return InvalidScope;
+	}
+
+	Scope scope;
+	scope.Name  = name;
+	scope.Depth = depth;
+	frame.Scopes.push_back(scope);
+
+	return uint32_t(frame.Scopes.size() - 1);
+}
+
+//-----------------------------------------------------------------------------
+//      スコープの開始時刻を書き込むコマンドを記録します.
+//-----------------------------------------------------------------------------
+void GpuProfiler::Begin(ID3D12GraphicsCommandList* pCmd, uint32_t scope)
+{
+	if (scope == InvalidScope || m_pHeap == nullptr)
+	{
+		return;
+	}
+
+	pCmd->EndQuery(m_pHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, (m_FrameIndex * m_MaxScopes + scope) * 2 + 0);
+}
+
+//-----------------------------------------------------------------------------
+//      スコープの終了時刻を書き込むコマンドを記録します.
+//-----------------------------------------------------------------------------
+void GpuProfiler::End(ID3D12GraphicsCommandList* pCmd, uint32_t scope)
+{
+	if (scope == InvalidScope || m_pHeap == nullptr)
+	{
+		return;
+	}
+
+	pCmd->EndQuery(m_pHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, (m_FrameIndex * m_MaxScopes + scope) * 2 + 1);
+}
+
+//-----------------------------------------------------------------------------
+//      計測結果を読み戻し用のバッファへ書き込むコマンドを記録します.
+//-----------------------------------------------------------------------------
+void GpuProfiler::Resolve(ID3D12GraphicsCommandList* pCmd)
+{
+	if (m_Frames.empty())
+	{
+		return;
+	}
+
+	auto& frame = m_Frames[m_FrameIndex];
+	if (frame.Scopes.empty())
+	{
+		return;
+	}
+
+	const auto first = m_FrameIndex * m_MaxScopes * 2;
+	const auto count = uint32_t(frame.Scopes.size()) * 2;
+	pCmd->ResolveQueryData(
+		m_pHeap.Get(),
+		D3D12_QUERY_TYPE_TIMESTAMP,
+		first,
+		count,
+		m_pReadback.Get(),
+		UINT64(first) * sizeof(uint64_t));
+
+	frame.Resolved = true;
+}
+
+//-----------------------------------------------------------------------------
+//      現在のフレームのスコープ数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t GpuProfiler::GetScopeCount() const
+{
+	return m_Frames.empty() ? 0 : uint32_t(m_Frames[m_FrameIndex].Scopes.size());
+}
@@ -10,6 +10,8 @@
 #include <IBLBaker.h>
 #include <SimpleMath.h>
 #include <Logger.h>
+#include <PipelineCache.h>
+#include <InlineUtil.h>
 #include <CommonStates.h>
 #include <DirectXHelpers.h>
 #include <pix_win.h>
@@ -168,14 +170,9 @@ bool IBLBaker::Init
 			return false;
 		}
 
-		hr = pDevice->CreateRootSignature(
-			0,
-			pBlob->GetBufferPointer(),
-			pBlob->GetBufferSize(),
-			IID_PPV_ARGS(m_pDFG_RootSig.GetAddressOf()));
-		if (FAILED(hr))
+		if (!PipelineCache::GetInstance().GetRootSignature(pDevice, pBlob->GetBufferPointer(), pBlob->GetBufferSize(), m_pDFG_RootSig))
 		{
-			ELOG("Error : ID3D12Device::CreateRootSignature() Failed. errcode : 0x%x", hr);
+			ELOG("Error : PipelineCache::GetRootSignature() Failed.");
 			return false;
 		}
 	}
@@ -248,14 +245,9 @@ bool IBLBaker::Init
 			return false;
 		}
 
-		hr = pDevice->CreateRootSignature(
-			0,
-			pBlob->GetBufferPointer(),
-			pBlob->GetBufferSize(),
-			IID_PPV_ARGS(m_pLD_RootSig.GetAddressOf()));
-		if (FAILED(hr))
+		if (!PipelineCache::GetInstance().GetRootSignature(pDevice, pBlob->GetBufferPointer(), pBlob->GetBufferSize(), m_pLD_RootSig))
 		{
-			ELOG("Error : ID3D12Device::CreateRootSignature() Failed. errcode = 0x%x", hr);
+			ELOG("Error : PipelineCache::GetRootSignature() Failed.");
 			return false;
 		}
 	}
@@ -285,10 +277,9 @@ bool IBLBaker::Init
 		desc.SampleDesc.Count = 1;
 		desc.SampleDesc.Quality = 0;
 
-		auto hr = pDevice->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(m_pDFG_PSO.GetAddressOf()));
-		if (FAILED(hr))
+		if (!PipelineCache::GetInstance().GetGraphicsPipeline(pDevice, desc, m_pDFG_PSO))
 		{
-			ELOG("Error : ID3D12Device::CreateGraphicsPipelineState() Failed. errcode = 0x%x", hr);
+			ELOG("Error : PipelineCache::GetGraphicsPipeline() Failed.");
 			return false;
 		}
 	}
@@ -311,10 +302,9 @@ bool IBLBaker::Init
 		desc.SampleDesc.Count = 1;
 		desc.SampleDesc.Quality = 0;
 
-		auto hr = pDevice->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(m_pDiffuseLD_PSO.GetAddressOf()));
-		if (FAILED(hr))
+		if (!PipelineCache::GetInstance().GetGraphicsPipeline(pDevice, desc, m_pDiffuseLD_PSO))
 		{
-			ELOG("Error : ID3D12Device::CreateGraphicsPipelineState() Failed. errcode = 0x%x", hr);
+			ELOG("Error : PipelineCache::GetGraphicsPipeline() Failed.");
 			return false;
 		}
 	}
@@ -337,10 +327,9 @@ bool IBLBaker::Init
 		desc.SampleDesc.Count = 1;
 		desc.SampleDesc.Quality = 0;
 
-		auto hr = pDevice->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(m_pSpecularLD_PSO.GetAddressOf()));
-		if (FAILED(hr))
+		if (!PipelineCache::GetInstance().GetGraphicsPipeline(pDevice, desc, m_pSpecularLD_PSO))
 		{
-			ELOG("Error : ID3D12Device::CreateGraphicsPipelineState() Failed. errcode = 0x%x", hr);
+			ELOG("Error : PipelineCache::GetGraphicsPipeline() Failed.");
 			return false;
 		}
 	}
@@ -952,4 +941,40 @@ D3D12_GPU_DESCRIPTOR_HANDLE IBLBaker::GetHandleGPU_DiffuseLD() const
 D3D12_GPU_DESCRIPTOR_HANDLE IBLBaker::GetHandleGPU_SpecularLD() const
 {
 	return m_pHandleSRV_SpecularLD->HandleGPU;
-}
\ No newline at end of file
+}
+
+//-----------------------------------------------------------------------------
+//      DFGテクスチャを取得します.
+//-----------------------------------------------------------------------------
+ID3D12Resource* IBLBaker::GetTextureDFG() const
+{
+	return m_TexDFG.Get();
+}
+
+//-----------------------------------------------------------------------------
+//      DiffuseLDテクスチャを取得します.
+//-----------------------------------------------------------------------------
+ID3D12Resource* IBLBaker::GetTextureDiffuseLD() const
+{
+	return m_TexDiffuseLD.Get();
+}
+
+//-----------------------------------------------------------------------------
+//      SpecularLDテクスチャを取得します.
+//-----------------------------------------------------------------------------
+ID3D12Resource* IBLBaker::GetTextureSpecularLD() const
+{
+	return m_TexSpecularLD.Get();
+}
+
+//-----------------------------------------------------------------------------
+//      積分に使用するシェーダのハッシュ値を求めます.
+//-----------------------------------------------------------------------------
+uint64_t IBLBaker::GetShaderHash()
+{
+	auto hash = HashBytes(QuadVS, sizeof(QuadVS));
+	hash = HashBytes(IntegrateDFG_PS,        sizeof(IntegrateDFG_PS),        hash);
+	hash = HashBytes(IntegrateDiffuseLD_PS,  sizeof(IntegrateDiffuseLD_PS),  hash);
+	hash = HashBytes(IntegrateSpecularLD_PS, sizeof(IntegrateSpecularLD_PS), hash);
+	return hash;
+}
@@ -0,0 +1,438 @@
+﻿//-----------------------------------------------------------------------------
+// File : IBLCache.cpp
+// Desc : Baked IBL Texture Cache Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <IBLCache.h>
+#include <InlineUtil.h>
+#include <Logger.h>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <climits>
+#include <cwchar>
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const uint32_t DDS_MAGIC                = 0x20534444;  // "DDS "
+const uint32_t DDS_FOURCC_DX10          = 0x30315844;  // "DX10"
+const uint32_t DDSD_CAPS                = 0x1;
+const uint32_t DDSD_HEIGHT              = 0x2;
+const uint32_t DDSD_WIDTH               = 0x4;
+const uint32_t DDSD_PIXELFORMAT         = 0x1000;
+const uint32_t DDSD_MIPMAPCOUNT         = 0x20000;
+const uint32_t DDPF_FOURCC              = 0x4;
+const uint32_t DDSCAPS_COMPLEX          = 0x8;
+const uint32_t DDSCAPS_TEXTURE          = 0x1000;
+const uint32_t DDSCAPS_MIPMAP           = 0x400000;
+const uint32_t DDSCAPS2_CUBEMAP_ALL     = 0x200 | 0xFC00;
+const uint32_t DDS_DIMENSION_TEXTURE2D  = 3;
+const uint32_t DDS_MISC_TEXTURECUBE     = 0x4;
+
+///////////////////////////////////////////////////////////////////////////////
+// DDSPixelFormat structure
+///////////////////////////////////////////////////////////////////////////////
+struct DDSPixelFormat
+{
+	uint32_t    Size;
+	uint32_t    Flags;
+	uint32_t    FourCC;
+	uint32_t    RGBBitCount;
+	uint32_t    RBitMask;
+	uint32_t    GBitMask;
+	uint32_t    BBitMask;
+	uint32_t    ABitMask;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// DDSHeader structure
+///////////////////////////////////////////////////////////////////////////////
+struct DDSHeader
+{
+	uint32_t        Size;
+	uint32_t        Flags;
+	uint32_t        Height;
+	uint32_t        Width;
+	uint32_t        PitchOrLinearSize;
+	uint32_t        Depth;
+	uint32_t        MipMapCount;
+	uint32_t        Reserved1[11];  // [0] 識別子, [1] バージョン, [2][3] キャッシュキーを格納します.
+	DDSPixelFormat  PixelFormat;
+	uint32_t        Caps;
+	uint32_t        Caps2;
+	uint32_t        Caps3;
+	uint32_t        Caps4;
+	uint32_t        Reserved2;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// DDSHeaderDX10 structure
+///////////////////////////////////////////////////////////////////////////////
+struct DDSHeaderDX10
+{
+	uint32_t    Format;
+	uint32_t    Dimension;
+	uint32_t    MiscFlag;
+	uint32_t    ArraySize;
+	uint32_t    MiscFlags2;
+};
+
+static_assert(sizeof(DDSHeader) == 124, "DDS header size mismatch.");
+static_assert(sizeof(DDSHeaderDX10) == 20, "DDS DX10 header size mismatch.");
+
+const size_t DDS_DATA_OFFSET = sizeof(uint32_t) + sizeof(DDSHeader) + sizeof(DDSHeaderDX10);
+
+//-----------------------------------------------------------------------------
+//      テクスチャの構成が一致するかどうかチェックします.
+//-----------------------------------------------------------------------------
+bool IsSameLayout(const IBLCache::Texture& a, const IBLCache::Texture& b)
+{
+	return a.Format    == b.Format
+		&& a.Width     == b.Width
+		&& a.Height    == b.Height
+		&& a.ArraySize == b.ArraySize
+		&& a.MipLevels == b.MipLevels
+		&& a.Cube      == b.Cube;
+}
+
+#if defined(_WIN32)
+//-----------------------------------------------------------------------------
+//      ファイル操作に渡すパスを取得します.
+//-----------------------------------------------------------------------------
+const std::wstring& ToFilePath(const std::wstring& path)
+{ return path; }
+
+//-----------------------------------------------------------------------------
+//      ファイルを削除します.
+//-----------------------------------------------------------------------------
+int RemoveFile(const std::wstring& path)
+{ return _wremove(path.c_str()); }
+
+//-----------------------------------------------------------------------------
+//      ファイル名を変更します.
+//-----------------------------------------------------------------------------
+int RenameFile(const std::wstring& from, const std::wstring& to)
+{ return _wrename(from.c_str(), to.c_str()); }
+#else
+//-----------------------------------------------------------------------------
+//      ファイル操作に渡すパスを取得します.
+//-----------------------------------------------------------------------------
+// ワイド文字のパスを開けないので, ロケールのマルチバイト文字列に変換します.
+std::string ToFilePath(const std::wstring& path)
+{
+	std::string result(path.size() * MB_LEN_MAX, '\0');
+	auto size = wcstombs(&result[0], path.c_str(), result.size());
+	result.resize((size == size_t(-1)) ? 0 : size);
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルを削除します.
+//-----------------------------------------------------------------------------
+int RemoveFile(const std::wstring& path)
+{ return remove(ToFilePath(path).c_str()); }
+
+//-----------------------------------------------------------------------------
+//      ファイル名を変更します.
+//-----------------------------------------------------------------------------
+int RenameFile(const std::wstring& from, const std::wstring& to)
+{ return rename(ToFilePath(from).c_str(), ToFilePath(to).c_str()); }
+#endif
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// IBLCache class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      DFGテクスチャのキャッシュキーを求めます.
+//-----------------------------------------------------------------------------
+uint64_t IBLCache::HashDFG(const Key& key)
+{
+	// DFG項は環境マップに依存しないので, 元テクスチャが変わっても使い回します.
+	auto hash = HashCombine(14695981039346656037ull, uint32_t(CacheVersion));
+	hash = HashCombine(hash, key.ShaderHash);
+	hash = HashCombine(hash, key.DFGSize);
+	hash = HashCombine(hash, key.DFGSamples);
+	return hash;
+}
+
+//-----------------------------------------------------------------------------
+//      LDテクスチャのキャッシュキーを求めます.
+//-----------------------------------------------------------------------------
+uint64_t IBLCache::HashLD(const Key& key)
+{
+	auto hash = HashCombine(14695981039346656037ull, uint32_t(CacheVersion));
+	hash = HashCombine(hash, key.SourceHash);
+	hash = HashCombine(hash, key.ShaderHash);
+	hash = HashCombine(hash, key.CubeSize);
+	hash = HashCombine(hash, key.CubeMipCount);
+	hash = HashCombine(hash, key.LDSize);
+	hash = HashCombine(hash, key.LDMipCount);
+	hash = HashCombine(hash, key.LDSamples);
+	return hash;
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルの内容のハッシュ値を求めます.
+//-----------------------------------------------------------------------------
+bool IBLCache::HashFile(const std::wstring& path, uint64_t& hash)
+{
+	std::ifstream stream(ToFilePath(path).c_str(), std::ios::binary);
+	if (!stream.is_open())
+	{
+		return false;
+	}
+
+	// 大きなファイルでもメモリを確保し直さないよう, 分割して読み込みます.
+	std::vector<char> buffer(1024 * 1024);
+	hash = 14695981039346656037ull;
+	while (stream)
+	{
+		stream.read(buffer.data(), std::streamsize(buffer.size()));
+		auto count = size_t(stream.gcount());
+		if (count == 0)
+		{ break; }
+
+		hash = HashBytes(buffer.data(), count, hash);
+	}
+
+	return stream.eof();
+}
+
+//-----------------------------------------------------------------------------
+//      キャッシュファイルのパスを求めます.
+//-----------------------------------------------------------------------------
+std::wstring IBLCache::MakePath(const std::wstring& dir, const wchar_t* tag, uint64_t hash)
+{
+	wchar_t name[17];
+	swprintf(name, 17, L"%016llx", static_cast<unsigned long long>(hash));
+
+	std::wstring path = dir;
+	if (!path.empty() && path.back() != L'/' && path.back() != L'\\')
+	{ path += L'/'; }
+
+	path += (tag != nullptr) ? tag : L"";
+	path += L'_';
+	path += name;
+	path += L".dds";
+	return path;
+}
+
+//-----------------------------------------------------------------------------
+//      1ピクセルあたりのバイト数を取得します.
+//-----------------------------------------------------------------------------
+size_t IBLCache::GetPixelSize(FORMAT format)
+{
+	switch (format)
+	{
+	case FORMAT_R32G32B32A32_FLOAT: return 16;
+	case FORMAT_R32G32_FLOAT:       return 8;
+	case FORMAT_R16G16B16A16_FLOAT: return 8;
+	case FORMAT_R16G16_FLOAT:       return 4;
+	default:                        return 0;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      テクスチャのピクセルデータのサイズを求めます.
+//-----------------------------------------------------------------------------
+size_t IBLCache::GetDataSize(const Texture& texture)
+{
+	auto pixelSize = GetPixelSize(texture.Format);
+	if (pixelSize == 0 || texture.Width == 0 || texture.Height == 0 || texture.ArraySize == 0 || texture.MipLevels == 0)
+	{ return 0; }
+
+	size_t size = 0;
+	for (auto m = 0u; m < texture.MipLevels; ++m)
+	{
+		auto w = (texture.Width  >> m) > 0 ? (texture.Width  >> m) : 1u;
+		auto h = (texture.Height >> m) > 0 ? (texture.Height >> m) : 1u;
+		size += size_t(w) * h * pixelSize;
+	}
+
+	return size * texture.ArraySize;
+}
+
+//-----------------------------------------------------------------------------
+//      DDSファイルのデータを構築します.
+//-----------------------------------------------------------------------------
+bool IBLCache::BuildDDS(const Texture& texture, uint64_t hash, std::vector<uint8_t>& file)
+{
+	auto dataSize = GetDataSize(texture);
+	if (dataSize == 0 || dataSize != texture.Pixels.size())
+	{ return false; }
+
+	if (texture.Cube && texture.ArraySize != 6)
+	{ return false; }
+
+	DDSHeader header = {};
+	header.Size              = sizeof(DDSHeader);
+	header.Flags             = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT;
+	header.Height            = texture.Height;
+	header.Width             = texture.Width;
+	header.Depth             = 1;
+	header.MipMapCount       = texture.MipLevels;
+	header.Reserved1[0]      = CacheMagic;
+	header.Reserved1[1]      = CacheVersion;
+	header.Reserved1[2]      = uint32_t(hash);
+	header.Reserved1[3]      = uint32_t(hash >> 32);
+	header.PixelFormat.Size  = sizeof(DDSPixelFormat);
+	header.PixelFormat.Flags = DDPF_FOURCC;
+	header.PixelFormat.FourCC = DDS_FOURCC_DX10;
+	header.Caps              = DDSCAPS_TEXTURE;
+
+	if (texture.MipLevels > 1)
+	{ header.Caps |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP; }
+
+	if (texture.Cube)
+	{
+		header.Caps  |= DDSCAPS_COMPLEX;
+		header.Caps2 |= DDSCAPS2_CUBEMAP_ALL;
+	}
+
+	// キューブマップの配列数は面の数ではなくキューブの数で表します.
+	DDSHeaderDX10 dx10 = {};
+	dx10.Format    = uint32_t(texture.Format);
+	dx10.Dimension = DDS_DIMENSION_TEXTURE2D;
+	dx10.MiscFlag  = texture.Cube ? DDS_MISC_TEXTURECUBE : 0;
+	dx10.ArraySize = texture.Cube ? texture.ArraySize / 6 : texture.ArraySize;
+
+	file.resize(DDS_DATA_OFFSET + dataSize);
+	auto ptr = file.data();
+	memcpy(ptr, &DDS_MAGIC, sizeof(DDS_MAGIC));     ptr += sizeof(DDS_MAGIC);
+	memcpy(ptr, &header, sizeof(header));           ptr += sizeof(header);
+	memcpy(ptr, &dx10, sizeof(dx10));               ptr += sizeof(dx10);
+	memcpy(ptr, texture.Pixels.data(), dataSize);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      DDSファイルのデータを検証して取り出します.
+//-----------------------------------------------------------------------------
+bool IBLCache::ParseDDS(const std::vector<uint8_t>& file, uint64_t hash, const Texture& expected, Texture& texture)
+{
+	if (file.size() < DDS_DATA_OFFSET)
+	{ return false; }
+
+	uint32_t      magic;
+	DDSHeader     header;
+	DDSHeaderDX10 dx10;
+
+	auto ptr = file.data();
+	memcpy(&magic, ptr, sizeof(magic));     ptr += sizeof(magic);
+	memcpy(&header, ptr, sizeof(header));   ptr += sizeof(header);
+	memcpy(&dx10, ptr, sizeof(dx10));
+
+	if (magic != DDS_MAGIC
+	 || header.Size != sizeof(DDSHeader)
+	 || header.PixelFormat.Size != sizeof(DDSPixelFormat)
+	 || (header.PixelFormat.Flags & DDPF_FOURCC) == 0
+	 || header.PixelFormat.FourCC != DDS_FOURCC_DX10
+	 || dx10.Dimension != DDS_DIMENSION_TEXTURE2D)
+	{ return false; }
+
+	// 別の条件でベイクしたファイルや, 他のツールで書き出したファイルは使いません.
+	auto fileHash = uint64_t(header.Reserved1[2]) | (uint64_t(header.Reserved1[3]) << 32);
+	if (header.Reserved1[0] != CacheMagic || header.Reserved1[1] != CacheVersion || fileHash != hash)
+	{ return false; }
+
+	Texture result;
+	result.Format    = FORMAT(dx10.Format);
+	result.Width     = header.Width;
+	result.Height    = header.Height;
+	result.Cube      = (dx10.MiscFlag & DDS_MISC_TEXTURECUBE) != 0;
+	result.ArraySize = result.Cube ? dx10.ArraySize * 6 : dx10.ArraySize;
+	result.MipLevels = (header.MipMapCount > 0) ? header.MipMapCount : 1;
+
+	if (!IsSameLayout(result, expected))
+	{ return false; }
+
+	auto dataSize = GetDataSize(result);
+	if (dataSize == 0 || file.size() != DDS_DATA_OFFSET + dataSize)
+	{ return false; }
+
+	result.Pixels.assign(file.begin() + DDS_DATA_OFFSET, file.end());
+	texture = std::move(result);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      テクスチャをキャッシュファイルに保存します.
+//-----------------------------------------------------------------------------
+bool IBLCache::Save(const std::wstring& path, uint64_t hash, const Texture& texture)
+{
+	std::vector<uint8_t> file;
+	if (!BuildDDS(texture, hash, file))
+	{
+		ELOG("Error : IBLCache::BuildDDS() Failed. path = %ls", path.c_str());
+		return false;
+	}
+
+	// 書き込み途中で終了しても壊れたファイルを読まないよう, 一時ファイルに書いてから置き換えます.
+	auto temp = path + L".tmp";
+	{
+		std::ofstream stream(ToFilePath(temp).c_str(), std::ios::binary | std::ios::trunc);
+		if (!stream.is_open())
+		{
+			ELOG("Error : File Open Failed. path = %ls", temp.c_str());
+			return false;
+		}
+
+		stream.write(reinterpret_cast<const char*>(file.data()), std::streamsize(file.size()));
+		if (!stream.good())
+		{
+			ELOG("Error : File Write Failed. path = %ls", temp.c_str());
+			return false;
+		}
+	}
+
+	RemoveFile(path);
+	if (RenameFile(temp, path) != 0)
+	{
+		ELOG("Error : File Rename Failed. path = %ls", path.c_str());
+		RemoveFile(temp);
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      キャッシュファイルからテクスチャを読み込みます.
+//-----------------------------------------------------------------------------
+bool IBLCache::Load(const std::wstring& path, uint64_t hash, const Texture& expected, Texture& texture)
+{
+	std::ifstream stream(ToFilePath(path).c_str(), std::ios::binary | std::ios::ate);
+	if (!stream.is_open())
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> file(size_t(stream.tellg()));
+	stream.seekg(0, std::ios::beg);
+	stream.read(reinterpret_cast<char*>(file.data()), std::streamsize(file.size()));
+	if (!stream.good())
+	{
+		ELOG("Warning : File Read Failed. path = %ls", path.c_str());
+		return false;
+	}
+
+	if (!ParseDDS(file, hash, expected, texture))
+	{
+		ELOG("Warning : IBL Cache Invalid. path = %ls", path.c_str());
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,726 @@
+﻿//-----------------------------------------------------------------------------
+// File : IBLReferenceBaker.cpp
+// Desc : CPU Reference Baker For IBL Textures.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <IBLReferenceBaker.h>
+#include <xmmintrin.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cmath>
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const float     F_PI        = 3.14159265358979323f;
+const uint32_t  MaxMipCount = 16;
+
+///////////////////////////////////////////////////////////////////////////////
+// CubeView structure
+///////////////////////////////////////////////////////////////////////////////
+struct CubeView
+{
+	const float*    pPixels;                    //!< 先頭のピクセルです.
+	uint32_t        MipLevels;                  //!< ミップレベル数です.
+	size_t          SliceSize;                  //!< 1面あたりの要素数です.
+	size_t          MipOffset[MaxMipCount];     //!< 面の先頭からミップレベルまでの要素数です.
+	uint32_t        MipSize  [MaxMipCount];     //!< ミップレベルのサイズです.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// SampleSet structure
+///////////////////////////////////////////////////////////////////////////////
+struct SampleSet
+{
+	std::vector<float>  Lx;         //!< 接空間のライトベクトルです.
+	std::vector<float>  Ly;         //!< 接空間のライトベクトルです.
+	std::vector<float>  Lz;         //!< 接空間のライトベクトルです.
+	std::vector<float>  Weight;     //!< NdotL です. 端数は 0 です.
+	std::vector<float>  Lod;        //!< 入力キューブマップのミップレベルです.
+	float               WeightSum;  //!< 重みの合計です.
+};
+
+//-----------------------------------------------------------------------------
+//      処理を複数スレッドに分配します.
+//-----------------------------------------------------------------------------
+template<typename Func>
+void ParallelFor(uint32_t count, uint32_t threadCount, Func func)
+{
+	if (threadCount == 0)
+	{ threadCount = std::max(1u, std::thread::hardware_concurrency()); }
+	threadCount = std::max(1u, std::min(threadCount, count));
+
+	// ミップレベルによって1行の処理量が異なるので, 空いたスレッドから順に取り出します.
+	std::atomic<uint32_t> next(0);
+	auto run = [&]()
+	{
+		for (;;)
+		{
+			auto index = next.fetch_add(1);
+			if (index >= count)
+			{ break; }
+
+			func(index);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount - 1);
+	for (auto i = 1u; i < threadCount; ++i)
+	{ threads.emplace_back(run); }
+
+	run();
+
+	for (auto& thread : threads)
+	{ thread.join(); }
+}
+
+//-----------------------------------------------------------------------------
+//      GGXの法線分布関数です(BRDF.hlsli と同じ).
+//-----------------------------------------------------------------------------
+float D_GGX(float a, float NH)
+{
+	float a2  = a * a;
+	float NH2 = NH * NH;
+	float f   = (NH2 * ((a2 - 1) * NH + 1));
+	return a2 / (F_PI * f * f);
+}
+
+//-----------------------------------------------------------------------------
+//      Height Correlated Smith による幾何減衰項です(BRDF.hlsli と同じ).
+//-----------------------------------------------------------------------------
+float G2_Smith(float NL, float NV, float a)
+{
+	float a2  = a * a;
+	float NL2 = NL * NL;
+	float NV2 = NV * NV;
+
+	float lambda_v = (-1.0f + sqrtf(a2 * (1.0f - NL2) / std::max(NL2, 1e-8f) + 1.0f)) * 0.5f;
+	float lambda_l = (-1.0f + sqrtf(a2 * (1.0f - NV2) / std::max(NV2, 1e-8f) + 1.0f)) * 0.5f;
+
+	return 1.0f / std::max(1.0f + lambda_v + lambda_l, 1e-8f);
+}
+
+//-----------------------------------------------------------------------------
+//      正規直交基底を求めます(BakeUtil.hlsli と同じ).
+//-----------------------------------------------------------------------------
+void TangentSpace(const float N[3], float T[3], float B[3])
+{
+	float s = (N[2] >= 0.0f) ? 1.0f : -1.0f;
+	float a = -1.0f / (s + N[2]);
+	float b = N[0] * N[1] * a;
+	T[0] = 1.0f + s * N[0] * N[0] * a;
+	T[1] = s * b;
+	T[2] = -s * N[0];
+	B[0] = b;
+	B[1] = s + N[1] * N[1] * a;
+	B[2] = -N[1];
+}
+
+//-----------------------------------------------------------------------------
+//      接空間でGGXの形状にもとづくハーフベクトルを求めます(BakeUtil.hlsli と同じ).
+//-----------------------------------------------------------------------------
+void SampleGGXLocal(uint32_t index, float a, float H[3])
+{
+	float u0 = float(index) / float(IBLReferenceBaker::SequenceCount);
+	float u1 = IBLReferenceBaker::RadicalInverse(index);
+
+	float phi      = 2.0f * F_PI * u0;
+	float cosTheta = sqrtf((1.0f - u1) / std::max(u1 * (a * a - 1.0f) + 1.0f, 1e-8f));
+	float sinTheta = sqrtf(std::max(1.0f - cosTheta * cosTheta, 0.0f));
+
+	H[0] = sinTheta * cosf(phi);
+	H[1] = sinTheta * sinf(phi);
+	H[2] = cosTheta;
+}
+
+//-----------------------------------------------------------------------------
+//      ベクトルを正規化します.
+//-----------------------------------------------------------------------------
+void Normalize(float v[3])
+{
+	auto invLen = 1.0f / sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+	v[0] *= invLen;
+	v[1] *= invLen;
+	v[2] *= invLen;
+}
+
+//-----------------------------------------------------------------------------
+//      キューブマップの参照を構築します.
+//-----------------------------------------------------------------------------
+bool MakeCubeView(const IBLCache::Texture& texture, CubeView& view)
+{
+	if (texture.Format != IBLCache::FORMAT_R32G32B32A32_FLOAT
+	 || texture.ArraySize != 6
+	 || texture.Width == 0
+	 || texture.Width != texture.Height
+	 || texture.MipLevels == 0
+	 || texture.MipLevels > MaxMipCount
+	 || texture.Pixels.size() != IBLCache::GetDataSize(texture))
+	{ return false; }
+
+	view.pPixels   = reinterpret_cast<const float*>(texture.Pixels.data());
+	view.MipLevels = texture.MipLevels;
+
+	size_t offset = 0;
+	for (auto m = 0u; m < texture.MipLevels; ++m)
+	{
+		auto size = std::max(texture.Width >> m, 1u);
+		view.MipOffset[m] = offset;
+		view.MipSize  [m] = size;
+		offset += size_t(size) * size * 4;
+	}
+	view.SliceSize = offset;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      方向から面番号と面内の座標 [-1, 1] を求めます.
+//-----------------------------------------------------------------------------
+inline void SelectFace(float x, float y, float z, uint32_t& face, float& s, float& t)
+{
+	auto ax = fabsf(x);
+	auto ay = fabsf(y);
+	auto az = fabsf(z);
+
+	if (az >= ax && az >= ay)
+	{
+		auto inv = 1.0f / az;
+		face = (z >= 0.0f) ? 4 : 5;
+		s    = ((z >= 0.0f) ? x : -x) * inv;
+		t    = -y * inv;
+	}
+	else if (ay >= ax)
+	{
+		auto inv = 1.0f / ay;
+		face = (y >= 0.0f) ? 2 : 3;
+		s    = x * inv;
+		t    = ((y >= 0.0f) ? z : -z) * inv;
+	}
+	else
+	{
+		auto inv = 1.0f / ax;
+		face = (x >= 0.0f) ? 0 : 1;
+		s    = ((x >= 0.0f) ? -z : z) * inv;
+		t    = -y * inv;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      1つの面をバイリニアでサンプルします. RGBA を1つのレジスタで補間します.
+//-----------------------------------------------------------------------------
+inline __m128 SampleBilinear(const CubeView& view, uint32_t face, uint32_t mip, float s, float t)
+{
+	auto size  = int(view.MipSize[mip]);
+	auto pFace = view.pPixels + face * view.SliceSize + view.MipOffset[mip];
+
+	auto fx = (s * 0.5f + 0.5f) * float(size) - 0.5f;
+	auto fy = (t * 0.5f + 0.5f) * float(size) - 0.5f;
+	auto bx = floorf(fx);
+	auto by = floorf(fy);
+	auto wx = _mm_set1_ps(fx - bx);
+	auto wy = _mm_set1_ps(fy - by);
+
+	auto x0 = std::min(std::max(int(bx),     0), size - 1);
+	auto x1 = std::min(std::max(int(bx) + 1, 0), size - 1);
+	auto y0 = std::min(std::max(int(by),     0), size - 1);
+	auto y1 = std::min(std::max(int(by) + 1, 0), size - 1);
+
+	auto p00 = _mm_loadu_ps(pFace + (size_t(y0) * size + x0) * 4);
+	auto p10 = _mm_loadu_ps(pFace + (size_t(y0) * size + x1) * 4);
+	auto p01 = _mm_loadu_ps(pFace + (size_t(y1) * size + x0) * 4);
+	auto p11 = _mm_loadu_ps(pFace + (size_t(y1) * size + x1) * 4);
+
+	auto top    = _mm_add_ps(p00, _mm_mul_ps(_mm_sub_ps(p10, p00), wx));
+	auto bottom = _mm_add_ps(p01, _mm_mul_ps(_mm_sub_ps(p11, p01), wx));
+	return _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), wy));
+}
+
+//-----------------------------------------------------------------------------
+//      キューブマップをトライリニアでサンプルします.
+//-----------------------------------------------------------------------------
+inline __m128 SampleLevel(const CubeView& view, float x, float y, float z, float lod)
+{
+	uint32_t face;
+	float s, t;
+	SelectFace(x, y, z, face, s, t);
+
+	lod = std::min(std::max(lod, 0.0f), float(view.MipLevels - 1));
+	auto mip  = uint32_t(lod);
+	auto frac = lod - float(mip);
+
+	auto result = SampleBilinear(view, face, mip, s, t);
+	if (frac > 0.0f && mip + 1 < view.MipLevels)
+	{
+		auto next = SampleBilinear(view, face, mip + 1, s, t);
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_sub_ps(next, result), _mm_set1_ps(frac)));
+	}
+
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      出力ミップレベルのサンプルを接空間で求めます.
+//-----------------------------------------------------------------------------
+void BuildSampleSet(float a, uint32_t sampleCount, float omegaP, float maxLod, SampleSet& set)
+{
+	set.Lx.clear();
+	set.Ly.clear();
+	set.Lz.clear();
+	set.Weight.clear();
+	set.Lod.clear();
+	set.WeightSum = 0.0f;
+
+	for (auto i = 0u; i < sampleCount; ++i)
+	{
+		float H[3];
+		SampleGGXLocal(i, a, H);
+
+		// N = V = (0, 0, 1) なので L = 2 * dot(V, H) * H - V です.
+		float L[3] = { 2.0f * H[2] * H[0], 2.0f * H[2] * H[1], 2.0f * H[2] * H[2] - 1.0f };
+		Normalize(L);
+
+		auto NdotL = std::min(std::max(L[2], 0.0f), 1.0f);
+		if (NdotL <= 0.0f)
+		{ continue; }
+
+		auto pdf    = D_GGX(NdotL, a) * NdotL;
+		auto omegaS = 1.0f / std::max(sampleCount * pdf, 1e-8f);
+		auto lod    = 0.5f * (log2f(omegaS) - log2f(omegaP)) + 1.0f;
+
+		set.Lx    .push_back(L[0]);
+		set.Ly    .push_back(L[1]);
+		set.Lz    .push_back(L[2]);
+		set.Weight.push_back(NdotL);
+		set.Lod   .push_back(std::min(std::max(lod, 0.0f), maxLod));
+		set.WeightSum += NdotL;
+	}
+
+	// 4つずつ処理できるよう重み 0 のサンプルで埋めます.
+	while (set.Weight.size() % 4 != 0)
+	{
+		set.Lx    .push_back(0.0f);
+		set.Ly    .push_back(0.0f);
+		set.Lz    .push_back(1.0f);
+		set.Weight.push_back(0.0f);
+		set.Lod   .push_back(0.0f);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      レジスタの4要素の合計を求めます.
+//-----------------------------------------------------------------------------
+inline float HorizontalSum(__m128 value)
+{
+	alignas(16) float lanes[4];
+	_mm_store_ps(lanes, value);
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// IBLReferenceBaker class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      ビットを反転した値を [0, 1) に変換します.
+//-----------------------------------------------------------------------------
+float IBLReferenceBaker::RadicalInverse(uint32_t index)
+{
+	auto bits = index;
+	bits = (bits << 16) | (bits >> 16);
+	bits = ((bits & 0x55555555u) << 1) | ((bits & 0xAAAAAAAAu) >> 1);
+	bits = ((bits & 0x33333333u) << 2) | ((bits & 0xCCCCCCCCu) >> 2);
+	bits = ((bits & 0x0F0F0F0Fu) << 4) | ((bits & 0xF0F0F0F0u) >> 4);
+	bits = ((bits & 0x00FF00FFu) << 8) | ((bits & 0xFF00FF00u) >> 8);
+	return float(bits) * 2.3283064365386963e-10f;
+}
+
+//-----------------------------------------------------------------------------
+//      DFG項を積分します.
+//-----------------------------------------------------------------------------
+bool IBLReferenceBaker::IntegrateDFG(uint32_t size, uint32_t sampleCount, uint32_t threadCount, IBLCache::Texture& result)
+{
+	if (size == 0 || sampleCount == 0)
+	{ return false; }
+
+	// サンプル番号だけで決まる値は全テクセルで共通なので先に求めます. 端数は無効なサンプルです.
+	auto padded = (sampleCount + 3) & ~3u;
+	std::vector<float> cosPhi(padded, 0.0f);
+	std::vector<float> u1    (padded, 0.0f);
+	std::vector<float> valid (padded, 0.0f);
+	for (auto i = 0u; i < sampleCount; ++i)
+	{
+		cosPhi[i] = cosf(2.0f * F_PI * (float(i) / float(SequenceCount)));
+		u1    [i] = RadicalInverse(i);
+		valid [i] = 1.0f;
+	}
+
+	result.Format    = IBLCache::FORMAT_R32G32_FLOAT;
+	result.Width     = size;
+	result.Height    = size;
+	result.ArraySize = 1;
+	result.MipLevels = 1;
+	result.Cube      = false;
+	result.Pixels.resize(IBLCache::GetDataSize(result));
+
+	auto pOut = reinterpret_cast<float*>(result.Pixels.data());
+
+	ParallelFor(size, threadCount, [&](uint32_t y)
+	{
+		auto roughness = 1.0f - (float(y) + 0.5f) / float(size);
+		auto a         = roughness * roughness;
+
+		const auto one     = _mm_set1_ps(1.0f);
+		const auto zero    = _mm_setzero_ps();
+		const auto half    = _mm_set1_ps(0.5f);
+		const auto epsilon = _mm_set1_ps(1e-8f);
+		const auto a2m1    = _mm_set1_ps(a * a - 1.0f);
+		const auto r2      = _mm_set1_ps(roughness * roughness);
+
+		for (auto x = 0u; x < size; ++x)
+		{
+			auto NdotV = (float(x) + 0.5f) / float(size);
+
+			// V は XZ 平面上にあり, N = (0, 0, 1) なので H の Y 成分は使いません.
+			auto Vx = _mm_set1_ps(sqrtf(1.0f - NdotV * NdotV));
+			auto Vz = _mm_set1_ps(NdotV);
+
+			// G2_Smith() の NdotV 側の項はテクセルごとに一定です.
+			auto NV2     = NdotV * NdotV;
+			auto lambdaL = _mm_set1_ps((-1.0f + sqrtf(roughness * roughness * (1.0f - NV2) / std::max(NV2, 1e-8f) + 1.0f)) * 0.5f);
+
+			auto accX = zero;
+			auto accY = zero;
+			for (auto i = 0u; i < padded; i += 4)
+			{
+				auto u        = _mm_loadu_ps(&u1[i]);
+				auto cos2     = _mm_div_ps(_mm_sub_ps(one, u), _mm_max_ps(_mm_add_ps(_mm_mul_ps(u, a2m1), one), epsilon));
+				auto cosTheta = _mm_sqrt_ps(cos2);
+				auto sinTheta = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(one, cos2), zero));
+
+				auto Hx    = _mm_mul_ps(sinTheta, _mm_loadu_ps(&cosPhi[i]));
+				auto Hz    = cosTheta;
+				auto VdotH = _mm_add_ps(_mm_mul_ps(Vx, Hx), _mm_mul_ps(Vz, Hz));
+				auto NdotL = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(VdotH, VdotH), Hz), Vz);
+				auto mask  = _mm_and_ps(_mm_cmpgt_ps(NdotL, zero), _mm_cmpgt_ps(_mm_loadu_ps(&valid[i]), half));
+
+				auto NdotH  = _mm_min_ps(_mm_max_ps(Hz,    zero), one);
+				auto VdotHs = _mm_min_ps(_mm_max_ps(VdotH, zero), one);
+
+				auto NL2     = _mm_mul_ps(NdotL, NdotL);
+				auto lambdaV = _mm_mul_ps(_mm_sub_ps(_mm_sqrt_ps(_mm_add_ps(_mm_div_ps(_mm_mul_ps(r2, _mm_sub_ps(one, NL2)), _mm_max_ps(NL2, epsilon)), one)), one), half);
+				auto G       = _mm_div_ps(one, _mm_max_ps(_mm_add_ps(_mm_add_ps(one, lambdaV), lambdaL), epsilon));
+				auto GVis    = _mm_div_ps(_mm_mul_ps(G, VdotHs), _mm_max_ps(_mm_mul_ps(Vz, NdotH), epsilon));
+
+				auto f1 = _mm_sub_ps(one, VdotHs);
+				auto f2 = _mm_mul_ps(f1, f1);
+				auto Fc = _mm_mul_ps(_mm_mul_ps(f2, f2), f1);
+
+				accX = _mm_add_ps(accX, _mm_and_ps(mask, _mm_mul_ps(_mm_sub_ps(one, Fc), GVis)));
+				accY = _mm_add_ps(accY, _mm_and_ps(mask, _mm_mul_ps(Fc, GVis)));
+			}
+
+			auto pTexel = pOut + (size_t(y) * size + x) * 2;
+			pTexel[0] = HorizontalSum(accX) / float(sampleCount);
+			pTexel[1] = HorizontalSum(accY) / float(sampleCount);
+		}
+	});
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      スペキュラーのLD項を積分します.
+//-----------------------------------------------------------------------------
+bool IBLReferenceBaker::IntegrateSpecularLD
+(
+	const IBLCache::Texture&    input,
+	uint32_t                    size,
+	uint32_t                    mipCount,
+	uint32_t                    sampleCount,
+	uint32_t                    threadCount,
+	IBLCache::Texture&          result
+)
+{
+	CubeView view;
+	if (!MakeCubeView(input, view) || size == 0 || mipCount < 2 || mipCount > MaxMipCount || sampleCount == 0)
+	{ return false; }
+
+	result.Format    = IBLCache::FORMAT_R32G32B32A32_FLOAT;
+	result.Width     = size;
+	result.Height    = size;
+	result.ArraySize = 6;
+	result.MipLevels = mipCount;
+	result.Cube      = true;
+	result.Pixels.resize(IBLCache::GetDataSize(result));
+
+	CubeView output;
+	MakeCubeView(result, output);
+
+	// IBLBaker::IntegrateLD() と同じくラフネスを加算で求め, 2乗した値を使います.
+	auto omegaP = (4.0f * F_PI) / (6.0f * float(input.Width) * float(input.Width));
+	auto maxLod = float(input.MipLevels - 1);
+	auto step   = 1.0f / float(mipCount - 1);
+
+	std::vector<SampleSet> sets(mipCount);
+	auto roughness = 0.0f;
+	for (auto m = 0u; m < mipCount; ++m)
+	{
+		if (m > 0)
+		{ BuildSampleSet(roughness * roughness, sampleCount, omegaP, maxLod, sets[m]); }
+
+		roughness += step;
+	}
+
+	// 面・ミップレベル・行を1つの作業単位にします.
+	struct Row
+	{
+		uint32_t    Face;
+		uint32_t    Mip;
+		uint32_t    Y;
+	};
+
+	std::vector<Row> rows;
+	for (auto f = 0u; f < 6; ++f)
+	{
+		for (auto m = 0u; m < mipCount; ++m)
+		{
+			for (auto y = 0u; y < output.MipSize[m]; ++y)
+			{ rows.push_back({ f, m, y }); }
+		}
+	}
+
+	auto pOut = reinterpret_cast<float*>(result.Pixels.data());
+
+	ParallelFor(uint32_t(rows.size()), threadCount, [&](uint32_t index)
+	{
+		const auto& row = rows[index];
+		const auto& set = sets[row.Mip];
+		auto mipSize = output.MipSize[row.Mip];
+		auto pRow    = pOut + row.Face * output.SliceSize + output.MipOffset[row.Mip] + size_t(row.Y) * mipSize * 4;
+
+		alignas(16) float Lx[4], Ly[4], Lz[4];
+
+		for (auto x = 0u; x < mipSize; ++x)
+		{
+			float N[3];
+			GetTexelDirection(row.Face, x, row.Y, mipSize, N);
+
+			__m128 color;
+			if (row.Mip == 0)
+			{
+				// ラフネス 0 は積分せずにそのままサンプルします.
+				color = SampleLevel(view, N[0], N[1], N[2], 0.0f);
+			}
+			else
+			{
+				float T[3], B[3];
+				TangentSpace(N, T, B);
+
+				auto acc = _mm_setzero_ps();
+				for (size_t i = 0; i < set.Weight.size(); i += 4)
+				{
+					// 接空間のライトベクトルを4つずつワールド空間に変換します.
+					auto lx = _mm_loadu_ps(&set.Lx[i]);
+					auto ly = _mm_loadu_ps(&set.Ly[i]);
+					auto lz = _mm_loadu_ps(&set.Lz[i]);
+					_mm_store_ps(Lx, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(T[0]), lx), _mm_mul_ps(_mm_set1_ps(B[0]), ly)), _mm_mul_ps(_mm_set1_ps(N[0]), lz)));
+					_mm_store_ps(Ly, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(T[1]), lx), _mm_mul_ps(_mm_set1_ps(B[1]), ly)), _mm_mul_ps(_mm_set1_ps(N[1]), lz)));
+					_mm_store_ps(Lz, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(T[2]), lx), _mm_mul_ps(_mm_set1_ps(B[2]), ly)), _mm_mul_ps(_mm_set1_ps(N[2]), lz)));
+
+					for (auto j = 0u; j < 4; ++j)
+					{
+						auto weight = set.Weight[i + j];
+						if (weight <= 0.0f)
+						{ continue; }
+
+						auto sample = SampleLevel(view, Lx[j], Ly[j], Lz[j], set.Lod[i + j]);
+						acc = _mm_add_ps(acc, _mm_mul_ps(sample, _mm_set1_ps(weight)));
+					}
+				}
+
+				color = (set.WeightSum > 0.0f) ? _mm_div_ps(acc, _mm_set1_ps(set.WeightSum)) : acc;
+			}
+
+			// IntegrateSpecularLD_PS と同じくアルファは 1 です.
+			alignas(16) float rgba[4];
+			_mm_store_ps(rgba, color);
+			pRow[x * 4 + 0] = rgba[0];
+			pRow[x * 4 + 1] = rgba[1];
+			pRow[x * 4 + 2] = rgba[2];
+			pRow[x * 4 + 3] = 1.0f;
+		}
+	});
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      1テクセル分のDFG項を積分します.
+//-----------------------------------------------------------------------------
+void IBLReferenceBaker::IntegrateDFGTexel(float NdotV, float roughness, uint32_t sampleCount, float result[2])
+{
+	const float N[3] = { 0.0f, 0.0f, 1.0f };
+	const float V[3] = { sqrtf(1.0f - NdotV * NdotV), 0.0f, NdotV };
+	float a = roughness * roughness;
+
+	float T[3], B[3];
+	TangentSpace(N, T, B);
+
+	float acc[2] = {};
+	for (auto i = 0u; i < sampleCount; ++i)
+	{
+		float h[3];
+		SampleGGXLocal(i, a, h);
+
+		float H[3];
+		for (auto k = 0; k < 3; ++k)
+		{ H[k] = T[k] * h[0] + B[k] * h[1] + N[k] * h[2]; }
+		Normalize(H);
+
+		auto VdotH = V[0] * H[0] + V[1] * H[1] + V[2] * H[2];
+		float L[3];
+		for (auto k = 0; k < 3; ++k)
+		{ L[k] = 2.0f * VdotH * H[k] - V[k]; }
+		Normalize(L);
+
+		auto NdotL = L[2];
+		if (NdotL > 0.0f)
+		{
+			auto NdotH  = std::min(std::max(H[2],  0.0f), 1.0f);
+			auto VdotHs = std::min(std::max(VdotH, 0.0f), 1.0f);
+
+			auto G    = G2_Smith(NdotL, NdotV, roughness);
+			auto GVis = G * VdotHs / std::max(NdotV * NdotH, 1e-8f);
+			auto Fc   = powf(1.0f - VdotHs, 5.0f);
+
+			acc[0] += (1 - Fc) * GVis;
+			acc[1] += Fc * GVis;
+		}
+	}
+
+	result[0] = acc[0] / float(sampleCount);
+	result[1] = acc[1] / float(sampleCount);
+}
+
+//-----------------------------------------------------------------------------
+//      1テクセル分のスペキュラーのLD項を積分します.
+//-----------------------------------------------------------------------------
+void IBLReferenceBaker::IntegrateSpecularTexel(const IBLCache::Texture& input, const float dir[3], float a, uint32_t sampleCount, float result[3])
+{
+	result[0] = result[1] = result[2] = 0.0f;
+
+	CubeView view;
+	if (!MakeCubeView(input, view))
+	{ return; }
+
+	alignas(16) float rgba[4];
+	if (a == 0.0f)
+	{
+		_mm_store_ps(rgba, SampleLevel(view, dir[0], dir[1], dir[2], 0.0f));
+		result[0] = rgba[0]; result[1] = rgba[1]; result[2] = rgba[2];
+		return;
+	}
+
+	const float* N = dir;
+	const float* V = dir;
+
+	float T[3], B[3];
+	TangentSpace(N, T, B);
+
+	auto omegaP   = (4.0f * F_PI) / (6.0f * float(input.Width) * float(input.Width));
+	auto mipCount = float(input.MipLevels - 1);
+
+	float acc[3]  = {};
+	float accWeight = 0.0f;
+	for (auto i = 0u; i < sampleCount; ++i)
+	{
+		float h[3];
+		SampleGGXLocal(i, a, h);
+
+		float H[3];
+		for (auto k = 0; k < 3; ++k)
+		{ H[k] = T[k] * h[0] + B[k] * h[1] + N[k] * h[2]; }
+		Normalize(H);
+
+		auto VdotH = V[0] * H[0] + V[1] * H[1] + V[2] * H[2];
+		float L[3];
+		for (auto k = 0; k < 3; ++k)
+		{ L[k] = 2.0f * VdotH * H[k] - V[k]; }
+		Normalize(L);
+
+		auto NdotL = std::min(std::max(N[0] * L[0] + N[1] * L[1] + N[2] * L[2], 0.0f), 1.0f);
+		if (NdotL > 0.0f)
+		{
+			auto pdf      = D_GGX(NdotL, a) * NdotL;
+			auto omegaS   = 1.0f / std::max(sampleCount * pdf, 1e-8f);
+			auto l        = 0.5f * (log2f(omegaS) - log2f(omegaP)) + 1.0f;
+			auto mipLevel = std::min(std::max(l, 0.0f), mipCount);
+
+			_mm_store_ps(rgba, SampleLevel(view, L[0], L[1], L[2], mipLevel));
+			acc[0] += rgba[0] * NdotL;
+			acc[1] += rgba[1] * NdotL;
+			acc[2] += rgba[2] * NdotL;
+			accWeight += NdotL;
+		}
+	}
+
+	if (accWeight == 0.0f)
+	{ return; }
+
+	result[0] = acc[0] / accWeight;
+	result[1] = acc[1] / accWeight;
+	result[2] = acc[2] / accWeight;
+}
+
+//-----------------------------------------------------------------------------
+//      キューブマップをトライリニアでサンプルします.
+//-----------------------------------------------------------------------------
+void IBLReferenceBaker::SampleCube(const IBLCache::Texture& input, const float dir[3], float lod, float result[4])
+{
+	CubeView view;
+	if (!MakeCubeView(input, view))
+	{
+		result[0] = result[1] = result[2] = result[3] = 0.0f;
+		return;
+	}
+
+	_mm_storeu_ps(result, SampleLevel(view, dir[0], dir[1], dir[2], lod));
+}
+
+//-----------------------------------------------------------------------------
+//      キューブマップのテクセルの方向を求めます.
+//-----------------------------------------------------------------------------
+void IBLReferenceBaker::GetTexelDirection(uint32_t face, uint32_t x, uint32_t y, uint32_t size, float dir[3])
+{
+	// IBLBaker の全画面三角形は上端が v = 1 になります.
+	auto px = 2.0f * ((float(x) + 0.5f) / float(size)) - 1.0f;
+	auto py = 2.0f * (1.0f - (float(y) + 0.5f) / float(size)) - 1.0f;
+
+	switch (face)
+	{
+	case 0 : { dir[0] =  1.0f; dir[1] =  py;   dir[2] = -px;   } break;
+	case 1 : { dir[0] = -1.0f; dir[1] =  py;   dir[2] =  px;   } break;
+	case 2 : { dir[0] =  px;   dir[1] =  1.0f; dir[2] = -py;   } break;
+	case 3 : { dir[0] =  px;   dir[1] = -1.0f; dir[2] =  py;   } break;
+	case 4 : { dir[0] =  px;   dir[1] =  py;   dir[2] =  1.0f; } break;
+	default: { dir[0] = -px;   dir[1] =  py;   dir[2] = -1.0f; } break;
+	}
+
+	Normalize(dir);
+}
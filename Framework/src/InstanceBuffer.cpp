@@ -0,0 +1,230 @@
+﻿//-----------------------------------------------------------------------------
+// File : InstanceBuffer.cpp
+// Desc : Per-Frame Instance Data Buffer Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <InstanceBuffer.h>
+#include <DescriptorPool.h>
+#include <Logger.h>
+
+static_assert(sizeof(InstanceData) % 16 == 0, "InstanceData must be 16 byte aligned.");
+
+///////////////////////////////////////////////////////////////////////////////
+// InstanceBuffer class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+InstanceBuffer::InstanceBuffer()
+	: m_pBuffer()
+	, m_pMappedPtr(nullptr)
+	, m_pPool(nullptr)
+	, m_Capacity(0)
+	, m_FrameIndex(0)
+	, m_Used(0)
+{
+	for (auto i = 0u; i < App::FrameCount; ++i)
+	{
+		m_pHandle[i] = nullptr;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+InstanceBuffer::~InstanceBuffer()
+{
+	Term();
+}
+
+//-----------------------------------------------------------------------------
+//      初期化処理を行います.
+//-----------------------------------------------------------------------------
+bool InstanceBuffer::Init(ID3D12Device* pDevice, DescriptorPool* pPool, uint32_t capacity)
+{
+	if (pDevice == nullptr || pPool == nullptr || capacity == 0)
+	{
+		ELOG("Error : Invalid Argument.");
+		return false;
+	}
+
+	Term();
+
+	m_pPool = pPool;
+	m_pPool->AddRef();
+
+	m_Capacity = capacity;
+
+	// ヒーププロパティ.
+	D3D12_HEAP_PROPERTIES prop = {};
+	prop.Type                 = D3D12_HEAP_TYPE_UPLOAD;
+	prop.CPUPageProperty      = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	prop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	prop.CreationNodeMask     = 1;
+	prop.VisibleNodeMask      = 1;
+
+	// リソースの設定. フレームごとの領域を連続して確保する.
+	D3D12_RESOURCE_DESC desc = {};
+	desc.Dimension          = D3D12_RESOURCE_DIMENSION_BUFFER;
+	desc.Alignment          = 0;
+	desc.Width              = UINT64(sizeof(InstanceData)) * capacity * App::FrameCount;
+	desc.Height             = 1;
+	desc.DepthOrArraySize   = 1;
+	desc.MipLevels          = 1;
+	desc.Format             = DXGI_FORMAT_UNKNOWN;
+	desc.SampleDesc.Count   = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Layout             = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	desc.Flags              = D3D12_RESOURCE_FLAG_NONE;
+
+	auto hr = pDevice->CreateCommittedResource(
+		&prop,
+		D3D12_HEAP_FLAG_NONE,
+		&desc,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(m_pBuffer.GetAddressOf()));
+	if (FAILED(hr))
+	{
+		ELOG("Error : ID3D12Device::CreateCommittedResource() Failed. retcode = 0x%x", hr);
+		return false;
+	}
+
+	// メモリマッピングしておきます.
+	hr = m_pBuffer->Map(0, nullptr, reinterpret_cast<void**>(&m_pMappedPtr));
+	if (FAILED(hr))
+	{
+		ELOG("Error : ID3D12Resource::Map() Failed. retcode = 0x%x", hr);
+		return false;
+	}
+
+	// フレームごとにストラクチャードバッファのビューを生成.
+	for (auto i = 0u; i < App::FrameCount; ++i)
+	{
+		m_pHandle[i] = pPool->AllocHandle();
+		if (m_pHandle[i] == nullptr)
+		{
+			ELOG("Error : DescriptorPool::AllocHandle() Failed.");
+			return false;
+		}
+
+		D3D12_SHADER_RESOURCE_VIEW_DESC viewDesc = {};
+		viewDesc.Format                     = DXGI_FORMAT_UNKNOWN;
+		viewDesc.ViewDimension              = D3D12_SRV_DIMENSION_BUFFER;
+		viewDesc.Shader4ComponentMapping    = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+		viewDesc.Buffer.FirstElement        = UINT64(capacity) * i;
+		viewDesc.Buffer.NumElements         = capacity;
+		viewDesc.Buffer.StructureByteStride = sizeof(InstanceData);
+		viewDesc.Buffer.Flags               = D3D12_BUFFER_SRV_FLAG_NONE;
+
+		pDevice->CreateShaderResourceView(m_pBuffer.Get(), &viewDesc, m_pHandle[i]->HandleCPU);
+	}
+
+	m_FrameIndex = 0;
+	m_Used       = 0;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      終了処理を行います.
+//-----------------------------------------------------------------------------
+void InstanceBuffer::Term()
+{
+	if (m_pBuffer != nullptr)
+	{
+		m_pBuffer->Unmap(0, nullptr);
+		m_pBuffer.Reset();
+	}
+
+	if (m_pPool != nullptr)
+	{
+		for (auto i = 0u; i < App::FrameCount; ++i)
+		{
+			m_pPool->FreeHandle(m_pHandle[i]);
+			m_pHandle[i] = nullptr;
+		}
+
+		m_pPool->Release();
+		m_pPool = nullptr;
+	}
+
+	m_pMappedPtr = nullptr;
+	m_Capacity   = 0;
+	m_FrameIndex = 0;
+	m_Used       = 0;
+}
+
+//-----------------------------------------------------------------------------
+//      フレームの書き込みを開始します.
+//-----------------------------------------------------------------------------
+void InstanceBuffer::Begin(uint32_t frameIndex)
+{
+	// App::Present() でGPUの完了を待っているため, 同じフレーム番号の領域は再利用できる.
+	m_FrameIndex = (frameIndex < App::FrameCount) ? frameIndex : 0;
+	m_Used       = 0;
+}
+
+//-----------------------------------------------------------------------------
+//      連続したインスタンス領域を割り当てます.
+//-----------------------------------------------------------------------------
+InstanceData* InstanceBuffer::Alloc(uint32_t count, uint32_t* pFirst)
+{
+	if (m_pMappedPtr == nullptr || count == 0)
+	{
+		return nullptr;
+	}
+
+	// 並列に記録するコマンドリストから呼ばれるので, 容量を超えない場合だけ進める.
+	auto first = m_Used.load(std::memory_order_relaxed);
+	do
+	{
+		if (first + count > m_Capacity)
+		{
+			return nullptr;
+		}
+	}
+	while (!m_Used.compare_exchange_weak(first, first + count, std::memory_order_relaxed));
+
+	if (pFirst != nullptr)
+	{
+		*pFirst = first;
+	}
+
+	auto pBase = reinterpret_cast<InstanceData*>(m_pMappedPtr) + size_t(m_Capacity) * m_FrameIndex;
+	return pBase + first;
+}
+
+//-----------------------------------------------------------------------------
+//      シェーダリソースビューを取得します.
+//-----------------------------------------------------------------------------
+D3D12_GPU_DESCRIPTOR_HANDLE InstanceBuffer::GetHandleGPU() const
+{
+	if (m_pHandle[m_FrameIndex] == nullptr)
+	{
+		return D3D12_GPU_DESCRIPTOR_HANDLE();
+	}
+
+	return m_pHandle[m_FrameIndex]->HandleGPU;
+}
+
+//-----------------------------------------------------------------------------
+//      割り当て済みのインスタンス数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t InstanceBuffer::GetUsedCount() const
+{
+	return m_Used;
+}
+
+//-----------------------------------------------------------------------------
+//      1フレームの最大インスタンス数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t InstanceBuffer::GetCapacity() const
+{
+	return m_Capacity;
+}
@@ -0,0 +1,562 @@
+﻿//-----------------------------------------------------------------------------
+// File : JobSystem.cpp
+// Desc : Work Stealing Job System Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <JobSystem.h>
+#include <algorithm>
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const uint32_t   kSpinCount = 64;    // 待機する前に空回りする回数です.
+
+//-----------------------------------------------------------------------------
+// Thread Local Variables.
+//-----------------------------------------------------------------------------
+thread_local JobSystem* t_pSystem = nullptr;    // 呼び出し元が属するジョブシステムです.
+thread_local uint32_t   t_Index   = 0;          // 呼び出し元のワーカー番号です.
+
+} // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+// WorkStealingDeque class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+WorkStealingDeque::WorkStealingDeque()
+: m_Top     (0)
+, m_Bottom  (0)
+{
+	for (auto& item : m_Buffer)
+	{
+		item.store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      所有スレッドが末尾に積みます.
+//-----------------------------------------------------------------------------
+bool WorkStealingDeque::Push(Task* pTask)
+{
+	auto b = m_Bottom.load(std::memory_order_relaxed);
+	auto t = m_Top   .load(std::memory_order_acquire);
+	if (b - t >= Capacity)
+	{
+		return false;
+	}
+
+	m_Buffer[b & (Capacity - 1)].store(pTask, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	m_Bottom.store(b + 1, std::memory_order_relaxed);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      所有スレッドが末尾から取り出します.
+//-----------------------------------------------------------------------------
+Task* WorkStealingDeque::Pop()
+{
+	auto b = m_Bottom.load(std::memory_order_relaxed) - 1;
+	m_Bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	auto t = m_Top.load(std::memory_order_relaxed);
+
+	if (t > b)
+	{
+		// 空でした.
+		m_Bottom.store(b + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	auto pTask = m_Buffer[b & (Capacity - 1)].load(std::memory_order_relaxed);
+	if (t == b)
+	{
+		// 最後の1つは盗む側と取り合うので先頭を進めて確定させます.
+		if (!m_Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			pTask = nullptr;
+		}
+		m_Bottom.store(b + 1, std::memory_order_relaxed);
+	}
+
+	return pTask;
+}
+
+//-----------------------------------------------------------------------------
+//      他のスレッドが先頭から盗みます.
+//-----------------------------------------------------------------------------
+Task* WorkStealingDeque::Steal()
+{
+	auto t = m_Top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	auto b = m_Bottom.load(std::memory_order_acquire);
+
+	if (t >= b)
+	{
+		return nullptr;
+	}
+
+	auto pTask = m_Buffer[t & (Capacity - 1)].load(std::memory_order_relaxed);
+	if (!m_Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+		return nullptr;
+	}
+
+	return pTask;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// TaskGraph class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+TaskGraph::TaskGraph()
+: m_Remaining(0)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+TaskGraph::~TaskGraph()
+{
+	Clear();
+}
+
+//-----------------------------------------------------------------------------
+//      タスクを追加します.
+//-----------------------------------------------------------------------------
+uint32_t TaskGraph::Add(std::function<void()> func)
+{
+	auto index = uint32_t(m_Tasks.size());
+
+	m_Tasks.emplace_back();
+	auto& task = m_Tasks.back();
+	task.Func         = std::move(func);
+	task.Predecessors = 0;
+	task.pGraph       = this;
+	task.Pending.store(0, std::memory_order_relaxed);
+
+	return index;
+}
+
+//-----------------------------------------------------------------------------
+//      before の完了後に after を実行するように設定します.
+//-----------------------------------------------------------------------------
+void TaskGraph::Precede(uint32_t before, uint32_t after)
+{
+	if (before >= m_Tasks.size() || after >= m_Tasks.size() || before == after)
+	{
+		return;
+	}
+
+	m_Tasks[before].Successors.push_back(&m_Tasks[after]);
+	m_Tasks[after].Predecessors++;
+}
+
+//-----------------------------------------------------------------------------
+//      全てのタスクを破棄します.
+//-----------------------------------------------------------------------------
+void TaskGraph::Clear()
+{
+	m_Tasks.clear();
+	m_Remaining.store(0, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+//      タスク数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t TaskGraph::GetCount() const
+{
+	return uint32_t(m_Tasks.size());
+}
+
+//-----------------------------------------------------------------------------
+//      全てのタスクが完了したかどうかを判定します.
+//-----------------------------------------------------------------------------
+bool TaskGraph::IsDone() const
+{
+	return m_Remaining.load(std::memory_order_acquire) == 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// JobSystem class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+JobSystem::JobSystem()
+: m_Overflows   (0)
+, m_Queued      (0)
+, m_Sleepers    (0)
+, m_Steals      (0)
+, m_Quit        (false)
+, m_pPrevSystem (nullptr)
+, m_PrevIndex   (0)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+JobSystem::~JobSystem()
+{
+	Term();
+}
+
+//-----------------------------------------------------------------------------
+//      初期化処理を行います.
+//-----------------------------------------------------------------------------
+bool JobSystem::Init(uint32_t workerCount)
+{
+	Term();
+
+	if (workerCount == 0)
+	{
+		workerCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	for (auto i = 0u; i < workerCount; ++i)
+	{
+		auto pWorker = new (std::nothrow) Worker();
+		if (pWorker == nullptr)
+		{
+			m_Workers.clear();
+			return false;
+		}
+
+		pWorker->Random = 0x9E3779B9u * (i + 1);
+		m_Workers.emplace_back(pWorker);
+	}
+
+	m_Quit     = false;
+	m_Queued   = 0;
+	m_Sleepers = 0;
+	m_Steals   = 0;
+
+	// 呼び出し元をワーカー0にします.
+	m_pPrevSystem = t_pSystem;
+	m_PrevIndex   = t_Index;
+	t_pSystem     = this;
+	t_Index       = 0;
+
+	for (auto i = 1u; i < workerCount; ++i)
+	{
+		m_Workers[i]->Thread = std::thread(&JobSystem::WorkerMain, this, i);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      終了処理を行います.
+//-----------------------------------------------------------------------------
+void JobSystem::Term()
+{
+	if (m_Workers.empty())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> locker(m_Mutex);
+		m_Quit = true;
+	}
+	m_WakeCV.notify_all();
+
+	for (auto& worker : m_Workers)
+	{
+		if (worker->Thread.joinable())
+		{
+			worker->Thread.join();
+		}
+	}
+	m_Workers.clear();
+
+	{
+		std::lock_guard<std::mutex> locker(m_Mutex);
+		m_Overflow.clear();
+		m_Overflows = 0;
+	}
+
+	if (t_pSystem == this)
+	{
+		t_pSystem = m_pPrevSystem;
+		t_Index   = m_PrevIndex;
+	}
+	m_pPrevSystem = nullptr;
+	m_PrevIndex   = 0;
+}
+
+//-----------------------------------------------------------------------------
+//      グラフの実行を開始します.
+//-----------------------------------------------------------------------------
+void JobSystem::Run(TaskGraph& graph)
+{
+	if (graph.m_Tasks.empty())
+	{
+		return;
+	}
+
+	// 積んだタスクが後続の待ち数を減らす前に全ての待ち数を戻しておきます.
+	graph.m_Remaining.store(uint32_t(graph.m_Tasks.size()), std::memory_order_relaxed);
+	for (auto& task : graph.m_Tasks)
+	{
+		task.Pending.store(task.Predecessors, std::memory_order_relaxed);
+	}
+	std::atomic_thread_fence(std::memory_order_release);
+
+	for (auto& task : graph.m_Tasks)
+	{
+		if (task.Predecessors == 0)
+		{
+			Push(&task);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      グラフの完了を待ちます.
+//-----------------------------------------------------------------------------
+void JobSystem::Wait(TaskGraph& graph)
+{
+	auto index = GetWorkerIndex();
+	auto spin  = 0u;
+
+	while (!graph.IsDone())
+	{
+		auto pTask = Acquire(index);
+		if (pTask != nullptr)
+		{
+			Execute(pTask);
+			spin = 0;
+			continue;
+		}
+
+		if (++spin > kSpinCount)
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      [0, count) を grain 個ずつに分けて並列に実行し, 完了を待ちます.
+//-----------------------------------------------------------------------------
+void JobSystem::ParallelFor(uint32_t count, uint32_t grain, const RangeFunc& func)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	grain = std::max(1u, grain);
+	auto chunks = (count + grain - 1) / grain;
+	if (chunks == 1 || m_Workers.size() <= 1)
+	{
+		func(0, count);
+		return;
+	}
+
+	TaskGraph graph;
+	for (auto i = 0u; i < chunks; ++i)
+	{
+		auto begin = i * grain;
+		auto end   = std::min(count, begin + grain);
+		graph.Add([&func, begin, end]() { func(begin, end); });
+	}
+
+	Run (graph);
+	Wait(graph);
+}
+
+//-----------------------------------------------------------------------------
+//      ワーカー数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t JobSystem::GetWorkerCount() const
+{
+	return uint32_t(m_Workers.size());
+}
+
+//-----------------------------------------------------------------------------
+//      呼び出し元のワーカー番号を取得します.
+//-----------------------------------------------------------------------------
+uint32_t JobSystem::GetWorkerIndex() const
+{
+	return (t_pSystem == this) ? t_Index : GetWorkerCount();
+}
+
+//-----------------------------------------------------------------------------
+//      他のワーカーから盗んだタスク数を取得します.
+//-----------------------------------------------------------------------------
+uint64_t JobSystem::GetStealCount() const
+{
+	return m_Steals.load(std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+//      タスクを積みます.
+//-----------------------------------------------------------------------------
+void JobSystem::Push(Task* pTask)
+{
+	auto index = GetWorkerIndex();
+	if (index >= m_Workers.size() || !m_Workers[index]->Deque.Push(pTask))
+	{
+		// ワーカー以外から積まれたか両端キューが満杯の場合は外部キューに積みます.
+		std::lock_guard<std::mutex> locker(m_Mutex);
+		m_Overflow.push_back(pTask);
+		m_Overflows.fetch_add(1);
+	}
+
+	// 待機中のワーカーがいれば起こします.
+	// m_Queued と m_Sleepers は逆順に書き込み・読み込みするので起こし損ねません.
+	m_Queued.fetch_add(1);
+	if (m_Sleepers.load() > 0)
+	{
+		std::lock_guard<std::mutex> locker(m_Mutex);
+		m_WakeCV.notify_one();
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      実行するタスクを取得します.
+//-----------------------------------------------------------------------------
+Task* JobSystem::Acquire(uint32_t index)
+{
+	auto count = uint32_t(m_Workers.size());
+
+	// 自分の両端キューから新しい順に取り出します.
+	if (index < count)
+	{
+		auto pTask = m_Workers[index]->Deque.Pop();
+		if (pTask != nullptr)
+		{
+			m_Queued.fetch_sub(1);
+			return pTask;
+		}
+	}
+
+	// 外部キューから取り出します.
+	if (m_Overflows.load() > 0)
+	{
+		std::lock_guard<std::mutex> locker(m_Mutex);
+		if (!m_Overflow.empty())
+		{
+			auto pTask = m_Overflow.front();
+			m_Overflow.pop_front();
+			m_Overflows.fetch_sub(1);
+			m_Queued   .fetch_sub(1);
+			return pTask;
+		}
+	}
+
+	if (count <= 1)
+	{
+		return nullptr;
+	}
+
+	// 他のワーカーから古い順に盗みます. 相手はランダムに選びます.
+	auto random = (index < count) ? m_Workers[index]->Random : uint32_t(count * 0x9E3779B9u);
+	for (auto i = 0u; i < count; ++i)
+	{
+		random ^= random << 13;
+		random ^= random >> 17;
+		random ^= random << 5;
+
+		auto victim = random % count;
+		if (victim == index)
+		{
+			continue;
+		}
+
+		auto pTask = m_Workers[victim]->Deque.Steal();
+		if (pTask != nullptr)
+		{
+			if (index < count)
+			{
+				m_Workers[index]->Random = random;
+			}
+			m_Steals.fetch_add(1, std::memory_order_relaxed);
+			m_Queued.fetch_sub(1);
+			return pTask;
+		}
+	}
+
+	if (index < count)
+	{
+		m_Workers[index]->Random = random;
+	}
+
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+//      タスクを実行し, 実行可能になった後続を積みます.
+//-----------------------------------------------------------------------------
+void JobSystem::Execute(Task* pTask)
+{
+	if (pTask->Func)
+	{
+		pTask->Func();
+	}
+
+	for (auto pNext : pTask->Successors)
+	{
+		if (pNext->Pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			Push(pNext);
+		}
+	}
+
+	// 完了を通知した後はグラフが破棄される可能性があるので最後に行います.
+	pTask->pGraph->m_Remaining.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+//-----------------------------------------------------------------------------
+//      ワーカースレッドのメイン処理です.
+//-----------------------------------------------------------------------------
+void JobSystem::WorkerMain(uint32_t index)
+{
+	t_pSystem = this;
+	t_Index   = index;
+
+	auto spin = 0u;
+	while (!m_Quit.load())
+	{
+		auto pTask = Acquire(index);
+		if (pTask != nullptr)
+		{
+			Execute(pTask);
+			spin = 0;
+			continue;
+		}
+
+		if (++spin < kSpinCount)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		// 積まれるまで待機します.
+		std::unique_lock<std::mutex> locker(m_Mutex);
+		m_Sleepers.fetch_add(1);
+		m_WakeCV.wait(locker, [this]() { return m_Queued.load() > 0 || m_Quit.load(); });
+		m_Sleepers.fetch_sub(1);
+		spin = 0;
+	}
+
+	t_pSystem = nullptr;
+}
@@ -9,7 +9,11 @@
 //-----------------------------------------------------------------------------
 #include <cstdio>
 #include <cstdarg>
+#include <cstring>
+
+#if defined(_WIN32)
 #include <Windows.h>
+#endif
 
 //-----------------------------------------------------------------------------
 //      ログ出力します.
@@ -21,12 +25,14 @@ void OutputLog(const char* format, ...)
 	va_list arg;
 
 	va_start(arg, format);
-	vsprintf_s(msg, format, arg);
+	vsnprintf(msg, sizeof(msg), format, arg);
 	va_end(arg);
 
 	// コンソールに出力.
-	printf_s("%s", msg);
+	printf("%s", msg);
 
+#if defined(_WIN32)
 	// Visual Studioの出力ウィンドウにも表示.
 	OutputDebugStringA(msg);
+#endif
 }
\ No newline at end of file
@@ -10,13 +10,9 @@
 #include "Material.h"
 #include "FileUtil.h"
 #include "Logger.h"
-
-namespace {
-	//-----------------------------------------------------------------------------
-	// Constant Values.
-	//-----------------------------------------------------------------------------
-	constexpr wchar_t* DummyTag = L"";
-}// namespace
+#include "FallbackTexture.h"
+#include <algorithm>
+#include <cassert>
 
 ///////////////////////////////////////////////////////////////////////////////
 // Material class
@@ -26,7 +22,9 @@ namespace {
 //      コンストラクタです.
 //-----------------------------------------------------------------------------
 Material::Material()
-	: m_pDevice(nullptr)
+	: m_pShader(nullptr)
+	, m_DefaultParam()
+	, m_pDevice(nullptr)
 	, m_pPool(nullptr)
 { /* DO_NOTHING */
 }
@@ -66,40 +64,8 @@ bool Material::Init
 
 	m_Subset.resize(count);
 
-	// ダミーテクスチャ生成.
-	{
-		auto pTexture = new (std::nothrow) Texture();
-		if (pTexture == nullptr)
-		{
-			return false;
-		}
-
-		D3D12_RESOURCE_DESC desc = {};
-		desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-		desc.Width = 1;
-		desc.Height = 1;
-		desc.DepthOrArraySize = 1;
-		desc.MipLevels = 1;
-		desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-		desc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
-		desc.SampleDesc.Count = 1;
-		desc.SampleDesc.Quality = 0;
-
-		if (!pTexture->Init(
-			pDevice,
-			pPool,
-			&desc,
-			D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
-			false))
-		{
-			ELOG("Error : Texture::Init() Failed.");
-			pTexture->Term();
-			delete pTexture;
-			return false;
-		}
-
-		m_pTexture[DummyTag] = pTexture;
-	}
+	// 未設定のテクスチャは共有の白テクスチャを参照させる.
+	auto fallback = FallbackTexture::GetInstance().GetHandleGPU(FallbackTexture::TYPE_WHITE);
 
 	auto size = bufferSize * count;
 	if (size > 0)
@@ -122,7 +88,7 @@ bool Material::Init
 			m_Subset[i].pCostantBuffer = pBuffer;
 			for (auto j = 0; j < TEXTURE_USAGE_COUNT; ++j)
 			{
-				m_Subset[i].TextureHandle[j].ptr = 0;
+				m_Subset[i].TextureHandle[j] = fallback;
 			}
 		}
 	}
@@ -133,7 +99,7 @@ bool Material::Init
 			m_Subset[i].pCostantBuffer = nullptr;
 			for (auto j = 0; j < TEXTURE_USAGE_COUNT; ++j)
 			{
-				m_Subset[i].TextureHandle[j].ptr = 0;
+				m_Subset[i].TextureHandle[j] = fallback;
 			}
 		}
 	}
@@ -169,6 +135,13 @@ void Material::Term()
 	m_pTexture.clear();
 	m_Subset.clear();
 
+	// 参照しているインスタンスを切り離す.
+	for (auto pInstance : m_Instances)
+	{
+		pInstance->m_pTemplate = nullptr;
+	}
+	m_Instances.clear();
+
 	if (m_pDevice != nullptr)
 	{
 		m_pDevice->Release();
@@ -189,14 +162,86 @@ bool Material::SetShaderPtr(ModelShader* pShader) {
 	return true;
 }
 
-bool Material::SetMaterial(ID3D12GraphicsCommandList* pCmd, int frameindex, Material& mat, int id, const ConstantBuffer* meshCB, const CommonBufferManager& commonbufmanager, const SkyManager& manager) {
+ModelShader* Material::GetShaderPtr() const {
+	return m_pShader;
+}
+
+bool Material::SetMaterial(ID3D12GraphicsCommandList* pCmd, int frameindex, Material& mat, int id, const MaterialInstance* pInstance, const ConstantBuffer* meshCB, const CommonBufferManager& commonbufmanager, const SkyManager& manager) {
 	if (m_pShader == nullptr)return false;
 
-	m_pShader->SetShader(pCmd, frameindex, mat, id, meshCB, commonbufmanager, manager);
+	m_pShader->SetShader(pCmd, frameindex, mat, id, pInstance, meshCB, commonbufmanager, manager);
 
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+//      インスタンスの既定パラメータを設定します.
+//-----------------------------------------------------------------------------
+void Material::SetDefaultParam(uint32_t slot, const DirectX::SimpleMath::Vector4& value)
+{
+	if (slot >= MaterialParamBlock::ParamCount || m_DefaultParam.Param[slot] == value)
+	{
+		return;
+	}
+
+	m_DefaultParam.Param[slot] = value;
+
+	// 上書きしていないインスタンスだけ再転送が必要.
+	for (auto pInstance : m_Instances)
+	{
+		if (!pInstance->IsOverridden(slot))
+		{
+			pInstance->Resolve();
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      インスタンスの既定パラメータを取得します.
+//-----------------------------------------------------------------------------
+const DirectX::SimpleMath::Vector4& Material::GetDefaultParam(uint32_t slot) const
+{
+	assert(slot < MaterialParamBlock::ParamCount);
+	return m_DefaultParam.Param[slot];
+}
+
+//-----------------------------------------------------------------------------
+//      インスタンスの既定パラメータブロックを取得します.
+//-----------------------------------------------------------------------------
+const MaterialParamBlock& Material::GetDefaultParams() const
+{
+	return m_DefaultParam;
+}
+
+//-----------------------------------------------------------------------------
+//      参照しているインスタンス数を取得します.
+//-----------------------------------------------------------------------------
+size_t Material::GetInstanceCount() const
+{
+	return m_Instances.size();
+}
+
+//-----------------------------------------------------------------------------
+//      インスタンスを登録します.
+//-----------------------------------------------------------------------------
+void Material::AddInstance(MaterialInstance* pInstance)
+{
+	m_Instances.push_back(pInstance);
+}
+
+//-----------------------------------------------------------------------------
+//      インスタンスの登録を解除します.
+//-----------------------------------------------------------------------------
+void Material::RemoveInstance(MaterialInstance* pInstance)
+{
+	auto itr = std::find(m_Instances.begin(), m_Instances.end(), pInstance);
+	if (itr != m_Instances.end())
+	{
+		*itr = m_Instances.back();
+		m_Instances.pop_back();
+	}
+}
+
 //-----------------------------------------------------------------------------
 //      既に生成されているテクスチャを登録します.
 //-----------------------------------------------------------------------------
@@ -264,8 +309,8 @@ bool Material::SetTexture
 	std::wstring findPath;
 	if (!SearchFilePathW(path.c_str(), findPath))
 	{
-		// 存在しない場合はダミーテクスチャを設定.
-		m_Subset[index].TextureHandle[usage] = m_pTexture[DummyTag]->GetHandleGPU();
+		// 存在しない場合は共有の白テクスチャを設定.
+		m_Subset[index].TextureHandle[usage] = FallbackTexture::GetInstance().GetHandleGPU(FallbackTexture::TYPE_WHITE);
 		return true;
 	}
 
@@ -273,7 +318,7 @@ bool Material::SetTexture
 	{
 		if (PathIsDirectoryW(findPath.c_str()) != FALSE)
 		{
-			m_Subset[index].TextureHandle[usage] = m_pTexture[DummyTag]->GetHandleGPU();
+			m_Subset[index].TextureHandle[usage] = FallbackTexture::GetInstance().GetHandleGPU(FallbackTexture::TYPE_WHITE);
 			return true;
 		}
 	}
@@ -303,6 +348,33 @@ bool Material::SetTexture
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+//      共有のフォールバックテクスチャを設定します.
+//-----------------------------------------------------------------------------
+bool Material::SetFallbackTexture
+(
+	size_t                          index,
+	TEXTURE_USAGE                   usage,
+	FallbackTexture::TYPE           type
+)
+{
+	// 範囲内であるかチェック.
+	if (index >= GetCount())
+	{
+		return false;
+	}
+
+	auto handle = FallbackTexture::GetInstance().GetHandleGPU(type);
+	if (handle.ptr == 0)
+	{
+		ELOG("Error : FallbackTexture is not initialized.");
+		return false;
+	}
+
+	m_Subset[index].TextureHandle[usage] = handle;
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 //      定数バッファのポインタを取得します.
 //-----------------------------------------------------------------------------
@@ -355,10 +427,49 @@ D3D12_GPU_DESCRIPTOR_HANDLE Material::GetTextureHandle(size_t index, TEXTURE_USA
 	return m_Subset[index].TextureHandle[usage];
 }
 
+//-----------------------------------------------------------------------------
+//      バインドレス描画用のテクスチャ番号を取得します.
+//-----------------------------------------------------------------------------
+uint32_t Material::GetTextureIndex(size_t index, TEXTURE_USAGE usage) const
+{
+	auto handle = GetTextureHandle(index, usage);
+	if (handle.ptr == 0)
+	{
+		return 0;
+	}
+
+	return m_pPool->GetHandleIndex(handle);
+}
+
 //-----------------------------------------------------------------------------
 //      マテリアル数を取得します.
 //-----------------------------------------------------------------------------
 size_t Material::GetCount() const
 {
 	return m_Subset.size();
+}
+
+//-----------------------------------------------------------------------------
+//      所有しているリソース数を取得します.
+//-----------------------------------------------------------------------------
+size_t Material::GetResourceCount() const
+{
+	size_t count = 0;
+	for (auto& subset : m_Subset)
+	{
+		if (subset.pCostantBuffer != nullptr)
+		{
+			count++;
+		}
+	}
+
+	for (auto& itr : m_pTexture)
+	{
+		if (itr.second != nullptr)
+		{
+			count++;
+		}
+	}
+
+	return count;
 }
\ No newline at end of file
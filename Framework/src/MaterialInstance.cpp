@@ -0,0 +1,233 @@
+﻿//-----------------------------------------------------------------------------
+// File : MaterialInstance.cpp
+// Desc : Material Instance Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <MaterialInstance.h>
+#include <Material.h>
+#include <Logger.h>
+
+static_assert(MaterialParamBlock::ParamCount <= 16, "MaterialInstance tracks overrides in 16 bits.");
+
+///////////////////////////////////////////////////////////////////////////////
+// MaterialInstance class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+MaterialInstance::MaterialInstance()
+	: m_pTemplate(nullptr)
+	, m_pBuffer(nullptr)
+	, m_Index(UINT32_MAX)
+	, m_OverrideMask(0)
+{ /* DO_NOTHING */
+}
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+MaterialInstance::~MaterialInstance()
+{
+	Term();
+}
+
+//-----------------------------------------------------------------------------
+//      初期化処理を行います.
+//-----------------------------------------------------------------------------
+bool MaterialInstance::Init(Material* pTemplate, MaterialParamBuffer* pBuffer)
+{
+	if (pTemplate == nullptr || pBuffer == nullptr)
+	{
+		ELOG("Error : Invalid Argument.");
+		return false;
+	}
+
+	Term();
+
+	m_Index = pBuffer->Alloc();
+	if (m_Index == UINT32_MAX)
+	{
+		return false;
+	}
+
+	m_pTemplate = pTemplate;
+	m_pBuffer   = pBuffer;
+	m_pTemplate->AddInstance(this);
+
+	Resolve();
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      終了処理を行います.
+//-----------------------------------------------------------------------------
+void MaterialInstance::Term()
+{
+	if (m_pTemplate != nullptr)
+	{
+		m_pTemplate->RemoveInstance(this);
+		m_pTemplate = nullptr;
+	}
+
+	if (m_pBuffer != nullptr)
+	{
+		m_pBuffer->Free(m_Index);
+		m_pBuffer = nullptr;
+	}
+
+	m_Index        = UINT32_MAX;
+	m_OverrideMask = 0;
+	m_Overrides.clear();
+}
+
+//-----------------------------------------------------------------------------
+//      上書き値の格納位置を求めます.
+//-----------------------------------------------------------------------------
+uint32_t MaterialInstance::GetOverrideOffset(uint32_t slot) const
+{
+	// 自身より小さいスロットの上書き数が格納位置になる.
+	uint32_t lower = m_OverrideMask & ((1u << slot) - 1u);
+	uint32_t count = 0;
+	while (lower != 0)
+	{
+		lower &= lower - 1;
+		count++;
+	}
+	return count;
+}
+
+//-----------------------------------------------------------------------------
+//      パラメータを上書きします.
+//-----------------------------------------------------------------------------
+void MaterialInstance::SetParam(uint32_t slot, const DirectX::SimpleMath::Vector4& value)
+{
+	if (slot >= MaterialParamBlock::ParamCount || m_pTemplate == nullptr)
+	{
+		return;
+	}
+
+	auto offset = GetOverrideOffset(slot);
+	if (IsOverridden(slot))
+	{
+		if (m_Overrides[offset] == value)
+		{
+			return;
+		}
+		m_Overrides[offset] = value;
+	}
+	else
+	{
+		m_Overrides.insert(m_Overrides.begin() + offset, value);
+		m_OverrideMask |= uint16_t(1u << slot);
+	}
+
+	Resolve();
+}
+
+//-----------------------------------------------------------------------------
+//      上書きを解除します.
+//-----------------------------------------------------------------------------
+void MaterialInstance::ResetParam(uint32_t slot)
+{
+	if (!IsOverridden(slot))
+	{
+		return;
+	}
+
+	m_Overrides.erase(m_Overrides.begin() + GetOverrideOffset(slot));
+	m_OverrideMask &= uint16_t(~(1u << slot));
+
+	Resolve();
+}
+
+//-----------------------------------------------------------------------------
+//      解決済みのパラメータを取得します.
+//-----------------------------------------------------------------------------
+DirectX::SimpleMath::Vector4 MaterialInstance::GetParam(uint32_t slot) const
+{
+	if (slot >= MaterialParamBlock::ParamCount || m_pTemplate == nullptr)
+	{
+		return DirectX::SimpleMath::Vector4::Zero;
+	}
+
+	if (IsOverridden(slot))
+	{
+		return m_Overrides[GetOverrideOffset(slot)];
+	}
+
+	return m_pTemplate->GetDefaultParam(slot);
+}
+
+//-----------------------------------------------------------------------------
+//      指定スロットを上書きしているかどうか.
+//-----------------------------------------------------------------------------
+bool MaterialInstance::IsOverridden(uint32_t slot) const
+{
+	if (slot >= MaterialParamBlock::ParamCount)
+	{
+		return false;
+	}
+
+	return (m_OverrideMask & (1u << slot)) != 0;
+}
+
+//-----------------------------------------------------------------------------
+//      テンプレートを取得します.
+//-----------------------------------------------------------------------------
+Material* MaterialInstance::GetTemplate() const
+{
+	return m_pTemplate;
+}
+
+//-----------------------------------------------------------------------------
+//      ブロック番号を取得します.
+//-----------------------------------------------------------------------------
+uint32_t MaterialInstance::GetIndex() const
+{
+	return m_Index;
+}
+
+//-----------------------------------------------------------------------------
+//      パラメータバッファを取得します.
+//-----------------------------------------------------------------------------
+MaterialParamBuffer* MaterialInstance::GetBuffer() const
+{
+	return m_pBuffer;
+}
+
+//-----------------------------------------------------------------------------
+//      インスタンスが使用しているCPUメモリのバイト数を取得します.
+//-----------------------------------------------------------------------------
+size_t MaterialInstance::GetMemorySize() const
+{
+	return sizeof(*this) + m_Overrides.capacity() * sizeof(DirectX::SimpleMath::Vector4);
+}
+
+//-----------------------------------------------------------------------------
+//      既定値と上書き値からブロックを組み立て, バッファへ書き込みます.
+//-----------------------------------------------------------------------------
+void MaterialInstance::Resolve()
+{
+	if (m_pTemplate == nullptr || m_pBuffer == nullptr)
+	{
+		return;
+	}
+
+	MaterialParamBlock block = m_pTemplate->GetDefaultParams();
+
+	uint32_t offset = 0;
+	for (auto i = 0u; i < MaterialParamBlock::ParamCount; ++i)
+	{
+		if (m_OverrideMask & (1u << i))
+		{
+			block.Param[i] = m_Overrides[offset++];
+		}
+	}
+
+	m_pBuffer->Write(m_Index, block);
+}
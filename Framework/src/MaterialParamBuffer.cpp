@@ -0,0 +1,337 @@
+﻿//-----------------------------------------------------------------------------
+// File : MaterialParamBuffer.cpp
+// Desc : Packed Material Parameter Buffer Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <MaterialParamBuffer.h>
+#include <DescriptorPool.h>
+#include <Logger.h>
+#include <algorithm>
+#include <cassert>
+
+static_assert(App::FrameCount <= 8, "MaterialParamBuffer tracks dirty frames in 8 bits.");
+
+///////////////////////////////////////////////////////////////////////////////
+// MaterialParamBuffer class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+MaterialParamBuffer::MaterialParamBuffer()
+	: m_pBuffer()
+	, m_pMappedPtr(nullptr)
+	, m_pPool(nullptr)
+	, m_Capacity(0)
+	, m_LastUploadCount(0)
+{
+	for (auto i = 0u; i < App::FrameCount; ++i)
+	{
+		m_pHandle[i] = nullptr;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+MaterialParamBuffer::~MaterialParamBuffer()
+{
+	Term();
+}
+
+//-----------------------------------------------------------------------------
+//      初期化処理を行います.
+//-----------------------------------------------------------------------------
+bool MaterialParamBuffer::Init(ID3D12Device* pDevice, DescriptorPool* pPool, uint32_t capacity)
+{
+	if (pDevice == nullptr || pPool == nullptr || capacity == 0)
+	{
+		ELOG("Error : Invalid Argument.");
+		return false;
+	}
+
+	Term();
+
+	m_pPool = pPool;
+	m_pPool->AddRef();
+
+	m_Capacity = capacity;
+
+	// ヒーププロパティ.
+	D3D12_HEAP_PROPERTIES prop = {};
+	prop.Type                 = D3D12_HEAP_TYPE_UPLOAD;
+	prop.CPUPageProperty      = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	prop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	prop.CreationNodeMask     = 1;
+	prop.VisibleNodeMask      = 1;
+
+	// リソースの設定. フレームごとの領域を連続して確保する.
+	D3D12_RESOURCE_DESC desc = {};
+	desc.Dimension          = D3D12_RESOURCE_DIMENSION_BUFFER;
+	desc.Alignment          = 0;
+	desc.Width              = UINT64(sizeof(MaterialParamBlock)) * capacity * App::FrameCount;
+	desc.Height             = 1;
+	desc.DepthOrArraySize   = 1;
+	desc.MipLevels          = 1;
+	desc.Format             = DXGI_FORMAT_UNKNOWN;
+	desc.SampleDesc.Count   = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Layout             = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	desc.Flags              = D3D12_RESOURCE_FLAG_NONE;
+
+	auto hr = pDevice->CreateCommittedResource(
+		&prop,
+		D3D12_HEAP_FLAG_NONE,
+		&desc,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(m_pBuffer.GetAddressOf()));
+	if (FAILED(hr))
+	{
+		ELOG("Error : ID3D12Device::CreateCommittedResource() Failed. retcode = 0x%x", hr);
+		return false;
+	}
+
+	// メモリマッピングしておきます.
+	hr = m_pBuffer->Map(0, nullptr, reinterpret_cast<void**>(&m_pMappedPtr));
+	if (FAILED(hr))
+	{
+		ELOG("Error : ID3D12Resource::Map() Failed. retcode = 0x%x", hr);
+		return false;
+	}
+
+	// フレームごとにストラクチャードバッファのビューを生成.
+	for (auto i = 0u; i < App::FrameCount; ++i)
+	{
+		m_pHandle[i] = pPool->AllocHandle();
+		if (m_pHandle[i] == nullptr)
+		{
+			ELOG("Error : DescriptorPool::AllocHandle() Failed.");
+			return false;
+		}
+
+		D3D12_SHADER_RESOURCE_VIEW_DESC viewDesc = {};
+		viewDesc.Format                     = DXGI_FORMAT_UNKNOWN;
+		viewDesc.ViewDimension              = D3D12_SRV_DIMENSION_BUFFER;
+		viewDesc.Shader4ComponentMapping    = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+		viewDesc.Buffer.FirstElement        = UINT64(capacity) * i;
+		viewDesc.Buffer.NumElements         = capacity;
+		viewDesc.Buffer.StructureByteStride = sizeof(MaterialParamBlock);
+		viewDesc.Buffer.Flags               = D3D12_BUFFER_SRV_FLAG_NONE;
+
+		pDevice->CreateShaderResourceView(m_pBuffer.Get(), &viewDesc, m_pHandle[i]->HandleCPU);
+	}
+
+	m_Blocks     .resize(capacity);
+	m_DirtyFrames.resize(capacity, 0);
+	m_DirtyList  .reserve(capacity);
+	m_FreeList   .reserve(capacity);
+
+	// 小さい番号から割り当てられるように逆順に積む.
+	for (auto i = capacity; i > 0; --i)
+	{
+		m_FreeList.push_back(i - 1);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      終了処理を行います.
+//-----------------------------------------------------------------------------
+void MaterialParamBuffer::Term()
+{
+	if (m_pBuffer != nullptr)
+	{
+		m_pBuffer->Unmap(0, nullptr);
+		m_pBuffer.Reset();
+	}
+
+	if (m_pPool != nullptr)
+	{
+		for (auto i = 0u; i < App::FrameCount; ++i)
+		{
+			m_pPool->FreeHandle(m_pHandle[i]);
+			m_pHandle[i] = nullptr;
+		}
+
+		m_pPool->Release();
+		m_pPool = nullptr;
+	}
+
+	m_pMappedPtr      = nullptr;
+	m_Capacity        = 0;
+	m_LastUploadCount = 0;
+
+	m_Blocks     .clear();
+	m_DirtyFrames.clear();
+	m_DirtyList  .clear();
+	m_FreeList   .clear();
+}
+
+//-----------------------------------------------------------------------------
+//      パラメータブロックを割り当てます.
+//-----------------------------------------------------------------------------
+uint32_t MaterialParamBuffer::Alloc()
+{
+	if (m_FreeList.empty())
+	{
+		ELOG("Error : MaterialParamBuffer is full. capacity = %u", m_Capacity);
+		return UINT32_MAX;
+	}
+
+	auto index = m_FreeList.back();
+	m_FreeList.pop_back();
+
+	m_Blocks[index] = MaterialParamBlock();
+	return index;
+}
+
+//-----------------------------------------------------------------------------
+//      パラメータブロックを解放します.
+//-----------------------------------------------------------------------------
+void MaterialParamBuffer::Free(uint32_t index)
+{
+	if (index >= m_Capacity)
+	{
+		return;
+	}
+
+	// 転送待ちであれば取り消す. 再割り当て後の Write() で二重に積まないよう, 転送リストからも取り除く.
+	if (m_DirtyFrames[index] != 0)
+	{
+		auto itr = std::find(m_DirtyList.begin(), m_DirtyList.end(), index);
+		if (itr != m_DirtyList.end())
+		{
+			*itr = m_DirtyList.back();
+			m_DirtyList.pop_back();
+		}
+		m_DirtyFrames[index] = 0;
+	}
+
+	m_FreeList.push_back(index);
+}
+
+//-----------------------------------------------------------------------------
+//      パラメータブロックを書き込みます.
+//-----------------------------------------------------------------------------
+void MaterialParamBuffer::Write(uint32_t index, const MaterialParamBlock& block)
+{
+	if (index >= m_Capacity)
+	{
+		return;
+	}
+
+	m_Blocks[index] = block;
+
+	// 全フレーム分のバッファに転送が必要.
+	if (m_DirtyFrames[index] == 0)
+	{
+		m_DirtyList.push_back(index);
+	}
+	m_DirtyFrames[index] = uint8_t((1u << App::FrameCount) - 1);
+}
+
+//-----------------------------------------------------------------------------
+//      変更されたブロックのみを転送します.
+//-----------------------------------------------------------------------------
+void MaterialParamBuffer::Update(uint32_t frameIndex)
+{
+	m_LastUploadCount = 0;
+	if (m_pMappedPtr == nullptr || frameIndex >= App::FrameCount)
+	{
+		return;
+	}
+
+	const auto bit  = uint8_t(1u << frameIndex);
+	auto       pDst = m_pMappedPtr + sizeof(MaterialParamBlock) * m_Capacity * frameIndex;
+
+	size_t count = 0;
+	for (size_t i = 0; i < m_DirtyList.size(); ++i)
+	{
+		auto index = m_DirtyList[i];
+		if (m_DirtyFrames[index] & bit)
+		{
+			memcpy(pDst + sizeof(MaterialParamBlock) * index, &m_Blocks[index], sizeof(MaterialParamBlock));
+			m_DirtyFrames[index] &= ~bit;
+			m_LastUploadCount++;
+		}
+
+		// 他のフレームへの転送が残っているものだけを残す.
+		if (m_DirtyFrames[index] != 0)
+		{
+			m_DirtyList[count++] = index;
+		}
+	}
+	m_DirtyList.resize(count);
+}
+
+//-----------------------------------------------------------------------------
+//      シェーダリソースビューを取得します.
+//-----------------------------------------------------------------------------
+D3D12_GPU_DESCRIPTOR_HANDLE MaterialParamBuffer::GetHandleGPU(uint32_t frameIndex) const
+{
+	if (frameIndex >= App::FrameCount || m_pHandle[frameIndex] == nullptr)
+	{
+		return D3D12_GPU_DESCRIPTOR_HANDLE();
+	}
+
+	return m_pHandle[frameIndex]->HandleGPU;
+}
+
+//-----------------------------------------------------------------------------
+//      CPU側のパラメータブロックを取得します.
+//-----------------------------------------------------------------------------
+const MaterialParamBlock& MaterialParamBuffer::GetBlock(uint32_t index) const
+{
+	assert(index < m_Capacity);
+	return m_Blocks[index];
+}
+
+//-----------------------------------------------------------------------------
+//      割り当て済みのブロック数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t MaterialParamBuffer::GetAllocatedCount() const
+{
+	return m_Capacity - uint32_t(m_FreeList.size());
+}
+
+//-----------------------------------------------------------------------------
+//      転送待ちのブロック数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t MaterialParamBuffer::GetPendingCount() const
+{
+	return uint32_t(m_DirtyList.size());
+}
+
+//-----------------------------------------------------------------------------
+//      直前に転送したブロック数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t MaterialParamBuffer::GetLastUploadCount() const
+{
+	return m_LastUploadCount;
+}
+
+//-----------------------------------------------------------------------------
+//      CPU側で確保しているバイト数を取得します.
+//-----------------------------------------------------------------------------
+size_t MaterialParamBuffer::GetCpuMemorySize() const
+{
+	return sizeof(*this)
+		+ m_Blocks     .capacity() * sizeof(MaterialParamBlock)
+		+ m_DirtyFrames.capacity() * sizeof(uint8_t)
+		+ m_DirtyList  .capacity() * sizeof(uint32_t)
+		+ m_FreeList   .capacity() * sizeof(uint32_t);
+}
+
+//-----------------------------------------------------------------------------
+//      GPU側で確保しているバイト数を取得します.
+//-----------------------------------------------------------------------------
+size_t MaterialParamBuffer::GetGpuMemorySize() const
+{
+	return (m_pBuffer != nullptr) ? size_t(m_pBuffer->GetDesc().Width) : 0;
+}
@@ -19,6 +19,9 @@
 Mesh::Mesh()
 	: m_MaterialId(UINT32_MAX)
 	, m_IndexCount(0)
+	, m_BoundsMin(0.0f, 0.0f, 0.0f)
+	, m_BoundsMax(0.0f, 0.0f, 0.0f)
+	, m_BoundingSphere(0.0f, 0.0f, 0.0f, 0.0f)
 { /* DO_NOTHING */
 }
 
@@ -54,6 +57,9 @@ bool Mesh::Init(ID3D12Device* pDevice, const ResMesh& resource)
 
 	m_MaterialId = resource.MaterialId;
 	m_IndexCount = uint32_t(resource.Indices.size());
+	m_BoundsMin      = resource.BoundsMin;
+	m_BoundsMax      = resource.BoundsMax;
+	m_BoundingSphere = resource.BoundingSphere;
 
 	return true;
 }
@@ -73,13 +79,21 @@ void Mesh::Term()
 //      描画処理を行います.
 //-----------------------------------------------------------------------------
 void Mesh::Draw(ID3D12GraphicsCommandList* pCmdList)
+{
+	Draw(pCmdList, 1);
+}
+
+//-----------------------------------------------------------------------------
+//      インスタンス描画を行います.
+//-----------------------------------------------------------------------------
+void Mesh::Draw(ID3D12GraphicsCommandList* pCmdList, uint32_t instanceCount)
 {
 	auto VBV = m_VB.GetView();
 	auto IBV = m_IB.GetView();
 	pCmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 	pCmdList->IASetVertexBuffers(0, 1, &VBV);
 	pCmdList->IASetIndexBuffer(&IBV);
-	pCmdList->DrawIndexedInstanced(m_IndexCount, 1, 0, 0, 0);
+	pCmdList->DrawIndexedInstanced(m_IndexCount, instanceCount, 0, 0, 0);
 }
 
 //-----------------------------------------------------------------------------
@@ -88,4 +102,28 @@ void Mesh::Draw(ID3D12GraphicsCommandList* pCmdList)
 uint32_t Mesh::GetMaterialId() const
 {
 	return m_MaterialId;
+}
+
+//-----------------------------------------------------------------------------
+//      AABBの最小値を取得します.
+//-----------------------------------------------------------------------------
+const DirectX::XMFLOAT3& Mesh::GetBoundsMin() const
+{
+	return m_BoundsMin;
+}
+
+//-----------------------------------------------------------------------------
+//      AABBの最大値を取得します.
+//-----------------------------------------------------------------------------
+const DirectX::XMFLOAT3& Mesh::GetBoundsMax() const
+{
+	return m_BoundsMax;
+}
+
+//-----------------------------------------------------------------------------
+//      境界球を取得します.
+//-----------------------------------------------------------------------------
+const DirectX::XMFLOAT4& Mesh::GetBoundingSphere() const
+{
+	return m_BoundingSphere;
 }
\ No newline at end of file
@@ -6,8 +6,9 @@
 #include <CommonBufferManager.h>
 #include <App.h>
 #include <ResourceManager.h>
+#include <InlineUtil.h>
 
-bool Model::LoadModel(std::wstring filePath, ComPtr<ID3D12Device> pDevice, DescriptorPool* resPool, ComPtr<ID3D12CommandQueue> commandQueue)
+bool Model::LoadModel(std::wstring filePath, ComPtr<ID3D12Device> pDevice, DescriptorPool* resPool, ComPtr<ID3D12CommandQueue> commandQueue, MaterialParamBuffer* pParamBuffer)
 {
 	m_ModelPath = filePath;
 	AppResourceManager& manager = AppResourceManager::GetInstance();
@@ -18,15 +19,32 @@ bool Model::LoadModel(std::wstring filePath, ComPtr<ID3D12Device> pDevice, Descr
 	if (!manager.CreateMesh(pDevice,	 m_ModelPath, manager.GetResMesh(m_ModelPath)))				return false;
 	if (!manager.CreateMaterial(pDevice, m_ModelPath, manager.GetResMaterial(m_ModelPath), resPool))	return false;
 
+	// 全メッシュを囲むAABBを求めておく(カリング用).
+	{
+		const std::vector<Mesh*> meshs = manager.GetMesh(m_ModelPath);
+		if (!meshs.empty())
+		{
+			auto vmin = DirectX::XMLoadFloat3(&meshs[0]->GetBoundsMin());
+			auto vmax = DirectX::XMLoadFloat3(&meshs[0]->GetBoundsMax());
+			for (size_t i = 1; i < meshs.size(); ++i)
+			{
+				vmin = DirectX::XMVectorMin(vmin, DirectX::XMLoadFloat3(&meshs[i]->GetBoundsMin()));
+				vmax = DirectX::XMVectorMax(vmax, DirectX::XMLoadFloat3(&meshs[i]->GetBoundsMax()));
+			}
+			DirectX::XMStoreFloat3(&m_BoundsMin, vmin);
+			DirectX::XMStoreFloat3(&m_BoundsMax, vmax);
+		}
+	}
+
 	std::vector<Material*>&		mat = manager.GetMaterial(m_ModelPath);
 	std::vector<ResMaterial>	res = manager.GetResMaterial(m_ModelPath);
 
 	DirectX::ResourceUploadBatch batch(pDevice.Get());
-	batch.Begin(); // ob`Jn.
+	batch.Begin(); // バッチ開始.
 
 	for (size_t i = 0; i < mat.size(); i++)
 	{
-		// }eA̒萔obt@lǂݎ
+		// マテリアルの定数バッファ値を読み取る
 		// auto ptr = reinterpret_cast<CommonCb::CbMaterial*>(mat[i]->GetBufferPtr(0));
 		// ptr->Param00 = Vector4(0.0f, 0.0f, 0.0f, 0.0f);
 
@@ -39,6 +57,10 @@ bool Model::LoadModel(std::wstring filePath, ComPtr<ID3D12Device> pDevice, Descr
 		}
 		mat[i]->SetShaderPtr(p);
 
+		// テクスチャが無い場合の既定値. 法線は平坦, メタリックは0とする.
+		mat[i]->SetFallbackTexture(0, Material::TEXTURE_USAGE_03, FallbackTexture::TYPE_FLAT_NORMAL);
+		mat[i]->SetFallbackTexture(0, Material::TEXTURE_USAGE_05, FallbackTexture::TYPE_BLACK);
+
 		SetTexture(mat[i], Material::TEXTURE_USAGE_03, res[i].NormalMap,		pDevice, resPool, true, batch, manager);
 		SetTexture(mat[i], Material::TEXTURE_USAGE_04, res[i].DiffuseMap,		pDevice, resPool, false, batch, manager);
 		SetTexture(mat[i], Material::TEXTURE_USAGE_05, res[i].SpecularMap,		pDevice, resPool, false, batch, manager);
@@ -47,10 +69,42 @@ bool Model::LoadModel(std::wstring filePath, ComPtr<ID3D12Device> pDevice, Descr
 		SetTexture(mat[i], Material::TEXTURE_USAGE_08, res[i].OpacityMap,		pDevice, resPool, false, batch, manager);
 		SetTexture(mat[i], Material::TEXTURE_USAGE_09, res[i].EmissiveMap,		pDevice, resPool, false, batch, manager);
 		SetTexture(mat[i], Material::TEXTURE_USAGE_10, res[i].DisplacementMap,	pDevice, resPool, false, batch, manager);
+
+		// バインドレス描画用にテクスチャ番号を定数バッファへ書き込んでおく.
+		for (size_t j = 0; j < mat[i]->GetCount(); j++)
+		{
+			auto ptr = mat[i]->GetBufferPtr<CommonCb::CbMaterial>(j);
+			if (ptr == nullptr) continue;
+
+			ptr->BaseColorMap = mat[i]->GetTextureIndex(j, Material::TEXTURE_USAGE_04);
+			ptr->MetallicMap  = mat[i]->GetTextureIndex(j, Material::TEXTURE_USAGE_05);
+			ptr->RoughnessMap = mat[i]->GetTextureIndex(j, Material::TEXTURE_USAGE_06);
+			ptr->NormalMap    = mat[i]->GetTextureIndex(j, Material::TEXTURE_USAGE_03);
+		}
 	}
 	
-	auto future = batch.End(commandQueue.Get()); // ob`I.
-	future.wait();// ob`ҋ@.
+	auto future = batch.End(commandQueue.Get()); // バッチ終了.
+	future.wait();// バッチ完了を待機.
+
+	// マテリアルはモデル間で共有されるので, パラメータはインスタンスで個別に持つ.
+	for (size_t i = 0; i < mat.size(); i++)
+	{
+		auto pInstance = new (std::nothrow) MaterialInstance();
+		if (pInstance == nullptr)
+		{
+			ELOG("Error : Out of memory.");
+			return false;
+		}
+
+		if (!pInstance->Init(mat[i], pParamBuffer))
+		{
+			ELOG("Error : MaterialInstance::Init() Failed.");
+			delete pInstance;
+			return false;
+		}
+
+		m_MaterialInstances.push_back(pInstance);
+	}
 
 	return true;
 }
@@ -59,6 +113,18 @@ std::vector<Material*> Model::GetMaterials() {
 	return  AppResourceManager::GetInstance().GetMaterial(m_ModelPath);
 }
 
+const std::vector<MaterialInstance*>& Model::GetMaterialInstances() const {
+	return m_MaterialInstances;
+}
+
+const DirectX::XMFLOAT3& Model::GetBoundsMin() const {
+	return m_BoundsMin;
+}
+
+const DirectX::XMFLOAT3& Model::GetBoundsMax() const {
+	return m_BoundsMax;
+}
+
 void Model::SetTexture(
 	Material* mat, 
 	Material::TEXTURE_USAGE usage, 
@@ -78,7 +144,7 @@ void Model::DrawModelRaw(ID3D12GraphicsCommandList* pCmd, int frameIndex) {
 
 	for (size_t i = 0; i < meshs.size(); ++i)
 	{
-		// bV`.
+		// メッシュを描画.
 		meshs[i]->Draw(pCmd);
 	}
 }
@@ -91,15 +157,40 @@ void Model::DrawModel(ID3D12GraphicsCommandList* pCmd, int frameIndex, CommonBuf
 
 	for (size_t i = 0; i < meshs.size(); ++i)
 	{
-		// }eAݒ
+		// マテリアルを設定
 		auto id = meshs[i]->GetMaterialId();
-		mat[i]->SetMaterial(pCmd, frameIndex, *mat[id], id, m_MeshCB, commonBufferManager, skyManager);
+		mat[id]->SetMaterial(pCmd, frameIndex, *mat[id], 0, m_MaterialInstances[id], m_MeshCB, commonBufferManager, skyManager);
 
-		// bV`.
+		// メッシュを描画.
 		meshs[i]->Draw(pCmd);
 	}
 }
 
+void Model::DrawModelInstanced(ID3D12GraphicsCommandList* pCmd, uint32_t instanceCount) {
+	AppResourceManager&			manager     = AppResourceManager::GetInstance();
+	const std::vector<Mesh*>	meshs		= manager.GetMesh(m_ModelPath);
+
+	for (size_t i = 0; i < meshs.size(); ++i)
+	{
+		// ワールド行列はインスタンスバッファから取得する.
+		meshs[i]->Draw(pCmd, instanceCount);
+	}
+}
+
+void Model::PushDrawItems(RenderQueue& queue, RenderQueue::PASS pass, const DirectX::XMFLOAT4X4& world, float viewDepth)
+{
+	AppResourceManager&				manager	= AppResourceManager::GetInstance();
+	const std::vector<Mesh*>		meshs	= manager.GetMesh(m_ModelPath);
+	const std::vector<Material*>	mat		= manager.GetMaterial(m_ModelPath);
+
+	// ステートの設定は RenderQueue::Submit() でまとめて行う.
+	for (size_t i = 0; i < meshs.size(); ++i)
+	{
+		auto id = meshs[i]->GetMaterialId();
+		queue.Push(pass, meshs[i], mat[id], m_MaterialInstances[id], m_MeshCB, world, viewDepth);
+	}
+}
+
 bool Model::CreateMeshBuffer(ComPtr<ID3D12Device> pDevice, DescriptorPool* resPool) {
 	for (auto i = 0; i < App::FrameCount; ++i)
 	{
@@ -127,4 +218,10 @@ void Model::Release()
 	{
 		m_MeshCB[i].Term();
 	}
+
+	for (auto pInstance : m_MaterialInstances)
+	{
+		SafeDelete(pInstance);
+	}
+	m_MaterialInstances.clear();
 }
\ No newline at end of file
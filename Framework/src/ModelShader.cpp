@@ -18,4 +18,27 @@ void ModelShader::Term()
 {
 	m_pPSO.Reset();
 	m_RootSig.Term();
-}
\ No newline at end of file
+}
+
+void ModelShader::SetShader(ID3D12GraphicsCommandList* pCmd, int frameindex, Material& mat, int id, const MaterialInstance* pInstance, const ConstantBuffer* meshCB, const CommonBufferManager& commonbufmanager, const SkyManager& manager)
+{
+	SetPassState(pCmd, frameindex, commonbufmanager, manager);
+	SetMaterialState(pCmd, frameindex, mat, id, pInstance);
+	SetMeshState(pCmd, frameindex, meshCB);
+	SetInstanceState(pCmd, pInstance);
+}
+
+bool ModelShader::SupportsInstancing() const
+{
+	return false;
+}
+
+void ModelShader::SetPipelineVariant(ID3D12GraphicsCommandList* pCmd, bool instanced)
+{
+	if (!instanced) pCmd->SetPipelineState(m_pPSO.Get());
+}
+
+void ModelShader::SetInstanceRange(ID3D12GraphicsCommandList* pCmd, D3D12_GPU_DESCRIPTOR_HANDLE instances, uint32_t offset)
+{
+	/* インスタンス描画に対応するシェーダのみ実装する */
+}
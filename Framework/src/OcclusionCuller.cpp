@@ -0,0 +1,753 @@
+﻿//-----------------------------------------------------------------------------
+// File : OcclusionCuller.cpp
+// Desc : Software Occlusion Culling Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <OcclusionCuller.h>
+#include <xmmintrin.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cfloat>
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const float  kSubPixel   = 16.0f;        // 頂点位置を丸める単位(1/16ピクセル)です.
+static const float  kMinArea    = 1.0e-6f;      // これより小さい三角形は描画しません.
+static const float  kMinW       = 1.0e-5f;      // これ以下の w はニア平面をまたいでいるとみなします.
+
+//-----------------------------------------------------------------------------
+//      2つのクリップ座標を線形補間します.
+//-----------------------------------------------------------------------------
+DirectX::XMFLOAT4 LerpClip(const DirectX::XMFLOAT4& a, const DirectX::XMFLOAT4& b, float t)
+{
+	return DirectX::XMFLOAT4(
+		a.x + (b.x - a.x) * t,
+		a.y + (b.y - a.y) * t,
+		a.z + (b.z - a.z) * t,
+		a.w + (b.w - a.w) * t);
+}
+
+//-----------------------------------------------------------------------------
+//      頂点位置をサブピクセル単位に丸めます.
+//-----------------------------------------------------------------------------
+float SnapSubPixel(float value)
+{
+	return std::floor(value * kSubPixel + 0.5f) / kSubPixel;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// OcclusionCuller class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+OcclusionCuller::OcclusionCuller()
+: m_Width       (0)
+, m_Height      (0)
+, m_Pitch       (0)
+, m_PaddedHeight(0)
+, m_TilesX      (0)
+, m_TilesY      (0)
+, m_BlocksX     (0)
+, m_BlocksY     (0)
+, m_Stats       ()
+, m_NextTile    (0)
+, m_Generation  (0)
+, m_Running     (0)
+, m_Quit        (false)
+{
+	DirectX::XMStoreFloat4x4(&m_ViewProj, DirectX::XMMatrixIdentity());
+}
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+OcclusionCuller::~OcclusionCuller()
+{
+	Term();
+}
+
+//-----------------------------------------------------------------------------
+//      初期化処理を行います.
+//-----------------------------------------------------------------------------
+bool OcclusionCuller::Init(uint32_t width, uint32_t height, uint32_t threadCount)
+{
+	if (width == 0 || height == 0)
+	{
+		return false;
+	}
+
+	Term();
+
+	m_Width        = width;
+	m_Height       = height;
+	m_TilesX       = (width  + TileWidth  - 1) / TileWidth;
+	m_TilesY       = (height + TileHeight - 1) / TileHeight;
+	m_Pitch        = m_TilesX * TileWidth;
+	m_PaddedHeight = m_TilesY * TileHeight;
+	m_BlocksX      = m_Pitch / BlockSize;
+	m_BlocksY      = m_PaddedHeight / BlockSize;
+
+	m_Depth.assign(m_Pitch * m_PaddedHeight, 1.0f);
+	m_HiZ  .assign(m_BlocksX * m_BlocksY, 1.0f);
+	m_Bins .resize(m_TilesX * m_TilesY);
+
+	m_Quit       = false;
+	m_Generation = 0;
+	m_Running    = 0;
+	m_NextTile   = 0;
+
+	for (auto i = 0u; i < threadCount; ++i)
+	{
+		m_Workers.emplace_back(&OcclusionCuller::WorkerMain, this);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      終了処理を行います.
+//-----------------------------------------------------------------------------
+void OcclusionCuller::Term()
+{
+	{
+		std::lock_guard<std::mutex> locker(m_Mutex);
+		m_Quit = true;
+	}
+	m_StartCV.notify_all();
+
+	for (auto& worker : m_Workers)
+	{
+		worker.join();
+	}
+	m_Workers.clear();
+
+	m_Depth        .clear();
+	m_HiZ          .clear();
+	m_Bins         .clear();
+	m_Triangles    .clear();
+	m_Occluders    .clear();
+	m_ClipPositions.clear();
+}
+
+//-----------------------------------------------------------------------------
+//      フレームを開始します.
+//-----------------------------------------------------------------------------
+void OcclusionCuller::Begin(const DirectX::XMFLOAT4X4& viewProj)
+{
+	m_ViewProj = viewProj;
+	m_Occluders.clear();
+	m_Stats = Stats();
+}
+
+//-----------------------------------------------------------------------------
+//      遮蔽物を追加します.
+//-----------------------------------------------------------------------------
+void OcclusionCuller::AddOccluder(const Occluder* pOccluder, const DirectX::XMFLOAT4X4& world)
+{
+	if (pOccluder == nullptr || pOccluder->Indices.empty())
+	{
+		return;
+	}
+
+	DrawOccluder item;
+	item.pOccluder = pOccluder;
+	item.World     = world;
+	m_Occluders.push_back(item);
+}
+
+//-----------------------------------------------------------------------------
+//      遮蔽物を深度バッファに描画し, 階層深度を構築します.
+//-----------------------------------------------------------------------------
+void OcclusionCuller::Render()
+{
+	if (m_Depth.empty())
+	{
+		return;
+	}
+
+	auto t0 = std::chrono::high_resolution_clock::now();
+
+	SetupTriangles();
+
+	auto t1 = std::chrono::high_resolution_clock::now();
+
+	// ワーカーを起こし, 呼び出し元のスレッドも含めてタイルを分担する.
+	m_NextTile = 0;
+	{
+		std::lock_guard<std::mutex> locker(m_Mutex);
+		m_Running = uint32_t(m_Workers.size());
+		m_Generation++;
+	}
+	m_StartCV.notify_all();
+
+	RasterizeTiles();
+
+	{
+		std::unique_lock<std::mutex> locker(m_Mutex);
+		m_DoneCV.wait(locker, [this] { return m_Running == 0; });
+	}
+
+	auto t2 = std::chrono::high_resolution_clock::now();
+
+	m_Stats.SetupMicroSec  = std::chrono::duration<double, std::micro>(t1 - t0).count();
+	m_Stats.RasterMicroSec = std::chrono::duration<double, std::micro>(t2 - t1).count();
+}
+
+//-----------------------------------------------------------------------------
+//      ワールド空間のAABBが見えるかどうかを判定します.
+//-----------------------------------------------------------------------------
+bool OcclusionCuller::TestAABB(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extent)
+{
+	if (m_Depth.empty())
+	{
+		return true;
+	}
+
+	m_Stats.Tested++;
+
+	const auto& m = m_ViewProj;
+
+	auto minX = FLT_MAX;
+	auto minY = FLT_MAX;
+	auto maxX = -FLT_MAX;
+	auto maxY = -FLT_MAX;
+	auto minZ = FLT_MAX;
+
+	for (auto i = 0; i < 8; ++i)
+	{
+		auto x = center.x + ((i & 1) ? extent.x : -extent.x);
+		auto y = center.y + ((i & 2) ? extent.y : -extent.y);
+		auto z = center.z + ((i & 4) ? extent.z : -extent.z);
+
+		auto cx = x * m._11 + y * m._21 + z * m._31 + m._41;
+		auto cy = x * m._12 + y * m._22 + z * m._32 + m._42;
+		auto cz = x * m._13 + y * m._23 + z * m._33 + m._43;
+		auto cw = x * m._14 + y * m._24 + z * m._34 + m._44;
+
+		// ニア平面をまたぐ場合は判定できないので見えるものとする.
+		if (cw <= kMinW)
+		{
+			return true;
+		}
+
+		auto invW = 1.0f / cw;
+		auto sx = ( cx * invW * 0.5f + 0.5f) * float(m_Width);
+		auto sy = (-cy * invW * 0.5f + 0.5f) * float(m_Height);
+
+		minX = std::min(minX, sx);
+		maxX = std::max(maxX, sx);
+		minY = std::min(minY, sy);
+		maxY = std::max(maxY, sy);
+		minZ = std::min(minZ, cz * invW);
+	}
+
+	// 画面外.
+	if (maxX < 0.0f || maxY < 0.0f || minX >= float(m_Width) || minY >= float(m_Height))
+	{
+		m_Stats.Occluded++;
+		return false;
+	}
+
+	auto x0 = std::max(int32_t(std::floor(minX)), 0);
+	auto y0 = std::max(int32_t(std::floor(minY)), 0);
+	auto x1 = std::min(int32_t(std::floor(maxX)), int32_t(m_Width  - 1));
+	auto y1 = std::min(int32_t(std::floor(maxY)), int32_t(m_Height - 1));
+
+	auto bx0 = x0 / int32_t(BlockSize);
+	auto by0 = y0 / int32_t(BlockSize);
+	auto bx1 = x1 / int32_t(BlockSize);
+	auto by1 = y1 / int32_t(BlockSize);
+
+	for (auto by = by0; by <= by1; ++by)
+	{
+		for (auto bx = bx0; bx <= bx1; ++bx)
+		{
+			// ブロック内の最大深度より手前にあれば, ブロック全体が遮蔽している.
+			if (m_HiZ[by * m_BlocksX + bx] < minZ)
+			{
+				continue;
+			}
+
+			auto px0 = std::max(bx * int32_t(BlockSize), x0);
+			auto py0 = std::max(by * int32_t(BlockSize), y0);
+			auto px1 = std::min(bx * int32_t(BlockSize) + int32_t(BlockSize) - 1, x1);
+			auto py1 = std::min(by * int32_t(BlockSize) + int32_t(BlockSize) - 1, y1);
+
+			for (auto py = py0; py <= py1; ++py)
+			{
+				auto pRow = &m_Depth[py * m_Pitch];
+				for (auto px = px0; px <= px1; ++px)
+				{
+					if (pRow[px] >= minZ)
+					{
+						return true;
+					}
+				}
+			}
+		}
+	}
+
+	m_Stats.Occluded++;
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+//      Render() と同じ三角形を1スレッド・1ピクセルずつ描画します.
+//-----------------------------------------------------------------------------
+void OcclusionCuller::RenderReference(std::vector<float>& depth) const
+{
+	depth.assign(m_Pitch * m_PaddedHeight, 1.0f);
+
+	for (const auto& tri : m_Triangles)
+	{
+		for (auto y = tri.MinY; y <= tri.MaxY; ++y)
+		{
+			auto py = float(y) + 0.5f;
+			float rowE[3];
+			for (auto i = 0; i < 3; ++i)
+			{
+				rowE[i] = tri.EdgeB[i] * py + tri.EdgeC[i];
+			}
+			auto rowZ = tri.DepthB * py + tri.DepthC;
+
+			for (auto x = tri.MinX; x <= tri.MaxX; ++x)
+			{
+				auto px = float(x) + 0.5f;
+
+				auto e0 = tri.EdgeA[0] * px + rowE[0];
+				auto e1 = tri.EdgeA[1] * px + rowE[1];
+				auto e2 = tri.EdgeA[2] * px + rowE[2];
+				if (e0 < 0.0f || e1 < 0.0f || e2 < 0.0f)
+				{
+					continue;
+				}
+
+				auto z = tri.DepthA * px + rowZ;
+				auto& d = depth[y * m_Pitch + x];
+				if (z <= d)
+				{
+					d = z;
+				}
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      ResMesh から遮蔽物を生成します.
+//-----------------------------------------------------------------------------
+bool OcclusionCuller::BuildOccluder
+(
+	const std::vector<ResMesh>& meshes,
+	uint32_t                    maxTriangles,
+	Occluder&                   occluder
+)
+{
+	occluder.Positions.clear();
+	occluder.Indices  .clear();
+
+	size_t triangleCount = 0;
+	for (const auto& mesh : meshes)
+	{
+		triangleCount += mesh.Indices.size() / 3;
+	}
+
+	if (triangleCount == 0 || triangleCount > maxTriangles)
+	{
+		return false;
+	}
+
+	for (const auto& mesh : meshes)
+	{
+		auto base = uint32_t(occluder.Positions.size());
+
+		for (const auto& vertex : mesh.Vertices)
+		{
+			occluder.Positions.push_back(vertex.Position);
+		}
+
+		auto count = mesh.Indices.size() / 3 * 3;
+		for (size_t i = 0; i < count; ++i)
+		{
+			occluder.Indices.push_back(base + mesh.Indices[i]);
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      深度バッファを取得します.
+//-----------------------------------------------------------------------------
+const float* OcclusionCuller::GetDepth() const
+{
+	return m_Depth.data();
+}
+
+//-----------------------------------------------------------------------------
+//      深度バッファの1行の要素数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t OcclusionCuller::GetPitch() const
+{
+	return m_Pitch;
+}
+
+//-----------------------------------------------------------------------------
+//      深度バッファの横幅を取得します.
+//-----------------------------------------------------------------------------
+uint32_t OcclusionCuller::GetWidth() const
+{
+	return m_Width;
+}
+
+//-----------------------------------------------------------------------------
+//      深度バッファの縦幅を取得します.
+//-----------------------------------------------------------------------------
+uint32_t OcclusionCuller::GetHeight() const
+{
+	return m_Height;
+}
+
+//-----------------------------------------------------------------------------
+//      ワーカースレッド数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t OcclusionCuller::GetThreadCount() const
+{
+	return uint32_t(m_Workers.size());
+}
+
+//-----------------------------------------------------------------------------
+//      直前のフレームの統計情報を取得します.
+//-----------------------------------------------------------------------------
+const OcclusionCuller::Stats& OcclusionCuller::GetStats() const
+{
+	return m_Stats;
+}
+
+//-----------------------------------------------------------------------------
+//      頂点を変換し, 三角形をクリップしてタイルに振り分けます.
+//-----------------------------------------------------------------------------
+void OcclusionCuller::SetupTriangles()
+{
+	m_Triangles.clear();
+	m_Stats.Occluders = 0;
+	m_Stats.Triangles = 0;
+	for (auto& bin : m_Bins)
+	{
+		bin.clear();
+	}
+
+	auto viewProj = DirectX::XMLoadFloat4x4(&m_ViewProj);
+
+	for (const auto& item : m_Occluders)
+	{
+		const auto& positions = item.pOccluder->Positions;
+		const auto& indices   = item.pOccluder->Indices;
+
+		auto world = DirectX::XMLoadFloat4x4(&item.World);
+		auto wvp   = DirectX::XMMatrixMultiply(world, viewProj);
+
+		m_ClipPositions.resize(positions.size());
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			auto pos = DirectX::XMVector3Transform(DirectX::XMLoadFloat3(&positions[i]), wvp);
+			DirectX::XMStoreFloat4(&m_ClipPositions[i], pos);
+		}
+
+		m_Stats.Occluders++;
+		m_Stats.Triangles += uint32_t(indices.size() / 3);
+
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			const DirectX::XMFLOAT4* v[3] = {
+				&m_ClipPositions[indices[i + 0]],
+				&m_ClipPositions[indices[i + 1]],
+				&m_ClipPositions[indices[i + 2]],
+			};
+
+			// 同じ平面の外側にある三角形は描画しない.
+			if ((v[0]->x >  v[0]->w && v[1]->x >  v[1]->w && v[2]->x >  v[2]->w)
+			 || (v[0]->x < -v[0]->w && v[1]->x < -v[1]->w && v[2]->x < -v[2]->w)
+			 || (v[0]->y >  v[0]->w && v[1]->y >  v[1]->w && v[2]->y >  v[2]->w)
+			 || (v[0]->y < -v[0]->w && v[1]->y < -v[1]->w && v[2]->y < -v[2]->w)
+			 || (v[0]->z >  v[0]->w && v[1]->z >  v[1]->w && v[2]->z >  v[2]->w)
+			 || (v[0]->z <  0.0f    && v[1]->z <  0.0f    && v[2]->z <  0.0f   ))
+			{
+				continue;
+			}
+
+			if (v[0]->z >= 0.0f && v[1]->z >= 0.0f && v[2]->z >= 0.0f)
+			{
+				AddTriangle(*v[0], *v[1], *v[2]);
+				continue;
+			}
+
+			// ニア平面(z = 0)でクリップし, 扇状に分割する.
+			DirectX::XMFLOAT4 poly[4];
+			auto count = 0;
+			for (auto j = 0; j < 3; ++j)
+			{
+				const auto& a = *v[j];
+				const auto& b = *v[(j + 1) % 3];
+
+				if (a.z >= 0.0f)
+				{
+					poly[count++] = a;
+				}
+
+				if ((a.z >= 0.0f) != (b.z >= 0.0f))
+				{
+					poly[count++] = LerpClip(a, b, a.z / (a.z - b.z));
+				}
+			}
+
+			for (auto j = 1; j + 1 < count; ++j)
+			{
+				AddTriangle(poly[0], poly[j], poly[j + 1]);
+			}
+		}
+	}
+
+	m_Stats.Rasterized = uint32_t(m_Triangles.size());
+}
+
+//-----------------------------------------------------------------------------
+//      クリップ済みの三角形をセットアップしてタイルに振り分けます.
+//-----------------------------------------------------------------------------
+void OcclusionCuller::AddTriangle
+(
+	const DirectX::XMFLOAT4& c0,
+	const DirectX::XMFLOAT4& c1,
+	const DirectX::XMFLOAT4& c2
+)
+{
+	const DirectX::XMFLOAT4* clip[3] = { &c0, &c1, &c2 };
+
+	float x[3];
+	float y[3];
+	float z[3];
+	for (auto i = 0; i < 3; ++i)
+	{
+		if (clip[i]->w <= kMinW)
+		{
+			return;
+		}
+
+		auto invW = 1.0f / clip[i]->w;
+		x[i] = SnapSubPixel(( clip[i]->x * invW * 0.5f + 0.5f) * float(m_Width));
+		y[i] = SnapSubPixel((-clip[i]->y * invW * 0.5f + 0.5f) * float(m_Height));
+		z[i] = clip[i]->z * invW;
+	}
+
+	auto area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+	if (std::abs(area) < kMinArea)
+	{
+		return;
+	}
+
+	// 遮蔽物は両面とも描画するので, 面積が正となる向きに揃える.
+	if (area < 0.0f)
+	{
+		std::swap(x[1], x[2]);
+		std::swap(y[1], y[2]);
+		std::swap(z[1], z[2]);
+		area = -area;
+	}
+
+	Triangle tri;
+	tri.MinX = std::max(int32_t(std::floor(std::min(std::min(x[0], x[1]), x[2]))), 0);
+	tri.MinY = std::max(int32_t(std::floor(std::min(std::min(y[0], y[1]), y[2]))), 0);
+	tri.MaxX = std::min(int32_t(std::ceil (std::max(std::max(x[0], x[1]), x[2]))), int32_t(m_Width  - 1));
+	tri.MaxY = std::min(int32_t(std::ceil (std::max(std::max(y[0], y[1]), y[2]))), int32_t(m_Height - 1));
+	if (tri.MinX > tri.MaxX || tri.MinY > tri.MaxY)
+	{
+		return;
+	}
+
+	// 辺 i -> j の辺関数 E(p) = A * px + B * py + C は, 内側で正となる.
+	for (auto i = 0; i < 3; ++i)
+	{
+		auto j = (i + 1) % 3;
+		tri.EdgeA[i] = y[i] - y[j];
+		tri.EdgeB[i] = x[j] - x[i];
+		tri.EdgeC[i] = x[i] * y[j] - x[j] * y[i];
+	}
+
+	// z / w はスクリーン空間で線形なので平面で補間する.
+	auto invArea = 1.0f / area;
+	tri.DepthA = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) * invArea;
+	tri.DepthB = ((x[1] - x[0]) * (z[2] - z[0]) - (x[2] - x[0]) * (z[1] - z[0])) * invArea;
+	tri.DepthC = z[0] - tri.DepthA * x[0] - tri.DepthB * y[0];
+
+	auto index = uint32_t(m_Triangles.size());
+	m_Triangles.push_back(tri);
+
+	auto tx0 = uint32_t(tri.MinX) / TileWidth;
+	auto ty0 = uint32_t(tri.MinY) / TileHeight;
+	auto tx1 = uint32_t(tri.MaxX) / TileWidth;
+	auto ty1 = uint32_t(tri.MaxY) / TileHeight;
+
+	for (auto ty = ty0; ty <= ty1; ++ty)
+	{
+		for (auto tx = tx0; tx <= tx1; ++tx)
+		{
+			m_Bins[ty * m_TilesX + tx].push_back(index);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      未処理のタイルがなくなるまでラスタライズします.
+//-----------------------------------------------------------------------------
+void OcclusionCuller::RasterizeTiles()
+{
+	auto tileCount = m_TilesX * m_TilesY;
+	for (;;)
+	{
+		auto tile = m_NextTile.fetch_add(1);
+		if (tile >= tileCount)
+		{
+			break;
+		}
+
+		RasterizeTile(tile);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      1タイル分をラスタライズし, 階層深度を構築します.
+//-----------------------------------------------------------------------------
+void OcclusionCuller::RasterizeTile(uint32_t tile)
+{
+	auto tileX = int32_t((tile % m_TilesX) * TileWidth);
+	auto tileY = int32_t((tile / m_TilesX) * TileHeight);
+
+	for (auto y = 0u; y < TileHeight; ++y)
+	{
+		auto pRow = &m_Depth[(tileY + y) * m_Pitch + tileX];
+		for (auto x = 0u; x < TileWidth; x += 4)
+		{
+			_mm_storeu_ps(pRow + x, _mm_set1_ps(1.0f));
+		}
+	}
+
+	const auto offset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const auto zero   = _mm_setzero_ps();
+
+	for (auto index : m_Bins[tile])
+	{
+		const auto& tri = m_Triangles[index];
+
+		auto x0 = std::max(tri.MinX, tileX);
+		auto y0 = std::max(tri.MinY, tileY);
+		auto x1 = std::min(tri.MaxX, tileX + int32_t(TileWidth)  - 1);
+		auto y1 = std::min(tri.MaxY, tileY + int32_t(TileHeight) - 1);
+
+		auto edgeA0 = _mm_set1_ps(tri.EdgeA[0]);
+		auto edgeA1 = _mm_set1_ps(tri.EdgeA[1]);
+		auto edgeA2 = _mm_set1_ps(tri.EdgeA[2]);
+		auto depthA = _mm_set1_ps(tri.DepthA);
+
+		// 外接矩形の外側のレーンは書き込まない.
+		auto boundMin = _mm_set1_ps(float(x0) + 0.5f);
+		auto boundMax = _mm_set1_ps(float(x1) + 0.5f);
+
+		auto startX = x0 & ~3;
+
+		for (auto y = y0; y <= y1; ++y)
+		{
+			auto py = float(y) + 0.5f;
+			auto rowE0 = _mm_set1_ps(tri.EdgeB[0] * py + tri.EdgeC[0]);
+			auto rowE1 = _mm_set1_ps(tri.EdgeB[1] * py + tri.EdgeC[1]);
+			auto rowE2 = _mm_set1_ps(tri.EdgeB[2] * py + tri.EdgeC[2]);
+			auto rowZ  = _mm_set1_ps(tri.DepthB * py + tri.DepthC);
+
+			auto pRow = &m_Depth[y * m_Pitch];
+
+			for (auto x = startX; x <= x1; x += 4)
+			{
+				auto px = _mm_add_ps(_mm_set1_ps(float(x)), offset);
+
+				auto e0 = _mm_add_ps(_mm_mul_ps(edgeA0, px), rowE0);
+				auto e1 = _mm_add_ps(_mm_mul_ps(edgeA1, px), rowE1);
+				auto e2 = _mm_add_ps(_mm_mul_ps(edgeA2, px), rowE2);
+
+				auto mask = _mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero));
+				mask = _mm_and_ps(mask, _mm_cmpge_ps(e2, zero));
+				mask = _mm_and_ps(mask, _mm_cmpge_ps(px, boundMin));
+				mask = _mm_and_ps(mask, _mm_cmple_ps(px, boundMax));
+				if (_mm_movemask_ps(mask) == 0)
+				{
+					continue;
+				}
+
+				auto z    = _mm_add_ps(_mm_mul_ps(depthA, px), rowZ);
+				auto prev = _mm_loadu_ps(pRow + x);
+				auto next = _mm_min_ps(z, prev);
+				_mm_storeu_ps(pRow + x, _mm_or_ps(_mm_and_ps(mask, next), _mm_andnot_ps(mask, prev)));
+			}
+		}
+	}
+
+	// 8x8 ピクセルごとの最大深度を求める.
+	for (auto by = 0u; by < TileHeight / BlockSize; ++by)
+	{
+		for (auto bx = 0u; bx < TileWidth / BlockSize; ++bx)
+		{
+			auto maxZ = _mm_setzero_ps();
+			for (auto y = 0u; y < BlockSize; ++y)
+			{
+				auto pRow = &m_Depth[(tileY + by * BlockSize + y) * m_Pitch + tileX + bx * BlockSize];
+				maxZ = _mm_max_ps(maxZ, _mm_loadu_ps(pRow + 0));
+				maxZ = _mm_max_ps(maxZ, _mm_loadu_ps(pRow + 4));
+			}
+			maxZ = _mm_max_ps(maxZ, _mm_shuffle_ps(maxZ, maxZ, _MM_SHUFFLE(1, 0, 3, 2)));
+			maxZ = _mm_max_ps(maxZ, _mm_shuffle_ps(maxZ, maxZ, _MM_SHUFFLE(2, 3, 0, 1)));
+
+			auto blockX = tileX / BlockSize + bx;
+			auto blockY = tileY / BlockSize + by;
+			_mm_store_ss(&m_HiZ[blockY * m_BlocksX + blockX], maxZ);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      ワーカースレッドのメインループです.
+//-----------------------------------------------------------------------------
+void OcclusionCuller::WorkerMain()
+{
+	uint32_t generation = 0;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> locker(m_Mutex);
+			m_StartCV.wait(locker, [&] { return m_Quit || m_Generation != generation; });
+			if (m_Quit)
+			{
+				return;
+			}
+			generation = m_Generation;
+		}
+
+		RasterizeTiles();
+
+		{
+			std::lock_guard<std::mutex> locker(m_Mutex);
+			m_Running--;
+		}
+		m_DoneCV.notify_one();
+	}
+}
@@ -0,0 +1,532 @@
+﻿//-----------------------------------------------------------------------------
+// File : PipelineCache.cpp
+// Desc : Pipeline State Cache Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <PipelineCache.h>
+#include <InlineUtil.h>
+#include <Logger.h>
+#include <fstream>
+#include <cstring>
+#include <cwchar>
+#include <chrono>
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// Hasher structure
+///////////////////////////////////////////////////////////////////////////////
+struct Hasher
+{
+	uint64_t Value = 14695981039346656037ull;
+
+	// 構造体のパディングを含めないよう, メンバーごとに追加します.
+	template<typename T>
+	void Add(const T& value)
+	{ Value = HashCombine(Value, value); }
+
+	void AddBytes(const void* pData, size_t size)
+	{
+		Add(uint64_t(size));
+		if (pData != nullptr && size > 0)
+		{ Value = HashBytes(pData, size, Value); }
+	}
+
+	void AddString(const char* str)
+	{ AddBytes(str, (str != nullptr) ? strlen(str) : 0); }
+
+	void AddShader(const D3D12_SHADER_BYTECODE& shader)
+	{ AddBytes(shader.pShaderBytecode, shader.BytecodeLength); }
+};
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// PipelineCache class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      初期化処理を行います.
+//-----------------------------------------------------------------------------
+bool PipelineCache::Init(ID3D12Device* pDevice, const wchar_t* path)
+{
+	if (pDevice == nullptr || path == nullptr)
+	{
+		ELOG("Error : Invalid Argument.");
+		return false;
+	}
+
+	Term();
+
+	std::lock_guard<std::mutex> locker(m_Mutex);
+	m_Path = path;
+
+	auto hr = pDevice->QueryInterface(IID_PPV_ARGS(m_pDevice.GetAddressOf()));
+	if (FAILED(hr))
+	{
+		ELOG("Warning : ID3D12Device1 Not Supported. PipelineLibrary Disabled.");
+		return true;
+	}
+
+	// 前回保存したライブラリを読み込みます.
+	std::ifstream stream(m_Path.c_str(), std::ios::binary);
+	if (stream.is_open())
+	{
+		m_File.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+
+		size_t offset = 0;
+		size_t size   = 0;
+		if (ParseFile(m_File, offset, size))
+		{
+			hr = m_pDevice->CreatePipelineLibrary(&m_File[offset], size, IID_PPV_ARGS(m_pLibrary.GetAddressOf()));
+			if (FAILED(hr))
+			{
+				// ドライバやアダプタが変わった場合は作り直します.
+				ELOG("Warning : PipelineLibrary Discarded. retcode = 0x%x", hr);
+				m_pLibrary.Reset();
+			}
+		}
+		else
+		{
+			ELOG("Warning : PipelineLibrary File Invalid. path = %ls", m_Path.c_str());
+		}
+	}
+
+	if (!m_pLibrary)
+	{
+		m_File.clear();
+		hr = m_pDevice->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(m_pLibrary.GetAddressOf()));
+		if (FAILED(hr))
+		{
+			ELOG("Warning : ID3D12Device1::CreatePipelineLibrary() Failed. retcode = 0x%x", hr);
+			m_pLibrary.Reset();
+			m_pDevice.Reset();
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      終了処理を行います.
+//-----------------------------------------------------------------------------
+void PipelineCache::Term()
+{
+	std::lock_guard<std::mutex> locker(m_Mutex);
+
+	m_Pipelines  .clear();
+	m_RootSigHash.clear();
+	m_RootSigs   .clear();
+
+	// ライブラリが参照しているので, 解放してからファイルの内容を破棄します.
+	m_pLibrary.Reset();
+	m_pDevice .Reset();
+	m_File.clear();
+	m_File.shrink_to_fit();
+	m_Path.clear();
+
+	m_Stats = {};
+	m_Dirty = false;
+}
+
+//-----------------------------------------------------------------------------
+//      追加したパイプラインステートをファイルに保存します.
+//-----------------------------------------------------------------------------
+bool PipelineCache::Save()
+{
+	std::lock_guard<std::mutex> locker(m_Mutex);
+
+	if (!m_pLibrary || !m_Dirty)
+	{
+		return true;
+	}
+
+	std::vector<uint8_t> blob(m_pLibrary->GetSerializedSize());
+	auto hr = m_pLibrary->Serialize(blob.data(), blob.size());
+	if (FAILED(hr))
+	{
+		ELOG("Error : ID3D12PipelineLibrary::Serialize() Failed. retcode = 0x%x", hr);
+		return false;
+	}
+
+	std::vector<uint8_t> file;
+	BuildFile(blob.data(), blob.size(), file);
+
+	std::ofstream stream(m_Path.c_str(), std::ios::binary | std::ios::trunc);
+	if (!stream.is_open())
+	{
+		ELOG("Error : File Open Failed. path = %ls", m_Path.c_str());
+		return false;
+	}
+
+	stream.write(reinterpret_cast<const char*>(file.data()), std::streamsize(file.size()));
+	if (!stream.good())
+	{
+		ELOG("Error : File Write Failed. path = %ls", m_Path.c_str());
+		return false;
+	}
+
+	m_Dirty = false;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ルートシグニチャを取得します.
+//-----------------------------------------------------------------------------
+bool PipelineCache::GetRootSignature(ID3D12Device* pDevice, const void* pBlob, size_t size, ComPtr<ID3D12RootSignature>& pRootSig)
+{
+	if (pDevice == nullptr || pBlob == nullptr || size == 0)
+	{
+		ELOG("Error : Invalid Argument.");
+		return false;
+	}
+
+	std::lock_guard<std::mutex> locker(m_Mutex);
+	m_Stats.RootRequests++;
+
+	auto hash = HashBytes(pBlob, size);
+	auto itr  = m_RootSigs.find(hash);
+	if (itr != m_RootSigs.end())
+	{
+		const auto& blob = itr->second.Blob;
+		if (blob.size() == size && memcmp(blob.data(), pBlob, size) == 0)
+		{
+			m_Stats.RootHits++;
+			pRootSig = itr->second.pRootSig;
+			return true;
+		}
+	}
+
+	ComPtr<ID3D12RootSignature> rootSig;
+	auto hr = pDevice->CreateRootSignature(0, pBlob, size, IID_PPV_ARGS(rootSig.GetAddressOf()));
+	if (FAILED(hr))
+	{
+		ELOG("Error : ID3D12Device::CreateRootSignature() Failed. retcode = 0x%x", hr);
+		return false;
+	}
+
+	// ハッシュ値が衝突した場合は共有せず, パイプラインステートもファイルに保存しません.
+	if (itr == m_RootSigs.end())
+	{
+		auto ptr = static_cast<const uint8_t*>(pBlob);
+
+		RootEntry entry;
+		entry.pRootSig = rootSig;
+		entry.Blob.assign(ptr, ptr + size);
+		m_RootSigs[hash] = std::move(entry);
+		m_RootSigHash[rootSig.Get()] = hash;
+	}
+	else
+	{
+		ELOG("Warning : RootSignature Hash Collision. hash = 0x%016llx", static_cast<unsigned long long>(hash));
+	}
+
+	pRootSig = rootSig;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ルートシグニチャのシリアライズ結果を取得します.
+//-----------------------------------------------------------------------------
+bool PipelineCache::GetRootSignatureBlob(ID3D12RootSignature* pRootSig, std::vector<uint8_t>& blob) const
+{
+	std::lock_guard<std::mutex> locker(m_Mutex);
+
+	auto itr = m_RootSigHash.find(pRootSig);
+	if (itr == m_RootSigHash.end())
+	{
+		return false;
+	}
+
+	blob = m_RootSigs.at(itr->second).Blob;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      パイプラインステートを取得します.
+//-----------------------------------------------------------------------------
+bool PipelineCache::GetGraphicsPipeline(ID3D12Device* pDevice, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, ComPtr<ID3D12PipelineState>& pPSO)
+{
+	if (pDevice == nullptr)
+	{
+		ELOG("Error : Invalid Argument.");
+		return false;
+	}
+
+	std::lock_guard<std::mutex> locker(m_Mutex);
+	m_Stats.Requests++;
+
+	// ここで生成していないルートシグニチャは内容が分からないので, ファイルには保存しません.
+	auto itr      = m_RootSigHash.find(desc.pRootSignature);
+	auto persist  = (itr != m_RootSigHash.end()) && m_pLibrary;
+	auto descHash = HashDesc(desc, (itr != m_RootSigHash.end()) ? itr->second : 0);
+	auto key      = MakeKey(descHash, desc.pRootSignature);
+
+	auto found = m_Pipelines.find(key);
+	if (found != m_Pipelines.end())
+	{
+		m_Stats.MemoryHits++;
+		pPSO = found->second;
+		return true;
+	}
+
+	auto t0 = std::chrono::high_resolution_clock::now();
+
+	wchar_t name[NameLength];
+	MakeName(descHash, name);
+
+	ComPtr<ID3D12PipelineState> pipeline;
+	if (persist)
+	{
+		auto hr = m_pLibrary->LoadGraphicsPipeline(name, &desc, IID_PPV_ARGS(pipeline.GetAddressOf()));
+		if (SUCCEEDED(hr))
+		{
+			m_Stats.LibraryHits++;
+		}
+		else
+		{
+			pipeline.Reset();
+		}
+	}
+
+	if (!pipeline)
+	{
+		auto hr = pDevice->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(pipeline.GetAddressOf()));
+		if (FAILED(hr))
+		{
+			ELOG("Error : ID3D12Device::CreateGraphicsPipelineState() Failed. retcode = 0x%x", hr);
+			return false;
+		}
+		m_Stats.Compiled++;
+
+		if (persist)
+		{
+			// 同じ名前で内容が異なる場合は失敗しますが, 生成したものはそのまま使います.
+			hr = m_pLibrary->StorePipeline(name, pipeline.Get());
+			if (SUCCEEDED(hr))
+			{
+				m_Stats.Stored++;
+				m_Dirty = true;
+			}
+			else
+			{
+				ELOG("Warning : ID3D12PipelineLibrary::StorePipeline() Failed. name = %ls, retcode = 0x%x", name, hr);
+			}
+		}
+	}
+
+	auto t1 = std::chrono::high_resolution_clock::now();
+	m_Stats.MilliSec += std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+	m_Pipelines[key] = pipeline;
+	pPSO = pipeline;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      統計情報を取得します.
+//-----------------------------------------------------------------------------
+const PipelineCache::Stats& PipelineCache::GetStats() const
+{
+	return m_Stats;
+}
+
+//-----------------------------------------------------------------------------
+//      生成済みのパイプラインステート数を取得します.
+//-----------------------------------------------------------------------------
+size_t PipelineCache::GetCount() const
+{
+	std::lock_guard<std::mutex> locker(m_Mutex);
+	return m_Pipelines.size();
+}
+
+//-----------------------------------------------------------------------------
+//      生成済みのルートシグニチャ数を取得します.
+//-----------------------------------------------------------------------------
+size_t PipelineCache::GetRootSignatureCount() const
+{
+	std::lock_guard<std::mutex> locker(m_Mutex);
+	return m_RootSigs.size();
+}
+
+//-----------------------------------------------------------------------------
+//      パイプラインライブラリを使用しているかどうかチェックします.
+//-----------------------------------------------------------------------------
+bool PipelineCache::HasLibrary() const
+{
+	std::lock_guard<std::mutex> locker(m_Mutex);
+	return m_pLibrary.Get() != nullptr;
+}
+
+//-----------------------------------------------------------------------------
+//      パイプラインステートの構成のハッシュ値を求めます.
+//-----------------------------------------------------------------------------
+uint64_t PipelineCache::HashDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSigHash)
+{
+	Hasher h;
+	h.Add(rootSigHash);
+
+	// シェーダはポインタではなくバイトコードの内容で区別します.
+	h.AddShader(desc.VS);
+	h.AddShader(desc.PS);
+	h.AddShader(desc.DS);
+	h.AddShader(desc.HS);
+	h.AddShader(desc.GS);
+
+	const auto& so = desc.StreamOutput;
+	h.Add(so.NumEntries);
+	for (auto i = 0u; i < so.NumEntries && so.pSODeclaration != nullptr; ++i)
+	{
+		const auto& entry = so.pSODeclaration[i];
+		h.Add(entry.Stream);
+		h.AddString(entry.SemanticName);
+		h.Add(entry.SemanticIndex);
+		h.Add(entry.StartComponent);
+		h.Add(entry.ComponentCount);
+		h.Add(entry.OutputSlot);
+	}
+	h.AddBytes(so.pBufferStrides, (so.pBufferStrides != nullptr) ? sizeof(UINT) * so.NumStrides : 0);
+	h.Add(so.RasterizedStream);
+
+	const auto& blend = desc.BlendState;
+	h.Add(blend.AlphaToCoverageEnable);
+	h.Add(blend.IndependentBlendEnable);
+	for (auto i = 0; i < D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT; ++i)
+	{
+		const auto& rt = blend.RenderTarget[i];
+		h.Add(rt.BlendEnable);
+		h.Add(rt.LogicOpEnable);
+		h.Add(rt.SrcBlend);
+		h.Add(rt.DestBlend);
+		h.Add(rt.BlendOp);
+		h.Add(rt.SrcBlendAlpha);
+		h.Add(rt.DestBlendAlpha);
+		h.Add(rt.BlendOpAlpha);
+		h.Add(rt.LogicOp);
+		h.Add(rt.RenderTargetWriteMask);
+	}
+	h.Add(desc.SampleMask);
+
+	const auto& rs = desc.RasterizerState;
+	h.Add(rs.FillMode);
+	h.Add(rs.CullMode);
+	h.Add(rs.FrontCounterClockwise);
+	h.Add(rs.DepthBias);
+	h.Add(rs.DepthBiasClamp);
+	h.Add(rs.SlopeScaledDepthBias);
+	h.Add(rs.DepthClipEnable);
+	h.Add(rs.MultisampleEnable);
+	h.Add(rs.AntialiasedLineEnable);
+	h.Add(rs.ForcedSampleCount);
+	h.Add(rs.ConservativeRaster);
+
+	const auto& ds = desc.DepthStencilState;
+	h.Add(ds.DepthEnable);
+	h.Add(ds.DepthWriteMask);
+	h.Add(ds.DepthFunc);
+	h.Add(ds.StencilEnable);
+	h.Add(ds.StencilReadMask);
+	h.Add(ds.StencilWriteMask);
+	for (const auto& face : { ds.FrontFace, ds.BackFace })
+	{
+		h.Add(face.StencilFailOp);
+		h.Add(face.StencilDepthFailOp);
+		h.Add(face.StencilPassOp);
+		h.Add(face.StencilFunc);
+	}
+
+	const auto& il = desc.InputLayout;
+	h.Add(il.NumElements);
+	for (auto i = 0u; i < il.NumElements && il.pInputElementDescs != nullptr; ++i)
+	{
+		const auto& elem = il.pInputElementDescs[i];
+		h.AddString(elem.SemanticName);
+		h.Add(elem.SemanticIndex);
+		h.Add(elem.Format);
+		h.Add(elem.InputSlot);
+		h.Add(elem.AlignedByteOffset);
+		h.Add(elem.InputSlotClass);
+		h.Add(elem.InstanceDataStepRate);
+	}
+
+	h.Add(desc.IBStripCutValue);
+	h.Add(desc.PrimitiveTopologyType);
+
+	// 使用しないレンダーターゲットのフォーマットは含めません.
+	auto count = (desc.NumRenderTargets < D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT) ? desc.NumRenderTargets : D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT;
+	h.Add(desc.NumRenderTargets);
+	for (auto i = 0u; i < count; ++i)
+	{ h.Add(desc.RTVFormats[i]); }
+
+	h.Add(desc.DSVFormat);
+	h.Add(desc.SampleDesc.Count);
+	h.Add(desc.SampleDesc.Quality);
+	h.Add(desc.NodeMask);
+	h.Add(desc.Flags);
+
+	return h.Value;
+}
+
+//-----------------------------------------------------------------------------
+//      メモリ上で共有するためのキーを求めます.
+//-----------------------------------------------------------------------------
+uint64_t PipelineCache::MakeKey(uint64_t descHash, const ID3D12RootSignature* pRootSig)
+{
+	// パイプラインステートは生成時のルートシグニチャを参照するので区別します.
+	return HashCombine(descHash, uint64_t(reinterpret_cast<uintptr_t>(pRootSig)));
+}
+
+//-----------------------------------------------------------------------------
+//      パイプラインライブラリに登録する名前を求めます.
+//-----------------------------------------------------------------------------
+void PipelineCache::MakeName(uint64_t descHash, wchar_t (&name)[NameLength])
+{
+	swprintf(name, NameLength, L"PSO_%016llx", static_cast<unsigned long long>(descHash));
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルに書き出すデータを構築します.
+//-----------------------------------------------------------------------------
+void PipelineCache::BuildFile(const void* pBlob, size_t size, std::vector<uint8_t>& file)
+{
+	FileHeader header = {};
+	header.Magic   = FileMagic;
+	header.Version = FileVersion;
+	header.Size    = size;
+
+	file.resize(sizeof(header) + size);
+	memcpy(file.data(), &header, sizeof(header));
+	if (size > 0)
+	{ memcpy(file.data() + sizeof(header), pBlob, size); }
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルから読み込んだデータを検証します.
+//-----------------------------------------------------------------------------
+bool PipelineCache::ParseFile(const std::vector<uint8_t>& file, size_t& offset, size_t& size)
+{
+	FileHeader header = {};
+	if (file.size() < sizeof(header))
+	{
+		return false;
+	}
+
+	memcpy(&header, file.data(), sizeof(header));
+	if (header.Magic != FileMagic || header.Version != FileVersion)
+	{
+		return false;
+	}
+
+	if (header.Size == 0 || header.Size != file.size() - sizeof(header))
+	{
+		return false;
+	}
+
+	offset = sizeof(header);
+	size   = size_t(header.Size);
+	return true;
+}
@@ -0,0 +1,527 @@
+﻿//-----------------------------------------------------------------------------
+// File : Profiler.cpp
+// Desc : Hierarchical CPU Profiler Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <Profiler.h>
+#include <Logger.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const uint64_t kPathSeed  = 0xcbf29ce484222325ull;  // FNV-1a のオフセット基底です.
+const uint64_t kPathPrime = 0x100000001b3ull;       // FNV-1a の素数です.
+
+//-----------------------------------------------------------------------------
+// ThreadCache structure
+//-----------------------------------------------------------------------------
+struct ThreadCache
+{
+	uint64_t    Owner;      // 登録先のプロファイラの識別子です.
+	void*       pBuffer;    // 登録先のスレッドバッファです.
+};
+
+//-----------------------------------------------------------------------------
+// Global Variables.
+//-----------------------------------------------------------------------------
+std::atomic<uint64_t> g_NextId(1);     // 次に割り当てる識別子です.
+
+//-----------------------------------------------------------------------------
+// Thread Local Variables.
+//-----------------------------------------------------------------------------
+thread_local ThreadCache t_Cache = { 0, nullptr };  // 呼び出し元のスレッドバッファです.
+
+//-----------------------------------------------------------------------------
+//      親のパスに名前を連結したハッシュを求めます.
+//-----------------------------------------------------------------------------
+uint64_t HashPath(uint64_t parent, const char* name)
+{
+	auto hash = parent;
+	for (auto p = name; *p != '\0'; ++p)
+	{
+		hash ^= uint8_t(*p);
+		hash *= kPathPrime;
+	}
+
+	// 親子の区切りです.
+	hash ^= uint8_t('/');
+	hash *= kPathPrime;
+	return hash;
+}
+
+//-----------------------------------------------------------------------------
+//      JSON の文字列として出力します.
+//-----------------------------------------------------------------------------
+void AppendEscaped(std::string& json, const char* text)
+{
+	json += '"';
+	for (auto p = text; *p != '\0'; ++p)
+	{
+		auto c = *p;
+		if (c == '"' || c == '\\')
+		{
+			json += '\\';
+			json += c;
+		}
+		else if (uint8_t(c) < 0x20)
+		{
+			char code[8];
+			snprintf(code, sizeof(code), "\\u%04x", unsigned(uint8_t(c)));
+			json += code;
+		}
+		else
+		{
+			json += c;
+		}
+	}
+	json += '"';
+}
+
+} // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Profiler class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+Profiler::Profiler()
+: m_Id              (g_NextId.fetch_add(1))
+, m_Enable          (true)
+, m_CaptureRemain   (0)
+, m_CapturedFrames  (0)
+, m_FrameCount      (0)
+, m_FrameBegin      (0)
+, m_FrameMs         (0.0)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+Profiler::~Profiler()
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      記録するかどうかを設定します.
+//-----------------------------------------------------------------------------
+void Profiler::SetEnable(bool enable)
+{
+	m_Enable.store(enable, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+//      記録するかどうかを取得します.
+//-----------------------------------------------------------------------------
+bool Profiler::IsEnabled() const
+{
+	return m_Enable.load(std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+//      呼び出し元のスレッドの名前を設定します.
+//-----------------------------------------------------------------------------
+void Profiler::SetThreadName(const char* name)
+{
+	auto pBuffer = GetThreadBuffer();
+
+	std::lock_guard<std::mutex> locker(m_Mutex);
+	pBuffer->Name = (name != nullptr) ? name : "";
+}
+
+//-----------------------------------------------------------------------------
+//      スレッドの名前を取得します.
+//-----------------------------------------------------------------------------
+std::string Profiler::GetThreadName(uint32_t thread) const
+{
+	std::lock_guard<std::mutex> locker(m_Mutex);
+	return (thread < m_Threads.size()) ? m_Threads[thread]->Name : std::string();
+}
+
+//-----------------------------------------------------------------------------
+//      フレームを開始します.
+//-----------------------------------------------------------------------------
+void Profiler::BeginFrame()
+{
+	m_FrameBegin = GetTicks();
+}
+
+//-----------------------------------------------------------------------------
+//      フレームを終了し, 全スレッドのイベントから階層と統計を求めます.
+//-----------------------------------------------------------------------------
+void Profiler::EndFrame()
+{
+	auto frameEnd = GetTicks();
+	m_FrameMs = (m_FrameBegin != 0) ? double(frameEnd - m_FrameBegin) * 1e-6 : 0.0;
+
+	// 各スレッドのリングバッファから, 書き込み済みのイベントを取り出します.
+	m_FrameEvents.clear();
+	{
+		std::lock_guard<std::mutex> locker(m_Mutex);
+		for (auto& pBuffer : m_Threads)
+		{
+			auto read  = pBuffer->Read .load(std::memory_order_relaxed);
+			auto write = pBuffer->Write.load(std::memory_order_acquire);
+			for (; read < write; ++read)
+			{ m_FrameEvents.push_back(pBuffer->Ring[read % RingSize]); }
+
+			pBuffer->Read.store(write, std::memory_order_release);
+		}
+
+		m_FrameEvents.insert(m_FrameEvents.end(), m_External.begin(), m_External.end());
+		m_External.clear();
+	}
+
+	// スレッド, 開始時刻, 深さの順に並べると, 親は子より前に来ます.
+	std::sort(m_FrameEvents.begin(), m_FrameEvents.end(), [](const Event& a, const Event& b)
+	{
+		if (a.Thread != b.Thread) { return a.Thread < b.Thread; }
+		if (a.Begin  != b.Begin)  { return a.Begin  < b.Begin; }
+		return a.Depth < b.Depth;
+	});
+
+	m_FrameCount++;
+	m_Nodes.clear();
+	m_Nodes.reserve(m_FrameEvents.size());
+
+	uint32_t stackNode[MaxDepth];
+	int64_t  stackEnd [MaxDepth];
+	auto     thread = InvalidIndex;
+	auto     base   = int64_t(0);
+
+	for (const auto& e : m_FrameEvents)
+	{
+		// CPU はフレームの開始, GPU は読み戻したフレームの先頭を基準にします.
+		if (e.Thread != thread)
+		{
+			thread = e.Thread;
+			base   = (thread == GpuThread || m_FrameBegin == 0) ? e.Begin : m_FrameBegin;
+			std::fill(stackNode, stackNode + MaxDepth, InvalidIndex);
+		}
+
+		auto depth  = std::min(e.Depth, MaxDepth - 1);
+		auto parent = (depth > 0) ? stackNode[depth - 1] : InvalidIndex;
+
+		// 親が取りこぼされた場合は, 直前の兄弟の子にしないよう根として扱います.
+		if (parent != InvalidIndex && e.Begin >= stackEnd[depth - 1])
+		{ parent = InvalidIndex; }
+
+		Node node;
+		node.Name       = e.Name;
+		node.Path       = HashPath((parent != InvalidIndex) ? m_Nodes[parent].Path : kPathSeed, e.Name);
+		node.Thread     = e.Thread;
+		node.Parent     = parent;
+		node.Depth      = depth;
+		node.StartMs    = double(e.Begin - base)    * 1e-6;
+		node.DurationMs = double(e.End   - e.Begin) * 1e-6;
+		node.AvgMs      = 0.0;
+		node.MinMs      = 0.0;
+		node.MaxMs      = 0.0;
+
+		stackNode[depth] = uint32_t(m_Nodes.size());
+		stackEnd [depth] = e.End;
+		m_Nodes.push_back(node);
+
+		// 同じパスはスレッドをまたいでフレームごとに合計します.
+		auto& stats = m_Stats[node.Path];
+		if (stats.Frame == 0)
+		{ stats.Stats.Init(StatsCount); }
+		if (stats.Frame != m_FrameCount)
+		{
+			stats.Frame = m_FrameCount;
+			stats.Total = 0.0;
+		}
+		stats.Total += node.DurationMs;
+	}
+
+	for (auto& itr : m_Stats)
+	{
+		auto& stats = itr.second;
+		if (stats.Frame != m_FrameCount)
+		{ continue; }
+
+		stats.Stats.Push(stats.Total);
+		stats.Avg = stats.Stats.GetAverage();
+		stats.Min = stats.Stats.GetPercentile(0.0);
+		stats.Max = stats.Stats.GetPercentile(100.0);
+	}
+
+	for (auto& node : m_Nodes)
+	{
+		const auto& stats = m_Stats[node.Path];
+		node.AvgMs = stats.Avg;
+		node.MinMs = stats.Min;
+		node.MaxMs = stats.Max;
+	}
+
+	if (m_CaptureRemain > 0)
+	{
+		m_Captured.insert(m_Captured.end(), m_FrameEvents.begin(), m_FrameEvents.end());
+		m_CaptureRemain--;
+		m_CapturedFrames++;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      呼び出し元のスレッドでスコープを開始します.
+//-----------------------------------------------------------------------------
+void Profiler::Push(const char* name)
+{
+	auto pBuffer = GetThreadBuffer();
+	if (pBuffer->Depth < MaxDepth)
+	{
+		pBuffer->StackName [pBuffer->Depth] = name;
+		pBuffer->StackBegin[pBuffer->Depth] = GetTicks();
+	}
+
+	// 深すぎる場合も Pop() と対応させるため深さは数えます.
+	pBuffer->Depth++;
+}
+
+//-----------------------------------------------------------------------------
+//      呼び出し元のスレッドで最後に開始したスコープを終了します.
+//-----------------------------------------------------------------------------
+void Profiler::Pop()
+{
+	auto end     = GetTicks();
+	auto pBuffer = GetThreadBuffer();
+	if (pBuffer->Depth == 0)
+	{ return; }
+
+	pBuffer->Depth--;
+	auto depth = pBuffer->Depth;
+	if (depth >= MaxDepth)
+	{ return; }
+
+	// 集計が追いつかない場合は新しいイベントを破棄します.
+	auto write = pBuffer->Write.load(std::memory_order_relaxed);
+	if (write - pBuffer->Read.load(std::memory_order_acquire) >= RingSize)
+	{
+		pBuffer->Dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	auto& e  = pBuffer->Ring[write % RingSize];
+	e.Name   = pBuffer->StackName [depth];
+	e.Begin  = pBuffer->StackBegin[depth];
+	e.End    = end;
+	e.Thread = pBuffer->Index;
+	e.Depth  = depth;
+	pBuffer->Write.store(write + 1, std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------
+//      計測済みのイベントを追加します.
+//-----------------------------------------------------------------------------
+void Profiler::AddEvent(const char* name, uint32_t thread, int64_t begin, int64_t end, uint32_t depth)
+{
+	if (name == nullptr || end < begin)
+	{ return; }
+
+	Event e;
+	e.Name   = name;
+	e.Begin  = begin;
+	e.End    = end;
+	e.Thread = thread;
+	e.Depth  = depth;
+
+	std::lock_guard<std::mutex> locker(m_Mutex);
+	m_External.push_back(e);
+}
+
+//-----------------------------------------------------------------------------
+//      直前のフレームのノードを取得します.
+//-----------------------------------------------------------------------------
+const std::vector<Profiler::Node>& Profiler::GetNodes() const
+{
+	return m_Nodes;
+}
+
+//-----------------------------------------------------------------------------
+//      直前のフレームの長さ(ミリ秒)を取得します.
+//-----------------------------------------------------------------------------
+double Profiler::GetFrameMs() const
+{
+	return m_FrameMs;
+}
+
+//-----------------------------------------------------------------------------
+//      リングバッファが溢れて破棄したイベント数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t Profiler::GetDroppedCount() const
+{
+	std::lock_guard<std::mutex> locker(m_Mutex);
+
+	auto count = 0u;
+	for (const auto& pBuffer : m_Threads)
+	{ count += pBuffer->Dropped.load(std::memory_order_relaxed); }
+
+	return count;
+}
+
+//-----------------------------------------------------------------------------
+//      指定フレーム数のイベントの取り込みを開始します.
+//-----------------------------------------------------------------------------
+void Profiler::Capture(uint32_t frames)
+{
+	m_Captured.clear();
+	m_CaptureRemain  = frames;
+	m_CapturedFrames = 0;
+}
+
+//-----------------------------------------------------------------------------
+//      取り込み中かどうかを取得します.
+//-----------------------------------------------------------------------------
+bool Profiler::IsCapturing() const
+{
+	return m_CaptureRemain > 0;
+}
+
+//-----------------------------------------------------------------------------
+//      取り込んだフレーム数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t Profiler::GetCapturedFrames() const
+{
+	return m_CapturedFrames;
+}
+
+//-----------------------------------------------------------------------------
+//      取り込んだイベントを Chrome Trace Event 形式の JSON で出力します.
+//-----------------------------------------------------------------------------
+void Profiler::ExportChromeTrace(std::string& json) const
+{
+	json.clear();
+	json += "{\"traceEvents\":[";
+
+	// chrome://tracing で見やすいよう, 時刻は最初のイベントからのマイクロ秒にします.
+	std::vector<uint32_t> threads;
+	auto base = int64_t(0);
+	for (size_t i = 0; i < m_Captured.size(); ++i)
+	{
+		threads.push_back(m_Captured[i].Thread);
+		base = (i == 0) ? m_Captured[i].Begin : std::min(base, m_Captured[i].Begin);
+	}
+	std::sort(threads.begin(), threads.end());
+	threads.erase(std::unique(threads.begin(), threads.end()), threads.end());
+
+	char text[256];
+	auto first = true;
+	for (auto thread : threads)
+	{
+		auto name = (thread == GpuThread) ? std::string("GPU") : GetThreadName(thread);
+		if (name.empty())
+		{
+			snprintf(text, sizeof(text), "Thread %u", thread);
+			name = text;
+		}
+
+		snprintf(text, sizeof(text), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",", thread);
+		json += text;
+		AppendEscaped(json, name.c_str());
+		json += "}}";
+		first = false;
+	}
+
+	for (const auto& e : m_Captured)
+	{
+		json += first ? "{\"name\":" : ",{\"name\":";
+		AppendEscaped(json, e.Name);
+
+		snprintf(text, sizeof(text), ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+			(e.Thread == GpuThread) ? "gpu" : "cpu",
+			e.Thread,
+			double(e.Begin - base) * 1e-3,
+			double(e.End - e.Begin) * 1e-3);
+		json += text;
+		first = false;
+	}
+
+	json += "],\"displayTimeUnit\":\"ms\"}";
+}
+
+//-----------------------------------------------------------------------------
+//      取り込んだイベントを Chrome Trace Event 形式のファイルに保存します.
+//-----------------------------------------------------------------------------
+bool Profiler::SaveChromeTrace(const char* path) const
+{
+	std::string json;
+	ExportChromeTrace(json);
+
+	std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+	if (!stream.is_open())
+	{
+		ELOG("Error : File Open Failed. path = %s", path);
+		return false;
+	}
+
+	stream.write(json.data(), std::streamsize(json.size()));
+	if (!stream.good())
+	{
+		ELOG("Error : File Write Failed. path = %s", path);
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      現在時刻(ナノ秒)を取得します.
+//-----------------------------------------------------------------------------
+int64_t Profiler::GetTicks()
+{
+	auto now = std::chrono::high_resolution_clock::now().time_since_epoch();
+	return int64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+//-----------------------------------------------------------------------------
+//      呼び出し元のスレッドバッファを取得します.
+//-----------------------------------------------------------------------------
+Profiler::ThreadBuffer* Profiler::GetThreadBuffer()
+{
+	if (t_Cache.Owner == m_Id)
+	{ return static_cast<ThreadBuffer*>(t_Cache.pBuffer); }
+
+	std::lock_guard<std::mutex> locker(m_Mutex);
+
+	// 別のプロファイラを使った後に戻ってきた場合は登録済みのものを使います.
+	auto id      = std::this_thread::get_id();
+	auto pBuffer = static_cast<ThreadBuffer*>(nullptr);
+	for (auto& pItem : m_Threads)
+	{
+		if (pItem->Id == id)
+		{
+			pBuffer = pItem.get();
+			break;
+		}
+	}
+
+	if (pBuffer == nullptr)
+	{
+		std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+		buffer->Ring.resize(RingSize);
+		buffer->Write   = 0;
+		buffer->Read    = 0;
+		buffer->Dropped = 0;
+		buffer->Depth   = 0;
+		buffer->Index   = uint32_t(m_Threads.size());
+		buffer->Id      = id;
+
+		pBuffer = buffer.get();
+		m_Threads.push_back(std::move(buffer));
+	}
+
+	t_Cache.Owner   = m_Id;
+	t_Cache.pBuffer = pBuffer;
+	return pBuffer;
+}
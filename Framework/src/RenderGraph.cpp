@@ -0,0 +1,783 @@
+﻿//-----------------------------------------------------------------------------
+// File : RenderGraph.cpp
+// Desc : Render Graph Compiler Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <RenderGraph.h>
+#include <Logger.h>
+#include <algorithm>
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values
+//-----------------------------------------------------------------------------
+// 書き込みを伴う状態です. これ以外は読み込み同士でまとめられます.
+const D3D12_RESOURCE_STATES kWriteStates = D3D12_RESOURCE_STATES(
+	D3D12_RESOURCE_STATE_RENDER_TARGET
+	| D3D12_RESOURCE_STATE_UNORDERED_ACCESS
+	| D3D12_RESOURCE_STATE_DEPTH_WRITE
+	| D3D12_RESOURCE_STATE_STREAM_OUT
+	| D3D12_RESOURCE_STATE_COPY_DEST
+	| D3D12_RESOURCE_STATE_RESOLVE_DEST);
+
+//-----------------------------------------------------------------------------
+//      読み込み専用の状態かどうかを判定します.
+//-----------------------------------------------------------------------------
+bool IsReadState(D3D12_RESOURCE_STATES state)
+{
+	return state != D3D12_RESOURCE_STATE_COMMON && (state & kWriteStates) == 0;
+}
+
+//-----------------------------------------------------------------------------
+//      アライメントを揃えます.
+//-----------------------------------------------------------------------------
+uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// RenderGraph class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+RenderGraph::RenderGraph()
+: m_LastPass(InvalidIndex)
+, m_HeapSize(0)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+RenderGraph::~RenderGraph()
+{
+	Clear();
+}
+
+//-----------------------------------------------------------------------------
+//      登録したパスとリソースを全て破棄します.
+//-----------------------------------------------------------------------------
+void RenderGraph::Clear()
+{
+	m_Passes.clear();
+	m_Resources.clear();
+	m_FinalBarriers.clear();
+	m_LastPass = InvalidIndex;
+	m_HeapSize = 0;
+	m_Report   = Report();
+}
+
+//-----------------------------------------------------------------------------
+//      一時テクスチャを作成します.
+//-----------------------------------------------------------------------------
+uint32_t RenderGraph::CreateTexture(const char* name, const TextureDesc& desc)
+{
+	ResourceInfo info;
+	info.Name           = (name != nullptr) ? name : "";
+	info.Desc           = desc;
+	info.Imported       = false;
+	info.Exported       = false;
+	info.InitialState   = D3D12_RESOURCE_STATE_COMMON;
+	info.FinalState     = D3D12_RESOURCE_STATE_COMMON;
+	info.CreateState    = D3D12_RESOURCE_STATE_COMMON;
+	info.First          = InvalidIndex;
+	info.Last           = InvalidIndex;
+	info.Offset         = 0;
+	info.Aliased        = false;
+
+	if (info.Desc.Size == 0)
+	{
+		info.Desc.Size = EstimateSize(desc);
+	}
+	if (info.Desc.Alignment == 0)
+	{
+		info.Desc.Alignment = DefaultAlignment;
+	}
+
+	m_Resources.push_back(info);
+	return uint32_t(m_Resources.size() - 1);
+}
+
+//-----------------------------------------------------------------------------
+//      グラフ外で管理するテクスチャを登録します.
+//-----------------------------------------------------------------------------
+uint32_t RenderGraph::ImportTexture(const char* name, D3D12_RESOURCE_STATES initialState, D3D12_RESOURCE_STATES finalState)
+{
+	ResourceInfo info;
+	info.Name           = (name != nullptr) ? name : "";
+	info.Imported       = true;
+	info.Exported       = true;
+	info.InitialState   = initialState;
+	info.FinalState     = finalState;
+	info.CreateState    = initialState;
+	info.First          = InvalidIndex;
+	info.Last           = InvalidIndex;
+	info.Offset         = 0;
+	info.Aliased        = false;
+
+	m_Resources.push_back(info);
+	return uint32_t(m_Resources.size() - 1);
+}
+
+//-----------------------------------------------------------------------------
+//      一時テクスチャをグラフの出力にします.
+//-----------------------------------------------------------------------------
+void RenderGraph::Export(uint32_t resource, D3D12_RESOURCE_STATES finalState)
+{
+	if (resource >= m_Resources.size() || m_Resources[resource].Imported)
+	{
+		return;
+	}
+
+	m_Resources[resource].Exported   = true;
+	m_Resources[resource].FinalState = finalState;
+}
+
+//-----------------------------------------------------------------------------
+//      パスを追加します.
+//-----------------------------------------------------------------------------
+uint32_t RenderGraph::AddPass(const char* name, bool sideEffect)
+{
+	PassInfo info;
+	info.Name       = (name != nullptr) ? name : "";
+	info.SideEffect = sideEffect;
+	info.Culled     = false;
+
+	m_Passes.push_back(info);
+	return uint32_t(m_Passes.size() - 1);
+}
+
+//-----------------------------------------------------------------------------
+//      パスが読み込むリソースを宣言します.
+//-----------------------------------------------------------------------------
+void RenderGraph::Read(uint32_t pass, uint32_t resource, D3D12_RESOURCE_STATES state)
+{
+	AddAccess(pass, resource, state, false);
+}
+
+//-----------------------------------------------------------------------------
+//      パスが書き込むリソースを宣言します.
+//-----------------------------------------------------------------------------
+void RenderGraph::Write(uint32_t pass, uint32_t resource, D3D12_RESOURCE_STATES state)
+{
+	AddAccess(pass, resource, state, true);
+}
+
+//-----------------------------------------------------------------------------
+//      アクセスを登録します.
+//-----------------------------------------------------------------------------
+void RenderGraph::AddAccess(uint32_t pass, uint32_t resource, D3D12_RESOURCE_STATES state, bool write)
+{
+	if (pass >= m_Passes.size() || resource >= m_Resources.size())
+	{
+		return;
+	}
+
+	// 1つのパスで同じリソースに複数回アクセスする場合は1つにまとめます.
+	for (auto& access : m_Passes[pass].Accesses)
+	{
+		if (access.Resource == resource)
+		{
+			access.State = D3D12_RESOURCE_STATES(access.State | state);
+			access.Write = access.Write || write;
+			return;
+		}
+	}
+
+	Access access;
+	access.Resource = resource;
+	access.State    = state;
+	access.Write    = write;
+	m_Passes[pass].Accesses.push_back(access);
+}
+
+//-----------------------------------------------------------------------------
+//      グラフをコンパイルします.
+//-----------------------------------------------------------------------------
+bool RenderGraph::Compile(bool enableAliasing)
+{
+	m_FinalBarriers.clear();
+	m_Report = Report();
+	for (auto& pass : m_Passes)
+	{
+		pass.Culled = false;
+		pass.Barriers.clear();
+		pass.Activations.clear();
+	}
+
+	CullPasses();
+
+	if (!ComputeLifetimes())
+	{
+		return false;
+	}
+
+	PlaceResources(enableAliasing);
+	ComputeBarriers();
+
+	// 統計情報.
+	m_Report.PassCount = uint32_t(m_Passes.size());
+	for (const auto& pass : m_Passes)
+	{
+		if (pass.Culled)
+		{
+			m_Report.CulledCount++;
+		}
+		else if (!pass.Barriers.empty())
+		{
+			m_Report.BatchCount++;
+		}
+
+		for (const auto& access : pass.Accesses)
+		{
+			// 書き込む状態へ遷移して読み込み状態に戻す, 従来の書き方です.
+			if (access.Write)
+			{
+				m_Report.ManualCount += 2;
+			}
+		}
+
+		for (const auto& barrier : pass.Barriers)
+		{
+			switch (barrier.Type)
+			{
+			case BARRIER_TRANSITION: m_Report.TransitionCount++; break;
+			case BARRIER_ALIASING:   m_Report.AliasingCount++;   break;
+			case BARRIER_UAV:        m_Report.UAVCount++;        break;
+			}
+		}
+	}
+
+	if (!m_FinalBarriers.empty())
+	{
+		m_Report.BatchCount++;
+		m_Report.TransitionCount += uint32_t(m_FinalBarriers.size());
+	}
+
+	for (const auto& res : m_Resources)
+	{
+		if (res.Imported || res.First == InvalidIndex)
+		{
+			continue;
+		}
+
+		m_Report.TransientCount++;
+		m_Report.TransientBytes += AlignUp(res.Desc.Size, res.Desc.Alignment);
+		if (res.Aliased)
+		{
+			m_Report.AliasedCount++;
+		}
+	}
+	m_Report.HeapBytes = m_HeapSize;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      出力に寄与しないパスを削除します.
+//-----------------------------------------------------------------------------
+void RenderGraph::CullPasses()
+{
+	// グラフ外のリソースと出力は必要とします.
+	std::vector<bool> needed(m_Resources.size(), false);
+	for (size_t i = 0; i < m_Resources.size(); ++i)
+	{
+		needed[i] = m_Resources[i].Exported;
+	}
+
+	// 後ろのパスから, 必要なリソースに書き込むパスを残します.
+	for (auto i = m_Passes.size(); i > 0; --i)
+	{
+		auto& pass = m_Passes[i - 1];
+
+		auto keep = pass.SideEffect;
+		for (const auto& access : pass.Accesses)
+		{
+			if (access.Write && needed[access.Resource])
+			{
+				keep = true;
+			}
+		}
+
+		if (!keep)
+		{
+			pass.Culled = true;
+			continue;
+		}
+
+		// 読み込むリソースと, 上書きする前の内容も必要になります.
+		for (const auto& access : pass.Accesses)
+		{
+			needed[access.Resource] = true;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      一時リソースの寿命を求めます.
+//-----------------------------------------------------------------------------
+bool RenderGraph::ComputeLifetimes()
+{
+	m_LastPass = InvalidIndex;
+
+	for (auto& res : m_Resources)
+	{
+		res.First   = InvalidIndex;
+		res.Last    = InvalidIndex;
+		res.Offset  = 0;
+		res.Aliased = false;
+	}
+
+	for (auto i = 0u; i < uint32_t(m_Passes.size()); ++i)
+	{
+		const auto& pass = m_Passes[i];
+		if (pass.Culled)
+		{
+			continue;
+		}
+
+		m_LastPass = i;
+
+		for (const auto& access : pass.Accesses)
+		{
+			auto& res = m_Resources[access.Resource];
+			if (res.First == InvalidIndex)
+			{
+				// 一時リソースは書き込まれるまで内容が不定です.
+				if (!res.Imported && !access.Write)
+				{
+					ELOG("Error : RenderGraph::Compile() Failed. '%s' is read by '%s' before written.", res.Name.c_str(), pass.Name.c_str());
+					return false;
+				}
+				res.First = i;
+			}
+			res.Last = i;
+		}
+	}
+
+	// 出力はフレームの最後まで有効です.
+	for (auto& res : m_Resources)
+	{
+		if (!res.Imported && res.Exported && res.First != InvalidIndex)
+		{
+			res.Last = uint32_t(m_Passes.size());
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      一時リソースをヒープ内に配置します.
+//-----------------------------------------------------------------------------
+void RenderGraph::PlaceResources(bool enableAliasing)
+{
+	m_HeapSize = 0;
+
+	std::vector<uint32_t> order;
+	for (auto i = 0u; i < uint32_t(m_Resources.size()); ++i)
+	{
+		if (!m_Resources[i].Imported && m_Resources[i].First != InvalidIndex)
+		{
+			order.push_back(i);
+		}
+	}
+
+	if (!enableAliasing)
+	{
+		for (auto index : order)
+		{
+			auto& res  = m_Resources[index];
+			res.Offset = AlignUp(m_HeapSize, res.Desc.Alignment);
+			m_HeapSize = res.Offset + res.Desc.Size;
+		}
+		return;
+	}
+
+	// 大きいものから順に, 寿命が重なるリソースと重ならない最も低い位置に置きます.
+	std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+	{
+		return m_Resources[a].Desc.Size > m_Resources[b].Desc.Size;
+	});
+
+	auto overlapLife = [](const ResourceInfo& a, const ResourceInfo& b)
+	{
+		return !(a.Last < b.First || b.Last < a.First);
+	};
+	auto overlapMemory = [](const ResourceInfo& a, const ResourceInfo& b)
+	{
+		return a.Offset < b.Offset + b.Desc.Size && b.Offset < a.Offset + a.Desc.Size;
+	};
+
+	std::vector<uint32_t> placed;
+	for (auto index : order)
+	{
+		auto& res = m_Resources[index];
+
+		// 候補は先頭と, 寿命が重なるリソースの直後です.
+		std::vector<uint64_t> candidates(1, 0);
+		for (auto other : placed)
+		{
+			const auto& o = m_Resources[other];
+			if (overlapLife(res, o))
+			{
+				candidates.push_back(AlignUp(o.Offset + o.Desc.Size, res.Desc.Alignment));
+			}
+		}
+		std::sort(candidates.begin(), candidates.end());
+
+		for (auto offset : candidates)
+		{
+			res.Offset = offset;
+
+			auto fit = true;
+			for (auto other : placed)
+			{
+				const auto& o = m_Resources[other];
+				if (overlapLife(res, o) && overlapMemory(res, o))
+				{
+					fit = false;
+					break;
+				}
+			}
+
+			if (fit)
+			{
+				break;
+			}
+		}
+
+		placed.push_back(index);
+		m_HeapSize = std::max(m_HeapSize, res.Offset + res.Desc.Size);
+	}
+
+	// 同じメモリを別のリソースも使う場合は, 使用開始時に切り替えが必要です.
+	for (auto a : placed)
+	{
+		for (auto b : placed)
+		{
+			if (a != b && overlapMemory(m_Resources[a], m_Resources[b]))
+			{
+				m_Resources[a].Aliased = true;
+				break;
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      バリアを求めます.
+//-----------------------------------------------------------------------------
+void RenderGraph::ComputeBarriers()
+{
+	// リソースごとのアクセス順です.
+	struct Use
+	{
+		uint32_t                Pass;
+		D3D12_RESOURCE_STATES   State;
+		bool                    Write;
+	};
+	std::vector<std::vector<Use>> uses(m_Resources.size());
+
+	for (auto i = 0u; i < uint32_t(m_Passes.size()); ++i)
+	{
+		if (m_Passes[i].Culled)
+		{
+			continue;
+		}
+
+		for (const auto& access : m_Passes[i].Accesses)
+		{
+			Use use;
+			use.Pass  = i;
+			use.State = access.State;
+			use.Write = access.Write;
+			uses[access.Resource].push_back(use);
+		}
+	}
+
+	for (auto r = 0u; r < uint32_t(m_Resources.size()); ++r)
+	{
+		auto& res  = m_Resources[r];
+		auto& list = uses[r];
+		if (list.empty())
+		{
+			continue;
+		}
+
+		// 連続する読み込みは状態を合成して1回の遷移にまとめます.
+		for (size_t i = 0; i < list.size(); ++i)
+		{
+			if (list[i].Write)
+			{
+				continue;
+			}
+
+			auto merged = list[i].State;
+			for (auto j = i + 1; j < list.size() && !list[j].Write; ++j)
+			{
+				merged = D3D12_RESOURCE_STATES(merged | list[j].State);
+			}
+			for (auto j = i; j < list.size() && !list[j].Write; ++j)
+			{
+				list[j].State = merged;
+			}
+		}
+
+		// 一時リソースは毎フレーム同じ遷移を行うので, 前のフレームの終了時の状態から始まります.
+		auto endState = res.Exported ? res.FinalState : list.back().State;
+		auto current  = res.Imported ? res.InitialState : endState;
+		res.CreateState = current;
+
+		// 使用開始時にメモリの切り替えと内容の破棄を行います.
+		if (!res.Imported && res.Aliased)
+		{
+			Barrier barrier;
+			barrier.Type     = BARRIER_ALIASING;
+			barrier.Resource = r;
+			barrier.Before   = current;
+			barrier.After    = current;
+			m_Passes[res.First].Barriers.push_back(barrier);
+			m_Passes[res.First].Activations.push_back(r);
+		}
+
+		for (size_t i = 0; i < list.size(); ++i)
+		{
+			const auto& use = list[i];
+
+			Barrier barrier;
+			barrier.Resource = r;
+			barrier.Before   = current;
+			barrier.After    = use.State;
+
+			if (use.State == current)
+			{
+				// 同じ状態が続く場合は, UAV書き込みの後だけ完了を待ちます.
+				if (use.Write && i > 0 && list[i - 1].Write && use.State == D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+				{
+					barrier.Type = BARRIER_UAV;
+					m_Passes[use.Pass].Barriers.push_back(barrier);
+				}
+				continue;
+			}
+
+			// 既に必要な読み込み状態を含んでいれば遷移しません.
+			if (!use.Write && IsReadState(current) && (current & use.State) == use.State)
+			{
+				continue;
+			}
+
+			barrier.Type = BARRIER_TRANSITION;
+			m_Passes[use.Pass].Barriers.push_back(barrier);
+			current = use.State;
+		}
+
+		if (current != endState && (res.Imported || res.Exported))
+		{
+			Barrier barrier;
+			barrier.Type     = BARRIER_TRANSITION;
+			barrier.Resource = r;
+			barrier.Before   = current;
+			barrier.After    = endState;
+			m_FinalBarriers.push_back(barrier);
+		}
+	}
+
+	// 切り替えは同じバッチ内の遷移より先に発行します.
+	for (auto& pass : m_Passes)
+	{
+		std::stable_partition(pass.Barriers.begin(), pass.Barriers.end(), [](const Barrier& barrier)
+		{
+			return barrier.Type == BARRIER_ALIASING;
+		});
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      パスが削除されたかどうかを判定します.
+//-----------------------------------------------------------------------------
+bool RenderGraph::IsCulled(uint32_t pass) const
+{
+	return (pass < m_Passes.size()) ? m_Passes[pass].Culled : true;
+}
+
+//-----------------------------------------------------------------------------
+//      パスの実行前に発行するバリアを取得します.
+//-----------------------------------------------------------------------------
+const std::vector<RenderGraph::Barrier>& RenderGraph::GetBarriers(uint32_t pass) const
+{
+	return m_Passes[pass].Barriers;
+}
+
+//-----------------------------------------------------------------------------
+//      パスの実行前に内容を破棄する一時リソースを取得します.
+//-----------------------------------------------------------------------------
+const std::vector<uint32_t>& RenderGraph::GetActivations(uint32_t pass) const
+{
+	return m_Passes[pass].Activations;
+}
+
+//-----------------------------------------------------------------------------
+//      最後のパスの実行後に発行するバリアを取得します.
+//-----------------------------------------------------------------------------
+const std::vector<RenderGraph::Barrier>& RenderGraph::GetFinalBarriers() const
+{
+	return m_FinalBarriers;
+}
+
+//-----------------------------------------------------------------------------
+//      削除されなかった最後のパス番号を取得します.
+//-----------------------------------------------------------------------------
+uint32_t RenderGraph::GetLastPass() const
+{
+	return m_LastPass;
+}
+
+//-----------------------------------------------------------------------------
+//      パス数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t RenderGraph::GetPassCount() const
+{
+	return uint32_t(m_Passes.size());
+}
+
+//-----------------------------------------------------------------------------
+//      パス名を取得します.
+//-----------------------------------------------------------------------------
+const char* RenderGraph::GetPassName(uint32_t pass) const
+{
+	return (pass < m_Passes.size()) ? m_Passes[pass].Name.c_str() : "";
+}
+
+//-----------------------------------------------------------------------------
+//      リソース数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t RenderGraph::GetResourceCount() const
+{
+	return uint32_t(m_Resources.size());
+}
+
+//-----------------------------------------------------------------------------
+//      リソース名を取得します.
+//-----------------------------------------------------------------------------
+const char* RenderGraph::GetResourceName(uint32_t resource) const
+{
+	return (resource < m_Resources.size()) ? m_Resources[resource].Name.c_str() : "";
+}
+
+//-----------------------------------------------------------------------------
+//      一時リソースかどうかを判定します.
+//-----------------------------------------------------------------------------
+bool RenderGraph::IsTransient(uint32_t resource) const
+{
+	return (resource < m_Resources.size()) && !m_Resources[resource].Imported;
+}
+
+//-----------------------------------------------------------------------------
+//      一時リソースが使用されるかどうかを判定します.
+//-----------------------------------------------------------------------------
+bool RenderGraph::IsUsed(uint32_t resource) const
+{
+	return IsTransient(resource) && m_Resources[resource].First != InvalidIndex;
+}
+
+//-----------------------------------------------------------------------------
+//      テクスチャ設定を取得します.
+//-----------------------------------------------------------------------------
+const RenderGraph::TextureDesc& RenderGraph::GetDesc(uint32_t resource) const
+{
+	return m_Resources[resource].Desc;
+}
+
+//-----------------------------------------------------------------------------
+//      一時リソースのヒープ内のオフセットを取得します.
+//-----------------------------------------------------------------------------
+uint64_t RenderGraph::GetHeapOffset(uint32_t resource) const
+{
+	return m_Resources[resource].Offset;
+}
+
+//-----------------------------------------------------------------------------
+//      リソースを使用するパスの範囲を取得します.
+//-----------------------------------------------------------------------------
+bool RenderGraph::GetLifetime(uint32_t resource, uint32_t& first, uint32_t& last) const
+{
+	if (resource >= m_Resources.size() || m_Resources[resource].First == InvalidIndex)
+	{
+		return false;
+	}
+
+	first = m_Resources[resource].First;
+	last  = m_Resources[resource].Last;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      一時リソースを生成するときの状態を取得します.
+//-----------------------------------------------------------------------------
+D3D12_RESOURCE_STATES RenderGraph::GetCreateState(uint32_t resource) const
+{
+	return m_Resources[resource].CreateState;
+}
+
+//-----------------------------------------------------------------------------
+//      ヒープサイズを取得します.
+//-----------------------------------------------------------------------------
+uint64_t RenderGraph::GetHeapSize() const
+{
+	return m_HeapSize;
+}
+
+//-----------------------------------------------------------------------------
+//      統計情報を取得します.
+//-----------------------------------------------------------------------------
+const RenderGraph::Report& RenderGraph::GetReport() const
+{
+	return m_Report;
+}
+
+//-----------------------------------------------------------------------------
+//      テクスチャのメモリサイズを推定します.
+//-----------------------------------------------------------------------------
+uint64_t RenderGraph::EstimateSize(const TextureDesc& desc)
+{
+	uint64_t bytesPerPixel = 4;
+	switch (desc.Format)
+	{
+	case DXGI_FORMAT_R32G32B32A32_FLOAT:
+	case DXGI_FORMAT_R32G32B32A32_UINT:
+		bytesPerPixel = 16;
+		break;
+
+	case DXGI_FORMAT_R16G16B16A16_FLOAT:
+	case DXGI_FORMAT_R16G16B16A16_UNORM:
+	case DXGI_FORMAT_R32G32_FLOAT:
+	case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
+		bytesPerPixel = 8;
+		break;
+
+	case DXGI_FORMAT_R16_FLOAT:
+	case DXGI_FORMAT_R16_UNORM:
+	case DXGI_FORMAT_D16_UNORM:
+		bytesPerPixel = 2;
+		break;
+
+	case DXGI_FORMAT_R8_UNORM:
+		bytesPerPixel = 1;
+		break;
+
+	default:
+		break;
+	}
+
+	return AlignUp(uint64_t(desc.Width) * desc.Height * bytesPerPixel, DefaultAlignment);
+}
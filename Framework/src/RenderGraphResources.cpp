@@ -0,0 +1,402 @@
+﻿//-----------------------------------------------------------------------------
+// File : RenderGraphResources.cpp
+// Desc : Render Graph Transient Resource Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <RenderGraphResources.h>
+#include <DescriptorPool.h>
+#include <Logger.h>
+#include <new>
+
+///////////////////////////////////////////////////////////////////////////////
+// RenderGraphResources class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+RenderGraphResources::RenderGraphResources()
+: m_pDevice (nullptr)
+, m_pHeap   (nullptr)
+, m_pPoolRTV(nullptr)
+, m_pPoolDSV(nullptr)
+, m_pPoolSRV(nullptr)
+, m_HeapSize(0)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+RenderGraphResources::~RenderGraphResources()
+{
+	Term();
+}
+
+//-----------------------------------------------------------------------------
+//      初期化処理を行います.
+//-----------------------------------------------------------------------------
+bool RenderGraphResources::Init(ID3D12Device* pDevice, DescriptorPool* pPoolRTV, DescriptorPool* pPoolDSV, DescriptorPool* pPoolSRV)
+{
+	if (pDevice == nullptr || pPoolRTV == nullptr || pPoolDSV == nullptr)
+	{
+		return false;
+	}
+
+	Term();
+
+	m_pDevice  = pDevice;
+	m_pPoolRTV = pPoolRTV;
+	m_pPoolDSV = pPoolDSV;
+	m_pPoolSRV = pPoolSRV;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      終了処理を行います.
+//-----------------------------------------------------------------------------
+void RenderGraphResources::Term()
+{
+	Release();
+
+	m_pDevice.Reset();
+	m_pPoolRTV = nullptr;
+	m_pPoolDSV = nullptr;
+	m_pPoolSRV = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+//      テクスチャ設定を作成します.
+//-----------------------------------------------------------------------------
+RenderGraph::TextureDesc RenderGraphResources::MakeDesc(uint32_t width, uint32_t height, DXGI_FORMAT format, bool depth) const
+{
+	RenderGraph::TextureDesc result;
+	result.Width  = width;
+	result.Height = height;
+	result.Format = format;
+	result.Depth  = depth;
+
+	if (depth)
+	{
+		result.ClearColor[0] = 1.0f;
+	}
+
+	if (m_pDevice == nullptr)
+	{
+		return result;
+	}
+
+	D3D12_RESOURCE_DESC desc = {};
+	desc.Dimension          = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	desc.Alignment          = 0;
+	desc.Width              = UINT64(width);
+	desc.Height             = height;
+	desc.DepthOrArraySize   = 1;
+	desc.MipLevels          = 1;
+	desc.Format             = format;
+	desc.SampleDesc.Count   = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Layout             = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+	desc.Flags              = (depth) ? D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL : D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+
+	auto info = m_pDevice->GetResourceAllocationInfo(0, 1, &desc);
+	result.Size      = info.SizeInBytes;
+	result.Alignment = info.Alignment;
+
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      一時リソースを生成します.
+//-----------------------------------------------------------------------------
+bool RenderGraphResources::Create(const RenderGraph& graph)
+{
+	if (m_pDevice == nullptr)
+	{
+		return false;
+	}
+
+	Release();
+
+	auto count = graph.GetResourceCount();
+	m_pColors   .resize(count, nullptr);
+	m_pDepths   .resize(count, nullptr);
+	m_pResources.resize(count, nullptr);
+
+	m_HeapSize = graph.GetHeapSize();
+	if (m_HeapSize == 0)
+	{
+		return true;
+	}
+
+	// 一時リソースは全て1つのヒープに配置します.
+	D3D12_HEAP_DESC heapDesc = {};
+	heapDesc.SizeInBytes                     = m_HeapSize;
+	heapDesc.Properties.Type                 = D3D12_HEAP_TYPE_DEFAULT;
+	heapDesc.Properties.CPUPageProperty      = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	heapDesc.Properties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	heapDesc.Properties.CreationNodeMask     = 1;
+	heapDesc.Properties.VisibleNodeMask      = 1;
+	heapDesc.Alignment                       = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	heapDesc.Flags                           = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+
+	auto hr = m_pDevice->CreateHeap(&heapDesc, IID_PPV_ARGS(m_pHeap.GetAddressOf()));
+	if (FAILED(hr))
+	{
+		ELOG("Error : ID3D12Device::CreateHeap() Failed. retcode = 0x%x", hr);
+		return false;
+	}
+
+	for (auto i = 0u; i < count; ++i)
+	{
+		if (!graph.IsUsed(i))
+		{
+			continue;
+		}
+
+		const auto& desc = graph.GetDesc(i);
+		auto offset = graph.GetHeapOffset(i);
+		auto state  = graph.GetCreateState(i);
+
+		if (desc.Depth)
+		{
+			auto pTarget = new (std::nothrow) DepthTarget();
+			if (pTarget == nullptr)
+			{
+				ELOG("Error : Out of memory.");
+				return false;
+			}
+
+			m_pDepths[i] = pTarget;
+			if (!pTarget->InitPlaced(
+				m_pDevice.Get(),
+				m_pPoolDSV,
+				m_pPoolSRV,
+				desc.Width,
+				desc.Height,
+				desc.Format,
+				desc.ClearColor[0],
+				0,
+				m_pHeap.Get(),
+				offset,
+				state))
+			{
+				ELOG("Error : DepthTarget::InitPlaced() Failed. name = %s", graph.GetResourceName(i));
+				return false;
+			}
+
+			m_pResources[i] = pTarget->GetResource();
+		}
+		else
+		{
+			auto pTarget = new (std::nothrow) ColorTarget();
+			if (pTarget == nullptr)
+			{
+				ELOG("Error : Out of memory.");
+				return false;
+			}
+
+			float clearColor[4] = {
+				desc.ClearColor[0],
+				desc.ClearColor[1],
+				desc.ClearColor[2],
+				desc.ClearColor[3]
+			};
+
+			m_pColors[i] = pTarget;
+			if (!pTarget->InitPlaced(
+				m_pDevice.Get(),
+				m_pPoolRTV,
+				m_pPoolSRV,
+				desc.Width,
+				desc.Height,
+				desc.Format,
+				clearColor,
+				m_pHeap.Get(),
+				offset,
+				state))
+			{
+				ELOG("Error : ColorTarget::InitPlaced() Failed. name = %s", graph.GetResourceName(i));
+				return false;
+			}
+
+			m_pResources[i] = pTarget->GetResource();
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      生成した一時リソースを破棄します.
+//-----------------------------------------------------------------------------
+void RenderGraphResources::Release()
+{
+	for (auto& pTarget : m_pColors)
+	{
+		if (pTarget != nullptr)
+		{
+			pTarget->Term();
+			delete pTarget;
+			pTarget = nullptr;
+		}
+	}
+
+	for (auto& pTarget : m_pDepths)
+	{
+		if (pTarget != nullptr)
+		{
+			pTarget->Term();
+			delete pTarget;
+			pTarget = nullptr;
+		}
+	}
+
+	m_pColors   .clear();
+	m_pDepths   .clear();
+	m_pResources.clear();
+	m_pHeap.Reset();
+	m_HeapSize = 0;
+}
+
+//-----------------------------------------------------------------------------
+//      グラフ外で管理するリソースを設定します.
+//-----------------------------------------------------------------------------
+void RenderGraphResources::SetImported(uint32_t resource, ID3D12Resource* pResource)
+{
+	if (resource < m_pResources.size())
+	{
+		m_pResources[resource] = pResource;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      リソースを取得します.
+//-----------------------------------------------------------------------------
+ID3D12Resource* RenderGraphResources::GetResource(uint32_t resource) const
+{
+	return (resource < m_pResources.size()) ? m_pResources[resource] : nullptr;
+}
+
+//-----------------------------------------------------------------------------
+//      一時カラーターゲットを取得します.
+//-----------------------------------------------------------------------------
+ColorTarget* RenderGraphResources::GetColorTarget(uint32_t resource) const
+{
+	return (resource < m_pColors.size()) ? m_pColors[resource] : nullptr;
+}
+
+//-----------------------------------------------------------------------------
+//      一時深度ターゲットを取得します.
+//-----------------------------------------------------------------------------
+DepthTarget* RenderGraphResources::GetDepthTarget(uint32_t resource) const
+{
+	return (resource < m_pDepths.size()) ? m_pDepths[resource] : nullptr;
+}
+
+//-----------------------------------------------------------------------------
+//      パスの実行前のバリアを発行します.
+//-----------------------------------------------------------------------------
+void RenderGraphResources::RecordBarriers(ID3D12GraphicsCommandList* pCmd, const RenderGraph& graph, uint32_t pass) const
+{
+	Record(pCmd, graph.GetBarriers(pass), &graph.GetActivations(pass));
+}
+
+//-----------------------------------------------------------------------------
+//      最後のパスの実行後のバリアを発行します.
+//-----------------------------------------------------------------------------
+void RenderGraphResources::RecordFinalBarriers(ID3D12GraphicsCommandList* pCmd, const RenderGraph& graph) const
+{
+	Record(pCmd, graph.GetFinalBarriers(), nullptr);
+}
+
+//-----------------------------------------------------------------------------
+//      ヒープサイズを取得します.
+//-----------------------------------------------------------------------------
+uint64_t RenderGraphResources::GetHeapSize() const
+{
+	return m_HeapSize;
+}
+
+//-----------------------------------------------------------------------------
+//      バリアをまとめて発行します.
+//-----------------------------------------------------------------------------
+void RenderGraphResources::Record
+(
+	ID3D12GraphicsCommandList*                  pCmd,
+	const std::vector<RenderGraph::Barrier>&    barriers,
+	const std::vector<uint32_t>*                pActivations
+) const
+{
+	if (!barriers.empty())
+	{
+		// 複数のスレッドから呼び出されるので作業領域はスタックに取ります.
+		const size_t MaxBatch = 32;
+		D3D12_RESOURCE_BARRIER batch[MaxBatch];
+		UINT count = 0;
+
+		for (const auto& barrier : barriers)
+		{
+			auto& dst = batch[count];
+			dst = {};
+
+			switch (barrier.Type)
+			{
+			case RenderGraph::BARRIER_ALIASING:
+				{
+					// 直前に同じメモリを使っていたリソースは問わないので nullptr にします.
+					dst.Type                     = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+					dst.Aliasing.pResourceBefore = nullptr;
+					dst.Aliasing.pResourceAfter  = GetResource(barrier.Resource);
+				}
+				break;
+
+			case RenderGraph::BARRIER_UAV:
+				{
+					dst.Type          = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+					dst.UAV.pResource = GetResource(barrier.Resource);
+				}
+				break;
+
+			default:
+				{
+					dst.Type                   = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+					dst.Transition.pResource   = GetResource(barrier.Resource);
+					dst.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+					dst.Transition.StateBefore = barrier.Before;
+					dst.Transition.StateAfter  = barrier.After;
+				}
+				break;
+			}
+
+			count++;
+			if (count == MaxBatch)
+			{
+				pCmd->ResourceBarrier(count, batch);
+				count = 0;
+			}
+		}
+
+		if (count > 0)
+		{
+			pCmd->ResourceBarrier(count, batch);
+		}
+	}
+
+	// メモリを共有するリソースは内容が不定なので, 使用開始時に破棄します.
+	if (pActivations != nullptr)
+	{
+		for (auto resource : *pActivations)
+		{
+			auto pResource = GetResource(resource);
+			if (pResource != nullptr)
+			{
+				pCmd->DiscardResource(pResource, nullptr);
+			}
+		}
+	}
+}
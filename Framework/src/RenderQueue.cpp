@@ -0,0 +1,456 @@
+﻿//-----------------------------------------------------------------------------
+// File : RenderQueue.cpp
+// Desc : Sorted Draw Submission Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <RenderQueue.h>
+#include <Mesh.h>
+#include <Material.h>
+#include <MaterialInstance.h>
+#include <ModelShader.h>
+#include <InstanceBuffer.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cassert>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const uint32_t RadixBits     = 8;
+static const uint32_t RadixSize     = 1 << RadixBits;
+static const uint32_t RadixPasses   = 64 / RadixBits;
+
+} // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+// RenderQueue class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+RenderQueue::RenderQueue()
+: m_pInstances(nullptr)
+, m_Batching  (true)
+, m_NearClip  (0.0f)
+, m_InvRange  (1.0f)
+, m_Sorted    (false)
+, m_Stats     ()
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+RenderQueue::~RenderQueue()
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      アイテムの収集を開始します.
+//-----------------------------------------------------------------------------
+void RenderQueue::Begin(float nearClip, float farClip)
+{
+	// 前フレームの領域はそのまま使い回す.
+	m_Items.clear();
+	m_Sorted = false;
+
+	// 番号はフレーム内の並び替えにしか使わないので毎フレーム振り直す.
+	// 破棄されたオブジェクトのアドレスが再利用されても古い番号は残らない.
+	m_PipelineIds.clear();
+	m_MaterialIds.clear();
+	m_MeshIds    .clear();
+
+	m_NearClip = nearClip;
+	m_InvRange = (farClip > nearClip) ? 1.0f / (farClip - nearClip) : 1.0f;
+}
+
+//-----------------------------------------------------------------------------
+//      描画アイテムを追加します.
+//-----------------------------------------------------------------------------
+void RenderQueue::Push
+(
+	PASS                        pass,
+	Mesh*                       pMesh,
+	Material*                   pMaterial,
+	const MaterialInstance*     pInstance,
+	const ConstantBuffer*       pMeshCB,
+	const DirectX::XMFLOAT4X4&  world,
+	float                       viewDepth
+)
+{
+	if (pMesh == nullptr || pMaterial == nullptr)
+	{ return; }
+
+	const uint32_t depthMax = (1u << DepthBits) - 1;
+
+	// 深度を [0, 1] に正規化してバケットに量子化.
+	auto t = (viewDepth - m_NearClip) * m_InvRange;
+	t = std::min(std::max(t, 0.0f), 1.0f);
+
+	auto depth = static_cast<uint32_t>(t * float(depthMax));
+
+	// 半透明は奥から描画するため反転する.
+	if (pass == PASS_TRANSPARENT)
+	{ depth = depthMax - depth; }
+
+	auto pipelineId = GetId(m_PipelineIds, pMaterial->GetShaderPtr(), PipelineBits);
+	auto materialId = GetId(m_MaterialIds, pMaterial, MaterialBits);
+	auto meshId     = GetId(m_MeshIds, pMesh, MeshBits);
+
+	DrawItem item;
+	item.SortKey    = MakeSortKey(pass, pipelineId, materialId, meshId, depth);
+	item.pMesh      = pMesh;
+	item.pMaterial  = pMaterial;
+	item.pInstance  = pInstance;
+	item.pMeshCB    = pMeshCB;
+	item.World      = world;
+
+	m_Items.push_back(item);
+	m_Sorted = false;
+}
+
+//-----------------------------------------------------------------------------
+//      ソートキーの昇順に並べ替えます.
+//-----------------------------------------------------------------------------
+void RenderQueue::Sort()
+{
+	auto begin = std::chrono::high_resolution_clock::now();
+
+	auto count = m_Items.size();
+	m_Entries.resize(count);
+	m_Temp   .resize(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		m_Entries[i].Key   = m_Items[i].SortKey;
+		m_Entries[i].Index = uint32_t(i);
+	}
+
+	m_Stats.SortPasses = (count > 0) ? RadixSort(m_Entries.data(), m_Temp.data(), count) : 0;
+
+	auto end = std::chrono::high_resolution_clock::now();
+
+	m_Stats.ItemCount    = uint32_t(count);
+	m_Stats.SortMicroSec = std::chrono::duration<double, std::micro>(end - begin).count();
+
+	m_Sorted = true;
+}
+
+//-----------------------------------------------------------------------------
+//      並べ替えたアイテムを描画します.
+//-----------------------------------------------------------------------------
+void RenderQueue::Submit
+(
+	ID3D12GraphicsCommandList*  pCmd,
+	int                         frameIndex,
+	const CommonBufferManager&  commonBufferManager,
+	const SkyManager&           skyManager
+)
+{
+	if (!m_Sorted)
+	{ Sort(); }
+
+	Stats stats;
+	Submit(pCmd, frameIndex, commonBufferManager, skyManager, 0, m_Entries.size(), stats);
+	MergeStats(&stats, 1);
+}
+
+//-----------------------------------------------------------------------------
+//      並べ替えたアイテムの一部を描画します.
+//-----------------------------------------------------------------------------
+void RenderQueue::Submit
+(
+	ID3D12GraphicsCommandList*  pCmd,
+	int                         frameIndex,
+	const CommonBufferManager&  commonBufferManager,
+	const SkyManager&           skyManager,
+	size_t                      rangeBegin,
+	size_t                      rangeEnd,
+	Stats&                      stats
+)
+{
+	// 複数のスレッドから呼び出されるので, ここでは並べ替えません.
+	assert(m_Sorted);
+
+	auto begin = std::chrono::high_resolution_clock::now();
+
+	stats.PipelineChanges   = 0;
+	stats.MaterialChanges   = 0;
+	stats.MeshBufferChanges = 0;
+	stats.InstanceChanges   = 0;
+	stats.DrawCalls         = 0;
+	stats.InstancedItems    = 0;
+
+	ModelShader*            pCurShader   = nullptr;
+	Material*               pCurMaterial = nullptr;
+	const ConstantBuffer*   pCurMeshCB   = nullptr;
+	uint32_t                curInstance  = UINT32_MAX;
+	bool                    curInstanced = false;
+
+	const auto count = std::min(rangeEnd, m_Entries.size());
+	size_t i = rangeBegin;
+	while (i < count)
+	{
+		auto& item    = m_Items[m_Entries[i].Index];
+		auto  pShader = item.pMaterial->GetShaderPtr();
+		if (pShader == nullptr)
+		{
+			i++;
+			continue;
+		}
+
+		// ルートシグニチャが変わるとルート引数は全て無効になる.
+		if (pShader != pCurShader)
+		{
+			pShader->SetPassState(pCmd, frameIndex, commonBufferManager, skyManager);
+			pCurShader   = pShader;
+			pCurMaterial = nullptr;
+			pCurMeshCB   = nullptr;
+			curInstance  = UINT32_MAX;
+			curInstanced = false;
+			stats.PipelineChanges++;
+		}
+
+		if (item.pMaterial != pCurMaterial)
+		{
+			pShader->SetMaterialState(pCmd, frameIndex, *item.pMaterial, 0, item.pInstance);
+			pCurMaterial = item.pMaterial;
+			stats.MaterialChanges++;
+		}
+
+		// 同じメッシュ・マテリアルが続く範囲を1回のインスタンス描画にまとめる.
+		if (m_pInstances != nullptr && pShader->SupportsInstancing())
+		{
+			auto last = i + 1;
+			if (m_Batching)
+			{
+				while (last < count)
+				{
+					auto& next = m_Items[m_Entries[last].Index];
+					if (next.pMesh != item.pMesh || next.pMaterial != item.pMaterial)
+					{ break; }
+					last++;
+				}
+			}
+
+			uint32_t first = 0;
+			auto pData = m_pInstances->Alloc(uint32_t(last - i), &first);
+			if (pData != nullptr)
+			{
+				for (auto j = i; j < last; ++j)
+				{
+					auto& src = m_Items[m_Entries[j].Index];
+					pData->World         = src.World;
+					pData->MaterialIndex = (src.pInstance != nullptr) ? src.pInstance->GetIndex() : 0;
+					pData++;
+				}
+
+				if (!curInstanced)
+				{
+					pShader->SetPipelineVariant(pCmd, true);
+					curInstanced = true;
+				}
+
+				pShader->SetInstanceRange(pCmd, m_pInstances->GetHandleGPU(), first);
+				item.pMesh->Draw(pCmd, uint32_t(last - i));
+
+				stats.DrawCalls++;
+				stats.InstancedItems += uint32_t(last - i);
+				i = last;
+				continue;
+			}
+
+			// バッファが足りない場合は通常の描画に切り替える.
+		}
+
+		if (curInstanced)
+		{
+			pShader->SetPipelineVariant(pCmd, false);
+			curInstanced = false;
+		}
+
+		if (item.pMeshCB != pCurMeshCB)
+		{
+			pShader->SetMeshState(pCmd, frameIndex, item.pMeshCB);
+			pCurMeshCB = item.pMeshCB;
+			stats.MeshBufferChanges++;
+		}
+
+		auto instance = (item.pInstance != nullptr) ? item.pInstance->GetIndex() : UINT32_MAX;
+		if (instance != curInstance)
+		{
+			pShader->SetInstanceState(pCmd, item.pInstance);
+			curInstance = instance;
+			stats.InstanceChanges++;
+		}
+
+		item.pMesh->Draw(pCmd);
+		stats.DrawCalls++;
+		i++;
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	stats.SubmitMicroSec = std::chrono::duration<double, std::micro>(end - begin).count();
+}
+
+//-----------------------------------------------------------------------------
+//      範囲ごとの統計情報をまとめます.
+//-----------------------------------------------------------------------------
+void RenderQueue::MergeStats(const Stats* pStats, size_t count)
+{
+	m_Stats.PipelineChanges   = 0;
+	m_Stats.MaterialChanges   = 0;
+	m_Stats.MeshBufferChanges = 0;
+	m_Stats.InstanceChanges   = 0;
+	m_Stats.DrawCalls         = 0;
+	m_Stats.InstancedItems    = 0;
+	m_Stats.SubmitMicroSec    = 0.0;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		m_Stats.PipelineChanges   += pStats[i].PipelineChanges;
+		m_Stats.MaterialChanges   += pStats[i].MaterialChanges;
+		m_Stats.MeshBufferChanges += pStats[i].MeshBufferChanges;
+		m_Stats.InstanceChanges   += pStats[i].InstanceChanges;
+		m_Stats.DrawCalls         += pStats[i].DrawCalls;
+		m_Stats.InstancedItems    += pStats[i].InstancedItems;
+		m_Stats.SubmitMicroSec    += pStats[i].SubmitMicroSec;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      ソートキーを生成します.
+//-----------------------------------------------------------------------------
+uint64_t RenderQueue::MakeSortKey(uint32_t pass, uint32_t pipelineId, uint32_t materialId, uint32_t meshId, uint32_t depthBucket)
+{
+	static_assert(PassBits + PipelineBits + MaterialBits + MeshBits + DepthBits == 64, "Invalid Sort Key Layout.");
+
+	uint64_t key = 0;
+	key |= uint64_t(pass        & ((1u << PassBits)     - 1)) << (PipelineBits + MaterialBits + MeshBits + DepthBits);
+	key |= uint64_t(pipelineId  & ((1u << PipelineBits) - 1)) << (MaterialBits + MeshBits + DepthBits);
+	key |= uint64_t(materialId  & ((1u << MaterialBits) - 1)) << (MeshBits + DepthBits);
+	key |= uint64_t(meshId      & ((1u << MeshBits)     - 1)) << (DepthBits);
+	key |= uint64_t(depthBucket & ((1u << DepthBits)    - 1));
+	return key;
+}
+
+//-----------------------------------------------------------------------------
+//      キーと添字の組を基数ソートします.
+//-----------------------------------------------------------------------------
+uint32_t RenderQueue::RadixSort(SortEntry* pEntries, SortEntry* pTemp, size_t count)
+{
+	assert(pEntries != nullptr && pTemp != nullptr);
+
+	// 全桁のヒストグラムを1回の走査でまとめて作る.
+	uint32_t histogram[RadixPasses][RadixSize];
+	memset(histogram, 0, sizeof(histogram));
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		auto key = pEntries[i].Key;
+		for (auto pass = 0u; pass < RadixPasses; ++pass)
+		{
+			histogram[pass][(key >> (pass * RadixBits)) & (RadixSize - 1)]++;
+		}
+	}
+
+	auto pSrc   = pEntries;
+	auto pDst   = pTemp;
+	auto passes = 0u;
+
+	for (auto pass = 0u; pass < RadixPasses; ++pass)
+	{
+		auto  shift  = pass * RadixBits;
+		auto& bucket = histogram[pass];
+
+		// 全要素が同じ桁値であれば並びは変わらない.
+		if (bucket[(pSrc[0].Key >> shift) & (RadixSize - 1)] == count)
+		{ continue; }
+
+		// 排他的累積和で書き込み位置を求める.
+		uint32_t offset = 0;
+		for (auto i = 0u; i < RadixSize; ++i)
+		{
+			auto n    = bucket[i];
+			bucket[i] = offset;
+			offset   += n;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto digit = (pSrc[i].Key >> shift) & (RadixSize - 1);
+			pDst[bucket[digit]++] = pSrc[i];
+		}
+
+		std::swap(pSrc, pDst);
+		passes++;
+	}
+
+	// 奇数回入れ替えた場合は結果が作業領域側にある.
+	if (pSrc != pEntries)
+	{ memcpy(pEntries, pSrc, sizeof(SortEntry) * count); }
+
+	return passes;
+}
+
+//-----------------------------------------------------------------------------
+//      インスタンス描画に使用するバッファを設定します.
+//-----------------------------------------------------------------------------
+void RenderQueue::SetInstanceBuffer(InstanceBuffer* pBuffer)
+{ m_pInstances = pBuffer; }
+
+//-----------------------------------------------------------------------------
+//      同じメッシュ・マテリアルをまとめて描画するかどうかを設定します.
+//-----------------------------------------------------------------------------
+void RenderQueue::SetBatching(bool enable)
+{ m_Batching = enable; }
+
+//-----------------------------------------------------------------------------
+//      同じメッシュ・マテリアルをまとめて描画するかどうか.
+//-----------------------------------------------------------------------------
+bool RenderQueue::IsBatching() const
+{ return m_Batching; }
+
+//-----------------------------------------------------------------------------
+//      アイテム数を取得します.
+//-----------------------------------------------------------------------------
+size_t RenderQueue::GetCount() const
+{ return m_Items.size(); }
+
+//-----------------------------------------------------------------------------
+//      並べ替えたアイテムを取得します.
+//-----------------------------------------------------------------------------
+const DrawItem& RenderQueue::GetItem(size_t index) const
+{
+	assert(index < m_Entries.size());
+	return m_Items[m_Entries[index].Index];
+}
+
+//-----------------------------------------------------------------------------
+//      直前のフレームの統計情報を取得します.
+//-----------------------------------------------------------------------------
+const RenderQueue::Stats& RenderQueue::GetStats() const
+{ return m_Stats; }
+
+//-----------------------------------------------------------------------------
+//      ポインタに対応する番号を取得します.
+//-----------------------------------------------------------------------------
+uint32_t RenderQueue::GetId(std::unordered_map<const void*, uint32_t>& ids, const void* ptr, uint32_t bits)
+{
+	auto itr = ids.find(ptr);
+	if (itr != ids.end())
+	{ return itr->second; }
+
+	// 桁あふれした場合は番号を使い回す(並び順が崩れるだけで描画結果は変わらない).
+	auto id = uint32_t(ids.size()) & ((1u << bits) - 1);
+	ids[ptr] = id;
+	return id;
+}
@@ -1,6 +1,8 @@
 #include "Renderer.h"
 #include "FileUtil.h"
 #include "Logger.h"
+#include "PipelineCache.h"
+#include "ShaderLibrary.h"
 #include "DirectXHelpers.h"
 #include <d3dcompiler.h>
 #include <RootSignature.h>
@@ -8,28 +10,28 @@
 
 bool SearchAndLoadShader(const std::wstring& shaderPath, ComPtr<ID3DBlob>& shaderBlob)
 {
-    std::wstring fullPath;
-    if (!SearchFilePath(shaderPath.c_str(), fullPath)) {
-        ELOG("Error : %ls Shader Not Found.", shaderPath.c_str());
+    // Each file is read once and shared by every renderer that asks for it.
+    if (!ShaderLibrary::GetInstance().Load(shaderPath, shaderBlob)) {
+        ELOG("Error : ShaderLibrary::Load() Failed. path = %ls", shaderPath.c_str());
         return false;
     }
 
-    HRESULT hr = D3DReadFileToBlob(fullPath.c_str(), shaderBlob.GetAddressOf());
-    if (FAILED(hr)) {
-        ELOG("Error : D3DReadFileToBlob() Failed. path = %ls", fullPath.c_str());
-        return false;
-    }
-
-    ELOG("Shader Loaded. Path = %ls", fullPath.c_str());
     return true;
 }
 
 bool CreateGraphicsPipelineState(ComPtr<ID3D12Device> pDevice, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, ComPtr<ID3D12PipelineState>& pPSO)
 {
-    HRESULT hr = pDevice->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(pPSO.GetAddressOf()));
-    if (FAILED(hr))
+#if defined(DEBUG) || defined(_DEBUG)
+    // Report shader resources the root signature does not bind before the driver rejects them.
+    std::vector<uint8_t> rootSig;
+    if (PipelineCache::GetInstance().GetRootSignatureBlob(desc.pRootSignature, rootSig)) {
+        ShaderLibrary::GetInstance().ValidatePipeline(desc, rootSig.data(), rootSig.size());
+    }
+#endif//defined(DEBUG) || defined(_DEBUG)
+
+    if (!PipelineCache::GetInstance().GetGraphicsPipeline(pDevice.Get(), desc, pPSO))
     {
-        ELOG("Error : ID3D12Device::CreateGraphicsPipelineState() Failed. retcode = 0x%x", hr);
+        ELOG("Error : PipelineCache::GetGraphicsPipeline() Failed.");
         return false;
     }
 
@@ -14,6 +14,7 @@
 #include <assimp/cimport.h>
 #include <codecvt>
 #include <cassert>
+#include <cmath>
 
 namespace {
 	//-----------------------------------------------------------------------------
@@ -208,6 +209,9 @@ namespace {
 			dstMesh.Indices[i * 3 + 1] = face.mIndices[1];
 			dstMesh.Indices[i * 3 + 2] = face.mIndices[2];
 		}
+
+		// 境界ボリュームを計算.
+		Res::ComputeBounds(dstMesh);
 	}
 
 	//-----------------------------------------------------------------------------
@@ -421,4 +425,43 @@ namespace Res {
 		MeshLoader loader;
 		return loader.Load(filename, meshes, materials);
 	}
+
+	//-----------------------------------------------------------------------------
+	//      頂点データから境界ボリュームを計算します.
+	//-----------------------------------------------------------------------------
+	void ComputeBounds(ResMesh& mesh)
+	{
+		if (mesh.Vertices.empty())
+		{
+			mesh.BoundsMin      = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+			mesh.BoundsMax      = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+			mesh.BoundingSphere = DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
+			return;
+		}
+
+		auto vmin = DirectX::XMLoadFloat3(&mesh.Vertices[0].Position);
+		auto vmax = vmin;
+		for (const auto& v : mesh.Vertices)
+		{
+			auto p = DirectX::XMLoadFloat3(&v.Position);
+			vmin = DirectX::XMVectorMin(vmin, p);
+			vmax = DirectX::XMVectorMax(vmax, p);
+		}
+
+		DirectX::XMStoreFloat3(&mesh.BoundsMin, vmin);
+		DirectX::XMStoreFloat3(&mesh.BoundsMax, vmax);
+
+		// AABBの中心から最も遠い頂点までを半径とする.
+		auto center   = DirectX::XMVectorScale(DirectX::XMVectorAdd(vmin, vmax), 0.5f);
+		auto radiusSq = DirectX::XMVectorZero();
+		for (const auto& v : mesh.Vertices)
+		{
+			auto d = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&v.Position), center);
+			radiusSq = DirectX::XMVectorMax(radiusSq, DirectX::XMVector3LengthSq(d));
+		}
+
+		DirectX::XMFLOAT3 c;
+		DirectX::XMStoreFloat3(&c, center);
+		mesh.BoundingSphere = DirectX::XMFLOAT4(c.x, c.y, c.z, sqrtf(DirectX::XMVectorGetX(radiusSq)));
+	}
 }
\ No newline at end of file
@@ -36,7 +36,7 @@ bool AppResourceManager::CheckFilePath(const std::wstring& path) {
 		return false;
 	}
 
-	// t@Cł邱Ƃ`FbN.
+	// ファイル名であることをチェック.
 	if (PathIsDirectoryW(findPath.c_str()) != FALSE)
 	{
 		ELOG("Error : This is not FilePath  = %ls", findPath.c_str());
@@ -44,31 +44,31 @@ bool AppResourceManager::CheckFilePath(const std::wstring& path) {
 	}
 }
 
-// Textureǂݍunordered_mapɓo^
+// Textureを読み込んでunordered_mapに登録する
 bool AppResourceManager::LoadTexture(const std::wstring path,
 	ComPtr<ID3D12Device> pDevice,
 	DescriptorPool* pPool,
 	bool isSRGB,
 	DirectX::ResourceUploadBatch& batch) {
-	// ɓo^Ăꍇ͉Ȃ
+	// 既に登録されている場合は何もしない
 	if (m_Textures.count(path) > 0) return true;
 
-	// t@CpX݂邩`FbN܂.
+	// ファイルパスが存在するかチェックします.
 	if (!CheckFilePath(path)) {
 		ELOG("Error : Load Texture Failed. filepath = %ls", path);
 		return false;
 	}
 
-	// eNX`ǂݍœo^
+	// テクスチャを読み込んで登録
 	Texture* pTexture = new (std::nothrow) Texture();
-	// CX^X.
+	// インスタンス生成.
 	if (pTexture == nullptr)
 	{
 		ELOG("Error : Out of memory.");
 		return false;
 	}
 
-	// .
+	// 初期化.
 	if (!pTexture->Init(pDevice.Get(), pPool, path.c_str(), isSRGB, batch))
 	{
 		ELOG("Error : Texture::Init() Failed.");
@@ -79,13 +79,13 @@ bool AppResourceManager::LoadTexture(const std::wstring path,
 	m_Textures.insert(std::make_pair(path, pTexture));
 }
 
-// Modelǂݍunordered_mapɓo^
+// Modelを読み込んでunordered_mapに登録する
 bool AppResourceManager::LoadResModel(const std::wstring path) {
 	if (m_ResMeshes.count(path) == 0 || m_ResMaterials.count(path) == 0) {
 		std::vector<ResMesh>        resMesh = std::vector<ResMesh>();
 		std::vector<ResMaterial>    resMaterial = std::vector<ResMaterial>();
 
-		// bV\[X[h.
+		// メッシュリソースをロード.
 		if (!Res::LoadMesh(path.c_str(), resMesh, resMaterial))
 		{
 			ELOG("Error : Load Mesh Failed. filepath = %ls", path);
@@ -98,30 +98,30 @@ bool AppResourceManager::LoadResModel(const std::wstring path) {
 	else return false;
 }
 
-// ResMeshMesh쐬
+// ResMeshからMeshを作成する
 bool AppResourceManager::CreateMesh(ComPtr<ID3D12Device> pDevice, const std::wstring key, std::vector<ResMesh> resMesh) {
 
 	if (m_pMeshs.count(key) > 0) return true;
 
 	std::vector<Mesh*> pMesh = std::vector<Mesh*>();
 
-	// \.
+	// メモリを予約.
 	pMesh.reserve(resMesh.size());
 
-	// bV.
+	// メッシュを初期化.
 	for (size_t i = 0; i < resMesh.size(); ++i)
 	{
-		// bV.
+		// メッシュ生成.
 		auto mesh = new (std::nothrow) Mesh();
 
-		// `FbN.
+		// チェック.
 		if (mesh == nullptr)
 		{
 			ELOG("Error : Out of memory.");
 			return false;
 		}
 
-		// .
+		// 初期化処理.
 		if (!mesh->Init(pDevice.Get(), resMesh[i]))
 		{
 			ELOG("Error : Mesh Initialize Failed.");
@@ -129,11 +129,11 @@ bool AppResourceManager::CreateMesh(ComPtr<ID3D12Device> pDevice, const std::wst
 			return false;
 		}
 
-		// o^.
+		// 成功したら登録.
 		pMesh.push_back(mesh);
 	}
 
-	// œK.
+	// メモリ最適化.
 	pMesh.shrink_to_fit();
 
 	m_pMeshs[key] = pMesh;
@@ -142,38 +142,39 @@ bool AppResourceManager::CreateMesh(ComPtr<ID3D12Device> pDevice, const std::wst
 }
 
 bool AppResourceManager::CreateMaterial(ComPtr<ID3D12Device> pDevice, const std::wstring key, std::vector<ResMaterial> resMaterial, DescriptorPool* resPool) {
-	// \.
+	// メモリを予約.
 	std::vector<Material*> pMaterial = std::vector<Material*>();
 	pMaterial.reserve(resMaterial.size());
 
-	// }eA.
+	// マテリアルを初期化.
 	for (size_t i = 0; i < resMaterial.size(); ++i)
 	{
-		// }eA.
+		// マテリアル生成.
 		auto material = new (std::nothrow) Material();
 
-		// `FbN.
+		// チェック.
 		if (material == nullptr)
 		{
 			ELOG("Error : Out of memory.");
 			return false;
 		}
 
+		// 1マテリアルにつきサブセットは1つ.
 		if (!material->Init(
 			pDevice.Get(),
 			resPool,
 			sizeof(CommonCb::CbMaterial),
-			resMaterial.size()))
+			1))
 		{
 			ELOG("Error : Material::Init() Failed.");
 			return false;
 		}
 
-		// o^.
+		// 成功したら登録.
 		pMaterial.push_back(material);
 	}
 
-	// œK.
+	// メモリ最適化.
 	pMaterial.shrink_to_fit();
 
 	m_pMaterials[key] = pMaterial;
@@ -181,7 +182,7 @@ bool AppResourceManager::CreateMaterial(ComPtr<ID3D12Device> pDevice, const std:
 	return true;
 }
 
-// eNX`擾
+// テクスチャを取得する
 Texture* AppResourceManager::GetTexture(const std::wstring& path) {
 	auto it = m_Textures.find(path);
 	if (it != m_Textures.end()) {
@@ -190,7 +191,7 @@ Texture* AppResourceManager::GetTexture(const std::wstring& path) {
 	return nullptr;
 }
 
-// eNX`ɑ΂郍[hƃQbg𓯎ɍs
+// テクスチャに対するロードとゲットを同時に行う
 Texture* AppResourceManager::LoadGetTexture(const std::wstring path,
 	ComPtr<ID3D12Device> pDevice,
 	DescriptorPool* pPool,
@@ -205,7 +206,7 @@ Texture* AppResourceManager::LoadGetTexture(const std::wstring path,
 	}
 }
 
-// \[XbV擾
+// リソースメッシュを取得する
 std::vector<ResMesh> AppResourceManager::GetResMesh(const std::wstring& path) {
 	auto it = m_ResMeshes.find(path);
 	if (it != m_ResMeshes.end()) {
@@ -214,7 +215,7 @@ std::vector<ResMesh> AppResourceManager::GetResMesh(const std::wstring& path) {
 	return std::vector<ResMesh>();
 }
 
-// \[X}eA擾
+// リソースマテリアルを取得する
 std::vector<ResMaterial> AppResourceManager::GetResMaterial(const std::wstring& path) {
 	auto it = m_ResMaterials.find(path);
 	if (it != m_ResMaterials.end()) {
@@ -223,7 +224,7 @@ std::vector<ResMaterial> AppResourceManager::GetResMaterial(const std::wstring&
 	return std::vector<ResMaterial>();
 }
 
-// bV擾
+// メッシュを取得する
 
 std::vector<Mesh*> AppResourceManager::GetMesh(const std::wstring& path) {
 	auto it = m_pMeshs.find(path);
@@ -233,7 +234,7 @@ std::vector<Mesh*> AppResourceManager::GetMesh(const std::wstring& path) {
 	return std::vector<Mesh*>();
 }
 
-// }eA擾
+// マテリアルを取得する
 std::vector<Material*> AppResourceManager::GetMaterial(const std::wstring& path) {
 	auto it = m_pMaterials.find(path);
 	if (it != m_pMaterials.end()) {
@@ -9,13 +9,16 @@
 //-----------------------------------------------------------------------------
 #include <RootSignature.h>
 #include <Logger.h>
+#include <PipelineCache.h>
+#include <algorithm>
+#include <cstdio>
 
 ///////////////////////////////////////////////////////////////////////////////
 // RootSignature::Desc class
 ///////////////////////////////////////////////////////////////////////////////
 
 //-----------------------------------------------------------------------------
-//      RXgN^ł.
+//      コンストラクタです.
 //-----------------------------------------------------------------------------
 RootSignature::Desc::Desc()
 	: m_Desc()
@@ -28,7 +31,7 @@ RootSignature::Desc::Desc()
 }
 
 //-----------------------------------------------------------------------------
-//      fXgN^ł.
+//      デストラクタです.
 //-----------------------------------------------------------------------------
 RootSignature::Desc::~Desc()
 {
@@ -38,7 +41,7 @@ RootSignature::Desc::~Desc()
 }
 
 //-----------------------------------------------------------------------------
-//      ZbgAbvJn.
+//      セットアップ開始.
 //-----------------------------------------------------------------------------
 RootSignature::Desc& RootSignature::Desc::Begin(int count)
 {
@@ -50,14 +53,15 @@ RootSignature::Desc& RootSignature::Desc::Begin(int count)
 
 	memset(&m_Desc, 0, sizeof(m_Desc));
 
+	// 前回の設定が残らないよう, 全て初期化します.
 	m_Samplers.clear();
-	m_Ranges.resize(count);
-	m_Params.resize(count);
+	m_Ranges.assign(count, std::vector<D3D12_DESCRIPTOR_RANGE>());
+	m_Params.assign(count, D3D12_ROOT_PARAMETER());
 	return *this;
 }
 
 //-----------------------------------------------------------------------------
-//      VF[_Xe[W`FbN܂.
+//      シェーダステージをチェックします.
 //-----------------------------------------------------------------------------
 void RootSignature::Desc::CheckStage(ShaderStage stage)
 {
@@ -69,14 +73,16 @@ void RootSignature::Desc::CheckStage(ShaderStage stage)
 }
 
 //-----------------------------------------------------------------------------
-//      p[^ݒ肵܂.
+//      パラメータを設定します.
 //-----------------------------------------------------------------------------
 void RootSignature::Desc::SetParam
 (
 	ShaderStage                 stage,
 	int                         index,
 	uint32_t                    reg,
-	D3D12_DESCRIPTOR_RANGE_TYPE type
+	D3D12_DESCRIPTOR_RANGE_TYPE type,
+	uint32_t                    count,
+	uint32_t                    space
 )
 {
 	if (index >= m_Params.size())
@@ -84,21 +90,12 @@ void RootSignature::Desc::SetParam
 		return;
 	}
 
-	m_Ranges[index].RangeType = type;
-	m_Ranges[index].NumDescriptors = 1;
-	m_Ranges[index].BaseShaderRegister = reg;
-	m_Ranges[index].RegisterSpace = 0;
-	m_Ranges[index].OffsetInDescriptorsFromTableStart = 0;
-
-	m_Params[index].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
-	m_Params[index].DescriptorTable.NumDescriptorRanges = 1;
-	m_Params[index].DescriptorTable.pDescriptorRanges = &m_Ranges[index];
-	m_Params[index].ShaderVisibility = D3D12_SHADER_VISIBILITY(stage);
-	CheckStage(stage);
+	m_Ranges[index].clear();
+	AddRange(stage, index, type, reg, count, space);
 }
 
 //-----------------------------------------------------------------------------
-//      萔obt@r[ݒ肵܂.
+//      定数バッファビューを設定します.
 //-----------------------------------------------------------------------------
 RootSignature::Desc& RootSignature::Desc::SetCBV(ShaderStage stage, int index, uint32_t reg)
 {
@@ -107,7 +104,7 @@ RootSignature::Desc& RootSignature::Desc::SetCBV(ShaderStage stage, int index, u
 }
 
 //-----------------------------------------------------------------------------
-//      VF[_\[Xr[ݒ肵܂.
+//      シェーダリソースビューを設定します.
 //-----------------------------------------------------------------------------
 RootSignature::Desc& RootSignature::Desc::SetSRV(ShaderStage stage, int index, uint32_t reg)
 {
@@ -116,7 +113,7 @@ RootSignature::Desc& RootSignature::Desc::SetSRV(ShaderStage stage, int index, u
 }
 
 //-----------------------------------------------------------------------------
-//      AI[_[hANZXr[ݒ肵܂.
+//      アンオーダードアクセスビューを設定します.
 //-----------------------------------------------------------------------------
 RootSignature::Desc& RootSignature::Desc::SetUAV(ShaderStage stage, int index, uint32_t reg)
 {
@@ -125,7 +122,7 @@ RootSignature::Desc& RootSignature::Desc::SetUAV(ShaderStage stage, int index, u
 }
 
 //-----------------------------------------------------------------------------
-//      Tv[Xe[gݒ肵܂.
+//      サンプラーステートを設定します.
 //-----------------------------------------------------------------------------
 RootSignature::Desc& RootSignature::Desc::SetSmp(ShaderStage stage, int index, uint32_t reg)
 {
@@ -134,7 +131,102 @@ RootSignature::Desc& RootSignature::Desc::SetSmp(ShaderStage stage, int index, u
 }
 
 //-----------------------------------------------------------------------------
-//      X^eBbNTv[ǉ܂.
+//      シェーダリソースビューの配列を設定します.
+//      count に UINT_MAX を指定するとサイズ無制限のテーブルになります.
+//-----------------------------------------------------------------------------
+RootSignature::Desc& RootSignature::Desc::SetSRVRange(ShaderStage stage, int index, uint32_t reg, uint32_t count, uint32_t space)
+{
+	SetParam(stage, index, reg, D3D12_DESCRIPTOR_RANGE_TYPE_SRV, count, space);
+	return *this;
+}
+
+//-----------------------------------------------------------------------------
+//      ルート定数を設定します.
+//-----------------------------------------------------------------------------
+RootSignature::Desc& RootSignature::Desc::SetConstants(ShaderStage stage, int index, uint32_t reg, uint32_t count)
+{
+	if (index >= m_Params.size())
+	{
+		return *this;
+	}
+
+	m_Params[index].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+	m_Params[index].Constants.ShaderRegister = reg;
+	m_Params[index].Constants.RegisterSpace = 0;
+	m_Params[index].Constants.Num32BitValues = count;
+	m_Params[index].ShaderVisibility = D3D12_SHADER_VISIBILITY(stage);
+	CheckStage(stage);
+	return *this;
+}
+
+//-----------------------------------------------------------------------------
+//      ルートディスクリプタとして定数バッファビューを設定します.
+//      テーブルを経由しないので, 描画ごとに切り替える定数バッファに向いています.
+//-----------------------------------------------------------------------------
+RootSignature::Desc& RootSignature::Desc::SetRootCBV(ShaderStage stage, int index, uint32_t reg)
+{
+	if (index >= m_Params.size())
+	{
+		return *this;
+	}
+
+	m_Ranges[index].clear();
+	m_Params[index].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+	m_Params[index].Descriptor.ShaderRegister = reg;
+	m_Params[index].Descriptor.RegisterSpace = 0;
+	m_Params[index].ShaderVisibility = D3D12_SHADER_VISIBILITY(stage);
+	CheckStage(stage);
+	return *this;
+}
+
+//-----------------------------------------------------------------------------
+//      ディスクリプタテーブルにレンジを追加します.
+//      既にテーブルであれば末尾に追加し, 連続したディスクリプタとして参照します.
+//-----------------------------------------------------------------------------
+RootSignature::Desc& RootSignature::Desc::AddRange
+(
+	ShaderStage                 stage,
+	int                         index,
+	D3D12_DESCRIPTOR_RANGE_TYPE type,
+	uint32_t                    reg,
+	uint32_t                    count,
+	uint32_t                    space
+)
+{
+	if (index >= m_Params.size())
+	{
+		return *this;
+	}
+
+	auto& param  = m_Params[index];
+	auto& ranges = m_Ranges[index];
+	if (param.ParameterType != D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE || ranges.empty())
+	{
+		ranges.clear();
+		param.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+		param.ShaderVisibility = D3D12_SHADER_VISIBILITY(stage);
+	}
+	else if (param.ShaderVisibility != D3D12_SHADER_VISIBILITY(stage))
+	{
+		// 異なるステージのレンジをまとめた場合は全ステージから参照します.
+		param.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+	}
+
+	// オフセットは End() で先頭から詰めて確定します.
+	D3D12_DESCRIPTOR_RANGE range = {};
+	range.RangeType = type;
+	range.NumDescriptors = count;
+	range.BaseShaderRegister = reg;
+	range.RegisterSpace = space;
+	range.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+	ranges.push_back(range);
+
+	CheckStage(stage);
+	return *this;
+}
+
+//-----------------------------------------------------------------------------
+//      スタティックサンプラーを追加します.
 //-----------------------------------------------------------------------------
 RootSignature::Desc& RootSignature::Desc::AddStaticSmp(ShaderStage stage, uint32_t reg, SamplerState state)
 {
@@ -215,7 +307,7 @@ RootSignature::Desc& RootSignature::Desc::AddStaticSmp(ShaderStage stage, uint32
 }
 
 //-----------------------------------------------------------------------------
-//      ̓CAEg܂.
+//      入力レイアウトを許可します.
 //-----------------------------------------------------------------------------
 RootSignature::Desc& RootSignature::Desc::AllowIL()
 {
@@ -224,7 +316,7 @@ RootSignature::Desc& RootSignature::Desc::AllowIL()
 }
 
 //-----------------------------------------------------------------------------
-//      Xg[AEgvbg܂.
+//      ストリームアウトプットを許可します.
 //-----------------------------------------------------------------------------
 RootSignature::Desc& RootSignature::Desc::AllowSO()
 {
@@ -233,7 +325,7 @@ RootSignature::Desc& RootSignature::Desc::AllowSO()
 }
 
 //-----------------------------------------------------------------------------
-//      ݒ菈ICLqqݒ肵܂.
+//      設定処理を終了し，記述子を設定します.
 //-----------------------------------------------------------------------------
 RootSignature::Desc& RootSignature::Desc::End()
 {
@@ -262,6 +354,34 @@ RootSignature::Desc& RootSignature::Desc::End()
 		m_Flags |= D3D12_ROOT_SIGNATURE_FLAG_DENY_PIXEL_SHADER_ROOT_ACCESS;
 	}
 
+	// 同じ構成であれば設定した順序に依らず同じ記述子になるよう, オフセットとサンプラーの順序を確定します.
+	for (size_t i = 0; i < m_Params.size(); ++i)
+	{
+		if (m_Params[i].ParameterType != D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE)
+		{
+			continue;
+		}
+
+		auto& ranges = m_Ranges[i];
+		uint32_t offset = 0;
+		for (auto& range : ranges)
+		{
+			range.OffsetInDescriptorsFromTableStart = offset;
+			offset = (range.NumDescriptors == UINT_MAX) ? UINT_MAX : offset + range.NumDescriptors;
+		}
+
+		m_Params[i].DescriptorTable.NumDescriptorRanges = UINT(ranges.size());
+		m_Params[i].DescriptorTable.pDescriptorRanges = ranges.data();
+	}
+
+	std::stable_sort(m_Samplers.begin(), m_Samplers.end(),
+		[](const D3D12_STATIC_SAMPLER_DESC& lhs, const D3D12_STATIC_SAMPLER_DESC& rhs)
+		{
+			if (lhs.RegisterSpace != rhs.RegisterSpace)
+			{ return lhs.RegisterSpace < rhs.RegisterSpace; }
+			return lhs.ShaderRegister < rhs.ShaderRegister;
+		});
+
 	m_Desc.NumParameters = UINT(m_Params.size());
 	m_Desc.pParameters = m_Params.data();
 	m_Desc.NumStaticSamplers = UINT(m_Samplers.size());
@@ -272,7 +392,7 @@ RootSignature::Desc& RootSignature::Desc::End()
 }
 
 //-----------------------------------------------------------------------------
-//      Lqq擾܂.
+//      記述子を取得します.
 //-----------------------------------------------------------------------------
 const D3D12_ROOT_SIGNATURE_DESC* RootSignature::Desc::GetDesc() const
 {
@@ -284,14 +404,14 @@ const D3D12_ROOT_SIGNATURE_DESC* RootSignature::Desc::GetDesc() const
 ///////////////////////////////////////////////////////////////////////////////
 
 //-----------------------------------------------------------------------------
-//      RXgN^ł.
+//      コンストラクタです.
 //-----------------------------------------------------------------------------
 RootSignature::RootSignature()
 { /* DO_NOTHING */
 }
 
 //-----------------------------------------------------------------------------
-//      fXgN^ł.
+//      デストラクタです.
 //-----------------------------------------------------------------------------
 RootSignature::~RootSignature()
 {
@@ -299,52 +419,204 @@ RootSignature::~RootSignature()
 }
 
 //-----------------------------------------------------------------------------
-//      s܂.
+//      初期化処理を行います.
 //-----------------------------------------------------------------------------
 bool RootSignature::Init(ID3D12Device* pDevice, const D3D12_ROOT_SIGNATURE_DESC* pDesc)
 {
 	ComPtr<ID3DBlob> pBlob;
-	ComPtr<ID3DBlob> pErrorBlob;
 
-	// VACY
-	auto hr = D3D12SerializeRootSignature(
-		pDesc,
-		D3D_ROOT_SIGNATURE_VERSION_1,
-		pBlob.GetAddressOf(),
-		pErrorBlob.GetAddressOf());
-	if (FAILED(hr))
+	// シリアライズ
+	if (!Serialize(pDesc, pBlob))
 	{
-		ELOG("Error : D3D12SerializeRootSignature() Failed. recode = 0x%x", hr);
+		ELOG("Error : RootSignature::Serialize() Failed.");
 		return false;
 	}
 
-	// [gVOj`𐶐.
-	hr = pDevice->CreateRootSignature(
-		0,
-		pBlob->GetBufferPointer(),
-		pBlob->GetBufferSize(),
-		IID_PPV_ARGS(m_RootSignature.GetAddressOf()));
-	if (FAILED(hr))
+	// ルートシグニチャを生成. シリアライズ結果が同じであれば共有します.
+	if (!PipelineCache::GetInstance().GetRootSignature(pDevice, pBlob->GetBufferPointer(), pBlob->GetBufferSize(), m_RootSignature))
 	{
-		ELOG("Error : Root Signature Create Failed. retcode = 0x%x", hr);
+		ELOG("Error : Root Signature Create Failed.");
 		return false;
 	}
 
+	m_Layout = Analyze(pDesc);
+
 	return true;
 }
 
 //-----------------------------------------------------------------------------
-//      Is܂.
+//      終了処理を行います.
 //-----------------------------------------------------------------------------
 void RootSignature::Term()
 {
 	m_RootSignature.Reset();
+	m_Layout = {};
 }
 
 //-----------------------------------------------------------------------------
-//      [gVOj`擾܂.
+//      ルートシグニチャを取得します.
 //-----------------------------------------------------------------------------
 ID3D12RootSignature* RootSignature::GetPtr() const
 {
 	return m_RootSignature.Get();
-}
\ No newline at end of file
+}
+
+//-----------------------------------------------------------------------------
+//      レイアウトの解析結果を取得します.
+//-----------------------------------------------------------------------------
+const RootSignature::Layout& RootSignature::GetLayout() const
+{
+	return m_Layout;
+}
+
+//-----------------------------------------------------------------------------
+//      ルートシグニチャをシリアライズします.
+//-----------------------------------------------------------------------------
+bool RootSignature::Serialize(const D3D12_ROOT_SIGNATURE_DESC* pDesc, ComPtr<ID3DBlob>& pBlob)
+{
+	ComPtr<ID3DBlob> pErrorBlob;
+
+	auto hr = D3D12SerializeRootSignature(
+		pDesc,
+		D3D_ROOT_SIGNATURE_VERSION_1,
+		pBlob.ReleaseAndGetAddressOf(),
+		pErrorBlob.GetAddressOf());
+	if (FAILED(hr))
+	{
+		if (pErrorBlob)
+		{
+			ELOG("Error : %s", static_cast<const char*>(pErrorBlob->GetBufferPointer()));
+		}
+
+		ELOG("Error : D3D12SerializeRootSignature() Failed. recode = 0x%x", hr);
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ルート引数のコストを求め, レイアウトを提案します.
+//-----------------------------------------------------------------------------
+RootSignature::Layout RootSignature::Analyze(const D3D12_ROOT_SIGNATURE_DESC* pDesc)
+{
+	// ルート引数の上限です.
+	const uint32_t MaxDWords  = 64;
+
+	// 多くのハードウェアでレジスタに直接載る目安です.
+	const uint32_t FastDWords = 16;
+
+	Layout layout = {};
+	if (pDesc == nullptr)
+	{
+		return layout;
+	}
+
+	layout.StaticSamplers = pDesc->NumStaticSamplers;
+
+	// ディスクリプタ1つだけのSRVテーブルをステージごとにまとめます.
+	std::vector<uint32_t> singleSRV[D3D12_SHADER_VISIBILITY_PIXEL + 1];
+	std::vector<uint32_t> singleCBV;
+
+	for (auto i = 0u; i < pDesc->NumParameters; ++i)
+	{
+		const auto& param = pDesc->pParameters[i];
+		switch (param.ParameterType)
+		{
+		case D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE:
+		{
+			layout.DWords += 1;
+			layout.Tables++;
+
+			const auto& table = param.DescriptorTable;
+			auto hasCBV = false;
+			for (auto j = 0u; j < table.NumDescriptorRanges; ++j)
+			{
+				hasCBV |= (table.pDescriptorRanges[j].RangeType == D3D12_DESCRIPTOR_RANGE_TYPE_CBV);
+			}
+
+			if (hasCBV)
+			{
+				layout.CBVTables++;
+			}
+
+			if (table.NumDescriptorRanges == 1 && table.pDescriptorRanges[0].NumDescriptors == 1)
+			{
+				layout.SingleTables++;
+
+				const auto& range = table.pDescriptorRanges[0];
+				if (range.RangeType == D3D12_DESCRIPTOR_RANGE_TYPE_CBV)
+				{
+					singleCBV.push_back(i);
+				}
+				else if (range.RangeType == D3D12_DESCRIPTOR_RANGE_TYPE_SRV && param.ShaderVisibility <= D3D12_SHADER_VISIBILITY_PIXEL)
+				{
+					singleSRV[param.ShaderVisibility].push_back(i);
+				}
+			}
+		}
+		break;
+
+		case D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS:
+		{
+			layout.DWords    += param.Constants.Num32BitValues;
+			layout.Constants += param.Constants.Num32BitValues;
+		}
+		break;
+
+		default:
+		{
+			// ルートディスクリプタはGPU仮想アドレス(64bit)を持ちます.
+			layout.DWords += 2;
+			layout.RootDescriptors++;
+		}
+		break;
+		}
+	}
+
+	char text[256];
+	layout.SuggestedDWords = layout.DWords;
+
+	// 定数バッファのテーブルはルートCBVにすると参照先を1回辿らずに済みます.
+	for (auto index : singleCBV)
+	{
+		if (layout.SuggestedDWords + 1 > MaxDWords)
+		{
+			break;
+		}
+
+		const auto& range = pDesc->pParameters[index].DescriptorTable.pDescriptorRanges[0];
+		sprintf_s(text, "param %u : CBV table (b%u) -> root CBV, +1 DWORD, no indirection", index, range.BaseShaderRegister);
+		layout.Suggestions.push_back(text);
+		layout.SuggestedDWords += 1;
+	}
+
+	// 同じステージのテクスチャはディスクリプタを連続して配置すれば1つのテーブルにまとめられます.
+	for (const auto& params : singleSRV)
+	{
+		if (params.size() < 2)
+		{
+			continue;
+		}
+
+		std::string list;
+		for (auto index : params)
+		{
+			list += (list.empty() ? "" : ",") + std::to_string(index);
+		}
+
+		auto saved = uint32_t(params.size() - 1);
+		sprintf_s(text, "params %s : %u SRV tables -> 1 multi-range table, -%u DWORD (needs contiguous descriptors)",
+			list.c_str(), uint32_t(params.size()), saved);
+		layout.Suggestions.push_back(text);
+		layout.SuggestedDWords -= saved;
+	}
+
+	if (layout.SuggestedDWords > FastDWords)
+	{
+		sprintf_s(text, "%u DWORD > %u : place frequently changing parameters first", layout.SuggestedDWords, FastDWords);
+		layout.Suggestions.push_back(text);
+	}
+
+	return layout;
+}
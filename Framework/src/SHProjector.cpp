@@ -0,0 +1,499 @@
+﻿//-----------------------------------------------------------------------------
+// File : SHProjector.cpp
+// Desc : Spherical Harmonics Irradiance Projection Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <SHProjector.h>
+#include <xmmintrin.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const double SH_PI      = 3.14159265358979323846;
+const float  SH_C0      = 0.282094792f;     // 1 / (2 * sqrt(π))
+const float  SH_C1      = 0.488602512f;     // sqrt(3 / (4π))
+const float  SH_C2      = 1.092548431f;     // sqrt(15 / (4π))
+const float  SH_C3      = 0.315391565f;     // sqrt(5 / (16π))
+const float  SH_C4      = 0.546274215f;     // sqrt(15 / (16π))
+
+// [係数][RGB] の順に並べ, 最後に立体角の合計を置きます.
+const uint32_t AccumCount = SHProjector::CoeffCount * 3 + 1;
+const uint32_t WeightSlot = AccumCount - 1;
+
+///////////////////////////////////////////////////////////////////////////////
+// Accum structure
+///////////////////////////////////////////////////////////////////////////////
+struct Accum
+{
+	double  Value[AccumCount];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// CubeFace structure
+///////////////////////////////////////////////////////////////////////////////
+struct CubeFace
+{
+	float   Major[3];   //!< 面の中心方向です.
+	float   U[3];       //!< テクスチャの横方向です.
+	float   V[3];       //!< テクスチャの縦方向です.
+};
+
+// D3D のキューブマップの面の向きです.
+const CubeFace CubeFaces[6] = {
+	{ {  1,  0,  0 }, {  0,  0, -1 }, { 0, -1,  0 } },     // +X
+	{ { -1,  0,  0 }, {  0,  0,  1 }, { 0, -1,  0 } },     // -X
+	{ {  0,  1,  0 }, {  1,  0,  0 }, { 0,  0,  1 } },     // +Y
+	{ {  0, -1,  0 }, {  1,  0,  0 }, { 0,  0, -1 } },     // -Y
+	{ {  0,  0,  1 }, {  1,  0,  0 }, { 0, -1,  0 } },     // +Z
+	{ {  0,  0, -1 }, { -1,  0,  0 }, { 0, -1,  0 } },     // -Z
+};
+
+//-----------------------------------------------------------------------------
+//      基底関数の値を倍精度で求めます.
+//-----------------------------------------------------------------------------
+void EvaluateBasisDouble(double x, double y, double z, double basis[SHProjector::CoeffCount])
+{
+	basis[0] = SH_C0;
+	basis[1] = SH_C1 * y;
+	basis[2] = SH_C1 * z;
+	basis[3] = SH_C1 * x;
+	basis[4] = SH_C2 * x * y;
+	basis[5] = SH_C2 * y * z;
+	basis[6] = SH_C3 * (3.0 * z * z - 1.0);
+	basis[7] = SH_C2 * x * z;
+	basis[8] = SH_C4 * (x * x - y * y);
+}
+
+//-----------------------------------------------------------------------------
+//      1方向の寄与を倍精度で加算します.
+//-----------------------------------------------------------------------------
+void AccumulateDouble(double x, double y, double z, double w, const float* pPixel, Accum& acc)
+{
+	double basis[SHProjector::CoeffCount];
+	EvaluateBasisDouble(x, y, z, basis);
+
+	for (auto k = 0u; k < SHProjector::CoeffCount; ++k)
+	{
+		auto bw = basis[k] * w;
+		acc.Value[k * 3 + 0] += bw * pPixel[0];
+		acc.Value[k * 3 + 1] += bw * pPixel[1];
+		acc.Value[k * 3 + 2] += bw * pPixel[2];
+	}
+
+	acc.Value[WeightSlot] += w;
+}
+
+//-----------------------------------------------------------------------------
+//      4方向の寄与をまとめて加算します.
+//-----------------------------------------------------------------------------
+inline void AccumulateSIMD(__m128 x, __m128 y, __m128 z, __m128 w, __m128 r, __m128 g, __m128 b, __m128* acc)
+{
+	const auto c1 = _mm_set1_ps(SH_C1);
+	const auto c2 = _mm_set1_ps(SH_C2);
+
+	__m128 basis[SHProjector::CoeffCount];
+	basis[0] = _mm_set1_ps(SH_C0);
+	basis[1] = _mm_mul_ps(c1, y);
+	basis[2] = _mm_mul_ps(c1, z);
+	basis[3] = _mm_mul_ps(c1, x);
+	basis[4] = _mm_mul_ps(c2, _mm_mul_ps(x, y));
+	basis[5] = _mm_mul_ps(c2, _mm_mul_ps(y, z));
+	basis[6] = _mm_mul_ps(_mm_set1_ps(SH_C3), _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(3.0f), _mm_mul_ps(z, z)), _mm_set1_ps(1.0f)));
+	basis[7] = _mm_mul_ps(c2, _mm_mul_ps(x, z));
+	basis[8] = _mm_mul_ps(_mm_set1_ps(SH_C4), _mm_sub_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+
+	auto wr = _mm_mul_ps(w, r);
+	auto wg = _mm_mul_ps(w, g);
+	auto wb = _mm_mul_ps(w, b);
+
+	for (auto k = 0u; k < SHProjector::CoeffCount; ++k)
+	{
+		acc[k * 3 + 0] = _mm_add_ps(acc[k * 3 + 0], _mm_mul_ps(basis[k], wr));
+		acc[k * 3 + 1] = _mm_add_ps(acc[k * 3 + 1], _mm_mul_ps(basis[k], wg));
+		acc[k * 3 + 2] = _mm_add_ps(acc[k * 3 + 2], _mm_mul_ps(basis[k], wb));
+	}
+
+	acc[WeightSlot] = _mm_add_ps(acc[WeightSlot], w);
+}
+
+//-----------------------------------------------------------------------------
+//      4ピクセルを読み込んで RGB ごとに並べ替えます.
+//-----------------------------------------------------------------------------
+inline void LoadPixels(const float* pRow, uint32_t x, uint32_t width, __m128& r, __m128& g, __m128& b)
+{
+	__m128 p[4];
+	for (auto i = 0u; i < 4; ++i)
+	{
+		// 端数のピクセルは重みを 0 にするので, 値は何でも構いません.
+		p[i] = (x + i < width) ? _mm_loadu_ps(pRow + size_t(x + i) * 4) : _mm_setzero_ps();
+	}
+
+	_MM_TRANSPOSE4_PS(p[0], p[1], p[2], p[3]);
+	r = p[0];
+	g = p[1];
+	b = p[2];
+}
+
+//-----------------------------------------------------------------------------
+//      1行分の SIMD の合計を倍精度の合計に加えます.
+//-----------------------------------------------------------------------------
+inline void FlushRow(const __m128* rowAcc, Accum& acc)
+{
+	alignas(16) float lanes[4];
+	for (auto i = 0u; i < AccumCount; ++i)
+	{
+		_mm_store_ps(lanes, rowAcc[i]);
+		acc.Value[i] += double(lanes[0]) + double(lanes[1]) + double(lanes[2]) + double(lanes[3]);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      行を分割して複数スレッドで処理し, 部分和を合計します.
+//-----------------------------------------------------------------------------
+template<typename Func>
+void ParallelRows(uint32_t rowCount, uint32_t threadCount, Accum& result, Func func)
+{
+	if (threadCount == 0)
+	{ threadCount = std::max(1u, std::thread::hardware_concurrency()); }
+	threadCount = std::max(1u, std::min(threadCount, rowCount));
+
+	// スレッド数が同じなら結果も同じになるよう, 部分和は番号順に合計します.
+	std::vector<Accum> partials(threadCount);
+	memset(partials.data(), 0, sizeof(Accum) * partials.size());
+
+	auto run = [&](uint32_t index)
+	{
+		auto begin = uint32_t(uint64_t(rowCount) * index       / threadCount);
+		auto end   = uint32_t(uint64_t(rowCount) * (index + 1) / threadCount);
+		func(begin, end, partials[index]);
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount - 1);
+	for (auto i = 1u; i < threadCount; ++i)
+	{ threads.emplace_back(run, i); }
+
+	run(0);
+
+	for (auto& thread : threads)
+	{ thread.join(); }
+
+	memset(&result, 0, sizeof(result));
+	for (const auto& partial : partials)
+	{
+		for (auto i = 0u; i < AccumCount; ++i)
+		{ result.Value[i] += partial.Value[i]; }
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      立体角の合計が 4π になるよう正規化して係数を求めます.
+//-----------------------------------------------------------------------------
+void Finalize(const Accum& acc, SHProjector::SH9& result)
+{
+	auto scale = (acc.Value[WeightSlot] > 0.0) ? (4.0 * SH_PI / acc.Value[WeightSlot]) : 0.0;
+	for (auto k = 0u; k < SHProjector::CoeffCount; ++k)
+	{
+		result.Coeffs[k][0] = float(acc.Value[k * 3 + 0] * scale);
+		result.Coeffs[k][1] = float(acc.Value[k * 3 + 1] * scale);
+		result.Coeffs[k][2] = float(acc.Value[k * 3 + 2] * scale);
+		result.Coeffs[k][3] = 0.0f;
+	}
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// SHProjector class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      正距円筒図法の環境マップを射影します.
+//-----------------------------------------------------------------------------
+void SHProjector::ProjectEquirect(const float* pPixels, uint32_t width, uint32_t height, uint32_t threadCount, SH9& result)
+{
+	memset(&result, 0, sizeof(result));
+	if (pPixels == nullptr || width == 0 || height == 0)
+	{ return; }
+
+	// 列ごとの経度の sin/cos は全ての行で共通なので先に求めます. 端数の列は重み 0 です.
+	auto paddedWidth = (width + 3) & ~3u;
+	std::vector<float> sinPhi(paddedWidth, 0.0f);
+	std::vector<float> cosPhi(paddedWidth, 0.0f);
+	std::vector<float> valid (paddedWidth, 0.0f);
+	for (auto x = 0u; x < width; ++x)
+	{
+		auto phi = 2.0 * SH_PI * (x + 0.5) / width;
+		sinPhi[x] = float(sin(phi));
+		cosPhi[x] = float(cos(phi));
+		valid [x] = 1.0f;
+	}
+
+	auto dPhiTheta = (2.0 * SH_PI / width) * (SH_PI / height);
+
+	Accum acc;
+	ParallelRows(height, threadCount, acc, [&](uint32_t begin, uint32_t end, Accum& partial)
+	{
+		for (auto y = begin; y < end; ++y)
+		{
+			auto theta    = SH_PI * (y + 0.5) / height;
+			auto sinTheta = float(sin(theta));
+			auto dirY     = _mm_set1_ps(float(cos(theta)));
+			auto scaleXZ  = _mm_set1_ps(sinTheta);
+			auto rowW     = _mm_set1_ps(float(dPhiTheta * sinTheta));
+			auto pRow     = pPixels + size_t(y) * width * 4;
+
+			__m128 rowAcc[AccumCount];
+			for (auto& v : rowAcc)
+			{ v = _mm_setzero_ps(); }
+
+			for (auto x = 0u; x < width; x += 4)
+			{
+				auto dirX = _mm_mul_ps(_mm_loadu_ps(&sinPhi[x]), scaleXZ);
+				auto dirZ = _mm_mul_ps(_mm_loadu_ps(&cosPhi[x]), scaleXZ);
+				auto w    = _mm_mul_ps(_mm_loadu_ps(&valid[x]), rowW);
+
+				__m128 r, g, b;
+				LoadPixels(pRow, x, width, r, g, b);
+				AccumulateSIMD(dirX, dirY, dirZ, w, r, g, b, rowAcc);
+			}
+
+			FlushRow(rowAcc, partial);
+		}
+	});
+
+	Finalize(acc, result);
+}
+
+//-----------------------------------------------------------------------------
+//      キューブマップの環境マップを射影します.
+//-----------------------------------------------------------------------------
+void SHProjector::ProjectCube(const float* pPixels, uint32_t size, uint32_t threadCount, SH9& result)
+{
+	memset(&result, 0, sizeof(result));
+	if (pPixels == nullptr || size == 0)
+	{ return; }
+
+	// 列ごとのテクスチャ座標は全ての行・面で共通なので先に求めます. 端数の列は重み 0 です.
+	auto paddedSize = (size + 3) & ~3u;
+	std::vector<float> coordS(paddedSize, 0.0f);
+	std::vector<float> valid (paddedSize, 0.0f);
+	for (auto x = 0u; x < size; ++x)
+	{
+		coordS[x] = float(2.0 * (x + 0.5) / size - 1.0);
+		valid [x] = 1.0f;
+	}
+
+	auto texelArea = float(4.0 / (double(size) * size));
+
+	Accum acc;
+	ParallelRows(size * 6, threadCount, acc, [&](uint32_t begin, uint32_t end, Accum& partial)
+	{
+		for (auto row = begin; row < end; ++row)
+		{
+			const auto& face = CubeFaces[row / size];
+			auto y = row % size;
+			auto t = float(2.0 * (y + 0.5) / size - 1.0);
+
+			// 方向 = Major + U * s + V * t を正規化し, 立体角は 4 / N^2 / (1 + s^2 + t^2)^(3/2) で近似します.
+			auto baseX = _mm_set1_ps(face.Major[0] + face.V[0] * t);
+			auto baseY = _mm_set1_ps(face.Major[1] + face.V[1] * t);
+			auto baseZ = _mm_set1_ps(face.Major[2] + face.V[2] * t);
+			auto uX    = _mm_set1_ps(face.U[0]);
+			auto uY    = _mm_set1_ps(face.U[1]);
+			auto uZ    = _mm_set1_ps(face.U[2]);
+			auto tt1   = _mm_set1_ps(1.0f + t * t);
+			auto area  = _mm_set1_ps(texelArea);
+			auto pRow  = pPixels + size_t(row) * size * 4;
+
+			__m128 rowAcc[AccumCount];
+			for (auto& v : rowAcc)
+			{ v = _mm_setzero_ps(); }
+
+			for (auto x = 0u; x < size; x += 4)
+			{
+				auto s      = _mm_loadu_ps(&coordS[x]);
+				auto lenSq  = _mm_add_ps(tt1, _mm_mul_ps(s, s));
+				auto invLen = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lenSq));
+
+				auto dirX = _mm_mul_ps(_mm_add_ps(baseX, _mm_mul_ps(uX, s)), invLen);
+				auto dirY = _mm_mul_ps(_mm_add_ps(baseY, _mm_mul_ps(uY, s)), invLen);
+				auto dirZ = _mm_mul_ps(_mm_add_ps(baseZ, _mm_mul_ps(uZ, s)), invLen);
+				auto w    = _mm_mul_ps(_mm_mul_ps(area, _mm_loadu_ps(&valid[x])), _mm_mul_ps(invLen, _mm_mul_ps(invLen, invLen)));
+
+				__m128 r, g, b;
+				LoadPixels(pRow, x, size, r, g, b);
+				AccumulateSIMD(dirX, dirY, dirZ, w, r, g, b, rowAcc);
+			}
+
+			FlushRow(rowAcc, partial);
+		}
+	});
+
+	Finalize(acc, result);
+}
+
+//-----------------------------------------------------------------------------
+//      正距円筒図法の環境マップを1ピクセルずつ射影します.
+//-----------------------------------------------------------------------------
+void SHProjector::ProjectEquirectReference(const float* pPixels, uint32_t width, uint32_t height, SH9& result)
+{
+	memset(&result, 0, sizeof(result));
+	if (pPixels == nullptr || width == 0 || height == 0)
+	{ return; }
+
+	Accum acc = {};
+	for (auto y = 0u; y < height; ++y)
+	{
+		auto theta = SH_PI * (y + 0.5) / height;
+		auto w     = (2.0 * SH_PI / width) * (SH_PI / height) * sin(theta);
+
+		for (auto x = 0u; x < width; ++x)
+		{
+			auto phi = 2.0 * SH_PI * (x + 0.5) / width;
+			AccumulateDouble(
+				sin(phi) * sin(theta),
+				cos(theta),
+				cos(phi) * sin(theta),
+				w,
+				pPixels + (size_t(y) * width + x) * 4,
+				acc);
+		}
+	}
+
+	Finalize(acc, result);
+}
+
+//-----------------------------------------------------------------------------
+//      キューブマップの環境マップを1ピクセルずつ射影します.
+//-----------------------------------------------------------------------------
+void SHProjector::ProjectCubeReference(const float* pPixels, uint32_t size, SH9& result)
+{
+	memset(&result, 0, sizeof(result));
+	if (pPixels == nullptr || size == 0)
+	{ return; }
+
+	Accum acc = {};
+	for (auto f = 0u; f < 6; ++f)
+	{
+		const auto& face = CubeFaces[f];
+		for (auto y = 0u; y < size; ++y)
+		{
+			auto t = 2.0 * (y + 0.5) / size - 1.0;
+			for (auto x = 0u; x < size; ++x)
+			{
+				auto s      = 2.0 * (x + 0.5) / size - 1.0;
+				auto lenSq  = 1.0 + s * s + t * t;
+				auto invLen = 1.0 / sqrt(lenSq);
+
+				AccumulateDouble(
+					(face.Major[0] + face.U[0] * s + face.V[0] * t) * invLen,
+					(face.Major[1] + face.U[1] * s + face.V[1] * t) * invLen,
+					(face.Major[2] + face.U[2] * s + face.V[2] * t) * invLen,
+					4.0 / (double(size) * size) * invLen * invLen * invLen,
+					pPixels + ((size_t(f) * size + y) * size + x) * 4,
+					acc);
+			}
+		}
+	}
+
+	Finalize(acc, result);
+}
+
+//-----------------------------------------------------------------------------
+//      全ピクセルを総当たりで積分してディフューズのLD項を求めます.
+//-----------------------------------------------------------------------------
+void SHProjector::IntegrateEquirectReference(const float* pPixels, uint32_t width, uint32_t height, const float dir[3], float result[3])
+{
+	result[0] = result[1] = result[2] = 0.0f;
+	if (pPixels == nullptr || width == 0 || height == 0)
+	{ return; }
+
+	double sum[3]   = {};
+	double weight   = 0.0;
+	for (auto y = 0u; y < height; ++y)
+	{
+		auto theta = SH_PI * (y + 0.5) / height;
+		auto w     = (2.0 * SH_PI / width) * (SH_PI / height) * sin(theta);
+
+		for (auto x = 0u; x < width; ++x)
+		{
+			auto phi = 2.0 * SH_PI * (x + 0.5) / width;
+			auto cosine = dir[0] * sin(phi) * sin(theta) + dir[1] * cos(theta) + dir[2] * cos(phi) * sin(theta);
+			weight += w;
+			if (cosine <= 0.0)
+			{ continue; }
+
+			auto pPixel = pPixels + (size_t(y) * width + x) * 4;
+			sum[0] += pPixel[0] * cosine * w;
+			sum[1] += pPixel[1] * cosine * w;
+			sum[2] += pPixel[2] * cosine * w;
+		}
+	}
+
+	// 射影と同じく立体角の合計を 4π に正規化し, Lambert BRDF の 1/π を掛けます.
+	auto scale = 4.0 / weight;
+	result[0] = float(sum[0] * scale);
+	result[1] = float(sum[1] * scale);
+	result[2] = float(sum[2] * scale);
+}
+
+//-----------------------------------------------------------------------------
+//      放射輝度の係数をランバートの余弦ローブで畳み込みます.
+//-----------------------------------------------------------------------------
+void SHProjector::ConvolveLambert(SH9& sh)
+{
+	// 余弦ローブの帯域ごとの係数 π, 2π/3, π/4 を π で割った値です.
+	const float bands[CoeffCount] = {
+		1.0f,
+		2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f,
+		0.25f, 0.25f, 0.25f, 0.25f, 0.25f,
+	};
+
+	for (auto k = 0u; k < CoeffCount; ++k)
+	{
+		sh.Coeffs[k][0] *= bands[k];
+		sh.Coeffs[k][1] *= bands[k];
+		sh.Coeffs[k][2] *= bands[k];
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      基底関数の値を求めます.
+//-----------------------------------------------------------------------------
+void SHProjector::EvaluateBasis(const float dir[3], float basis[CoeffCount])
+{
+	double values[CoeffCount];
+	EvaluateBasisDouble(dir[0], dir[1], dir[2], values);
+
+	for (auto k = 0u; k < CoeffCount; ++k)
+	{ basis[k] = float(values[k]); }
+}
+
+//-----------------------------------------------------------------------------
+//      係数から指定方向の値を復元します.
+//-----------------------------------------------------------------------------
+void SHProjector::Evaluate(const SH9& sh, const float dir[3], float result[3])
+{
+	float basis[CoeffCount];
+	EvaluateBasis(dir, basis);
+
+	result[0] = result[1] = result[2] = 0.0f;
+	for (auto k = 0u; k < CoeffCount; ++k)
+	{
+		result[0] += sh.Coeffs[k][0] * basis[k];
+		result[1] += sh.Coeffs[k][1] * basis[k];
+		result[2] += sh.Coeffs[k][2] * basis[k];
+	}
+}
@@ -0,0 +1,32 @@
+﻿//-----------------------------------------------------------------------------
+// File : SceneComponents.cpp
+// Desc : Scene Components And Systems For EntityRegistry.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <SceneComponents.h>
+
+namespace SceneSystems {
+
+//-----------------------------------------------------------------------------
+//      LocalTransform から WorldTransform を計算します.
+//-----------------------------------------------------------------------------
+void UpdateWorldTransforms(EntityRegistry& registry, float deltaTime)
+{
+	(void)deltaTime;
+
+	registry.Each<WorldTransform, LocalTransform>(
+		[](Entity, WorldTransform& world, const LocalTransform& local)
+		{
+			world.World = DirectX::XMMatrixAffineTransformation(
+				local.Scale,
+				DirectX::XMVectorZero(),
+				local.Rotation,
+				local.Position);
+		});
+}
+
+} // namespace SceneSystems
@@ -0,0 +1,692 @@
+﻿//-----------------------------------------------------------------------------
+// File : ShaderLibrary.cpp
+// Desc : Compiled Shader Library Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <ShaderLibrary.h>
+#include <InlineUtil.h>
+#include <FileUtil.h>
+#include <Logger.h>
+#include <d3dcompiler.h>
+#include <d3d12shader.h>
+#include <fstream>
+#include <cstring>
+#include <climits>
+#include <chrono>
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      リソースの種類からディスクリプタレンジの種類を求めます.
+//-----------------------------------------------------------------------------
+D3D12_DESCRIPTOR_RANGE_TYPE ToRangeType(D3D_SHADER_INPUT_TYPE type)
+{
+	switch (type)
+	{
+	case D3D_SIT_CBUFFER:
+		return D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
+
+	case D3D_SIT_SAMPLER:
+		return D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER;
+
+	case D3D_SIT_UAV_RWTYPED:
+	case D3D_SIT_UAV_RWSTRUCTURED:
+	case D3D_SIT_UAV_RWBYTEADDRESS:
+	case D3D_SIT_UAV_APPEND_STRUCTURED:
+	case D3D_SIT_UAV_CONSUME_STRUCTURED:
+	case D3D_SIT_UAV_RWSTRUCTURED_WITH_COUNTER:
+		return D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+
+	default:
+		return D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      シェーダステージのルートアクセス拒否フラグを求めます.
+//-----------------------------------------------------------------------------
+D3D12_ROOT_SIGNATURE_FLAGS ToDenyFlag(D3D12_SHADER_VISIBILITY visibility)
+{
+	switch (visibility)
+	{
+	case D3D12_SHADER_VISIBILITY_VERTEX:    return D3D12_ROOT_SIGNATURE_FLAG_DENY_VERTEX_SHADER_ROOT_ACCESS;
+	case D3D12_SHADER_VISIBILITY_HULL:      return D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS;
+	case D3D12_SHADER_VISIBILITY_DOMAIN:    return D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS;
+	case D3D12_SHADER_VISIBILITY_GEOMETRY:  return D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS;
+	case D3D12_SHADER_VISIBILITY_PIXEL:     return D3D12_ROOT_SIGNATURE_FLAG_DENY_PIXEL_SHADER_ROOT_ACCESS;
+	default:                                return D3D12_ROOT_SIGNATURE_FLAG_NONE;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      ディスクリプタレンジがリソースを含むかどうかチェックします.
+//-----------------------------------------------------------------------------
+bool Contains(const D3D12_DESCRIPTOR_RANGE& range, const ShaderLibrary::Binding& binding)
+{
+	if (binding.Register < range.BaseShaderRegister)
+	{ return false; }
+
+	// サイズ指定なしのレンジは以降の全てのレジスタを含みます.
+	if (range.NumDescriptors == UINT_MAX)
+	{ return true; }
+
+	if (binding.Count == 0)
+	{ return false; }
+
+	return uint64_t(binding.Register) + binding.Count <= uint64_t(range.BaseShaderRegister) + range.NumDescriptors;
+}
+
+//-----------------------------------------------------------------------------
+//      書き出し位置を配置境界に揃えます.
+//-----------------------------------------------------------------------------
+void AlignTo(std::vector<uint8_t>& data, size_t alignment)
+{
+	auto size = (data.size() + alignment - 1) / alignment * alignment;
+	data.resize(size, 0);
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// ShaderLibrary class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      シェーダアーカイブを読み込みます.
+//-----------------------------------------------------------------------------
+bool ShaderLibrary::MountArchive(const wchar_t* path)
+{
+	if (path == nullptr)
+	{
+		ELOG("Error : Invalid Argument.");
+		return false;
+	}
+
+	std::ifstream stream(path, std::ios::binary | std::ios::ate);
+	if (!stream.is_open())
+	{
+		return false;
+	}
+
+	// 個別のファイルを開かずに済むよう, 全体を1回で読み込みます.
+	std::vector<uint8_t> archive(size_t(stream.tellg()));
+	stream.seekg(0, std::ios::beg);
+	stream.read(reinterpret_cast<char*>(archive.data()), std::streamsize(archive.size()));
+	if (!stream.good())
+	{
+		ELOG("Error : File Read Failed. path = %ls", path);
+		return false;
+	}
+
+	std::lock_guard<std::mutex> locker(m_Mutex);
+
+	m_Archive.swap(archive);
+	m_Archived.clear();
+
+	std::vector<ArchiveItem> items;
+	if (!ParseArchive(m_Archive, items))
+	{
+		ELOG("Warning : ShaderArchive File Invalid. path = %ls", path);
+		m_Archive.clear();
+		return false;
+	}
+
+	for (auto& item : items)
+	{
+		auto name = item.Name;
+		m_Archived[name] = std::move(item);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      読み込んだシェーダとアーカイブを全て破棄します.
+//-----------------------------------------------------------------------------
+void ShaderLibrary::Term()
+{
+	std::lock_guard<std::mutex> locker(m_Mutex);
+
+	m_Names   .clear();
+	m_Blobs   .clear();
+	m_Archived.clear();
+	m_Archive .clear();
+	m_Archive .shrink_to_fit();
+
+	m_Stats = {};
+}
+
+//-----------------------------------------------------------------------------
+//      コンパイル済みシェーダを取得します.
+//-----------------------------------------------------------------------------
+bool ShaderLibrary::Load(const std::wstring& name, ComPtr<ID3DBlob>& pBlob)
+{
+	std::lock_guard<std::mutex> locker(m_Mutex);
+	m_Stats.Requests++;
+
+	auto found = m_Names.find(name);
+	if (found != m_Names.end())
+	{
+		m_Stats.NameHits++;
+		pBlob = m_Blobs[found->second].pBlob;
+		return true;
+	}
+
+	auto t0 = std::chrono::high_resolution_clock::now();
+
+	ComPtr<ID3DBlob> blob;
+	uint64_t hash = 0;
+
+	auto archived = m_Archived.find(name);
+	if (archived != m_Archived.end())
+	{
+		const auto& item = archived->second;
+		auto hr = D3DCreateBlob(item.Size, blob.GetAddressOf());
+		if (FAILED(hr))
+		{
+			ELOG("Error : D3DCreateBlob() Failed. retcode = 0x%x", hr);
+			return false;
+		}
+
+		memcpy(blob->GetBufferPointer(), item.pData, item.Size);
+		hash = item.Hash;
+		m_Stats.ArchiveHits++;
+	}
+	else
+	{
+		std::wstring fullPath;
+		if (!SearchFilePath(name.c_str(), fullPath))
+		{
+			ELOG("Error : %ls Shader Not Found.", name.c_str());
+			return false;
+		}
+
+		auto hr = D3DReadFileToBlob(fullPath.c_str(), blob.GetAddressOf());
+		if (FAILED(hr))
+		{
+			ELOG("Error : D3DReadFileToBlob() Failed. path = %ls", fullPath.c_str());
+			return false;
+		}
+
+		ELOG("Shader Loaded. Path = %ls", fullPath.c_str());
+		hash = HashBytes(blob->GetBufferPointer(), blob->GetBufferSize());
+		m_Stats.FileReads++;
+	}
+
+	auto& entry = m_Blobs[hash];
+	if (!entry.pBlob)
+	{
+		entry.pBlob = blob;
+		m_Stats.Bytes += blob->GetBufferSize();
+	}
+	else if (entry.pBlob->GetBufferSize() == blob->GetBufferSize()
+		&& memcmp(entry.pBlob->GetBufferPointer(), blob->GetBufferPointer(), blob->GetBufferSize()) == 0)
+	{
+		// 別名で同じ内容を読み込んだ場合は, 先に読み込んだものを共有します.
+		m_Stats.Interned++;
+		blob = entry.pBlob;
+	}
+	else
+	{
+		// ハッシュ値が衝突した場合は共有せず, 毎回読み込みます.
+		ELOG("Warning : Shader Hash Collision. name = %ls, hash = 0x%016llx", name.c_str(), static_cast<unsigned long long>(hash));
+		pBlob = blob;
+		return true;
+	}
+
+	auto t1 = std::chrono::high_resolution_clock::now();
+	m_Stats.MilliSec += std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+	m_Names[name] = hash;
+	pBlob = blob;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      読み込み済みのシェーダをアーカイブに書き出します.
+//-----------------------------------------------------------------------------
+bool ShaderLibrary::WriteArchive(const wchar_t* path) const
+{
+	if (path == nullptr)
+	{
+		ELOG("Error : Invalid Argument.");
+		return false;
+	}
+
+	std::vector<uint8_t> archive;
+	{
+		std::lock_guard<std::mutex> locker(m_Mutex);
+
+		std::vector<ArchiveItem> items;
+		items.reserve(m_Names.size());
+		for (const auto& itr : m_Names)
+		{
+			const auto& pBlob = m_Blobs.at(itr.second).pBlob;
+
+			ArchiveItem item;
+			item.Name  = itr.first;
+			item.pData = pBlob->GetBufferPointer();
+			item.Size  = pBlob->GetBufferSize();
+			item.Hash  = itr.second;
+			items.push_back(item);
+		}
+
+		BuildArchive(items, archive);
+	}
+
+	std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+	if (!stream.is_open())
+	{
+		ELOG("Error : File Open Failed. path = %ls", path);
+		return false;
+	}
+
+	stream.write(reinterpret_cast<const char*>(archive.data()), std::streamsize(archive.size()));
+	if (!stream.good())
+	{
+		ELOG("Error : File Write Failed. path = %ls", path);
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      シェーダが使用するリソースを取得します.
+//-----------------------------------------------------------------------------
+bool ShaderLibrary::GetBindings(const D3D12_SHADER_BYTECODE& shader, std::vector<Binding>& bindings)
+{
+	if (shader.pShaderBytecode == nullptr || shader.BytecodeLength == 0)
+	{
+		bindings.clear();
+		return true;
+	}
+
+	std::lock_guard<std::mutex> locker(m_Mutex);
+
+	// ヘッダに埋め込んだシェーダなど, ここで読み込んでいないものはリフレクション結果だけ保持します.
+	auto& entry = m_Blobs[HashBytes(shader.pShaderBytecode, shader.BytecodeLength)];
+	if (!entry.Reflected)
+	{
+		if (!Reflect(entry, shader))
+		{
+			return false;
+		}
+		m_Stats.Reflected++;
+	}
+
+	bindings = entry.Bindings;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      パイプラインステートのシェーダがルートシグニチャに収まっているか検証します.
+//-----------------------------------------------------------------------------
+bool ShaderLibrary::ValidatePipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, const void* pRootSig, size_t size)
+{
+	ComPtr<ID3D12RootSignatureDeserializer> pDeserializer;
+	auto hr = D3D12CreateRootSignatureDeserializer(pRootSig, size, IID_PPV_ARGS(pDeserializer.GetAddressOf()));
+	if (FAILED(hr))
+	{
+		ELOG("Error : D3D12CreateRootSignatureDeserializer() Failed. retcode = 0x%x", hr);
+		return false;
+	}
+
+	struct Stage
+	{
+		const D3D12_SHADER_BYTECODE*    pShader;
+		D3D12_SHADER_VISIBILITY         Visibility;
+		const char*                     Tag;
+	};
+
+	const Stage stages[] = {
+		{ &desc.VS, D3D12_SHADER_VISIBILITY_VERTEX,   "VS" },
+		{ &desc.HS, D3D12_SHADER_VISIBILITY_HULL,     "HS" },
+		{ &desc.DS, D3D12_SHADER_VISIBILITY_DOMAIN,   "DS" },
+		{ &desc.GS, D3D12_SHADER_VISIBILITY_GEOMETRY, "GS" },
+		{ &desc.PS, D3D12_SHADER_VISIBILITY_PIXEL,    "PS" },
+	};
+
+	auto result = true;
+	for (const auto& stage : stages)
+	{
+		std::vector<Binding> bindings;
+		if (!GetBindings(*stage.pShader, bindings))
+		{
+			continue;
+		}
+
+		std::vector<std::string> errors;
+		if (!ValidateBindings(*pDeserializer->GetRootSignatureDesc(), stage.Visibility, bindings, errors))
+		{
+			for (const auto& error : errors)
+			{
+				ELOG("Warning : %s %s", stage.Tag, error.c_str());
+			}
+			result = false;
+		}
+	}
+
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      統計情報を取得します.
+//-----------------------------------------------------------------------------
+const ShaderLibrary::Stats& ShaderLibrary::GetStats() const
+{
+	return m_Stats;
+}
+
+//-----------------------------------------------------------------------------
+//      読み込み済みのシェーダ名の数を取得します.
+//-----------------------------------------------------------------------------
+size_t ShaderLibrary::GetCount() const
+{
+	std::lock_guard<std::mutex> locker(m_Mutex);
+	return m_Names.size();
+}
+
+//-----------------------------------------------------------------------------
+//      内容が異なるバイトコードの数を取得します.
+//-----------------------------------------------------------------------------
+size_t ShaderLibrary::GetBlobCount() const
+{
+	std::lock_guard<std::mutex> locker(m_Mutex);
+
+	size_t count = 0;
+	for (const auto& itr : m_Blobs)
+	{
+		if (itr.second.pBlob)
+		{ count++; }
+	}
+
+	return count;
+}
+
+//-----------------------------------------------------------------------------
+//      アーカイブを読み込んでいるかどうかチェックします.
+//-----------------------------------------------------------------------------
+bool ShaderLibrary::HasArchive() const
+{
+	std::lock_guard<std::mutex> locker(m_Mutex);
+	return !m_Archive.empty();
+}
+
+//-----------------------------------------------------------------------------
+//      アーカイブに書き出すデータを構築します.
+//-----------------------------------------------------------------------------
+void ShaderLibrary::BuildArchive(const std::vector<ArchiveItem>& items, std::vector<uint8_t>& archive)
+{
+	std::vector<ArchiveEntry>   entries(items.size());
+	std::vector<uint16_t>       names;
+	std::vector<size_t>         unique;     // 格納するバイトコードの items 内の番号です.
+	std::vector<size_t>         owner(items.size());
+
+	for (size_t i = 0; i < items.size(); ++i)
+	{
+		const auto& item = items[i];
+		auto& entry = entries[i];
+
+		entry.Hash       = HashBytes(item.pData, item.Size);
+		entry.Size       = item.Size;
+		entry.NameOffset = uint32_t(names.size());
+		entry.NameLength = uint32_t(item.Name.size());
+
+		// ファイル名は ASCII を想定し, プラットフォームに依存しないよう 16bit で格納します.
+		for (auto c : item.Name)
+		{ names.push_back(uint16_t(c)); }
+
+		owner[i] = unique.size();
+		for (size_t j = 0; j < unique.size(); ++j)
+		{
+			const auto& other = items[unique[j]];
+			if (entries[unique[j]].Hash == entry.Hash && other.Size == item.Size && memcmp(other.pData, item.pData, item.Size) == 0)
+			{
+				owner[i] = j;
+				break;
+			}
+		}
+
+		if (owner[i] == unique.size())
+		{ unique.push_back(i); }
+	}
+
+	ArchiveHeader header = {};
+	header.Magic    = ArchiveMagic;
+	header.Version  = ArchiveVersion;
+	header.Count    = uint32_t(items.size());
+	header.NameSize = uint32_t(names.size());
+
+	archive.clear();
+	archive.resize(sizeof(header) + sizeof(ArchiveEntry) * entries.size() + sizeof(uint16_t) * names.size());
+	if (!names.empty())
+	{ memcpy(&archive[sizeof(header) + sizeof(ArchiveEntry) * entries.size()], names.data(), sizeof(uint16_t) * names.size()); }
+
+	std::vector<uint64_t> offsets(unique.size());
+	for (size_t j = 0; j < unique.size(); ++j)
+	{
+		const auto& item = items[unique[j]];
+
+		AlignTo(archive, DataAlignment);
+		offsets[j] = archive.size();
+
+		auto ptr = static_cast<const uint8_t*>(item.pData);
+		archive.insert(archive.end(), ptr, ptr + item.Size);
+	}
+
+	for (size_t i = 0; i < entries.size(); ++i)
+	{ entries[i].Offset = offsets[owner[i]]; }
+
+	header.Size = archive.size();
+	memcpy(&archive[0], &header, sizeof(header));
+	if (!entries.empty())
+	{ memcpy(&archive[sizeof(header)], entries.data(), sizeof(ArchiveEntry) * entries.size()); }
+}
+
+//-----------------------------------------------------------------------------
+//      アーカイブの内容を検証して取り出します.
+//-----------------------------------------------------------------------------
+bool ShaderLibrary::ParseArchive(const std::vector<uint8_t>& archive, std::vector<ArchiveItem>& items)
+{
+	items.clear();
+
+	if (archive.size() < sizeof(ArchiveHeader))
+	{ return false; }
+
+	ArchiveHeader header;
+	memcpy(&header, archive.data(), sizeof(header));
+
+	if (header.Magic != ArchiveMagic || header.Version != ArchiveVersion || header.Size != archive.size())
+	{ return false; }
+
+	auto tableSize = uint64_t(sizeof(ArchiveEntry)) * header.Count + uint64_t(sizeof(uint16_t)) * header.NameSize;
+	if (tableSize > archive.size() - sizeof(header))
+	{ return false; }
+
+	auto namePos = sizeof(header) + sizeof(ArchiveEntry) * size_t(header.Count);
+
+	items.resize(header.Count);
+	for (auto i = 0u; i < header.Count; ++i)
+	{
+		ArchiveEntry entry;
+		memcpy(&entry, &archive[sizeof(header) + sizeof(ArchiveEntry) * i], sizeof(entry));
+
+		if (uint64_t(entry.NameOffset) + entry.NameLength > header.NameSize
+		 || entry.Offset > archive.size() || entry.Size > archive.size() - entry.Offset)
+		{
+			items.clear();
+			return false;
+		}
+
+		auto pData = archive.data() + size_t(entry.Offset);
+		if (HashBytes(pData, size_t(entry.Size)) != entry.Hash)
+		{
+			items.clear();
+			return false;
+		}
+
+		auto& item = items[i];
+		item.Name.resize(entry.NameLength);
+		for (auto j = 0u; j < entry.NameLength; ++j)
+		{
+			uint16_t c;
+			memcpy(&c, &archive[namePos + sizeof(uint16_t) * (entry.NameOffset + j)], sizeof(c));
+			item.Name[j] = wchar_t(c);
+		}
+		item.pData = pData;
+		item.Size  = size_t(entry.Size);
+		item.Hash  = entry.Hash;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      リソースがルートシグニチャに収まっているか検証します.
+//-----------------------------------------------------------------------------
+bool ShaderLibrary::ValidateBindings
+(
+	const D3D12_ROOT_SIGNATURE_DESC&    desc,
+	D3D12_SHADER_VISIBILITY             visibility,
+	const std::vector<Binding>&         bindings,
+	std::vector<std::string>&           errors
+)
+{
+	errors.clear();
+
+	auto visible = [&](D3D12_SHADER_VISIBILITY value)
+	{ return value == D3D12_SHADER_VISIBILITY_ALL || value == visibility; };
+
+	auto deny = ToDenyFlag(visibility);
+	auto denied = (deny != D3D12_ROOT_SIGNATURE_FLAG_NONE) && ((desc.Flags & deny) != 0);
+
+	for (const auto& binding : bindings)
+	{
+		auto type    = ToRangeType(binding.Type);
+		auto covered = false;
+
+		for (auto i = 0u; i < desc.NumParameters && !covered && !denied; ++i)
+		{
+			const auto& param = desc.pParameters[i];
+			if (!visible(param.ShaderVisibility))
+			{ continue; }
+
+			switch (param.ParameterType)
+			{
+			case D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE:
+				{
+					const auto& table = param.DescriptorTable;
+					for (auto j = 0u; j < table.NumDescriptorRanges && !covered; ++j)
+					{
+						const auto& range = table.pDescriptorRanges[j];
+						covered = (range.RangeType == type)
+							   && (range.RegisterSpace == binding.Space)
+							   && Contains(range, binding);
+					}
+				}
+				break;
+
+			case D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS:
+				covered = (type == D3D12_DESCRIPTOR_RANGE_TYPE_CBV)
+					   && (param.Constants.ShaderRegister == binding.Register)
+					   && (param.Constants.RegisterSpace  == binding.Space)
+					   && (binding.Count == 1);
+				break;
+
+			case D3D12_ROOT_PARAMETER_TYPE_CBV:
+			case D3D12_ROOT_PARAMETER_TYPE_SRV:
+			case D3D12_ROOT_PARAMETER_TYPE_UAV:
+				{
+					auto rootType = (param.ParameterType == D3D12_ROOT_PARAMETER_TYPE_CBV) ? D3D12_DESCRIPTOR_RANGE_TYPE_CBV
+								  : (param.ParameterType == D3D12_ROOT_PARAMETER_TYPE_SRV) ? D3D12_DESCRIPTOR_RANGE_TYPE_SRV
+								  : D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+					covered = (type == rootType)
+						   && (param.Descriptor.ShaderRegister == binding.Register)
+						   && (param.Descriptor.RegisterSpace  == binding.Space)
+						   && (binding.Count == 1);
+				}
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		if (!covered && !denied && type == D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER)
+		{
+			for (auto i = 0u; i < desc.NumStaticSamplers && !covered; ++i)
+			{
+				const auto& sampler = desc.pStaticSamplers[i];
+				covered = visible(sampler.ShaderVisibility)
+					   && (sampler.ShaderRegister == binding.Register)
+					   && (sampler.RegisterSpace  == binding.Space);
+			}
+		}
+
+		if (covered)
+		{ continue; }
+
+		const char prefix[] = { 'b', 't', 'u', 's' };
+		auto index = (type == D3D12_DESCRIPTOR_RANGE_TYPE_CBV) ? 0
+				   : (type == D3D12_DESCRIPTOR_RANGE_TYPE_SRV) ? 1
+				   : (type == D3D12_DESCRIPTOR_RANGE_TYPE_UAV) ? 2 : 3;
+
+		char text[256];
+		sprintf_s(text, "%s (%c%u, space%u) is not bound%s.",
+			binding.Name.c_str(), prefix[index], binding.Register, binding.Space,
+			denied ? " (root access denied)" : "");
+		errors.push_back(text);
+	}
+
+	return errors.empty();
+}
+
+//-----------------------------------------------------------------------------
+//      リフレクション情報を取得します.
+//-----------------------------------------------------------------------------
+bool ShaderLibrary::Reflect(BlobEntry& entry, const D3D12_SHADER_BYTECODE& shader)
+{
+	// 失敗した場合も警告を繰り返さないよう, リソース無しとして扱います.
+	entry.Bindings.clear();
+	entry.Reflected = true;
+
+	ComPtr<ID3D12ShaderReflection> pReflection;
+	auto hr = D3DReflect(shader.pShaderBytecode, shader.BytecodeLength, IID_PPV_ARGS(pReflection.GetAddressOf()));
+	if (FAILED(hr))
+	{
+		ELOG("Warning : D3DReflect() Failed. retcode = 0x%x", hr);
+		return false;
+	}
+
+	D3D12_SHADER_DESC desc;
+	hr = pReflection->GetDesc(&desc);
+	if (FAILED(hr))
+	{
+		ELOG("Warning : ID3D12ShaderReflection::GetDesc() Failed. retcode = 0x%x", hr);
+		return false;
+	}
+
+	entry.Bindings.reserve(desc.BoundResources);
+	for (auto i = 0u; i < desc.BoundResources; ++i)
+	{
+		D3D12_SHADER_INPUT_BIND_DESC bind;
+		hr = pReflection->GetResourceBindingDesc(i, &bind);
+		if (FAILED(hr))
+		{ continue; }
+
+		Binding binding;
+		binding.Name     = (bind.Name != nullptr) ? bind.Name : "";
+		binding.Type     = bind.Type;
+		binding.Register = bind.BindPoint;
+		binding.Count    = bind.BindCount;
+		binding.Space    = bind.Space;
+		entry.Bindings.push_back(binding);
+	}
+
+	return true;
+}
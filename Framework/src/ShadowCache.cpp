@@ -0,0 +1,393 @@
+﻿//-----------------------------------------------------------------------------
+// File : ShadowCache.cpp
+// Desc : Static Shadow Cache Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <ShadowCache.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+using namespace DirectX;
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static_assert(ShadowCache::RegionCount * ShadowCache::RegionCount == 64, "Region mask must fit in 64 bits.");
+const uint64_t AllRegions = ~uint64_t(0);
+
+//-----------------------------------------------------------------------------
+//      正規化デバイス座標を領域の番号に変換します.
+//-----------------------------------------------------------------------------
+uint32_t ToRegion(float ndc)
+{
+	auto t = std::floor((ndc * 0.5f + 0.5f) * float(ShadowCache::RegionCount));
+	return uint32_t(std::min(std::max(t, 0.0f), float(ShadowCache::RegionCount - 1)));
+}
+
+//-----------------------------------------------------------------------------
+//      矩形に含まれる領域のビットを求めます.
+//-----------------------------------------------------------------------------
+uint64_t RectMask(uint32_t col0, uint32_t col1, uint32_t row0, uint32_t row1)
+{
+	auto row  = ((uint64_t(1) << (col1 - col0 + 1)) - 1) << col0;
+	auto mask = uint64_t(0);
+	for (auto y = row0; y <= row1; ++y)
+	{ mask |= row << (y * ShadowCache::RegionCount); }
+	return mask;
+}
+
+//-----------------------------------------------------------------------------
+//      立っているビット数を求めます.
+//-----------------------------------------------------------------------------
+uint32_t CountBits(uint64_t mask)
+{
+	auto count = 0u;
+	for (; mask != 0; mask &= mask - 1)
+	{ count++; }
+	return count;
+}
+
+} // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+// ShadowCache class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+ShadowCache::ShadowCache()
+: m_CascadeCount(0)
+, m_TileSize    (0)
+, m_SettleFrames(DefaultSettleFrames)
+, m_Valid       (false)
+, m_FrameDynamic(false)
+, m_AtlasDynamic(false)
+{
+	memset(m_ViewProj,  0, sizeof(m_ViewProj));
+	memset(m_Dirty,     0, sizeof(m_Dirty));
+	memset(m_DirtyRect, 0, sizeof(m_DirtyRect));
+	memset(&m_Stats,    0, sizeof(m_Stats));
+}
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+ShadowCache::~ShadowCache()
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      キャッシュ全体を無効にします.
+//-----------------------------------------------------------------------------
+void ShadowCache::Invalidate()
+{
+	m_Valid = false;
+}
+
+//-----------------------------------------------------------------------------
+//      動かなくなってから静的とみなすまでのフレーム数を設定します.
+//-----------------------------------------------------------------------------
+void ShadowCache::SetSettleFrames(uint32_t frames)
+{
+	m_SettleFrames = frames;
+}
+
+//-----------------------------------------------------------------------------
+//      フレームの更新を開始します.
+//-----------------------------------------------------------------------------
+void ShadowCache::BeginFrame(const CascadedShadow::Cascade* pCascades, uint32_t cascadeCount, uint32_t tileSize)
+{
+	memset(&m_Stats, 0, sizeof(m_Stats));
+	m_FrameDynamic = false;
+
+	auto count = (pCascades != nullptr) ? std::min(cascadeCount, CascadedShadow::MaxCascadeCount) : 0u;
+	auto reset = !m_Valid || count != m_CascadeCount || tileSize != m_TileSize;
+
+	for (auto i = 0u; i < count; ++i)
+	{
+		// ライトの向きやカメラ位置が変わるとテクセルの対応が変わるので, 全体を描き直します.
+		// 提出されなかったフレームの描き直す範囲は残します.
+		if (reset || memcmp(&m_ViewProj[i], &pCascades[i].ViewProj, sizeof(XMFLOAT4X4)) != 0)
+		{
+			m_Dirty[i] = AllRegions;
+			m_Stats.InvalidCascades++;
+		}
+		m_ViewProj[i] = pCascades[i].ViewProj;
+	}
+
+	m_CascadeCount = count;
+	m_TileSize     = tileSize;
+	m_Valid        = true;
+}
+
+//-----------------------------------------------------------------------------
+//      遮蔽物の現在の状態を設定します.
+//-----------------------------------------------------------------------------
+void ShadowCache::UpdateCaster
+(
+	uint32_t            index,
+	const XMFLOAT4X4&   world,
+	const XMFLOAT3&     center,
+	const XMFLOAT3&     extent
+)
+{
+	if (index >= m_Casters.size())
+	{
+		// 追加された遮蔽物は静的としてキャッシュに描画します.
+		Caster caster;
+		caster.World       = world;
+		caster.Center      = center;
+		caster.Extent      = extent;
+		caster.StillFrames = 0;
+		caster.Static      = true;
+		m_Casters.resize(index + 1, caster);
+
+		MarkDirty(center, extent);
+		return;
+	}
+
+	auto& caster = m_Casters[index];
+	auto  moved  = memcmp(&caster.World,  &world,  sizeof(world))  != 0
+	            || memcmp(&caster.Center, &center, sizeof(center)) != 0
+	            || memcmp(&caster.Extent, &extent, sizeof(extent)) != 0;
+
+	if (moved)
+	{
+		// 動き始めた遮蔽物はキャッシュから取り除き, 毎フレーム重ねて描画します.
+		if (caster.Static)
+		{ MarkDirty(caster.Center, caster.Extent); }
+
+		caster.World       = world;
+		caster.Center      = center;
+		caster.Extent      = extent;
+		caster.StillFrames = 0;
+		caster.Static      = false;
+	}
+	else if (!caster.Static)
+	{
+		// しばらく動かなければキャッシュに戻します.
+		caster.StillFrames++;
+		if (caster.StillFrames >= m_SettleFrames)
+		{
+			caster.Static = true;
+			MarkDirty(caster.Center, caster.Extent);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      遮蔽物の更新を終了します.
+//-----------------------------------------------------------------------------
+void ShadowCache::EndUpdate(uint32_t casterCount)
+{
+	// 削除された遮蔽物の範囲を描き直します.
+	for (auto i = size_t(casterCount); i < m_Casters.size(); ++i)
+	{
+		if (m_Casters[i].Static)
+		{ MarkDirty(m_Casters[i].Center, m_Casters[i].Extent); }
+	}
+	if (m_Casters.size() > casterCount)
+	{ m_Casters.resize(casterCount); }
+
+	for (const auto& caster : m_Casters)
+	{
+		if (caster.Static)
+		{ m_Stats.StaticCasters++; }
+		else
+		{ m_Stats.DynamicCasters++; }
+	}
+
+	// 1つの矩形で描き直すので, 矩形に含まれる領域は全て描き直します.
+	for (auto i = 0u; i < m_CascadeCount; ++i)
+	{
+		auto& rect = m_DirtyRect[i];
+		memset(&rect, 0, sizeof(rect));
+
+		auto mask = m_Dirty[i];
+		if (mask == 0)
+		{ continue; }
+
+		auto col0 = RegionCount - 1, col1 = 0u;
+		auto row0 = RegionCount - 1, row1 = 0u;
+		for (auto bit = 0u; bit < RegionCount * RegionCount; ++bit)
+		{
+			if ((mask & (uint64_t(1) << bit)) == 0)
+			{ continue; }
+
+			auto col = bit % RegionCount;
+			auto row = bit / RegionCount;
+			col0 = std::min(col0, col);
+			col1 = std::max(col1, col);
+			row0 = std::min(row0, row);
+			row1 = std::max(row1, row);
+		}
+
+		m_Dirty[i]  = RectMask(col0, col1, row0, row1);
+		rect.Left   = uint32_t(uint64_t(col0)     * m_TileSize / RegionCount);
+		rect.Top    = uint32_t(uint64_t(row0)     * m_TileSize / RegionCount);
+		rect.Right  = uint32_t(uint64_t(col1 + 1) * m_TileSize / RegionCount);
+		rect.Bottom = uint32_t(uint64_t(row1 + 1) * m_TileSize / RegionCount);
+
+		m_Stats.DirtyRegions += CountBits(m_Dirty[i]);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      カスケードの描画リストを作成します.
+//-----------------------------------------------------------------------------
+void ShadowCache::BuildDrawList
+(
+	uint32_t                        cascade,
+	const std::vector<uint32_t>&    visible,
+	std::vector<uint32_t>&          staticDraws,
+	std::vector<uint32_t>&          dynamicDraws
+)
+{
+	staticDraws .clear();
+	dynamicDraws.clear();
+
+	if (cascade >= m_CascadeCount)
+	{ return; }
+
+	auto dirty = m_Dirty[cascade];
+	for (auto index : visible)
+	{
+		// 遮蔽物として登録されていないものは描画しません.
+		if (index >= m_Casters.size())
+		{ continue; }
+
+		m_Stats.UncachedDraws++;
+
+		const auto& caster = m_Casters[index];
+		if (!caster.Static)
+		{
+			dynamicDraws.push_back(index);
+		}
+		else if (dirty == AllRegions
+			 || (dirty != 0 && (CalcRegionMask(m_ViewProj[cascade], caster.Center, caster.Extent) & dirty) != 0))
+		{
+			staticDraws.push_back(index);
+		}
+	}
+
+	m_Stats.StaticDraws  += uint32_t(staticDraws .size());
+	m_Stats.DynamicDraws += uint32_t(dynamicDraws.size());
+	m_FrameDynamic = m_FrameDynamic || !dynamicDraws.empty();
+}
+
+//-----------------------------------------------------------------------------
+//      フレームの描画結果を確定します.
+//-----------------------------------------------------------------------------
+void ShadowCache::CommitFrame()
+{
+	for (auto i = 0u; i < m_CascadeCount; ++i)
+	{
+		m_Dirty[i] = 0;
+		memset(&m_DirtyRect[i], 0, sizeof(m_DirtyRect[i]));
+	}
+	m_AtlasDynamic = m_FrameDynamic;
+}
+
+//-----------------------------------------------------------------------------
+//      キャッシュをアトラスへ複製する必要があるかどうかを判定します.
+//-----------------------------------------------------------------------------
+bool ShadowCache::NeedsCopy() const
+{
+	// 前のフレームの動的な遮蔽物が残っていれば, キャッシュで上書きして消します.
+	if (m_AtlasDynamic)
+	{ return true; }
+
+	for (auto i = 0u; i < m_CascadeCount; ++i)
+	{
+		if (m_Dirty[i] != 0)
+		{ return true; }
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+//      描き直すタイル内の範囲を取得します.
+//-----------------------------------------------------------------------------
+const ShadowCache::Rect& ShadowCache::GetDirtyRect(uint32_t cascade) const
+{
+	static const Rect empty = {};
+	return (cascade < m_CascadeCount) ? m_DirtyRect[cascade] : empty;
+}
+
+//-----------------------------------------------------------------------------
+//      描き直す領域を取得します.
+//-----------------------------------------------------------------------------
+uint64_t ShadowCache::GetDirtyMask(uint32_t cascade) const
+{
+	return (cascade < m_CascadeCount) ? m_Dirty[cascade] : 0;
+}
+
+//-----------------------------------------------------------------------------
+//      遮蔽物が静的かどうかを取得します.
+//-----------------------------------------------------------------------------
+bool ShadowCache::IsStatic(uint32_t index) const
+{
+	return (index < m_Casters.size()) && m_Casters[index].Static;
+}
+
+//-----------------------------------------------------------------------------
+//      現在のフレームの統計を取得します.
+//-----------------------------------------------------------------------------
+const ShadowCache::Stats& ShadowCache::GetStats() const
+{
+	return m_Stats;
+}
+
+//-----------------------------------------------------------------------------
+//      ワールド空間のAABBが掛かる領域を求めます.
+//-----------------------------------------------------------------------------
+uint64_t ShadowCache::CalcRegionMask(const XMFLOAT4X4& viewProj, const XMFLOAT3& center, const XMFLOAT3& extent)
+{
+	auto m = XMLoadFloat4x4(&viewProj);
+
+	auto minX =  FLT_MAX, minY =  FLT_MAX;
+	auto maxX = -FLT_MAX, maxY = -FLT_MAX;
+	for (auto i = 0; i < 8; ++i)
+	{
+		auto corner = XMVectorSet(
+			center.x + ((i & 1) ? extent.x : -extent.x),
+			center.y + ((i & 2) ? extent.y : -extent.y),
+			center.z + ((i & 4) ? extent.z : -extent.z),
+			1.0f);
+		auto p = XMVector3TransformCoord(corner, m);
+		minX = std::min(minX, XMVectorGetX(p));
+		maxX = std::max(maxX, XMVectorGetX(p));
+		minY = std::min(minY, XMVectorGetY(p));
+		maxY = std::max(maxY, XMVectorGetY(p));
+	}
+
+	if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f)
+	{ return 0; }
+
+	// 正規化デバイス座標の y は上向きで, 領域の行は下向きです.
+	return RectMask(ToRegion(minX), ToRegion(maxX), ToRegion(-maxY), ToRegion(-minY));
+}
+
+//-----------------------------------------------------------------------------
+//      ワールド空間のAABBが掛かる領域を描き直します.
+//-----------------------------------------------------------------------------
+void ShadowCache::MarkDirty(const XMFLOAT3& center, const XMFLOAT3& extent)
+{
+	for (auto i = 0u; i < m_CascadeCount; ++i)
+	{
+		if (m_Dirty[i] != AllRegions)
+		{ m_Dirty[i] |= CalcRegionMask(m_ViewProj[i], center, extent); }
+	}
+}
@@ -19,10 +19,13 @@ bool ShadowMap::Init(ComPtr<ID3D12Device> pDevice, DescriptorPool* pool, DXGI_FO
 bool ShadowMap::CreateRootSig(ComPtr<ID3D12Device> pDevice) {
 	RootSignature::Desc desc;
 	
-	desc.Begin(3)
+	desc.Begin(6)
 		.SetCBV(ShaderStage::VS, 0, 0)	//CbTransform
 		.SetCBV(ShaderStage::VS, 1, 1)	//CbMesh
-		.SetCBV(ShaderStage::VS, 2, 2)  //CbShadow
+		.SetCBV(ShaderStage::VS, 2, 2)	//CbLight
+		.SetSRV(ShaderStage::VS, 3, 11)	//Instances
+		.SetConstants(ShaderStage::VS, 4, 6, 1)	//InstanceOffset
+		.SetConstants(ShaderStage::VS, 5, 7, 1)	//CascadeIndex
 		.AllowIL()
 		.End();
 
@@ -44,7 +47,7 @@ bool ShadowMap::CreatePipeLineState(ComPtr<ID3D12Device> pDevice, DXGI_FORMAT rt
 		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 	};
 
-	// OtBbNXpCvCXe[gݒ.
+	// グラフィックスパイプラインステートを設定.
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
 	desc.InputLayout                        = { elements, _countof(elements) };
 	desc.pRootSignature                     = m_RootSig.GetPtr();
@@ -59,18 +62,28 @@ bool ShadowMap::CreatePipeLineState(ComPtr<ID3D12Device> pDevice, DXGI_FORMAT rt
 	desc.SampleDesc.Count                   = 1;
 	desc.SampleDesc.Quality                 = 0;
 
-	//XeV𖳌
+	//ステンシルを無効に
 	desc.DepthStencilState.StencilEnable	= FALSE;
 
 
-	// pCvCXe[g𐶐.
+	// パイプラインステートを生成.
 	if (!CreateGraphicsPipelineState(pDevice, desc, m_pPSO))return false;
 
+	// インスタンス描画用は頂点シェーダのみ差し替える.
+	ComPtr<ID3DBlob>	pInstancedVSBlob;
+	if (!SearchAndLoadShader(m_InstancedVSPath, pInstancedVSBlob)) return false;
+
+	desc.VS = { pInstancedVSBlob->GetBufferPointer(), pInstancedVSBlob->GetBufferSize() };
+	if (!CreateGraphicsPipelineState(pDevice, desc, m_pInstancedPSO))return false;
+
 	return true;
 }
 
 void ShadowMap::Term()
 {
+	m_pInstancedPSO.Reset();
+	m_Batches.clear();
+
 	for (auto i = 0; i < App::FrameCount; ++i)
 	{
 		m_CB[i].Term();
@@ -86,38 +99,175 @@ void ShadowMap::DrawShadowMap(
 )
 {
 	
-	DirectX::TransitionResource(pCmd,
-		s.DepthDest.GetResource(),
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		D3D12_RESOURCE_STATE_DEPTH_WRITE
-	);
-
-	// fBXNv^擾.
+	// ディスクリプタ取得.
 	auto handleDSV = s.DepthDest.GetHandleDSV();
 
-	// _[^[Qbgݒ.
+	SetPipeline(pCmd, frameindex, s);
+
+	auto count = (s.CascadeCount < CascadedShadow::MaxCascadeCount) ? s.CascadeCount : CascadedShadow::MaxCascadeCount;
+
+	// レンダーターゲットを設定.
 	pCmd->OMSetRenderTargets(0, nullptr, FALSE, &handleDSV->HandleCPU);
 
-	// _[^[QbgNA.
-	s.DepthDest.ClearView(pCmd);
+	// キャッシュを使う場合はアトラスへ複製済みなので, その上に動的な遮蔽物を重ねる.
+	if (s.pStaticDest == nullptr) {
+		s.DepthDest.ClearView(pCmd);
+	}
+
+	// カスケードごとにアトラスのタイルへ描画.
+	for (auto cascade = 0u; cascade < count; ++cascade) {
+		SetTile(pCmd, cascade, s.TileSize, nullptr);
+		pCmd->SetGraphicsRoot32BitConstant(5, cascade, 0);
+
+		DrawObjects(pCmd, frameindex, s.pCascadeObjects[cascade], s.pInstances);
+	}
+}
+
+void ShadowMap::DrawStaticShadowMap(
+	ID3D12GraphicsCommandList*	pCmd,
+	int							frameindex,
+	DrawSource&					s
+)
+{
+	if (s.pStaticDest == nullptr || s.pStaticObjects == nullptr || s.pDirtyRects == nullptr) return;
+
+	SetPipeline(pCmd, frameindex, s);
+
+	auto count = (s.CascadeCount < CascadedShadow::MaxCascadeCount) ? s.CascadeCount : CascadedShadow::MaxCascadeCount;
+
+	// 静的な遮蔽物はキャッシュの描き直す範囲だけをクリアして描画.
+	auto handleStatic = s.pStaticDest->GetHandleDSV();
+	pCmd->OMSetRenderTargets(0, nullptr, FALSE, &handleStatic->HandleCPU);
+
+	for (auto cascade = 0u; cascade < count; ++cascade) {
+		const auto& dirty = s.pDirtyRects[cascade];
+		if (dirty.Left >= dirty.Right || dirty.Top >= dirty.Bottom) continue;
+
+		uint32_t tileX, tileY;
+		CascadedShadow::GetTile(cascade, tileX, tileY);
+
+		D3D12_RECT rect = {};
+		rect.left   = LONG(tileX * s.TileSize + dirty.Left);
+		rect.top    = LONG(tileY * s.TileSize + dirty.Top);
+		rect.right  = LONG(tileX * s.TileSize + dirty.Right);
+		rect.bottom = LONG(tileY * s.TileSize + dirty.Bottom);
+
+		pCmd->ClearDepthStencilView(handleStatic->HandleCPU, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 1, &rect);
+		SetTile(pCmd, cascade, s.TileSize, &rect);
+		pCmd->SetGraphicsRoot32BitConstant(5, cascade, 0);
+
+		DrawObjects(pCmd, frameindex, s.pStaticObjects[cascade], s.pInstances);
+	}
+}
+
+void ShadowMap::CopyStaticShadowMap(
+	ID3D12GraphicsCommandList*	pCmd,
+	DrawSource&					s
+)
+{
+	if (s.pStaticDest == nullptr) return;
 
+	// 深度ステンシルは部分領域を複製できないので, 描き直したタイルだけでなくアトラス全体を複製する.
+	pCmd->CopyResource(s.DepthDest.GetResource(), s.pStaticDest->GetResource());
+}
+
+void ShadowMap::SetPipeline(
+	ID3D12GraphicsCommandList*	pCmd,
+	int							frameindex,
+	DrawSource&					s
+)
+{
 	pCmd->SetGraphicsRootSignature(m_RootSig.GetPtr());
 	pCmd->SetPipelineState(m_pPSO.Get());
 
 	pCmd->SetGraphicsRootDescriptorTable(0, s.Commonbufmanager.m_TransformCB[frameindex].GetHandleGPU());
 	pCmd->SetGraphicsRootDescriptorTable(2, s.Commonbufmanager.m_LightCB[frameindex].GetHandleGPU());
-	// V[̕`.
-	
-	for (size_t i = 0; i < s.GameObjects.size(); i++) {
-		GameObject* g = s.GameObjects[i];
-		pCmd->SetGraphicsRootDescriptorTable(1, g->m_Model.m_MeshCB[frameindex].GetHandleGPU());
-		g->m_Model.DrawModelRaw(pCmd, frameindex);
+	if (s.pInstances != nullptr && m_pInstancedPSO != nullptr) {
+		pCmd->SetGraphicsRootDescriptorTable(3, s.pInstances->GetHandleGPU());
 	}
+}
+
+void ShadowMap::SetTile(
+	ID3D12GraphicsCommandList*	pCmd,
+	uint32_t					cascade,
+	uint32_t					tileSize,
+	const D3D12_RECT*			pScissor
+)
+{
+	uint32_t tileX, tileY;
+	CascadedShadow::GetTile(cascade, tileX, tileY);
 
-	DirectX::TransitionResource(pCmd,
-		s.DepthDest.GetResource(),
-		D3D12_RESOURCE_STATE_DEPTH_WRITE,
-		D3D12_RESOURCE_STATE_GENERIC_READ
-	);
+	D3D12_VIEWPORT viewport = {};
+	viewport.TopLeftX = float(tileX * tileSize);
+	viewport.TopLeftY = float(tileY * tileSize);
+	viewport.Width    = float(tileSize);
+	viewport.Height   = float(tileSize);
+	viewport.MinDepth = 0.0f;
+	viewport.MaxDepth = 1.0f;
 
+	// シザーを指定しない場合はタイル全体.
+	D3D12_RECT scissor = {};
+	scissor.left   = LONG(tileX * tileSize);
+	scissor.top    = LONG(tileY * tileSize);
+	scissor.right  = LONG((tileX + 1) * tileSize);
+	scissor.bottom = LONG((tileY + 1) * tileSize);
+
+	pCmd->RSSetViewports(1, &viewport);
+	pCmd->RSSetScissorRects(1, (pScissor != nullptr) ? pScissor : &scissor);
+}
+
+void ShadowMap::DrawObjects(
+	ID3D12GraphicsCommandList*			pCmd,
+	int									frameindex,
+	const std::vector<GameObject*>&		objects,
+	InstanceBuffer*						pInstances
+)
+{
+	// シーンの描画.
+	if (pInstances != nullptr && m_pInstancedPSO != nullptr) {
+
+		// 同じモデルのオブジェクトを1回のインスタンス描画にまとめる.
+		for (auto& batch : m_Batches) batch.second.clear();
+		for (size_t i = 0; i < objects.size(); i++) {
+			GameObject* g = objects[i];
+			m_Batches[g->m_Model.m_ModelPath].push_back(g);
+		}
+
+		pCmd->SetPipelineState(m_pInstancedPSO.Get());
+
+		for (auto& batch : m_Batches) {
+			auto& batchObjects = batch.second;
+			if (batchObjects.empty()) continue;
+
+			uint32_t first = 0;
+			auto pData = pInstances->Alloc(uint32_t(batchObjects.size()), &first);
+			if (pData == nullptr) {
+				// バッファが足りない場合はオブジェクトごとに描画する.
+				pCmd->SetPipelineState(m_pPSO.Get());
+				for (auto g : batchObjects) {
+					pCmd->SetGraphicsRootDescriptorTable(1, g->m_Model.m_MeshCB[frameindex].GetHandleGPU());
+					g->m_Model.DrawModelRaw(pCmd, frameindex);
+				}
+				pCmd->SetPipelineState(m_pInstancedPSO.Get());
+				continue;
+			}
+
+			for (auto g : batchObjects) {
+				pData->World         = g->Transform().GetTransform();
+				pData->MaterialIndex = 0;
+				pData++;
+			}
+
+			pCmd->SetGraphicsRoot32BitConstant(4, first, 0);
+			batchObjects[0]->m_Model.DrawModelInstanced(pCmd, uint32_t(batchObjects.size()));
+		}
+	}
+	else {
+		pCmd->SetPipelineState(m_pPSO.Get());
+		for (size_t i = 0; i < objects.size(); i++) {
+			GameObject* g = objects[i];
+			pCmd->SetGraphicsRootDescriptorTable(1, g->m_Model.m_MeshCB[frameindex].GetHandleGPU());
+			g->m_Model.DrawModelRaw(pCmd, frameindex);
+		}
+	}
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 //-----------------------------------------------------------------------------
 #include <SkyBox.h>
 #include <Logger.h>
+#include <PipelineCache.h>
 #include <CommonStates.h>
 
 //-----------------------------------------------------------------------------
@@ -43,7 +44,6 @@ namespace {
 //-----------------------------------------------------------------------------
 SkyBox::SkyBox()
 	: m_pPoolRes(nullptr)
-	, m_Index(0)
 { /* DO_NOTHING */
 }
 
@@ -144,14 +144,9 @@ bool SkyBox::Init
 			return false;
 		}
 
-		hr = pDevice->CreateRootSignature(
-			0,
-			pBlob->GetBufferPointer(),
-			pBlob->GetBufferSize(),
-			IID_PPV_ARGS(m_pRootSig.GetAddressOf()));
-		if (FAILED(hr))
+		if (!PipelineCache::GetInstance().GetRootSignature(pDevice, pBlob->GetBufferPointer(), pBlob->GetBufferSize(), m_pRootSig))
 		{
-			ELOG("Error : ID3D12Device::CreateRootSignature() Failed. retcode = 0x%x", hr);
+			ELOG("Error : PipelineCache::GetRootSignature() Failed.");
 			return false;
 		}
 	}
@@ -179,11 +174,9 @@ bool SkyBox::Init
 		desc.SampleDesc.Quality = 0;
 		desc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
 
-		auto hr = pDevice->CreateGraphicsPipelineState(
-			&desc, IID_PPV_ARGS(m_pPSO.GetAddressOf()));
-		if (FAILED(hr))
+		if (!PipelineCache::GetInstance().GetGraphicsPipeline(pDevice, desc, m_pPSO))
 		{
-			ELOG("Error : ID3D12Device::CreateGraphicsPipelineState() Failed. retcode = 0x%x", hr);
+			ELOG("Error : PipelineCache::GetGraphicsPipeline() Failed.");
 			return false;
 		}
 	}
@@ -251,7 +244,7 @@ bool SkyBox::Init
 
 	// 定数バッファの生成.
 	{
-		for (auto i = 0; i < 2; ++i)
+		for (auto i = 0u; i < App::FrameCount; ++i)
 		{
 			if (!m_CB[i].Init(pDevice, m_pPoolRes, sizeof(CbSkyBox)))
 			{
@@ -261,8 +254,6 @@ bool SkyBox::Init
 		}
 	}
 
-	m_Index = 0;
-
 	return true;
 }
 
@@ -271,7 +262,7 @@ bool SkyBox::Init
 //-----------------------------------------------------------------------------
 void SkyBox::Term()
 {
-	for (auto i = 0; i < 2; ++i)
+	for (auto i = 0u; i < App::FrameCount; ++i)
 	{
 		m_CB[i].Term();
 	}
@@ -294,6 +285,7 @@ void SkyBox::Term()
 void SkyBox::Draw
 (
 	ID3D12GraphicsCommandList* pCmd,
+	uint32_t                    frameIndex,
 	D3D12_GPU_DESCRIPTOR_HANDLE handleCubeMap,
 	const Matrix& viewMatrix,
 	const Matrix& projMatrix,
@@ -302,7 +294,7 @@ void SkyBox::Draw
 {
 	// 定数バッファの更新.
 	{
-		auto ptr = m_CB[m_Index].GetPtr<CbSkyBox>();
+		auto ptr = m_CB[frameIndex].GetPtr<CbSkyBox>();
 		auto pos = Vector3(viewMatrix._41, viewMatrix._42, viewMatrix._43);
 		ptr->World = Matrix::CreateScale(boxSize) * Matrix::CreateTranslation(pos);
 		ptr->View = viewMatrix;
@@ -313,14 +305,11 @@ void SkyBox::Draw
 
 	// 描画コマンド作成.
 	pCmd->SetGraphicsRootSignature(m_pRootSig.Get());
-	pCmd->SetGraphicsRootDescriptorTable(0, m_CB[m_Index].GetHandleGPU());
+	pCmd->SetGraphicsRootDescriptorTable(0, m_CB[frameIndex].GetHandleGPU());
 	pCmd->SetGraphicsRootDescriptorTable(1, handleCubeMap);
 	pCmd->SetPipelineState(m_pPSO.Get());
 	pCmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 	pCmd->IASetIndexBuffer(nullptr);
 	pCmd->IASetVertexBuffers(0, 1, &vbv);
 	pCmd->DrawInstanced(36, 1, 0, 0);
-
-	// バッファ入れ替え.
-	m_Index = (m_Index + 1) % 2;
 }
\ No newline at end of file
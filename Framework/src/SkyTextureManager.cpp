@@ -5,12 +5,45 @@
 #include "CommonStates.h"
 #include "DirectXHelpers.h"
 #include "SimpleMath.h"
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      ベイク結果のテクスチャの構成を求めます.
+//-----------------------------------------------------------------------------
+IBLCache::Texture MakeLayout(DXGI_FORMAT format, uint32_t size, uint32_t arraySize, uint32_t mipLevels)
+{
+	IBLCache::Texture layout;
+	layout.Format    = IBLCache::FORMAT(format);
+	layout.Width     = size;
+	layout.Height    = size;
+	layout.ArraySize = arraySize;
+	layout.MipLevels = mipLevels;
+	layout.Cube      = (arraySize == 6);
+	return layout;
+}
+
+IBLCache::Texture GetDFGLayout()
+{ return MakeLayout(DXGI_FORMAT_R32G32_FLOAT, IBLBaker::DFGTextureSize, 1, 1); }
+
+IBLCache::Texture GetDiffuseLDLayout()
+{ return MakeLayout(DXGI_FORMAT_R32G32B32A32_FLOAT, IBLBaker::LDTextureSize, 6, 1); }
+
+IBLCache::Texture GetSpecularLDLayout()
+{ return MakeLayout(DXGI_FORMAT_R32G32B32A32_FLOAT, IBLBaker::LDTextureSize, 6, IBLBaker::MipCount); }
+
+} // namespace
 
 bool SkyManager::Init(ComPtr<ID3D12Device> pDevice, DescriptorPool* rtvPool, DescriptorPool* resPool, ComPtr<ID3D12CommandQueue> commandQueue, std::wstring path) {
 	if (!InitSphereMapTexture(pDevice, resPool, commandQueue, path)) return false;
 	if (!InitSphereMapConverter(pDevice, rtvPool, resPool)) return false;
 	if (!InitSkyBox(pDevice, resPool)) return false;
 
+	// 他の初期化と並行してキャッシュを読み込む.
+	StartCacheLoad();
+
 	return true;
 }
 
@@ -22,10 +55,10 @@ bool SkyManager::InitSphereMapTexture(ComPtr<ID3D12Device> pDevice, DescriptorPo
 
 	DirectX::ResourceUploadBatch batch(pDevice.Get());
 
-	// ob`Jn.
+	// バッチ開始.
 	batch.Begin();
 	
-	// XtBA}bvǂݍ.
+	// スフィアマップ読み込み.
 	{
 		std::wstring sphereMapPath;
 		if (!SearchFilePathW(path.c_str(), sphereMapPath))
@@ -35,8 +68,9 @@ bool SkyManager::InitSphereMapTexture(ComPtr<ID3D12Device> pDevice, DescriptorPo
 		}
 
 		m_SkyTexturePath = path;
+		m_SkyTextureFullPath = sphereMapPath;
 
-		// eNX`.
+		// テクスチャ初期化.
 		if (!m_SphereMap.Init(
 			pDevice.Get(),
 			resPool,
@@ -48,10 +82,10 @@ bool SkyManager::InitSphereMapTexture(ComPtr<ID3D12Device> pDevice, DescriptorPo
 		}
 	}
 
-	// ob`I.
+	// バッチ終了.
 	auto future = batch.End(commandQueue.Get());
 
-	// ҋ@.
+	// 完了を待機.
 	future.wait();
 
 	return true;
@@ -83,15 +117,26 @@ bool SkyManager::InitSkyBox(ComPtr<ID3D12Device> pDevice, DescriptorPool* resPoo
 	return true;
 }
 
-// 
+// 引数が多すぎる
 bool SkyManager::IBLBake(ComPtr<ID3D12Device> pDevice, DescriptorPool* rtvPool, DescriptorPool* resPool, CommandList& commandList, ComPtr<ID3D12CommandQueue> commandQueue, Fence& fence) {
+	auto t0 = std::chrono::high_resolution_clock::now();
+
 	if (!m_IBLBaker.Init(pDevice.Get(), resPool, rtvPool))
 	{
 		ELOG("Error : IBLBaker::Init() Failed.");
 		return false;
 	}
 
-	// R}hXg̋L^Jn.
+	// キャッシュの読み込みを待つ.
+	if (m_LoadTask.valid())
+	{
+		m_LoadTask.get();
+	}
+
+	auto bakeDFG = !m_CacheStats.DFGHit;
+	auto bakeLD  = !m_CacheStats.LDHit;
+
+	// コマンドリストの記録を開始.
 	auto pCmd = commandList.Reset();
 
 	ID3D12DescriptorHeap* const pHeaps[] = {
@@ -100,33 +145,625 @@ bool SkyManager::IBLBake(ComPtr<ID3D12Device> pDevice, DescriptorPool* rtvPool,
 
 	pCmd->SetDescriptorHeaps(1, pHeaps);
 
-	// L[u}bvɕϊ.
+	// キューブマップに変換. スカイボックスで使うのでキャッシュの有無に依らず描画する.
 	m_SphereMapConverter.DrawToCube(pCmd, m_SphereMap.GetHandleGPU());
 
 	auto desc = m_SphereMapConverter.GetCubeMapDesc();
 	auto handle = m_SphereMapConverter.GetCubeMapHandleGPU();
 
-	// DFGϕ.
-	m_IBLBaker.IntegrateDFG(pCmd);
+	// DFG項を積分.
+	if (bakeDFG)
+	{
+		m_IBLBaker.IntegrateDFG(pCmd);
+	}
 
-	// LDϕ.
-	m_IBLBaker.IntegrateLD(pCmd, uint32_t(desc.Width), desc.MipLevels, handle);
+	// LD項を積分.
+	if (bakeLD)
+	{
+		m_IBLBaker.IntegrateLD(pCmd, uint32_t(desc.Width), desc.MipLevels, handle);
+	}
 
-	// R}hXg̋L^I.
+	// コマンドリストの記録を終了.
 	pCmd->Close();
 
-	// R}hXgs.
+	// コマンドリストを実行.
 	ID3D12CommandList* pLists[] = { pCmd };
 	commandQueue->ExecuteCommandLists(1, pLists);
 
-	// ҋ@.
+	// 完了を待機.
 	fence.Sync(commandQueue.Get());
 
+	// キャッシュから読み込んだテクスチャを転送.
+	if (!UploadCache(pDevice.Get(), commandQueue.Get()))
+	{
+		ELOG("Error : SkyManager::UploadCache() Failed.");
+		return false;
+	}
+
+	// ディフューズIBL用の球面調和関数を求める. 失敗した場合は DiffuseLD テクスチャを使う.
+	if (!ProjectIrradiance(pDevice.Get(), commandList, commandQueue.Get(), fence))
+	{
+		ELOG("Warning : SkyManager::ProjectIrradiance() Failed.");
+	}
+
+	// ベイクした結果を次回の起動に備えて保存. 失敗しても描画には影響しない.
+	if (bakeDFG || bakeLD)
+	{
+		if (!SaveCache(pDevice.Get(), commandList, commandQueue.Get(), fence, bakeDFG, bakeLD))
+		{
+			ELOG("Warning : SkyManager::SaveCache() Failed.");
+		}
+	}
+
+	auto t1 = std::chrono::high_resolution_clock::now();
+	m_CacheStats.BakeMilliSec = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      キャッシュの読み込みを開始します.
+//-----------------------------------------------------------------------------
+void SkyManager::StartCacheLoad()
+{
+	auto cubeDesc = m_SphereMapConverter.GetCubeMapDesc();
+
+	m_CacheKey = {};
+	m_CacheKey.ShaderHash   = IBLBaker::GetShaderHash();
+	m_CacheKey.CubeSize     = uint32_t(cubeDesc.Width);
+	m_CacheKey.CubeMipCount = cubeDesc.MipLevels;
+	m_CacheKey.DFGSize      = IBLBaker::DFGTextureSize;
+	m_CacheKey.DFGSamples   = IBLBaker::DFGSampleCount;
+	m_CacheKey.LDSize       = IBLBaker::LDTextureSize;
+	m_CacheKey.LDMipCount   = IBLBaker::MipCount;
+	m_CacheKey.LDSamples    = IBLBaker::LDSampleCount;
+
+	m_CacheStats = {};
+
+	// デバイスを使わない処理だけなので, 別スレッドで行う.
+	m_LoadTask = std::async(std::launch::async, [this]() {
+		auto t0 = std::chrono::high_resolution_clock::now();
+
+		auto dfgHash = IBLCache::HashDFG(m_CacheKey);
+		m_CacheStats.DFGHit = IBLCache::Load(IBLCache::MakePath(m_CacheDir, L"DFG", dfgHash), dfgHash, GetDFGLayout(), m_CachedDFG);
+
+		if (IBLCache::HashFile(m_SkyTextureFullPath, m_CacheKey.SourceHash))
+		{
+			auto ldHash = IBLCache::HashLD(m_CacheKey);
+			m_CacheStats.LDHit =
+				IBLCache::Load(IBLCache::MakePath(m_CacheDir, L"DiffuseLD", ldHash), ldHash, GetDiffuseLDLayout(), m_CachedDiffuseLD) &&
+				IBLCache::Load(IBLCache::MakePath(m_CacheDir, L"SpecularLD", ldHash), ldHash, GetSpecularLDLayout(), m_CachedSpecularLD);
+		}
+
+		if (!m_CacheStats.LDHit)
+		{
+			m_CachedDiffuseLD  = IBLCache::Texture();
+			m_CachedSpecularLD = IBLCache::Texture();
+		}
+
+		auto t1 = std::chrono::high_resolution_clock::now();
+		m_CacheStats.PrepareMilliSec = std::chrono::duration<double, std::milli>(t1 - t0).count();
+	});
+}
+
+//-----------------------------------------------------------------------------
+//      キャッシュから読み込んだテクスチャを転送します.
+//-----------------------------------------------------------------------------
+bool SkyManager::UploadCache(ID3D12Device* pDevice, ID3D12CommandQueue* pQueue)
+{
+	struct Target
+	{
+		IBLCache::Texture*  pTexture;
+		ID3D12Resource*     pResource;
+	};
+
+	Target targets[] = {
+		{ &m_CachedDFG,        m_CacheStats.DFGHit ? m_IBLBaker.GetTextureDFG()        : nullptr },
+		{ &m_CachedDiffuseLD,  m_CacheStats.LDHit  ? m_IBLBaker.GetTextureDiffuseLD()  : nullptr },
+		{ &m_CachedSpecularLD, m_CacheStats.LDHit  ? m_IBLBaker.GetTextureSpecularLD() : nullptr },
+	};
+
+	if (!m_CacheStats.DFGHit && !m_CacheStats.LDHit)
+	{
+		return true;
+	}
+
+	DirectX::ResourceUploadBatch batch(pDevice);
+	batch.Begin();
+
+	for (auto& target : targets)
+	{
+		if (target.pResource == nullptr)
+		{
+			continue;
+		}
+
+		const auto& texture = *target.pTexture;
+		auto pixelSize = IBLCache::GetPixelSize(texture.Format);
+
+		// 配列番号・ミップレベルの順に詰めてあるので, サブリソース番号順に並ぶ.
+		std::vector<D3D12_SUBRESOURCE_DATA> subresources;
+		subresources.reserve(size_t(texture.ArraySize) * texture.MipLevels);
+
+		auto ptr = texture.Pixels.data();
+		for (auto i = 0u; i < texture.ArraySize; ++i)
+		{
+			for (auto m = 0u; m < texture.MipLevels; ++m)
+			{
+				auto w = (texture.Width  >> m) > 0 ? (texture.Width  >> m) : 1u;
+				auto h = (texture.Height >> m) > 0 ? (texture.Height >> m) : 1u;
+
+				D3D12_SUBRESOURCE_DATA data = {};
+				data.pData      = ptr;
+				data.RowPitch   = LONG_PTR(w * pixelSize);
+				data.SlicePitch = LONG_PTR(w * h * pixelSize);
+				subresources.push_back(data);
+
+				ptr += data.SlicePitch;
+			}
+		}
+
+		batch.Transition(target.pResource, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COPY_DEST);
+		batch.Upload(target.pResource, 0, subresources.data(), UINT(subresources.size()));
+		batch.Transition(target.pResource, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	}
+
+	auto future = batch.End(pQueue);
+	future.wait();
+
+	// 転送したので CPU 側のデータは不要.
+	m_CachedDFG        = IBLCache::Texture();
+	m_CachedDiffuseLD  = IBLCache::Texture();
+	m_CachedSpecularLD = IBLCache::Texture();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ベイクした結果をキャッシュに保存します.
+//-----------------------------------------------------------------------------
+bool SkyManager::SaveCache(ID3D12Device* pDevice, CommandList& commandList, ID3D12CommandQueue* pQueue, Fence& fence, bool saveDFG, bool saveLD)
+{
+	// 元テクスチャのハッシュ値が求まらなかった場合は LD 項を保存しない.
+	saveLD = saveLD && (m_CacheKey.SourceHash != 0);
+
+	struct SaveItem
+	{
+		std::wstring        Path;
+		uint64_t            Hash;
+		IBLCache::Texture   Texture;
+	};
+
+	std::vector<SaveItem>        items;
+	std::vector<ID3D12Resource*> resources;
+	if (saveDFG)
+	{
+		auto hash = IBLCache::HashDFG(m_CacheKey);
+		items.push_back({ IBLCache::MakePath(m_CacheDir, L"DFG", hash), hash, GetDFGLayout() });
+		resources.push_back(m_IBLBaker.GetTextureDFG());
+	}
+
+	if (saveLD)
+	{
+		auto hash = IBLCache::HashLD(m_CacheKey);
+		items.push_back({ IBLCache::MakePath(m_CacheDir, L"DiffuseLD",  hash), hash, GetDiffuseLDLayout() });
+		items.push_back({ IBLCache::MakePath(m_CacheDir, L"SpecularLD", hash), hash, GetSpecularLDLayout() });
+		resources.push_back(m_IBLBaker.GetTextureDiffuseLD());
+		resources.push_back(m_IBLBaker.GetTextureSpecularLD());
+	}
+
+	if (items.empty())
+	{
+		return true;
+	}
+
+	std::vector<IBLCache::Texture*> textures;
+	for (auto& item : items)
+	{
+		textures.push_back(&item.Texture);
+	}
+
+	if (!ReadbackTextures(pDevice, commandList, pQueue, fence, resources.data(), textures.data(), uint32_t(items.size())))
+	{
+		return false;
+	}
+
+	CreateDirectoryW(m_CacheDir.c_str(), nullptr);
+
+	// ファイルへの書き込みは描画を待たせないよう別スレッドで行う.
+	if (m_SaveTask.valid())
+	{
+		m_SaveTask.wait();
+	}
+
+	m_SaveTask = std::async(std::launch::async, [items = std::move(items)]() {
+		uint32_t saved = 0;
+		for (const auto& item : items)
+		{
+			if (IBLCache::Save(item.Path, item.Hash, item.Texture))
+			{
+				saved++;
+			}
+		}
+		return saved;
+	});
+
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+//      テクスチャを読み戻します.
+//-----------------------------------------------------------------------------
+bool SkyManager::ReadbackTextures(ID3D12Device* pDevice, CommandList& commandList, ID3D12CommandQueue* pQueue, Fence& fence, ID3D12Resource* const* ppResources, IBLCache::Texture* const* ppTextures, uint32_t count)
+{
+	// 各テクスチャの配列番号・ミップレベルごとにコピー先を割り当てる.
+	// テクスチャの MipLevels がリソースより少ない場合は, 先頭のミップレベルのみ読み戻す.
+	struct Region
+	{
+		uint32_t                            Texture;
+		UINT                                Subresource;
+		D3D12_PLACED_SUBRESOURCE_FOOTPRINT  Layout;
+		UINT                                Rows;
+		UINT64                              RowSize;
+	};
+
+	std::vector<Region> regions;
+	UINT64 totalSize = 0;
+
+	for (auto i = 0u; i < count; ++i)
+	{
+		auto desc = ppResources[i]->GetDesc();
+		const auto& texture = *ppTextures[i];
+
+		for (auto slice = 0u; slice < texture.ArraySize; ++slice)
+		{
+			for (auto mip = 0u; mip < texture.MipLevels; ++mip)
+			{
+				Region region = {};
+				region.Texture     = i;
+				region.Subresource = mip + slice * desc.MipLevels;
+
+				// コピー先のオフセットは配置境界に揃える.
+				totalSize = (totalSize + D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1) & ~UINT64(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1);
+
+				UINT64 size = 0;
+				pDevice->GetCopyableFootprints(&desc, region.Subresource, 1, totalSize, &region.Layout, &region.Rows, &region.RowSize, &size);
+				totalSize += size;
+
+				regions.push_back(region);
+			}
+		}
+	}
+
+	ComPtr<ID3D12Resource> pReadback;
+	{
+		D3D12_HEAP_PROPERTIES props = {};
+		props.Type = D3D12_HEAP_TYPE_READBACK;
+		props.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+		props.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+
+		D3D12_RESOURCE_DESC desc = {};
+		desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+		desc.Width = totalSize;
+		desc.Height = 1;
+		desc.DepthOrArraySize = 1;
+		desc.MipLevels = 1;
+		desc.Format = DXGI_FORMAT_UNKNOWN;
+		desc.SampleDesc.Count = 1;
+		desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+		auto hr = pDevice->CreateCommittedResource(
+			&props,
+			D3D12_HEAP_FLAG_NONE,
+			&desc,
+			D3D12_RESOURCE_STATE_COPY_DEST,
+			nullptr,
+			IID_PPV_ARGS(pReadback.GetAddressOf()));
+		if (FAILED(hr))
+		{
+			ELOG("Error : ID3D12Device::CreateCommittedResource() Failed. retcode = 0x%x", hr);
+			return false;
+		}
+	}
+
+	// 読み戻すテクスチャは全てピクセルシェーダリソースの状態.
+	auto pCmd = commandList.Reset();
+	for (auto i = 0u; i < count; ++i)
+	{
+		DirectX::TransitionResource(pCmd, ppResources[i], D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COPY_SOURCE);
+	}
+
+	for (const auto& region : regions)
+	{
+		D3D12_TEXTURE_COPY_LOCATION dst = {};
+		dst.pResource       = pReadback.Get();
+		dst.Type            = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+		dst.PlacedFootprint = region.Layout;
+
+		D3D12_TEXTURE_COPY_LOCATION src = {};
+		src.pResource        = ppResources[region.Texture];
+		src.Type             = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+		src.SubresourceIndex = region.Subresource;
+
+		pCmd->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+	}
+
+	for (auto i = 0u; i < count; ++i)
+	{
+		DirectX::TransitionResource(pCmd, ppResources[i], D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	}
+	pCmd->Close();
+
+	ID3D12CommandList* pLists[] = { pCmd };
+	pQueue->ExecuteCommandLists(1, pLists);
+	fence.Sync(pQueue);
+
+	// 行ごとのパディングを取り除いて, 配列番号・ミップレベルの順に詰める.
+	uint8_t* pMapped = nullptr;
+	D3D12_RANGE readRange = { 0, SIZE_T(totalSize) };
+	auto hr = pReadback->Map(0, &readRange, reinterpret_cast<void**>(&pMapped));
+	if (FAILED(hr))
+	{
+		ELOG("Error : ID3D12Resource::Map() Failed. retcode = 0x%x", hr);
+		return false;
+	}
+
+	std::vector<uint8_t*> dsts(count);
+	for (auto i = 0u; i < count; ++i)
+	{
+		ppTextures[i]->Pixels.resize(IBLCache::GetDataSize(*ppTextures[i]));
+		dsts[i] = ppTextures[i]->Pixels.data();
+	}
+
+	for (const auto& region : regions)
+	{
+		auto& dst = dsts[region.Texture];
+		for (auto y = 0u; y < region.Rows; ++y)
+		{
+			memcpy(dst, pMapped + region.Layout.Offset + size_t(y) * region.Layout.Footprint.RowPitch, size_t(region.RowSize));
+			dst += region.RowSize;
+		}
+	}
+
+	D3D12_RANGE writeRange = { 0, 0 };
+	pReadback->Unmap(0, &writeRange);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      環境マップを球面調和関数に射影します.
+//-----------------------------------------------------------------------------
+bool SkyManager::ProjectIrradiance(ID3D12Device* pDevice, CommandList& commandList, ID3D12CommandQueue* pQueue, Fence& fence)
+{
+	// スカイボックスやLD項と同じ向きになるよう, 変換済みのキューブマップの最上位ミップから射影する.
+	auto pCube = m_SphereMapConverter.GetCubeMap();
+	auto desc  = pCube->GetDesc();
+
+	auto cube = MakeLayout(desc.Format, uint32_t(desc.Width), 6, 1);
+	if (cube.Format != IBLCache::FORMAT_R32G32B32A32_FLOAT)
+	{
+		ELOG("Error : Unsupported Cube Map Format. format = %d", int(cube.Format));
+		return false;
+	}
+
+	auto pTexture = &cube;
+	if (!ReadbackTextures(pDevice, commandList, pQueue, fence, &pCube, &pTexture, 1))
+	{
+		return false;
+	}
+
+	auto t0 = std::chrono::high_resolution_clock::now();
+
+	SHProjector::ProjectCube(reinterpret_cast<const float*>(cube.Pixels.data()), cube.Width, 0, m_IrradianceSH);
+	SHProjector::ConvolveLambert(m_IrradianceSH);
+
+	auto t1 = std::chrono::high_resolution_clock::now();
+	m_IrradianceMilliSec = std::chrono::duration<double, std::milli>(t1 - t0).count();
+	m_HasIrradianceSH    = true;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      CPUで参照ベイクを行い, GPUのベイク結果と比較します.
+//-----------------------------------------------------------------------------
+bool SkyManager::CompareReferenceBake(ID3D12Device* pDevice, CommandList& commandList, ID3D12CommandQueue* pQueue, Fence& fence, uint32_t threadCount)
+{
+	m_ReferenceStats = {};
+
+	// LD項の入力はGPUと同じく, ミップ付きの変換済みキューブマップを使う.
+	auto pCube = m_SphereMapConverter.GetCubeMap();
+	auto desc  = pCube->GetDesc();
+
+	auto cube = MakeLayout(desc.Format, uint32_t(desc.Width), 6, desc.MipLevels);
+	if (cube.Format != IBLCache::FORMAT_R32G32B32A32_FLOAT)
+	{
+		ELOG("Error : Unsupported Cube Map Format. format = %d", int(cube.Format));
+		return false;
+	}
+
+	auto gpuDFG = GetDFGLayout();
+	auto gpuLD  = GetSpecularLDLayout();
+
+	ID3D12Resource*    pResources[] = { pCube, m_IBLBaker.GetTextureDFG(), m_IBLBaker.GetTextureSpecularLD() };
+	IBLCache::Texture* pTextures [] = { &cube,  &gpuDFG,                   &gpuLD };
+	if (!ReadbackTextures(pDevice, commandList, pQueue, fence, pResources, pTextures, _countof(pResources)))
+	{
+		return false;
+	}
+
+	IBLCache::Texture cpuDFG;
+	IBLCache::Texture cpuLD;
+
+	auto t0 = std::chrono::high_resolution_clock::now();
+	if (!IBLReferenceBaker::IntegrateDFG(IBLBaker::DFGTextureSize, IBLBaker::DFGSampleCount, threadCount, cpuDFG))
+	{
+		ELOG("Error : IBLReferenceBaker::IntegrateDFG() Failed.");
+		return false;
+	}
+
+	auto t1 = std::chrono::high_resolution_clock::now();
+	if (!IBLReferenceBaker::IntegrateSpecularLD(cube, IBLBaker::LDTextureSize, IBLBaker::MipCount, IBLBaker::LDSampleCount, threadCount, cpuLD))
+	{
+		ELOG("Error : IBLReferenceBaker::IntegrateSpecularLD() Failed.");
+		return false;
+	}
+
+	auto t2 = std::chrono::high_resolution_clock::now();
+
+	// DFG項は [0, 1] の値なので絶対誤差で比較する.
+	{
+		auto pCpu  = reinterpret_cast<const float*>(cpuDFG.Pixels.data());
+		auto pGpu  = reinterpret_cast<const float*>(gpuDFG.Pixels.data());
+		auto count = cpuDFG.Pixels.size() / sizeof(float);
+
+		double sum = 0.0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto diff = fabsf(pCpu[i] - pGpu[i]);
+			if (diff > m_ReferenceStats.DFGMaxError)
+			{ m_ReferenceStats.DFGMaxError = diff; }
+			sum += double(diff) * diff;
+		}
+		m_ReferenceStats.DFGRmsError = float(sqrt(sum / double(count)));
+	}
+
+	// LD項はHDRなので, 暗いテクセルが支配しないよう 1 を下限とした相対誤差で比較する.
+	{
+		auto pCpu  = reinterpret_cast<const float*>(cpuLD.Pixels.data());
+		auto pGpu  = reinterpret_cast<const float*>(gpuLD.Pixels.data());
+		auto count = cpuLD.Pixels.size() / (sizeof(float) * 4);
+
+		double sum = 0.0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			for (auto c = 0; c < 3; ++c)
+			{
+				auto base = fabsf(pGpu[i * 4 + c]);
+				auto diff = fabsf(pCpu[i * 4 + c] - pGpu[i * 4 + c]) / ((base > 1.0f) ? base : 1.0f);
+				if (diff > m_ReferenceStats.LDMaxError)
+				{ m_ReferenceStats.LDMaxError = diff; }
+				sum += double(diff) * diff;
+			}
+		}
+		m_ReferenceStats.LDRmsError = float(sqrt(sum / double(count * 3)));
+	}
+
+	m_ReferenceStats.DFGMilliSec = std::chrono::duration<double, std::milli>(t1 - t0).count();
+	m_ReferenceStats.LDMilliSec  = std::chrono::duration<double, std::milli>(t2 - t1).count();
+	m_ReferenceStats.Valid       = true;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      CPUでスフィアマップをキューブマップに変換し, GPUの変換結果と比較します.
+//-----------------------------------------------------------------------------
+bool SkyManager::CompareCpuCubeMap(ID3D12Device* pDevice, CommandList& commandList, ID3D12CommandQueue* pQueue, Fence& fence, uint32_t threadCount)
+{
+	m_ConvertStats = {};
+
+	auto pSphere    = m_SphereMap.GetResource();
+	auto sphereDesc = pSphere->GetDesc();
+
+	IBLCache::Texture sphere;
+	sphere.Format    = IBLCache::FORMAT(sphereDesc.Format);
+	sphere.Width     = uint32_t(sphereDesc.Width);
+	sphere.Height    = sphereDesc.Height;
+	sphere.ArraySize = 1;
+	sphere.MipLevels = 1;
+	sphere.Cube      = false;
+	if (sphere.Format != IBLCache::FORMAT_R32G32B32A32_FLOAT && sphere.Format != IBLCache::FORMAT_R16G16B16A16_FLOAT)
+	{
+		ELOG("Error : Unsupported Sphere Map Format. format = %d", int(sphere.Format));
+		return false;
+	}
+
+	// GPUの変換結果は描画時のままの最上位ミップで比較する.
+	auto pCube    = m_SphereMapConverter.GetCubeMap();
+	auto cubeDesc = pCube->GetDesc();
+	auto gpuCube  = MakeLayout(cubeDesc.Format, uint32_t(cubeDesc.Width), 6, 1);
+
+	ID3D12Resource*    pResources[] = { pSphere, pCube };
+	IBLCache::Texture* pTextures [] = { &sphere, &gpuCube };
+	if (!ReadbackTextures(pDevice, commandList, pQueue, fence, pResources, pTextures, _countof(pResources)))
+	{
+		return false;
+	}
+
+	std::vector<float> pixels(size_t(sphere.Width) * sphere.Height * 4);
+	if (sphere.Format == IBLCache::FORMAT_R16G16B16A16_FLOAT)
+	{
+		auto pHalf = reinterpret_cast<const uint16_t*>(sphere.Pixels.data());
+		for (size_t i = 0; i < pixels.size(); ++i)
+		{ pixels[i] = SphereMapCpuConverter::HalfToFloat(pHalf[i]); }
+	}
+	else
+	{
+		memcpy(pixels.data(), sphere.Pixels.data(), pixels.size() * sizeof(float));
+	}
+
+	IBLCache::Texture cpuCube;
+
+	auto t0 = std::chrono::high_resolution_clock::now();
+	if (!SphereMapCpuConverter::Convert(pixels.data(), sphere.Width, sphere.Height, gpuCube.Width, cubeDesc.MipLevels, IBLCache::FORMAT_R32G32B32A32_FLOAT, threadCount, cpuCube))
+	{
+		ELOG("Error : SphereMapCpuConverter::Convert() Failed.");
+		return false;
+	}
+	auto t1 = std::chrono::high_resolution_clock::now();
+
+	// HDRなので, 暗いテクセルが支配しないよう 1 を下限とした相対誤差で比較する.
+	auto mipSize = size_t(gpuCube.Width) * gpuCube.Height * 4;
+	auto cpuSlice = IBLCache::GetDataSize(cpuCube) / (sizeof(float) * 6);
+
+	double sum = 0.0;
+	for (auto face = 0u; face < 6; ++face)
+	{
+		auto pCpu = reinterpret_cast<const float*>(cpuCube.Pixels.data()) + face * cpuSlice;
+		auto pGpu = reinterpret_cast<const float*>(gpuCube.Pixels.data()) + face * mipSize;
+		for (size_t i = 0; i < mipSize; ++i)
+		{
+			if ((i & 3) == 3)
+			{ continue; }
+
+			auto base = fabsf(pGpu[i]);
+			auto diff = fabsf(pCpu[i] - pGpu[i]) / ((base > 1.0f) ? base : 1.0f);
+			if (diff > m_ConvertStats.MaxError)
+			{ m_ConvertStats.MaxError = diff; }
+			sum += double(diff) * diff;
+		}
+	}
+
+	m_ConvertStats.RmsError = float(sqrt(sum / double(mipSize / 4 * 3 * 6)));
+	m_ConvertStats.Size     = gpuCube.Width;
+	m_ConvertStats.MilliSec = std::chrono::duration<double, std::milli>(t1 - t0).count();
+	m_ConvertStats.Valid    = true;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      キャッシュを保存中かどうかチェックします.
+//-----------------------------------------------------------------------------
+bool SkyManager::IsCacheSaving() const
+{
+	return m_SaveTask.valid() && m_SaveTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
 void SkyManager::Term()
 {
+	if (m_LoadTask.valid())
+	{
+		m_LoadTask.wait();
+	}
+
+	if (m_SaveTask.valid())
+	{
+		m_CacheStats.Saved += m_SaveTask.get();
+	}
+
 	m_IBLBaker.Term();
 	m_SphereMapConverter.Term();
 	m_SphereMap.Term();
@@ -9,6 +9,7 @@
 //-----------------------------------------------------------------------------
 #include <SphereMapConverter.h>
 #include <Logger.h>
+#include <PipelineCache.h>
 #include <CommonStates.h>
 #include <DirectXHelpers.h>
 #include <SimpleMath.h>
@@ -148,14 +149,9 @@ bool SphereMapConverter::Init
 			return false;
 		}
 
-		hr = pDevice->CreateRootSignature(
-			0,
-			pBlob->GetBufferPointer(),
-			pBlob->GetBufferSize(),
-			IID_PPV_ARGS(m_pRootSig.GetAddressOf()));
-		if (FAILED(hr))
+		if (!PipelineCache::GetInstance().GetRootSignature(pDevice, pBlob->GetBufferPointer(), pBlob->GetBufferSize(), m_pRootSig))
 		{
-			ELOG("Error : ID3D12Device::CreateRootSignature() Failed. retcode = 0x%x", hr);
+			ELOG("Error : PipelineCache::GetRootSignature() Failed.");
 			return false;
 		}
 	}
@@ -184,10 +180,9 @@ bool SphereMapConverter::Init
 		desc.SampleDesc.Quality = 0;
 		desc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
 
-		auto hr = pDevice->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(m_pPSO.GetAddressOf()));
-		if (FAILED(hr))
+		if (!PipelineCache::GetInstance().GetGraphicsPipeline(pDevice, desc, m_pPSO))
 		{
-			ELOG("Error : ID3D12Device::CreateGraphicsPipelineState() Failed. retcode = 0x%x", hr);
+			ELOG("Error : PipelineCache::GetGraphicsPipeline() Failed.");
 			return false;
 		}
 	}
@@ -603,6 +598,14 @@ D3D12_RESOURCE_DESC SphereMapConverter::GetCubeMapDesc() const
 	return m_pCubeTex->GetDesc();
 }
 
+//-----------------------------------------------------------------------------
+//      キューブマップを取得します.
+//-----------------------------------------------------------------------------
+ID3D12Resource* SphereMapConverter::GetCubeMap() const
+{
+	return m_pCubeTex.Get();
+}
+
 //-----------------------------------------------------------------------------
 //      キューブマップのCPUディスクリプタハンドルを取得します.
 //-----------------------------------------------------------------------------
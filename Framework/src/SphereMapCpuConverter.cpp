@@ -0,0 +1,476 @@
+﻿//-----------------------------------------------------------------------------
+// File : SphereMapCpuConverter.cpp
+// Desc : Convert Sphere Map To Cube Map On CPU.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <SphereMapCpuConverter.h>
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const float F_PI = 3.14159265358979323f;
+
+//-----------------------------------------------------------------------------
+// 面ごとの方向です. dir = Axis + px * S + py * T (px, py は [-1, 1] で py は上向き).
+// IntegrateSpecularLD_PS の CalcDirection() と同じ向きです.
+//-----------------------------------------------------------------------------
+const float FaceAxis[6][3] = {
+	{  1.0f,  0.0f,  0.0f },
+	{ -1.0f,  0.0f,  0.0f },
+	{  0.0f,  1.0f,  0.0f },
+	{  0.0f, -1.0f,  0.0f },
+	{  0.0f,  0.0f,  1.0f },
+	{  0.0f,  0.0f, -1.0f },
+};
+
+const float FaceS[6][3] = {
+	{  0.0f,  0.0f, -1.0f },
+	{  0.0f,  0.0f,  1.0f },
+	{  1.0f,  0.0f,  0.0f },
+	{  1.0f,  0.0f,  0.0f },
+	{  1.0f,  0.0f,  0.0f },
+	{ -1.0f,  0.0f,  0.0f },
+};
+
+const float FaceT[6][3] = {
+	{  0.0f,  1.0f,  0.0f },
+	{  0.0f,  1.0f,  0.0f },
+	{  0.0f,  0.0f, -1.0f },
+	{  0.0f,  0.0f,  1.0f },
+	{  0.0f,  1.0f,  0.0f },
+	{  0.0f,  1.0f,  0.0f },
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Row structure
+///////////////////////////////////////////////////////////////////////////////
+struct Row
+{
+	uint32_t    Face;   //!< 面番号です.
+	uint32_t    Y;      //!< 行番号です.
+};
+
+//-----------------------------------------------------------------------------
+//      処理を複数スレッドに分配します.
+//-----------------------------------------------------------------------------
+template<typename Func>
+void ParallelFor(uint32_t count, uint32_t threadCount, Func func)
+{
+	if (threadCount == 0)
+	{ threadCount = std::max(1u, std::thread::hardware_concurrency()); }
+	threadCount = std::max(1u, std::min(threadCount, count));
+
+	std::atomic<uint32_t> next(0);
+	auto run = [&]()
+	{
+		for (;;)
+		{
+			auto index = next.fetch_add(1);
+			if (index >= count)
+			{ break; }
+
+			func(index);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount - 1);
+	for (auto i = 1u; i < threadCount; ++i)
+	{ threads.emplace_back(run); }
+
+	run();
+
+	for (auto& thread : threads)
+	{ thread.join(); }
+}
+
+//-----------------------------------------------------------------------------
+//      4要素の atan2 を求めます. 最大誤差は 1e-5 ラジアン程度です.
+//-----------------------------------------------------------------------------
+inline __m128 Atan2(__m128 y, __m128 x)
+{
+	const auto signMask = _mm_set1_ps(-0.0f);
+
+	auto ax = _mm_andnot_ps(signMask, x);
+	auto ay = _mm_andnot_ps(signMask, y);
+	auto mn = _mm_min_ps(ax, ay);
+	auto mx = _mm_max_ps(ax, ay);
+
+	// Abramowitz and Stegun 4.4.49 の多項式で [0, 1] の atan を求めます.
+	auto t = _mm_div_ps(mn, _mm_max_ps(mx, _mm_set1_ps(1e-30f)));
+	auto s = _mm_mul_ps(t, t);
+	auto p = _mm_set1_ps(0.0208351f);
+	p = _mm_add_ps(_mm_mul_ps(p, s), _mm_set1_ps(-0.0851330f));
+	p = _mm_add_ps(_mm_mul_ps(p, s), _mm_set1_ps( 0.1801410f));
+	p = _mm_add_ps(_mm_mul_ps(p, s), _mm_set1_ps(-0.3302995f));
+	p = _mm_add_ps(_mm_mul_ps(p, s), _mm_set1_ps( 0.9998660f));
+	p = _mm_mul_ps(p, t);
+
+	// 象限を戻します.
+	auto swap = _mm_cmpgt_ps(ay, ax);
+	p = _mm_or_ps(_mm_and_ps(swap, _mm_sub_ps(_mm_set1_ps(F_PI * 0.5f), p)), _mm_andnot_ps(swap, p));
+
+	auto negX = _mm_cmplt_ps(x, _mm_setzero_ps());
+	p = _mm_or_ps(_mm_and_ps(negX, _mm_sub_ps(_mm_set1_ps(F_PI), p)), _mm_andnot_ps(negX, p));
+
+	return _mm_or_ps(p, _mm_and_ps(signMask, y));
+}
+
+//-----------------------------------------------------------------------------
+//      スフィアマップをバイリニアでサンプルします. RGBA を1つのレジスタで補間します.
+//-----------------------------------------------------------------------------
+inline __m128 SampleBilinear(const float* pPixels, int width, int height, int x0, int y0, float wx, float wy)
+{
+	// 横方向は経度なので折り返し, 縦方向は極で止めます.
+	if (x0 < 0)
+	{ x0 += width; }
+	auto x1 = (x0 + 1 < width) ? x0 + 1 : 0;
+	if (x0 >= width)
+	{ x0 = width - 1; }
+
+	auto y1 = std::min(std::max(y0 + 1, 0), height - 1);
+	y0 = std::min(std::max(y0, 0), height - 1);
+
+	auto p00 = _mm_loadu_ps(pPixels + (size_t(y0) * width + x0) * 4);
+	auto p10 = _mm_loadu_ps(pPixels + (size_t(y0) * width + x1) * 4);
+	auto p01 = _mm_loadu_ps(pPixels + (size_t(y1) * width + x0) * 4);
+	auto p11 = _mm_loadu_ps(pPixels + (size_t(y1) * width + x1) * 4);
+
+	auto fx = _mm_set1_ps(wx);
+	auto top    = _mm_add_ps(p00, _mm_mul_ps(_mm_sub_ps(p10, p00), fx));
+	auto bottom = _mm_add_ps(p01, _mm_mul_ps(_mm_sub_ps(p11, p01), fx));
+	return _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), _mm_set1_ps(wy)));
+}
+
+//-----------------------------------------------------------------------------
+//      最上位ミップの1行を変換します.
+//-----------------------------------------------------------------------------
+void ConvertRow(const float* pPixels, uint32_t width, uint32_t height, uint32_t face, uint32_t y, uint32_t size, float* pDst)
+{
+	const auto& axis = FaceAxis[face];
+	const auto& S    = FaceS[face];
+	const auto& T    = FaceT[face];
+
+	auto py  = 1.0f - 2.0f * (float(y) + 0.5f) / float(size);
+	auto one = _mm_set1_ps(1.0f);
+
+	alignas(16) int   ix[4], iy[4];
+	alignas(16) float fx[4], fy[4];
+
+	for (auto x = 0u; x < size; x += 4)
+	{
+		// 端数の列は有効な列を繰り返し, 書き込みません.
+		auto px = _mm_setr_ps(
+			float(std::min(x + 0, size - 1)),
+			float(std::min(x + 1, size - 1)),
+			float(std::min(x + 2, size - 1)),
+			float(std::min(x + 3, size - 1)));
+		px = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(px, _mm_set1_ps(0.5f)), _mm_set1_ps(2.0f / float(size))), one);
+
+		auto dx = _mm_add_ps(_mm_set1_ps(axis[0] + py * T[0]), _mm_mul_ps(px, _mm_set1_ps(S[0])));
+		auto dy = _mm_add_ps(_mm_set1_ps(axis[1] + py * T[1]), _mm_mul_ps(px, _mm_set1_ps(S[1])));
+		auto dz = _mm_add_ps(_mm_set1_ps(axis[2] + py * T[2]), _mm_mul_ps(px, _mm_set1_ps(S[2])));
+
+		// SphereMapConverter は右手系のカメラで描画するので, 球の Z を反転した方向を参照します.
+		// 正規化しなくても atan2 で経度・緯度が求まります.
+		auto u = _mm_mul_ps(Atan2(dx, _mm_sub_ps(_mm_setzero_ps(), dz)), _mm_set1_ps(0.5f / F_PI));
+		u = _mm_add_ps(u, _mm_and_ps(_mm_cmplt_ps(u, _mm_setzero_ps()), one));
+		auto v = _mm_mul_ps(Atan2(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz))), dy), _mm_set1_ps(1.0f / F_PI));
+
+		// テクセル中心を基準にした座標です. -0.5 以上なので +1 してから切り捨てます.
+		auto tx = _mm_sub_ps(_mm_mul_ps(u, _mm_set1_ps(float(width))),  _mm_set1_ps(0.5f));
+		auto ty = _mm_sub_ps(_mm_mul_ps(v, _mm_set1_ps(float(height))), _mm_set1_ps(0.5f));
+		auto bx = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(tx, one)), _mm_set1_epi32(1));
+		auto by = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(ty, one)), _mm_set1_epi32(1));
+
+		_mm_store_si128(reinterpret_cast<__m128i*>(ix), bx);
+		_mm_store_si128(reinterpret_cast<__m128i*>(iy), by);
+		_mm_store_ps(fx, _mm_sub_ps(tx, _mm_cvtepi32_ps(bx)));
+		_mm_store_ps(fy, _mm_sub_ps(ty, _mm_cvtepi32_ps(by)));
+
+		auto count = std::min(4u, size - x);
+		for (auto i = 0u; i < count; ++i)
+		{
+			auto color = SampleBilinear(pPixels, int(width), int(height), ix[i], iy[i], fx[i], fy[i]);
+			_mm_storeu_ps(pDst + (x + i) * 4, color);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      1つ上のミップの 2x2 の平均で1行を求めます.
+//-----------------------------------------------------------------------------
+void DownsampleRow(const float* pSrc, uint32_t srcSize, uint32_t y, uint32_t dstSize, float* pDst)
+{
+	auto y0 = std::min(y * 2 + 0, srcSize - 1);
+	auto y1 = std::min(y * 2 + 1, srcSize - 1);
+	auto pRow0 = pSrc + size_t(y0) * srcSize * 4;
+	auto pRow1 = pSrc + size_t(y1) * srcSize * 4;
+	auto quarter = _mm_set1_ps(0.25f);
+
+	for (auto x = 0u; x < dstSize; ++x)
+	{
+		auto x0 = std::min(x * 2 + 0, srcSize - 1);
+		auto x1 = std::min(x * 2 + 1, srcSize - 1);
+
+		auto sum = _mm_add_ps(
+			_mm_add_ps(_mm_loadu_ps(pRow0 + x0 * 4), _mm_loadu_ps(pRow0 + x1 * 4)),
+			_mm_add_ps(_mm_loadu_ps(pRow1 + x0 * 4), _mm_loadu_ps(pRow1 + x1 * 4)));
+		_mm_storeu_ps(pDst + x * 4, _mm_mul_ps(sum, quarter));
+	}
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// SphereMapCpuConverter class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      キューブマップのサイズとミップレベル数を求めます.
+//-----------------------------------------------------------------------------
+uint32_t SphereMapCpuConverter::CalcCubeSize(uint32_t sphereWidth, int mapSize, uint32_t* pMipLevels)
+{
+	auto tempSize = (mapSize == -1) ? sphereWidth / 4 : uint32_t(mapSize);
+	tempSize = std::max(tempSize, 1u);
+
+	uint32_t size      = 1;
+	uint32_t mipLevels = 1;
+	while (size < tempSize)
+	{
+		size <<= 1;
+		mipLevels++;
+	}
+
+	if (pMipLevels != nullptr)
+	{ *pMipLevels = mipLevels; }
+
+	return size;
+}
+
+//-----------------------------------------------------------------------------
+//      スフィアマップをキューブマップに変換します.
+//-----------------------------------------------------------------------------
+bool SphereMapCpuConverter::Convert
+(
+	const float*        pPixels,
+	uint32_t            width,
+	uint32_t            height,
+	uint32_t            size,
+	uint32_t            mipLevels,
+	IBLCache::FORMAT    format,
+	uint32_t            threadCount,
+	IBLCache::Texture&  result
+)
+{
+	if (pPixels == nullptr || width == 0 || height == 0 || size == 0 || mipLevels == 0)
+	{ return false; }
+
+	if (format != IBLCache::FORMAT_R32G32B32A32_FLOAT && format != IBLCache::FORMAT_R16G16B16A16_FLOAT)
+	{ return false; }
+
+	uint32_t maxMipLevels = 1;
+	while ((size >> maxMipLevels) > 0)
+	{ maxMipLevels++; }
+
+	if (mipLevels > maxMipLevels)
+	{ return false; }
+
+	// ミップの生成は32bit浮動小数で行い, 最後に出力フォーマットへ変換します.
+	IBLCache::Texture cube;
+	cube.Format    = IBLCache::FORMAT_R32G32B32A32_FLOAT;
+	cube.Width     = size;
+	cube.Height    = size;
+	cube.ArraySize = 6;
+	cube.MipLevels = mipLevels;
+	cube.Cube      = true;
+	cube.Pixels.resize(IBLCache::GetDataSize(cube));
+
+	std::vector<size_t>   mipOffsets(mipLevels);
+	std::vector<uint32_t> mipSizes  (mipLevels);
+	size_t sliceSize = 0;
+	for (auto m = 0u; m < mipLevels; ++m)
+	{
+		mipOffsets[m] = sliceSize;
+		mipSizes  [m] = std::max(size >> m, 1u);
+		sliceSize += size_t(mipSizes[m]) * mipSizes[m] * 4;
+	}
+
+	auto pCube = reinterpret_cast<float*>(cube.Pixels.data());
+
+	std::vector<Row> rows;
+	rows.reserve(size_t(size) * 6);
+
+	for (auto m = 0u; m < mipLevels; ++m)
+	{
+		auto mipSize = mipSizes[m];
+
+		rows.clear();
+		for (auto f = 0u; f < 6; ++f)
+		{
+			for (auto y = 0u; y < mipSize; ++y)
+			{ rows.push_back({ f, y }); }
+		}
+
+		// 下位のミップは1つ上のミップに依存するので, ミップごとに全ての面と行を分配します.
+		ParallelFor(uint32_t(rows.size()), threadCount, [&](uint32_t index)
+		{
+			const auto& row = rows[index];
+			auto pFace = pCube + row.Face * sliceSize;
+			auto pDst  = pFace + mipOffsets[m] + size_t(row.Y) * mipSize * 4;
+
+			if (m == 0)
+			{ ConvertRow(pPixels, width, height, row.Face, row.Y, mipSize, pDst); }
+			else
+			{ DownsampleRow(pFace + mipOffsets[m - 1], mipSizes[m - 1], row.Y, mipSize, pDst); }
+		});
+	}
+
+	if (format == IBLCache::FORMAT_R32G32B32A32_FLOAT)
+	{
+		result = std::move(cube);
+		return true;
+	}
+
+	result.Format    = format;
+	result.Width     = size;
+	result.Height    = size;
+	result.ArraySize = 6;
+	result.MipLevels = mipLevels;
+	result.Cube      = true;
+	result.Pixels.resize(IBLCache::GetDataSize(result));
+
+	// BC6H(UF16) は負値・NaN・アルファを持たないので, 圧縮前に取り除きます.
+	auto pSrc   = reinterpret_cast<const float*>(cube.Pixels.data());
+	auto pDst   = reinterpret_cast<uint16_t*>(result.Pixels.data());
+	auto texels = uint32_t(cube.Pixels.size() / (sizeof(float) * 4));
+	auto chunks = (texels + 4095) / 4096;
+
+	ParallelFor(chunks, threadCount, [&](uint32_t chunk)
+	{
+		auto begin = chunk * 4096;
+		auto end   = std::min(begin + 4096, texels);
+		for (auto i = begin; i < end; ++i)
+		{
+			for (auto c = 0; c < 3; ++c)
+			{
+				auto value = pSrc[i * 4 + c];
+				value = (value > 0.0f) ? std::min(value, float(MaxHalfValue)) : 0.0f;
+				pDst[i * 4 + c] = FloatToHalf(value);
+			}
+			pDst[i * 4 + 3] = FloatToHalf(1.0f);
+		}
+	});
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      スフィアマップを1方向だけサンプルします.
+//-----------------------------------------------------------------------------
+void SphereMapCpuConverter::SampleReference(const float* pPixels, uint32_t width, uint32_t height, const float dir[3], float result[4])
+{
+	auto len = sqrtf(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+
+	// SphereMapConverter の球は u = atan2(x, z) / 2π, v = acos(y) / π で, 描画時に Z が反転します.
+	auto u = atan2f(dir[0], -dir[2]) / (2.0f * F_PI);
+	if (u < 0.0f)
+	{ u += 1.0f; }
+	auto v = acosf(std::min(std::max(dir[1] / len, -1.0f), 1.0f)) / F_PI;
+
+	auto tx = u * float(width)  - 0.5f;
+	auto ty = v * float(height) - 0.5f;
+	auto bx = floorf(tx);
+	auto by = floorf(ty);
+
+	auto color = SampleBilinear(pPixels, int(width), int(height), int(bx), int(by), tx - bx, ty - by);
+	_mm_storeu_ps(result, color);
+}
+
+//-----------------------------------------------------------------------------
+//      32bit浮動小数を16bit浮動小数に変換します.
+//-----------------------------------------------------------------------------
+uint16_t SphereMapCpuConverter::FloatToHalf(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	auto sign    = uint16_t((bits >> 16) & 0x8000u);
+	auto absBits = bits & 0x7FFFFFFFu;
+
+	// 無限大と NaN です.
+	if (absBits >= 0x7F800000u)
+	{ return uint16_t(sign | 0x7C00u | ((absBits > 0x7F800000u) ? 0x0200u : 0u)); }
+
+	// 65520 以上は丸めると無限大です.
+	if (absBits >= 0x477FF000u)
+	{ return uint16_t(sign | 0x7C00u); }
+
+	// 2^-14 未満は非正規化数です.
+	if (absBits < 0x38800000u)
+	{
+		auto shift = 126 - int(absBits >> 23);
+		if (shift > 24)
+		{ return sign; }
+
+		auto mant  = (absBits & 0x007FFFFFu) | 0x00800000u;
+		auto half  = mant >> shift;
+		auto rem   = mant & ((1u << shift) - 1);
+		auto mid   = 1u << (shift - 1);
+		if (rem > mid || (rem == mid && (half & 1)))
+		{ half++; }
+
+		return uint16_t(sign | half);
+	}
+
+	// 指数のバイアスを 127 から 15 に付け替えて, 仮数を最近接偶数に丸めます.
+	auto half = (absBits - 0x38000000u) >> 13;
+	auto rem  = absBits & 0x1FFFu;
+	if (rem > 0x1000u || (rem == 0x1000u && (half & 1)))
+	{ half++; }
+
+	return uint16_t(sign | half);
+}
+
+//-----------------------------------------------------------------------------
+//      16bit浮動小数を32bit浮動小数に変換します.
+//-----------------------------------------------------------------------------
+float SphereMapCpuConverter::HalfToFloat(uint16_t value)
+{
+	auto sign = uint32_t(value & 0x8000u) << 16;
+	auto exp  = (value >> 10) & 0x1Fu;
+	auto mant = value & 0x03FFu;
+
+	if (exp == 0)
+	{
+		auto result = float(mant) * (1.0f / 16777216.0f);
+		return (sign != 0) ? -result : result;
+	}
+
+	uint32_t bits;
+	if (exp == 31)
+	{ bits = sign | 0x7F800000u | (uint32_t(mant) << 13); }
+	else
+	{ bits = sign | ((exp + 112) << 23) | (uint32_t(mant) << 13); }
+
+	float result;
+	memcpy(&result, &bits, sizeof(result));
+	return result;
+}
@@ -0,0 +1,83 @@
+﻿//-----------------------------------------------------------------------------
+// File : SystemScheduler.cpp
+// Desc : Entity System Scheduling Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <SystemScheduler.h>
+#include <algorithm>
+#include <chrono>
+
+///////////////////////////////////////////////////////////////////////////////
+// SystemScheduler class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+SystemScheduler::SystemScheduler()
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+SystemScheduler::~SystemScheduler()
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      システムを登録します.
+//-----------------------------------------------------------------------------
+void SystemScheduler::Add(const char* name, PHASE phase, SystemFunc func)
+{
+	SystemInfo info;
+	info.Name     = name;
+	info.Phase    = phase;
+	info.Func     = func;
+	info.Enable   = true;
+	info.MicroSec = 0.0;
+
+	// 同じフェーズの末尾に挿入して登録順を保つ.
+	auto itr = std::upper_bound(m_Systems.begin(), m_Systems.end(), phase,
+		[](PHASE value, const SystemInfo& item) { return value < item.Phase; });
+	m_Systems.insert(itr, info);
+}
+
+//-----------------------------------------------------------------------------
+//      全てのシステムを破棄します.
+//-----------------------------------------------------------------------------
+void SystemScheduler::Clear()
+{
+	m_Systems.clear();
+}
+
+//-----------------------------------------------------------------------------
+//      有効なシステムをフェーズ順に実行します.
+//-----------------------------------------------------------------------------
+void SystemScheduler::Run(EntityRegistry& registry, float deltaTime)
+{
+	for (auto& system : m_Systems)
+	{
+		if (!system.Enable || !system.Func)
+		{
+			system.MicroSec = 0.0;
+			continue;
+		}
+
+		auto t0 = std::chrono::high_resolution_clock::now();
+		system.Func(registry, deltaTime);
+		auto t1 = std::chrono::high_resolution_clock::now();
+
+		system.MicroSec = std::chrono::duration<double, std::micro>(t1 - t0).count();
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      システムを取得します.
+//-----------------------------------------------------------------------------
+std::vector<SystemScheduler::SystemInfo>& SystemScheduler::GetSystems()
+{
+	return m_Systems;
+}
@@ -0,0 +1,569 @@
+﻿//-----------------------------------------------------------------------------
+// File : TransformHierarchy.cpp
+// Desc : Hierarchical Transform Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TransformHierarchy.h>
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const DirectX::XMFLOAT3 kZero    (0.0f, 0.0f, 0.0f);
+static const DirectX::XMFLOAT3 kOne     (1.0f, 1.0f, 1.0f);
+static const DirectX::XMFLOAT4 kIdentity(0.0f, 0.0f, 0.0f, 1.0f);
+
+//-----------------------------------------------------------------------------
+//      拡大・回転・平行移動の順に適用する行列を作成します.
+//-----------------------------------------------------------------------------
+inline DirectX::XMMATRIX XM_CALLCONV ComposeSRT
+(
+	DirectX::FXMVECTOR scale,
+	DirectX::FXMVECTOR rotation,
+	DirectX::FXMVECTOR position
+)
+{
+	auto m = DirectX::XMMatrixRotationQuaternion(rotation);
+	m.r[0] = DirectX::XMVectorMultiply(m.r[0], DirectX::XMVectorSplatX(scale));
+	m.r[1] = DirectX::XMVectorMultiply(m.r[1], DirectX::XMVectorSplatY(scale));
+	m.r[2] = DirectX::XMVectorMultiply(m.r[2], DirectX::XMVectorSplatZ(scale));
+	m.r[3] = DirectX::XMVectorSelect(DirectX::g_XMIdentityR3, position, DirectX::g_XMSelect1110);
+	return m;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// TransformHierarchy class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+// Static Variables.
+//-----------------------------------------------------------------------------
+const uint32_t TransformHierarchy::NullNode;
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+TransformHierarchy::TransformHierarchy()
+: m_Count       (0)
+, m_LayoutDirty (false)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+TransformHierarchy::~TransformHierarchy()
+{
+	Clear();
+}
+
+//-----------------------------------------------------------------------------
+//      全てのノードを破棄します.
+//-----------------------------------------------------------------------------
+void TransformHierarchy::Clear()
+{
+	m_SlotOf    .clear();
+	m_FreeNodes .clear();
+	m_NodeOf    .clear();
+	m_ParentNode.clear();
+	m_ParentSlot.clear();
+	m_SubtreeEnd.clear();
+	m_Positions .clear();
+	m_Rotations .clear();
+	m_Scales    .clear();
+	m_Worlds    .clear();
+	m_Dirty     .clear();
+	m_DirtyNodes.clear();
+
+	m_Count       = 0;
+	m_LayoutDirty = false;
+}
+
+//-----------------------------------------------------------------------------
+//      領域を予約します.
+//-----------------------------------------------------------------------------
+void TransformHierarchy::Reserve(size_t count)
+{
+	m_SlotOf    .reserve(count);
+	m_NodeOf    .reserve(count);
+	m_ParentNode.reserve(count);
+	m_ParentSlot.reserve(count);
+	m_SubtreeEnd.reserve(count);
+	m_Positions .reserve(count);
+	m_Rotations .reserve(count);
+	m_Scales    .reserve(count);
+	m_Worlds    .reserve(count);
+	m_Dirty     .reserve(count);
+	m_DirtyNodes.reserve(count);
+}
+
+//-----------------------------------------------------------------------------
+//      ノードを生成します.
+//-----------------------------------------------------------------------------
+uint32_t TransformHierarchy::Create(uint32_t parent)
+{
+	if (!IsValid(parent))
+	{
+		parent = NullNode;
+	}
+
+	uint32_t node;
+	if (!m_FreeNodes.empty())
+	{
+		node = m_FreeNodes.back();
+		m_FreeNodes.pop_back();
+	}
+	else
+	{
+		node = uint32_t(m_SlotOf.size());
+		m_SlotOf.push_back(NullNode);
+	}
+
+	DirectX::XMFLOAT4X4 identity;
+	DirectX::XMStoreFloat4x4(&identity, DirectX::XMMatrixIdentity());
+
+	// 末尾に追加する. ルートならそのままで深さ優先順が保たれる.
+	auto slot = uint32_t(m_NodeOf.size());
+	m_SlotOf[node] = slot;
+	m_NodeOf    .push_back(node);
+	m_ParentNode.push_back(parent);
+	m_ParentSlot.push_back(NullNode);
+	m_SubtreeEnd.push_back(slot + 1);
+	m_Positions .push_back(kZero);
+	m_Rotations .push_back(kIdentity);
+	m_Scales    .push_back(kOne);
+	m_Worlds    .push_back(identity);
+	m_Dirty     .push_back(0);
+
+	if (parent != NullNode)
+	{
+		m_LayoutDirty = true;
+	}
+
+	MarkDirty(slot);
+	m_Count++;
+
+	return node;
+}
+
+//-----------------------------------------------------------------------------
+//      ノードと全ての子孫を破棄します.
+//-----------------------------------------------------------------------------
+void TransformHierarchy::Destroy(uint32_t node)
+{
+	if (!IsValid(node))
+	{
+		return;
+	}
+
+	if (m_LayoutDirty)
+	{
+		RebuildLayout();
+	}
+
+	// 部分木は連続しているので範囲ごと無効にし, 次の並べ直しで詰める.
+	auto slot = m_SlotOf[node];
+	auto end  = m_SubtreeEnd[slot];
+	for (auto i = slot; i < end; ++i)
+	{
+		auto n = m_NodeOf[i];
+		m_SlotOf[n] = NullNode;
+		m_NodeOf[i] = NullNode;
+		m_FreeNodes.push_back(n);
+		m_Count--;
+	}
+
+	m_LayoutDirty = true;
+}
+
+//-----------------------------------------------------------------------------
+//      親ノードを変更します.
+//-----------------------------------------------------------------------------
+bool TransformHierarchy::SetParent(uint32_t node, uint32_t parent)
+{
+	if (!IsValid(node))
+	{
+		return false;
+	}
+
+	if (!IsValid(parent))
+	{
+		parent = NullNode;
+	}
+
+	if (m_LayoutDirty)
+	{
+		RebuildLayout();
+	}
+
+	auto slot = m_SlotOf[node];
+	if (parent != NullNode)
+	{
+		auto parentSlot = m_SlotOf[parent];
+		if (slot <= parentSlot && parentSlot < m_SubtreeEnd[slot])
+		{
+			return false;
+		}
+	}
+
+	m_ParentNode[slot] = parent;
+	m_LayoutDirty = true;
+	MarkDirty(slot);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      親ノードを取得します.
+//-----------------------------------------------------------------------------
+uint32_t TransformHierarchy::GetParent(uint32_t node) const
+{
+	assert(IsValid(node));
+	return m_ParentNode[m_SlotOf[node]];
+}
+
+//-----------------------------------------------------------------------------
+//      親空間での位置を設定します.
+//-----------------------------------------------------------------------------
+void TransformHierarchy::SetPosition(uint32_t node, const DirectX::XMFLOAT3& position)
+{
+	assert(IsValid(node));
+	auto slot = m_SlotOf[node];
+	m_Positions[slot] = position;
+	MarkDirty(slot);
+}
+
+//-----------------------------------------------------------------------------
+//      親空間での回転を設定します.
+//-----------------------------------------------------------------------------
+void TransformHierarchy::SetRotation(uint32_t node, const DirectX::XMFLOAT4& rotation)
+{
+	assert(IsValid(node));
+	auto slot = m_SlotOf[node];
+	m_Rotations[slot] = rotation;
+	MarkDirty(slot);
+}
+
+//-----------------------------------------------------------------------------
+//      親空間での拡大率を設定します.
+//-----------------------------------------------------------------------------
+void TransformHierarchy::SetScale(uint32_t node, const DirectX::XMFLOAT3& scale)
+{
+	assert(IsValid(node));
+	auto slot = m_SlotOf[node];
+	m_Scales[slot] = scale;
+	MarkDirty(slot);
+}
+
+//-----------------------------------------------------------------------------
+//      親空間での位置・回転・拡大率をまとめて設定します.
+//-----------------------------------------------------------------------------
+void TransformHierarchy::SetLocal
+(
+	uint32_t                    node,
+	const DirectX::XMFLOAT3&    position,
+	const DirectX::XMFLOAT4&    rotation,
+	const DirectX::XMFLOAT3&    scale
+)
+{
+	assert(IsValid(node));
+	auto slot = m_SlotOf[node];
+	m_Positions[slot] = position;
+	m_Rotations[slot] = rotation;
+	m_Scales   [slot] = scale;
+	MarkDirty(slot);
+}
+
+//-----------------------------------------------------------------------------
+//      親空間での位置を取得します.
+//-----------------------------------------------------------------------------
+const DirectX::XMFLOAT3& TransformHierarchy::GetPosition(uint32_t node) const
+{
+	assert(IsValid(node));
+	return m_Positions[m_SlotOf[node]];
+}
+
+//-----------------------------------------------------------------------------
+//      親空間での回転を取得します.
+//-----------------------------------------------------------------------------
+const DirectX::XMFLOAT4& TransformHierarchy::GetRotation(uint32_t node) const
+{
+	assert(IsValid(node));
+	return m_Rotations[m_SlotOf[node]];
+}
+
+//-----------------------------------------------------------------------------
+//      親空間での拡大率を取得します.
+//-----------------------------------------------------------------------------
+const DirectX::XMFLOAT3& TransformHierarchy::GetScale(uint32_t node) const
+{
+	assert(IsValid(node));
+	return m_Scales[m_SlotOf[node]];
+}
+
+//-----------------------------------------------------------------------------
+//      ワールド行列を取得します.
+//-----------------------------------------------------------------------------
+const DirectX::XMFLOAT4X4& TransformHierarchy::GetWorld(uint32_t node) const
+{
+	assert(IsValid(node));
+	return m_Worlds[m_SlotOf[node]];
+}
+
+//-----------------------------------------------------------------------------
+//      変更されたノードとその子孫のワールド行列を再計算します.
+//-----------------------------------------------------------------------------
+uint32_t TransformHierarchy::Update()
+{
+	if (m_LayoutDirty)
+	{
+		RebuildLayout();
+	}
+
+	m_DirtySlots.clear();
+	for (auto node : m_DirtyNodes)
+	{
+		if (!IsValid(node))
+		{
+			continue;
+		}
+
+		auto slot = m_SlotOf[node];
+		if (m_Dirty[slot])
+		{
+			m_DirtySlots.push_back(slot);
+			m_Dirty[slot] = 0;
+		}
+	}
+	m_DirtyNodes.clear();
+
+	// 親は子より前に並ぶので, 先頭から処理すれば親の行列は常に計算済み.
+	std::sort(m_DirtySlots.begin(), m_DirtySlots.end());
+
+	uint32_t count   = 0;
+	uint32_t covered = 0;
+	for (auto slot : m_DirtySlots)
+	{
+		// 祖先の部分木として計算済み.
+		if (slot < covered)
+		{
+			continue;
+		}
+
+		auto end = m_SubtreeEnd[slot];
+		for (auto i = slot; i < end; ++i)
+		{
+			auto world = ComposeSRT(
+				DirectX::XMLoadFloat3(&m_Scales[i]),
+				DirectX::XMLoadFloat4(&m_Rotations[i]),
+				DirectX::XMLoadFloat3(&m_Positions[i]));
+
+			auto parent = m_ParentSlot[i];
+			if (parent != NullNode)
+			{
+				world = DirectX::XMMatrixMultiply(world, DirectX::XMLoadFloat4x4(&m_Worlds[parent]));
+			}
+
+			DirectX::XMStoreFloat4x4(&m_Worlds[i], world);
+		}
+
+		count  += end - slot;
+		covered = end;
+	}
+
+	return count;
+}
+
+//-----------------------------------------------------------------------------
+//      全てのワールド行列を1ノードずつ親をたどって計算します.
+//-----------------------------------------------------------------------------
+void TransformHierarchy::ComputeReference(std::vector<DirectX::XMFLOAT4X4>& worlds) const
+{
+	worlds.resize(m_SlotOf.size());
+
+	for (uint32_t node = 0; node < uint32_t(m_SlotOf.size()); ++node)
+	{
+		if (!IsValid(node))
+		{
+			continue;
+		}
+
+		auto world = DirectX::XMMatrixIdentity();
+		for (auto n = node; n != NullNode; n = m_ParentNode[m_SlotOf[n]])
+		{
+			auto slot  = m_SlotOf[n];
+			auto local = ComposeSRT(
+				DirectX::XMLoadFloat3(&m_Scales[slot]),
+				DirectX::XMLoadFloat4(&m_Rotations[slot]),
+				DirectX::XMLoadFloat3(&m_Positions[slot]));
+			world = DirectX::XMMatrixMultiply(world, local);
+		}
+
+		DirectX::XMStoreFloat4x4(&worlds[node], world);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      有効なノード数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t TransformHierarchy::GetCount() const
+{
+	return m_Count;
+}
+
+//-----------------------------------------------------------------------------
+//      ノード番号の上限を取得します.
+//-----------------------------------------------------------------------------
+uint32_t TransformHierarchy::GetCapacity() const
+{
+	return uint32_t(m_SlotOf.size());
+}
+
+//-----------------------------------------------------------------------------
+//      ノードが有効かどうかを判定します.
+//-----------------------------------------------------------------------------
+bool TransformHierarchy::IsValid(uint32_t node) const
+{
+	return (node < m_SlotOf.size()) && (m_SlotOf[node] != NullNode);
+}
+
+//-----------------------------------------------------------------------------
+//      変更フラグを立てます.
+//-----------------------------------------------------------------------------
+void TransformHierarchy::MarkDirty(uint32_t slot)
+{
+	if (m_Dirty[slot])
+	{
+		return;
+	}
+
+	m_Dirty[slot] = 1;
+	m_DirtyNodes.push_back(m_NodeOf[slot]);
+}
+
+//-----------------------------------------------------------------------------
+//      親が子より前に並ぶ深さ優先順に並べ直します.
+//-----------------------------------------------------------------------------
+void TransformHierarchy::RebuildLayout()
+{
+	const auto count = uint32_t(m_NodeOf.size());
+
+	// 親の配列位置ごとに子を数えて, 子の一覧を作る(元の並び順を保つ).
+	m_ChildStart.assign(count + 1, 0);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		if (m_NodeOf[i] == NullNode)
+		{
+			continue;
+		}
+
+		auto parent = m_ParentNode[i];
+		if (!IsValid(parent))
+		{
+			m_ParentNode[i] = NullNode;
+			continue;
+		}
+
+		m_ChildStart[m_SlotOf[parent] + 1]++;
+	}
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		m_ChildStart[i + 1] += m_ChildStart[i];
+	}
+
+	m_Children.resize(m_ChildStart[count]);
+	m_Stack.assign(m_ChildStart.begin(), m_ChildStart.end() - 1);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		if (m_NodeOf[i] == NullNode || m_ParentNode[i] == NullNode)
+		{
+			continue;
+		}
+
+		auto parent = m_SlotOf[m_ParentNode[i]];
+		m_Children[m_Stack[parent]++] = i;
+	}
+
+	// ルートから深さ優先でたどる.
+	m_Order.clear();
+	m_Stack.clear();
+	for (uint32_t root = 0; root < count; ++root)
+	{
+		if (m_NodeOf[root] == NullNode || m_ParentNode[root] != NullNode)
+		{
+			continue;
+		}
+
+		m_Stack.push_back(root);
+		while (!m_Stack.empty())
+		{
+			auto slot = m_Stack.back();
+			m_Stack.pop_back();
+			m_Order.push_back(slot);
+
+			// 子の並び順を保つため逆順に積む.
+			for (auto c = m_ChildStart[slot + 1]; c > m_ChildStart[slot]; --c)
+			{
+				m_Stack.push_back(m_Children[c - 1]);
+			}
+		}
+	}
+
+	Permute(m_NodeOf);
+	Permute(m_ParentNode);
+	Permute(m_Positions);
+	Permute(m_Rotations);
+	Permute(m_Scales);
+	Permute(m_Worlds);
+	Permute(m_Dirty);
+
+	const auto newCount = uint32_t(m_Order.size());
+	for (uint32_t i = 0; i < newCount; ++i)
+	{
+		m_SlotOf[m_NodeOf[i]] = i;
+	}
+
+	m_ParentSlot.resize(newCount);
+	m_SubtreeEnd.resize(newCount);
+	for (uint32_t i = 0; i < newCount; ++i)
+	{
+		auto parent = m_ParentNode[i];
+		m_ParentSlot[i] = (parent != NullNode) ? m_SlotOf[parent] : NullNode;
+		m_SubtreeEnd[i] = i + 1;
+	}
+
+	// 部分木は連続しているので, 末尾から親へ終端を伝える.
+	for (auto i = newCount; i > 0; --i)
+	{
+		auto parent = m_ParentSlot[i - 1];
+		if (parent != NullNode)
+		{
+			m_SubtreeEnd[parent] = std::max(m_SubtreeEnd[parent], m_SubtreeEnd[i - 1]);
+		}
+	}
+
+	m_LayoutDirty = false;
+}
+
+//-----------------------------------------------------------------------------
+//      並べ替え後の順序で配列を詰め直します.
+//-----------------------------------------------------------------------------
+template<typename T>
+void TransformHierarchy::Permute(std::vector<T>& values)
+{
+	std::vector<T> sorted(m_Order.size());
+	for (size_t i = 0; i < m_Order.size(); ++i)
+	{
+		sorted[i] = values[m_Order[i]];
+	}
+	values.swap(sorted);
+}
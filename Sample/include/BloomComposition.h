@@ -6,7 +6,7 @@
 #include <RootSignature.h>
 #include <PostEffect.h>
 
-// J[^[Qbgƃu[^[Qbg
+// カラーターゲットとブルームターゲットを合成
 class BloomComposition: public PostEffect {
 public:
 	struct alignas(256) CbBloomComposition
@@ -16,7 +16,7 @@ public:
 	struct DrawSource {
 		ColorTarget&	ColorDest;
 		ColorTarget&    ColorBaseSources;
-		ColorTarget		(&ColorSources)[4];
+		ColorTarget*	ColorSources[4];
 		VertexBuffer&	VertexBuffer;
 	};
 
@@ -6,7 +6,7 @@
 #include <RootSignature.h>
 #include <PostEffect.h>
 
-// Pxo
+// 高輝度抽出
 class ExtractHightIntensity : public PostEffect {
 public:
 	struct alignas(256) CbExtractHightIntensity
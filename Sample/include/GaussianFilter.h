@@ -6,7 +6,7 @@
 #include <RootSignature.h>
 #include <PostEffect.h>
 
-// KEVAtB^[
+// ガウシアンフィルター
 class GaussianFilter : public PostEffect {
 public:
 	struct alignas(256) CbGaussianFilter
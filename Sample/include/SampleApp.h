@@ -20,6 +20,27 @@
 #include <Shaders.h>
 #include <SkyTextureManager.h>
 #include <ModelLoader.h>
+#include <RenderQueue.h>
+#include <InstanceBuffer.h>
+#include <FrustumCuller.h>
+#include <CascadedShadow.h>
+#include <ShadowCache.h>
+#include <DynamicBVH.h>
+#include <OcclusionCuller.h>
+#include <EntityRegistry.h>
+#include <SystemScheduler.h>
+#include <SceneComponents.h>
+#include <TransformHierarchy.h>
+#include <JobSystem.h>
+#include <CommandListPool.h>
+#include <CommandRecorder.h>
+#include <Profiler.h>
+#include <GpuProfiler.h>
+#include <RenderGraph.h>
+#include <RenderGraphResources.h>
+#include <SampleGraph.h>
+#include <PipelineCache.h>
+#include <ShaderLibrary.h>
 
 #include <ToneMap.h>
 #include <ShadowMap.h>
@@ -66,12 +87,110 @@ private:
 	//=========================================================================
 	// private variables.
 	//=========================================================================
-	
+	static const uint32_t			MaterialParamCapacity = 4096;	//!< マテリアルインスタンスの最大数です.
+	static const uint32_t			InstanceCapacity      = 16384;	//!< 1フレームに描画できるインスタンスの最大数です.
+	static const uint32_t			ShadowTileSize        = 1024;	//!< 1カスケードあたりのシャドウマップサイズです.
+
 	std::vector<GameObject*>		m_GameObjects;
 	Camera                          m_Camera;
 	CommonRTManager                 m_CommonRTManager;
 	CommonBufferManager             m_CommonBufferManager;
 	SkyManager						m_SkyManager;
+	MaterialParamBuffer				m_MaterialParamBuffer;			//!< マテリアルインスタンスのパラメータです.
+	RenderQueue						m_RenderQueue;					//!< 不透明パスの描画キューです.
+	InstanceBuffer					m_InstanceBuffer;				//!< インスタンス描画用のワールド行列です.
+	int								m_StressCount		= 0;		//!< 負荷計測用に追加で描画するオブジェクト数です.
+
+	FrustumCuller					m_Culler;						//!< シーン全体のワールド空間AABBです.
+	std::vector<Matrix>				m_StressWorlds;					//!< 負荷計測用オブジェクトのワールド行列です.
+	std::vector<uint32_t>			m_CameraVisible;				//!< カメラから可視なカリング番号です.
+	std::vector<uint32_t>			m_LightVisible;					//!< いずれかのカスケードから可視なカリング番号です.
+	std::vector<uint32_t>			m_CascadeVisible[CascadedShadow::MaxCascadeCount];	//!< カスケードごとの可視なカリング番号です.
+	std::vector<GameObject*>		m_CameraObjects;				//!< カメラから可視なオブジェクトです.
+	std::vector<GameObject*>		m_CascadeObjects[CascadedShadow::MaxCascadeCount];	//!< カスケードごとの可視なオブジェクトです. キャッシュ有効時は動的なものだけです.
+	std::vector<GameObject*>		m_StaticCascadeObjects[CascadedShadow::MaxCascadeCount];	//!< カスケードごとのキャッシュに描き直すオブジェクトです.
+	std::vector<uint32_t>			m_ShadowStaticDraws;			//!< キャッシュに描き直すカリング番号の作業領域です.
+	std::vector<uint32_t>			m_ShadowDynamicDraws;			//!< 毎フレーム描画するカリング番号の作業領域です.
+	ShadowCache						m_ShadowCache;					//!< 静的な遮蔽物のシャドウキャッシュです.
+	ShadowCache::Rect				m_ShadowDirtyRects[CascadedShadow::MaxCascadeCount] = {};	//!< カスケードごとの描き直す範囲です.
+	bool							m_EnableShadowCache	= true;		//!< 静的な遮蔽物をキャッシュするかどうか.
+	bool							m_EnableCulling		= true;		//!< 視錐台カリングを行うかどうか.
+	double							m_CullMicroSec		= 0.0;		//!< カリングにかかった時間(マイクロ秒).
+
+	DynamicBVH						m_SceneBVH;						//!< シーン検索用のBVHです.
+	std::vector<int32_t>			m_BVHProxies;					//!< カリング番号ごとのBVHの葉です.
+	bool							m_UseBVH			= true;		//!< カリングにBVHを使うかどうか.
+	uint32_t						m_BVHRefits			= 0;		//!< 直前のフレームで木を更新した葉の数です.
+	int								m_PickedObject		= -1;		//!< レイで選択したオブジェクトの番号です.
+	bool							m_PickChanged		= false;	//!< 選択が変わったかどうか.
+
+	static const uint32_t			OcclusionWidth		= 320;		//!< 遮蔽判定用の深度バッファの横幅です.
+	static const uint32_t			OcclusionHeight		= 180;		//!< 遮蔽判定用の深度バッファの縦幅です.
+	static const uint32_t			OccluderMaxTriangles = 1024;	//!< 遮蔽物として扱うモデルの最大三角形数です.
+
+	OcclusionCuller					m_OcclusionCuller;				//!< CPUで描画した深度による遮蔽判定です.
+	std::vector<OcclusionCuller::Occluder>	m_Occluders;			//!< オブジェクトごとの遮蔽物です(対象外は空).
+	bool							m_EnableOcclusion	= true;		//!< 遮蔽カリングを行うかどうか.
+	double							m_OcclusionMicroSec	= 0.0;		//!< 遮蔽判定にかかった時間(マイクロ秒).
+
+	EntityRegistry					m_Registry;						//!< エンティティとコンポーネントです.
+	SystemScheduler					m_Systems;						//!< 毎フレーム実行するシステムです.
+	std::vector<Entity>				m_StressEntities;				//!< 負荷計測用オブジェクトのエンティティです.
+
+	TransformHierarchy				m_Hierarchy;					//!< 負荷計測用オブジェクトの親子関係です.
+	uint32_t						m_StressRoot		= TransformHierarchy::NullNode;	//!< 負荷計測用オブジェクトの親ノードです.
+	Matrix							m_StressRootWorld;				//!< 親ノードに設定済みの行列です.
+	uint32_t						m_HierarchyRecomputed = 0;		//!< 直前のフレームで再計算したノード数です.
+
+	JobSystem						m_JobSystem;					//!< ワークスティーリング型のジョブシステムです.
+
+	static const uint32_t			OpaqueChunkMinItems	= 64;		//!< 不透明描画を分割するときの1リストあたりの最小アイテム数です.
+	static const uint32_t			OpaqueChunkMax		= 8;		//!< 不透明描画の最大分割数です.
+
+	CommandListPool					m_CommandListPool;				//!< フレーム・スレッドごとのコマンドリストです.
+	CommandRecorder<ID3D12GraphicsCommandList>	m_Recorder;			//!< パスごとにコマンドリストを記録します.
+	std::vector<RenderQueue::Stats>	m_OpaqueChunkStats;				//!< 分割した不透明描画ごとの統計情報です.
+	std::vector<ID3D12CommandList*>	m_SubmitLists;					//!< 提出するコマンドリストです.
+	bool							m_EnableParallelRecord = true;	//!< 並列に記録するかどうか.
+	double							m_RecordMicroSec	= 0.0;		//!< 記録にかかった時間(マイクロ秒)です.
+
+	///////////////////////////////////////////////////////////////////////////
+	// GPU_SCOPE enum
+	///////////////////////////////////////////////////////////////////////////
+	enum GPU_SCOPE
+	{
+		GPU_SCOPE_PRE_NORMAL = 0,	//!< 法線の事前描画です.
+		GPU_SCOPE_SHADOW,			//!< シャドウマップの描画です.
+		GPU_SCOPE_SKY,				//!< スカイボックスの描画です.
+		GPU_SCOPE_OPAQUE,			//!< 不透明描画です.
+		GPU_SCOPE_POST,				//!< ポストエフェクトです.
+		GPU_SCOPE_BLOOM,			//!< ブルームです.
+		GPU_SCOPE_TONEMAP,			//!< トーンマップです.
+		GPU_SCOPE_IMGUI,			//!< ImGui の描画です.
+		GPU_SCOPE_COUNT
+	};
+
+	static const uint32_t			GpuProfilerMaxScopes = 32;		//!< 1フレームで計測するGPUの最大スコープ数です.
+	GpuProfiler						m_GpuProfiler;					//!< GPUのタイムスタンプを計測します.
+	uint32_t						m_GpuScope[GPU_SCOPE_COUNT] = {};	//!< 現在のフレームのGPUスコープ番号です.
+	bool							m_EnableProfiler	= true;		//!< プロファイラを有効にするかどうか.
+	bool							m_EnableGpuProfiler	= true;		//!< GPUのタイムスタンプを計測するかどうか.
+	int								m_ProfilerCaptureFrames = 60;	//!< トレースに記録するフレーム数です.
+	bool							m_ProfilerTraceSaved = false;	//!< トレースを保存したかどうか.
+
+	bool							m_EnableFrameCap	 = false;	//!< フレームレートを制限するかどうか.
+	float							m_FrameCapFps		 = 60.0f;	//!< 制限するフレームレートです.
+
+	RenderGraph						m_RenderGraph;					//!< フレームのパスとリソースの依存関係です.
+	RenderGraphResources			m_GraphResources;				//!< レンダーグラフの一時リソースです.
+	uint32_t						m_GraphPass[GRAPH_PASS_COUNT] = {};	//!< パスごとのグラフのパス番号です.
+	uint32_t						m_GraphRes[GRAPH_RES_COUNT]   = {};	//!< リソースごとのグラフのリソース番号です.
+	bool							m_GraphAliasing		= true;		//!< 一時リソースのメモリを共有するかどうか.
+	bool							m_GraphKeepTargets	= false;	//!< 全ての一時リソースを確認用に残すかどうか.
+	bool							m_GraphDirty		= false;	//!< 次のフレームの前にグラフを再構築するかどうか.
+	bool							m_UseIrradianceSH = true;		//!< ディフューズIBLに球面調和関数を使うかどうか.
+	bool							m_CompareIBLReference = false;	//!< 次のフレームの前にCPU参照ベイクと比較するかどうか.
+	bool							m_CompareCpuCubeMap = false;	//!< 次のフレームの前にCPUでのキューブマップ変換と比較するかどうか.
 
 	ShadowMap						m_ShadowMap;
 	ToneMap                         m_ToneMap;
@@ -86,6 +205,8 @@ private:
 
 	DirectX::SimpleMath::Matrix     m_View;                         //!< ビュー行列.
 	DirectX::SimpleMath::Matrix     m_Proj;                         //!< 射影行列.
+	float                           m_NearClip = 0.1f;              //!< ニアクリップ.
+	float                           m_FarClip  = 1000.0f;           //!< ファークリップ.
 
 	int                             m_PrevCursorX;                  //!< 前回のカーソル位置X.
 	int                             m_PrevCursorY;                  //!< 前回のカーソル位置Y.
@@ -94,8 +215,12 @@ private:
 	float							m_LightIntensity	= 1.0f;
 	float							m_ShadowBias		= 0.0005f;
 	float							m_ShadowStrength	= 0.2f;
-	float							m_ShadowLightPosDistance = 50.0f;
-	Vector4							m_OrthoGraphParam	= Vector4(5.0f, 5.0f, 0.1f, 100.0f);
+	float							m_ShadowLightPosDistance = 50.0f;	//!< 分割範囲の外の遮蔽物を含めるよう, ライト側へ伸ばす距離.
+	int								m_CascadeCount		= CascadedShadow::MaxCascadeCount;	//!< カスケード数.
+	float							m_CascadeLambda		= 0.75f;	//!< 対数分割と線形分割の混合比.
+	float							m_ShadowDistance	= 100.0f;	//!< 影を落とす最大距離.
+	CascadedShadow::Cascade			m_Cascades[CascadedShadow::MaxCascadeCount];	//!< 現在のフレームのカスケードです.
+	uint32_t						m_ActiveCascadeCount = 0;		//!< 現在のフレームのカスケード数です.
 
 	Vector2							m_FogArea			= Vector2(0.0f, 5.0f);
 	Vector3							m_FogColor			= Vector3(1.0f, 1.0f, 1.0f);
@@ -138,15 +263,32 @@ private:
 	//-------------------------------------------------------------------------
 	//! @brief      シーンを描画します.
 	//-------------------------------------------------------------------------
-	void DrawScene(ID3D12GraphicsCommandList* pCmdList);
+	void DrawScene(ID3D12GraphicsCommandList* pCmdList, const RecordSlot& slot);
+	void BuildScene();
+	bool RecordFrame();
+	void SetRecordState(ID3D12GraphicsCommandList* pCmd);
 	void RenderShadowMap(ID3D12GraphicsCommandList* pCmd, DepthTarget& DepthDest);
-	void RenderPreProcess(ID3D12GraphicsCommandList* pCmd);
-	void RenderOpaque(ID3D12GraphicsCommandList* pCmd, ColorTarget& ColorSource, DepthTarget& depthSource, SkyManager& manager);
+	void RenderPreNormal(ID3D12GraphicsCommandList* pCmd);
+	void RenderOpaqueBegin(ID3D12GraphicsCommandList* pCmd, ColorTarget& ColorSource, DepthTarget& depthSource, SkyManager& manager);
 	void RenderPostProcess(ID3D12GraphicsCommandList* pCmd);
 	void RenderBloom(ID3D12GraphicsCommandList* pCmd);
 	void RenderImGui(ID3D12GraphicsCommandList* pCmd);
 	void UpdateCamera();
 	void UpdateBuffer();
+	void UpdateCulling();
+	void PickObject(float screenX, float screenY);
+	void UpdateOcclusion(size_t objectCount);
+	void UpdateStressEntities();
+	bool RebuildRenderGraph();
+	bool BeginGraphPass(ID3D12GraphicsCommandList* pCmd, GRAPH_PASS pass);
+	ColorTarget& GetGraphColor(GRAPH_RES res) const;
+	DepthTarget& GetGraphDepth(GRAPH_RES res) const;
+
+	//-------------------------------------------------------------------------
+	//! @brief      プロファイラの結果をフレームグラフで表示します.
+	//-------------------------------------------------------------------------
+	void DrawProfilerFlameGraph();
+
 	//-------------------------------------------------------------------------
 	//! @brief      モデルを描画します.
 	//-------------------------------------------------------------------------
@@ -0,0 +1,79 @@
+﻿//-----------------------------------------------------------------------------
+// File : SampleGraph.h
+// Desc : Sample Render Graph Declaration.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <RenderGraph.h>
+#include <RenderGraphResources.h>
+#include <cstdint>
+
+
+///////////////////////////////////////////////////////////////////////////////
+// GRAPH_PASS enum
+///////////////////////////////////////////////////////////////////////////////
+enum GRAPH_PASS
+{
+	GRAPH_PASS_PRE_NORMAL = 0,		//!< 法線と深度の事前描画です.
+	GRAPH_PASS_SHADOW_CACHE,		//!< 静的な遮蔽物のキャッシュです(キャッシュを使う場合のみ).
+	GRAPH_PASS_SHADOW_COPY,			//!< キャッシュからシャドウマップへの複製です(キャッシュを使う場合のみ).
+	GRAPH_PASS_SHADOW,				//!< シャドウマップです.
+	GRAPH_PASS_SKY,					//!< クリアと背景です.
+	GRAPH_PASS_OPAQUE,				//!< 不透明描画です.
+	GRAPH_PASS_EXTRACT,				//!< 高輝度抽出です.
+	GRAPH_PASS_GAUSS0,				//!< ガウシアンフィルター(1/2)です.
+	GRAPH_PASS_GAUSS1,				//!< ガウシアンフィルター(1/4)です.
+	GRAPH_PASS_GAUSS2,				//!< ガウシアンフィルター(1/8)です.
+	GRAPH_PASS_GAUSS3,				//!< ガウシアンフィルター(1/16)です.
+	GRAPH_PASS_COMPOSITE,			//!< ブルーム合成です.
+	GRAPH_PASS_TONEMAP,				//!< トーンマップです.
+	GRAPH_PASS_COUNT
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// GRAPH_RES enum
+///////////////////////////////////////////////////////////////////////////////
+enum GRAPH_RES
+{
+	GRAPH_RES_NORMAL = 0,			//!< 法線です(グラフの出力).
+	GRAPH_RES_PRE_DEPTH,			//!< 事前描画の深度です(グラフの出力).
+	GRAPH_RES_SCENE_COLOR,			//!< シーンカラーです.
+	GRAPH_RES_SCENE_DEPTH,			//!< シーン深度です.
+	GRAPH_RES_BRIGHT,				//!< 高輝度抽出の結果です.
+	GRAPH_RES_BLOOM0,				//!< ブルーム(1/2)です.
+	GRAPH_RES_BLOOM1,				//!< ブルーム(1/4)です.
+	GRAPH_RES_BLOOM2,				//!< ブルーム(1/8)です.
+	GRAPH_RES_BLOOM3,				//!< ブルーム(1/16)です.
+	GRAPH_RES_BLOOM_RESULT,			//!< ブルーム合成の結果です.
+	GRAPH_RES_SHADOW,				//!< シャドウマップです(グラフ外).
+	GRAPH_RES_SHADOW_STATIC,		//!< 静的な遮蔽物のキャッシュです(グラフ外, キャッシュを使う場合のみ).
+	GRAPH_RES_BACK_BUFFER,			//!< バックバッファです(グラフ外).
+	GRAPH_RES_COUNT
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      サンプルのフレームのパスとリソースをレンダーグラフに登録します.
+//!
+//! @param[in]      graph           登録先のレンダーグラフです.
+//! @param[in]      resources       リソースのサイズを求める一時リソースです. 初期化していない場合はグラフが推定します.
+//! @param[in]      width           画面の横幅です.
+//! @param[in]      height          画面の縦幅です.
+//! @param[in]      keepTargets     全ての一時リソースを確認用に出力にする場合は true を指定します.
+//! @param[in]      shadowCache     静的な遮蔽物のキャッシュを使う場合は true を指定します.
+//! @param[out]     pPasses         GRAPH_PASS_COUNT 個のパス番号の格納先です.
+//! @param[out]     pRes            GRAPH_RES_COUNT 個のリソース番号の格納先です.
+//! @note       登録しないパスとリソースの番号は RenderGraph::InvalidIndex になります.
+//-----------------------------------------------------------------------------
+void DeclareSampleGraph(
+	RenderGraph&                graph,
+	const RenderGraphResources& resources,
+	uint32_t                    width,
+	uint32_t                    height,
+	bool                        keepTargets,
+	bool                        shadowCache,
+	uint32_t*                   pPasses,
+	uint32_t*                   pRes);
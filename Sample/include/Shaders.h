@@ -11,22 +11,95 @@
 
 class BasicShader : public ModelShader {
 public:
-	void SetShader(
+	void SetPassState(
 		ID3D12GraphicsCommandList* pCmd,
-		int frameindex, 
-		Material& mat, 
-		int id, 
-		const ConstantBuffer* meshCB,
+		int frameindex,
 		const CommonBufferManager& commonbufmanager,
 		const SkyManager& skyManager
 	) override;
 
+	void SetMaterialState(
+		ID3D12GraphicsCommandList* pCmd,
+		int frameindex,
+		Material& mat,
+		int id,
+		const MaterialInstance* pInstance
+	) override;
+
+	void SetMeshState(
+		ID3D12GraphicsCommandList* pCmd,
+		int frameindex,
+		const ConstantBuffer* meshCB
+	) override;
+
+	void SetInstanceState(
+		ID3D12GraphicsCommandList* pCmd,
+		const MaterialInstance* pInstance
+	) override;
+
+	bool SupportsInstancing() const override;
+
+	void SetPipelineVariant(
+		ID3D12GraphicsCommandList* pCmd,
+		bool instanced
+	) override;
+
+	void SetInstanceRange(
+		ID3D12GraphicsCommandList* pCmd,
+		D3D12_GPU_DESCRIPTOR_HANDLE instances,
+		uint32_t offset
+	) override;
+
+	void Term() override;
+
 protected:
 
 	const wchar_t* m_VSPath = L"BasicVS.cso";
 	const wchar_t* m_PSPath = L"BasicPS.cso";
+	const wchar_t* m_InstancedVSPath = L"BasicInstancedVS.cso";
+
+	ComPtr<ID3D12PipelineState>	m_pInstancedPSO;	// ワールド行列をインスタンスバッファから読むPSO.
 
 	bool CreateRootSig(ComPtr<ID3D12Device> pDevice) override;
 	bool CreatePipeLineState(ComPtr<ID3D12Device> pDevice, DXGI_FORMAT rtvFormat, DXGI_FORMAT dsvFormat) override;
 	
-};
\ No newline at end of file
+};
+
+// マテリアルテクスチャをリソースヒープ全体のテーブルから番号で参照するシェーダ.
+// ドローごとのバインドはマテリアル定数バッファ1つで済む.
+class BindlessShader : public BasicShader {
+public:
+	BindlessShader();
+
+	void SetPassState(
+		ID3D12GraphicsCommandList* pCmd,
+		int frameindex,
+		const CommonBufferManager& commonbufmanager,
+		const SkyManager& skyManager
+	) override;
+
+	void SetMaterialState(
+		ID3D12GraphicsCommandList* pCmd,
+		int frameindex,
+		Material& mat,
+		int id,
+		const MaterialInstance* pInstance
+	) override;
+
+	void SetInstanceState(
+		ID3D12GraphicsCommandList* pCmd,
+		const MaterialInstance* pInstance
+	) override;
+
+	void SetInstanceRange(
+		ID3D12GraphicsCommandList* pCmd,
+		D3D12_GPU_DESCRIPTOR_HANDLE instances,
+		uint32_t offset
+	) override;
+
+	// サイズ無制限のSRVテーブルを扱えるデバイスかどうか.
+	static bool IsSupported(ID3D12Device* pDevice);
+
+protected:
+	bool CreateRootSig(ComPtr<ID3D12Device> pDevice) override;
+};
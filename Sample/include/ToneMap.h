@@ -22,9 +22,9 @@ public:
 	///////////////////////////////////////////////////////////////////////////////
 	enum TONEMAP_TYPE
 	{
-		TONEMAP_NONE = 0,   // g[}bvȂ.
-		TONEMAP_REINHARD,   // Reinhardg[}bv.
-		TONEMAP_GT,         // GTg[}bv.
+		TONEMAP_NONE = 0,   // トーンマップなし.
+		TONEMAP_REINHARD,   // Reinhardトーンマップ.
+		TONEMAP_GT,         // GTトーンマップ.
 	};
 
 	///////////////////////////////////////////////////////////////////////////////
@@ -32,14 +32,14 @@ public:
 	///////////////////////////////////////////////////////////////////////////////
 	struct alignas(256) CbTonemap
 	{
-		int     Type;               // g[}bv^Cv.
-		int     ColorSpace;         // o͐F.
-		float   BaseLuminance;      // Pxl[nit].
-		float   MaxLuminance;       // őPxl[nit].
+		int     Type;               // トーンマップタイプ.
+		int     ColorSpace;         // 出力色空間.
+		float   BaseLuminance;      // 基準輝度値[nit].
+		float   MaxLuminance;       // 最大輝度値[nit].
 	};
 
 	//-----------------------------------------------------------------------------
-	//      Fx擾.
+	//      色度を取得する.
 	//-----------------------------------------------------------------------------
 	inline static UINT16 GetChromaticityCoord(double value)
 	{
@@ -59,16 +59,16 @@ public:
 	void DrawTonemap(ID3D12GraphicsCommandList*	pCmd, int frameindex, DrawSource& s);
 
 	void SetLuminance(float base, float max);
-	int                             m_TonemapType;              //!< g[}bv^Cv.
+	int                             m_TonemapType;              //!< トーンマップタイプ.
 
 private:
 
 	const wchar_t* m_VSPath = L"QuadVS.cso";
 	const wchar_t* m_PSPath = L"TonemapPS.cso";
 
-	int                             m_ColorSpace;                   //!< o͐F
-	float                           m_BaseLuminance;                //!< Pxl.
-	float                           m_MaxLuminance;                 //!< őPxl.
+	int                             m_ColorSpace;                   //!< 出力色空間
+	float                           m_BaseLuminance;                //!< 基準輝度値.
+	float                           m_MaxLuminance;                 //!< 最大輝度値.
 
 	bool CreateRootSig(ComPtr<ID3D12Device> pDevice) override;
 	bool CreatePipeLineState(ComPtr<ID3D12Device> pDevice, DXGI_FORMAT rtv_format, DXGI_FORMAT dsv_format)  override;
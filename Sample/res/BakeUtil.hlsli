@@ -17,12 +17,12 @@ static const uint SampleCount = 128;
 // Constant Values.
 //-----------------------------------------------------------------------------
 #ifndef F_PI
-#define F_PI        3.14159265358979323f   // ~.
+#define F_PI        3.14159265358979323f   // 円周率.
 #endif//F_PI
 
 
 //-----------------------------------------------------------------------------
-//      Hammersley_QTv܂.
+//      Hammersley点群をサンプルします.
 //-----------------------------------------------------------------------------
 float2 Hammersley(uint i, uint N)
 {
@@ -31,7 +31,7 @@ float2 Hammersley(uint i, uint N)
 }
 
 //-----------------------------------------------------------------------------
-//      L[u}bṽtFb`߂܂.
+//      キューブマップのフェッチ方向を求めます.
 //-----------------------------------------------------------------------------
 float3 CalcDirection(float2 uv, const int faceIndex)
 {
@@ -52,14 +52,14 @@ float3 CalcDirection(float2 uv, const int faceIndex)
 };
 
 //-----------------------------------------------------------------------------
-//      K߂܂.
+//      正規直交基底を求めます.
 //-----------------------------------------------------------------------------
 void TangentSpace(float3 N, out float3 T, out float3 B)
 {
     // Tom Duff, James Burgess, Per Christensen, Christophe Hery, Andrew Kensler, Max Liani, and Ryusuke Villemin
     // "Building an Orthonormal Bais, Revisited",
     // Journal of Computer Graphics Techniques Vol.6, No.1, 2017.
-    // Listing 3.Q.
+    // Listing 3.参照.
     float s = (N.z >= 0.0f) ? 1.0f : -1.0f;
     float a = -1.0f / (s + N.z);
     float b = N.x * N.y * a;
@@ -68,7 +68,7 @@ void TangentSpace(float3 N, out float3 T, out float3 B)
 }
 
 //-----------------------------------------------------------------------------
-//      Lambert BRDF̌`ɊÂTvOs܂.
+//      Lambert BRDFの形状に基づくサンプリングを行います.
 //-----------------------------------------------------------------------------
 float3 SampleLambert(float2 u, float3 N)
 {
@@ -87,7 +87,7 @@ float3 SampleLambert(float2 u, float3 N)
 }
 
 //-----------------------------------------------------------------------------
-//      GGX BRDF̌`ɂƂÂTvOs܂.
+//      GGX BRDFの形状にもとづくサンプリングを行います.
 //-----------------------------------------------------------------------------
 float3 SampleGGX(float2 u, float a, float3 N)
 {
@@ -10,17 +10,18 @@
 #include "BRDF.hlsli"
 #include "CommonBuffer.hlsli"
 #include "CommonLightBuffer.hlsli"
+#include "MaterialParam.hlsli"
 
 ///////////////////////////////////////////////////////////////////////////////
 // VSOutput structure
 ///////////////////////////////////////////////////////////////////////////////
 struct VSOutput
 {
-    float4      Position        : SV_POSITION;          // ʒuWł.
-    float4      PosSM           : POSITION_SM;          // 
-    float2      TexCoord        : TEXCOORD;             // eNX`Wł.
-    float3      WorldPos        : WORLD_POS;            // [hԂ̈ʒuWł.
-    float3x3    InvTangentBasis : INV_TANGENT_BASIS;    // ڐԂւ̊ϊs̋tsł.
+    float4      Position        : SV_POSITION;          // 位置座標です.
+    float2      TexCoord        : TEXCOORD;             // テクスチャ座標です.
+    float3      WorldPos        : WORLD_POS;            // ワールド空間の位置座標です.
+    float3x3    InvTangentBasis : INV_TANGENT_BASIS;    // 接線空間への基底変換行列の逆行列です.
+    nointerpolation uint MaterialIndex : MATERIAL_INDEX; // マテリアルパラメータブロックの番号です.
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -28,56 +29,48 @@ struct VSOutput
 ///////////////////////////////////////////////////////////////////////////////
 struct PSOutput
 {
-    float4  Color : SV_TARGET0;     // o̓J[ł.
+    float4  Color : SV_TARGET0;     // 出力カラーです.
 };
 
 
-///////////////////////////////////////////////////////////////////////////////
-// Custom constant buffer
-///////////////////////////////////////////////////////////////////////////////
-cbuffer CbCustom : register(b4)
-{
-    float4 TestCustomParam : packoffset(c0);
-};
-
 //-----------------------------------------------------------------------------
 // Textures and Samplers
 //-----------------------------------------------------------------------------
-// DFG.
+// DFG項.
 Texture2D    DFGMap         : register(t0);
 SamplerState DFGSmp         : register(s0);
 
-// fBt[YLD.
+// ディフューズLD項.
 TextureCube  DiffuseLDMap   : register(t1);
 SamplerState DiffuseLDSmp   : register(s1);
 
-// XyL[LD.
+// スペキュラーLD項.
 TextureCube  SpecularLDMap  : register(t2);
 SamplerState SpecularLDSmp  : register(s2);
 
-// x[XJ[}bv.
+// ベースカラーマップ.
 Texture2D    BaseColorMap    : register(t3);
 SamplerState BaseColorSmp    : register(s3);
 
-// ^bN}bv.
+// メタリックマップ.
 Texture2D    MetallicMap     : register(t4);
 SamplerState MetallicSmp     : register(s4);
 
-// tlX}bv.
+// ラフネスマップ.
 Texture2D    RoughnessMap    : register(t5);
 SamplerState RoughnessSmp    : register(s5);
 
-// @}bv.
+// 法線マップ.
 Texture2D     NormalMap       : register(t6);
 SamplerState  NormalSmp       : register(s6);
 
-// VhE}bv
+// シャドウマップ
 Texture2D    ShadowMap      : register(t9);
 SamplerState ShadowSmp      : register(s9);
 
 
 //-----------------------------------------------------------------------------
-//      XyL[̎xzIȕ߂܂.
+//      スペキュラーの支配的な方向を求めます.
 //-----------------------------------------------------------------------------
 float3 GetSpecularDomiantDir(float3 N, float3 R, float roughness)
 {
@@ -87,16 +80,19 @@ float3 GetSpecularDomiantDir(float3 N, float3 R, float roughness)
 }
 
 //-----------------------------------------------------------------------------
-//      fBt[YIBL]܂.
+//      ディフューズIBLを評価します.
 //-----------------------------------------------------------------------------
 float3 EvaluateIBLDiffuse(float3 N)
 {
-    // Lambert BRDFDFG͐ϕ1.0ƂȂ̂ŁCLD݂̂ԋpΗǂ
+    // Lambert BRDFはDFG項は積分すると1.0となるので，LD項のみを返却すれば良い
+    if (EnableIrradianceSH > 0.5f)
+    { return EvaluateIrradianceSH(N); }
+
     return DiffuseLDMap.Sample(DiffuseLDSmp, N).rgb;
 }
 
 //-----------------------------------------------------------------------------
-//      `tlX~bvx߂܂.
+//      線形ラフネスからミップレベルを求めます.
 //-----------------------------------------------------------------------------
 float RoughnessToMipLevel(float linearRoughness, float mipCount)
 {
@@ -104,29 +100,29 @@ float RoughnessToMipLevel(float linearRoughness, float mipCount)
 }
 
 //-----------------------------------------------------------------------------
-//      XyL[IBL]܂.
+//      スペキュラーIBLを評価します.
 //-----------------------------------------------------------------------------
 float3 EvaluateIBLSpecular
 (
-    float           NdotV,          // @xNgƎxNg̓.
-    float3          N,              // @xNg.
-    float3          R,              // ˃xNg.
-    float3          f0,             // tl
-    float           roughness,      // `tlX.
-    float           textureSize,    // eNX`TCY.
-    float           mipCount        // ~bvx.
+    float           NdotV,          // 法線ベクトルと視線ベクトルの内積.
+    float3          N,              // 法線ベクトル.
+    float3          R,              // 反射ベクトル.
+    float3          f0,             // フレネル項
+    float           roughness,      // 線形ラフネス.
+    float           textureSize,    // テクスチャサイズ.
+    float           mipCount        // ミップレベル数.
 )
 {
     float  a = roughness * roughness;
     float3 dominantR = GetSpecularDomiantDir(N, R, a);
 
-    // ֐č\z.
+    // 関数を再構築.
     // L * D * (f0 * Gvis * (1 - Fc) + Gvis * Fc) * cosTheta / (4 * NdotL * NdotV).
-    NdotV = max(NdotV, 0.5f / textureSize); // [ZȂ悤ɂ.
+    NdotV = max(NdotV, 0.5f / textureSize); // ゼロ除算が発生しないようにする.
     float  mipLevel = RoughnessToMipLevel(roughness, mipCount);
     float3 preLD    = SpecularLDMap.SampleLevel(SpecularLDSmp, dominantR, mipLevel).xyz;
     
-    // OϕDFGTv.
+    // 事前積分したDFGをサンプルする.
     // Fc = ( 1 - HdotL )^5
     // PreIntegratedDFG.r = Gvis * (1 - Fc)
     // PreIntegratedDFG.g = Gvis * Fc
@@ -139,7 +135,7 @@ float3 EvaluateIBLSpecular
 
 
 //-----------------------------------------------------------------------------
-//      sNZVF[_̃CGg[|Cgł.
+//      ピクセルシェーダのメインエントリーポイントです.
 //-----------------------------------------------------------------------------
 PSOutput main(VSOutput input)
 {
@@ -170,12 +166,12 @@ PSOutput main(VSOutput input)
     lit += EvaluateIBLDiffuse(N) * Kd;
     lit += EvaluateIBLSpecular(NV, N, R, Ks, roughness, TextureSize, MipCount);
 
-    // eXgpCg
+    // テスト用ライト
+    float4 TestCustomParam = GetMaterialParam(input.MaterialIndex, 0);
     float3 TestLit = saturate(dot(N, normalize(LightDirection))) * TestCustomParam.xyz * LightIntensity;
     
     // Shadow
-    float lightDist     = ShadowMap.Sample(ShadowSmp, input.PosSM.xy);
-    float Shadow        = (input.PosSM.z - ShadowBias < lightDist) ? 1.0f : ShadowStrength;
+    float Shadow        = EvaluateCascadeShadow(ShadowMap, ShadowSmp, input.WorldPos, CameraPosition);
     
     float3 lastLit = lit * LightIntensity * Shadow + TestLit;
     
@@ -4,17 +4,17 @@
 // Copyright(c) Pocol. All right reserved.
 //-----------------------------------------------------------------------------
 #include "VSCommonBuffer.hlsli"
-#include "CommonLightBuffer.hlsli"
+#include "MaterialParam.hlsli"
 
 ///////////////////////////////////////////////////////////////////////////////
 // VSInput structure
 ///////////////////////////////////////////////////////////////////////////////
 struct VSInput
 {
-    float3  Position : POSITION;    // ʒuWł.
-    float3  Normal   : NORMAL;      // @xNgł.
-    float2  TexCoord : TEXCOORD;    // eNX`Wł.
-    float3  Tangent  : TANGENT;     // ڐxNgł.
+    float3  Position : POSITION;    // 位置座標です.
+    float3  Normal   : NORMAL;      // 法線ベクトルです.
+    float2  TexCoord : TEXCOORD;    // テクスチャ座標です.
+    float3  Tangent  : TANGENT;     // 接線ベクトルです.
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -22,16 +22,16 @@ struct VSInput
 ///////////////////////////////////////////////////////////////////////////////
 struct VSOutput
 {
-    float4      Position        : SV_POSITION;          // ʒuWł.
-    float4      PosSM           : POSITION_SM;          // 
-    float2      TexCoord        : TEXCOORD;             // eNX`Wł.
-    float3      WorldPos        : WORLD_POS;            // [hԂ̈ʒuWł.
-    float3x3    InvTangentBasis : INV_TANGENT_BASIS;    // ڐԂւ̊ϊs̋tsł.
+    float4      Position        : SV_POSITION;          // 位置座標です.
+    float2      TexCoord        : TEXCOORD;             // テクスチャ座標です.
+    float3      WorldPos        : WORLD_POS;            // ワールド空間の位置座標です.
+    float3x3    InvTangentBasis : INV_TANGENT_BASIS;    // 接線空間への基底変換行列の逆行列です.
+    nointerpolation uint MaterialIndex : MATERIAL_INDEX; // マテリアルパラメータブロックの番号です.
 };
 
 
 //-----------------------------------------------------------------------------
-//      _VF[_̃CGg[|Cgł.
+//      頂点シェーダのメインエントリーポイントです.
 //-----------------------------------------------------------------------------
 VSOutput main(VSInput input)
 {
@@ -45,22 +45,15 @@ VSOutput main(VSInput input)
     output.Position = projPos;
     output.TexCoord = input.TexCoord;
     output.WorldPos = worldPos.xyz;
+    output.MaterialIndex = MaterialIndex;
 
-    // xNg
+    // 基底ベクトル
     float3 N = normalize(mul((float3x3)World, input.Normal));
     float3 T = normalize(mul((float3x3)World, input.Tangent));
     float3 B = normalize(cross(N, T));
 
-    // ϊs̋ts.
+    // 基底変換行列の逆行列.
     output.InvTangentBasis = transpose(float3x3(T, B, N));
-    
-    // VhĚvZ
-    // float4 _worldPos    = mul(World, localPos);
-    float4 LvpPos       = mul(LightVP, worldPos);
-    LvpPos.xyz          = LvpPos.xyz / LvpPos.w;
-    output.PosSM.x      = (1.0f + LvpPos.x) / 2.0f;
-    output.PosSM.y      = (1.0f - LvpPos.y) / 2.0f;
-    output.PosSM.z      = LvpPos.z;
 
     return output;
 }
\ No newline at end of file
@@ -0,0 +1,187 @@
+//-----------------------------------------------------------------------------
+// File : BindlessPS.hlsl
+// Desc : Pixel Shader (Bindless Material Textures).
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include "BRDF.hlsli"
+#include "CommonBuffer.hlsli"
+#include "CommonLightBuffer.hlsli"
+#include "MaterialParam.hlsli"
+
+///////////////////////////////////////////////////////////////////////////////
+// VSOutput structure
+///////////////////////////////////////////////////////////////////////////////
+struct VSOutput
+{
+    float4      Position        : SV_POSITION;          // 位置座標です.
+    float2      TexCoord        : TEXCOORD;             // テクスチャ座標です.
+    float3      WorldPos        : WORLD_POS;            // ワールド空間の位置座標です.
+    float3x3    InvTangentBasis : INV_TANGENT_BASIS;    // 接線空間への基底変換行列の逆行列です.
+    nointerpolation uint MaterialIndex : MATERIAL_INDEX; // マテリアルパラメータブロックの番号です.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// PSOutput structure
+///////////////////////////////////////////////////////////////////////////////
+struct PSOutput
+{
+    float4  Color : SV_TARGET0;     // 出力カラーです.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Custom constant buffer
+///////////////////////////////////////////////////////////////////////////////
+cbuffer CbCustom : register(b4)
+{
+    uint   BaseColorIndex   : packoffset(c16);      // ベースカラーマップの番号です.
+    uint   MetallicIndex    : packoffset(c16.y);    // メタリックマップの番号です.
+    uint   RoughnessIndex   : packoffset(c16.z);    // ラフネスマップの番号です.
+    uint   NormalIndex      : packoffset(c16.w);    // 法線マップの番号です.
+};
+
+//-----------------------------------------------------------------------------
+// Textures and Samplers
+//-----------------------------------------------------------------------------
+// DFG項.
+Texture2D    DFGMap         : register(t0);
+SamplerState DFGSmp         : register(s0);
+
+// ディフューズLD項.
+TextureCube  DiffuseLDMap   : register(t1);
+SamplerState DiffuseLDSmp   : register(s1);
+
+// スペキュラーLD項.
+TextureCube  SpecularLDMap  : register(t2);
+SamplerState SpecularLDSmp  : register(s2);
+
+// マテリアルテクスチャ(リソースヒープ全体).
+Texture2D    MaterialMaps[] : register(t0, space1);
+SamplerState MaterialSmp    : register(s3);
+
+// シャドウマップ
+Texture2D    ShadowMap      : register(t9);
+SamplerState ShadowSmp      : register(s9);
+
+
+//-----------------------------------------------------------------------------
+//      スペキュラーの支配的な方向を求めます.
+//-----------------------------------------------------------------------------
+float3 GetSpecularDomiantDir(float3 N, float3 R, float roughness)
+{
+    float smoothness = saturate(1.0f - roughness);
+    float lerpFactor = smoothness * (sqrt(smoothness) + roughness);
+    return lerp(N, R, lerpFactor);
+}
+
+//-----------------------------------------------------------------------------
+//      ディフューズIBLを評価します.
+//-----------------------------------------------------------------------------
+float3 EvaluateIBLDiffuse(float3 N)
+{
+    // Lambert BRDFはDFG項は積分すると1.0となるので，LD項のみを返却すれば良い
+    if (EnableIrradianceSH > 0.5f)
+    { return EvaluateIrradianceSH(N); }
+
+    return DiffuseLDMap.Sample(DiffuseLDSmp, N).rgb;
+}
+
+//-----------------------------------------------------------------------------
+//      線形ラフネスからミップレベルを求めます.
+//-----------------------------------------------------------------------------
+float RoughnessToMipLevel(float linearRoughness, float mipCount)
+{
+    return (mipCount - 1) * linearRoughness;
+}
+
+//-----------------------------------------------------------------------------
+//      スペキュラーIBLを評価します.
+//-----------------------------------------------------------------------------
+float3 EvaluateIBLSpecular
+(
+    float           NdotV,          // 法線ベクトルと視線ベクトルの内積.
+    float3          N,              // 法線ベクトル.
+    float3          R,              // 反射ベクトル.
+    float3          f0,             // フレネル項
+    float           roughness,      // 線形ラフネス.
+    float           textureSize,    // テクスチャサイズ.
+    float           mipCount        // ミップレベル数.
+)
+{
+    float  a = roughness * roughness;
+    float3 dominantR = GetSpecularDomiantDir(N, R, a);
+
+    // 関数を再構築.
+    // L * D * (f0 * Gvis * (1 - Fc) + Gvis * Fc) * cosTheta / (4 * NdotL * NdotV).
+    NdotV = max(NdotV, 0.5f / textureSize); // ゼロ除算が発生しないようにする.
+    float  mipLevel = RoughnessToMipLevel(roughness, mipCount);
+    float3 preLD    = SpecularLDMap.SampleLevel(SpecularLDSmp, dominantR, mipLevel).xyz;
+    
+    // 事前積分したDFGをサンプルする.
+    // Fc = ( 1 - HdotL )^5
+    // PreIntegratedDFG.r = Gvis * (1 - Fc)
+    // PreIntegratedDFG.g = Gvis * Fc
+    float2 preDFG   = DFGMap.SampleLevel(DFGSmp, float2(NdotV, roughness), 0).xy;
+
+    // LD * (f0 * Gvis * (1 - Fc) + Gvis * Fc)
+    return preLD * (f0 * preDFG.x + preDFG.y);
+}
+
+
+
+//-----------------------------------------------------------------------------
+//      ピクセルシェーダのメインエントリーポイントです.
+//-----------------------------------------------------------------------------
+PSOutput main(VSOutput input)
+{
+    const float near = 0.1;
+    const float far = 30.0;
+    const float linerDepth = 1.0 / (far - near);
+    
+    PSOutput output = (PSOutput)0;
+
+    float3 V = normalize(input.WorldPos.xyz - CameraPosition);
+    float3 N = MaterialMaps[NormalIndex].Sample(MaterialSmp, input.TexCoord).xyz * 2.0f - 1.0f;
+    N = mul(input.InvTangentBasis, N);
+    float3 R = normalize(reflect(V, N));
+
+    
+    
+    
+    float NV = saturate(dot(N, V));
+
+    float3 baseColor = MaterialMaps[BaseColorIndex].Sample(MaterialSmp, input.TexCoord).rgb;
+    float  metallic  = MaterialMaps[MetallicIndex] .Sample(MaterialSmp, input.TexCoord).r;
+    float  roughness = MaterialMaps[RoughnessIndex].Sample(MaterialSmp, input.TexCoord).r;
+
+    float3 Kd = baseColor * (1.0f - metallic);
+    float3 Ks = baseColor * metallic;
+
+    float3 lit = 0;
+    lit += EvaluateIBLDiffuse(N) * Kd;
+    lit += EvaluateIBLSpecular(NV, N, R, Ks, roughness, TextureSize, MipCount);
+
+    // テスト用ライト
+    float4 TestCustomParam = GetMaterialParam(input.MaterialIndex, 0);
+    float3 TestLit = saturate(dot(N, normalize(LightDirection))) * TestCustomParam.xyz * LightIntensity;
+    
+    // Shadow
+    float Shadow        = EvaluateCascadeShadow(ShadowMap, ShadowSmp, input.WorldPos, CameraPosition);
+    
+    float3 lastLit = lit * LightIntensity * Shadow + TestLit;
+    
+    // Fog
+    float linerPos  = length(CameraPosition - input.WorldPos) * linerDepth;
+    float fogFactor = clamp((FogArea.y - linerPos) / (FogArea.y - FogArea.x), 0.0, 1.0);
+    
+    float3 Out = lerp(FogColor, lastLit, fogFactor);
+    
+    output.Color.rgb = Out;
+    output.Color.a   = 1.0f;
+    
+    return output;
+}
\ No newline at end of file
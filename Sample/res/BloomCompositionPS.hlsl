@@ -3,8 +3,8 @@
 ///////////////////////////////////////////////////////////////////////////////
 struct VSOutput
 {
-    float4 Position : SV_POSITION; // ʒuWł.
-    float2 TexCoord : TEXCOORD; // eNX`Wł.
+    float4 Position : SV_POSITION; // 位置座標です.
+    float2 TexCoord : TEXCOORD; // テクスチャ座標です.
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -6,7 +6,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 cbuffer CbCommon : register(b2)
 {
-    float3 CameraPosition   : packoffset(c0); // Jʒuł.
-    float2 FogArea          : packoffset(c1); // Fog̃X^[gʒuƃGhʒu
-    float3 FogColor         : packoffset(c2); // Fog̐F
+    float3 CameraPosition   : packoffset(c0); // カメラ位置です.
+    float2 FogArea          : packoffset(c1); // Fogのスタート位置とエンド位置
+    float3 FogColor         : packoffset(c2); // Fogの色
 }
\ No newline at end of file
@@ -8,13 +8,66 @@
 ///////////////////////////////////////////////////////////////////////////////
 cbuffer CbLight : register(b3)
 {
-    float       TextureSize         : packoffset(c0);       // eNX`TCYł.
-    float       MipCount            : packoffset(c0.y);     // ~bvJEgł.
-    float       LightIntensity      : packoffset(c0.z);     // Cgx(XP[l).
-    float3      LightDirection      : packoffset(c1);       // fBNViCg̕.
-    float4x4    LightVP             : packoffset(c2);       // CgVP
+    float       TextureSize         : packoffset(c0);       // テクスチャサイズです.
+    float       MipCount            : packoffset(c0.y);     // ミップカウントです.
+    float       LightIntensity      : packoffset(c0.z);     // ライト強度(スケール値).
+    float3      LightDirection      : packoffset(c1);       // ディレクショナルライトの方向.
+    float4x4    LightVP             : packoffset(c2);       // 最も手前のカスケードのライトVP.
     float       ShadowBias          : packoffset(c6);       // bias
-    float       ShadowStrength      : packoffset(c6.y);     // e̋
+    float       ShadowStrength      : packoffset(c6.y);     // 影の強さ
+    float       EnableIrradianceSH  : packoffset(c6.z);     // ディフューズIBLに球面調和関数を使うかどうか.
+    float4      IrradianceSH[9]     : packoffset(c7);       // 放射照度 / π の球面調和関数の係数(xyz = RGB).
+    float4x4    CascadeVP[4]        : packoffset(c16);      // カスケードごとのライトVP.
+    float4      CascadeSplits       : packoffset(c32);      // カスケードごとの奥側の分割位置(カメラからの奥行き).
+    float3      CameraForward       : packoffset(c33);      // 奥行きを求めるカメラの前方向.
+    float       CascadeCount        : packoffset(c33.w);    // カスケード数.
 };
 
+//-----------------------------------------------------------------------------
+//      球面調和関数からディフューズのLD項を求めます.
+//-----------------------------------------------------------------------------
+float3 EvaluateIrradianceSH(float3 N)
+{
+    // 係数はCPUでランバートの余弦ローブと畳み込み済みなので, 基底関数との内積のみ求めます.
+    float3 result = IrradianceSH[0].xyz * 0.282095f;
+    result += IrradianceSH[1].xyz * (0.488603f * N.y);
+    result += IrradianceSH[2].xyz * (0.488603f * N.z);
+    result += IrradianceSH[3].xyz * (0.488603f * N.x);
+    result += IrradianceSH[4].xyz * (1.092548f * N.x * N.y);
+    result += IrradianceSH[5].xyz * (1.092548f * N.y * N.z);
+    result += IrradianceSH[6].xyz * (0.315392f * (3.0f * N.z * N.z - 1.0f));
+    result += IrradianceSH[7].xyz * (1.092548f * N.x * N.z);
+    result += IrradianceSH[8].xyz * (0.546274f * (N.x * N.x - N.y * N.y));
+    return max(result, 0.0f);
+}
+
+//-----------------------------------------------------------------------------
+//      カスケードシャドウマップから影の係数を求めます.
+//-----------------------------------------------------------------------------
+float EvaluateCascadeShadow(Texture2D shadowMap, SamplerState shadowSmp, float3 worldPos, float3 cameraPos)
+{
+    // 分割位置はカメラからの奥行きなので, 視線方向の距離でカスケードを選びます.
+    float depth = dot(worldPos - cameraPos, CameraForward);
+    uint  count = (uint)CascadeCount;
+    if (count == 0 || depth > CascadeSplits[count - 1])
+    { return 1.0f; }
+
+    uint index = 0;
+    [unroll] for (uint i = 0; i < 3; ++i)
+    { index += (i + 1 < count && depth > CascadeSplits[i]) ? 1 : 0; }
+
+    float4 pos = mul(CascadeVP[index], float4(worldPos, 1.0f));
+    float2 uv  = float2(0.5f + 0.5f * pos.x, 0.5f - 0.5f * pos.y);
+
+    // アトラスは 2x2 のタイルなので, 隣のタイルを読まないよう半テクセル内側に収めます.
+    float width, height;
+    shadowMap.GetDimensions(width, height);
+    float2 border = float2(1.0f / width, 1.0f / height);
+    float2 tile   = float2(index & 1, index >> 1);
+    uv = (clamp(uv, border, 1.0f - border) + tile) * 0.5f;
+
+    float lightDist = shadowMap.Sample(shadowSmp, uv).r;
+    return (pos.z - ShadowBias < lightDist) ? 1.0f : ShadowStrength;
+}
+
 
@@ -3,11 +3,17 @@
 
 cbuffer CbLight : register(b2)
 {
-    float TextureSize : packoffset(c0);         // eNX`TCYł.
-    float MipCount : packoffset(c0.y);          // ~bvJEgł.
-    float LightIntensity : packoffset(c0.z);    // Cgx(XP[l).
-    float3 LightDirection : packoffset(c1);     // fBNViCg̕.
-    float4x4 LightVP : packoffset(c2);          // CgVP
+    float TextureSize : packoffset(c0);         // テクスチャサイズです.
+    float MipCount : packoffset(c0.y);          // ミップカウントです.
+    float LightIntensity : packoffset(c0.z);    // ライト強度(スケール値).
+    float3 LightDirection : packoffset(c1);     // ディレクショナルライトの方向.
+    float4x4 LightVP : packoffset(c2);          // 最も手前のカスケードのライトVP.
+    float4x4 CascadeVP[4] : packoffset(c16);    // カスケードごとのライトVP.
+};
+
+cbuffer CbCascade : register(b7)
+{
+    uint CascadeIndex;                          // 描画するカスケードの番号です.
 };
 
 
@@ -18,12 +24,12 @@ struct VS_INPUT
     float2 UV       : TEXCOORD;
 };
 
-//Vh[}bvvZp_VF[_
+//シャドーマップ計算用頂点シェーダ
 float4 main(VS_INPUT input) : SV_POSITION
 {
     float4 Pos = float4(input.Position, 1.0f);
     Pos = mul(World, Pos);
-    Pos = mul(LightVP, Pos);
+    Pos = mul(CascadeVP[CascadeIndex], Pos);
 
     return Pos;
 }
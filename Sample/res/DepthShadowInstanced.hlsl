@@ -0,0 +1,37 @@
+#include "VSCommonBuffer.hlsli"
+#include "InstanceData.hlsli"
+
+
+cbuffer CbLight : register(b2)
+{
+    float TextureSize : packoffset(c0);         // テクスチャサイズです.
+    float MipCount : packoffset(c0.y);          // ミップカウントです.
+    float LightIntensity : packoffset(c0.z);    // ライト強度(スケール値).
+    float3 LightDirection : packoffset(c1);     // ディレクショナルライトの方向.
+    float4x4 LightVP : packoffset(c2);          // 最も手前のカスケードのライトVP.
+    float4x4 CascadeVP[4] : packoffset(c16);    // カスケードごとのライトVP.
+};
+
+cbuffer CbCascade : register(b7)
+{
+    uint CascadeIndex;                          // 描画するカスケードの番号です.
+};
+
+
+struct VS_INPUT
+{
+    float3 Position   : POSITION;
+    float3 Normal     : NORMAL;
+    float2 UV         : TEXCOORD;
+    uint   InstanceId : SV_InstanceID;
+};
+
+//シャドーマップ計算用頂点シェーダ(インスタンス描画)
+float4 main(VS_INPUT input) : SV_POSITION
+{
+    float4 Pos = float4(input.Position, 1.0f);
+    Pos = mul(GetInstance(input.InstanceId).World, Pos);
+    Pos = mul(CascadeVP[CascadeIndex], Pos);
+
+    return Pos;
+}
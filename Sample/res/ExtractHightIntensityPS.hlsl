@@ -3,8 +3,8 @@
 ///////////////////////////////////////////////////////////////////////////////
 struct VSOutput
 {
-    float4 Position : SV_POSITION; // ʒuWł.
-    float2 TexCoord : TEXCOORD; // eNX`Wł.
+    float4 Position : SV_POSITION; // 位置座標です.
+    float2 TexCoord : TEXCOORD; // テクスチャ座標です.
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -20,7 +20,7 @@ cbuffer CbExt : register(b0)
 Texture2D ColorMap : register(t0);
 SamplerState ColorSmp : register(s0);
 
-// PxľvZ oWKv
+// 輝度値の計算 出展必要
 float GetLuminance(float3 color)
 {
     return dot(color, float3(0.299, 0.587, 0.114));
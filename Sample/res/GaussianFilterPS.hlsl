@@ -3,8 +3,8 @@
 ///////////////////////////////////////////////////////////////////////////////
 struct VSOutput
 {
-    float4 Position : SV_POSITION; // ʒuWł.
-    float2 TexCoord : TEXCOORD; // eNX`Wł.
+    float4 Position : SV_POSITION; // 位置座標です.
+    float2 TexCoord : TEXCOORD; // テクスチャ座標です.
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -36,7 +36,7 @@ float4 main(const VSOutput input) : SV_TARGET
     
     float3 col = float3(0.0,0.0,0.0);
     
-    // 
+    // 横
     
     col += ColorMap.Sample(ColorSmp, uv) * weight[0] * 2.0;
     
@@ -0,0 +1,33 @@
+#ifndef INSTANCE_DATA_HLSLI
+#define INSTANCE_DATA_HLSLI
+
+///////////////////////////////////////////////////////////////////////////////
+// InstanceData structure
+///////////////////////////////////////////////////////////////////////////////
+struct InstanceData
+{
+    float4x4 World;             // ワールド行列です.
+    uint     MaterialIndex;     // マテリアルパラメータブロックの番号です.
+    uint3    Reserved;          // 予約領域です.
+};
+
+// フレーム内の全インスタンス.
+StructuredBuffer<InstanceData> Instances : register(t11);
+
+///////////////////////////////////////////////////////////////////////////////
+// Instance offset constant (root constant).
+///////////////////////////////////////////////////////////////////////////////
+cbuffer CbInstanceOffset : register(b6)
+{
+    uint InstanceOffset;        // このドローの先頭インスタンス番号です.
+};
+
+//-----------------------------------------------------------------------------
+//      インスタンスデータを取得します.
+//-----------------------------------------------------------------------------
+InstanceData GetInstance(uint instanceId)
+{
+    return Instances[InstanceOffset + instanceId];
+}
+
+#endif//INSTANCE_DATA_HLSLI
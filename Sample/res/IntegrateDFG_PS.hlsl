@@ -21,7 +21,7 @@ struct VSOutput
 };
 
 //-----------------------------------------------------------------------------
-//      DFGϕ܂.
+//      DFG項を積分します.
 //-----------------------------------------------------------------------------
 float3 IntegrateDFG_Only(float NdotV, float roughness)
 {
@@ -57,7 +57,7 @@ float3 IntegrateDFG_Only(float NdotV, float roughness)
 }
 
 //-----------------------------------------------------------------------------
-//      CGg[|Cgł.
+//      メインエントリーポイントです.
 //-----------------------------------------------------------------------------
 float4 main(const VSOutput input) : SV_TARGET
 {
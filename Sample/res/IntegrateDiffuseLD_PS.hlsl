@@ -25,10 +25,10 @@ struct VSOutput
 ///////////////////////////////////////////////////////////////////////////////
 cbuffer CbBake : register(b0)
 {
-    int     FaceIndex : packoffset(c0);     // L[u}bv̖ʔԍ.
-    float   Roughness : packoffset(c0.y);   // `tlX.
-    float   Width     : packoffset(c0.z);   // ̓L[u}bṽTCY
-    float   MipCount  : packoffset(c0.w);   // ̓L[u}bṽ~bvx.
+    int     FaceIndex : packoffset(c0);     // キューブマップの面番号.
+    float   Roughness : packoffset(c0.y);   // 線形ラフネス.
+    float   Width     : packoffset(c0.z);   // 入力キューブマップのサイズ
+    float   MipCount  : packoffset(c0.w);   // 入力キューブマップのミップレベル数.
 };
 
 //-----------------------------------------------------------------------------
@@ -39,7 +39,7 @@ SamplerState IBLSmp  : register(s0);
 
 
 //-----------------------------------------------------------------------------
-//      fBt[YLDϕ܂.
+//      ディフューズのLD項を積分します.
 //-----------------------------------------------------------------------------
 float3 IntegrateDiffuseCube(in float3 N, in float width, in float mipCount)
 {
@@ -51,17 +51,17 @@ float3 IntegrateDiffuseCube(in float3 N, in float width, in float mipCount)
 
     for(uint i=0; i<SampleCount; ++i)
     {
-        // lz擾.
+        // 超一様分布列を取得.
         float2 u = Hammersley(i, SampleCount);
 
-        // BRDFɂƂÂd_TvO.
+        // BRDFにもとづく重点サンプリング.
         float3 L = SampleLambert(u, N);
 
         float NdotL = saturate(dot(N, L));
         if (NdotL > 0.0f)
         {
         #ifdef ENABLE_MIPMAP_FILTERING
-            // ~bv}bvtB^d_TvO.
+            // ミップマップフィルタ重点サンプリング.
             float pdf      = NdotL / F_PI;
             float omegaS   = 1.0f / max(SampleCount * pdf, 1e-8f);
             float l        = 0.5f * (log2(omegaS) - log2(omegaP)) + bias;
@@ -83,7 +83,7 @@ float3 IntegrateDiffuseCube(in float3 N, in float width, in float mipCount)
 }
 
 //-----------------------------------------------------------------------------
-//      CGg[|Cgł.
+//      メインエントリーポイントです.
 //-----------------------------------------------------------------------------
 float4 main(const VSOutput input) : SV_TARGET
 {
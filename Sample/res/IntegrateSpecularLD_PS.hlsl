@@ -25,10 +25,10 @@ struct VSOutput
 ///////////////////////////////////////////////////////////////////////////////
 cbuffer CbBake : register(b0)
 {
-    int     FaceIndex : packoffset(c0);     // o̓L[u}bv̖ʔԍ.
-    float   Roughness : packoffset(c0.y);   // tlX(= `tlX^2).
-    float   Width     : packoffset(c0.z);   // ̓L[u}bṽTCY.
-    float   MipCount  : packoffset(c0.w);   // ̓L[u}bṽ~bvx.
+    int     FaceIndex : packoffset(c0);     // 出力キューブマップの面番号.
+    float   Roughness : packoffset(c0.y);   // ラフネス(= 線形ラフネス^2).
+    float   Width     : packoffset(c0.z);   // 入力キューブマップのサイズ.
+    float   MipCount  : packoffset(c0.w);   // 入力キューブマップのミップレベル数.
 };
 
 //-----------------------------------------------------------------------------
@@ -39,7 +39,7 @@ SamplerState IBLSmp  : register(s0);
 
 
 //-----------------------------------------------------------------------------
-//      XyL[LDϕ܂.
+//      スペキュラーのLD項を積分します.
 //-----------------------------------------------------------------------------
 float3 IntegrateSpecularCube
 (
@@ -58,20 +58,20 @@ float3 IntegrateSpecularCube
 
     for(uint i=0; i<SampleCount; ++i)
     {
-        // lz擾.
+        // 超一様分布列を取得.
         float2 u = Hammersley(i, SampleCount);
 
-        // BRDFɂƂÂd_TvO.
+        // BRDFにもとづく重点サンプリング.
         float3 H = SampleGGX(u, a, N);
 
-        // CgxNg߂.
+        // ライトベクトルを求める.
         float3 L = normalize(2 * dot( V, H ) * H - V);
 
         float NdotL = saturate(dot(N, L));
         if (NdotL > 0)
         {
         #ifdef ENABLE_MIPMAP_FILTERING
-            // ~bv}bvtB^d_TvO.
+            // ミップマップフィルタ重点サンプリング.
             float pdf      = D_GGX(NdotL, a) * NdotL;
             float omegaS   = 1.0f / max(SampleCount * pdf, 1e-8f);
             float l        = 0.5f * (log2(omegaS) - log2(omegaP)) + bias;
@@ -93,7 +93,7 @@ float3 IntegrateSpecularCube
 }
 
 //-----------------------------------------------------------------------------
-//      CGg[|Cgł.
+//      メインエントリーポイントです.
 //-----------------------------------------------------------------------------
 float4 main(const VSOutput input) : SV_TARGET
 {
@@ -0,0 +1,32 @@
+#ifndef MATERIAL_PARAM_HLSLI
+#define MATERIAL_PARAM_HLSLI
+
+///////////////////////////////////////////////////////////////////////////////
+// MaterialParamBlock structure
+///////////////////////////////////////////////////////////////////////////////
+struct MaterialParamBlock
+{
+    float4 Param[16];   // マテリアルインスタンスの解決済みパラメータです.
+};
+
+// 全インスタンスのパラメータブロック.
+StructuredBuffer<MaterialParamBlock> MaterialParams : register(t10);
+
+///////////////////////////////////////////////////////////////////////////////
+// Material instance constant (root constant).
+///////////////////////////////////////////////////////////////////////////////
+cbuffer CbMaterialInstance : register(b5)
+{
+    uint MaterialIndex;     // パラメータブロックの番号です.
+};
+
+//-----------------------------------------------------------------------------
+//      マテリアルパラメータを取得します.
+//      インスタンス描画では頂点シェーダから渡された番号を使用します.
+//-----------------------------------------------------------------------------
+float4 GetMaterialParam(uint materialIndex, uint slot)
+{
+    return MaterialParams[materialIndex].Param[slot];
+}
+
+#endif//MATERIAL_PARAM_HLSLI
@@ -11,10 +11,10 @@ cbuffer CbPreNormal : register(b0)
 ///////////////////////////////////////////////////////////////////////////////
 struct VSOutput
 {
-    float4      Position        : SV_POSITION; // ʒuWł.
-    float2      TexCoord        : TEXCOORD; // eNX`Wł.
-    float3      WorldPos        : WORLD_POS; // [hԂ̈ʒuWł.
-    float3x3    InvTangentBasis : INV_TANGENT_BASIS; // ڐԂւ̊ϊs̋tsł.
+    float4      Position        : SV_POSITION; // 位置座標です.
+    float2      TexCoord        : TEXCOORD; // テクスチャ座標です.
+    float3      WorldPos        : WORLD_POS; // ワールド空間の位置座標です.
+    float3x3    InvTangentBasis : INV_TANGENT_BASIS; // 接線空間への基底変換行列の逆行列です.
     float3      WorldNormal     : TEXCOORD1;
 };
 
@@ -23,12 +23,12 @@ struct VSOutput
 ///////////////////////////////////////////////////////////////////////////////
 struct PSOutput
 {
-    float4 Color : SV_TARGET0; // o̓J[ł.
+    float4 Color : SV_TARGET0; // 出力カラーです.
 };
 
 
 //-----------------------------------------------------------------------------
-//      sNZVF[_̃CGg[|Cgł.
+//      ピクセルシェーダのメインエントリーポイントです.
 //-----------------------------------------------------------------------------
 PSOutput main(VSOutput input)
 {
@@ -5,10 +5,10 @@
 ///////////////////////////////////////////////////////////////////////////////
 struct VSInput
 {
-    float3 Position : POSITION; // ʒuWł.
-    float3 Normal : NORMAL; // @xNgł.
-    float2 TexCoord : TEXCOORD; // eNX`Wł.
-    float3 Tangent : TANGENT; // ڐxNgł.
+    float3 Position : POSITION; // 位置座標です.
+    float3 Normal : NORMAL; // 法線ベクトルです.
+    float2 TexCoord : TEXCOORD; // テクスチャ座標です.
+    float3 Tangent : TANGENT; // 接線ベクトルです.
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -16,16 +16,16 @@ struct VSInput
 ///////////////////////////////////////////////////////////////////////////////
 struct VSOutput
 {
-    float4 Position             : SV_POSITION;  // ʒuWł.
-    float2 TexCoord             : TEXCOORD;     // eNX`Wł.
-    float3 WorldPos             : WORLD_POS;    // [hԂ̈ʒuWł.
-    float3x3 InvTangentBasis    : INV_TANGENT_BASIS; // ڐԂւ̊ϊs̋tsł.
+    float4 Position             : SV_POSITION;  // 位置座標です.
+    float2 TexCoord             : TEXCOORD;     // テクスチャ座標です.
+    float3 WorldPos             : WORLD_POS;    // ワールド空間の位置座標です.
+    float3x3 InvTangentBasis    : INV_TANGENT_BASIS; // 接線空間への基底変換行列の逆行列です.
     float3 WorldNormal          : TEXCOORD1;
 };
 
 
 //-----------------------------------------------------------------------------
-//      _VF[_̃CGg[|Cgł.
+//      頂点シェーダのメインエントリーポイントです.
 //-----------------------------------------------------------------------------
 VSOutput main(VSInput input)
 {
@@ -43,12 +43,12 @@ VSOutput main(VSInput input)
     output.WorldPos = worldPos.xyz;
     output.WorldNormal = worldNormal.xyz;
     
-    // xNg
+    // 基底ベクトル
     float3 N = normalize(mul((float3x3) World, input.Normal));
     float3 T = normalize(mul((float3x3) World, input.Tangent));
     float3 B = normalize(cross(N, T));
 
-    // ϊs̋ts.
+    // 基底変換行列の逆行列.
     output.InvTangentBasis = transpose(float3x3(T, B, N));
 
     return output;
@@ -20,7 +20,7 @@ TextureCube  CubeMap : register(t0);
 SamplerState CubeSmp : register(s0);
 
 //-----------------------------------------------------------------------------
-//      CGg[|Cgł.
+//      メインエントリーポイントです.
 //-----------------------------------------------------------------------------
 float4 main(const VSOutput input) : SV_TARGET0
 {
@@ -32,7 +32,7 @@ cbuffer CbSkyBox : register(b0)
 }
 
 //-----------------------------------------------------------------------------
-//      CGg[|Cgł.
+//      メインエントリーポイントです.
 //-----------------------------------------------------------------------------
 VSOutput main(const VSInput input)
 {
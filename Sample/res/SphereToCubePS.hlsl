@@ -20,10 +20,10 @@ Texture2D       SphereMap : register(t0);
 SamplerState    SphereSmp : register(s0);
 
 //-----------------------------------------------------------------------------
-//      CGg[|Cgł.
+//      メインエントリーポイントです.
 //-----------------------------------------------------------------------------
 float4 main(const VSOutput input) : SV_TARGET0
 {
-    // XtBA}bvTv܂.
+    // スフィアマップをサンプルします.
     return SphereMap.SampleLevel(SphereSmp, input.TexCoord, 0.0f);
 }
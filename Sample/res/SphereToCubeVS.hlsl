@@ -33,7 +33,7 @@ cbuffer CbTransform : register(b0)
 };
 
 //-----------------------------------------------------------------------------
-//      CGg[|Cgł.
+//      メインエントリーポイントです.
 //-----------------------------------------------------------------------------
 VSOutput main(const VSInput input)
 {
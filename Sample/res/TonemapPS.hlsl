@@ -20,8 +20,8 @@ static const int TONEMAP_GT       = 2;
 ///////////////////////////////////////////////////////////////////////////////
 struct VSOutput
 {
-    float4 Position : SV_POSITION;      // ʒuWł.
-    float2 TexCoord : TEXCOORD;         // eNX`Wł.
+    float4 Position : SV_POSITION;      // 位置座標です.
+    float2 TexCoord : TEXCOORD;         // テクスチャ座標です.
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -29,10 +29,10 @@ struct VSOutput
 ///////////////////////////////////////////////////////////////////////////////
 cbuffer CbTonemap : register(b0)
 {
-    int     TonemapType;    // g[}bṽ^Cvł.
-    int     ColorSpace;     // o͐FԂł.
-    float   BaseLuminance;  // Pxlł(Pʂ[nit]).
-    float   MaxLuminance;   // őPxlł(Pʂ[nit]).
+    int     TonemapType;    // トーンマップのタイプです.
+    int     ColorSpace;     // 出力色空間です.
+    float   BaseLuminance;  // 基準輝度値です(単位は[nit]).
+    float   MaxLuminance;   // 最大輝度値です(単位は[nit]).
 };
 
 //-----------------------------------------------------------------------------
@@ -43,7 +43,7 @@ SamplerState    ColorSmp : register(s0);
 
 
 //-----------------------------------------------------------------------------
-//      Fϊs܂.
+//      色域変換を行います.
 //-----------------------------------------------------------------------------
 float4 ColorSpaceConvert(float4 color)
 {
@@ -54,7 +54,7 @@ float4 ColorSpaceConvert(float4 color)
     // ITU-R BT.709
     case COLOR_SPACE_BT709:
         {
-            // ]ʂĈ܂܏o͂܂.
+            // 従来通り，そのまま出力します.
             result = color;
         }
         break;
@@ -78,7 +78,7 @@ float4 ColorSpaceConvert(float4 color)
 }
 
 //-----------------------------------------------------------------------------
-//      Reinhardg[}bvKp܂.
+//      Reinhardトーンマップを適用します.
 //-----------------------------------------------------------------------------
 float3 ReinhardTonemap(float3 color)
 {
@@ -88,13 +88,13 @@ float3 ReinhardTonemap(float3 color)
 }
 
 //-----------------------------------------------------------------------------
-//      GTg[}bvKp܂.
+//      GTトーンマップを適用します.
 //-----------------------------------------------------------------------------
 float3 GtTonemap(float3 color)
 {
     float k = MaxLuminance / BaseLuminance;
 
-    // p[^.
+    // 制御パラメータ.
     float P = k;
     float a = 1.0f;
     float m = 0.22f;
@@ -122,7 +122,7 @@ float3 GtTonemap(float3 color)
 }
 
 //-----------------------------------------------------------------------------
-//      ITU-R BT.709 OETFKp܂.
+//      ITU-R BT.709 OETFを適用します.
 //-----------------------------------------------------------------------------
 float3 OETF_BT709(float3 color)
 {
@@ -134,7 +134,7 @@ float3 OETF_BT709(float3 color)
 }
 
 //-----------------------------------------------------------------------------
-//      ITU-R BT.2100 PQ System OETFKp܂.
+//      ITU-R BT.2100 PQ System OETFを適用します.
 //-----------------------------------------------------------------------------
 float3 OETF_BT2100_PQ(float3 color)
 {
@@ -148,7 +148,7 @@ float3 OETF_BT2100_PQ(float3 color)
 }
 
 //-----------------------------------------------------------------------------
-//      g[}bsOs܂.
+//      トーンマッピングを行います.
 //-----------------------------------------------------------------------------
 float4 Tonemapping(float4 color)
 {
@@ -156,17 +156,17 @@ float4 Tonemapping(float4 color)
 
     switch (TonemapType)
     {
-    // g[}bvȂ.
+    // トーンマップなし.
     case TONEMAP_NONE:
         result.rgb = color.rgb;
         break;
 
-    // Reinhardg[}bv.
+    // Reinhardトーンマップ.
     case TONEMAP_REINHARD:
         result.rgb = ReinhardTonemap(color.rgb);
         break;
 
-    // GTg[}bv.
+    // GTトーンマップ.
     case TONEMAP_GT:
         result.rgb = GtTonemap(color.rgb);
         break;
@@ -176,7 +176,7 @@ float4 Tonemapping(float4 color)
 }
 
 //-----------------------------------------------------------------------------
-//      OETF(Opt Electronic Transfer Function)Kp܂.
+//      OETF(Opt Electronic Transfer Function)を適用します.
 //-----------------------------------------------------------------------------
 float4 ApplyOETF(float4 color)
 {
@@ -199,20 +199,20 @@ float4 ApplyOETF(float4 color)
 }
 
 //-----------------------------------------------------------------------------
-//      CGg[|Cgł.
+//      メインエントリーポイントです.
 //-----------------------------------------------------------------------------
 float4 main(const VSOutput input) : SV_TARGET0
 {
-    // eNX`J[擾.
+    // テクスチャカラーを取得.
     float4 result = ColorMap.Sample(ColorSmp, input.TexCoord);
 
-    // FԂϊ.
+    // 色空間を変換.
     result = ColorSpaceConvert(result);
 
-    // g[}bsO.
+    // トーンマッピング.
     result = Tonemapping(result);
 
-    // OETFKp.
+    // OETF適用.
     result = ApplyOETF(result);
 
     return result;
@@ -7,8 +7,8 @@
 ///////////////////////////////////////////////////////////////////////////////
 cbuffer CbTransform : register(b0)
 {
-    float4x4 View : packoffset(c0);     // r[sł.
-    float4x4 Proj : packoffset(c4);     // ˉesł.
+    float4x4 View : packoffset(c0);     // ビュー行列です.
+    float4x4 Proj : packoffset(c4);     // 射影行列です.
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -16,5 +16,5 @@ cbuffer CbTransform : register(b0)
 ///////////////////////////////////////////////////////////////////////////////
 cbuffer CbMesh : register(b1)
 {
-    float4x4 World : packoffset(c0);    // [hsł.
+    float4x4 World : packoffset(c0);    // ワールド行列です.
 };
\ No newline at end of file
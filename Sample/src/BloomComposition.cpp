@@ -47,7 +47,7 @@ bool BloomComposition::CreatePipeLineState(ComPtr<ID3D12Device> pDevice, DXGI_FO
 		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 	};
 
-	// OtBbNXpCvCXe[gݒ.
+	// グラフィックスパイプラインステートを設定.
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
 	desc.InputLayout                        = { elements, 2 };
 	desc.pRootSignature                     = m_RootSig.GetPtr();
@@ -62,7 +62,7 @@ bool BloomComposition::CreatePipeLineState(ComPtr<ID3D12Device> pDevice, DXGI_FO
 	desc.SampleDesc.Count                   = 1;
 	desc.SampleDesc.Quality                 = 0;
 
-	// pCvCXe[g𐶐.
+	// パイプラインステートを生成.
 	if (!CreateGraphicsPipelineState(pDevice, desc, m_pPSO))return false;
 
 	return true;
@@ -81,31 +81,26 @@ void BloomComposition::Term()
 
 void BloomComposition::Draw(ID3D12GraphicsCommandList* pCmd, int frameindex, DrawSource& s)
 {
-	DirectX::TransitionResource(pCmd,
-		s.ColorDest.GetResource(),
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
-		D3D12_RESOURCE_STATE_RENDER_TARGET);
-
-	// fBXNv^擾.
+	// ディスクリプタ取得.
 	auto handleRTV = s.ColorDest.GetHandleRTV();
 
-	// _[^[Qbgݒ.
+	// レンダーターゲットを設定.
 	pCmd->OMSetRenderTargets(1, &handleRTV->HandleCPU, FALSE, nullptr);
 
-	// _[^[QbgNA.
+	// レンダーターゲットをクリア.
 	s.ColorDest.ClearView(pCmd);
 
-	// 萔obt@XV
+	// 定数バッファ更新
 
 	pCmd->SetGraphicsRootSignature(m_RootSig.GetPtr());
 	pCmd->SetGraphicsRootDescriptorTable(0, m_CB[frameindex].GetHandleGPU());
 	pCmd->SetGraphicsRootDescriptorTable(1, s.ColorBaseSources.GetHandleSRV()->HandleGPU);
 
 
-	pCmd->SetGraphicsRootDescriptorTable(2, s.ColorSources[0].GetHandleSRV()->HandleGPU);
-	pCmd->SetGraphicsRootDescriptorTable(3, s.ColorSources[1].GetHandleSRV()->HandleGPU);
-	pCmd->SetGraphicsRootDescriptorTable(4, s.ColorSources[2].GetHandleSRV()->HandleGPU);
-	pCmd->SetGraphicsRootDescriptorTable(5, s.ColorSources[3].GetHandleSRV()->HandleGPU);
+	pCmd->SetGraphicsRootDescriptorTable(2, s.ColorSources[0]->GetHandleSRV()->HandleGPU);
+	pCmd->SetGraphicsRootDescriptorTable(3, s.ColorSources[1]->GetHandleSRV()->HandleGPU);
+	pCmd->SetGraphicsRootDescriptorTable(4, s.ColorSources[2]->GetHandleSRV()->HandleGPU);
+	pCmd->SetGraphicsRootDescriptorTable(5, s.ColorSources[3]->GetHandleSRV()->HandleGPU);
 
 	pCmd->SetPipelineState(m_pPSO.Get());
 
@@ -113,12 +108,5 @@ void BloomComposition::Draw(ID3D12GraphicsCommandList* pCmd, int frameindex, Dra
 	pCmd->IASetVertexBuffers(0, 1, &s.VertexBuffer.GetView());
 
 	pCmd->DrawInstanced(3, 1, 0, 0);
-
-	// \p\[XoAݒ.
-	DirectX::TransitionResource(pCmd,
-		s.ColorDest.GetResource(),
-		D3D12_RESOURCE_STATE_RENDER_TARGET,
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-
 }
 
@@ -22,21 +22,16 @@ void ExtractHightIntensity::Term()
 
 void ExtractHightIntensity::Draw(ID3D12GraphicsCommandList* pCmd, int frameindex, DrawSource& s)
 {
-	DirectX::TransitionResource(pCmd,
-		s.ColorDest.GetResource(),
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
-		D3D12_RESOURCE_STATE_RENDER_TARGET);
-
-	// fBXNv^擾.
+	// ディスクリプタ取得.
 	auto handleRTV = s.ColorDest.GetHandleRTV();
 
-	// _[^[Qbgݒ.
+	// レンダーターゲットを設定.
 	pCmd->OMSetRenderTargets(1, &handleRTV->HandleCPU, FALSE, nullptr);
 
-	// _[^[QbgNA.
+	// レンダーターゲットをクリア.
 	s.ColorDest.ClearView(pCmd);
 
-	// 萔obt@XV
+	// 定数バッファ更新
 
 	pCmd->SetGraphicsRootSignature(m_RootSig.GetPtr());
 	pCmd->SetGraphicsRootDescriptorTable(0, m_CB[frameindex].GetHandleGPU());
@@ -47,12 +42,6 @@ void ExtractHightIntensity::Draw(ID3D12GraphicsCommandList* pCmd, int frameindex
 	pCmd->IASetVertexBuffers(0, 1, &s.VertexBuffer.GetView());
 
 	pCmd->DrawInstanced(3, 1, 0, 0);
-
-	// \p\[XoAݒ.
-	DirectX::TransitionResource(pCmd,
-		s.ColorDest.GetResource(),
-		D3D12_RESOURCE_STATE_RENDER_TARGET,
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 }
 
 bool ExtractHightIntensity::CreateRootSig(ComPtr<ID3D12Device> pDevice)
@@ -88,7 +77,7 @@ bool ExtractHightIntensity::CreatePipeLineState(ComPtr<ID3D12Device> pDevice, DX
 		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 	};
 
-	// OtBbNXpCvCXe[gݒ.
+	// グラフィックスパイプラインステートを設定.
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
 	desc.InputLayout                        = { elements, 2 };
 	desc.pRootSignature                     = m_RootSig.GetPtr();
@@ -103,7 +92,7 @@ bool ExtractHightIntensity::CreatePipeLineState(ComPtr<ID3D12Device> pDevice, DX
 	desc.SampleDesc.Count                   = 1;
 	desc.SampleDesc.Quality                 = 0;
 
-	// pCvCXe[g𐶐.
+	// パイプラインステートを生成.
 	if (!CreateGraphicsPipelineState(pDevice, desc, m_pPSO))return false;
 
 	return true;
@@ -28,21 +28,16 @@ void GaussianFilter::Term()
 
 void GaussianFilter::Draw(ID3D12GraphicsCommandList* pCmd, int frameindex, DrawSource& s)
 {
-	DirectX::TransitionResource(pCmd,
-		s.ColorDest.GetResource(),
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
-		D3D12_RESOURCE_STATE_RENDER_TARGET);
-
-	// fBXNv^擾.
+	// ディスクリプタ取得.
 	auto handleRTV = s.ColorDest.GetHandleRTV();
 
-	// _[^[Qbgݒ.
+	// レンダーターゲットを設定.
 	pCmd->OMSetRenderTargets(1, &handleRTV->HandleCPU, FALSE, nullptr);
 
-	// _[^[QbgNA.
+	// レンダーターゲットをクリア.
 	s.ColorDest.ClearView(pCmd);
 
-	// 萔obt@XV
+	// 定数バッファ更新
 	{
 		auto ptr = m_SCB[s.index][frameindex].GetPtr<CbGaussianFilter>();
 		ptr->ReductionRatio = s.ReductionRatio;
@@ -57,12 +52,6 @@ void GaussianFilter::Draw(ID3D12GraphicsCommandList* pCmd, int frameindex, DrawS
 	pCmd->IASetVertexBuffers(0, 1, &s.VertexBuffer.GetView());
 
 	pCmd->DrawInstanced(3, 1, 0, 0);
-
-	// \p\[XoAݒ.
-	DirectX::TransitionResource(pCmd,
-		s.ColorDest.GetResource(),
-		D3D12_RESOURCE_STATE_RENDER_TARGET,
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 }
 
 bool GaussianFilter::CreateRootSig(ComPtr<ID3D12Device> pDevice)
@@ -98,7 +87,7 @@ bool GaussianFilter::CreatePipeLineState(ComPtr<ID3D12Device> pDevice, DXGI_FORM
 	};
 
 
-	// OtBbNXpCvCXe[gݒ.
+	// グラフィックスパイプラインステートを設定.
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc     = {};
 	desc.InputLayout                            = { elements, 2 };
 	desc.pRootSignature                         = m_RootSig.GetPtr();
@@ -115,7 +104,7 @@ bool GaussianFilter::CreatePipeLineState(ComPtr<ID3D12Device> pDevice, DXGI_FORM
 	desc.SampleDesc.Count                       = 1;
 	desc.SampleDesc.Quality                     = 0;
 
-	// pCvCXe[g𐶐.
+	// パイプラインステートを生成.
 	if (!CreateGraphicsPipelineState(pDevice, desc, m_pPSO))return false;
 
 	return true;
@@ -22,23 +22,18 @@ void PreNormalRenderer::Term()
 
 void PreNormalRenderer::Draw(ID3D12GraphicsCommandList* pCmd, int frameindex, DrawSource& s)
 {
-	DirectX::TransitionResource(pCmd,
-		s.ColorDest.GetResource(),
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
-		D3D12_RESOURCE_STATE_RENDER_TARGET);
-
-	// fBXNv^擾.
+	// ディスクリプタ取得.
 	auto handleRTV = s.ColorDest.GetHandleRTV();
 	auto handleDSV = s.DepthDest.GetHandleDSV();
 
-	// _[^[Qbgݒ.
+	// レンダーターゲットを設定.
 	pCmd->OMSetRenderTargets(1, &handleRTV->HandleCPU, FALSE, &handleDSV->HandleCPU);
 
-	// _[^[QbgNA.
+	// レンダーターゲットをクリア.
 	s.ColorDest.ClearView(pCmd);
 	s.DepthDest.ClearView(pCmd);
 
-	// 萔obt@XV
+	// 定数バッファ更新
 	//
 	//
 	//
@@ -56,11 +51,6 @@ void PreNormalRenderer::Draw(ID3D12GraphicsCommandList* pCmd, int frameindex, Dr
 		g->m_Model.DrawModelRaw(pCmd, frameindex);
 	}
 
-	// \p\[XoAݒ.
-	DirectX::TransitionResource(pCmd,
-		s.ColorDest.GetResource(),
-		D3D12_RESOURCE_STATE_RENDER_TARGET,
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 }
 
 bool PreNormalRenderer::CreateRootSig(ComPtr<ID3D12Device> pDevice)
@@ -97,7 +87,7 @@ bool PreNormalRenderer::CreatePipeLineState(ComPtr<ID3D12Device> pDevice, DXGI_F
 		{ "TANGENT",  0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
 	};
 
-	// OtBbNXpCvCXe[gݒ.
+	// グラフィックスパイプラインステートを設定.
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
 	desc.InputLayout                        = { elements, _countof(elements) };
 	desc.pRootSignature                     = m_RootSig.GetPtr();
@@ -114,7 +104,7 @@ bool PreNormalRenderer::CreatePipeLineState(ComPtr<ID3D12Device> pDevice, DXGI_F
 	desc.SampleDesc.Count                   = 1;
 	desc.SampleDesc.Quality                 = 0;
 
-	// pCvCXe[g𐶐.
+	// パイプラインステートを生成.
 	if (!CreateGraphicsPipelineState(pDevice, desc, m_pPSO))return false;
 
 	return true;
@@ -16,7 +16,12 @@
 #include "CommonBufferManager.h"
 #include <ResourceManager.h>
 #include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <memory>
 #include <cmath>
+#include <chrono>
+#include <thread>
 //-----------------------------------------------------------------------------
 // Using Statements
 //-----------------------------------------------------------------------------
@@ -66,8 +71,11 @@ bool SampleApp::OnInit()
 
 	// GameObject/Model
 	AppResourceManager& manager = AppResourceManager::GetInstance();
-	ModelShader* ptr                 = new BasicShader();
-	ptr->Init(m_pDevice, m_CommonRTManager.m_SceneColorTarget.GetRTVDesc().Format, m_DepthTarget.GetDSVDesc().Format);
+	// 対応していればマテリアルテクスチャをバインドレスで参照する.
+	ModelShader* ptr = nullptr;
+	if (BindlessShader::IsSupported(m_pDevice.Get()))	ptr = new BindlessShader();
+	else												ptr = new BasicShader();
+	ptr->Init(m_pDevice, DXGI_FORMAT_R10G10B10A2_UNORM, m_DepthTarget.GetDSVDesc().Format);
 	manager.AddShader(L"basic", ptr);
 
 	const std::vector<std::wstring> path= {
@@ -79,22 +87,43 @@ bool SampleApp::OnInit()
 		
 	// matball
 	g = new GameObject();
-	if (!g->m_Model.LoadModel(path[0] , m_pDevice, m_pPool[POOL_TYPE_RES], m_pQueue)) return false;
+	if (!g->m_Model.LoadModel(path[0], m_pDevice, m_pPool[POOL_TYPE_RES], m_pQueue, &m_MaterialParamBuffer)) return false;
 	m_GameObjects.push_back(g);
 	
 	// teapot
 	g = new GameObject();
-	if (!g->m_Model.LoadModel(path[1], m_pDevice, m_pPool[POOL_TYPE_RES], m_pQueue)) return false;
+	if (!g->m_Model.LoadModel(path[1], m_pDevice, m_pPool[POOL_TYPE_RES], m_pQueue, &m_MaterialParamBuffer)) return false;
 	g->Transform().SetPosition({ 1.0f,0.0f,0.0f });
 	m_GameObjects.push_back(g);
 
 	// cube
 	g = new GameObject();
-	if (!g->m_Model.LoadModel(path[2], m_pDevice, m_pPool[POOL_TYPE_RES], m_pQueue)) return false;
+	if (!g->m_Model.LoadModel(path[2], m_pDevice, m_pPool[POOL_TYPE_RES], m_pQueue, &m_MaterialParamBuffer)) return false;
 	g->Transform().SetPosition({0.0f,-0.4f,0.0f});
 	g->Transform().SetScale({ 20.0f,0.1f,20.0f });
 	m_GameObjects.push_back(g);
 
+	// 三角形数が少ないモデルを遮蔽物にする.
+	m_Occluders.resize(m_GameObjects.size());
+	for (size_t i = 0; i < m_GameObjects.size(); i++) {
+		OcclusionCuller::BuildOccluder(manager.GetResMesh(m_GameObjects[i]->m_Model.m_ModelPath), OccluderMaxTriangles, m_Occluders[i]);
+	}
+
+	const uint32_t threadCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+	if (!m_OcclusionCuller.Init(OcclusionWidth, OcclusionHeight, threadCount)) return false;
+	if (!m_JobSystem.Init()) return false;
+	if (!m_CommandListPool.Init(m_pDevice.Get(), D3D12_COMMAND_LIST_TYPE_DIRECT, FrameCount, m_JobSystem.GetWorkerCount())) return false;
+	if (!m_GpuProfiler.Init(m_pDevice.Get(), m_pQueue.Get(), FrameCount, GpuProfilerMaxScopes)) return false;
+	Profiler::GetInstance().SetThreadName("Main");
+
+	m_StressRoot = m_Hierarchy.Create();
+	m_Systems.Add("Transform", SystemScheduler::PHASE_TRANSFORM, SceneSystems::UpdateWorldTransforms);
+	m_Systems.Add("Hierarchy", SystemScheduler::PHASE_TRANSFORM, [this](EntityRegistry&, float) {
+		m_HierarchyRecomputed = m_Hierarchy.Update();
+	});
+
+	// 起動時に生成するパイプラインステートは揃ったので, 次回の起動に備えて保存する.
+	PipelineCache::GetInstance().Save();
 
 	return true;
 }
@@ -103,11 +132,21 @@ bool SampleApp::CommonInit() {
 
 	const std::wstring skyPath = L"../res/texture/hdr014.dds";
 	
+	// アーカイブが無ければ個別のファイルから読み込む.
+	ShaderLibrary::GetInstance().MountArchive(L"ShaderLibrary.bin");
+	if (!PipelineCache::GetInstance().Init(m_pDevice.Get(), L"PipelineCache.bin"))                                                              return false;
+	if (!FallbackTexture::GetInstance().Init(m_pDevice.Get(), m_pPool[POOL_TYPE_RES], m_pQueue.Get()))                                          return false;
+	if (!m_MaterialParamBuffer.Init(m_pDevice.Get(), m_pPool[POOL_TYPE_RES], MaterialParamCapacity))                                          return false;
+	if (!m_InstanceBuffer.Init(m_pDevice.Get(), m_pPool[POOL_TYPE_RES], InstanceCapacity))                                                    return false;
 	if (!m_CommonBufferManager.Init(m_pDevice.Get(), m_pPool[POOL_TYPE_RES], m_Width, m_Height))                                                return false;
-	if (!m_CommonRTManager.Init(m_pDevice.Get(), m_pPool[POOL_TYPE_RTV], m_pPool[POOL_TYPE_RES], m_pPool[POOL_TYPE_DSV], m_Width, m_Height))    return false;
+	if (!m_CommonRTManager.Init(m_pDevice.Get(), m_pPool[POOL_TYPE_RTV], m_pPool[POOL_TYPE_RES], m_pPool[POOL_TYPE_DSV], m_Width, m_Height, ShadowTileSize * CascadedShadow::AtlasTileCount))    return false;
 	if (!m_SkyManager.Init(m_pDevice, m_pPool[POOL_TYPE_RTV], m_pPool[POOL_TYPE_RES], m_pQueue, skyPath)) return false;
+	if (!m_GraphResources.Init(m_pDevice.Get(), m_pPool[POOL_TYPE_RTV], m_pPool[POOL_TYPE_DSV], m_pPool[POOL_TYPE_RES]))                      return false;
+	if (!RebuildRenderGraph())                                                                                                                  return false;
 
 	m_CommonBufferManager.SetRTManager(&m_CommonRTManager);
+	m_RenderQueue.SetInstanceBuffer(&m_InstanceBuffer);
+	return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -120,12 +159,34 @@ void SampleApp::OnTerm()
 		g->m_Model.Release();
 	}
 	m_GameObjects.clear();
-
+	m_SceneBVH.Clear();
+	m_BVHProxies.clear();
+	m_OcclusionCuller.Term();
+	m_Occluders.clear();
+	m_Systems.Clear();
+	m_Registry.Clear();
+	m_StressEntities.clear();
+	m_Hierarchy.Clear();
+	m_StressRoot = TransformHierarchy::NullNode;
+	m_Recorder.Clear();
+	m_CommandListPool.Term();
+	m_GpuProfiler.Term();
+	m_JobSystem.Term();
+
+	m_RenderQueue.SetInstanceBuffer(nullptr);
+	m_InstanceBuffer.Term();
+	m_MaterialParamBuffer.Term();
 	m_ToneMap.Term();
 	m_ShadowMap.Term();
 	m_CommonBufferManager.Term();
+	m_GraphResources.Term();
+	m_RenderGraph.Clear();
 	m_CommonRTManager.Term();
 	m_SkyManager.Term();
+	FallbackTexture::GetInstance().Term();
+	PipelineCache::GetInstance().Save();
+	PipelineCache::GetInstance().Term();
+	ShaderLibrary::GetInstance().Term();
 }
 
 void SampleApp::OnRenderIMGUI() {
@@ -174,10 +235,9 @@ void SampleApp::OnRenderIMGUI() {
 			ImGui::InputFloat("ShadowBias",		&m_ShadowBias);
 			ImGui::InputFloat("ShadowStrength", &m_ShadowStrength);
 			ImGui::InputFloat("ShadowLightPosDistance", &m_ShadowLightPosDistance);
-
-			float* orthoArray = new float[] { m_OrthoGraphParam.x, m_OrthoGraphParam.y, m_OrthoGraphParam.z, m_OrthoGraphParam.w};
-			ImGui::InputFloat4("OrthoGraphParam", orthoArray);
-			m_OrthoGraphParam = Vector4(orthoArray);
+			ImGui::SliderInt("CascadeCount", &m_CascadeCount, 1, int(CascadedShadow::MaxCascadeCount));
+			ImGui::SliderFloat("CascadeLambda", &m_CascadeLambda, 0.0f, 1.0f);
+			ImGui::InputFloat("ShadowDistance", &m_ShadowDistance);
 
 			ImGui::TreePop();
 		}
@@ -216,8 +276,14 @@ void SampleApp::OnRenderIMGUI() {
 
 
 
-	if (ImGui::TreeNode("GameObjects")) {
+	// ImGui 以外の場所でダブルクリックしたらオブジェクトを選択する.
+	if (ImGui::IsMouseDoubleClicked(0) && !ImGui::GetIO().WantCaptureMouse) {
+		PickObject(ImGui::GetIO().MousePos.x, ImGui::GetIO().MousePos.y);
+	}
 
+	if (m_PickChanged) ImGui::SetNextItemOpen(true);
+	if (ImGui::TreeNode("GameObjects")) {
+		ImGui::Text("Picked : %d (double click to pick)", m_PickedObject);
 
 		for (size_t i = 0; i < m_GameObjects.size(); i++) {
 			
@@ -225,6 +291,7 @@ void SampleApp::OnRenderIMGUI() {
 			GameObject* g = m_GameObjects[i];
 			std::string s = "ID : " + std::to_string(g->GetId());
 
+			if (m_PickChanged) ImGui::SetNextItemOpen(int(i) == m_PickedObject);
 			if (ImGui::TreeNode(s.c_str())) {
 				
 
@@ -256,44 +323,34 @@ void SampleApp::OnRenderIMGUI() {
 				}
 
 				if (ImGui::TreeNode("Material")) {
-					std::vector<Material*> mats = g->m_Model.GetMaterials();
+					const auto& instances = g->m_Model.GetMaterialInstances();
 
-					for (size_t i = 0; i < mats.size(); i++)
+					for (size_t j = 0; j < instances.size(); j++)
 					{
-						auto ptr = reinterpret_cast<CommonCb::CbMaterial*>(mats[i]->GetBufferPtr(0));
-						
-						float* p00 = new float[] { ptr->Param00.x, ptr->Param00.y, ptr->Param00.z, ptr->Param00.w };
-						float* p01 = new float[] { ptr->Param01.x, ptr->Param01.y, ptr->Param01.z, ptr->Param01.w };
-						float* p02 = new float[] { ptr->Param02.x, ptr->Param02.y, ptr->Param02.z, ptr->Param02.w };
-						float* p03 = new float[] { ptr->Param03.x, ptr->Param03.y, ptr->Param03.z, ptr->Param03.w };
-						float* p04 = new float[] { ptr->Param04.x, ptr->Param04.y, ptr->Param04.z, ptr->Param04.w };
-						float* p05 = new float[] { ptr->Param05.x, ptr->Param05.y, ptr->Param05.z, ptr->Param05.w };
-						float* p06 = new float[] { ptr->Param06.x, ptr->Param06.y, ptr->Param06.z, ptr->Param06.w };
-						float* p07 = new float[] { ptr->Param07.x, ptr->Param07.y, ptr->Param07.z, ptr->Param07.w };
-						float* p08 = new float[] { ptr->Param08.x, ptr->Param08.y, ptr->Param08.z, ptr->Param08.w };
-						float* p09 = new float[] { ptr->Param09.x, ptr->Param09.y, ptr->Param09.z, ptr->Param09.w };
-						
-						ImGui::InputFloat4("Param00", p00);
-						ImGui::InputFloat4("Param01", p01);
-						ImGui::InputFloat4("Param02", p02);
-						ImGui::InputFloat4("Param03", p03);
-						ImGui::InputFloat4("Param04", p04);
-						ImGui::InputFloat4("Param05", p05);
-						ImGui::InputFloat4("Param06", p06);
-						ImGui::InputFloat4("Param07", p07);
-						ImGui::InputFloat4("Param08", p08);
-						ImGui::InputFloat4("Param09", p09);
-
-						ptr->Param00 = Vector4(p00);
-						ptr->Param01 = Vector4(p01);
-						ptr->Param02 = Vector4(p02);
-						ptr->Param03 = Vector4(p03);
-						ptr->Param04 = Vector4(p04);
-						ptr->Param05 = Vector4(p05);
-						ptr->Param06 = Vector4(p06);
-						ptr->Param07 = Vector4(p07);
-						ptr->Param08 = Vector4(p08);
-						ptr->Param09 = Vector4(p09);
+						MaterialInstance* pInstance = instances[j];
+						ImGui::PushID(int(j));
+
+						// 変更したスロットだけをインスタンスで上書きする.
+						for (uint32_t slot = 0; slot < 10; slot++)
+						{
+							char label[16];
+							sprintf_s(label, "Param%02u", slot);
+
+							Vector4 v = pInstance->GetParam(slot);
+							float param[4] = { v.x, v.y, v.z, v.w };
+							if (ImGui::InputFloat4(label, param)) {
+								pInstance->SetParam(slot, Vector4(param));
+							}
+
+							if (pInstance->IsOverridden(slot)) {
+								ImGui::SameLine();
+								ImGui::PushID(int(slot));
+								if (ImGui::SmallButton("Reset")) pInstance->ResetParam(slot);
+								ImGui::PopID();
+							}
+						}
+
+						ImGui::PopID();
 					}
 
 					ImGui::TreePop();
@@ -309,6 +366,7 @@ void SampleApp::OnRenderIMGUI() {
 
 		ImGui::TreePop();
 	}
+	m_PickChanged = false;
 
 	if (ImGui::Button("Close Window")) {
 		PostQuitMessage(0);
@@ -322,48 +380,313 @@ void SampleApp::OnRenderIMGUI() {
 
 	if (ImGui::TreeNode("Target")) {
 
-		if (ImGui::TreeNode("TempTarget")) {
-			ImGui::Image((ImTextureID)m_CommonRTManager.m_TempColorTarget.GetHandleSRV()->HandleGPU.ptr, ImVec2(160, 90));
+		if (ImGui::TreeNode("ShadowTarget")) {
+			ImGui::Image((ImTextureID)m_CommonRTManager.m_SceneShadowTarget.GetHandleSRV()->HandleGPU.ptr, ImVec2(160, 160));
 			ImGui::TreePop();
 		}
 
-		if (ImGui::TreeNode("ColorTarget")) {
-			ImGui::Image((ImTextureID)m_CommonRTManager.m_SceneColorTarget.GetHandleSRV()->HandleGPU.ptr, ImVec2(160, 90));
-			ImGui::TreePop();
+		// 一時リソースは他のリソースとメモリを共有するので, 残す設定のときだけ表示する.
+		if (!m_GraphKeepTargets) {
+			ImGui::Text("Enable 'Keep Targets' in Render Graph to view transient targets.");
+		}
+		for (auto i = 0u; m_GraphKeepTargets && i < m_RenderGraph.GetResourceCount(); i++) {
+			auto pColor  = m_GraphResources.GetColorTarget(i);
+			auto pDepth  = m_GraphResources.GetDepthTarget(i);
+			auto pHandle = (pColor != nullptr) ? pColor->GetHandleSRV() : (pDepth != nullptr) ? pDepth->GetHandleSRV() : nullptr;
+			if (pHandle == nullptr) continue;
+
+			if (ImGui::TreeNode(m_RenderGraph.GetResourceName(i))) {
+				ImGui::Image((ImTextureID)pHandle->HandleGPU.ptr, ImVec2(160, 90));
+				ImGui::TreePop();
+			}
 		}
+		ImGui::TreePop();
+	}
 
-		if (ImGui::TreeNode("DepthTarget")) {
-			ImGui::Image((ImTextureID)m_CommonRTManager.m_SceneDepthTarget.GetHandleSRV()->HandleGPU.ptr, ImVec2(160, 90));
-			ImGui::TreePop();
+	if (ImGui::TreeNode("MaterialParam")) {
+		ImGui::Text("Instances : %u", m_MaterialParamBuffer.GetAllocatedCount());
+		ImGui::Text("Uploaded  : %u blocks (%u bytes)", m_MaterialParamBuffer.GetLastUploadCount(), m_MaterialParamBuffer.GetLastUploadCount() * uint32_t(sizeof(MaterialParamBlock)));
+		ImGui::Text("Pending   : %u blocks", m_MaterialParamBuffer.GetPendingCount());
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNode("RenderQueue")) {
+		const auto& stats = m_RenderQueue.GetStats();
+		ImGui::Text("Items     : %u", stats.ItemCount);
+		ImGui::Text("Pipeline  : %u", stats.PipelineChanges);
+		ImGui::Text("Material  : %u", stats.MaterialChanges);
+		ImGui::Text("MeshCB    : %u", stats.MeshBufferChanges);
+		ImGui::Text("Instance  : %u", stats.InstanceChanges);
+		ImGui::Text("Draws     : %u (%u instanced items)", stats.DrawCalls, stats.InstancedItems);
+		ImGui::Text("Sort      : %.1f us (%u passes)", stats.SortMicroSec, stats.SortPasses);
+		ImGui::Text("Submit    : %.1f us", stats.SubmitMicroSec);
+		ImGui::Text("Instances : %u / %u", m_InstanceBuffer.GetUsedCount(), m_InstanceBuffer.GetCapacity());
+
+		bool batching = m_RenderQueue.IsBatching();
+		if (ImGui::Checkbox("Batching", &batching)) {
+			m_RenderQueue.SetBatching(batching);
 		}
+		ImGui::SliderInt("Stress Objects", &m_StressCount, 0, 10000);
+		ImGui::TreePop();
+	}
 
-		if (ImGui::TreeNode("ShadowTarget")) {
-			ImGui::Image((ImTextureID)m_CommonRTManager.m_SceneShadowTarget.GetHandleSRV()->HandleGPU.ptr, ImVec2(160, 90));
-			ImGui::TreePop();
+	if (ImGui::TreeNode("Culling")) {
+		ImGui::Checkbox("Frustum Culling", &m_EnableCulling);
+		ImGui::Text("Bounds    : %zu", m_Culler.GetCount());
+		ImGui::Text("Camera    : %zu visible", m_CameraVisible.size());
+		ImGui::Text("Light     : %zu visible", m_LightVisible.size());
+		for (auto i = 0u; i < m_ActiveCascadeCount; ++i) {
+			ImGui::Text("Cascade %u : %zu visible", i, m_CascadeVisible[i].size());
 		}
+		ImGui::Text("Cull      : %.1f us", m_CullMicroSec);
 
-		if (ImGui::TreeNode("BloomTarget")) {
+		ImGui::Separator();
+		ImGui::Checkbox("Use BVH", &m_UseBVH);
+		ImGui::Text("Proxies   : %u (%u nodes)", m_SceneBVH.GetProxyCount(), m_SceneBVH.GetNodeCount());
+		ImGui::Text("Height    : %d", m_SceneBVH.GetHeight());
+		ImGui::Text("Refits    : %u", m_BVHRefits);
+		ImGui::TreePop();
+	}
 
-			int size = sizeof(m_CommonRTManager.m_BloomColorTarget) / sizeof(m_CommonRTManager.m_BloomColorTarget[0]);
-			for (size_t i = 0; i < size; i++)
-			{
-				ImGui::Image((ImTextureID)m_CommonRTManager.m_BloomColorTarget[i].GetHandleSRV()->HandleGPU.ptr, ImVec2(160, 90));
+	if (ImGui::TreeNode("ECS")) {
+		ImGui::Text("Entities  : %u", m_Registry.GetCount());
+		for (auto& system : m_Systems.GetSystems()) {
+			ImGui::Checkbox(system.Name.c_str(), &system.Enable);
+			ImGui::SameLine();
+			ImGui::Text("%.1f us", system.MicroSec);
+		}
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNode("Hierarchy")) {
+		ImGui::Text("Nodes     : %u", m_Hierarchy.GetCount());
+		ImGui::Text("Recompute : %u", m_HierarchyRecomputed);
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNode("Jobs")) {
+		ImGui::Text("Workers   : %u", m_JobSystem.GetWorkerCount());
+		ImGui::Text("Steals    : %llu", (unsigned long long)m_JobSystem.GetStealCount());
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNode("Recording")) {
+		ImGui::Checkbox("Parallel Recording", &m_EnableParallelRecord);
+		ImGui::Text("Lists     : %zu (%u allocated)", m_Recorder.GetLists().size(), m_CommandListPool.GetListCount());
+		ImGui::Text("Record    : %.1f us", m_RecordMicroSec);
+		for (const auto& slot : m_Recorder.GetSlots()) {
+			ImGui::Text("%-9s %u : %7.1f us (worker %u, items %u-%u)", m_Recorder.GetPassName(slot.Pass), slot.Chunk, slot.MicroSec, slot.Worker, slot.Begin, slot.End);
+		}
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNode("Frame Pacing")) {
+		const auto completed = m_Fence.GetCompletedValue();
+		ImGui::Text("Frames    : %u in flight max", m_FramePacer.GetFrameCount());
+		ImGui::Text("In Flight : %u", m_FramePacer.GetInFlightCount(completed));
+		ImGui::Text("Fence     : %llu (completed %llu)", (unsigned long long)m_FramePacer.GetLastValue(), (unsigned long long)completed);
+
+		int latency = int(GetMaxFrameLatency());
+		if (ImGui::SliderInt("Max Frame Latency", &latency, 1, 8)) {
+			SetMaxFrameLatency(uint32_t(latency));
+		}
+		int interval = int(m_SyncInterval);
+		if (ImGui::SliderInt("Sync Interval", &interval, 0, 4)) {
+			m_SyncInterval = uint32_t(interval);
+		}
+		bool cap = ImGui::Checkbox("Frame Cap", &m_EnableFrameCap);
+		cap |= ImGui::SliderFloat("Cap FPS", &m_FrameCapFps, 10.0f, 240.0f, "%.0f");
+		if (cap) {
+			m_FrameLimiter.SetTargetFps(m_EnableFrameCap ? double(m_FrameCapFps) : 0.0);
+		}
+
+		ImGui::Text("Frame     : p50 %6.2f ms, p99 %6.2f ms, avg %6.2f ms", m_FrameStats.GetPercentile(50.0), m_FrameStats.GetPercentile(99.0), m_FrameStats.GetAverage());
+		ImGui::Text("Present   : p50 %6.2f ms, p99 %6.2f ms", m_PresentStats.GetPercentile(50.0), m_PresentStats.GetPercentile(99.0));
+		ImGui::Text("Wait      : p50 %6.2f ms, p99 %6.2f ms", m_FrameWaitStats.GetPercentile(50.0), m_FrameWaitStats.GetPercentile(99.0));
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNode("Render Graph")) {
+		const auto& report = m_RenderGraph.GetReport();
+
+		// 記録済みのコマンドがリソースを参照しているので, 再構築は次のフレームの前に行う.
+		m_GraphDirty |= ImGui::Checkbox("Transient Aliasing", &m_GraphAliasing);
+		m_GraphDirty |= ImGui::Checkbox("Keep Targets", &m_GraphKeepTargets);
+
+		ImGui::Text("Passes    : %u (%u culled)", report.PassCount, report.CulledCount);
+		ImGui::Text("Barriers  : %u transition, %u aliasing, %u uav", report.TransitionCount, report.AliasingCount, report.UAVCount);
+		ImGui::Text("Batches   : %u (manual %u transitions)", report.BatchCount, report.ManualCount);
+		ImGui::Text("Transient : %u (%u aliased)", report.TransientCount, report.AliasedCount);
+		ImGui::Text("Memory    : %.2f MB heap / %.2f MB separate", double(report.HeapBytes) / (1024.0 * 1024.0), double(report.TransientBytes) / (1024.0 * 1024.0));
+		for (auto i = 0u; i < m_RenderGraph.GetPassCount(); i++) {
+			if (m_RenderGraph.IsCulled(i)) {
+				ImGui::Text("%-10s : culled", m_RenderGraph.GetPassName(i));
+			}
+			else {
+				ImGui::Text("%-10s : %zu barriers", m_RenderGraph.GetPassName(i), m_RenderGraph.GetBarriers(i).size());
 			}
+		}
 
-			
-			ImGui::TreePop();
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNode("Pipeline Cache")) {
+		auto& cache = PipelineCache::GetInstance();
+		const auto& stats = cache.GetStats();
+
+		ImGui::Text("Library   : %s", cache.HasLibrary() ? "enabled" : "disabled");
+		ImGui::Text("Pipelines : %zu (%u requests)", cache.GetCount(), stats.Requests);
+		ImGui::Text("Hits      : %u memory, %u library", stats.MemoryHits, stats.LibraryHits);
+		ImGui::Text("Compiled  : %u (%u stored)", stats.Compiled, stats.Stored);
+		ImGui::Text("Time      : %.2f ms", stats.MilliSec);
+		if (ImGui::Button("Save Library")) {
+			cache.Save();
 		}
 
-		if (ImGui::TreeNode("NormalTarget")) {
-			ImGui::Image((ImTextureID)m_CommonRTManager.m_NormalTarget.GetHandleSRV()->HandleGPU.ptr, ImVec2(160, 90));
-			ImGui::TreePop();
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNode("Root Signature")) {
+		const auto& stats = PipelineCache::GetInstance().GetStats();
+		ImGui::Text("Cache     : %zu unique / %u requests (%u shared)", PipelineCache::GetInstance().GetRootSignatureCount(), stats.RootRequests, stats.RootHits);
+
+		auto pShader = AppResourceManager::GetInstance().GetShader(L"basic");
+		if (pShader != nullptr) {
+			const auto& layout = pShader->GetRootSig().GetLayout();
+			ImGui::Text("Model     : %u DWORD (suggested %u)", layout.DWords, layout.SuggestedDWords);
+			ImGui::Text("Params    : %u tables (%u cbv), %u root descriptors, %u constants", layout.Tables, layout.CBVTables, layout.RootDescriptors, layout.Constants);
+			for (const auto& suggestion : layout.Suggestions) {
+				ImGui::BulletText("%s", suggestion.c_str());
+			}
+		}
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNode("Shader Library")) {
+		auto& library = ShaderLibrary::GetInstance();
+		const auto& stats = library.GetStats();
+
+		ImGui::Text("Archive   : %s", library.HasArchive() ? "mounted" : "none");
+		ImGui::Text("Shaders   : %zu names, %zu blobs (%.1f KB)", library.GetCount(), library.GetBlobCount(), double(stats.Bytes) / 1024.0);
+		ImGui::Text("Requests  : %u (%u shared, %u interned)", stats.Requests, stats.NameHits, stats.Interned);
+		ImGui::Text("Loaded    : %u archive, %u files", stats.ArchiveHits, stats.FileReads);
+		ImGui::Text("Reflected : %u", stats.Reflected);
+		ImGui::Text("Time      : %.2f ms", stats.MilliSec);
+		if (ImGui::Button("Write Archive")) {
+			library.WriteArchive(L"ShaderLibrary.bin");
+		}
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNode("IBL Cache")) {
+		const auto& stats = m_SkyManager.GetCacheStats();
+		ImGui::Text("DFG       : %s", stats.DFGHit ? "hit" : "baked");
+		ImGui::Text("LD        : %s", stats.LDHit  ? "hit" : "baked");
+		ImGui::Text("Prepare   : %.2f ms", stats.PrepareMilliSec);
+		ImGui::Text("Bake      : %.2f ms", stats.BakeMilliSec);
+		ImGui::Text("Save      : %s", m_SkyManager.IsCacheSaving() ? "writing" : "idle");
+
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNode("Irradiance SH")) {
+		ImGui::Checkbox("Use SH Diffuse", &m_UseIrradianceSH);
+		ImGui::Text("Projected : %s (%.2f ms)", m_SkyManager.HasIrradianceSH() ? "yes" : "no", m_SkyManager.GetIrradianceMilliSec());
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNode("IBL Reference")) {
+		if (ImGui::Button("Compare with GPU")) {
+			m_CompareIBLReference = true;
 		}
+		const auto& stats = m_SkyManager.GetReferenceStats();
+		if (stats.Valid) {
+			ImGui::Text("DFG       : max %.2e / rms %.2e (%.1f ms)", stats.DFGMaxError, stats.DFGRmsError, stats.DFGMilliSec);
+			ImGui::Text("LD        : max %.2f%% / rms %.3f%% (%.1f ms)", stats.LDMaxError * 100.0f, stats.LDRmsError * 100.0f, stats.LDMilliSec);
+		}
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNode("CPU Cube Convert")) {
+		if (ImGui::Button("Compare with GPU")) {
+			m_CompareCpuCubeMap = true;
+		}
+		const auto& stats = m_SkyManager.GetConvertStats();
+		if (stats.Valid) {
+			ImGui::Text("Cube %4u : max %.2f%% / rms %.3f%% (%.1f ms)", stats.Size, stats.MaxError * 100.0f, stats.RmsError * 100.0f, stats.MilliSec);
+		}
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNode("Cascaded Shadow")) {
+		for (auto i = 0u; i < m_ActiveCascadeCount; ++i) {
+			const auto& c = m_Cascades[i];
+			ImGui::Text("Cascade %u : %7.2f - %7.2f  radius %6.2f  texel %.4f", i, c.SplitNear, c.SplitFar, c.Radius, c.TexelSize);
+		}
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNode("Shadow Cache")) {
+		// キャッシュのパスを登録し直す. 有効にした直後はキャッシュの内容が古いので全体を描き直す.
+		if (ImGui::Checkbox("Shadow Cache", &m_EnableShadowCache)) {
+			m_GraphDirty = true;
+			if (m_EnableShadowCache) m_ShadowCache.Invalidate();
+		}
+
+		if (m_EnableShadowCache) {
+			const auto& stats = m_ShadowCache.GetStats();
+			const auto  draws = stats.StaticDraws + stats.DynamicDraws;
+			ImGui::Text("Casters   : %u static / %u dynamic", stats.StaticCasters, stats.DynamicCasters);
+			ImGui::Text("Dirty     : %u cascades invalid, %u regions", stats.InvalidCascades, stats.DirtyRegions);
+			ImGui::Text("Draws     : %u static + %u dynamic (uncached %u, saved %u)", stats.StaticDraws, stats.DynamicDraws, stats.UncachedDraws, stats.UncachedDraws - draws);
+		}
+		ImGui::TreePop();
+	}
 
-		if (ImGui::TreeNode("PreDepthTarget")) {
-			ImGui::Image((ImTextureID)m_CommonRTManager.m_PreDepthTarget.GetHandleSRV()->HandleGPU.ptr, ImVec2(160, 90));
+	if (ImGui::TreeNode("Profiler")) {
+		auto& profiler = Profiler::GetInstance();
+		const auto& nodes = profiler.GetNodes();
+		ImGui::Checkbox("Enable Profiler", &m_EnableProfiler);
+		ImGui::Checkbox("GPU Timestamps", &m_EnableGpuProfiler);
+		ImGui::Text("Frame     : %.3f ms (%u scopes, %u dropped)", profiler.GetFrameMs(), uint32_t(nodes.size()), profiler.GetDroppedCount());
+
+		DrawProfilerFlameGraph();
+
+		// 同じパスはフレーム内で合計されるので, 最初のノードだけを表示する.
+		if (ImGui::TreeNode("Statistics")) {
+			std::vector<uint64_t> shown;
+			for (const auto& node : nodes) {
+				if (std::find(shown.begin(), shown.end(), node.Path) != shown.end()) continue;
+				shown.push_back(node.Path);
+				ImGui::Text("%s%*s%-16s avg %7.3f  min %7.3f  max %7.3f ms",
+					(node.Thread == Profiler::GpuThread) ? "GPU " : "CPU ", int(node.Depth * 2), "", node.Name, node.AvgMs, node.MinMs, node.MaxMs);
+			}
 			ImGui::TreePop();
 		}
 
+		ImGui::SliderInt("Capture Frames", &m_ProfilerCaptureFrames, 1, 300);
+		if (ImGui::Button("Capture Trace")) {
+			profiler.Capture(uint32_t(m_ProfilerCaptureFrames));
+			m_ProfilerTraceSaved = false;
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Save Trace")) {
+			m_ProfilerTraceSaved = profiler.SaveChromeTrace("profile_trace.json");
+		}
+		ImGui::Text("Trace     : %u frames%s", profiler.GetCapturedFrames(),
+			profiler.IsCapturing() ? " (capturing)" : (m_ProfilerTraceSaved ? " saved to profile_trace.json" : ""));
+		ImGui::TreePop();
+	}
+
+	if (ImGui::TreeNode("Occlusion")) {
+		const auto& stats = m_OcclusionCuller.GetStats();
+		ImGui::Checkbox("Occlusion Culling", &m_EnableOcclusion);
+		ImGui::Text("Buffer    : %ux%u (%u workers)", m_OcclusionCuller.GetWidth(), m_OcclusionCuller.GetHeight(), m_OcclusionCuller.GetThreadCount());
+		ImGui::Text("Occluders : %u (%u tris, %u rasterized)", stats.Occluders, stats.Triangles, stats.Rasterized);
+		ImGui::Text("Occluded  : %u / %u", stats.Occluded, stats.Tested);
+		ImGui::Text("Setup     : %.1f us", stats.SetupMicroSec);
+		ImGui::Text("Raster    : %.1f us", stats.RasterMicroSec);
+		ImGui::Text("Total     : %.1f us", m_OcclusionMicroSec);
 		ImGui::TreePop();
 	}
 
@@ -405,47 +728,81 @@ void SampleApp::OnRenderIMGUI() {
 //-----------------------------------------------------------------------------
 void SampleApp::OnRender()
 {
+	auto& profiler = Profiler::GetInstance();
+	profiler.SetEnable(m_EnableProfiler);
+	profiler.BeginFrame();
+
+	// 前回このフレーム番号で計測したGPUの結果は実行済みなので読み戻す.
+	m_GpuProfiler.BeginFrame(m_FrameIndex, m_EnableProfiler ? &profiler : nullptr);
+
 	// カメラ更新.
 	UpdateCamera();
 	UpdateBuffer();
+	UpdateCulling();
+	m_InstanceBuffer.Begin(m_FrameIndex);
+	BuildScene();
+
+	// CPU参照ベイクとの比較は読み戻しでキューを待つので, フレームの記録前に行う.
+	if (m_CompareIBLReference) {
+		m_CompareIBLReference = false;
+		m_Fence.Sync(m_pQueue.Get());
+		if (!m_SkyManager.CompareReferenceBake(m_pDevice.Get(), m_CommandList, m_pQueue.Get(), m_Fence, 0)) {
+			ELOG("Error : SkyManager::CompareReferenceBake() Failed.");
+		}
+	}
 
-	// レンダリングエンジン描画
-	auto pCmd = m_CommandList.Reset();
-	if (pCmd == nullptr) { return; }
-
-	ID3D12DescriptorHeap* const pHeaps[] = {
-		m_pPool[POOL_TYPE_RES]->GetHeap(),
-	};
-	pCmd->SetDescriptorHeaps(1, pHeaps);
-	{
-		// ビューポート設定.
-		pCmd->RSSetViewports(1,    &m_Viewport);
-		pCmd->RSSetScissorRects(1, &m_Scissor);
+	if (m_CompareCpuCubeMap) {
+		m_CompareCpuCubeMap = false;
+		m_Fence.Sync(m_pQueue.Get());
+		if (!m_SkyManager.CompareCpuCubeMap(m_pDevice.Get(), m_CommandList, m_pQueue.Get(), m_Fence, 0)) {
+			ELOG("Error : SkyManager::CompareCpuCubeMap() Failed.");
+		}
+	}
 
-		RenderPreProcess(pCmd);
-		RenderOpaque(pCmd, m_CommonRTManager.m_SceneColorTarget, m_CommonRTManager.m_SceneDepthTarget, m_SkyManager);
-		RenderPostProcess(pCmd);
+	// レンダリングエンジン描画
+	if (m_GraphDirty) {
+		m_GraphDirty = false;
+		if (!RebuildRenderGraph()) { return; }
 	}
-	pCmd->Close();
+	m_CommandListPool.BeginFrame(m_FrameIndex);
+	if (!RecordFrame()) { return; }
 
-	// ImGui描画
-	OnRenderIMGUICommonProcess();
-	ID3D12DescriptorHeap* const pImGuiHeaps[] = {
-		m_pPool[POOL_TYPE_RES]->GetHeap(),
-	};
-	auto pImGuiCmd = m_ImGuiCommandList.Reset();
-	pImGuiCmd->SetDescriptorHeaps(1, pImGuiHeaps);
+	// ImGui描画. 提出順で最後のリストなのでタイムスタンプの解決もここで行う.
+	auto pImGuiCmd = m_ImGuiCommandList.Reset(m_FrameIndex);
 	{
+		PROFILE_SCOPE("ImGui");
+		OnRenderIMGUICommonProcess();
+		ID3D12DescriptorHeap* const pImGuiHeaps[] = {
+			m_pPool[POOL_TYPE_RES]->GetHeap(),
+		};
+		pImGuiCmd->SetDescriptorHeaps(1, pImGuiHeaps);
+		m_GpuProfiler.Begin(pImGuiCmd, m_GpuScope[GPU_SCOPE_IMGUI]);
 		RenderImGui(pImGuiCmd);
+		m_GpuProfiler.End(pImGuiCmd, m_GpuScope[GPU_SCOPE_IMGUI]);
+		m_GpuProfiler.Resolve(pImGuiCmd);
 	}
 	pImGuiCmd->Close();
 
-	// コマンドリストを実行.
-	ID3D12CommandList* pLists[] = { pCmd ,pImGuiCmd };
-	m_pQueue->ExecuteCommandLists(2, pLists);
+	// コマンドリストを実行. 記録したスレッドによらず登録順に提出する.
+	m_SubmitLists.clear();
+	for (auto pList : m_Recorder.GetLists()) {
+		m_SubmitLists.push_back(pList);
+	}
+	m_SubmitLists.push_back(pImGuiCmd);
+	m_pQueue->ExecuteCommandLists(UINT(m_SubmitLists.size()), m_SubmitLists.data());
+
+	// 提出したフレームの分だけキャッシュを描画済みにする.
+	if (m_EnableShadowCache) {
+		m_ShadowCache.CommitFrame();
+	}
 
 	// 画面に表示.
-	Present(1);
+	{
+		PROFILE_SCOPE("Present");
+		Present(m_SyncInterval);
+	}
+
+	profiler.EndFrame();
 }
 
 void SampleApp::UpdateCamera() {
@@ -453,10 +810,12 @@ void SampleApp::UpdateCamera() {
 	auto aspect = static_cast<float>(m_Width) / static_cast<float>(m_Height);
 
 	m_View = m_Camera.GetView();
-	m_Proj = Matrix::CreatePerspectiveFieldOfView(fovY, aspect, 0.1f, 1000.0f);
+	m_Proj = Matrix::CreatePerspectiveFieldOfView(fovY, aspect, m_NearClip, m_FarClip);
 }
 
 void SampleApp::UpdateBuffer() {
+	PROFILE_SCOPE("UpdateBuffer");
+
 	CommonCb::CbCommon common;
 	common.CameraPosition = m_Camera.GetPosition();
 	common.FogArea        = m_FogArea;
@@ -470,7 +829,21 @@ void SampleApp::UpdateBuffer() {
 	cbl.LightIntensity = m_LightIntensity;
 	cbl.ShadowBias     = m_ShadowBias;
 	cbl.ShadowStrength = m_ShadowStrength;
-
+	cbl.EnableIrradianceSH = (m_UseIrradianceSH && m_SkyManager.HasIrradianceSH()) ? 1.0f : 0.0f;
+	cbl.Padding2       = 0.0f;
+	memcpy(cbl.IrradianceSH, m_SkyManager.GetIrradianceSH().Coeffs, sizeof(cbl.IrradianceSH));
+
+	// カメラの視錐台を分割してカスケードを求める. ライトの向きが不正な場合は前回の結果を使う.
+	CascadedShadow::Desc csm;
+	csm.CascadeCount   = uint32_t(std::min(std::max(m_CascadeCount, 1), int(CascadedShadow::MaxCascadeCount)));
+	csm.Lambda         = m_CascadeLambda;
+	csm.NearClip       = m_NearClip;
+	csm.FarClip        = std::min(std::max(m_ShadowDistance, m_NearClip * 2.0f), m_FarClip);
+	csm.TileSize       = ShadowTileSize;
+	csm.CasterDistance = m_ShadowLightPosDistance;
+	if (CascadedShadow::Compute(m_View, m_Proj, m_LightDirection, csm, m_Cascades)) {
+		m_ActiveCascadeCount = csm.CascadeCount;
+	}
 
 	// ビュープロジェクションバッファ
 	CommonCb::CbTransform cbt;
@@ -479,18 +852,190 @@ void SampleApp::UpdateBuffer() {
 
 	m_CommonBufferManager.UpdateCommonBuffer(m_FrameIndex, common);
 	m_CommonBufferManager.UpdateLightBuffer(m_FrameIndex, cbl);
-	m_CommonBufferManager.UpdateShadowBuffer(m_FrameIndex, m_LightDirection, m_ShadowLightPosDistance, m_OrthoGraphParam);
+
+	// 右手系のビュー行列の3列目はカメラの後方を向く.
+	m_CommonBufferManager.UpdateShadowBuffer(m_FrameIndex, m_Cascades, m_ActiveCascadeCount, Vector3(-m_View._13, -m_View._23, -m_View._33));
 	m_CommonBufferManager.UpdateViewProjMatrix(m_FrameIndex, cbt);
+
+	// 変更されたマテリアルパラメータのみ転送.
+	m_MaterialParamBuffer.Update(m_FrameIndex);
+}
+
+//-----------------------------------------------------------------------------
+//      フレームのコマンドをパスごとに記録します.
+//-----------------------------------------------------------------------------
+bool SampleApp::RecordFrame()
+{
+	PROFILE_SCOPE("RecordFrame");
+
+	// バックバッファはフレームごとに変わる.
+	m_GraphResources.SetImported(m_GraphRes[GRAPH_RES_BACK_BUFFER], m_ColorTarget[m_FrameIndex].GetResource());
+
+	// 登録順がそのまま提出順になる. 不透明描画はソート済みの描画リストを分割して記録する.
+	// バリアはレンダーグラフが求めたものを各パスの先頭にまとめて記録する.
+	const auto preNormal = !m_RenderGraph.IsCulled(m_GraphPass[GRAPH_PASS_PRE_NORMAL]);
+	const auto itemCount = uint32_t(m_RenderQueue.GetCount());
+	m_OpaqueChunkStats.resize(CommandRecorder<ID3D12GraphicsCommandList>::GetChunkCount(itemCount, OpaqueChunkMinItems, OpaqueChunkMax));
+
+	// GPUのスコープは記録前に確保する. 記録しないパスには確保しない.
+	for (auto& scope : m_GpuScope) {
+		scope = GpuProfiler::InvalidScope;
+	}
+	if (m_EnableProfiler && m_EnableGpuProfiler) {
+		if (preNormal) {
+			m_GpuScope[GPU_SCOPE_PRE_NORMAL] = m_GpuProfiler.AddScope("PreNormal", 0);
+		}
+		m_GpuScope[GPU_SCOPE_SHADOW] = m_GpuProfiler.AddScope("Shadow", 0);
+		m_GpuScope[GPU_SCOPE_SKY]    = m_GpuProfiler.AddScope("Sky", 0);
+		if (!m_OpaqueChunkStats.empty()) {
+			m_GpuScope[GPU_SCOPE_OPAQUE] = m_GpuProfiler.AddScope("Opaque", 0);
+		}
+		m_GpuScope[GPU_SCOPE_POST]    = m_GpuProfiler.AddScope("Post", 0);
+		m_GpuScope[GPU_SCOPE_BLOOM]   = m_GpuProfiler.AddScope("Bloom", 1);
+		m_GpuScope[GPU_SCOPE_TONEMAP] = m_GpuProfiler.AddScope("Tonemap", 1);
+		m_GpuScope[GPU_SCOPE_IMGUI]   = m_GpuProfiler.AddScope("ImGui", 0);
+	}
+
+	m_Recorder.Clear();
+	if (preNormal) {
+		m_Recorder.AddPass("PreNormal", [this](ID3D12GraphicsCommandList* pCmd, const RecordSlot&) {
+			PROFILE_SCOPE("PreNormal");
+			SetRecordState(pCmd);
+			m_GpuProfiler.Begin(pCmd, m_GpuScope[GPU_SCOPE_PRE_NORMAL]);
+			BeginGraphPass(pCmd, GRAPH_PASS_PRE_NORMAL);
+			RenderPreNormal(pCmd);
+			m_GpuProfiler.End(pCmd, m_GpuScope[GPU_SCOPE_PRE_NORMAL]);
+		});
+	}
+	m_Recorder.AddPass("Shadow", [this](ID3D12GraphicsCommandList* pCmd, const RecordSlot&) {
+		PROFILE_SCOPE("Shadow");
+		SetRecordState(pCmd);
+		m_GpuProfiler.Begin(pCmd, m_GpuScope[GPU_SCOPE_SHADOW]);
+		RenderShadowMap(pCmd, m_CommonRTManager.m_SceneShadowTarget);
+		m_GpuProfiler.End(pCmd, m_GpuScope[GPU_SCOPE_SHADOW]);
+	});
+	m_Recorder.AddPass("Sky", [this](ID3D12GraphicsCommandList* pCmd, const RecordSlot&) {
+		PROFILE_SCOPE("Sky");
+		SetRecordState(pCmd);
+		m_GpuProfiler.Begin(pCmd, m_GpuScope[GPU_SCOPE_SKY]);
+		BeginGraphPass(pCmd, GRAPH_PASS_SKY);
+		RenderOpaqueBegin(pCmd, GetGraphColor(GRAPH_RES_SCENE_COLOR), GetGraphDepth(GRAPH_RES_SCENE_DEPTH), m_SkyManager);
+		m_GpuProfiler.End(pCmd, m_GpuScope[GPU_SCOPE_SKY]);
+
+		// 不透明描画は分割数が変わるので, バリアは提出順で直前になるこのリストの末尾に記録する.
+		BeginGraphPass(pCmd, GRAPH_PASS_OPAQUE);
+	});
+
+	// 分割したリストは登録順に提出されるので, 先頭で開始して末尾で終了すれば全体を計測できる.
+	m_Recorder.AddChunkedPass("Opaque", itemCount, OpaqueChunkMinItems, OpaqueChunkMax, [this](ID3D12GraphicsCommandList* pCmd, const RecordSlot& slot) {
+		PROFILE_SCOPE("Opaque");
+		SetRecordState(pCmd);
+		if (slot.Chunk == 0) {
+			m_GpuProfiler.Begin(pCmd, m_GpuScope[GPU_SCOPE_OPAQUE]);
+		}
+		DrawScene(pCmd, slot);
+		if (slot.Chunk + 1 == m_OpaqueChunkStats.size()) {
+			m_GpuProfiler.End(pCmd, m_GpuScope[GPU_SCOPE_OPAQUE]);
+		}
+	});
+
+	m_Recorder.AddPass("Post", [this](ID3D12GraphicsCommandList* pCmd, const RecordSlot&) {
+		PROFILE_SCOPE("Post");
+		SetRecordState(pCmd);
+		m_GpuProfiler.Begin(pCmd, m_GpuScope[GPU_SCOPE_POST]);
+		RenderPostProcess(pCmd);
+		m_GpuProfiler.End(pCmd, m_GpuScope[GPU_SCOPE_POST]);
+
+		// グラフ外のリソースを次のフレームの開始時の状態に戻す.
+		m_GraphResources.RecordFinalBarriers(pCmd, m_RenderGraph);
+	});
+
+	auto t0 = std::chrono::high_resolution_clock::now();
+	auto result = m_Recorder.Record(
+		m_EnableParallelRecord ? &m_JobSystem : nullptr,
+		[this](uint32_t worker) { return m_CommandListPool.Acquire(worker); },
+		[](ID3D12GraphicsCommandList* pCmd) { pCmd->Close(); });
+	auto t1 = std::chrono::high_resolution_clock::now();
+	m_RecordMicroSec = std::chrono::duration<double, std::micro>(t1 - t0).count();
+
+	m_RenderQueue.MergeStats(m_OpaqueChunkStats.data(), m_OpaqueChunkStats.size());
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      コマンドリストごとに必要な共通ステートを設定します.
+//-----------------------------------------------------------------------------
+void SampleApp::SetRecordState(ID3D12GraphicsCommandList* pCmd)
+{
+	// コマンドリスト間でステートは引き継がれない.
+	ID3D12DescriptorHeap* const pHeaps[] = {
+		m_pPool[POOL_TYPE_RES]->GetHeap(),
+	};
+	pCmd->SetDescriptorHeaps(1, pHeaps);
+
+	// ビューポート設定.
+	pCmd->RSSetViewports(1,    &m_Viewport);
+	pCmd->RSSetScissorRects(1, &m_Scissor);
+}
+
+//-----------------------------------------------------------------------------
+//      レンダーグラフをコンパイルして一時リソースを生成し直します.
+//-----------------------------------------------------------------------------
+bool SampleApp::RebuildRenderGraph()
+{
+	// 破棄するリソースを参照するコマンドの完了を待つ.
+	m_Fence.Sync(m_pQueue.Get());
+
+	m_RenderGraph.Clear();
+	DeclareSampleGraph(m_RenderGraph, m_GraphResources, m_Width, m_Height, m_GraphKeepTargets, m_EnableShadowCache, m_GraphPass, m_GraphRes);
+	if (!m_RenderGraph.Compile(m_GraphAliasing)) {
+		ELOG("Error : RenderGraph::Compile() Failed.");
+		return false;
+	}
+
+	if (!m_GraphResources.Create(m_RenderGraph)) {
+		ELOG("Error : RenderGraphResources::Create() Failed.");
+		return false;
+	}
+	m_GraphResources.SetImported(m_GraphRes[GRAPH_RES_SHADOW], m_CommonRTManager.m_SceneShadowTarget.GetResource());
+	m_GraphResources.SetImported(m_GraphRes[GRAPH_RES_SHADOW_STATIC], m_CommonRTManager.m_StaticShadowTarget.GetResource());
+
+	return true;
 }
 
-void SampleApp::RenderOpaque(ID3D12GraphicsCommandList* pCmd, ColorTarget& ColorDest, DepthTarget& DepthDest,SkyManager& skyManager)
+//-----------------------------------------------------------------------------
+//      パスの実行前のバリアを記録します.
+//-----------------------------------------------------------------------------
+bool SampleApp::BeginGraphPass(ID3D12GraphicsCommandList* pCmd, GRAPH_PASS pass)
 {
-	// 書き込み用リソースバリア設定.
-	DirectX::TransitionResource(pCmd,
-		ColorDest.GetResource(),
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
-		D3D12_RESOURCE_STATE_RENDER_TARGET);
+	auto index = m_GraphPass[pass];
+	if (m_RenderGraph.IsCulled(index)) {
+		return false;
+	}
 
+	m_GraphResources.RecordBarriers(pCmd, m_RenderGraph, index);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//      レンダーグラフのカラーターゲットを取得します.
+//-----------------------------------------------------------------------------
+ColorTarget& SampleApp::GetGraphColor(GRAPH_RES res) const
+{
+	// 削除されないパスからのみ呼び出すので, 必ず生成されている.
+	return *m_GraphResources.GetColorTarget(m_GraphRes[res]);
+}
+
+//-----------------------------------------------------------------------------
+//      レンダーグラフの深度ターゲットを取得します.
+//-----------------------------------------------------------------------------
+DepthTarget& SampleApp::GetGraphDepth(GRAPH_RES res) const
+{
+	return *m_GraphResources.GetDepthTarget(m_GraphRes[res]);
+}
+
+void SampleApp::RenderOpaqueBegin(ID3D12GraphicsCommandList* pCmd, ColorTarget& ColorDest, DepthTarget& DepthDest,SkyManager& skyManager)
+{
 	// ディスクリプタ取得.
 	auto handleRTV = ColorDest.GetHandleRTV();
 	auto handleDSV = DepthDest.GetHandleDSV();
@@ -504,36 +1049,301 @@ void SampleApp::RenderOpaque(ID3D12GraphicsCommandList* pCmd, ColorTarget& Color
 
 	// 背景描画.
 	SkyBox* ptr = skyManager.GetSkyBox();
-	if (ptr != nullptr) ptr->Draw(pCmd, skyManager.GetCubeMapHandleGPU(), m_View, m_Proj, 300.0f);
+	if (ptr != nullptr) ptr->Draw(pCmd, m_FrameIndex, skyManager.GetCubeMapHandleGPU(), m_View, m_Proj, 300.0f);
+}
 
-	// シーンの描画.
-	DrawScene(pCmd);
+//-----------------------------------------------------------------------------
+//      描画リストを構築します.
+//-----------------------------------------------------------------------------
+void SampleApp::BuildScene()
+{
+	PROFILE_SCOPE("BuildScene");
+
+	m_RenderQueue.Begin(m_NearClip, m_FarClip);
+
+	// 視錐台カリングを通過したものだけを積む.
+	const auto objectCount = m_GameObjects.size();
+	for (auto index : m_CameraVisible) {
+		Model* pModel = (index < objectCount)
+			? &m_GameObjects[index]->m_Model
+			: m_Registry.Get<ModelRenderer>(m_StressEntities[index - objectCount]).pModel;
+		Matrix world  = (index < objectCount)
+			? Matrix(m_GameObjects[index]->Transform().GetTransform())
+			: m_StressWorlds[index - objectCount];
+
+		// ビュー空間は右手系なので視線方向は -Z.
+		auto viewPos = Vector3::Transform(world.Translation(), m_View);
+		pModel->PushDrawItems(m_RenderQueue, RenderQueue::PASS_OPAQUE, world, -viewPos.z);
+	}
 
-	// 読み込み用リソースバリア設定.
-	DirectX::TransitionResource(pCmd,
-		ColorDest.GetResource(),
-		D3D12_RESOURCE_STATE_RENDER_TARGET,
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	// パス・PSO・マテリアル・深度の順に並べ替える. 記録は複数のスレッドで分担するので先に済ませる.
+	m_RenderQueue.Sort();
 }
 
 //-----------------------------------------------------------------------------
 //      シーンを描画します.
 //-----------------------------------------------------------------------------
-void SampleApp::DrawScene(ID3D12GraphicsCommandList* pCmd)
+void SampleApp::DrawScene(ID3D12GraphicsCommandList* pCmd, const RecordSlot& slot)
 {
+	auto handleRTV = GetGraphColor(GRAPH_RES_SCENE_COLOR).GetHandleRTV();
+	auto handleDSV = GetGraphDepth(GRAPH_RES_SCENE_DEPTH).GetHandleDSV();
+	pCmd->OMSetRenderTargets(1, &handleRTV->HandleCPU, FALSE, &handleDSV->HandleCPU);
 
-	// 非バッチ
-	for (size_t i = 0; i < m_GameObjects.size(); i++) {
+	// 担当する範囲だけを, 重複するステート設定を省いて描画.
+	m_RenderQueue.Submit(pCmd, m_FrameIndex, m_CommonBufferManager, m_SkyManager, slot.Begin, slot.End, m_OpaqueChunkStats[slot.Chunk]);
+}
+
+//-----------------------------------------------------------------------------
+//      視錐台カリングを行います.
+//-----------------------------------------------------------------------------
+void SampleApp::UpdateCulling()
+{
+	PROFILE_SCOPE("UpdateCulling");
+
+	const auto objectCount = m_GameObjects.size();
+
+	// 負荷計測用のエンティティを更新し, 先頭のオブジェクトの子として配置する.
+	UpdateStressEntities();
+	if (!m_GameObjects.empty()) {
+		// 親が動いたときだけ子孫を再計算する.
+		const Matrix& base = m_GameObjects[0]->Transform().GetTransform();
+		if (base != m_StressRootWorld) {
+			Vector3    scale;
+			Quaternion rotation;
+			Vector3    position;
+			Matrix(base).Decompose(scale, rotation, position);
+			m_Hierarchy.SetLocal(m_StressRoot, position, rotation, scale);
+			m_StressRootWorld = base;
+		}
+	}
+	m_Systems.Run(m_Registry, ImGui::GetIO().DeltaTime);
+
+	m_StressWorlds.clear();
+	for (auto entity : m_StressEntities) {
+		m_StressWorlds.push_back(m_Hierarchy.GetWorld(m_Registry.Get<TransformNode>(entity).Node));
+	}
+
+	auto t0 = std::chrono::high_resolution_clock::now();
+
+	// ワールド空間のAABBを SoA で詰め, BVH の葉も合わせて更新する.
+	// 番号はオブジェクト, 負荷計測用の順.
+	const auto total = objectCount + m_StressWorlds.size();
+	while (m_BVHProxies.size() > total) {
+		m_SceneBVH.DestroyProxy(m_BVHProxies.back());
+		m_BVHProxies.pop_back();
+	}
+
+	m_Culler.Clear();
+	m_Culler.Reserve(total);
+	m_BVHRefits = 0;
+
+	auto addBounds = [&](const Model& model, const Matrix& world) {
+		DirectX::XMFLOAT3 center;
+		DirectX::XMFLOAT3 extent;
+		FrustumCuller::TransformAABB(model.GetBoundsMin(), model.GetBoundsMax(), world, center, extent);
+
+		auto index = m_Culler.Add(center, extent);
+		Vector3 bmin = Vector3(center) - Vector3(extent);
+		Vector3 bmax = Vector3(center) + Vector3(extent);
+		if (index < m_BVHProxies.size()) {
+			if (m_SceneBVH.MoveProxy(m_BVHProxies[index], bmin, bmax)) m_BVHRefits++;
+		}
+		else {
+			m_BVHProxies.push_back(m_SceneBVH.CreateProxy(bmin, bmax, index));
+		}
+	};
+
+	// 影を落とすのはオブジェクトのみなので, キャッシュの遮蔽物の番号はカリング番号と一致する.
+	if (m_EnableShadowCache) {
+		m_ShadowCache.BeginFrame(m_Cascades, m_ActiveCascadeCount, ShadowTileSize);
+	}
+
+	for (size_t i = 0; i < objectCount; i++) {
 		GameObject* g = m_GameObjects[i];
 
 		CommonCb::CbMesh cbm;
 		cbm.World = g->Transform().GetTransform();
-
 		g->m_Model.UpdateMeshBuffer(m_FrameIndex, cbm);
-		g->m_Model.DrawModel(pCmd, m_FrameIndex, m_CommonBufferManager, m_SkyManager);
+
+		addBounds(g->m_Model, cbm.World);
+
+		if (m_EnableShadowCache) {
+			DirectX::XMFLOAT3 center;
+			DirectX::XMFLOAT3 extent;
+			m_Culler.GetBounds(uint32_t(i), center, extent);
+			m_ShadowCache.UpdateCaster(uint32_t(i), cbm.World, center, extent);
+		}
+	}
+	if (m_EnableShadowCache) {
+		m_ShadowCache.EndUpdate(uint32_t(objectCount));
+	}
+	for (size_t i = 0; i < m_StressEntities.size(); i++) {
+		addBounds(*m_Registry.Get<ModelRenderer>(m_StressEntities[i]).pModel, m_StressWorlds[i]);
+	}
+
+	if (m_EnableCulling) {
+		Frustum camera;
+		camera.Extract(m_View * m_Proj);
+
+		// 影を落とすオブジェクトはカスケードの投影範囲ごとに選ぶ.
+		Frustum cascades[CascadedShadow::MaxCascadeCount];
+		for (auto i = 0u; i < m_ActiveCascadeCount; i++) {
+			cascades[i].Extract(m_Cascades[i].ViewProj);
+		}
+
+		if (m_UseBVH) {
+			// BVH の列挙順は木の形で変わるので番号順に揃えておく.
+			m_SceneBVH.Query(camera, m_CameraVisible);
+			std::sort(m_CameraVisible.begin(), m_CameraVisible.end());
+			for (auto i = 0u; i < m_ActiveCascadeCount; i++) {
+				m_SceneBVH.Query(cascades[i], m_CascadeVisible[i]);
+				std::sort(m_CascadeVisible[i].begin(), m_CascadeVisible[i].end());
+			}
+		}
+		else {
+			m_Culler.Cull(camera, m_CameraVisible);
+			for (auto i = 0u; i < m_ActiveCascadeCount; i++) {
+				m_Culler.Cull(cascades[i], m_CascadeVisible[i]);
+			}
+		}
+
+		// 表示用に, いずれかのカスケードから可視な番号をまとめる.
+		m_LightVisible.clear();
+		for (auto i = 0u; i < m_ActiveCascadeCount; i++) {
+			m_LightVisible.insert(m_LightVisible.end(), m_CascadeVisible[i].begin(), m_CascadeVisible[i].end());
+		}
+		std::sort(m_LightVisible.begin(), m_LightVisible.end());
+		m_LightVisible.erase(std::unique(m_LightVisible.begin(), m_LightVisible.end()), m_LightVisible.end());
+	}
+	else {
+		m_CameraVisible.resize(m_Culler.GetCount());
+		for (size_t i = 0; i < m_CameraVisible.size(); i++) m_CameraVisible[i] = uint32_t(i);
+		m_LightVisible = m_CameraVisible;
+		for (auto i = 0u; i < m_ActiveCascadeCount; i++) m_CascadeVisible[i] = m_CameraVisible;
+	}
+
+	auto t1 = std::chrono::high_resolution_clock::now();
+	m_CullMicroSec = std::chrono::duration<double, std::micro>(t1 - t0).count();
+
+	// 遮蔽されたオブジェクトはカメラから描画しない.
+	// 影は遮蔽物の裏からも落ちるので, ライトの可視リストはそのまま使う.
+	if (m_EnableCulling && m_EnableOcclusion) {
+		UpdateOcclusion(objectCount);
+	}
+
+	// パスごとの可視リスト.
+	m_CameraObjects.clear();
+	for (auto index : m_CameraVisible) {
+		if (index < objectCount) m_CameraObjects.push_back(m_GameObjects[index]);
+	}
+
+	for (auto i = 0u; i < m_ActiveCascadeCount; i++) {
+		m_CascadeObjects[i].clear();
+		m_StaticCascadeObjects[i].clear();
+
+		if (!m_EnableShadowCache) {
+			for (auto index : m_CascadeVisible[i]) {
+				if (index < objectCount) m_CascadeObjects[i].push_back(m_GameObjects[index]);
+			}
+			continue;
+		}
+
+		// 静的なものは描き直す範囲に掛かる場合だけキャッシュへ, 動的なものは毎フレーム重ねて描く.
+		m_ShadowCache.BuildDrawList(i, m_CascadeVisible[i], m_ShadowStaticDraws, m_ShadowDynamicDraws);
+		for (auto index : m_ShadowStaticDraws)  m_StaticCascadeObjects[i].push_back(m_GameObjects[index]);
+		for (auto index : m_ShadowDynamicDraws) m_CascadeObjects[i].push_back(m_GameObjects[index]);
+		m_ShadowDirtyRects[i] = m_ShadowCache.GetDirtyRect(i);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      負荷計測用のエンティティ数を合わせ, 格子状に並べます.
+//-----------------------------------------------------------------------------
+void SampleApp::UpdateStressEntities()
+{
+	const size_t count = m_GameObjects.empty() ? 0 : size_t(m_StressCount);
+	if (m_StressEntities.size() == count) return;
+
+	while (m_StressEntities.size() > count) {
+		m_Hierarchy.Destroy(m_Registry.Get<TransformNode>(m_StressEntities.back()).Node);
+		m_Registry.Destroy(m_StressEntities.back());
+		m_StressEntities.pop_back();
+	}
+
+	while (m_StressEntities.size() < count) {
+		Entity entity = m_Registry.Create();
+		if (entity == NullEntity) break;
+
+		m_Registry.Add<TransformNode>(entity, m_Hierarchy.Create(m_StressRoot));
+		m_Registry.Add<ModelRenderer>(entity, &m_GameObjects[0]->m_Model);
+		m_StressEntities.push_back(entity);
+	}
+
+	// 格子の幅が変わるので全て並べ直す.
+	const int side = int(std::ceil(std::sqrt(float(m_StressEntities.size()))));
+	for (int i = 0; i < int(m_StressEntities.size()); i++) {
+		const uint32_t node = m_Registry.Get<TransformNode>(m_StressEntities[i]).Node;
+		m_Hierarchy.SetPosition(node, Vector3(float(i % side - side / 2) * 1.5f, 0.0f, -3.0f - float(i / side) * 1.5f));
 	}
 }
 
+//-----------------------------------------------------------------------------
+//      遮蔽物を描画し, カメラの可視リストから遮蔽されたものを取り除きます.
+//-----------------------------------------------------------------------------
+void SampleApp::UpdateOcclusion(size_t objectCount)
+{
+	auto t0 = std::chrono::high_resolution_clock::now();
+
+	// 視錐台内の遮蔽物だけを描画する. 負荷計測用は先頭のモデルと同じ遮蔽物を使う.
+	m_OcclusionCuller.Begin(m_View * m_Proj);
+	for (auto index : m_CameraVisible) {
+		const size_t model = (index < objectCount) ? index : 0;
+		if (model >= m_Occluders.size()) continue;
+
+		const Matrix world = (index < objectCount)
+			? m_GameObjects[index]->Transform().GetTransform()
+			: m_StressWorlds[index - objectCount];
+		m_OcclusionCuller.AddOccluder(&m_Occluders[model], world);
+	}
+	m_OcclusionCuller.Render();
+
+	// 遮蔽物自身は自分の深度より手前に AABB があるので取り除かれない.
+	size_t count = 0;
+	for (auto index : m_CameraVisible) {
+		DirectX::XMFLOAT3 center;
+		DirectX::XMFLOAT3 extent;
+		m_Culler.GetBounds(index, center, extent);
+		if (m_OcclusionCuller.TestAABB(center, extent)) m_CameraVisible[count++] = index;
+	}
+	m_CameraVisible.resize(count);
+
+	auto t1 = std::chrono::high_resolution_clock::now();
+	m_OcclusionMicroSec = std::chrono::duration<double, std::micro>(t1 - t0).count();
+}
+
+//-----------------------------------------------------------------------------
+//      画面上の位置からレイを飛ばしてオブジェクトを選択します.
+//-----------------------------------------------------------------------------
+void SampleApp::PickObject(float screenX, float screenY)
+{
+	auto x =  2.0f * screenX / float(m_Width)  - 1.0f;
+	auto y = -2.0f * screenY / float(m_Height) + 1.0f;
+
+	Matrix invViewProj = (m_View * m_Proj).Invert();
+	Vector3 nearPos = Vector3::Transform(Vector3(x, y, 0.0f), invViewProj);
+	Vector3 farPos  = Vector3::Transform(Vector3(x, y, 1.0f), invViewProj);
+
+	uint32_t index    = 0;
+	float    distance = 0.0f;
+	if (m_SceneBVH.RayCast(nearPos, farPos - nearPos, 1.0f, &index, &distance) && index < m_GameObjects.size()) {
+		m_PickedObject = int(index);
+	}
+	else {
+		m_PickedObject = -1;
+	}
+	m_PickChanged = true;
+}
+
 //-----------------------------------------------------------------------------
 //      プリ/ポストプロセス
 //-----------------------------------------------------------------------------
@@ -541,97 +1351,104 @@ void SampleApp::RenderShadowMap(ID3D12GraphicsCommandList* pCmd, DepthTarget& De
 	ShadowMap::DrawSource s{
 		DepthDest,
 		m_CommonBufferManager,
-		m_GameObjects,
-		m_LightDirection
+		m_CascadeObjects,
+		m_ActiveCascadeCount,
+		ShadowTileSize,
+		m_LightDirection,
+		&m_InstanceBuffer,
+		m_EnableShadowCache ? &m_CommonRTManager.m_StaticShadowTarget : nullptr,
+		m_StaticCascadeObjects,
+		m_ShadowDirtyRects
 	};
+
+	// キャッシュの描き直しと複製の前後の遷移はグラフが発行する.
+	if (BeginGraphPass(pCmd, GRAPH_PASS_SHADOW_CACHE)) {
+		m_ShadowMap.DrawStaticShadowMap(pCmd, m_FrameIndex, s);
+	}
+
+	// 描き直した範囲も前のフレームで重ねた動的な遮蔽物もなければ, アトラスはキャッシュと同じ内容.
+	if (BeginGraphPass(pCmd, GRAPH_PASS_SHADOW_COPY) && m_ShadowCache.NeedsCopy()) {
+		m_ShadowMap.CopyStaticShadowMap(pCmd, s);
+	}
+
+	BeginGraphPass(pCmd, GRAPH_PASS_SHADOW);
 	m_ShadowMap.DrawShadowMap(pCmd, m_FrameIndex, s);
 }
 
-void SampleApp::RenderPreProcess(ID3D12GraphicsCommandList* pCmd) {
+void SampleApp::RenderPreNormal(ID3D12GraphicsCommandList* pCmd) {
 	
 	PreNormalRenderer::DrawSource s{
-		m_CommonRTManager.m_NormalTarget,
-		m_CommonRTManager.m_PreDepthTarget,
+		GetGraphColor(GRAPH_RES_NORMAL),
+		GetGraphDepth(GRAPH_RES_PRE_DEPTH),
 		m_CommonBufferManager,
-		m_GameObjects
+		m_CameraObjects
 	};
 	m_PreNormalRenderer.Draw(pCmd, m_FrameIndex, s);
-
-
-	RenderShadowMap(pCmd, m_CommonRTManager.m_SceneShadowTarget);
 }
 
 void SampleApp::RenderPostProcess(ID3D12GraphicsCommandList* pCmd)
 {
-	RenderBloom(pCmd);
+	{
+		PROFILE_SCOPE("Bloom");
+		m_GpuProfiler.Begin(pCmd, m_GpuScope[GPU_SCOPE_BLOOM]);
+		RenderBloom(pCmd);
+		m_GpuProfiler.End(pCmd, m_GpuScope[GPU_SCOPE_BLOOM]);
+	}
 
-	// トーンマップ
+	// トーンマップ. バックバッファに書き込むのでカリングされない.
+	if (!BeginGraphPass(pCmd, GRAPH_PASS_TONEMAP)) return;
+	PROFILE_SCOPE("Tonemap");
 	ToneMap::DrawSource s{
 		m_ColorTarget[m_FrameIndex],
 		m_DepthTarget,
-		m_CommonRTManager.m_TempColorTarget,
+		GetGraphColor(GRAPH_RES_BLOOM_RESULT),
 		m_CommonBufferManager.m_QuadVB
 	};
+	m_GpuProfiler.Begin(pCmd, m_GpuScope[GPU_SCOPE_TONEMAP]);
 	m_ToneMap.DrawTonemap(pCmd, m_FrameIndex, s);
+	m_GpuProfiler.End(pCmd, m_GpuScope[GPU_SCOPE_TONEMAP]);
 }
 
 void SampleApp::RenderBloom(ID3D12GraphicsCommandList* pCmd) {
 	// 高輝度抽出
-	ExtractHightIntensity::DrawSource es{
-		m_CommonRTManager.m_TempColorTarget,
-		m_CommonRTManager.m_SceneColorTarget,
-		m_CommonBufferManager.m_QuadVB
-	};
-	m_ExtractHight.Draw(pCmd, m_FrameIndex, es);
-
-
-	// ガウシアンフィルター
-	GaussianFilter::DrawSource gs1{
-		m_CommonRTManager.m_BloomColorTarget[0],
-		m_CommonRTManager.m_TempColorTarget,
-		m_CommonBufferManager.m_QuadVB,
-		0,
-		2
-	};
-	m_GaussianFilter.Draw(pCmd, m_FrameIndex, gs1);
-
-	GaussianFilter::DrawSource gs2{
-		m_CommonRTManager.m_BloomColorTarget[1],
-		m_CommonRTManager.m_BloomColorTarget[0],
-		m_CommonBufferManager.m_QuadVB,
-		1,
-		4
-	};
-	m_GaussianFilter.Draw(pCmd, m_FrameIndex, gs2);
-
-	GaussianFilter::DrawSource gs3{
-		m_CommonRTManager.m_BloomColorTarget[2],
-		m_CommonRTManager.m_BloomColorTarget[1],
-		m_CommonBufferManager.m_QuadVB,
-		2,
-		8
-	};
-	m_GaussianFilter.Draw(pCmd, m_FrameIndex, gs3);
-
-	GaussianFilter::DrawSource gs4{
-		m_CommonRTManager.m_BloomColorTarget[3],
-		m_CommonRTManager.m_BloomColorTarget[2],
-		m_CommonBufferManager.m_QuadVB,
-		3,
-		16
-	};
-	m_GaussianFilter.Draw(pCmd, m_FrameIndex, gs4);
+	if (BeginGraphPass(pCmd, GRAPH_PASS_EXTRACT)) {
+		ExtractHightIntensity::DrawSource es{
+			GetGraphColor(GRAPH_RES_BRIGHT),
+			GetGraphColor(GRAPH_RES_SCENE_COLOR),
+			m_CommonBufferManager.m_QuadVB
+		};
+		m_ExtractHight.Draw(pCmd, m_FrameIndex, es);
+	}
 
+	// ガウシアンフィルター. 1/2 から 1/16 まで順に縮小する.
+	for (uint32_t i = 0; i < 4; i++) {
+		if (!BeginGraphPass(pCmd, GRAPH_PASS(GRAPH_PASS_GAUSS0 + i))) continue;
+
+		GaussianFilter::DrawSource gs{
+			GetGraphColor(GRAPH_RES(GRAPH_RES_BLOOM0 + i)),
+			GetGraphColor((i == 0) ? GRAPH_RES_BRIGHT : GRAPH_RES(GRAPH_RES_BLOOM0 + i - 1)),
+			m_CommonBufferManager.m_QuadVB,
+			int(i),
+			float(2 << i)
+		};
+		m_GaussianFilter.Draw(pCmd, m_FrameIndex, gs);
+	}
 
 	// ブルーム合成
-	BloomComposition::DrawSource bs{
-		m_CommonRTManager.m_TempColorTarget,
-		m_CommonRTManager.m_SceneColorTarget,
-		m_CommonRTManager.m_BloomColorTarget,
-		m_CommonBufferManager.m_QuadVB
-	};
-	m_BloomComp.Draw(pCmd, m_FrameIndex, bs);
-
+	if (BeginGraphPass(pCmd, GRAPH_PASS_COMPOSITE)) {
+		BloomComposition::DrawSource bs{
+			GetGraphColor(GRAPH_RES_BLOOM_RESULT),
+			GetGraphColor(GRAPH_RES_SCENE_COLOR),
+			{
+				&GetGraphColor(GRAPH_RES_BLOOM0),
+				&GetGraphColor(GRAPH_RES_BLOOM1),
+				&GetGraphColor(GRAPH_RES_BLOOM2),
+				&GetGraphColor(GRAPH_RES_BLOOM3),
+			},
+			m_CommonBufferManager.m_QuadVB
+		};
+		m_BloomComp.Draw(pCmd, m_FrameIndex, bs);
+	}
 }
 
 void SampleApp::RenderImGui(ID3D12GraphicsCommandList* pImGuiCmd)
@@ -869,4 +1686,71 @@ void SampleApp::ChangeDisplayMode(bool hdr)
 			"SDR設定成功",
 			MB_OK | MB_ICONINFORMATION);
 	}
-}
\ No newline at end of file
+}
+
+//-----------------------------------------------------------------------------
+//      プロファイラの結果をフレームグラフで表示します.
+//-----------------------------------------------------------------------------
+void SampleApp::DrawProfilerFlameGraph()
+{
+	const auto& profiler  = Profiler::GetInstance();
+	const auto& nodes     = profiler.GetNodes();
+	const auto  rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+	const auto  width     = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+	auto pDrawList = ImGui::GetWindowDrawList();
+
+	// ノードはスレッドごとに開始時刻順に並んでいる.
+	size_t begin = 0;
+	while (begin < nodes.size()) {
+		const auto thread = nodes[begin].Thread;
+		const auto isGpu  = (thread == Profiler::GpuThread);
+
+		auto     end      = begin;
+		uint32_t maxDepth = 0;
+		double   spanMs   = isGpu ? 0.0 : profiler.GetFrameMs();
+		for (; end < nodes.size() && nodes[end].Thread == thread; ++end) {
+			maxDepth = std::max(maxDepth, nodes[end].Depth);
+			spanMs   = std::max(spanMs, nodes[end].StartMs + nodes[end].DurationMs);
+		}
+		spanMs = std::max(spanMs, 1e-3);
+
+		if (isGpu) {
+			ImGui::Text("GPU (%.3f ms)", spanMs);
+		}
+		else {
+			const auto name = profiler.GetThreadName(thread);
+			if (name.empty()) ImGui::Text("Thread %u (%.3f ms)", thread, spanMs);
+			else              ImGui::Text("%s (%.3f ms)", name.c_str(), spanMs);
+		}
+
+		const auto origin = ImGui::GetCursorScreenPos();
+		const auto height = rowHeight * float(maxDepth + 1);
+		const auto scale  = width / float(spanMs);
+		pDrawList->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + height), IM_COL32(32, 32, 32, 255));
+
+		for (auto i = begin; i < end; ++i) {
+			const auto& node = nodes[i];
+			const auto x0 = origin.x + float(std::max(node.StartMs, 0.0)) * scale;
+			const auto x1 = std::max(x0 + 1.0f, origin.x + float(node.StartMs + node.DurationMs) * scale);
+			const auto y0 = origin.y + rowHeight * float(node.Depth);
+			const ImVec2 min(x0, y0);
+			const ImVec2 max(std::min(x1, origin.x + width), y0 + rowHeight - 1.0f);
+
+			// 同じパスはフレームが変わっても同じ色にする.
+			float r, g, b;
+			ImGui::ColorConvertHSVtoRGB(float(node.Path % 97) / 97.0f, 0.5f, 0.8f, r, g, b);
+			pDrawList->AddRectFilled(min, max, ImGui::GetColorU32(ImVec4(r, g, b, 1.0f)));
+
+			if (ImGui::CalcTextSize(node.Name).x + 4.0f < max.x - min.x) {
+				pDrawList->AddText(ImVec2(min.x + 2.0f, min.y + 2.0f), IM_COL32(0, 0, 0, 255), node.Name);
+			}
+
+			if (ImGui::IsMouseHoveringRect(min, max)) {
+				ImGui::SetTooltip("%s\n%.3f ms\navg %.3f / min %.3f / max %.3f ms", node.Name, node.DurationMs, node.AvgMs, node.MinMs, node.MaxMs);
+			}
+		}
+
+		ImGui::Dummy(ImVec2(width, height));
+		begin = end;
+	}
+}
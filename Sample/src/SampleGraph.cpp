@@ -0,0 +1,126 @@
+﻿//-----------------------------------------------------------------------------
+// File : SampleGraph.cpp
+// Desc : Sample Render Graph Declaration.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include "SampleGraph.h"
+
+
+//-----------------------------------------------------------------------------
+//      フレームのパスとリソースをレンダーグラフに登録します.
+//-----------------------------------------------------------------------------
+void DeclareSampleGraph
+(
+	RenderGraph&                graph,
+	const RenderGraphResources& resources,
+	uint32_t                    width,
+	uint32_t                    height,
+	bool                        keepTargets,
+	bool                        shadowCache,
+	uint32_t*                   pPasses,
+	uint32_t*                   pRes
+)
+{
+	const auto colorFormat = DXGI_FORMAT_R10G10B10A2_UNORM;
+	const auto depthFormat = DXGI_FORMAT_D32_FLOAT;
+	const auto RT  = D3D12_RESOURCE_STATE_RENDER_TARGET;
+	const auto DW  = D3D12_RESOURCE_STATE_DEPTH_WRITE;
+	const auto PSR = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+	const auto CS  = D3D12_RESOURCE_STATE_COPY_SOURCE;
+	const auto CD  = D3D12_RESOURCE_STATE_COPY_DEST;
+
+	// デバイスがなければサイズはグラフが推定する.
+	auto sceneColor = resources.MakeDesc(width, height, colorFormat, false);
+	sceneColor.ClearColor[0] = 0.2f;
+	sceneColor.ClearColor[1] = 0.2f;
+	sceneColor.ClearColor[2] = 0.2f;
+
+	pRes[GRAPH_RES_NORMAL]       = graph.CreateTexture("Normal",      resources.MakeDesc(width, height, colorFormat, false));
+	pRes[GRAPH_RES_PRE_DEPTH]    = graph.CreateTexture("PreDepth",    resources.MakeDesc(width, height, depthFormat, true));
+	pRes[GRAPH_RES_SCENE_COLOR]  = graph.CreateTexture("SceneColor",  sceneColor);
+	pRes[GRAPH_RES_SCENE_DEPTH]  = graph.CreateTexture("SceneDepth",  resources.MakeDesc(width, height, depthFormat, true));
+	pRes[GRAPH_RES_BRIGHT]       = graph.CreateTexture("Bright",      resources.MakeDesc(width, height, colorFormat, false));
+	for (uint32_t i = 0; i < 4; i++) {
+		const char* names[] = { "Bloom0", "Bloom1", "Bloom2", "Bloom3" };
+		pRes[GRAPH_RES_BLOOM0 + i] = graph.CreateTexture(names[i], resources.MakeDesc(width >> (i + 1), height >> (i + 1), colorFormat, false));
+	}
+	pRes[GRAPH_RES_BLOOM_RESULT] = graph.CreateTexture("BloomResult", resources.MakeDesc(width, height, colorFormat, false));
+	pRes[GRAPH_RES_SHADOW]       = graph.ImportTexture("Shadow",     PSR, PSR);
+	pRes[GRAPH_RES_BACK_BUFFER]  = graph.ImportTexture("BackBuffer", D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_PRESENT);
+	pRes[GRAPH_RES_SHADOW_STATIC] = shadowCache ? graph.ImportTexture("ShadowStatic", DW, DW) : RenderGraph::InvalidIndex;
+
+	// 法線と深度はフレーム内で読まないが, 事前描画の結果として残すので出力にする.
+	graph.Export(pRes[GRAPH_RES_NORMAL]);
+	graph.Export(pRes[GRAPH_RES_PRE_DEPTH]);
+
+	// 確認用に表示する場合は全て出力にする. 出力はメモリを共有しない.
+	if (keepTargets) {
+		for (auto i = uint32_t(GRAPH_RES_SCENE_COLOR); i < GRAPH_RES_SHADOW; i++) {
+			graph.Export(pRes[i]);
+		}
+	}
+
+	auto pass = graph.AddPass("PreNormal");
+	graph.Write(pass, pRes[GRAPH_RES_NORMAL],    RT);
+	graph.Write(pass, pRes[GRAPH_RES_PRE_DEPTH], DW);
+	pPasses[GRAPH_PASS_PRE_NORMAL] = pass;
+
+	// キャッシュの描き直しと複製はパスを分け, 複製元と複製先への遷移をグラフに任せる.
+	pPasses[GRAPH_PASS_SHADOW_CACHE] = RenderGraph::InvalidIndex;
+	pPasses[GRAPH_PASS_SHADOW_COPY]  = RenderGraph::InvalidIndex;
+	if (shadowCache) {
+		pass = graph.AddPass("ShadowCache");
+		graph.Write(pass, pRes[GRAPH_RES_SHADOW_STATIC], DW);
+		pPasses[GRAPH_PASS_SHADOW_CACHE] = pass;
+
+		pass = graph.AddPass("ShadowCopy");
+		graph.Read (pass, pRes[GRAPH_RES_SHADOW_STATIC], CS);
+		graph.Write(pass, pRes[GRAPH_RES_SHADOW],        CD);
+		pPasses[GRAPH_PASS_SHADOW_COPY] = pass;
+	}
+
+	pass = graph.AddPass("Shadow");
+	graph.Write(pass, pRes[GRAPH_RES_SHADOW], DW);
+	pPasses[GRAPH_PASS_SHADOW] = pass;
+
+	pass = graph.AddPass("Sky");
+	graph.Write(pass, pRes[GRAPH_RES_SCENE_COLOR], RT);
+	graph.Write(pass, pRes[GRAPH_RES_SCENE_DEPTH], DW);
+	pPasses[GRAPH_PASS_SKY] = pass;
+
+	pass = graph.AddPass("Opaque");
+	graph.Read (pass, pRes[GRAPH_RES_SHADOW],      PSR);
+	graph.Write(pass, pRes[GRAPH_RES_SCENE_COLOR], RT);
+	graph.Write(pass, pRes[GRAPH_RES_SCENE_DEPTH], DW);
+	pPasses[GRAPH_PASS_OPAQUE] = pass;
+
+	pass = graph.AddPass("Extract");
+	graph.Read (pass, pRes[GRAPH_RES_SCENE_COLOR], PSR);
+	graph.Write(pass, pRes[GRAPH_RES_BRIGHT],      RT);
+	pPasses[GRAPH_PASS_EXTRACT] = pass;
+
+	for (uint32_t i = 0; i < 4; i++) {
+		const char* names[] = { "Gauss0", "Gauss1", "Gauss2", "Gauss3" };
+		pass = graph.AddPass(names[i]);
+		graph.Read (pass, pRes[(i == 0) ? uint32_t(GRAPH_RES_BRIGHT) : GRAPH_RES_BLOOM0 + i - 1], PSR);
+		graph.Write(pass, pRes[GRAPH_RES_BLOOM0 + i], RT);
+		pPasses[GRAPH_PASS_GAUSS0 + i] = pass;
+	}
+
+	pass = graph.AddPass("Composite");
+	graph.Read (pass, pRes[GRAPH_RES_SCENE_COLOR], PSR);
+	for (uint32_t i = 0; i < 4; i++) {
+		graph.Read(pass, pRes[GRAPH_RES_BLOOM0 + i], PSR);
+	}
+	graph.Write(pass, pRes[GRAPH_RES_BLOOM_RESULT], RT);
+	pPasses[GRAPH_PASS_COMPOSITE] = pass;
+
+	pass = graph.AddPass("ToneMap");
+	graph.Read (pass, pRes[GRAPH_RES_BLOOM_RESULT], PSR);
+	graph.Write(pass, pRes[GRAPH_RES_BACK_BUFFER],  RT);
+	pPasses[GRAPH_PASS_TONEMAP] = pass;
+}
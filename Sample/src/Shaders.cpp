@@ -10,29 +10,38 @@
 // BasicShader
 bool BasicShader::CreateRootSig(ComPtr<ID3D12Device> pDevice) {
 	RootSignature::Desc desc;
-	desc.Begin(13)
+	desc.Begin(16)
 		
-		// ʂ̒萔obt@
-		.SetCBV(ShaderStage::ALL, 2, 3)  // lightCB
+		// 定数バッファはテーブルを経由せずルートCBVで参照する.
+		// 共通の定数バッファ
+		.SetRootCBV(ShaderStage::ALL, 2, 3)  // lightCB
 
 
-		//VS̒萔obt@
-		.SetCBV(ShaderStage::VS, 0, 0)	// VP
-		.SetCBV(ShaderStage::VS, 1, 1)	// meshCB
+		//VSの定数バッファ
+		.SetRootCBV(ShaderStage::VS, 0, 0)	// VP
+		.SetRootCBV(ShaderStage::VS, 1, 1)	// meshCB
 
-		//PS̒萔obt@
-		.SetCBV(ShaderStage::PS, 3, 2)  // CameraCB
-		.SetCBV(ShaderStage::PS, 4, 4)  // MaterialCB
+		//PSの定数バッファ
+		.SetRootCBV(ShaderStage::PS, 3, 2)  // CameraCB
+		// マテリアルのパラメータはパラメータブロックから読むので MaterialCB(b4) は持たない.
 
-		// eNX`
-		.SetSRV(ShaderStage::PS, 5, 0)
-		.SetSRV(ShaderStage::PS, 6, 1)
-		.SetSRV(ShaderStage::PS, 7, 2)
-		.SetSRV(ShaderStage::PS, 8, 3)
-		.SetSRV(ShaderStage::PS, 9, 4)
-		.SetSRV(ShaderStage::PS, 10, 5)
-		.SetSRV(ShaderStage::PS, 11, 6)
-		.SetSRV(ShaderStage::PS, 12, 9)	// ShadowMap
+		// テクスチャ
+		.SetSRV(ShaderStage::PS, 4, 0)
+		.SetSRV(ShaderStage::PS, 5, 1)
+		.SetSRV(ShaderStage::PS, 6, 2)
+		.SetSRV(ShaderStage::PS, 7, 3)
+		.SetSRV(ShaderStage::PS, 8, 4)
+		.SetSRV(ShaderStage::PS, 9, 5)
+		.SetSRV(ShaderStage::PS, 10, 6)
+		.SetSRV(ShaderStage::PS, 11, 9)	// ShadowMap
+
+		// マテリアルインスタンス
+		.SetSRV(ShaderStage::PS, 12, 10)		// パラメータブロック
+		.SetConstants(ShaderStage::ALL, 13, 5, 1)	// ブロック番号 (VSから出力する)
+
+		// インスタンス描画
+		.SetSRV(ShaderStage::VS, 14, 11)		// ワールド行列
+		.SetConstants(ShaderStage::VS, 15, 6, 1)	// 先頭インスタンス番号
 
 
 		.AddStaticSmp(ShaderStage::PS, 0, SamplerState::LinearWrap)
@@ -66,7 +75,7 @@ bool BasicShader::CreatePipeLineState(ComPtr<ID3D12Device> pDevice, DXGI_FORMAT
 		{ "TANGENT",  0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
 	};
 
-	// OtBbNXpCvCXe[gݒ.
+	// グラフィックスパイプラインステートを設定.
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
 	desc.InputLayout                        = { elements, 4 };
 	desc.pRootSignature                     = m_RootSig.GetPtr();
@@ -84,52 +93,200 @@ bool BasicShader::CreatePipeLineState(ComPtr<ID3D12Device> pDevice, DXGI_FORMAT
 	desc.SampleDesc.Count = 1;
 	desc.SampleDesc.Quality = 0;
 
-	// pCvCXe[g𐶐.
+	// パイプラインステートを生成.
 	if (!CreateGraphicsPipelineState(pDevice, desc, m_pPSO))return false;
 
+	// インスタンス描画用は頂点シェーダのみ差し替える.
+	ComPtr<ID3DBlob> pInstancedVSBlob;
+	if (!SearchAndLoadShader(m_InstancedVSPath, pInstancedVSBlob)) return false;
+
+	desc.VS = { pInstancedVSBlob->GetBufferPointer(), pInstancedVSBlob->GetBufferSize() };
+	if (!CreateGraphicsPipelineState(pDevice, desc, m_pInstancedPSO))return false;
+
 	return true;
 }
-void BasicShader::SetShader(ID3D12GraphicsCommandList* pCmd, int frameindex, Material& mat, int id, const ConstantBuffer* meshCB, const CommonBufferManager& commonbufmanager, const SkyManager& skyManager)
+
+void BasicShader::Term()
 {
-	//@}eAʂ̃obt@
-	{
-		pCmd->SetGraphicsRootSignature(m_RootSig.GetPtr());
-
-		// RRO
-		{
-			pCmd->SetGraphicsRootDescriptorTable(0, commonbufmanager.m_TransformCB[frameindex].GetHandleGPU());
-			pCmd->SetGraphicsRootDescriptorTable(2, commonbufmanager.m_LightCB[frameindex].GetHandleGPU());
-			pCmd->SetGraphicsRootDescriptorTable(3, commonbufmanager.m_CommonCB[frameindex].GetHandleGPU());
-		}
-
-		pCmd->SetGraphicsRootDescriptorTable(5, skyManager.m_IBLBaker.GetHandleGPU_DFG());
-		pCmd->SetGraphicsRootDescriptorTable(6, skyManager.m_IBLBaker.GetHandleGPU_DiffuseLD());
-		pCmd->SetGraphicsRootDescriptorTable(7, skyManager.m_IBLBaker.GetHandleGPU_SpecularLD());
-	}
-	
-	pCmd->SetGraphicsRootDescriptorTable(1, meshCB[frameindex].GetHandleGPU());
+	m_pInstancedPSO.Reset();
+	ModelShader::Term();
+}
+
+bool BasicShader::SupportsInstancing() const
+{
+	return m_pInstancedPSO != nullptr;
+}
+
+void BasicShader::SetPipelineVariant(ID3D12GraphicsCommandList* pCmd, bool instanced)
+{
+	pCmd->SetPipelineState(instanced ? m_pInstancedPSO.Get() : m_pPSO.Get());
+}
+
+void BasicShader::SetInstanceRange(ID3D12GraphicsCommandList* pCmd, D3D12_GPU_DESCRIPTOR_HANDLE instances, uint32_t offset)
+{
+	pCmd->SetGraphicsRootDescriptorTable(14, instances);
+	pCmd->SetGraphicsRoot32BitConstant(15, offset, 0);
+}
+
+void BasicShader::SetPassState(ID3D12GraphicsCommandList* pCmd, int frameindex, const CommonBufferManager& commonbufmanager, const SkyManager& skyManager)
+{
+	//　マテリアル共通のバッファ
+	pCmd->SetGraphicsRootSignature(m_RootSig.GetPtr());
+	pCmd->SetPipelineState(m_pPSO.Get());
+
+	pCmd->SetGraphicsRootConstantBufferView(0, commonbufmanager.m_TransformCB[frameindex].GetAddress());
+	pCmd->SetGraphicsRootConstantBufferView(2, commonbufmanager.m_LightCB[frameindex].GetAddress());
+	pCmd->SetGraphicsRootConstantBufferView(3, commonbufmanager.m_CommonCB[frameindex].GetAddress());
+
+	pCmd->SetGraphicsRootDescriptorTable(4, skyManager.m_IBLBaker.GetHandleGPU_DFG());
+	pCmd->SetGraphicsRootDescriptorTable(5, skyManager.m_IBLBaker.GetHandleGPU_DiffuseLD());
+	pCmd->SetGraphicsRootDescriptorTable(6, skyManager.m_IBLBaker.GetHandleGPU_SpecularLD());
 
-	// VhE}bv
+	// シャドウマップ
 	if (commonbufmanager.m_RTManager != nullptr) {
 		auto handle = commonbufmanager.m_RTManager->m_SceneShadowTarget.GetHandleSRV()->HandleGPU;
-		pCmd->SetGraphicsRootDescriptorTable(12, handle);
+		pCmd->SetGraphicsRootDescriptorTable(11, handle);
 	}
 	else {
 		ELOG("Shadow Map Error");
-		return;
 	}
+}
 
-	//  }eA萔obt@o
-	pCmd->SetGraphicsRootDescriptorTable(4, mat.GetBufferHandle(id));
+void BasicShader::SetMaterialState(ID3D12GraphicsCommandList* pCmd, int frameindex, Material& mat, int id, const MaterialInstance* pInstance)
+{
+	// インスタンスのパラメータブロック
+	if (pInstance != nullptr) {
+		pCmd->SetGraphicsRootDescriptorTable(12, pInstance->GetBuffer()->GetHandleGPU(frameindex));
+	}
+	else {
+		ELOG("Material Instance Error");
+	}
 
-	//@}eAƂɈقȂobt@
-	{
-		pCmd->SetGraphicsRootDescriptorTable(8,		mat.GetTextureHandle(id, Material::TEXTURE_USAGE_04));
-		pCmd->SetGraphicsRootDescriptorTable(9,		mat.GetTextureHandle(id, Material::TEXTURE_USAGE_05));
-		pCmd->SetGraphicsRootDescriptorTable(10,	mat.GetTextureHandle(id, Material::TEXTURE_USAGE_06));
-		pCmd->SetGraphicsRootDescriptorTable(11,	mat.GetTextureHandle(id, Material::TEXTURE_USAGE_03));
+	//　マテリアルごとに異なるバッファ
+	pCmd->SetGraphicsRootDescriptorTable(7,		mat.GetTextureHandle(id, Material::TEXTURE_USAGE_04));
+	pCmd->SetGraphicsRootDescriptorTable(8,		mat.GetTextureHandle(id, Material::TEXTURE_USAGE_05));
+	pCmd->SetGraphicsRootDescriptorTable(9,		mat.GetTextureHandle(id, Material::TEXTURE_USAGE_06));
+	pCmd->SetGraphicsRootDescriptorTable(10,	mat.GetTextureHandle(id, Material::TEXTURE_USAGE_03));
+}
 
+void BasicShader::SetMeshState(ID3D12GraphicsCommandList* pCmd, int frameindex, const ConstantBuffer* meshCB)
+{
+	pCmd->SetGraphicsRootConstantBufferView(1, meshCB[frameindex].GetAddress());
+}
 
-	}
+void BasicShader::SetInstanceState(ID3D12GraphicsCommandList* pCmd, const MaterialInstance* pInstance)
+{
+	if (pInstance == nullptr) return;
+	pCmd->SetGraphicsRoot32BitConstant(13, pInstance->GetIndex(), 0);
+}
+
+// BindlessShader
+BindlessShader::BindlessShader() {
+	m_PSPath = L"BindlessPS.cso";
+}
+
+bool BindlessShader::IsSupported(ID3D12Device* pDevice) {
+	D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+	auto hr = pDevice->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options));
+	if (FAILED(hr)) return false;
+
+	// ヒープ内のCBVや未使用領域もテーブルに含まれるため Tier3 を要求する.
+	return options.ResourceBindingTier >= D3D12_RESOURCE_BINDING_TIER_3;
+}
+
+bool BindlessShader::CreateRootSig(ComPtr<ID3D12Device> pDevice) {
+	RootSignature::Desc desc;
+	desc.Begin(14)
+
+		// 定数バッファはテーブルを経由せずルートCBVで参照する.
+		// 共通の定数バッファ
+		.SetRootCBV(ShaderStage::ALL, 2, 3)  // lightCB
+
+		//VSの定数バッファ
+		.SetRootCBV(ShaderStage::VS, 0, 0)	// VP
+		.SetRootCBV(ShaderStage::VS, 1, 1)	// meshCB
+
+		//PSの定数バッファ
+		.SetRootCBV(ShaderStage::PS, 3, 2)  // CameraCB
+		.SetRootCBV(ShaderStage::PS, 4, 4)  // MaterialCB (テクスチャ番号を含む)
+
+		// テクスチャ
+		.SetSRV(ShaderStage::PS, 5, 0)	// DFG
+		.SetSRV(ShaderStage::PS, 6, 1)	// DiffuseLD
+		.SetSRV(ShaderStage::PS, 7, 2)	// SpecularLD
+		.SetSRV(ShaderStage::PS, 8, 9)	// ShadowMap
+		.SetSRVRange(ShaderStage::PS, 9, 0, UINT_MAX, 1)	// マテリアルテクスチャ(space1)
+
+		// マテリアルインスタンス
+		.SetSRV(ShaderStage::PS, 10, 10)		// パラメータブロック
+		.SetConstants(ShaderStage::ALL, 11, 5, 1)	// ブロック番号 (VSから出力する)
+
+		// インスタンス描画
+		.SetSRV(ShaderStage::VS, 12, 11)		// ワールド行列
+		.SetConstants(ShaderStage::VS, 13, 6, 1)	// 先頭インスタンス番号
+
+		.AddStaticSmp(ShaderStage::PS, 0, SamplerState::LinearWrap)
+		.AddStaticSmp(ShaderStage::PS, 1, SamplerState::LinearWrap)
+		.AddStaticSmp(ShaderStage::PS, 2, SamplerState::LinearWrap)
+		.AddStaticSmp(ShaderStage::PS, 3, SamplerState::LinearWrap)
+		.AddStaticSmp(ShaderStage::PS, 9, SamplerState::LinearClamp)
+		.AllowIL()
+		.End();
+
+	if (!InitRootSignature(pDevice, desc, m_RootSig)) return false;
+
+	return true;
+}
+
+void BindlessShader::SetPassState(ID3D12GraphicsCommandList* pCmd, int frameindex, const CommonBufferManager& commonbufmanager, const SkyManager& skyManager)
+{
+	//　マテリアル共通のバッファ
+	pCmd->SetGraphicsRootSignature(m_RootSig.GetPtr());
 	pCmd->SetPipelineState(m_pPSO.Get());
-}
\ No newline at end of file
+
+	pCmd->SetGraphicsRootConstantBufferView(0, commonbufmanager.m_TransformCB[frameindex].GetAddress());
+	pCmd->SetGraphicsRootConstantBufferView(2, commonbufmanager.m_LightCB[frameindex].GetAddress());
+	pCmd->SetGraphicsRootConstantBufferView(3, commonbufmanager.m_CommonCB[frameindex].GetAddress());
+
+	pCmd->SetGraphicsRootDescriptorTable(5, skyManager.m_IBLBaker.GetHandleGPU_DFG());
+	pCmd->SetGraphicsRootDescriptorTable(6, skyManager.m_IBLBaker.GetHandleGPU_DiffuseLD());
+	pCmd->SetGraphicsRootDescriptorTable(7, skyManager.m_IBLBaker.GetHandleGPU_SpecularLD());
+
+	// シャドウマップ
+	if (commonbufmanager.m_RTManager != nullptr) {
+		auto handle = commonbufmanager.m_RTManager->m_SceneShadowTarget.GetHandleSRV()->HandleGPU;
+		pCmd->SetGraphicsRootDescriptorTable(8, handle);
+	}
+	else {
+		ELOG("Shadow Map Error");
+	}
+}
+
+void BindlessShader::SetMaterialState(ID3D12GraphicsCommandList* pCmd, int frameindex, Material& mat, int id, const MaterialInstance* pInstance)
+{
+	// リソースヒープ全体をテクスチャ配列として公開する.
+	pCmd->SetGraphicsRootDescriptorTable(9, mat.GetPool()->GetHeap()->GetGPUDescriptorHandleForHeapStart());
+
+	//  マテリアルごとに異なるのは定数バッファのみ
+	pCmd->SetGraphicsRootConstantBufferView(4, mat.GetBufferAddress(id));
+
+	// インスタンスのパラメータブロック
+	if (pInstance != nullptr) {
+		pCmd->SetGraphicsRootDescriptorTable(10, pInstance->GetBuffer()->GetHandleGPU(frameindex));
+	}
+	else {
+		ELOG("Material Instance Error");
+	}
+}
+
+void BindlessShader::SetInstanceState(ID3D12GraphicsCommandList* pCmd, const MaterialInstance* pInstance)
+{
+	if (pInstance == nullptr) return;
+	pCmd->SetGraphicsRoot32BitConstant(11, pInstance->GetIndex(), 0);
+}
+
+void BindlessShader::SetInstanceRange(ID3D12GraphicsCommandList* pCmd, D3D12_GPU_DESCRIPTOR_HANDLE instances, uint32_t offset)
+{
+	pCmd->SetGraphicsRootDescriptorTable(12, instances);
+	pCmd->SetGraphicsRoot32BitConstant(13, offset, 0);
+}
@@ -48,7 +48,7 @@ bool ToneMap::CreatePipeLineState(ComPtr<ID3D12Device> pDevice, DXGI_FORMAT rtv_
 		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 	};
 
-	// OtBbNXpCvCXe[gݒ.
+	// グラフィックスパイプラインステートを設定.
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
 	desc.InputLayout                        = { elements, 2 };
 	desc.pRootSignature                     = m_RootSig.GetPtr();
@@ -65,7 +65,7 @@ bool ToneMap::CreatePipeLineState(ComPtr<ID3D12Device> pDevice, DXGI_FORMAT rtv_
 	desc.SampleDesc.Count                   = 1;
 	desc.SampleDesc.Quality                 = 0;
 
-	// pCvCXe[g𐶐.
+	// パイプラインステートを生成.
 	if (!CreateGraphicsPipelineState(pDevice, desc, m_pPSO))return false;
 
 	return true;
@@ -85,25 +85,20 @@ void ToneMap::Term()
 
 void ToneMap::DrawTonemap(ID3D12GraphicsCommandList* pCmd, int frameindex, DrawSource& s)
 {
-	// ݗp\[XoAݒ.
+	// 書き込み用リソースバリア設定.
 
-	DirectX::TransitionResource(pCmd,
-		s.ColorDest.GetResource(),
-		D3D12_RESOURCE_STATE_PRESENT,
-		D3D12_RESOURCE_STATE_RENDER_TARGET);
-
-	// fBXNv^擾.
+	// ディスクリプタ取得.
 	auto handleRTV = s.ColorDest.GetHandleRTV();
 	auto handleDSV = s.DepthDest.GetHandleDSV();
 
-	// _[^[Qbgݒ.
+	// レンダーターゲットを設定.
 	pCmd->OMSetRenderTargets(1, &handleRTV->HandleCPU, FALSE, &handleDSV->HandleCPU);
 
-	// _[^[QbgNA.
+	// レンダーターゲットをクリア.
 	s.ColorDest.ClearView(pCmd);
 	s.DepthDest.ClearView(pCmd);
 
-	// 萔obt@XV
+	// 定数バッファ更新
 	{
 		auto ptr           = m_CB[frameindex].GetPtr<CbTonemap>();
 		ptr->Type          = m_TonemapType;
@@ -121,12 +116,6 @@ void ToneMap::DrawTonemap(ID3D12GraphicsCommandList* pCmd, int frameindex, DrawS
 	pCmd->IASetVertexBuffers(0, 1, &s.VertexBuffer.GetView());
 
 	pCmd->DrawInstanced(3, 1, 0, 0);
-
-	// \p\[XoAݒ.
-	DirectX::TransitionResource(pCmd,
-		s.ColorDest.GetResource(),
-		D3D12_RESOURCE_STATE_RENDER_TARGET,
-		D3D12_RESOURCE_STATE_PRESENT);
 }
 
 void ToneMap::SetLuminance(float base, float max)
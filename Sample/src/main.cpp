@@ -15,7 +15,7 @@
 #include "SampleApp.h"
 
 //-----------------------------------------------------------------------------
-//      CGg[|Cgł.
+//      メインエントリーポイントです.
 //-----------------------------------------------------------------------------
 int wmain(int argc, wchar_t** argv, wchar_t** envp)
 {
@@ -0,0 +1,256 @@
+﻿//-----------------------------------------------------------------------------
+// File : CascadedShadowTest.cpp
+// Desc : Cascaded Shadow Split And Stability Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <CascadedShadow.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      右手系のビュー行列を生成します.
+//-----------------------------------------------------------------------------
+XMFLOAT4X4 MakeLookAt(const XMFLOAT3& eye, const XMFLOAT3& target)
+{
+	XMFLOAT4X4 result;
+	XMStoreFloat4x4(&result, XMMatrixLookAtRH(XMLoadFloat3(&eye), XMLoadFloat3(&target), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)));
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      点を変換して w で除算します.
+//-----------------------------------------------------------------------------
+XMFLOAT3 TransformCoord(const XMFLOAT3& point, const XMFLOAT4X4& matrix)
+{
+	XMFLOAT3 result;
+	XMStoreFloat3(&result, XMVector3TransformCoord(XMLoadFloat3(&point), XMLoadFloat4x4(&matrix)));
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      テストに使うカスケードの設定を生成します.
+//-----------------------------------------------------------------------------
+CascadedShadow::Desc MakeDesc()
+{
+	CascadedShadow::Desc desc;
+	desc.CascadeCount   = CascadedShadow::MaxCascadeCount;
+	desc.Lambda         = 0.75f;
+	desc.NearClip       = 0.1f;
+	desc.FarClip        = 100.0f;
+	desc.TileSize       = 1024;
+	desc.CasterDistance = 50.0f;
+	return desc;
+}
+
+//-----------------------------------------------------------------------------
+//      テストに使うカメラの射影行列を生成します.
+//-----------------------------------------------------------------------------
+XMFLOAT4X4 MakeProj(const CascadedShadow::Desc& desc)
+{
+	XMFLOAT4X4 result;
+	XMStoreFloat4x4(&result, XMMatrixPerspectiveFovRH(XMConvertToRadians(37.5f), 16.0f / 9.0f, desc.NearClip, 1000.0f));
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      分割位置を検証します.
+//-----------------------------------------------------------------------------
+void TestSplits()
+{
+	// 分割位置は単調増加で両端がクリップ面に一致し, λ = 0 で等間隔, λ = 1 で等比になること.
+	float splits[CascadedShadow::MaxCascadeCount + 1];
+	for (auto count = 1u; count <= CascadedShadow::MaxCascadeCount; ++count)
+	{
+		for (auto lambda : { 0.0f, 0.5f, 0.75f, 1.0f })
+		{
+			CascadedShadow::ComputeSplits(count, 0.1f, 100.0f, lambda, splits);
+			auto monotonic = true;
+			for (auto i = 0u; i < count; ++i)
+			{ monotonic &= (splits[i] < splits[i + 1]); }
+			CHECK(monotonic && splits[0] == 0.1f && splits[count] == 100.0f);
+		}
+	}
+
+	CascadedShadow::ComputeSplits(4, 1.0f, 81.0f, 0.0f, splits);
+	CHECK(fabsf(splits[1] - 21.0f) < 1e-4f && fabsf(splits[2] - 41.0f) < 1e-4f && fabsf(splits[3] - 61.0f) < 1e-4f);
+	CascadedShadow::ComputeSplits(4, 1.0f, 81.0f, 1.0f, splits);
+	CHECK(fabsf(splits[1] - 3.0f) < 1e-4f && fabsf(splits[2] - 9.0f) < 1e-4f && fabsf(splits[3] - 27.0f) < 1e-4f);
+}
+
+//-----------------------------------------------------------------------------
+//      不正な設定を検証します.
+//-----------------------------------------------------------------------------
+void TestInvalid()
+{
+	const auto desc     = MakeDesc();
+	const auto proj     = MakeProj(desc);
+	const auto lightDir = XMFLOAT3(1.0f, 1.0f, 1.0f);
+	const auto view     = MakeLookAt(XMFLOAT3(0.0f, 1.0f, 10.0f), XMFLOAT3(0.0f, 0.0f, 0.0f));
+
+	CascadedShadow::Cascade cascades[CascadedShadow::MaxCascadeCount];
+
+	// 不正な設定は失敗すること.
+	auto bad = desc;
+	bad.CascadeCount = 0;
+	CHECK(!CascadedShadow::Compute(view, proj, lightDir, bad, cascades));
+	bad.CascadeCount = CascadedShadow::MaxCascadeCount + 1;
+	CHECK(!CascadedShadow::Compute(view, proj, lightDir, bad, cascades));
+	bad = desc;
+	bad.FarClip = bad.NearClip;
+	CHECK(!CascadedShadow::Compute(view, proj, lightDir, bad, cascades));
+	CHECK(!CascadedShadow::Compute(view, proj, XMFLOAT3(0.0f, 0.0f, 0.0f), desc, cascades));
+
+	// ライトが真上にあっても上方向を切り替えて求まること.
+	CHECK(CascadedShadow::Compute(view, proj, XMFLOAT3(0.0f, 1.0f, 0.0f), desc, cascades));
+	CHECK(std::isfinite(cascades[0].ViewProj._11) && std::isfinite(cascades[0].ViewProj._42));
+}
+
+//-----------------------------------------------------------------------------
+//      投影範囲を検証します.
+//-----------------------------------------------------------------------------
+void TestBounds()
+{
+	const auto desc     = MakeDesc();
+	const auto proj     = MakeProj(desc);
+	const auto lightDir = XMFLOAT3(1.0f, 1.0f, 1.0f);
+	const auto halfTile = float(desc.TileSize) * 0.5f;
+
+	CascadedShadow::Cascade cascades[CascadedShadow::MaxCascadeCount];
+
+	// 分割範囲の8頂点と, ライト側へ CasterDistance 伸ばした範囲が投影範囲に収まること.
+	// テクセル境界への平行移動は半テクセル以内です.
+	auto view = MakeLookAt(XMFLOAT3(3.0f, 2.0f, 10.0f), XMFLOAT3(0.0f, 1.0f, 0.0f));
+	CHECK(CascadedShadow::Compute(view, proj, lightDir, desc, cascades));
+
+	XMFLOAT4X4 invView;
+	XMStoreFloat4x4(&invView, XMMatrixInverse(nullptr, XMLoadFloat4x4(&view)));
+
+	auto tanX    = 1.0f / proj._11;
+	auto tanY    = 1.0f / proj._22;
+	auto margin  = 0.5f / halfTile + 1e-5f;
+	auto scale   = 1.0f / sqrtf(lightDir.x * lightDir.x + lightDir.y * lightDir.y + lightDir.z * lightDir.z);
+	auto inside  = true;
+	auto ordered = true;
+	for (auto i = 0u; i < desc.CascadeCount; ++i)
+	{
+		const auto& c = cascades[i];
+		for (auto corner = 0; corner < 8; ++corner)
+		{
+			auto depth = (corner & 4) ? c.SplitFar : c.SplitNear;
+			auto sx    = (corner & 1) ? 1.0f : -1.0f;
+			auto sy    = (corner & 2) ? 1.0f : -1.0f;
+			auto p     = TransformCoord(XMFLOAT3(sx * depth * tanX, sy * depth * tanY, -depth), invView);
+			auto q     = TransformCoord(p, c.ViewProj);
+			inside &= (fabsf(q.x) <= 1.0f + margin && fabsf(q.y) <= 1.0f + margin && q.z >= 0.0f && q.z <= 1.0f);
+		}
+
+		auto d      = (c.Radius + desc.CasterDistance * 0.99f) * scale;
+		auto caster = TransformCoord(XMFLOAT3(c.Center.x + lightDir.x * d, c.Center.y + lightDir.y * d, c.Center.z + lightDir.z * d), c.ViewProj);
+		inside &= (caster.z >= 0.0f && caster.z <= 1.0f);
+
+		if (i > 0)
+		{ ordered &= (c.SplitNear == cascades[i - 1].SplitFar && c.TexelSize >= cascades[i - 1].TexelSize); }
+	}
+	CHECK(inside);
+	CHECK(ordered && cascades[0].SplitNear == desc.NearClip && cascades[desc.CascadeCount - 1].SplitFar == desc.FarClip);
+}
+
+//-----------------------------------------------------------------------------
+//      カメラ移動に対する安定性を検証します.
+//-----------------------------------------------------------------------------
+void TestStability()
+{
+	const auto desc     = MakeDesc();
+	const auto proj     = MakeProj(desc);
+	const auto lightDir = XMFLOAT3(1.0f, 1.0f, 1.0f);
+	const auto halfTile = float(desc.TileSize) * 0.5f;
+
+	CascadedShadow::Cascade cascades[CascadedShadow::MaxCascadeCount];
+
+	// カメラを少しずつ移動・回転しても, 投影範囲の大きさと, 固定した点のテクセル内の位置が変わらないこと.
+	// 変わると影の輪郭がカメラの動きに合わせて揺れます.
+	const size_t PointCount = 3;
+	const XMFLOAT3 points[PointCount] = {
+		XMFLOAT3( 0.37f, 0.21f, -0.53f),
+		XMFLOAT3(-4.10f, 0.00f,  2.75f),
+		XMFLOAT3( 7.31f, 1.50f, -9.02f),
+	};
+
+	float radius[CascadedShadow::MaxCascadeCount];
+	float fracX [CascadedShadow::MaxCascadeCount][PointCount];
+	float fracY [CascadedShadow::MaxCascadeCount][PointCount];
+
+	auto sameRadius = true;
+	auto stable     = true;
+	auto maxDrift   = 0.0f;
+	for (auto step = 0; step < 120; ++step)
+	{
+		auto angle  = float(step) * 0.03f;
+		auto eye    = XMFLOAT3(3.0f + float(step) * 0.0137f, 2.0f + float(step) * 0.0041f, 10.0f - float(step) * 0.0213f);
+		auto target = XMFLOAT3(eye.x + sinf(angle), eye.y - 0.2f + 0.1f * sinf(angle * 3.0f), eye.z - cosf(angle));
+		auto view   = MakeLookAt(eye, target);
+		if (!CascadedShadow::Compute(view, proj, lightDir, desc, cascades))
+		{
+			stable = false;
+			break;
+		}
+
+		for (auto i = 0u; i < desc.CascadeCount; ++i)
+		{
+			if (step == 0)
+			{ radius[i] = cascades[i].Radius; }
+			else
+			{ sameRadius &= (cascades[i].Radius == radius[i]); }
+
+			for (size_t j = 0; j < PointCount; ++j)
+			{
+				auto q  = TransformCoord(points[j], cascades[i].ViewProj);
+				auto tx = q.x * halfTile;
+				auto ty = q.y * halfTile;
+				auto fx = tx - floorf(tx);
+				auto fy = ty - floorf(ty);
+				if (step == 0)
+				{
+					fracX[i][j] = fx;
+					fracY[i][j] = fy;
+					continue;
+				}
+
+				// 0 と 1 の境界をまたいだ場合も同じ位置とみなします.
+				auto dx = fx - fracX[i][j];
+				auto dy = fy - fracY[i][j];
+				dx -= roundf(dx);
+				dy -= roundf(dy);
+				maxDrift = std::max(maxDrift, std::max(fabsf(dx), fabsf(dy)));
+			}
+		}
+	}
+	CHECK(stable);
+	CHECK(sameRadius);
+	CHECK(maxDrift < 0.01f);
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main()
+{
+	TestSplits();
+	TestInvalid();
+	TestBounds();
+	TestStability();
+	return TestReport("CascadedShadow");
+}
@@ -0,0 +1,229 @@
+﻿//-----------------------------------------------------------------------------
+// File : CommandRecorderTest.cpp
+// Desc : Parallel Command Recording Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <CommandRecorder.h>
+#include <memory>
+#include <random>
+
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// FakeList structure
+///////////////////////////////////////////////////////////////////////////////
+struct FakeList
+{
+	std::vector<uint32_t>   Commands;       //!< 記録したコマンドです.
+	bool                    Open = false;   //!< 記録中かどうか.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// FakePool class
+///////////////////////////////////////////////////////////////////////////////
+class FakePool
+{
+public:
+	explicit FakePool(uint32_t workerCount)
+	: m_Lists(workerCount)
+	, m_Used (workerCount, 0)
+	{ /* DO_NOTHING */ }
+
+	//-------------------------------------------------------------------------
+	//      使用数をリセットします.
+	//-------------------------------------------------------------------------
+	void Reset()
+	{ std::fill(m_Used.begin(), m_Used.end(), 0u); }
+
+	//-------------------------------------------------------------------------
+	//      ワーカーごとのリストを取得します.
+	//-------------------------------------------------------------------------
+	FakeList* Acquire(uint32_t worker)
+	{
+		if (worker >= m_Lists.size())
+		{ return nullptr; }
+
+		auto& lists = m_Lists[worker];
+		if (m_Used[worker] == lists.size())
+		{ lists.emplace_back(new FakeList()); }
+
+		auto pList = lists[m_Used[worker]++].get();
+		pList->Commands.clear();
+		pList->Open = true;
+		return pList;
+	}
+
+private:
+	std::vector<std::vector<std::unique_ptr<FakeList>>> m_Lists;
+	std::vector<uint32_t>                               m_Used;
+};
+
+//-----------------------------------------------------------------------------
+//      パス番号を上位8bit, アイテム番号を下位24bitに詰めて記録する関数を生成します.
+//-----------------------------------------------------------------------------
+CommandRecorder<FakeList>::RecordFunc Record(uint32_t tag)
+{
+	return [tag](FakeList* pList, const RecordSlot& slot)
+	{
+		if (slot.Begin == slot.End)
+		{ pList->Commands.push_back(tag << 24); }
+
+		for (auto i = slot.Begin; i < slot.End; ++i)
+		{ pList->Commands.push_back((tag << 24) | i); }
+	};
+}
+
+//-----------------------------------------------------------------------------
+//      分割数の計算を検証します.
+//-----------------------------------------------------------------------------
+void TestChunkCount()
+{
+	using Recorder = CommandRecorder<FakeList>;
+
+	CHECK(Recorder::GetChunkCount(0,    64, 8) == 0);
+	CHECK(Recorder::GetChunkCount(1,    64, 8) == 1);
+	CHECK(Recorder::GetChunkCount(127,  64, 8) == 1);
+	CHECK(Recorder::GetChunkCount(128,  64, 8) == 2);
+	CHECK(Recorder::GetChunkCount(5000, 64, 8) == 8);
+
+	// 0 を指定しても 1 として扱う.
+	CHECK(Recorder::GetChunkCount(10, 0, 8) == 8);
+	CHECK(Recorder::GetChunkCount(10, 1, 0) == 1);
+}
+
+//-----------------------------------------------------------------------------
+//      分割したパスの範囲が隙間なく, 偏りなく並ぶことを検証します.
+//-----------------------------------------------------------------------------
+void TestChunkRanges()
+{
+	CommandRecorder<FakeList> recorder;
+	recorder.AddPass("Shadow", Record(1));
+	auto pass = recorder.AddChunkedPass("Opaque", 1003, 100, 4, Record(2));
+	recorder.AddChunkedPass("Empty", 0, 1, 4, Record(3));
+
+	CHECK(pass == 1);
+	CHECK(recorder.GetPassCount() == 3);
+	CHECK(std::string(recorder.GetPassName(pass)) == "Opaque");
+	CHECK(std::string(recorder.GetPassName(10))   == "");
+
+	const auto& slots = recorder.GetSlots();
+	CHECK(slots.size() == 5);
+	CHECK(slots[0].Pass == 0 && slots[0].Begin == 0 && slots[0].End == 0);
+
+	auto next = 0u;
+	for (auto i = 1u; i < slots.size(); ++i)
+	{
+		CHECK(slots[i].Pass  == pass);
+		CHECK(slots[i].Chunk == i - 1);
+		CHECK(slots[i].Begin == next);
+		CHECK(slots[i].End - slots[i].Begin >= 250 && slots[i].End - slots[i].Begin <= 251);
+		next = slots[i].End;
+	}
+	CHECK(next == 1003);
+
+	recorder.Clear();
+	CHECK(recorder.GetPassCount() == 0);
+	CHECK(recorder.GetSlots().empty());
+}
+
+//-----------------------------------------------------------------------------
+//      リストを取得できない場合の結果を検証します.
+//-----------------------------------------------------------------------------
+void TestAcquireFailure()
+{
+	FakeList list;
+	auto calls = 0;
+
+	CommandRecorder<FakeList> recorder;
+	recorder.AddPass("A", Record(1));
+	recorder.AddPass("B", Record(2));
+
+	auto acquire = [&](uint32_t) -> FakeList*
+	{ return (calls++ == 0) ? &list : nullptr; };
+	auto close = [](FakeList* pList) { pList->Open = false; };
+
+	CHECK(!recorder.Record(nullptr, acquire, close));
+	CHECK(recorder.GetLists().size() == 2);
+	CHECK(recorder.GetLists()[0] == &list);
+	CHECK(recorder.GetLists()[1] == nullptr);
+}
+
+//-----------------------------------------------------------------------------
+//      ランダムな分割で, 全てのリストを連結した結果が順に記録した場合と一致することを検証します.
+//-----------------------------------------------------------------------------
+void TestOrdering(JobSystem* pJobs, uint32_t rounds)
+{
+	auto workerCount = (pJobs != nullptr) ? pJobs->GetWorkerCount() : 1u;
+
+	FakePool pool(workerCount);
+	auto acquire = [&pool](uint32_t worker) { return pool.Acquire(worker); };
+	auto close   = [](FakeList* pList) { pList->Open = false; };
+
+	std::mt19937 rng(12345);
+
+	for (auto round = 0u; round < rounds; ++round)
+	{
+		auto count     = uint32_t(rng() % 5000);
+		auto minItems  = uint32_t(1 + rng() % 128);
+		auto maxChunks = uint32_t(1 + rng() % 16);
+
+		pool.Reset();
+
+		CommandRecorder<FakeList> recorder;
+		recorder.AddPass("PreNormal", Record(1));
+		recorder.AddPass("Shadow",    Record(2));
+		recorder.AddChunkedPass("Opaque", count, minItems, maxChunks, Record(3));
+		recorder.AddPass("Post",      Record(4));
+
+		CHECK(recorder.Record(pJobs, acquire, close));
+		CHECK(recorder.GetSlots().size() == 3 + CommandRecorder<FakeList>::GetChunkCount(count, minItems, maxChunks));
+
+		std::vector<uint32_t> expected;
+		expected.push_back(1 << 24);
+		expected.push_back(2 << 24);
+		for (auto i = 0u; i < count; ++i)
+		{ expected.push_back((3 << 24) | i); }
+		expected.push_back(4 << 24);
+
+		std::vector<uint32_t> actual;
+		auto closed = true;
+		for (auto pList : recorder.GetLists())
+		{
+			if (pList == nullptr || pList->Open)
+			{
+				closed = false;
+				continue;
+			}
+			actual.insert(actual.end(), pList->Commands.begin(), pList->Commands.end());
+		}
+		CHECK(closed);
+		CHECK(actual == expected);
+	}
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main()
+{
+	TestChunkCount();
+	TestChunkRanges();
+	TestAcquireFailure();
+	TestOrdering(nullptr, 20);
+
+	JobSystem jobs;
+	CHECK(jobs.Init(4));
+	TestOrdering(&jobs, 100);
+	jobs.Term();
+
+	return TestReport("CommandRecorder");
+}
@@ -0,0 +1,230 @@
+﻿//-----------------------------------------------------------------------------
+// File : CubeConvertTest.cpp
+// Desc : CPU Sphere Map To Cube Map Conversion Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <SphereMapCpuConverter.h>
+#include <IBLReferenceBaker.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <cmath>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      キューブマップのサイズとミップレベル数を検証します.
+//-----------------------------------------------------------------------------
+void TestCubeSize()
+{
+	// SphereMapConverter::Init() と同じサイズ・ミップレベル数になること.
+	for (auto width : { 4u, 100u, 1000u, 2048u, 4096u, 8192u })
+	{
+		uint32_t mipLevels = 0;
+		auto size = SphereMapCpuConverter::CalcCubeSize(width, -1, &mipLevels);
+		auto expected = 1u;
+		while (expected < width / 4) { expected <<= 1; }
+		CHECK(size == expected && (1u << (mipLevels - 1)) == size);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      16bit浮動小数への変換を検証します.
+//-----------------------------------------------------------------------------
+void TestHalf()
+{
+	// 16bit浮動小数への変換は最近接偶数丸めで, 全ての有限値が往復で一致すること.
+	CHECK(SphereMapCpuConverter::FloatToHalf(1.0f) == 0x3C00);
+	CHECK(SphereMapCpuConverter::FloatToHalf(65504.0f) == 0x7BFF);
+	CHECK(SphereMapCpuConverter::FloatToHalf(65520.0f) == 0x7C00);
+	CHECK(SphereMapCpuConverter::FloatToHalf(1.0f + 1.0f / 2048.0f) == 0x3C00);
+	CHECK(SphereMapCpuConverter::FloatToHalf(1.0f + 3.0f / 2048.0f) == 0x3C02);
+	{
+		auto roundTrip = true;
+		for (auto h = 0u; h < 0x7C00u; ++h)
+		{
+			roundTrip &= (SphereMapCpuConverter::FloatToHalf(SphereMapCpuConverter::HalfToFloat(uint16_t(h))) == h);
+		}
+		CHECK(roundTrip);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      変換結果の向きとミップを検証します.
+//-----------------------------------------------------------------------------
+void TestConvert()
+{
+	// 各ピクセルに球上の方向を書き込んだスフィアマップで, 向きと参照実装との一致を確認します.
+	const float pi     = 3.14159265358979f;
+	const uint32_t width  = 512;
+	const uint32_t height = 256;
+	std::vector<float> pixels(size_t(width) * height * 4);
+	for (auto y = 0u; y < height; ++y)
+	{
+		for (auto x = 0u; x < width; ++x)
+		{
+			auto lat = pi * 0.5f - (y + 0.5f) / height * pi;
+			auto lon = (x + 0.5f) / width * 2.0f * pi;
+			auto pDst = &pixels[(size_t(y) * width + x) * 4];
+			pDst[0] = sinf(lon) * cosf(lat);
+			pDst[1] = sinf(lat);
+			pDst[2] = cosf(lon) * cosf(lat);
+			pDst[3] = 1.0f;
+		}
+	}
+
+	const uint32_t size      = 64;
+	const uint32_t mipLevels = 7;
+	IBLCache::Texture single, multi;
+	CHECK(SphereMapCpuConverter::Convert(pixels.data(), width, height, size, mipLevels, IBLCache::FORMAT_R32G32B32A32_FLOAT, 1, single));
+	CHECK(SphereMapCpuConverter::Convert(pixels.data(), width, height, size, mipLevels, IBLCache::FORMAT_R32G32B32A32_FLOAT, 3, multi));
+	CHECK(single.Pixels.size() == IBLCache::GetDataSize(single));
+	CHECK(single.Pixels == multi.Pixels);
+	CHECK(!SphereMapCpuConverter::Convert(pixels.data(), width, height, size, mipLevels + 1, IBLCache::FORMAT_R32G32B32A32_FLOAT, 1, multi));
+
+	size_t sliceSize = 0;
+	for (auto mip = 0u; mip < mipLevels; ++mip)
+	{
+		auto mipSize = std::max(size >> mip, 1u);
+		sliceSize += size_t(mipSize) * mipSize * 4;
+	}
+
+	auto pTexels   = reinterpret_cast<const float*>(single.Pixels.data());
+	auto dirError  = 0.0f;
+	auto refError  = 0.0f;
+	for (auto face = 0u; face < 6; ++face)
+	{
+		for (auto y = 0u; y < size; ++y)
+		{
+			for (auto x = 0u; x < size; ++x)
+			{
+				float dir[3], expected[4];
+				IBLReferenceBaker::GetTexelDirection(face, x, y, size, dir);
+				SphereMapCpuConverter::SampleReference(pixels.data(), width, height, dir, expected);
+
+				// SphereMapConverter の右手系カメラに合わせて, Z を反転した方向が格納されます.
+				auto pTexel = pTexels + face * sliceSize + (size_t(y) * size + x) * 4;
+				dirError = std::max(dirError, fabsf(pTexel[0] - dir[0]));
+				dirError = std::max(dirError, fabsf(pTexel[1] - dir[1]));
+				dirError = std::max(dirError, fabsf(pTexel[2] + dir[2]));
+				for (auto c = 0; c < 4; ++c)
+				{
+					refError = std::max(refError, fabsf(pTexel[c] - expected[c]));
+				}
+			}
+		}
+	}
+	CHECK(dirError <= 0.03f);
+	CHECK(refError <= 1e-3f);
+
+	// 下位のミップは1つ上のミップの 2x2 の平均になること.
+	{
+		auto mipError = 0.0f;
+		auto offset   = size_t(0);
+		for (auto mip = 1u; mip < mipLevels; ++mip)
+		{
+			auto srcSize = size >> (mip - 1);
+			auto dstSize = size >> mip;
+			auto next    = offset + size_t(srcSize) * srcSize * 4;
+			for (auto face = 0u; face < 6; ++face)
+			{
+				auto pSrc = pTexels + face * sliceSize + offset;
+				auto pDst = pTexels + face * sliceSize + next;
+				for (auto y = 0u; y < dstSize; ++y)
+				{
+					for (auto x = 0u; x < dstSize; ++x)
+					{
+						for (auto c = 0u; c < 4; ++c)
+						{
+							auto avg = (pSrc[((2 * y + 0) * srcSize + 2 * x + 0) * 4 + c]
+									  + pSrc[((2 * y + 0) * srcSize + 2 * x + 1) * 4 + c]
+									  + pSrc[((2 * y + 1) * srcSize + 2 * x + 0) * 4 + c]
+									  + pSrc[((2 * y + 1) * srcSize + 2 * x + 1) * 4 + c]) * 0.25f;
+							mipError = std::max(mipError, fabsf(pDst[(y * dstSize + x) * 4 + c] - avg));
+						}
+					}
+				}
+			}
+			offset = next;
+		}
+		CHECK(mipError <= 1e-6f);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      BC6H 向けの出力を検証します.
+//-----------------------------------------------------------------------------
+void TestHalfOutput()
+{
+	// BC6H 向けの出力は負値を 0 に, 範囲外を最大値に収め, アルファを 1 にすること.
+	std::vector<float> hdr(64 * 32 * 4);
+	for (size_t i = 0; i < hdr.size(); i += 4)
+	{
+		hdr[i + 0] = -1.0f;
+		hdr[i + 1] = 1e6f;
+		hdr[i + 2] = 0.5f;
+		hdr[i + 3] = 7.0f;
+	}
+
+	IBLCache::Texture half;
+	CHECK(SphereMapCpuConverter::Convert(hdr.data(), 64, 32, 16, 5, IBLCache::FORMAT_R16G16B16A16_FLOAT, 2, half));
+	CHECK(half.Format == IBLCache::FORMAT_R16G16B16A16_FLOAT && half.Pixels.size() == IBLCache::GetDataSize(half));
+
+	auto pHalf = reinterpret_cast<const uint16_t*>(half.Pixels.data());
+	auto valid = true;
+	for (size_t i = 0; i < half.Pixels.size() / 8; ++i)
+	{
+		valid &= (pHalf[i * 4 + 0] == 0 && pHalf[i * 4 + 1] == 0x7BFF && pHalf[i * 4 + 2] == 0x3800 && pHalf[i * 4 + 3] == 0x3C00);
+	}
+	CHECK(valid);
+}
+
+//-----------------------------------------------------------------------------
+//      CPUでのキューブマップ変換の処理時間を入力解像度ごとに計測します.
+//-----------------------------------------------------------------------------
+void BenchmarkResolution()
+{
+	const auto threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	IBLCache::Texture cube;
+	for (auto i = 0u; i < 3; ++i)
+	{
+		// 2K / 4K / 8K の正距円筒図法の環境マップです. 内容は処理時間に影響しないので簡単な模様にします.
+		auto width  = 2048u << i;
+		auto height = width / 2;
+		std::vector<float> pixels(size_t(width) * height * 4);
+		for (size_t j = 0; j < pixels.size(); ++j)
+		{ pixels[j] = float(uint32_t(j * 2654435761u) >> 24) / 255.0f; }
+
+		uint32_t mipLevels = 0;
+		auto size   = SphereMapCpuConverter::CalcCubeSize(width, -1, &mipLevels);
+		auto single = MeasureMilliSec([&]() { SphereMapCpuConverter::Convert(pixels.data(), width, height, size, mipLevels, IBLCache::FORMAT_R32G32B32A32_FLOAT, 1, cube); });
+		auto multi  = MeasureMilliSec([&]() { SphereMapCpuConverter::Convert(pixels.data(), width, height, size, mipLevels, IBLCache::FORMAT_R32G32B32A32_FLOAT, threadCount, cube); });
+		printf("%uK -> %4u : %8.1f ms (1 thread) / %8.1f ms (%u threads)\n", 2u << i, size, single, multi, threadCount);
+	}
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	TestCubeSize();
+	TestHalf();
+	TestConvert();
+	TestHalfOutput();
+
+	if (IsBenchmark(argc, argv))
+	{ BenchmarkResolution(); }
+
+	return TestReport("CubeConvert");
+}
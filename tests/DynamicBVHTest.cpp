@@ -0,0 +1,409 @@
+﻿//-----------------------------------------------------------------------------
+// File : DynamicBVHTest.cpp
+// Desc : Dynamic AABB Tree Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <DynamicBVH.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+
+using namespace DirectX;
+
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// Box structure
+///////////////////////////////////////////////////////////////////////////////
+struct Box
+{
+	XMFLOAT3    Min;        //!< 最小値です.
+	XMFLOAT3    Max;        //!< 最大値です.
+	int32_t     Proxy;      //!< 葉のノード番号です.
+	bool        Alive;      //!< 木に登録されているかどうか.
+};
+
+//-----------------------------------------------------------------------------
+//      密度が一定になるようにランダムな AABB を生成します.
+//-----------------------------------------------------------------------------
+std::vector<Box> MakeBoxes(size_t count, uint32_t seed, float& range)
+{
+	range = 10.0f * std::cbrt(float(count));
+
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> position(-range, range);
+	std::uniform_real_distribution<float> extent(0.2f, 1.5f);
+
+	std::vector<Box> result(count);
+	for (auto& box : result)
+	{
+		XMFLOAT3 c(position(rng), position(rng), position(rng));
+		XMFLOAT3 e(extent(rng), extent(rng), extent(rng));
+		box.Min   = XMFLOAT3(c.x - e.x, c.y - e.y, c.z - e.z);
+		box.Max   = XMFLOAT3(c.x + e.x, c.y + e.y, c.z + e.z);
+		box.Proxy = DynamicBVH::NullNode;
+		box.Alive = false;
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      原点から指定した方向を向いた視錐台を生成します.
+//-----------------------------------------------------------------------------
+Frustum MakeFrustum(float angle, float farClip)
+{
+	auto eye    = XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f);
+	auto target = XMVectorSet(std::sin(angle), 0.0f, -std::cos(angle), 0.0f);
+	auto view   = XMMatrixLookAtRH(eye, target, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+	auto proj   = XMMatrixPerspectiveFovRH(XMConvertToRadians(60.0f), 1.0f, 0.1f, farClip);
+
+	XMFLOAT4X4 viewProj;
+	XMStoreFloat4x4(&viewProj, XMMatrixMultiply(view, proj));
+
+	Frustum result;
+	result.Extract(viewProj);
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      登録中の全ての AABB を総当たりで判定します.
+//-----------------------------------------------------------------------------
+std::vector<uint32_t> QueryBruteForce(const std::vector<Box>& boxes, const Frustum& frustum)
+{
+	FrustumCuller         culler;
+	std::vector<uint32_t> ids;
+	for (auto i = 0u; i < boxes.size(); ++i)
+	{
+		if (!boxes[i].Alive)
+		{ continue; }
+
+		const auto& b = boxes[i];
+		culler.Add(
+			XMFLOAT3((b.Min.x + b.Max.x) * 0.5f, (b.Min.y + b.Max.y) * 0.5f, (b.Min.z + b.Max.z) * 0.5f),
+			XMFLOAT3((b.Max.x - b.Min.x) * 0.5f, (b.Max.y - b.Min.y) * 0.5f, (b.Max.z - b.Min.z) * 0.5f));
+		ids.push_back(i);
+	}
+
+	std::vector<uint32_t> visible;
+	culler.CullReference(frustum, visible);
+	for (auto& index : visible)
+	{ index = ids[index]; }
+	return visible;
+}
+
+//-----------------------------------------------------------------------------
+//      木の問い合わせ結果が総当たりと一致するかどうかを調べます.
+//-----------------------------------------------------------------------------
+bool MatchesBruteForce(const DynamicBVH& bvh, const std::vector<Box>& boxes, float range)
+{
+	auto result = true;
+	for (auto angle : { 0.0f, 1.0f, 2.5f, 4.0f })
+	{
+		auto frustum = MakeFrustum(angle, range);
+
+		std::vector<uint32_t> tree;
+		bvh.Query(frustum, tree);
+		std::sort(tree.begin(), tree.end());
+
+		result &= (tree == QueryBruteForce(boxes, frustum));
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      葉の数と内部ノードの数が二分木の関係になっているかどうかを調べます.
+//-----------------------------------------------------------------------------
+bool IsFullBinaryTree(const DynamicBVH& bvh)
+{
+	auto proxies = bvh.GetProxyCount();
+	return (proxies == 0) ? (bvh.GetNodeCount() == 0) : (bvh.GetNodeCount() == 2 * proxies - 1);
+}
+
+//-----------------------------------------------------------------------------
+//      挿入・削除・移動の後の問い合わせを検証します.
+//-----------------------------------------------------------------------------
+void TestInsertRemoveQuery()
+{
+	float range;
+	auto  boxes = MakeBoxes(2000, 1, range);
+
+	// 総当たりと比べるため葉は膨らませない.
+	DynamicBVH bvh;
+	bvh.SetMargin(0.0f);
+	for (auto i = 0u; i < boxes.size(); ++i)
+	{
+		boxes[i].Proxy = bvh.CreateProxy(boxes[i].Min, boxes[i].Max, i);
+		boxes[i].Alive = true;
+	}
+	CHECK(bvh.GetProxyCount() == boxes.size());
+	CHECK(IsFullBinaryTree(bvh));
+	CHECK(MatchesBruteForce(bvh, boxes, range));
+
+	// 3つに1つを削除する.
+	for (auto i = 0u; i < boxes.size(); i += 3)
+	{
+		bvh.DestroyProxy(boxes[i].Proxy);
+		boxes[i].Alive = false;
+	}
+	CHECK(bvh.GetProxyCount() == boxes.size() - (boxes.size() + 2) / 3);
+	CHECK(IsFullBinaryTree(bvh));
+	CHECK(MatchesBruteForce(bvh, boxes, range));
+
+	// 残りの一部を動かす.
+	std::mt19937 rng(2);
+	std::uniform_real_distribution<float> offset(-5.0f, 5.0f);
+	for (auto i = 1u; i < boxes.size(); i += 5)
+	{
+		if (!boxes[i].Alive)
+		{ continue; }
+
+		XMFLOAT3 d(offset(rng), offset(rng), offset(rng));
+		auto& b = boxes[i];
+		b.Min = XMFLOAT3(b.Min.x + d.x, b.Min.y + d.y, b.Min.z + d.z);
+		b.Max = XMFLOAT3(b.Max.x + d.x, b.Max.y + d.y, b.Max.z + d.z);
+		bvh.MoveProxy(b.Proxy, b.Min, b.Max);
+	}
+	CHECK(MatchesBruteForce(bvh, boxes, range));
+
+	// 削除した番号を再利用して追加し直す.
+	for (auto i = 0u; i < boxes.size(); i += 3)
+	{
+		boxes[i].Proxy = bvh.CreateProxy(boxes[i].Min, boxes[i].Max, i);
+		boxes[i].Alive = true;
+	}
+	CHECK(bvh.GetProxyCount() == boxes.size());
+	CHECK(IsFullBinaryTree(bvh));
+	CHECK(MatchesBruteForce(bvh, boxes, range));
+
+	// 全て削除すると空になる.
+	for (auto& box : boxes)
+	{
+		bvh.DestroyProxy(box.Proxy);
+		box.Alive = false;
+	}
+	CHECK(bvh.GetProxyCount() == 0 && bvh.GetNodeCount() == 0);
+}
+
+//-----------------------------------------------------------------------------
+//      まとめて構築した木の問い合わせを検証します.
+//-----------------------------------------------------------------------------
+void TestRebuild()
+{
+	float range;
+	auto  boxes = MakeBoxes(2000, 3, range);
+
+	DynamicBVH bvh;
+	bvh.SetMargin(0.0f);
+	bvh.Reserve(boxes.size());
+	for (auto i = 0u; i < boxes.size(); ++i)
+	{
+		boxes[i].Proxy = bvh.CreateProxy(boxes[i].Min, boxes[i].Max, i, false);
+		boxes[i].Alive = true;
+	}
+	bvh.Rebuild();
+
+	CHECK(IsFullBinaryTree(bvh));
+	CHECK(MatchesBruteForce(bvh, boxes, range));
+
+	// SAH で分割するので, 高さは葉の数に比べて十分に小さい.
+	CHECK(bvh.GetHeight() < 32);
+}
+
+//-----------------------------------------------------------------------------
+//      膨らませた範囲内の移動では木を更新しないことを検証します.
+//-----------------------------------------------------------------------------
+void TestMargin()
+{
+	DynamicBVH bvh;
+	bvh.SetMargin(0.5f);
+	auto proxy = bvh.CreateProxy(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f), 0);
+
+	CHECK(!bvh.MoveProxy(proxy, XMFLOAT3(0.25f, 0.0f, 0.0f), XMFLOAT3(1.25f, 1.0f, 1.0f)));
+	CHECK( bvh.MoveProxy(proxy, XMFLOAT3(1.0f,  0.0f, 0.0f), XMFLOAT3(2.0f,  1.0f, 1.0f)));
+}
+
+//-----------------------------------------------------------------------------
+//      レイと AABB の交差距離を求めます.
+//-----------------------------------------------------------------------------
+bool IntersectRay(const XMFLOAT3& origin, const XMFLOAT3& dir, const Box& box, float& distance)
+{
+	float tmin = 0.0f;
+	float tmax = FLT_MAX;
+
+	const float o [3] = { origin.x,  origin.y,  origin.z };
+	const float d [3] = { dir.x,     dir.y,     dir.z };
+	const float lo[3] = { box.Min.x, box.Min.y, box.Min.z };
+	const float hi[3] = { box.Max.x, box.Max.y, box.Max.z };
+	for (auto i = 0; i < 3; ++i)
+	{
+		auto t0 = (lo[i] - o[i]) * (1.0f / d[i]);
+		auto t1 = (hi[i] - o[i]) * (1.0f / d[i]);
+		tmin = std::max(tmin, std::min(t0, t1));
+		tmax = std::min(tmax, std::max(t0, t1));
+	}
+
+	distance = tmin;
+	return tmin <= tmax;
+}
+
+//-----------------------------------------------------------------------------
+//      レイキャストの結果が総当たりと一致することを検証します.
+//-----------------------------------------------------------------------------
+void TestRayCast()
+{
+	float range;
+	auto  boxes = MakeBoxes(2000, 4, range);
+
+	DynamicBVH bvh;
+	bvh.SetMargin(0.0f);
+	for (auto i = 0u; i < boxes.size(); ++i)
+	{ boxes[i].Proxy = bvh.CreateProxy(boxes[i].Min, boxes[i].Max, i); }
+
+	std::mt19937 rng(5);
+	std::uniform_real_distribution<float> position(-range, range);
+	std::uniform_real_distribution<float> direction(0.1f, 1.0f);
+	std::uniform_int_distribution<int>    sign(0, 1);
+
+	uint32_t hits       = 0;
+	uint32_t mismatches = 0;
+	for (auto k = 0; k < 500; ++k)
+	{
+		XMFLOAT3 origin(position(rng), position(rng), position(rng));
+		XMFLOAT3 dir(
+			direction(rng) * (sign(rng) ? 1.0f : -1.0f),
+			direction(rng) * (sign(rng) ? 1.0f : -1.0f),
+			direction(rng) * (sign(rng) ? 1.0f : -1.0f));
+
+		auto expected = FLT_MAX;
+		for (const auto& box : boxes)
+		{
+			float t;
+			if (IntersectRay(origin, dir, box, t))
+			{ expected = std::min(expected, t); }
+		}
+
+		uint32_t id;
+		float    distance;
+		auto     hit = bvh.RayCast(origin, dir, FLT_MAX, &id, &distance);
+		if (hit != (expected < FLT_MAX))
+		{
+			mismatches++;
+			continue;
+		}
+
+		if (!hit)
+		{ continue; }
+
+		// 返した葉までの距離が最短の距離になっている.
+		float t;
+		IntersectRay(origin, dir, boxes[id], t);
+		if (distance != expected || t != expected)
+		{ mismatches++; }
+		hits++;
+	}
+
+	CHECK(mismatches == 0);
+	CHECK(hits > 0);
+}
+
+//-----------------------------------------------------------------------------
+//      構築・更新・問い合わせの処理時間を計測します.
+//-----------------------------------------------------------------------------
+void BenchmarkBVH(size_t count)
+{
+	float range;
+	auto  boxes = MakeBoxes(count, 12345, range);
+
+	DynamicBVH bvh;
+	bvh.SetMargin(0.0f);
+	bvh.Reserve(count);
+
+	auto buildTime = MeasureMilliSec([&]()
+	{
+		for (auto i = 0u; i < boxes.size(); ++i)
+		{
+			boxes[i].Proxy = bvh.CreateProxy(boxes[i].Min, boxes[i].Max, i, false);
+			boxes[i].Alive = true;
+		}
+		bvh.Rebuild();
+	});
+
+	// 1割の葉を動かす.
+	std::mt19937 rng(12345);
+	std::uniform_int_distribution<size_t> pick(0, count - 1);
+	std::uniform_real_distribution<float> offset(-2.0f, 2.0f);
+	uint32_t refits = 0;
+	auto refitTime = MeasureMilliSec([&]()
+	{
+		for (size_t k = 0; k < count / 10; ++k)
+		{
+			auto& b = boxes[pick(rng)];
+			XMFLOAT3 d(offset(rng), offset(rng), offset(rng));
+			b.Min = XMFLOAT3(b.Min.x + d.x, b.Min.y + d.y, b.Min.z + d.z);
+			b.Max = XMFLOAT3(b.Max.x + d.x, b.Max.y + d.y, b.Max.z + d.z);
+			if (bvh.MoveProxy(b.Proxy, b.Min, b.Max))
+			{ refits++; }
+		}
+	});
+
+	FrustumCuller culler;
+	culler.Reserve(count);
+	for (const auto& b : boxes)
+	{
+		culler.Add(
+			XMFLOAT3((b.Min.x + b.Max.x) * 0.5f, (b.Min.y + b.Max.y) * 0.5f, (b.Min.z + b.Max.z) * 0.5f),
+			XMFLOAT3((b.Max.x - b.Min.x) * 0.5f, (b.Max.y - b.Min.y) * 0.5f, (b.Max.z - b.Min.z) * 0.5f));
+	}
+
+	auto frustum = MakeFrustum(0.0f, range);
+	std::vector<uint32_t> tree;
+	std::vector<uint32_t> flat;
+	auto queryTime = MeasureMilliSec([&]() { bvh.Query(frustum, tree); });
+	auto flatTime  = MeasureMilliSec([&]() { culler.Cull(frustum, flat); });
+
+	std::sort(tree.begin(), tree.end());
+	CHECK(tree == flat);
+
+	auto rayTime = MeasureMilliSec([&]()
+	{
+		std::uniform_real_distribution<float> position(-range, range);
+		for (auto k = 0; k < 1000; ++k)
+		{
+			XMFLOAT3 origin(position(rng), position(rng), position(rng));
+			XMFLOAT3 dir(offset(rng), offset(rng), offset(rng));
+			uint32_t id;
+			float    dist;
+			bvh.RayCast(origin, dir, FLT_MAX, &id, &dist);
+		}
+	});
+
+	printf("BVH %7zu : build %8.2f ms (height %d, cost %.1f), refit %6.2f ms (%u moved), query %.3f ms (flat %.3f ms), ray x1000 %.3f ms\n",
+		count, buildTime, bvh.GetHeight(), bvh.ComputeCost(), refitTime, refits, queryTime, flatTime, rayTime);
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	TestInsertRemoveQuery();
+	TestRebuild();
+	TestMargin();
+	TestRayCast();
+	if (IsBenchmark(argc, argv))
+	{
+		for (auto count : { 10000u, 100000u, 1000000u })
+		{ BenchmarkBVH(count); }
+	}
+	return TestReport("DynamicBVH");
+}
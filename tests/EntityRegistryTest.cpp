@@ -0,0 +1,320 @@
+﻿//-----------------------------------------------------------------------------
+// File : EntityRegistryTest.cpp
+// Desc : Sparse Set Entity Component Storage Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <EntityRegistry.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// Position structure
+///////////////////////////////////////////////////////////////////////////////
+struct Position
+{
+	float   X;
+	float   Y;
+	float   Z;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Velocity structure
+///////////////////////////////////////////////////////////////////////////////
+struct Velocity
+{
+	float   X;
+	float   Y;
+	float   Z;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Tag structure
+///////////////////////////////////////////////////////////////////////////////
+struct Tag
+{
+	int     Value;
+};
+
+//-----------------------------------------------------------------------------
+//      エンティティの生成と破棄を検証します.
+//-----------------------------------------------------------------------------
+void TestCreateDestroy()
+{
+	EntityRegistry registry;
+	CHECK(!registry.IsAlive(NullEntity));
+
+	auto a = registry.Create();
+	auto b = registry.Create();
+	auto c = registry.Create();
+	CHECK(registry.GetCount() == 3);
+	CHECK(GetEntityIndex(a) == 0 && GetEntityIndex(b) == 1 && GetEntityIndex(c) == 2);
+	CHECK(registry.IsAlive(a) && registry.IsAlive(b) && registry.IsAlive(c));
+
+	// 2回目の破棄は何もしない.
+	registry.Destroy(b);
+	registry.Destroy(b);
+	CHECK(registry.GetCount() == 2);
+	CHECK(!registry.IsAlive(b));
+
+	// 番号は再利用し, 世代を進めて古いハンドルと区別する.
+	auto d = registry.Create();
+	CHECK(GetEntityIndex(d) == GetEntityIndex(b));
+	CHECK(GetEntityGeneration(d) == GetEntityGeneration(b) + 1);
+	CHECK(registry.IsAlive(d) && !registry.IsAlive(b));
+	CHECK(registry.GetCount() == 3);
+
+	// 世代は8bitで一周する.
+	auto e = d;
+	for (auto i = 0u; i <= EntityGenerationMask; ++i)
+	{
+		registry.Destroy(e);
+		e = registry.Create();
+	}
+	CHECK(GetEntityIndex(e) == GetEntityIndex(d) && GetEntityGeneration(e) == GetEntityGeneration(d));
+
+	registry.Clear();
+	CHECK(registry.GetCount() == 0);
+	CHECK(!registry.IsAlive(a) && !registry.IsAlive(c));
+	CHECK(GetEntityIndex(registry.Create()) == 0);
+}
+
+//-----------------------------------------------------------------------------
+//      コンポーネントの追加・取得・削除を検証します.
+//-----------------------------------------------------------------------------
+void TestComponents()
+{
+	EntityRegistry registry;
+	std::vector<Entity> entities;
+	for (auto i = 0; i < 8; ++i)
+	{
+		auto entity = registry.Create();
+		registry.Add<Tag>(entity, i);
+		entities.push_back(entity);
+	}
+	CHECK(registry.GetPool<Tag>().GetCount() == 8);
+
+	// 追加済みの場合は上書きする.
+	registry.Add<Tag>(entities[3], 30);
+	CHECK(registry.GetPool<Tag>().GetCount() == 8);
+	CHECK(registry.Get<Tag>(entities[3]).Value == 30);
+
+	// 末尾で穴を埋めても, 残りのコンポーネントの値は変わらない.
+	registry.Remove<Tag>(entities[2]);
+	registry.Remove<Tag>(entities[2]);
+	CHECK(!registry.Has<Tag>(entities[2]));
+	CHECK(registry.Find<Tag>(entities[2]) == nullptr);
+	CHECK(registry.GetPool<Tag>().GetCount() == 7);
+
+	auto intact = true;
+	for (auto i = 0; i < 8; ++i)
+	{
+		if (i == 2)
+		{ continue; }
+		auto pTag = registry.Find<Tag>(entities[i]);
+		intact &= (pTag != nullptr) && (pTag->Value == ((i == 3) ? 30 : i));
+	}
+	CHECK(intact);
+
+	// 持っていない型の問い合わせは空の配列を作るだけ.
+	CHECK(!registry.Has<Position>(entities[0]));
+	CHECK(registry.GetPool<Position>().GetCount() == 0);
+
+	// 破棄すると全ての型のコンポーネントが消え, 番号を再利用しても引き継がない.
+	registry.Add<Position>(entities[5], 1.0f, 2.0f, 3.0f);
+	registry.Destroy(entities[5]);
+	CHECK(registry.GetPool<Tag>     ().GetCount() == 6);
+	CHECK(registry.GetPool<Position>().GetCount() == 0);
+
+	auto reused = registry.Create();
+	CHECK(GetEntityIndex(reused) == GetEntityIndex(entities[5]));
+	CHECK(!registry.Has<Tag>(reused));
+
+	registry.Add<Tag>(reused, 50);
+	CHECK( registry.Has<Tag>(reused));
+	CHECK(!registry.Has<Tag>(entities[5]));
+}
+
+//-----------------------------------------------------------------------------
+//      複数の型を持つエンティティの列挙を検証します.
+//-----------------------------------------------------------------------------
+void TestEach()
+{
+	EntityRegistry registry;
+	std::vector<Entity> entities;
+	for (auto i = 0; i < 30; ++i)
+	{
+		auto entity = registry.Create();
+		if (i % 2 == 0)
+		{ registry.Add<Position>(entity, float(i), 0.0f, 0.0f); }
+		if (i % 3 == 0)
+		{ registry.Add<Velocity>(entity, 1.0f, 2.0f, 3.0f); }
+		entities.push_back(entity);
+	}
+
+	// 両方を持つ 0, 6, 12, 18, 24 だけを先頭の型の並び順で列挙する.
+	std::vector<Entity> visited;
+	registry.Each<Velocity, Position>([&](Entity entity, Velocity& velocity, Position& position)
+	{
+		position.X += velocity.X;
+		position.Y += velocity.Y;
+		position.Z += velocity.Z;
+		visited.push_back(entity);
+	});
+
+	std::vector<Entity> expected;
+	for (auto i = 0; i < 30; i += 6)
+	{ expected.push_back(entities[i]); }
+	CHECK(visited == expected);
+
+	auto updated = true;
+	for (auto i = 0; i < 30; i += 2)
+	{
+		const auto& p = registry.Get<Position>(entities[i]);
+		updated &= (i % 6 == 0)
+			? (p.X == float(i) + 1.0f && p.Y == 2.0f && p.Z == 3.0f)
+			: (p.X == float(i) && p.Y == 0.0f && p.Z == 0.0f);
+	}
+	CHECK(updated);
+
+	// 破棄したエンティティは列挙されない.
+	registry.Destroy(entities[6]);
+	uint32_t count = 0;
+	registry.Each<Velocity, Position>([&](Entity, Velocity&, Position&) { count++; });
+	CHECK(count == 4);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// ObjectComponent class
+///////////////////////////////////////////////////////////////////////////////
+class ObjectComponent
+{
+public:
+	virtual ~ObjectComponent()
+	{ /* DO_NOTHING */ }
+
+	virtual void Update(float deltaTime) = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ObjectMotion class
+///////////////////////////////////////////////////////////////////////////////
+class ObjectMotion : public ObjectComponent
+{
+public:
+	explicit ObjectMotion(const Velocity& velocity)
+	: m_Velocity(velocity)
+	{ /* DO_NOTHING */ }
+
+	void Update(float) override
+	{ /* DO_NOTHING */ }
+
+	Velocity m_Velocity;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Object class
+///////////////////////////////////////////////////////////////////////////////
+class Object
+{
+public:
+	// GameObject と同じく, コンポーネントを型変換で探す.
+	template<typename T>
+	std::shared_ptr<T> GetComponent() const
+	{
+		for (const auto& component : m_Components)
+		{
+			auto result = std::dynamic_pointer_cast<T>(component);
+			if (result)
+			{ return result; }
+		}
+		return nullptr;
+	}
+
+	void Update(float deltaTime)
+	{
+		for (auto& component : m_Components)
+		{ component->Update(deltaTime); }
+	}
+
+	Position                                        m_Position = {};
+	std::vector<std::shared_ptr<ObjectComponent>>   m_Components;
+};
+
+//-----------------------------------------------------------------------------
+//      密配列の走査と, オブジェクトごとにヒープを辿る更新を比べます.
+//-----------------------------------------------------------------------------
+void BenchmarkEach(size_t count)
+{
+	const float deltaTime = 1.0f / 60.0f;
+
+	std::mt19937 rng(12345);
+	std::uniform_real_distribution<float> velocity(-1.0f, 1.0f);
+
+	EntityRegistry registry;
+	registry.GetPool<Position>().Reserve(count);
+	registry.GetPool<Velocity>().Reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		auto entity = registry.Create();
+		registry.Add<Position>(entity, 0.0f, 0.0f, 0.0f);
+		registry.Add<Velocity>(entity, velocity(rng), velocity(rng), velocity(rng));
+	}
+
+	auto ecsTime = MeasureMilliSec([&]()
+	{
+		registry.Each<Velocity, Position>([deltaTime](Entity, Velocity& v, Position& p)
+		{
+			p.X += v.X * deltaTime;
+			p.Y += v.Y * deltaTime;
+			p.Z += v.Z * deltaTime;
+		});
+	});
+
+	std::vector<std::unique_ptr<Object>> objects;
+	objects.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		std::unique_ptr<Object> object(new Object());
+		object->m_Components.push_back(std::make_shared<ObjectMotion>(Velocity{ velocity(rng), velocity(rng), velocity(rng) }));
+		objects.push_back(std::move(object));
+	}
+
+	auto objectTime = MeasureMilliSec([&]()
+	{
+		for (auto& object : objects)
+		{
+			const auto& v = object->GetComponent<ObjectMotion>()->m_Velocity;
+			object->m_Position.X += v.X * deltaTime;
+			object->m_Position.Y += v.Y * deltaTime;
+			object->m_Position.Z += v.Z * deltaTime;
+			object->Update(deltaTime);
+		}
+	});
+
+	printf("Each %zu : ECS %.3f ms, object %.3f ms\n", count, ecsTime, objectTime);
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	TestCreateDestroy();
+	TestComponents();
+	TestEach();
+	if (IsBenchmark(argc, argv))
+	{ BenchmarkEach(1000000); }
+	return TestReport("EntityRegistry");
+}
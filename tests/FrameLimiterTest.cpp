@@ -0,0 +1,120 @@
+﻿//-----------------------------------------------------------------------------
+// File : FrameLimiterTest.cpp
+// Desc : Frame Limiter And Frame Statistics Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <FrameLimiter.h>
+#include <FrameStats.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <cmath>
+
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// SimClock class
+///////////////////////////////////////////////////////////////////////////////
+// 休止が最大 1.5ms 遅れる, OSのタイマーを模したクロックです.
+class SimClock : public FrameClock
+{
+public:
+	double          Now = 0.0;
+	std::mt19937    Rng { 4321 };
+
+	double GetMicroSec() override { return Now; }
+	void   Sleep(double microSec) override { Now += microSec + std::uniform_real_distribution<double>(0.0, 1500.0)(Rng); }
+	void   Spin() override { Now += 5.0; }
+};
+
+//-----------------------------------------------------------------------------
+//      フレームレート制限を模擬クロックで検証します.
+//-----------------------------------------------------------------------------
+void TestLimiter()
+{
+	const double fpsList[] = { 30.0, 60.0, 120.0, 144.0, 240.0 };
+
+	std::mt19937 rng(99);
+	std::uniform_real_distribution<double> jitter(0.8, 1.2);
+
+	for (auto fps : fpsList)
+	{
+		for (auto load = 0u; load < 3; ++load)
+		{
+			SimClock     clock;
+			FrameLimiter limiter;
+			FrameStats   stats;
+			limiter.Init(&clock);
+			limiter.SetTargetFps(fps);
+			stats.Init(256);
+
+			// 1フレームの処理は予算の 20% ~ 80% です.
+			const double period = 1000000.0 / fps;
+			const double workUs = period * (0.2 + 0.3 * load);
+
+			double last = 0.0;
+			for (auto f = 0u; f < 600; ++f)
+			{
+				limiter.Wait();
+				if (f > 0)
+				{ stats.Push(clock.Now - last); }
+				last = clock.Now;
+				clock.Now += workUs * jitter(rng);
+			}
+
+			// 休止の遅れを吸収して, フレーム間隔が目標からずれないこと.
+			CHECK(std::abs(stats.GetAverage() - period) < period * 0.01);
+			CHECK(stats.GetPercentile(50.0) > period - 50.0);
+			CHECK(stats.GetPercentile(99.0) < period + 50.0);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      パーセンタイルが整列した参照と一致することを検証します.
+//-----------------------------------------------------------------------------
+void TestStats()
+{
+	std::mt19937 rng(99);
+	std::uniform_real_distribution<double> value(0.0, 100.0);
+
+	FrameStats stats;
+	stats.Init(100);
+
+	std::vector<double> samples;
+	for (auto i = 0u; i < 250; ++i)
+	{
+		auto v = value(rng);
+		stats.Push(v);
+		samples.push_back(v);
+	}
+
+	// 保持するのは最新の100個です.
+	std::vector<double> sorted(samples.end() - 100, samples.end());
+	std::sort(sorted.begin(), sorted.end());
+
+	CHECK(stats.GetCount() == 100);
+	CHECK(stats.GetPercentile(50.0)  == sorted[49]);
+	CHECK(stats.GetPercentile(99.0)  == sorted[98]);
+	CHECK(stats.GetPercentile(100.0) == sorted[99]);
+	CHECK(stats.GetPercentile(0.0)   == sorted[0]);
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main()
+{
+	TestLimiter();
+	TestStats();
+	return TestReport("FrameLimiter");
+}
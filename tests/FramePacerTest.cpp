@@ -0,0 +1,155 @@
+﻿//-----------------------------------------------------------------------------
+// File : FramePacerTest.cpp
+// Desc : Frames In Flight Pacing Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <FramePacer.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// SimQueue structure
+///////////////////////////////////////////////////////////////////////////////
+// 提出順に1フレームずつ処理する, 単一キューのGPUを模したものです.
+struct SimQueue
+{
+	std::vector<double> Complete = { 0.0 };     //!< フェンス値ごとの完了時刻です.
+	double              Free     = 0.0;         //!< GPUが空く時刻です.
+
+	uint64_t Submit(double now, double gpuMs)
+	{
+		Free = std::max(Free, now) + gpuMs;
+		Complete.push_back(Free);
+		return uint64_t(Complete.size() - 1);
+	}
+
+	uint64_t GetCompletedValue(double now) const
+	{
+		uint64_t value = 0;
+		while (value + 1 < Complete.size() && Complete[size_t(value + 1)] <= now)
+		{ value++; }
+		return value;
+	}
+};
+
+//-----------------------------------------------------------------------------
+//      フェンス値の記録と判定を検証します.
+//-----------------------------------------------------------------------------
+void TestFenceValues()
+{
+	FramePacer pacer;
+	CHECK(!pacer.Init(0));
+	CHECK(pacer.Init(3));
+	CHECK(pacer.GetFrameCount() == 3);
+
+	// 一度も提出していないフレームはすぐに使える.
+	CHECK(pacer.GetWaitValue(0) == 0);
+	CHECK(pacer.IsReady(2, 0));
+	CHECK(pacer.GetInFlightCount(0) == 0);
+
+	pacer.EndFrame(0, 1);
+	pacer.EndFrame(1, 2);
+	pacer.EndFrame(2, 3);
+	CHECK(pacer.GetLastValue() == 3);
+	CHECK(pacer.GetWaitValue(1) == 2);
+	CHECK(pacer.GetInFlightCount(0) == 3);
+	CHECK(pacer.GetInFlightCount(2) == 1);
+	CHECK(!pacer.IsReady(0, 0));
+	CHECK( pacer.IsReady(0, 1));
+	CHECK(!pacer.IsReady(2, 2));
+
+	// シグナルに失敗した提出と範囲外のフレーム番号は無視する.
+	pacer.EndFrame(0, 0);
+	pacer.EndFrame(5, 4);
+	CHECK(pacer.GetWaitValue(0) == 1);
+	CHECK(pacer.GetWaitValue(5) == 0);
+	CHECK(pacer.GetLastValue() == 3);
+
+	pacer.EndFrame(0, 4);
+	CHECK(pacer.GetWaitValue(0) == 4);
+	CHECK(pacer.GetInFlightCount(3) == 1);
+
+	pacer.Term();
+	CHECK(pacer.GetFrameCount() == 0);
+	CHECK(pacer.GetLastValue() == 0);
+}
+
+//-----------------------------------------------------------------------------
+//      模擬キューでフレームを上書きしないことと, CPUとGPUが重なることを検証します.
+//-----------------------------------------------------------------------------
+void TestSimulatedQueue(uint32_t rounds)
+{
+	const uint32_t frames = 240;
+	const uint32_t warmup = 40;
+
+	std::mt19937 rng(6789);
+	std::uniform_real_distribution<double> cost(1.0, 16.0);
+	std::uniform_real_distribution<double> jitter(0.9, 1.1);
+
+	for (auto round = 0u; round < rounds; ++round)
+	{
+		auto frameCount = 2 + round % 2;
+		auto cpuMs      = cost(rng);
+		auto gpuMs      = cost(rng);
+
+		FramePacer pacer;
+		CHECK(pacer.Init(frameCount));
+
+		SimQueue queue;
+		auto now   = 0.0;
+		auto start = 0.0;
+		auto slot  = 0u;
+		auto ready = true;
+
+		for (auto f = 0u; f < frames; ++f)
+		{
+			if (f == warmup)
+			{ start = now; }
+
+			// 再利用するフレームの完了だけを待つ.
+			auto wait = pacer.GetWaitValue(slot);
+			if (wait > 0)
+			{ now = std::max(now, queue.Complete[size_t(wait)]); }
+
+			// GPUが実行中のフレームを上書きしないこと. CPUの先行は FrameCount フレームまで.
+			auto completed = queue.GetCompletedValue(now);
+			ready &= pacer.IsReady(slot, completed);
+			ready &= (pacer.GetInFlightCount(completed) < frameCount);
+
+			// 記録して提出.
+			now += cpuMs * jitter(rng);
+			pacer.EndFrame(slot, queue.Submit(now, gpuMs * jitter(rng)));
+			ready &= (pacer.GetInFlightCount(queue.GetCompletedValue(now)) <= frameCount);
+
+			slot = (slot + 1) % frameCount;
+		}
+		CHECK(ready);
+
+		// 定常状態のフレーム時間は CPU+GPU ではなく max(CPU, GPU) になること.
+		auto paced = (now - start) / double(frames - warmup);
+		auto ideal = std::max(cpuMs, gpuMs);
+		CHECK(paced <= ideal * 1.1 && paced >= ideal * 0.9);
+	}
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main()
+{
+	TestFenceValues();
+	TestSimulatedQueue(100);
+	return TestReport("FramePacer");
+}
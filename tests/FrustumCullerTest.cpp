@@ -0,0 +1,155 @@
+﻿//-----------------------------------------------------------------------------
+// File : FrustumCullerTest.cpp
+// Desc : SIMD Frustum Culling Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <FrustumCuller.h>
+#include <cmath>
+#include <random>
+
+using namespace DirectX;
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      テストに使うカメラの視錐台を生成します.
+//-----------------------------------------------------------------------------
+Frustum MakeFrustum(float angle)
+{
+	auto eye    = XMVectorSet(0.0f, 0.0f, 0.0f, 0.0f);
+	auto target = XMVectorSet(std::sin(angle), 0.0f, -std::cos(angle), 0.0f);
+	auto view   = XMMatrixLookAtRH(eye, target, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+	auto proj   = XMMatrixPerspectiveFovRH(XMConvertToRadians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+
+	XMFLOAT4X4 viewProj;
+	XMStoreFloat4x4(&viewProj, XMMatrixMultiply(view, proj));
+
+	Frustum result;
+	result.Extract(viewProj);
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      ランダムな AABB を追加します.
+//-----------------------------------------------------------------------------
+void AddRandomBounds(FrustumCuller& culler, size_t count, uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+	std::uniform_real_distribution<float> extent(0.1f, 4.0f);
+
+	culler.Reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		culler.Add(
+			XMFLOAT3(position(rng), position(rng), position(rng)),
+			XMFLOAT3(extent(rng), extent(rng), extent(rng)));
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      視錐台の内外の判定を検証します.
+//-----------------------------------------------------------------------------
+void TestVisibility()
+{
+	FrustumCuller culler;
+	auto inside  = culler.Add(XMFLOAT3(   0.0f, 0.0f,  -10.0f), XMFLOAT3(1.0f, 1.0f, 1.0f));
+	culler.Add(XMFLOAT3(   0.0f, 0.0f,   10.0f), XMFLOAT3(1.0f, 1.0f, 1.0f));   // カメラの後ろ.
+	culler.Add(XMFLOAT3( 100.0f, 0.0f,  -10.0f), XMFLOAT3(1.0f, 1.0f, 1.0f));   // 画角の外.
+	culler.Add(XMFLOAT3(   0.0f, 0.0f, -200.0f), XMFLOAT3(1.0f, 1.0f, 1.0f));   // 遠クリップ面の外.
+	auto overlap = culler.Add(XMFLOAT3(   0.0f, 0.0f,    1.0f), XMFLOAT3(2.0f, 2.0f, 2.0f));
+
+	// 一部でも視錐台に入っていれば可視とする.
+	std::vector<uint32_t> visible;
+	CHECK(culler.Cull(MakeFrustum(0.0f), visible) == 2);
+	CHECK(visible.size() == 2 && visible[0] == inside && visible[1] == overlap);
+}
+
+//-----------------------------------------------------------------------------
+//      ワールド行列で変換した AABB を検証します.
+//-----------------------------------------------------------------------------
+void TestTransformAABB()
+{
+	XMFLOAT3 localMin(-1.0f, -2.0f, -3.0f);
+	XMFLOAT3 localMax( 1.0f,  2.0f,  3.0f);
+	XMFLOAT3 center;
+	XMFLOAT3 extent;
+
+	// 平行移動では中心だけが動く.
+	XMFLOAT4X4 world;
+	XMStoreFloat4x4(&world, XMMatrixTranslation(5.0f, 6.0f, 7.0f));
+	FrustumCuller::TransformAABB(localMin, localMax, world, center, extent);
+	CHECK(center.x == 5.0f && center.y == 6.0f && center.z == 7.0f);
+	CHECK(extent.x == 1.0f && extent.y == 2.0f && extent.z == 3.0f);
+
+	// Y 軸まわりに 90 度回すと X と Z の大きさが入れ替わる.
+	XMStoreFloat4x4(&world, XMMatrixRotationY(XMConvertToRadians(90.0f)));
+	FrustumCuller::TransformAABB(localMin, localMax, world, center, extent);
+	CHECK(std::fabs(extent.x - 3.0f) < 1.0e-5f && std::fabs(extent.y - 2.0f) < 1.0e-5f && std::fabs(extent.z - 1.0f) < 1.0e-5f);
+}
+
+//-----------------------------------------------------------------------------
+//      SIMD 版とスカラー版の結果が一致することを検証します.
+//-----------------------------------------------------------------------------
+void TestMatchesReference()
+{
+	// 4 の倍数でない個数で端数の処理も確かめる.
+	for (auto count : { 1u, 3u, 4u, 7u, 1000u, 4099u })
+	{
+		FrustumCuller culler;
+		AddRandomBounds(culler, count, count);
+
+		for (auto angle : { 0.0f, 1.0f, 2.5f, 4.0f })
+		{
+			auto frustum = MakeFrustum(angle);
+
+			// 同じ式で判定しているので番号の並びまで一致する.
+			std::vector<uint32_t> simd;
+			std::vector<uint32_t> scalar;
+			CHECK(culler.Cull(frustum, simd) == culler.CullReference(frustum, scalar));
+			CHECK(simd == scalar);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      SIMD 版とスカラー版の処理時間を計測します.
+//-----------------------------------------------------------------------------
+void BenchmarkCull()
+{
+	const size_t count = 100000;
+
+	FrustumCuller culler;
+	AddRandomBounds(culler, count, 12345);
+	auto frustum = MakeFrustum(0.0f);
+
+	std::vector<uint32_t> simd;
+	std::vector<uint32_t> scalar;
+	auto simdTime   = MeasureMilliSec([&]() { culler.Cull(frustum, simd); });
+	auto scalarTime = MeasureMilliSec([&]() { culler.CullReference(frustum, scalar); });
+	CHECK(simd == scalar);
+
+	printf("Cull %zu : SSE %.3f ms, scalar %.3f ms (%zu visible)\n", count, simdTime, scalarTime, simd.size());
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	TestVisibility();
+	TestTransformAABB();
+	TestMatchesReference();
+	if (IsBenchmark(argc, argv))
+	{ BenchmarkCull(); }
+	return TestReport("FrustumCuller");
+}
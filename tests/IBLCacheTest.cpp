@@ -0,0 +1,180 @@
+﻿//-----------------------------------------------------------------------------
+// File : IBLCacheTest.cpp
+// Desc : Baked IBL Texture Cache Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <IBLCache.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      テストに使うベイク条件を生成します.
+//-----------------------------------------------------------------------------
+IBLCache::Key MakeKey()
+{
+	IBLCache::Key key = {};
+	key.SourceHash   = 0x0123456789abcdefull;
+	key.ShaderHash   = 0xfedcba9876543210ull;
+	key.CubeSize     = 512;
+	key.CubeMipCount = 10;
+	key.DFGSize      = 64;
+	key.DFGSamples   = 1024;
+	key.LDSize       = 16;
+	key.LDMipCount   = 3;
+	key.LDSamples    = 128;
+	return key;
+}
+
+//-----------------------------------------------------------------------------
+//      テストで書き出したファイルを削除します.
+//-----------------------------------------------------------------------------
+void RemoveFile(const std::wstring& path)
+{
+#if defined(_WIN32)
+	_wremove(path.c_str());
+#else
+	// テストのパスは ASCII だけなので, そのまま変換できる.
+	remove(std::string(path.begin(), path.end()).c_str());
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      キャッシュキーを検証します.
+//-----------------------------------------------------------------------------
+void TestHash()
+{
+	const auto key = MakeKey();
+
+
+	// DFG項は元テクスチャに依存しないので, 環境が変わっても共有されること.
+	auto other = key;
+	other.SourceHash++;
+	other.CubeSize *= 2;
+	CHECK(IBLCache::HashDFG(other) == IBLCache::HashDFG(key));
+	CHECK(IBLCache::HashLD(other) != IBLCache::HashLD(key));
+
+	// LD項はどの設定が変わっても別のキーになること.
+	uint32_t IBLCache::Key::* fields[] = {
+		&IBLCache::Key::CubeSize,
+		&IBLCache::Key::CubeMipCount,
+		&IBLCache::Key::LDSize,
+		&IBLCache::Key::LDMipCount,
+		&IBLCache::Key::LDSamples,
+	};
+	for (auto field : fields)
+	{
+		other = key;
+		other.*field += 1;
+		CHECK(IBLCache::HashLD(other) != IBLCache::HashLD(key));
+	}
+
+	other = key;
+	other.DFGSamples *= 2;
+	CHECK(IBLCache::HashDFG(other) != IBLCache::HashDFG(key));
+	other = key;
+	other.ShaderHash++;
+	CHECK(IBLCache::HashDFG(other) != IBLCache::HashDFG(key));
+	CHECK(IBLCache::HashLD(other) != IBLCache::HashLD(key));
+}
+
+//-----------------------------------------------------------------------------
+//      DDSファイルの構築と読み込みを検証します.
+//-----------------------------------------------------------------------------
+void TestFile()
+{
+	const auto key = MakeKey();
+
+	// ミップ付きキューブマップが DDS を経由して復元できること.
+	IBLCache::Texture cube;
+	cube.Format    = IBLCache::FORMAT_R32G32B32A32_FLOAT;
+	cube.Width     = key.LDSize;
+	cube.Height    = key.LDSize;
+	cube.ArraySize = 6;
+	cube.MipLevels = key.LDMipCount;
+	cube.Cube      = true;
+	cube.Pixels.resize(IBLCache::GetDataSize(cube));
+	for (size_t i = 0; i < cube.Pixels.size(); ++i)
+	{
+		cube.Pixels[i] = uint8_t(i * 31 + 7);
+	}
+	CHECK(cube.Pixels.size() == size_t(16 * 16 + 8 * 8 + 4 * 4) * 16 * 6);
+
+	auto layout = cube;
+	layout.Pixels.clear();
+
+	auto hash = IBLCache::HashLD(key);
+	std::vector<uint8_t> file;
+	CHECK(IBLCache::BuildDDS(cube, hash, file));
+
+	IBLCache::Texture parsed;
+	CHECK(IBLCache::ParseDDS(file, hash, layout, parsed));
+	CHECK(parsed.Pixels == cube.Pixels);
+	CHECK(parsed.Cube && parsed.ArraySize == 6 && parsed.MipLevels == cube.MipLevels);
+
+	// キーや構成が一致しないファイル, 壊れたファイルは読み込まないこと.
+	CHECK(!IBLCache::ParseDDS(file, hash + 1, layout, parsed));
+
+	auto wrongLayout = layout;
+	wrongLayout.MipLevels++;
+	CHECK(!IBLCache::ParseDDS(file, hash, wrongLayout, parsed));
+	wrongLayout = layout;
+	wrongLayout.Format = IBLCache::FORMAT_R16G16B16A16_FLOAT;
+	CHECK(!IBLCache::ParseDDS(file, hash, wrongLayout, parsed));
+
+	auto truncated = file;
+	truncated.pop_back();
+	CHECK(!IBLCache::ParseDDS(truncated, hash, layout, parsed));
+
+	auto broken = file;
+	broken[0] ^= 0xff;
+	CHECK(!IBLCache::ParseDDS(broken, hash, layout, parsed));
+
+	// 2次元テクスチャもファイルを経由して復元できること.
+	IBLCache::Texture dfg;
+	dfg.Format    = IBLCache::FORMAT_R32G32_FLOAT;
+	dfg.Width     = key.DFGSize;
+	dfg.Height    = key.DFGSize;
+	dfg.ArraySize = 1;
+	dfg.MipLevels = 1;
+	dfg.Pixels.resize(IBLCache::GetDataSize(dfg));
+	for (size_t i = 0; i < dfg.Pixels.size(); ++i)
+	{
+		dfg.Pixels[i] = uint8_t(i ^ 0x5a);
+	}
+
+	auto dfgLayout = dfg;
+	dfgLayout.Pixels.clear();
+
+	auto dfgHash = IBLCache::HashDFG(key);
+	auto path = IBLCache::MakePath(L".", L"IBLCacheTest", dfgHash);
+	CHECK(IBLCache::Save(path, dfgHash, dfg));
+
+	IBLCache::Texture loaded;
+	CHECK(IBLCache::Load(path, dfgHash, dfgLayout, loaded));
+	CHECK(loaded.Pixels == dfg.Pixels && !loaded.Cube);
+	CHECK(!IBLCache::Load(path, dfgHash + 1, dfgLayout, loaded));
+	RemoveFile(path);
+	CHECK(!IBLCache::Load(path, dfgHash, dfgLayout, loaded));
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main()
+{
+	TestHash();
+	TestFile();
+	return TestReport("IBLCache");
+}
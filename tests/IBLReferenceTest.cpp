@@ -0,0 +1,249 @@
+﻿//-----------------------------------------------------------------------------
+// File : IBLReferenceTest.cpp
+// Desc : CPU Reference IBL Bake Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <IBLReferenceBaker.h>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <cmath>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+// IBLBaker と同じ値です. IBLBaker.h は Direct3D 12 のヘッダを使うので, ここに写します.
+const uint32_t DFGSampleCount = 1024;
+const uint32_t LDSampleCount  = 128;
+const uint32_t MipCount       = 8;
+
+//-----------------------------------------------------------------------------
+//      方向から放射輝度を求める関数でミップ付きのキューブマップを作ります.
+//-----------------------------------------------------------------------------
+IBLCache::Texture MakeReferenceCube(uint32_t size, uint32_t mipLevels, const std::function<void(const float dir[3], float rgba[4])>& func)
+{
+	IBLCache::Texture cube;
+	cube.Format    = IBLCache::FORMAT_R32G32B32A32_FLOAT;
+	cube.Width     = size;
+	cube.Height    = size;
+	cube.ArraySize = 6;
+	cube.MipLevels = mipLevels;
+	cube.Cube      = true;
+	cube.Pixels.resize(IBLCache::GetDataSize(cube));
+
+	auto pDst = reinterpret_cast<float*>(cube.Pixels.data());
+	for (auto face = 0u; face < 6; ++face)
+	{
+		for (auto mip = 0u; mip < mipLevels; ++mip)
+		{
+			auto mipSize = std::max(size >> mip, 1u);
+			for (auto y = 0u; y < mipSize; ++y)
+			{
+				for (auto x = 0u; x < mipSize; ++x)
+				{
+					float dir[3];
+					IBLReferenceBaker::GetTexelDirection(face, x, y, mipSize, dir);
+					func(dir, pDst);
+					pDst += 4;
+				}
+			}
+		}
+	}
+
+	return cube;
+}
+
+//-----------------------------------------------------------------------------
+//      Hammersley 点列を検証します.
+//-----------------------------------------------------------------------------
+void TestRadicalInverse()
+{
+	// Hammersley 点列の2成分目は HLSL の reversebits() と同じ値になります.
+	CHECK(IBLReferenceBaker::RadicalInverse(1) == 0.5f);
+	CHECK(IBLReferenceBaker::RadicalInverse(2) == 0.25f);
+	CHECK(IBLReferenceBaker::RadicalInverse(3) == 0.75f);
+}
+
+//-----------------------------------------------------------------------------
+//      DFG項の積分を検証します.
+//-----------------------------------------------------------------------------
+void TestDFG()
+{
+	// DFG項: SIMD版がシェーダをそのまま移植した実装と一致し, スレッド数に依らず同じ結果になること.
+	const uint32_t size = 32;
+	IBLCache::Texture single, multi;
+	CHECK(IBLReferenceBaker::IntegrateDFG(size, DFGSampleCount, 1, single));
+	CHECK(IBLReferenceBaker::IntegrateDFG(size, DFGSampleCount, 4, multi));
+	CHECK(single.Pixels.size() == IBLCache::GetDataSize(single));
+	CHECK(single.Pixels == multi.Pixels);
+
+	auto pTexels  = reinterpret_cast<const float*>(single.Pixels.data());
+	auto maxError = 0.0f;
+	auto inRange  = true;
+	for (auto y = 0u; y < size; ++y)
+	{
+		for (auto x = 0u; x < size; ++x)
+		{
+			float expected[2];
+			IBLReferenceBaker::IntegrateDFGTexel((x + 0.5f) / size, 1.0f - (y + 0.5f) / size, DFGSampleCount, expected);
+
+			auto pTexel = pTexels + (y * size + x) * 2;
+			maxError = std::max(maxError, fabsf(pTexel[0] - expected[0]));
+			maxError = std::max(maxError, fabsf(pTexel[1] - expected[1]));
+			inRange &= (pTexel[0] >= 0.0f && pTexel[1] >= 0.0f && pTexel[0] + pTexel[1] <= 1.0001f);
+		}
+	}
+	CHECK(maxError <= 1e-4f);
+	CHECK(inRange);
+}
+
+//-----------------------------------------------------------------------------
+//      一様な環境マップのLD項を検証します.
+//-----------------------------------------------------------------------------
+void TestUniformLD()
+{
+	// LD項: 一様な環境マップはどのラフネスでも同じ値になること.
+	auto cube = MakeReferenceCube(32, 6, [](const float dir[3], float rgba[4])
+	{
+		(void)dir;
+		rgba[0] = 0.5f; rgba[1] = 0.25f; rgba[2] = 2.0f; rgba[3] = 1.0f;
+	});
+
+	IBLCache::Texture result;
+	CHECK(IBLReferenceBaker::IntegrateSpecularLD(cube, 16, 5, LDSampleCount, 2, result));
+
+	auto pTexels  = reinterpret_cast<const float*>(result.Pixels.data());
+	auto maxError = 0.0f;
+	for (size_t i = 0; i < result.Pixels.size() / (sizeof(float) * 4); ++i)
+	{
+		maxError = std::max(maxError, fabsf(pTexels[i * 4 + 0] - 0.5f));
+		maxError = std::max(maxError, fabsf(pTexels[i * 4 + 1] - 0.25f));
+		maxError = std::max(maxError, fabsf(pTexels[i * 4 + 2] - 2.0f));
+	}
+	CHECK(maxError <= 1e-4f);
+}
+
+//-----------------------------------------------------------------------------
+//      模様のある環境マップのLD項を検証します.
+//-----------------------------------------------------------------------------
+void TestPatternLD()
+{
+	// LD項: 模様のある環境マップで, SIMD版がシェーダをそのまま移植した実装と一致すること.
+	auto cube = MakeReferenceCube(32, 6, [](const float dir[3], float rgba[4])
+	{
+		rgba[0] = std::max(dir[1], 0.0f) * 4.0f + 0.1f;
+		rgba[1] = dir[0] * 0.5f + 0.5f;
+		rgba[2] = expf(8.0f * (dir[2] - 1.0f)) * 10.0f;
+		rgba[3] = 1.0f;
+	});
+
+	const uint32_t size     = 16;
+	const uint32_t mipCount = 5;
+	IBLCache::Texture single, multi;
+	CHECK(IBLReferenceBaker::IntegrateSpecularLD(cube, size, mipCount, LDSampleCount, 1, single));
+	CHECK(IBLReferenceBaker::IntegrateSpecularLD(cube, size, mipCount, LDSampleCount, 3, multi));
+	CHECK(single.Pixels.size() == IBLCache::GetDataSize(single));
+	CHECK(single.Pixels == multi.Pixels);
+
+	size_t sliceSize = 0;
+	for (auto mip = 0u; mip < mipCount; ++mip)
+	{
+		auto mipSize = std::max(size >> mip, 1u);
+		sliceSize += size_t(mipSize) * mipSize * 4;
+	}
+
+	// IntegrateLD() と同じくラフネスを加算で求めます.
+	auto pTexels   = reinterpret_cast<const float*>(single.Pixels.data());
+	auto roughness = 0.0f;
+	auto offset    = size_t(0);
+	auto maxError  = 0.0f;
+	for (auto mip = 0u; mip < mipCount; ++mip)
+	{
+		auto mipSize = std::max(size >> mip, 1u);
+		auto step    = std::max(mipSize / 4, 1u);
+		for (auto face = 0u; face < 6; ++face)
+		{
+			for (auto y = 0u; y < mipSize; y += step)
+			{
+				for (auto x = 0u; x < mipSize; x += step)
+				{
+					float dir[3], expected[3];
+					IBLReferenceBaker::GetTexelDirection(face, x, y, mipSize, dir);
+					IBLReferenceBaker::IntegrateSpecularTexel(cube, dir, roughness * roughness, LDSampleCount, expected);
+
+					auto pTexel = pTexels + face * sliceSize + offset + (size_t(y) * mipSize + x) * 4;
+					for (auto c = 0; c < 3; ++c)
+					{
+						maxError = std::max(maxError, fabsf(pTexel[c] - expected[c]) / std::max(fabsf(expected[c]), 1e-3f));
+					}
+				}
+			}
+		}
+		offset    += size_t(mipSize) * mipSize * 4;
+		roughness += 1.0f / float(mipCount - 1);
+	}
+	CHECK(maxError <= 1e-4f);
+}
+
+//-----------------------------------------------------------------------------
+//      CPU参照ベイクの処理時間を解像度ごとに計測します.
+//-----------------------------------------------------------------------------
+void BenchmarkResolution()
+{
+	const auto threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	// 入力は IBLBaker の LD 項と同程度の 256 のミップ付きキューブマップです.
+	auto cube = MakeReferenceCube(256, 9, [](const float dir[3], float rgba[4])
+	{
+		rgba[0] = std::max(dir[1], 0.0f) * 4.0f + 0.1f;
+		rgba[1] = dir[0] * 0.5f + 0.5f;
+		rgba[2] = expf(8.0f * (dir[2] - 1.0f)) * 10.0f;
+		rgba[3] = 1.0f;
+	});
+
+	const uint32_t dfgSizes[3] = { 128, 256, 512 };
+	const uint32_t ldSizes [3] = { 64, 128, 256 };
+
+	IBLCache::Texture result;
+	for (auto size : dfgSizes)
+	{
+		auto single = MeasureMilliSec([&]() { IBLReferenceBaker::IntegrateDFG(size, DFGSampleCount, 1, result); });
+		auto multi  = MeasureMilliSec([&]() { IBLReferenceBaker::IntegrateDFG(size, DFGSampleCount, threadCount, result); });
+		printf("DFG %4u : %8.1f ms (1 thread) / %8.1f ms (%u threads)\n", size, single, multi, threadCount);
+	}
+
+	for (auto size : ldSizes)
+	{
+		auto mipCount = std::min(MipCount, uint32_t(log2(size)) + 1);
+		auto single = MeasureMilliSec([&]() { IBLReferenceBaker::IntegrateSpecularLD(cube, size, mipCount, LDSampleCount, 1, result); });
+		auto multi  = MeasureMilliSec([&]() { IBLReferenceBaker::IntegrateSpecularLD(cube, size, mipCount, LDSampleCount, threadCount, result); });
+		printf("LD  %4u : %8.1f ms (1 thread) / %8.1f ms (%u threads)\n", size, single, multi, threadCount);
+	}
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	TestRadicalInverse();
+	TestDFG();
+	TestUniformLD();
+	TestPatternLD();
+
+	if (IsBenchmark(argc, argv))
+	{ BenchmarkResolution(); }
+
+	return TestReport("IBLReference");
+}
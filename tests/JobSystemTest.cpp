@@ -0,0 +1,247 @@
+﻿//-----------------------------------------------------------------------------
+// File : JobSystemTest.cpp
+// Desc : Work Stealing Job System Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <JobSystem.h>
+#include <algorithm>
+#include <random>
+#include <cmath>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      単一スレッドでの積み下ろしを検証します.
+//-----------------------------------------------------------------------------
+void TestDequeOrder()
+{
+	std::unique_ptr<WorkStealingDeque> deque(new WorkStealingDeque());
+	std::vector<Task> tasks(8);
+
+	CHECK(deque->Pop()   == nullptr);
+	CHECK(deque->Steal() == nullptr);
+
+	for (auto& task : tasks)
+	{ CHECK(deque->Push(&task)); }
+
+	// 所有スレッドは後から積んだものを, 盗む側は先に積んだものを取り出すこと.
+	CHECK(deque->Pop()   == &tasks[7]);
+	CHECK(deque->Steal() == &tasks[0]);
+	CHECK(deque->Steal() == &tasks[1]);
+	CHECK(deque->Pop()   == &tasks[6]);
+
+	for (auto i = 0; i < 4; ++i)
+	{ CHECK(deque->Pop() != nullptr); }
+	CHECK(deque->Pop()   == nullptr);
+	CHECK(deque->Steal() == nullptr);
+
+	// 満杯になれば積めないこと.
+	Task task;
+	for (auto i = 0; i < WorkStealingDeque::Capacity; ++i)
+	{ deque->Push(&task); }
+	CHECK(!deque->Push(&task));
+	CHECK(deque->Steal() == &task);
+	CHECK(deque->Push(&task));
+}
+
+//-----------------------------------------------------------------------------
+//      所有スレッドと盗む側が競合しても, 全てのタスクが1回ずつ取り出されることを検証します.
+//-----------------------------------------------------------------------------
+void TestDequeSteal()
+{
+	const uint32_t count   = 200000;
+	const uint32_t thieves = 3;
+
+	std::unique_ptr<WorkStealingDeque> deque(new WorkStealingDeque());
+	std::vector<Task> tasks(count);
+	std::vector<std::atomic<uint32_t>> taken(count);
+	for (auto& t : taken)
+	{ t.store(0); }
+
+	auto take = [&](Task* pTask)
+	{ taken[size_t(pTask - tasks.data())]++; };
+
+	std::atomic<bool> done(false);
+	std::vector<std::thread> threads;
+	for (auto i = 0u; i < thieves; ++i)
+	{
+		threads.emplace_back([&]()
+		{
+			while (!done.load())
+			{
+				auto pTask = deque->Steal();
+				if (pTask != nullptr)
+				{ take(pTask); }
+			}
+		});
+	}
+
+	// 積む量と取り出す量を変えて, 空になる境界での競合も起こす.
+	std::mt19937 rng(777);
+	uint32_t pushed = 0;
+	while (pushed < count)
+	{
+		auto burst = 1 + rng() % 64;
+		for (auto i = 0u; i < burst && pushed < count; ++i)
+		{
+			if (deque->Push(&tasks[pushed]))
+			{ pushed++; }
+		}
+
+		auto pops = rng() % 64;
+		for (auto i = 0u; i < pops; ++i)
+		{
+			auto pTask = deque->Pop();
+			if (pTask != nullptr)
+			{ take(pTask); }
+		}
+	}
+
+	while (auto pTask = deque->Pop())
+	{ take(pTask); }
+
+	done.store(true);
+	for (auto& thread : threads)
+	{ thread.join(); }
+
+	CHECK(std::all_of(taken.begin(), taken.end(), [](const std::atomic<uint32_t>& t) { return t.load() == 1; }));
+}
+
+//-----------------------------------------------------------------------------
+//      固定シードの入力でジョブシステムの結果を逐次実行と比較します.
+//-----------------------------------------------------------------------------
+void TestJobSystem(uint32_t rounds)
+{
+	JobSystem jobs;
+	CHECK(jobs.Init(4));
+	CHECK(jobs.GetWorkerCount() == 4);
+
+	std::mt19937 rng(12345);
+
+	for (auto round = 0u; round < rounds; ++round)
+	{
+		// ParallelFor: 要素ごとの結果が逐次実行と一致すること.
+		{
+			const uint32_t count = 10000 + rng() % 100000;
+			const uint32_t grain = 1 + rng() % 512;
+			std::vector<uint64_t> values(count, 0);
+			jobs.ParallelFor(count, grain, [&values](uint32_t begin, uint32_t end)
+			{
+				for (auto i = begin; i < end; ++i)
+				{ values[i] += uint64_t(i) * i + 1; }
+			});
+
+			bool pass = true;
+			for (auto i = 0u; i < count; ++i)
+			{ pass &= (values[i] == uint64_t(i) * i + 1); }
+			CHECK(pass);
+		}
+
+		// TaskGraph: 全てのタスクが1回ずつ, 先行タスクより後に実行されること.
+		{
+			const uint32_t count = 1000 + rng() % 4000;
+			std::vector<uint32_t> order(count, 0);
+			std::vector<std::pair<uint32_t, uint32_t>> edges;
+			std::atomic<uint32_t> counter(0);
+
+			TaskGraph graph;
+			for (auto i = 0u; i < count; ++i)
+			{ graph.Add([&order, &counter, i]() { order[i] = ++counter; }); }
+
+			for (auto i = 1u; i < count; ++i)
+			{
+				const uint32_t edgeCount = rng() % 4;
+				for (auto j = 0u; j < edgeCount; ++j)
+				{
+					const uint32_t before = rng() % i;
+					graph.Precede(before, i);
+					edges.push_back(std::make_pair(before, i));
+				}
+			}
+
+			jobs.Run(graph);
+			jobs.Wait(graph);
+
+			bool pass = (counter.load() == count);
+			for (const auto& edge : edges)
+			{ pass &= (order[edge.first] != 0 && order[edge.first] < order[edge.second]); }
+			CHECK(pass);
+		}
+
+		// 入れ子: タスクの中で待っても全て完了すること.
+		{
+			std::atomic<uint32_t> total(0);
+			jobs.ParallelFor(64, 1, [&jobs, &total](uint32_t begin, uint32_t end)
+			{
+				for (auto i = begin; i < end; ++i)
+				{ jobs.ParallelFor(1000, 50, [&total](uint32_t b, uint32_t e) { total += e - b; }); }
+			});
+			CHECK(total.load() == 64 * 1000);
+		}
+	}
+
+	jobs.Term();
+}
+
+//-----------------------------------------------------------------------------
+//      ワーカー数を1からコア数まで変えてジョブシステムを計測します.
+//-----------------------------------------------------------------------------
+void BenchmarkScaling()
+{
+	const uint32_t count    = 1 << 20;
+	const uint32_t grain    = 4096;
+	const uint32_t maxCount = std::max(1u, std::thread::hardware_concurrency());
+
+	std::vector<float> values(count);
+	auto work = [&values](uint32_t begin, uint32_t end)
+	{
+		for (auto i = begin; i < end; ++i)
+		{
+			auto x = float(i) * 1.0e-3f;
+			for (auto k = 0; k < 16; ++k)
+			{ x = std::sin(x) + 1.0f; }
+			values[i] = x;
+		}
+	};
+
+	double base = 0.0;
+	for (auto workers = 1u; workers <= maxCount; ++workers)
+	{
+		JobSystem jobs;
+		if (!jobs.Init(workers))
+		{ break; }
+
+		// 1回目はスレッドの起動を含むので捨てる.
+		jobs.ParallelFor(count, grain, work);
+		auto ms = MeasureMilliSec([&]() { jobs.ParallelFor(count, grain, work); });
+		jobs.Term();
+
+		if (workers == 1)
+		{ base = ms; }
+		printf("%2u workers : %8.2f ms (x%.2f)\n", workers, ms, base / std::max(ms, 1.0e-6));
+	}
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	TestDequeOrder();
+	TestDequeSteal();
+	TestJobSystem(100);
+
+	if (IsBenchmark(argc, argv))
+	{ BenchmarkScaling(); }
+
+	return TestReport("JobSystem");
+}
@@ -0,0 +1,225 @@
+﻿//-----------------------------------------------------------------------------
+// File : MaterialParamBufferTest.cpp
+// Desc : Material Parameter Buffer Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <TestDevice.h>
+#include <MaterialParamBuffer.h>
+#include <MaterialInstance.h>
+#include <Material.h>
+#include <memory>
+#include <vector>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Using Statements
+//-----------------------------------------------------------------------------
+using DirectX::SimpleMath::Vector4;
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const uint32_t Capacity = 64;
+const uint32_t PoolSize = 64;
+
+//-----------------------------------------------------------------------------
+//      先頭のパラメータだけを設定したブロックを生成します.
+//-----------------------------------------------------------------------------
+MaterialParamBlock MakeBlock(float value)
+{
+	MaterialParamBlock block;
+	block.Param[0] = Vector4(value, 0.0f, 0.0f, 1.0f);
+	return block;
+}
+
+//-----------------------------------------------------------------------------
+//      全フレーム分を転送して, 転送したブロック数の合計を返却します.
+//-----------------------------------------------------------------------------
+uint32_t Flush(MaterialParamBuffer& buffer)
+{
+	uint32_t uploads = 0;
+	for (auto i = 0u; i < App::FrameCount; ++i)
+	{
+		buffer.Update(i);
+		uploads += buffer.GetLastUploadCount();
+	}
+	return uploads;
+}
+
+//-----------------------------------------------------------------------------
+//      書き込んだブロックだけがフレームごとに1回ずつ転送されることを検証します.
+//-----------------------------------------------------------------------------
+void TestUpload(ID3D12Device* pDevice, DescriptorPool* pPool)
+{
+	MaterialParamBuffer buffer;
+	CHECK(buffer.Init(pDevice, pPool, Capacity));
+
+	auto a = buffer.Alloc();
+	auto b = buffer.Alloc();
+	CHECK(a == 0);
+	CHECK(b == 1);
+	CHECK(buffer.GetAllocatedCount() == 2);
+
+	// 同じブロックへの書き込みは1つにまとめる.
+	buffer.Write(a, MakeBlock(1.0f));
+	buffer.Write(a, MakeBlock(2.0f));
+	CHECK(buffer.GetPendingCount() == 1);
+
+	for (auto i = 0u; i < App::FrameCount; ++i)
+	{
+		buffer.Update(i);
+		CHECK(buffer.GetLastUploadCount() == 1);
+	}
+	CHECK(buffer.GetPendingCount() == 0);
+	CHECK(buffer.GetBlock(a).Param[0].x == 2.0f);
+
+	buffer.Update(0);
+	CHECK(buffer.GetLastUploadCount() == 0);
+
+	buffer.Term();
+}
+
+//-----------------------------------------------------------------------------
+//      転送待ちのブロックを解放しても転送リストに残らないことを検証します.
+//-----------------------------------------------------------------------------
+void TestFreePending(ID3D12Device* pDevice, DescriptorPool* pPool)
+{
+	MaterialParamBuffer buffer;
+	CHECK(buffer.Init(pDevice, pPool, Capacity));
+
+	auto index  = buffer.Alloc();
+	auto reused = buffer.Alloc();
+	buffer.Free(reused);
+
+	// 転送前に解放と再割り当てを繰り返しても, 転送待ちは増えない.
+	for (auto round = 0u; round < Capacity * 4; ++round)
+	{
+		CHECK(buffer.Alloc() == reused);
+
+		buffer.Write(reused, MakeBlock(float(round)));
+		CHECK(buffer.GetPendingCount() == 1);
+
+		buffer.Free(reused);
+		CHECK(buffer.GetPendingCount() == 0);
+	}
+
+	// 再割り当てしたブロックは全フレームへ1回ずつだけ転送する.
+	CHECK(buffer.Alloc() == reused);
+	buffer.Write(reused, MakeBlock(2.0f));
+	CHECK(buffer.GetPendingCount() == 1);
+	CHECK(Flush(buffer) == App::FrameCount);
+	CHECK(buffer.GetPendingCount() == 0);
+
+	// 一部のフレームだけ転送した後で解放した場合も残らない.
+	buffer.Write(index, MakeBlock(3.0f));
+	buffer.Update(0);
+	CHECK(buffer.GetPendingCount() == ((App::FrameCount > 1) ? 1u : 0u));
+	buffer.Free(index);
+	CHECK(buffer.GetPendingCount() == 0);
+	CHECK(Flush(buffer) == 0);
+
+	buffer.Term();
+}
+
+//-----------------------------------------------------------------------------
+//      インスタンスの一部だけを変更した場合の転送量を検証します.
+//-----------------------------------------------------------------------------
+void TestInstanceUpload(ID3D12Device* pDevice, DescriptorPool* pPool, uint32_t count, bool print)
+{
+	MaterialParamBuffer buffer;
+	CHECK(buffer.Init(pDevice, pPool, count));
+
+	// インスタンスより先に破棄されないよう, テンプレートを先に宣言する.
+	Material templ;
+	std::vector<std::unique_ptr<MaterialInstance>> instances(count);
+
+	// 16 スロットのうち 2 つだけを上書きする.
+	size_t instanceBytes = 0;
+	for (auto i = 0u; i < count; ++i)
+	{
+		instances[i].reset(new MaterialInstance());
+		CHECK(instances[i]->Init(&templ, &buffer));
+		instances[i]->SetParam(0, Vector4(float(i), 0.0f, 0.0f, 1.0f));
+		instances[i]->SetParam(1, Vector4(0.5f, 0.5f, 0.0f, 0.0f));
+		instanceBytes += instances[i]->GetMemorySize();
+	}
+	CHECK(buffer.GetAllocatedCount() == count);
+
+	// 初回は全てのインスタンスを全フレームへ転送する.
+	CHECK(Flush(buffer) == count * App::FrameCount);
+
+	// 全て・1%・変更なしの順に, 上書き値を変えてから1フレーム分を転送する.
+	const char*    names  [3] = { "All Dirty", "1% Dirty ", "No Change" };
+	const uint32_t strides[3] = { 1, 100, 0 };
+	for (auto s = 0; s < 3; ++s)
+	{
+		uint32_t written = 0;
+		if (strides[s] > 0)
+		{
+			for (auto i = 0u; i < count; i += strides[s])
+			{
+				instances[i]->SetParam(0, Vector4(float(i), float(s + 1), 0.0f, 1.0f));
+				written++;
+			}
+		}
+
+		auto time = MeasureMilliSec([&]() { buffer.Update(0); });
+		CHECK(buffer.GetLastUploadCount() == written);
+
+		if (print)
+		{
+			printf("%s : %5u blocks, %6zu KB, %.3f ms\n", names[s], buffer.GetLastUploadCount(),
+				buffer.GetLastUploadCount() * sizeof(MaterialParamBlock) / 1024, time);
+		}
+
+		// 残りのフレームへの転送を済ませておく.
+		Flush(buffer);
+		CHECK(buffer.GetPendingCount() == 0);
+	}
+
+	if (print)
+	{
+		printf("Memory : %zu KB CPU (%zu instances + %zu buffer), %zu KB GPU\n",
+			(instanceBytes + buffer.GetCpuMemorySize()) / 1024, instanceBytes / 1024,
+			buffer.GetCpuMemorySize() / 1024, buffer.GetGpuMemorySize() / 1024);
+	}
+
+	for (auto& pInstance : instances)
+	{ pInstance->Term(); }
+
+	CHECK(buffer.GetAllocatedCount() == 0);
+	buffer.Term();
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	ComPtr<ID3D12Device> pDevice;
+	DescriptorPool*      pPool = nullptr;
+	CHECK(CreateTestDevice(pDevice.GetAddressOf()));
+	CHECK(pDevice != nullptr && CreateTestPool(pDevice.Get(), PoolSize, &pPool));
+
+	if (pPool != nullptr)
+	{
+		TestUpload(pDevice.Get(), pPool);
+		TestFreePending(pDevice.Get(), pPool);
+		TestInstanceUpload(pDevice.Get(), pPool, 1000, false);
+		if (IsBenchmark(argc, argv))
+		{ TestInstanceUpload(pDevice.Get(), pPool, 10000, true); }
+		pPool->Release();
+	}
+
+	return TestReport("MaterialParamBuffer");
+}
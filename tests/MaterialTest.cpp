@@ -0,0 +1,160 @@
+﻿//-----------------------------------------------------------------------------
+// File : MaterialTest.cpp
+// Desc : Material Allocation Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <TestDevice.h>
+#include <Material.h>
+#include <Texture.h>
+#include <new>
+#include <vector>
+
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// Allocation structure
+///////////////////////////////////////////////////////////////////////////////
+struct Allocation
+{
+	uint32_t    Resources   = 0;    //!< 生成したコミットリソース数です.
+	uint32_t    Descriptors = 0;    //!< 確保したディスクリプタ数です.
+};
+
+//-----------------------------------------------------------------------------
+//      マテリアル生成で確保するリソース数を計測します.
+//-----------------------------------------------------------------------------
+bool MeasureAllocation(ID3D12Device* pDevice, uint32_t materialCount, bool legacy, Allocation& result)
+{
+	result = Allocation();
+
+	// 以前の方法は N*N 個の定数バッファと N 個のダミーテクスチャを確保していた.
+	DescriptorPool* pPool = nullptr;
+	if (!CreateTestPool(pDevice, legacy ? materialCount * materialCount + materialCount : materialCount, &pPool))
+	{ return false; }
+
+	D3D12_RESOURCE_DESC dummyDesc = {};
+	dummyDesc.Dimension        = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	dummyDesc.Width            = 1;
+	dummyDesc.Height           = 1;
+	dummyDesc.DepthOrArraySize = 1;
+	dummyDesc.MipLevels        = 1;
+	dummyDesc.Format           = DXGI_FORMAT_R8G8B8A8_UNORM;
+	dummyDesc.Layout           = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+	dummyDesc.SampleDesc.Count = 1;
+
+	std::vector<Material*>  materials;
+	std::vector<Texture*>   dummies;
+	bool                    succeeded = true;
+
+	for (auto i = 0u; i < materialCount && succeeded; ++i)
+	{
+		auto pMaterial = new (std::nothrow) Material();
+		if (pMaterial == nullptr)
+		{
+			succeeded = false;
+			break;
+		}
+		materials.push_back(pMaterial);
+
+		// 以前はモデルのマテリアル数をサブセット数として渡していた.
+		succeeded = pMaterial->Init(pDevice, pPool, sizeof(CommonCb::CbMaterial), legacy ? materialCount : 1);
+		result.Resources += uint32_t(pMaterial->GetResourceCount());
+
+		// 以前はマテリアルごとに 1x1 のダミーテクスチャを生成していた.
+		if (succeeded && legacy)
+		{
+			auto pTexture = new (std::nothrow) Texture();
+			if (pTexture == nullptr)
+			{
+				succeeded = false;
+				break;
+			}
+			dummies.push_back(pTexture);
+
+			succeeded = pTexture->Init(pDevice, pPool, &dummyDesc, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, false);
+			if (succeeded)
+			{ result.Resources++; }
+		}
+	}
+
+	result.Descriptors = pPool->GetAllocatedHandleCount();
+
+	for (auto pTexture : dummies)
+	{
+		pTexture->Term();
+		delete pTexture;
+	}
+	for (auto pMaterial : materials)
+	{
+		pMaterial->Term();
+		delete pMaterial;
+	}
+	pPool->Release();
+
+	return succeeded;
+}
+
+//-----------------------------------------------------------------------------
+//      マテリアルごとに定数バッファを1つだけ確保することを検証します.
+//-----------------------------------------------------------------------------
+void TestAllocation(ID3D12Device* pDevice, uint32_t count, bool print)
+{
+	// 未設定のテクスチャは共有のフォールバックを参照するので, テクスチャは生成しない.
+	Allocation current;
+	auto currentTime = MeasureMilliSec([&]() { CHECK(MeasureAllocation(pDevice, count, false, current)); });
+	CHECK(current.Resources   == count);
+	CHECK(current.Descriptors == count);
+
+	// 以前の方法は N*N 個の定数バッファを確保するので, 大きな数では計測しない.
+	Allocation legacy;
+	double     legacyTime = 0.0;
+	if (count <= 32)
+	{
+		legacyTime = MeasureMilliSec([&]() { CHECK(MeasureAllocation(pDevice, count, true, legacy)); });
+		CHECK(legacy.Resources   == count * count + count);
+		CHECK(legacy.Descriptors == count * count + count);
+	}
+
+	if (print)
+	{
+		if (count <= 32)
+		{
+			printf("%4u materials : %5u -> %4u resources, %5u -> %4u descriptors, %.2f -> %.2f ms\n",
+				count, legacy.Resources, current.Resources, legacy.Descriptors, current.Descriptors, legacyTime, currentTime);
+		}
+		else
+		{
+			printf("%4u materials : %u resources, %u descriptors, %.2f ms\n",
+				count, current.Resources, current.Descriptors, currentTime);
+		}
+	}
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	ComPtr<ID3D12Device> pDevice;
+	CHECK(CreateTestDevice(pDevice.GetAddressOf()));
+
+	if (pDevice != nullptr)
+	{
+		const bool print = IsBenchmark(argc, argv);
+		TestAllocation(pDevice.Get(), 1,  print);
+		TestAllocation(pDevice.Get(), 32, print);
+		if (print)
+		{ TestAllocation(pDevice.Get(), 1000, print); }
+	}
+
+	return TestReport("Material");
+}
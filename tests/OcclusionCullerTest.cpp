@@ -0,0 +1,241 @@
+﻿//-----------------------------------------------------------------------------
+// File : OcclusionCullerTest.cpp
+// Desc : Software Occlusion Culling Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <OcclusionCuller.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+
+using namespace DirectX;
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const uint32_t Width  = 320;    // タイル境界に揃わない大きさにする.
+const uint32_t Height = 180;
+
+///////////////////////////////////////////////////////////////////////////////
+// Comparison structure
+///////////////////////////////////////////////////////////////////////////////
+struct Comparison
+{
+	uint32_t    Mismatch;   //!< 参照実装と深度が異なるピクセル数です.
+	float       MaxError;   //!< 深度の最大誤差です.
+	uint32_t    Covered;    //!< 遮蔽物を描画したピクセル数です.
+};
+
+//-----------------------------------------------------------------------------
+//      原点にある 1x1x1 の立方体の遮蔽物を生成します.
+//-----------------------------------------------------------------------------
+OcclusionCuller::Occluder MakeCube()
+{
+	OcclusionCuller::Occluder result;
+	for (auto i = 0; i < 8; ++i)
+	{
+		result.Positions.push_back(XMFLOAT3(
+			(i & 1) ? 0.5f : -0.5f,
+			(i & 2) ? 0.5f : -0.5f,
+			(i & 4) ? 0.5f : -0.5f));
+	}
+
+	const uint32_t indices[] = {
+		0, 2, 1,  1, 2, 3,      // -Z
+		4, 5, 6,  5, 7, 6,      // +Z
+		0, 1, 4,  1, 5, 4,      // -Y
+		2, 6, 3,  3, 6, 7,      // +Y
+		0, 4, 2,  2, 4, 6,      // -X
+		1, 3, 5,  3, 7, 5,      // +X
+	};
+	result.Indices.assign(std::begin(indices), std::end(indices));
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      原点から -Z 方向を向いたカメラのビュー射影行列を生成します.
+//-----------------------------------------------------------------------------
+XMFLOAT4X4 MakeViewProj()
+{
+	auto view = XMMatrixLookAtRH(
+		XMVectorSet(0.0f, 0.0f,  0.0f, 0.0f),
+		XMVectorSet(0.0f, 0.0f, -1.0f, 0.0f),
+		XMVectorSet(0.0f, 1.0f,  0.0f, 0.0f));
+	auto proj = XMMatrixPerspectiveFovRH(XMConvertToRadians(60.0f), float(Width) / float(Height), 0.1f, 200.0f);
+
+	XMFLOAT4X4 result;
+	XMStoreFloat4x4(&result, XMMatrixMultiply(view, proj));
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      平行移動と拡大縮小のワールド行列を生成します.
+//-----------------------------------------------------------------------------
+XMFLOAT4X4 MakeWorld(float x, float y, float z, float scale)
+{
+	auto m = XMMatrixIdentity();
+	m.r[0] = XMVectorScale(m.r[0], scale);
+	m.r[1] = XMVectorScale(m.r[1], scale);
+	m.r[2] = XMVectorScale(m.r[2], scale);
+	m.r[3] = XMVectorSet(x, y, z, 1.0f);
+
+	XMFLOAT4X4 result;
+	XMStoreFloat4x4(&result, m);
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      カメラの前にランダムな立方体を並べて描画します.
+//-----------------------------------------------------------------------------
+void RenderRandomCubes(OcclusionCuller& culler, const OcclusionCuller::Occluder& cube, uint32_t count, uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> x    (-30.0f,  30.0f);
+	std::uniform_real_distribution<float> z    (-80.0f,  -2.0f);
+	std::uniform_real_distribution<float> scale(  0.5f,   6.0f);
+
+	culler.Begin(MakeViewProj());
+	for (auto i = 0u; i < count; ++i)
+	{ culler.AddOccluder(&cube, MakeWorld(x(rng), x(rng) * 0.5f, z(rng), scale(rng))); }
+	culler.Render();
+}
+
+//-----------------------------------------------------------------------------
+//      SIMD・マルチスレッドの描画結果を参照実装と比べます.
+//-----------------------------------------------------------------------------
+Comparison CompareWithReference(const OcclusionCuller& culler)
+{
+	std::vector<float> reference;
+	culler.RenderReference(reference);
+
+	Comparison result = {};
+	const auto depth  = culler.GetDepth();
+	const auto pitch  = culler.GetPitch();
+	for (auto y = 0u; y < culler.GetHeight(); ++y)
+	{
+		for (auto x = 0u; x < culler.GetWidth(); ++x)
+		{
+			auto a = depth    [y * pitch + x];
+			auto b = reference[y * pitch + x];
+			if (a != b)
+			{
+				result.Mismatch++;
+				result.MaxError = std::max(result.MaxError, std::abs(a - b));
+			}
+			if (b < 1.0f)
+			{ result.Covered++; }
+		}
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      深度バッファが参照実装と一致することを検証します.
+//-----------------------------------------------------------------------------
+void TestMatchesReference(uint32_t threadCount)
+{
+	OcclusionCuller culler;
+	CHECK(culler.Init(Width, Height, threadCount));
+	CHECK(culler.GetPitch() >= Width);
+
+	auto cube = MakeCube();
+	for (auto seed : { 1u, 2u, 3u })
+	{
+		RenderRandomCubes(culler, cube, 64, seed);
+
+		auto result = CompareWithReference(culler);
+		CHECK(result.Mismatch == 0);
+		CHECK(result.MaxError == 0.0f);
+		CHECK(result.Covered  >  0);
+	}
+
+	// ニア平面をまたぐ遮蔽物もクリップして同じ結果になる.
+	culler.Begin(MakeViewProj());
+	culler.AddOccluder(&cube, MakeWorld(0.0f, 0.0f, 0.0f, 2.0f));
+	culler.Render();
+	CHECK(CompareWithReference(culler).Mismatch == 0);
+
+	culler.Term();
+}
+
+//-----------------------------------------------------------------------------
+//      遮蔽の判定を検証します.
+//-----------------------------------------------------------------------------
+void TestOcclusion()
+{
+	OcclusionCuller culler;
+	CHECK(culler.Init(Width, Height, 2));
+
+	// 正面の大きな壁.
+	auto cube = MakeCube();
+	culler.Begin(MakeViewProj());
+	culler.AddOccluder(&cube, MakeWorld(0.0f, 0.0f, -10.0f, 8.0f));
+	culler.Render();
+
+	const XMFLOAT3 small(0.5f, 0.5f, 0.5f);
+	CHECK(!culler.TestAABB(XMFLOAT3( 0.0f,  0.0f, -30.0f), small));    // 壁の後ろ.
+	CHECK( culler.TestAABB(XMFLOAT3( 0.0f,  0.0f,  -3.0f), small));    // 壁の手前.
+	CHECK( culler.TestAABB(XMFLOAT3(20.0f,  0.0f, -30.0f), small));    // 壁の横.
+	CHECK(!culler.TestAABB(XMFLOAT3(200.0f, 0.0f, -30.0f), small));    // 画面外.
+
+	// ニア平面をまたぐ場合やカメラの後ろは判定できないので見えるものとする.
+	CHECK( culler.TestAABB(XMFLOAT3( 0.0f,  0.0f,   0.0f), small));
+	CHECK( culler.TestAABB(XMFLOAT3( 0.0f,  0.0f,  30.0f), small));
+
+	const auto& stats = culler.GetStats();
+	CHECK(stats.Occluders == 1);
+	CHECK(stats.Tested    == 6);
+	CHECK(stats.Occluded  == 2);
+
+	culler.Term();
+}
+
+//-----------------------------------------------------------------------------
+//      SIMD・マルチスレッドと参照実装の処理時間を計測します.
+//-----------------------------------------------------------------------------
+void BenchmarkRender()
+{
+	auto threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+	OcclusionCuller culler;
+	CHECK(culler.Init(512, 256, threadCount));
+
+	auto cube = MakeCube();
+	auto renderTime = MeasureMilliSec([&]() { RenderRandomCubes(culler, cube, 1000, 12345); });
+
+	std::vector<float> reference;
+	auto referenceTime = MeasureMilliSec([&]() { culler.RenderReference(reference); });
+
+	auto result = CompareWithReference(culler);
+	CHECK(result.Mismatch == 0);
+
+	printf("Occlusion 1000 cubes : SIMD+MT %.3f ms (%u workers), reference %.3f ms, %u px covered\n",
+		renderTime, threadCount, referenceTime, result.Covered);
+
+	culler.Term();
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	TestMatchesReference(0);
+	TestMatchesReference(3);
+	TestOcclusion();
+	if (IsBenchmark(argc, argv))
+	{ BenchmarkRender(); }
+	return TestReport("OcclusionCuller");
+}
@@ -0,0 +1,260 @@
+﻿//-----------------------------------------------------------------------------
+// File : PipelineCacheTest.cpp
+// Desc : Pipeline Cache Key Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <PipelineCache.h>
+#include <climits>
+#include <cstring>
+#include <cwchar>
+#include <functional>
+#include <vector>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const uint8_t Shader[] = { 0x44, 0x58, 0x42, 0x43, 0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe };
+
+//-----------------------------------------------------------------------------
+//      ブレンドステートを生成します.
+//-----------------------------------------------------------------------------
+D3D12_BLEND_DESC MakeBlend(bool alphaBlend)
+{
+	D3D12_BLEND_DESC desc = {};
+	desc.AlphaToCoverageEnable  = FALSE;
+	desc.IndependentBlendEnable = FALSE;
+	for (auto& target : desc.RenderTarget)
+	{
+		target.BlendEnable           = alphaBlend ? TRUE : FALSE;
+		target.LogicOpEnable         = FALSE;
+		target.SrcBlend              = D3D12_BLEND_ONE;
+		target.DestBlend             = alphaBlend ? D3D12_BLEND_INV_SRC_ALPHA : D3D12_BLEND_ZERO;
+		target.BlendOp               = D3D12_BLEND_OP_ADD;
+		target.SrcBlendAlpha         = D3D12_BLEND_ONE;
+		target.DestBlendAlpha        = alphaBlend ? D3D12_BLEND_INV_SRC_ALPHA : D3D12_BLEND_ZERO;
+		target.BlendOpAlpha          = D3D12_BLEND_OP_ADD;
+		target.LogicOp               = D3D12_LOGIC_OP_NOOP;
+		target.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+	}
+	return desc;
+}
+
+//-----------------------------------------------------------------------------
+//      ラスタライザーステートを生成します.
+//-----------------------------------------------------------------------------
+D3D12_RASTERIZER_DESC MakeRasterizer(D3D12_CULL_MODE cullMode)
+{
+	D3D12_RASTERIZER_DESC desc = {};
+	desc.FillMode              = D3D12_FILL_MODE_SOLID;
+	desc.CullMode              = cullMode;
+	desc.FrontCounterClockwise = FALSE;
+	desc.DepthBias             = D3D12_DEFAULT_DEPTH_BIAS;
+	desc.DepthBiasClamp        = D3D12_DEFAULT_DEPTH_BIAS_CLAMP;
+	desc.SlopeScaledDepthBias  = D3D12_DEFAULT_SLOPE_SCALED_DEPTH_BIAS;
+	desc.DepthClipEnable       = TRUE;
+	desc.MultisampleEnable     = FALSE;
+	desc.AntialiasedLineEnable = FALSE;
+	desc.ForcedSampleCount     = 0;
+	desc.ConservativeRaster    = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF;
+	return desc;
+}
+
+//-----------------------------------------------------------------------------
+//      深度ステンシルステートを生成します.
+//-----------------------------------------------------------------------------
+D3D12_DEPTH_STENCIL_DESC MakeDepth(bool depthWrite)
+{
+	D3D12_DEPTH_STENCIL_DESC desc = {};
+	desc.DepthEnable      = TRUE;
+	desc.DepthWriteMask   = depthWrite ? D3D12_DEPTH_WRITE_MASK_ALL : D3D12_DEPTH_WRITE_MASK_ZERO;
+	desc.DepthFunc        = D3D12_COMPARISON_FUNC_LESS_EQUAL;
+	desc.StencilEnable    = FALSE;
+	desc.StencilReadMask  = D3D12_DEFAULT_STENCIL_READ_MASK;
+	desc.StencilWriteMask = D3D12_DEFAULT_STENCIL_WRITE_MASK;
+
+	const D3D12_DEPTH_STENCILOP_DESC stencilOp = {
+		D3D12_STENCIL_OP_KEEP, D3D12_STENCIL_OP_KEEP, D3D12_STENCIL_OP_KEEP, D3D12_COMPARISON_FUNC_ALWAYS
+	};
+	desc.FrontFace = stencilOp;
+	desc.BackFace  = stencilOp;
+	return desc;
+}
+
+//-----------------------------------------------------------------------------
+//      パイプラインステートを生成します.
+//-----------------------------------------------------------------------------
+// 使用しない領域やパディングの値に依存しないよう, 埋める値を変えて構築する.
+void MakeDesc(D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, const uint8_t* pShader, const D3D12_INPUT_ELEMENT_DESC* pElements, int fill)
+{
+	memset(&desc, fill, sizeof(desc));
+	desc.pRootSignature         = nullptr;
+	desc.VS                     = { pShader, sizeof(Shader) };
+	desc.PS                     = { pShader, sizeof(Shader) };
+	desc.DS                     = {};
+	desc.HS                     = {};
+	desc.GS                     = {};
+	desc.StreamOutput           = {};
+	desc.BlendState             = MakeBlend(false);
+	desc.SampleMask             = UINT_MAX;
+	desc.RasterizerState        = MakeRasterizer(D3D12_CULL_MODE_BACK);
+	desc.DepthStencilState      = MakeDepth(true);
+	desc.InputLayout            = { pElements, 2 };
+	desc.IBStripCutValue        = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_DISABLED;
+	desc.PrimitiveTopologyType  = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+	desc.NumRenderTargets       = 1;
+	desc.RTVFormats[0]          = DXGI_FORMAT_R10G10B10A2_UNORM;
+	desc.DSVFormat              = DXGI_FORMAT_D32_FLOAT;
+	desc.SampleDesc.Count       = 1;
+	desc.SampleDesc.Quality     = 0;
+	desc.NodeMask               = 0;
+	desc.CachedPSO              = {};
+	desc.Flags                  = D3D12_PIPELINE_STATE_FLAG_NONE;
+}
+
+//-----------------------------------------------------------------------------
+//      デバイスを使わずにパイプラインステートのハッシュ値とキーを検証します.
+//-----------------------------------------------------------------------------
+void TestHash()
+{
+	// 内容が同じでアドレスが異なるバイトコードとセマンティクス名を用意する.
+	uint8_t shaderCopy[sizeof(Shader)];
+	memcpy(shaderCopy, Shader, sizeof(Shader));
+
+	char position[] = "POSITION";
+	char texcoord[] = "TEXCOORD";
+	const D3D12_INPUT_ELEMENT_DESC elements[] = {
+		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0,  0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+	};
+	const D3D12_INPUT_ELEMENT_DESC elementsCopy[] = {
+		{ position, 0, DXGI_FORMAT_R32G32B32_FLOAT, 0,  0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ texcoord, 0, DXGI_FORMAT_R32G32_FLOAT,    0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+	};
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC base;
+	MakeDesc(base, Shader, elements, 0);
+	const auto baseHash = PipelineCache::HashDesc(base, 1);
+
+	// 同じ構成はアドレスや未使用領域が異なっても同じハッシュ値になること.
+	{
+		D3D12_GRAPHICS_PIPELINE_STATE_DESC desc;
+		MakeDesc(desc, shaderCopy, elementsCopy, 0xcd);
+		CHECK(PipelineCache::HashDesc(desc, 1) == baseHash);
+		CHECK(PipelineCache::HashDesc(desc, 1) == PipelineCache::HashDesc(desc, 1));
+	}
+
+	// 構成が1つでも異なれば, 互いに異なるハッシュ値になること.
+	uint8_t shaderEdit[sizeof(Shader)];
+	memcpy(shaderEdit, Shader, sizeof(Shader));
+	shaderEdit[sizeof(Shader) - 1] ^= 0x01;
+
+	char normal[] = "NORMAL";
+	D3D12_INPUT_ELEMENT_DESC elementsEdit[2];
+	memcpy(elementsEdit, elements, sizeof(elements));
+	elementsEdit[1].SemanticName = normal;
+
+	std::vector<std::function<void(D3D12_GRAPHICS_PIPELINE_STATE_DESC&)>> edits = {
+		[&](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.VS.pShaderBytecode = shaderEdit; },
+		[&](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.PS.pShaderBytecode = shaderEdit; },
+		[](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.PS.BytecodeLength--; },
+		[](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.PS = {}; },
+		[](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.RTVFormats[0] = DXGI_FORMAT_R16G16B16A16_FLOAT; },
+		[](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.NumRenderTargets = 2; d.RTVFormats[1] = DXGI_FORMAT_R10G10B10A2_UNORM; },
+		[](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.DSVFormat = DXGI_FORMAT_UNKNOWN; },
+		[](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.BlendState = MakeBlend(true); },
+		[](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_RED; },
+		[](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.RasterizerState = MakeRasterizer(D3D12_CULL_MODE_NONE); },
+		[](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.RasterizerState.DepthBias = 100; },
+		[](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.DepthStencilState = MakeDepth(false); },
+		[](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_GREATER; },
+		[&](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.InputLayout.pInputElementDescs = elementsEdit; },
+		[](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.InputLayout.NumElements = 1; },
+		[](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_LINE; },
+		[](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.SampleDesc.Count = 4; },
+		[](D3D12_GRAPHICS_PIPELINE_STATE_DESC& d) { d.SampleMask = 0x1; },
+	};
+
+	std::vector<uint64_t> hashes = { baseHash, PipelineCache::HashDesc(base, 2) };
+	for (const auto& edit : edits)
+	{
+		D3D12_GRAPHICS_PIPELINE_STATE_DESC desc;
+		MakeDesc(desc, Shader, elements, 0);
+		edit(desc);
+		hashes.push_back(PipelineCache::HashDesc(desc, 1));
+	}
+	for (size_t i = 0; i < hashes.size(); i++)
+	{
+		for (size_t j = i + 1; j < hashes.size(); j++)
+		{ CHECK(hashes[i] != hashes[j]); }
+	}
+
+	// メモリ上のキーは生成時のルートシグニチャを区別し, ファイル上の名前は区別しないこと.
+	auto pRootA = reinterpret_cast<ID3D12RootSignature*>(uintptr_t(0x1000));
+	auto pRootB = reinterpret_cast<ID3D12RootSignature*>(uintptr_t(0x2000));
+	CHECK(PipelineCache::MakeKey(baseHash, pRootA) == PipelineCache::MakeKey(baseHash, pRootA));
+	CHECK(PipelineCache::MakeKey(baseHash, pRootA) != PipelineCache::MakeKey(baseHash, pRootB));
+	CHECK(PipelineCache::MakeKey(baseHash, pRootA) != PipelineCache::MakeKey(hashes[1], pRootA));
+
+	wchar_t nameA[PipelineCache::NameLength];
+	wchar_t nameB[PipelineCache::NameLength];
+	PipelineCache::MakeName(baseHash, nameA);
+	PipelineCache::MakeName(hashes[1], nameB);
+	CHECK(wcslen(nameA) == PipelineCache::NameLength - 1);
+	CHECK(wcsncmp(nameA, L"PSO_", 4) == 0);
+	CHECK(wcscmp(nameA, nameB) != 0);
+}
+
+//-----------------------------------------------------------------------------
+//      ライブラリファイルの読み書きを検証します.
+//-----------------------------------------------------------------------------
+void TestFile()
+{
+	// 保存したファイルは読み戻せて, 壊れたファイルや古いバージョンは破棄すること.
+	std::vector<uint8_t> blob(1000);
+	for (size_t i = 0; i < blob.size(); i++)
+	{ blob[i] = uint8_t(i * 31); }
+
+	std::vector<uint8_t> file;
+	size_t offset = 0;
+	size_t size   = 0;
+	PipelineCache::BuildFile(blob.data(), blob.size(), file);
+	CHECK(PipelineCache::ParseFile(file, offset, size));
+	CHECK(size == blob.size() && memcmp(&file[offset], blob.data(), size) == 0);
+
+	auto broken = file;
+	broken.pop_back();
+	CHECK(!PipelineCache::ParseFile(broken, offset, size));
+
+	broken = file;
+	broken[0] ^= 0xff;
+	CHECK(!PipelineCache::ParseFile(broken, offset, size));
+
+	broken = file;
+	broken[4]++;
+	CHECK(!PipelineCache::ParseFile(broken, offset, size));
+
+	PipelineCache::BuildFile(nullptr, 0, broken);
+	CHECK(!PipelineCache::ParseFile(broken, offset, size));
+	CHECK(!PipelineCache::ParseFile(std::vector<uint8_t>(), offset, size));
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main()
+{
+	TestHash();
+	TestFile();
+	return TestReport("PipelineCache");
+}
@@ -0,0 +1,261 @@
+﻿//-----------------------------------------------------------------------------
+// File : ProfilerTest.cpp
+// Desc : Hierarchical CPU Profiler Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <Profiler.h>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      入れ子のスコープが親子になり, 子は親の時間内に収まることを検証します.
+//-----------------------------------------------------------------------------
+void TestHierarchy()
+{
+	Profiler profiler;
+	profiler.BeginFrame();
+	{
+		ProfileScope outer(profiler, "Outer");
+		{ ProfileScope inner(profiler, "Inner"); }
+		{ ProfileScope inner(profiler, "Inner2"); }
+	}
+	profiler.EndFrame();
+
+	const auto& nodes = profiler.GetNodes();
+	CHECK(nodes.size() == 3);
+	if (nodes.size() == 3)
+	{
+		CHECK(strcmp(nodes[0].Name, "Outer") == 0 && nodes[0].Parent == Profiler::InvalidIndex && nodes[0].Depth == 0);
+		CHECK(strcmp(nodes[1].Name, "Inner") == 0 && nodes[1].Parent == 0 && nodes[1].Depth == 1);
+		CHECK(strcmp(nodes[2].Name, "Inner2") == 0 && nodes[2].Parent == 0 && nodes[2].Depth == 1);
+		CHECK(nodes[1].StartMs >= nodes[0].StartMs && nodes[2].StartMs + nodes[2].DurationMs <= nodes[0].StartMs + nodes[0].DurationMs);
+		CHECK(nodes[1].Path != nodes[2].Path && nodes[0].StartMs >= 0.0 && profiler.GetFrameMs() >= nodes[0].DurationMs);
+	}
+
+	// 無効にしたフレームは何も記録しないこと.
+	profiler.SetEnable(false);
+	profiler.BeginFrame();
+	{ ProfileScope scope(profiler, "Disabled"); }
+	profiler.EndFrame();
+	CHECK(profiler.GetNodes().empty());
+}
+
+//-----------------------------------------------------------------------------
+//      深すぎるスコープは記録せず, 対応は崩れないことを検証します.
+//-----------------------------------------------------------------------------
+void TestMaxDepth()
+{
+	Profiler profiler;
+	std::function<void(uint32_t)> nest = [&](uint32_t depth)
+	{
+		ProfileScope scope(profiler, "Nest");
+		if (depth > 1)
+		{ nest(depth - 1); }
+	};
+	nest(Profiler::MaxDepth + 4);
+	{ ProfileScope scope(profiler, "After"); }
+	profiler.EndFrame();
+
+	const auto& nodes = profiler.GetNodes();
+	CHECK(nodes.size() == Profiler::MaxDepth + 1);
+	CHECK(!nodes.empty() && strcmp(nodes.back().Name, "After") == 0 && nodes.back().Depth == 0);
+}
+
+//-----------------------------------------------------------------------------
+//      スレッドごとのリングバッファから取りこぼしなく集まることを検証します.
+//-----------------------------------------------------------------------------
+void TestThreads()
+{
+	Profiler profiler;
+	const uint32_t threadCount = 4;
+	const uint32_t scopeCount  = 500;
+
+	std::vector<std::thread> threads;
+	for (auto t = 0u; t < threadCount; ++t)
+	{
+		threads.emplace_back([&profiler, scopeCount]()
+		{
+			for (auto i = 0u; i < scopeCount; ++i)
+			{
+				ProfileScope outer(profiler, "Job");
+				ProfileScope inner(profiler, "Work");
+			}
+		});
+	}
+	for (auto& thread : threads)
+	{ thread.join(); }
+	profiler.EndFrame();
+
+	const auto& nodes = profiler.GetNodes();
+	std::vector<uint32_t> perThread;
+	auto nested = true;
+	for (const auto& node : nodes)
+	{
+		if (node.Thread >= perThread.size())
+		{ perThread.resize(node.Thread + 1, 0); }
+		perThread[node.Thread]++;
+		if (node.Depth == 1)
+		{ nested &= (node.Parent != Profiler::InvalidIndex && nodes[node.Parent].Thread == node.Thread); }
+	}
+	CHECK(nodes.size() == threadCount * scopeCount * 2 && profiler.GetDroppedCount() == 0);
+	CHECK(perThread.size() == threadCount && nested);
+	CHECK(std::all_of(perThread.begin(), perThread.end(), [&](uint32_t count) { return count == scopeCount * 2; }));
+}
+
+//-----------------------------------------------------------------------------
+//      集計が追いつかない場合は溢れた分だけ破棄し, 集計後は再び記録できることを検証します.
+//-----------------------------------------------------------------------------
+void TestOverflow()
+{
+	Profiler profiler;
+	for (auto i = 0u; i < Profiler::RingSize + 10; ++i)
+	{ ProfileScope scope(profiler, "Flood"); }
+	profiler.EndFrame();
+	CHECK(profiler.GetNodes().size() == Profiler::RingSize && profiler.GetDroppedCount() == 10);
+
+	{ ProfileScope scope(profiler, "Next"); }
+	profiler.EndFrame();
+	CHECK(profiler.GetNodes().size() == 1);
+}
+
+//-----------------------------------------------------------------------------
+//      パスごとのフレーム合計から移動統計を求めることを検証します.
+//-----------------------------------------------------------------------------
+void TestStats()
+{
+	// GPU は先頭のイベントが基準になること.
+	Profiler profiler;
+	const int64_t ms = 1000000;
+	const int64_t origin = Profiler::GetTicks() - 100 * ms;
+	for (auto frame = 1; frame <= 3; ++frame)
+	{
+		profiler.AddEvent("Pass", Profiler::GpuThread, origin, origin + frame * ms, 0);
+		profiler.AddEvent("Half", Profiler::GpuThread, origin + 5 * ms, origin + 5 * ms + ms / 2, 0);
+		profiler.AddEvent("Half", Profiler::GpuThread, origin + 6 * ms, origin + 6 * ms + ms / 2, 0);
+		profiler.EndFrame();
+	}
+
+	const auto& nodes = profiler.GetNodes();
+	CHECK(nodes.size() == 3);
+	if (nodes.size() == 3)
+	{
+		CHECK(strcmp(nodes[0].Name, "Pass") == 0 && nodes[0].StartMs == 0.0 && fabs(nodes[0].DurationMs - 3.0) < 1e-6);
+		CHECK(fabs(nodes[0].AvgMs - 2.0) < 1e-6 && fabs(nodes[0].MinMs - 1.0) < 1e-6 && fabs(nodes[0].MaxMs - 3.0) < 1e-6);
+		CHECK(nodes[1].Path == nodes[2].Path && fabs(nodes[1].AvgMs - 1.0) < 1e-6 && fabs(nodes[2].StartMs - 6.0) < 1e-6);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      取り込んだフレームを Chrome Trace Event 形式で出力することを検証します.
+//-----------------------------------------------------------------------------
+void TestChromeTrace()
+{
+	Profiler profiler;
+	profiler.SetThreadName("Main \"Thread\"");
+	profiler.Capture(2);
+	for (auto frame = 0; frame < 3; ++frame)
+	{
+		profiler.BeginFrame();
+		{
+			ProfileScope outer(profiler, "Frame");
+			ProfileScope inner(profiler, "Quote\"Back\\slash");
+		}
+		profiler.EndFrame();
+	}
+	CHECK(!profiler.IsCapturing() && profiler.GetCapturedFrames() == 2);
+
+	std::string json;
+	profiler.ExportChromeTrace(json);
+
+	auto count = [&json](const char* text)
+	{
+		size_t found = 0;
+		for (auto pos = json.find(text); pos != std::string::npos; pos = json.find(text, pos + 1))
+		{ found++; }
+		return found;
+	};
+	CHECK(json.compare(0, 15, "{\"traceEvents\":") == 0 && json.back() == '}');
+	CHECK(count("\"ph\":\"X\"") == 4 && count("\"ph\":\"M\"") == 1);
+	CHECK(count("\"name\":\"Quote\\\"Back\\\\slash\"") == 2 && count("Main \\\"Thread\\\"") == 1);
+
+	// 文字列の外の括弧が対応していること.
+	auto depth    = 0;
+	auto balanced = true;
+	auto inString = false;
+	for (size_t i = 0; i < json.size(); ++i)
+	{
+		auto c = json[i];
+		if (inString)
+		{
+			if (c == '\\')
+			{ i++; }
+			else if (c == '"')
+			{ inString = false; }
+			continue;
+		}
+		if (c == '"')
+		{ inString = true; }
+		else if (c == '{' || c == '[')
+		{ depth++; }
+		else if (c == '}' || c == ']')
+		{ balanced &= (--depth >= 0); }
+	}
+	CHECK(balanced && depth == 0 && !inString);
+}
+
+//-----------------------------------------------------------------------------
+//      スコープ1つあたりの記録と集計の時間を計測します.
+//-----------------------------------------------------------------------------
+void BenchmarkScope()
+{
+	Profiler profiler;
+	const uint32_t frames = 100;
+	const uint32_t scopes = Profiler::RingSize / 2;
+
+	double record  = 0.0;
+	double collect = 0.0;
+	for (auto frame = 0u; frame < frames; ++frame)
+	{
+		profiler.BeginFrame();
+		record += MeasureMilliSec([&]()
+		{
+			for (auto i = 0u; i < scopes; ++i)
+			{ ProfileScope scope(profiler, "Scope"); }
+		});
+		collect += MeasureMilliSec([&]() { profiler.EndFrame(); });
+	}
+
+	const auto count = double(frames) * scopes;
+	printf("Scope : %.1f ns record / %.1f ns collect (%u scopes x %u frames)\n",
+		record * 1e6 / count, collect * 1e6 / count, scopes, frames);
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	TestHierarchy();
+	TestMaxDepth();
+	TestThreads();
+	TestOverflow();
+	TestStats();
+	TestChromeTrace();
+
+	if (IsBenchmark(argc, argv))
+	{ BenchmarkScope(); }
+
+	return TestReport("Profiler");
+}
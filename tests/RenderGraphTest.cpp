@@ -0,0 +1,159 @@
+﻿//-----------------------------------------------------------------------------
+// File : RenderGraphTest.cpp
+// Desc : Render Graph Compile Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <SampleGraph.h>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      デバイスを使わずにサンプルのレンダーグラフのコンパイル結果を検証します.
+//-----------------------------------------------------------------------------
+void TestCompile(uint32_t rounds)
+{
+	// 初期化しない場合はサイズを推定する.
+	RenderGraphResources headless;
+
+	std::mt19937 rng(2024);
+	std::uniform_int_distribution<uint32_t> extent(64, 4096);
+
+	for (uint32_t round = 0; round < rounds; round++)
+	{
+		const bool keep  = (round % 2) == 1;
+		const bool cache = (round % 4) < 2;
+		uint32_t passes[GRAPH_PASS_COUNT];
+		uint32_t res[GRAPH_RES_COUNT];
+
+		RenderGraph graph;
+		DeclareSampleGraph(graph, headless, extent(rng), extent(rng), keep, cache, passes, res);
+
+		CHECK(graph.Compile(false));
+		const auto separate = graph.GetReport();
+		CHECK(graph.Compile(true));
+		const auto report = graph.GetReport();
+
+		// 事前描画の結果は出力なので, 確認用の表示に関係なくどのパスも削除されないこと.
+		CHECK(report.CulledCount == 0);
+		CHECK(!graph.IsCulled(passes[GRAPH_PASS_PRE_NORMAL]));
+		CHECK(graph.IsUsed(res[GRAPH_RES_NORMAL]));
+		CHECK(graph.IsUsed(res[GRAPH_RES_PRE_DEPTH]));
+
+		// キャッシュを使わない場合はキャッシュのパスとリソースを登録しないこと.
+		CHECK((passes[GRAPH_PASS_SHADOW_COPY] != RenderGraph::InvalidIndex) == cache);
+		CHECK((res[GRAPH_RES_SHADOW_STATIC]   != RenderGraph::InvalidIndex) == cache);
+		CHECK(graph.IsCulled(passes[GRAPH_PASS_SHADOW_CACHE]) != cache);
+
+		// 共有したメモリは個別に確保するより小さいこと.
+		CHECK(separate.HeapBytes == report.TransientBytes);
+		CHECK(report.HeapBytes <= separate.HeapBytes);
+		CHECK(report.TransitionCount < report.ManualCount);
+		if (keep)
+		{
+			CHECK(report.AliasedCount == 0);
+		}
+		else
+		{
+			CHECK(report.HeapBytes < report.TransientBytes);
+		}
+
+		// 同時に使用する一時リソースがメモリを共有しないこと.
+		const auto count = graph.GetResourceCount();
+		for (auto a = 0u; a < count; a++)
+		{
+			for (auto b = a + 1; b < count; b++)
+			{
+				uint32_t firstA, lastA, firstB, lastB;
+				if (!graph.IsUsed(a) || !graph.IsUsed(b))
+				{ continue; }
+				graph.GetLifetime(a, firstA, lastA);
+				graph.GetLifetime(b, firstB, lastB);
+
+				auto beginA = graph.GetHeapOffset(a), endA = beginA + graph.GetDesc(a).Size;
+				auto beginB = graph.GetHeapOffset(b), endB = beginB + graph.GetDesc(b).Size;
+				auto overlapLife   = !(lastA < firstB || lastB < firstA);
+				auto overlapMemory = (beginA < endB) && (beginB < endA);
+				CHECK(!(overlapLife && overlapMemory));
+			}
+		}
+
+		// 遷移前の状態が追跡した状態と一致し, フレームの最後に開始時の状態に戻ること.
+		std::vector<D3D12_RESOURCE_STATES> start(count), state(count);
+		for (auto i = 0u; i < count; i++)
+		{
+			start[i] = graph.IsTransient(i) ? graph.GetCreateState(i) : D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+		}
+		start[res[GRAPH_RES_BACK_BUFFER]] = D3D12_RESOURCE_STATE_PRESENT;
+		if (cache)
+		{ start[res[GRAPH_RES_SHADOW_STATIC]] = D3D12_RESOURCE_STATE_DEPTH_WRITE; }
+		state = start;
+
+		auto apply = [&](const std::vector<RenderGraph::Barrier>& barriers)
+		{
+			for (const auto& barrier : barriers)
+			{
+				if (barrier.Type != RenderGraph::BARRIER_TRANSITION)
+				{ continue; }
+				CHECK(state[barrier.Resource] == barrier.Before);
+				state[barrier.Resource] = barrier.After;
+			}
+		};
+		for (auto i = 0u; i < graph.GetPassCount(); i++)
+		{
+			if (graph.IsCulled(i))
+			{ continue; }
+			apply(graph.GetBarriers(i));
+
+			if (i == passes[GRAPH_PASS_PRE_NORMAL])
+			{
+				CHECK(state[res[GRAPH_RES_NORMAL]]    == D3D12_RESOURCE_STATE_RENDER_TARGET);
+				CHECK(state[res[GRAPH_RES_PRE_DEPTH]] == D3D12_RESOURCE_STATE_DEPTH_WRITE);
+			}
+			if (cache && i == passes[GRAPH_PASS_SHADOW_COPY])
+			{
+				CHECK(state[res[GRAPH_RES_SHADOW_STATIC]] == D3D12_RESOURCE_STATE_COPY_SOURCE);
+				CHECK(state[res[GRAPH_RES_SHADOW]]        == D3D12_RESOURCE_STATE_COPY_DEST);
+			}
+			if (i == passes[GRAPH_PASS_SHADOW])
+			{
+				CHECK(state[res[GRAPH_RES_SHADOW]] == D3D12_RESOURCE_STATE_DEPTH_WRITE);
+			}
+			if (i == passes[GRAPH_PASS_OPAQUE])
+			{
+				CHECK(state[res[GRAPH_RES_SHADOW]]      == D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+				CHECK(state[res[GRAPH_RES_SCENE_COLOR]] == D3D12_RESOURCE_STATE_RENDER_TARGET);
+			}
+			if (i == passes[GRAPH_PASS_COMPOSITE])
+			{
+				CHECK(state[res[GRAPH_RES_SCENE_COLOR]] == D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+				CHECK(state[res[GRAPH_RES_BLOOM3]]      == D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+			}
+			if (i == passes[GRAPH_PASS_TONEMAP])
+			{
+				CHECK(state[res[GRAPH_RES_BACK_BUFFER]] == D3D12_RESOURCE_STATE_RENDER_TARGET);
+			}
+		}
+		apply(graph.GetFinalBarriers());
+		CHECK(state == start);
+	}
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main()
+{
+	TestCompile(100);
+	return TestReport("RenderGraph");
+}
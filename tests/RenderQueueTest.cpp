@@ -0,0 +1,682 @@
+﻿//-----------------------------------------------------------------------------
+// File : RenderQueueTest.cpp
+// Desc : Render Queue Submission Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <RenderQueue.h>
+#include <FakeCommandList.h>
+#include <ModelShader.h>
+#include <Material.h>
+#include <MaterialInstance.h>
+#include <Mesh.h>
+#include <InstanceBuffer.h>
+#include <TestDevice.h>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const uint32_t MeshCount     = 2;
+const uint32_t MaterialCount = 3;
+const uint32_t DrawCount     = 12;
+const uint32_t RandomCount   = 256;
+const uint32_t PoolSize      = 8;
+
+///////////////////////////////////////////////////////////////////////////////
+// BINDING enum
+///////////////////////////////////////////////////////////////////////////////
+enum BINDING
+{
+	BINDING_TABLE = 0,      //!< テクスチャごとにテーブルを設定します(BasicShader と同じ配置).
+	BINDING_BINDLESS,       //!< ヒープ全体のテーブルと定数バッファを設定します(BindlessShader と同じ配置).
+};
+
+//-----------------------------------------------------------------------------
+//      アドレスを GPU 仮想アドレスの代わりにします.
+//-----------------------------------------------------------------------------
+D3D12_GPU_VIRTUAL_ADDRESS ToAddress(const void* ptr, uint32_t offset = 0)
+{ return D3D12_GPU_VIRTUAL_ADDRESS(reinterpret_cast<uintptr_t>(ptr)) + offset; }
+
+//-----------------------------------------------------------------------------
+//      アドレスをディスクリプタハンドルの代わりにします.
+//-----------------------------------------------------------------------------
+D3D12_GPU_DESCRIPTOR_HANDLE ToHandle(const void* ptr, uint32_t offset = 0)
+{
+	D3D12_GPU_DESCRIPTOR_HANDLE handle;
+	handle.ptr = ToAddress(ptr, offset);
+	return handle;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TestShader class
+///////////////////////////////////////////////////////////////////////////////
+class TestShader : public ModelShader
+{
+public:
+	static const uint32_t PassParams = 1;   //!< パスごとに設定するルート引数の数です.
+	static const uint32_t MeshParams = 1;   //!< ドローごとに設定するメッシュのルート引数の数です.
+
+	explicit TestShader(BINDING binding, bool instancing = false)
+	: m_Binding   (binding)
+	, m_Instancing(instancing)
+	{ /* DO_NOTHING */ }
+
+	// マテリアルごとに設定するルート引数の数です.
+	uint32_t GetMaterialParams() const
+	{ return (m_Binding == BINDING_TABLE) ? 4 : 2; }
+
+	// 記録先は偽のコマンドリストなので, シェーダのアドレスをルートシグニチャ・PSOの代わりにする.
+	void SetPassState(ID3D12GraphicsCommandList* pCmd, int, const CommonBufferManager&, const SkyManager&) override
+	{
+		pCmd->SetGraphicsRootSignature(reinterpret_cast<ID3D12RootSignature*>(this));
+		pCmd->SetPipelineState(reinterpret_cast<ID3D12PipelineState*>(this));
+		pCmd->SetGraphicsRootConstantBufferView(0, ToAddress(this));
+	}
+
+	void SetMaterialState(ID3D12GraphicsCommandList* pCmd, int, Material& mat, int, const MaterialInstance*) override
+	{
+		if (m_Binding == BINDING_TABLE)
+		{
+			for (auto i = 0u; i < 4; ++i)
+			{ pCmd->SetGraphicsRootDescriptorTable(1 + i, ToHandle(&mat, i)); }
+		}
+		else
+		{
+			// ヒープの先頭はマテリアルによらず同じ.
+			pCmd->SetGraphicsRootDescriptorTable(1, ToHandle(this));
+			pCmd->SetGraphicsRootConstantBufferView(2, ToAddress(&mat));
+		}
+	}
+
+	void SetMeshState(ID3D12GraphicsCommandList* pCmd, int, const ConstantBuffer* meshCB) override
+	{ pCmd->SetGraphicsRootConstantBufferView(5, ToAddress(meshCB)); }
+
+	// BasicShader と同じく, インスタンスが無ければ何も設定しない.
+	void SetInstanceState(ID3D12GraphicsCommandList* pCmd, const MaterialInstance* pInstance) override
+	{
+		if (pInstance != nullptr)
+		{ pCmd->SetGraphicsRoot32BitConstant(6, pInstance->GetIndex(), 0); }
+	}
+
+	bool SupportsInstancing() const override
+	{ return m_Instancing; }
+
+	// インスタンス描画用のPSOはシェーダの次のアドレスで表す.
+	void SetPipelineVariant(ID3D12GraphicsCommandList* pCmd, bool instanced) override
+	{ pCmd->SetPipelineState(reinterpret_cast<ID3D12PipelineState*>(reinterpret_cast<uintptr_t>(this) + (instanced ? 1 : 0))); }
+
+	void SetInstanceRange(ID3D12GraphicsCommandList* pCmd, D3D12_GPU_DESCRIPTOR_HANDLE instances, uint32_t offset) override
+	{
+		pCmd->SetGraphicsRootDescriptorTable(7, instances);
+		pCmd->SetGraphicsRoot32BitConstant(8, offset, 0);
+	}
+
+protected:
+	bool CreateRootSig(ComPtr<ID3D12Device>) override
+	{ return true; }
+
+	bool CreatePipeLineState(ComPtr<ID3D12Device>, DXGI_FORMAT, DXGI_FORMAT) override
+	{ return true; }
+
+private:
+	BINDING m_Binding;
+	bool    m_Instancing;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Scene structure
+///////////////////////////////////////////////////////////////////////////////
+struct Scene
+{
+	CommonBufferManager CommonBuffer;
+	SkyManager          Sky;
+	Mesh                Meshes   [MeshCount];
+	Material            Materials[MaterialCount];
+	ConstantBuffer      MeshCB   [DrawCount];
+
+	// 全てのマテリアルを同じシェーダで描画する.
+	explicit Scene(ModelShader* pShader)
+	{
+		for (auto& material : Materials)
+		{ material.SetShaderPtr(pShader); }
+	}
+
+	// メッシュとマテリアルを交互に並べて追加する.
+	void Push(RenderQueue& queue)
+	{
+		DirectX::XMFLOAT4X4 world;
+		DirectX::XMStoreFloat4x4(&world, DirectX::XMMatrixIdentity());
+
+		queue.Begin(0.0f, 100.0f);
+		for (auto i = 0u; i < DrawCount; ++i)
+		{
+			queue.Push(RenderQueue::PASS_OPAQUE, &Meshes[i % MeshCount], &Materials[i % MaterialCount], nullptr, &MeshCB[i], world, float(i));
+		}
+		queue.Sort();
+	}
+};
+
+//-----------------------------------------------------------------------------
+//      バインド方式ごとのルート引数の設定回数を検証します.
+//-----------------------------------------------------------------------------
+void TestRootParameters(BINDING binding)
+{
+	TestShader  shader(binding);
+	Scene       scene(&shader);
+	RenderQueue queue;
+	scene.Push(queue);
+	CHECK(queue.GetCount() == DrawCount);
+
+	// ModelShader::SetShader() と同じく, ドローごとに全て設定し直す.
+	FakeCommandList perDraw;
+	for (size_t i = 0; i < queue.GetCount(); ++i)
+	{
+		const auto& item = queue.GetItem(i);
+		shader.SetShader(&perDraw, 0, *item.pMaterial, 0, item.pInstance, item.pMeshCB, scene.CommonBuffer, scene.Sky);
+		item.pMesh->Draw(&perDraw);
+	}
+
+	// RenderQueue::Submit() は変化した時だけ設定する.
+	FakeCommandList sorted;
+	queue.Submit(&sorted, 0, scene.CommonBuffer, scene.Sky);
+
+	const auto& stats     = queue.GetStats();
+	const auto  matParams = shader.GetMaterialParams();
+	const auto  perParams = TestShader::PassParams + matParams + TestShader::MeshParams;
+
+	CHECK(perDraw.GetCounters().RootParameterSets == DrawCount * perParams);
+	CHECK(perDraw.GetCounters().DrawCalls         == DrawCount);
+
+	// インスタンスを使わないのでインスタンス番号は一度も設定しない.
+	CHECK(stats.PipelineChanges   == 1);
+	CHECK(stats.MaterialChanges   == MaterialCount);
+	CHECK(stats.MeshBufferChanges == DrawCount);
+	CHECK(stats.InstanceChanges   == 0);
+	CHECK(stats.DrawCalls         == DrawCount);
+
+	const auto& counters = sorted.GetCounters();
+	CHECK(counters.RootSignatureSets == stats.PipelineChanges);
+	CHECK(counters.DrawCalls         == stats.DrawCalls);
+	CHECK(counters.RootParameterSets == TestShader::PassParams + MaterialCount * matParams + DrawCount * TestShader::MeshParams);
+	CHECK(counters.RootParameterSets <  perDraw.GetCounters().RootParameterSets);
+
+	// バインドレスではマテリアルが変わってもヒープのテーブルは変わらない.
+	CHECK(counters.RedundantSets == ((binding == BINDING_BINDLESS) ? MaterialCount - 1 : 0));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// RandomScene structure
+///////////////////////////////////////////////////////////////////////////////
+struct RandomScene
+{
+	///////////////////////////////////////////////////////////////////////////
+	// Expect structure
+	///////////////////////////////////////////////////////////////////////////
+	struct Expect
+	{
+		uint32_t    Pass;       //!< 描画パスです.
+		uint32_t    Pipeline;   //!< 最初に追加された順のシェーダ番号です.
+		uint32_t    Material;   //!< 最初に追加された順のマテリアル番号です.
+		uint32_t    Mesh;       //!< 最初に追加された順のメッシュ番号です.
+		uint32_t    Depth;      //!< 描画順の深度です(半透明は反転).
+		uint32_t    Index;      //!< 追加した順番です.
+	};
+
+	static const uint32_t ShaderCount = 2;
+
+	CommonBufferManager     CommonBuffer;
+	SkyManager              Sky;
+	TestShader              Shaders[ShaderCount] = { TestShader(BINDING_TABLE), TestShader(BINDING_TABLE) };
+	Mesh                    Meshes   [MeshCount];
+	Material                Materials[MaterialCount * ShaderCount];
+	ConstantBuffer          MeshCB   [RandomCount];
+	std::vector<Expect>     Expected;
+
+	// マテリアルを交互にシェーダへ割り当てる.
+	RandomScene()
+	{
+		for (auto i = 0u; i < MaterialCount * ShaderCount; ++i)
+		{ Materials[i].SetShaderPtr(&Shaders[i % ShaderCount]); }
+	}
+
+	// 両方のパスにランダムに追加し, 期待する描画順を求める.
+	void Push(RenderQueue& queue, uint32_t seed)
+	{
+		DirectX::XMFLOAT4X4 world;
+		DirectX::XMStoreFloat4x4(&world, DirectX::XMMatrixIdentity());
+
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<uint32_t> pass    (0, RenderQueue::PASS_COUNT - 1);
+		std::uniform_int_distribution<uint32_t> material(0, MaterialCount * ShaderCount - 1);
+		std::uniform_int_distribution<uint32_t> mesh    (0, MeshCount - 1);
+		std::uniform_int_distribution<uint32_t> depth   (0, 99);
+
+		// 番号はキューと同じくフレーム内で最初に追加された順に振る.
+		std::vector<const void*> pipelines;
+		std::vector<const void*> materials;
+		std::vector<const void*> meshes;
+		auto rank = [](std::vector<const void*>& seen, const void* ptr)
+		{
+			auto itr = std::find(seen.begin(), seen.end(), ptr);
+			if (itr != seen.end())
+			{ return uint32_t(itr - seen.begin()); }
+			seen.push_back(ptr);
+			return uint32_t(seen.size() - 1);
+		};
+
+		queue.Begin(0.0f, 100.0f);
+		Expected.clear();
+		for (auto i = 0u; i < RandomCount; ++i)
+		{
+			auto p = RenderQueue::PASS(pass(rng));
+			auto t = material(rng);
+			auto m = mesh(rng);
+			auto d = depth(rng);
+			queue.Push(p, &Meshes[m], &Materials[t], nullptr, &MeshCB[i], world, float(d));
+
+			Expect e;
+			e.Pass     = p;
+			e.Pipeline = rank(pipelines, Materials[t].GetShaderPtr());
+			e.Material = rank(materials, &Materials[t]);
+			e.Mesh     = rank(meshes, &Meshes[m]);
+			e.Depth    = (p == RenderQueue::PASS_TRANSPARENT) ? 100 - d : d;
+			e.Index    = i;
+			Expected.push_back(e);
+		}
+
+		std::stable_sort(Expected.begin(), Expected.end(), [](const Expect& a, const Expect& b)
+		{
+			if (a.Pass     != b.Pass)     { return a.Pass     < b.Pass; }
+			if (a.Pipeline != b.Pipeline) { return a.Pipeline < b.Pipeline; }
+			if (a.Material != b.Material) { return a.Material < b.Material; }
+			if (a.Mesh     != b.Mesh)     { return a.Mesh     < b.Mesh; }
+			return a.Depth < b.Depth;
+		});
+	}
+
+	// 期待する描画順で, 指定した項目が切り替わる回数を数える.
+	template<typename Func>
+	uint32_t CountRuns(Func key) const
+	{
+		uint32_t runs = 0;
+		for (size_t i = 0; i < Expected.size(); ++i)
+		{
+			if (i == 0 || key(Expected[i]) != key(Expected[i - 1]))
+			{ runs++; }
+		}
+		return runs;
+	}
+};
+
+//-----------------------------------------------------------------------------
+//      ソートキーのビット配置を検証します.
+//-----------------------------------------------------------------------------
+void TestSortKey()
+{
+	const uint32_t maxPipeline = (1u << RenderQueue::PipelineBits) - 1;
+	const uint32_t maxMaterial = (1u << RenderQueue::MaterialBits) - 1;
+	const uint32_t maxMesh     = (1u << RenderQueue::MeshBits)     - 1;
+	const uint32_t maxDepth    = (1u << RenderQueue::DepthBits)    - 1;
+
+	// 上位の項目は下位の項目が全て最大でも優先される.
+	CHECK(RenderQueue::MakeSortKey(1, 0, 0, 0, 0) > RenderQueue::MakeSortKey(0, maxPipeline, maxMaterial, maxMesh, maxDepth));
+	CHECK(RenderQueue::MakeSortKey(0, 1, 0, 0, 0) > RenderQueue::MakeSortKey(0, 0, maxMaterial, maxMesh, maxDepth));
+	CHECK(RenderQueue::MakeSortKey(0, 0, 1, 0, 0) > RenderQueue::MakeSortKey(0, 0, 0, maxMesh, maxDepth));
+	CHECK(RenderQueue::MakeSortKey(0, 0, 0, 1, 0) > RenderQueue::MakeSortKey(0, 0, 0, 0, maxDepth));
+	CHECK(RenderQueue::MakeSortKey(0, 0, 0, 0, 1) > RenderQueue::MakeSortKey(0, 0, 0, 0, 0));
+
+	// 桁あふれした値は隣の項目に漏れない.
+	CHECK(RenderQueue::MakeSortKey(0, 0, 0, 0, maxDepth + 1) == RenderQueue::MakeSortKey(0, 0, 0, 0, 0));
+	CHECK(RenderQueue::MakeSortKey(0, maxPipeline + 1, 0, 0, 0) == RenderQueue::MakeSortKey(0, 0, 0, 0, 0));
+}
+
+//-----------------------------------------------------------------------------
+//      パス・パイプライン・マテリアル・メッシュ・深度の順に並ぶことを検証します.
+//-----------------------------------------------------------------------------
+void TestSortOrder(uint32_t seed)
+{
+	RandomScene scene;
+	RenderQueue queue;
+	scene.Push(queue, seed);
+	queue.Sort();
+	CHECK(queue.GetCount() == RandomCount);
+
+	// メッシュ用定数バッファはアイテムごとに異なるので, 追加した順番の代わりにする.
+	uint32_t mismatches = 0;
+	for (size_t i = 0; i < queue.GetCount(); ++i)
+	{
+		if (queue.GetItem(i).pMeshCB != &scene.MeshCB[scene.Expected[i].Index])
+		{ mismatches++; }
+	}
+	CHECK(mismatches == 0);
+}
+
+//-----------------------------------------------------------------------------
+//      省いたステート設定が冗長だったことを検証します.
+//-----------------------------------------------------------------------------
+void TestRedundantState(uint32_t seed)
+{
+	RandomScene scene;
+	RenderQueue queue;
+	scene.Push(queue, seed);
+
+	FakeCommandList sorted;
+	queue.Submit(&sorted, 0, scene.CommonBuffer, scene.Sky);
+	const auto& stats = queue.GetStats();
+
+	// 同じ順序で, ドローごとに全てのステートを設定し直して記録する.
+	FakeCommandList naive;
+	for (size_t i = 0; i < queue.GetCount(); ++i)
+	{
+		const auto& item = queue.GetItem(i);
+		item.pMaterial->GetShaderPtr()->SetShader(&naive, 0, *item.pMaterial, 0, item.pInstance, item.pMeshCB, scene.CommonBuffer, scene.Sky);
+		item.pMesh->Draw(&naive);
+	}
+
+	// 各ドローの時点のステートと引数が全て一致すれば, 省いた設定は冗長だったことになる.
+	const auto& sortedDraws = sorted.GetDraws();
+	const auto& naiveDraws  = naive .GetDraws();
+	CHECK(sortedDraws.size() == naiveDraws.size());
+
+	uint32_t mismatches = 0;
+	for (size_t i = 0; i < std::min(sortedDraws.size(), naiveDraws.size()); ++i)
+	{
+		const auto& a = sortedDraws[i];
+		const auto& b = naiveDraws [i];
+		if (a.StateHash     != b.StateHash
+		 || a.Count         != b.Count
+		 || a.InstanceCount != b.InstanceCount
+		 || a.Start         != b.Start
+		 || a.BaseVertex    != b.BaseVertex
+		 || a.StartInstance != b.StartInstance)
+		{ mismatches++; }
+	}
+	CHECK(mismatches == 0);
+
+	// 設定済みの値を設定し直すことは無い.
+	const auto& counters = sorted.GetCounters();
+	CHECK(counters.RedundantSets == 0);
+	CHECK(naive.GetCounters().RedundantSets > 0);
+
+	// パイプラインとマテリアルはパスの中でまとまっているので, 切り替えは種類の数だけになる.
+	auto pipelineRuns = scene.CountRuns([](const RandomScene::Expect& e) { return e.Pass * 1024 + e.Pipeline; });
+	auto materialRuns = scene.CountRuns([](const RandomScene::Expect& e) { return e.Pass * 1024 + e.Material; });
+	CHECK(stats.PipelineChanges   == pipelineRuns);
+	CHECK(stats.MaterialChanges   == materialRuns);
+	CHECK(stats.MeshBufferChanges == RandomCount);
+	CHECK(stats.DrawCalls         == RandomCount);
+	CHECK(pipelineRuns <= RenderQueue::PASS_COUNT * RandomScene::ShaderCount);
+	CHECK(materialRuns <= RenderQueue::PASS_COUNT * MaterialCount * RandomScene::ShaderCount);
+
+	CHECK(counters.RootSignatureSets == stats.PipelineChanges);
+	CHECK(counters.DrawCalls         == stats.DrawCalls);
+	CHECK(counters.RootParameterSets == stats.PipelineChanges * TestShader::PassParams
+	                                  + stats.MaterialChanges * scene.Shaders[0].GetMaterialParams()
+	                                  + stats.MeshBufferChanges * TestShader::MeshParams);
+	CHECK(counters.RootParameterSets < naive.GetCounters().RootParameterSets);
+}
+
+//-----------------------------------------------------------------------------
+//      基数ソートが std::stable_sort と同じ結果になることを検証します.
+//-----------------------------------------------------------------------------
+void TestRadixSort(size_t count, bool print)
+{
+	std::mt19937_64 rng(12345);
+	std::uniform_int_distribution<uint32_t> pipeline(0, 7);
+	std::uniform_int_distribution<uint32_t> material(0, 1023);
+	std::uniform_int_distribution<uint32_t> mesh    (0, 255);
+	std::uniform_int_distribution<uint32_t> depth   (0, (1u << RenderQueue::DepthBits) - 1);
+
+	std::vector<RenderQueue::SortEntry> source(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		source[i].Key   = RenderQueue::MakeSortKey(RenderQueue::PASS_OPAQUE, pipeline(rng), material(rng), mesh(rng), depth(rng));
+		source[i].Index = uint32_t(i);
+	}
+
+	auto entries = source;
+	std::vector<RenderQueue::SortEntry> temp(count);
+	uint32_t passes = 0;
+	auto radixTime = MeasureMilliSec([&]() { passes = RenderQueue::RadixSort(entries.data(), temp.data(), count); });
+
+	auto reference = source;
+	auto stdTime = MeasureMilliSec([&]()
+	{
+		std::stable_sort(reference.begin(), reference.end(),
+			[](const RenderQueue::SortEntry& a, const RenderQueue::SortEntry& b) { return a.Key < b.Key; });
+	});
+
+	// 安定ソート同士なので添字まで一致する.
+	uint32_t mismatches = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (entries[i].Index != reference[i].Index)
+		{ mismatches++; }
+	}
+	CHECK(mismatches == 0);
+
+	// パスは常に同じ値なので, その桁は走査しない.
+	CHECK(passes < 8);
+
+	if (print)
+	{ printf("Sort %zu : radix %.3f ms (%u passes), std::stable_sort %.3f ms\n", count, radixTime, passes, stdTime); }
+}
+
+//-----------------------------------------------------------------------------
+//      全て同じキーの場合は走査せずに元の順序を保つことを検証します.
+//-----------------------------------------------------------------------------
+void TestRadixSortUniform()
+{
+	std::vector<RenderQueue::SortEntry> entries(16);
+	std::vector<RenderQueue::SortEntry> temp(entries.size());
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		entries[i].Key   = 0x0123456789abcdefull;
+		entries[i].Index = uint32_t(i);
+	}
+
+	CHECK(RenderQueue::RadixSort(entries.data(), temp.data(), entries.size()) == 0);
+
+	bool ordered = true;
+	for (size_t i = 0; i < entries.size(); ++i)
+	{ ordered &= (entries[i].Index == i); }
+	CHECK(ordered);
+}
+
+} // namespace
+
+
+///////////////////////////////////////////////////////////////////////////////
+// BatchScene structure
+///////////////////////////////////////////////////////////////////////////////
+struct BatchScene
+{
+	static const uint32_t ShaderCount        = 2;
+	static const uint32_t BatchMeshCount     = 8;
+	static const uint32_t BatchMaterialCount = 6;
+
+	CommonBufferManager         CommonBuffer;
+	SkyManager                  Sky;
+	TestShader                  Shaders[ShaderCount] = { TestShader(BINDING_TABLE, true), TestShader(BINDING_TABLE, true) };
+	Mesh                        Meshes   [BatchMeshCount];
+	Material                    Materials[BatchMaterialCount];
+	std::vector<ConstantBuffer> MeshCB;
+	std::vector<uint32_t>       MeshIndex;
+	std::vector<uint32_t>       MaterialIndex;
+
+	// 同じメッシュ・マテリアルが何度も現れるオブジェクトの一覧を作る.
+	BatchScene(uint32_t count, uint32_t seed)
+	: MeshCB(count)
+	{
+		for (auto i = 0u; i < BatchMaterialCount; ++i)
+		{ Materials[i].SetShaderPtr(&Shaders[i % ShaderCount]); }
+
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<uint32_t> mesh    (0, BatchMeshCount - 1);
+		std::uniform_int_distribution<uint32_t> material(0, BatchMaterialCount - 1);
+		for (auto i = 0u; i < count; ++i)
+		{
+			MeshIndex    .push_back(mesh(rng));
+			MaterialIndex.push_back(material(rng));
+		}
+	}
+
+	// メッシュとマテリアルの組み合わせの数が, まとめた後のドロー数になる.
+	uint32_t GetRunCount() const
+	{
+		std::set<std::pair<uint32_t, uint32_t>> runs;
+		for (size_t i = 0; i < MeshIndex.size(); ++i)
+		{ runs.insert(std::make_pair(MaterialIndex[i], MeshIndex[i])); }
+		return uint32_t(runs.size());
+	}
+
+	// 毎フレームと同じく, 追加からソート・記録までを行う.
+	double Submit(RenderQueue& queue, InstanceBuffer& instances, FakeCommandList& cmd)
+	{
+		DirectX::XMFLOAT4X4 world;
+		DirectX::XMStoreFloat4x4(&world, DirectX::XMMatrixIdentity());
+
+		instances.Begin(0);
+		queue.Begin(0.0f, 100.0f);
+		for (size_t i = 0; i < MeshIndex.size(); ++i)
+		{ queue.Push(RenderQueue::PASS_OPAQUE, &Meshes[MeshIndex[i]], &Materials[MaterialIndex[i]], nullptr, &MeshCB[i], world, float(i % 100)); }
+		queue.Sort();
+
+		return MeasureMilliSec([&]() { queue.Submit(&cmd, 0, CommonBuffer, Sky); });
+	}
+};
+
+//-----------------------------------------------------------------------------
+//      記録したドローのインスタンス数の合計を求めます.
+//-----------------------------------------------------------------------------
+uint32_t CountInstances(const FakeCommandList& cmd)
+{
+	uint32_t result = 0;
+	for (const auto& draw : cmd.GetDraws())
+	{ result += draw.InstanceCount; }
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      同じオブジェクトの一覧をまとめた場合とまとめない場合で描画して比較します.
+//-----------------------------------------------------------------------------
+void TestBatching(ID3D12Device* pDevice, DescriptorPool* pPool, uint32_t count, bool print)
+{
+	BatchScene     scene(count, 7);
+	RenderQueue    queue;
+	InstanceBuffer instances;
+	CHECK(instances.Init(pDevice, pPool, count));
+	queue.SetInstanceBuffer(&instances);
+
+	// まとめない場合はオブジェクトごとに1インスタンスのドローになる.
+	FakeCommandList single;
+	queue.SetBatching(false);
+	auto singleTime  = scene.Submit(queue, instances, single);
+	auto singleStats = queue.GetStats();
+	CHECK(singleStats.DrawCalls           == count);
+	CHECK(single.GetCounters().DrawCalls  == count);
+	CHECK(CountInstances(single)          == count);
+	CHECK(instances.GetUsedCount()        == count);
+
+	// まとめた場合は同じメッシュ・マテリアルの並びが1回のドローになる.
+	FakeCommandList batched;
+	queue.SetBatching(true);
+	auto batchedTime  = scene.Submit(queue, instances, batched);
+	auto batchedStats = queue.GetStats();
+	auto runs         = scene.GetRunCount();
+	CHECK(batchedStats.DrawCalls          == runs);
+	CHECK(batchedStats.InstancedItems     == count);
+	CHECK(batched.GetCounters().DrawCalls == runs);
+	CHECK(CountInstances(batched)         == count);
+	CHECK(instances.GetUsedCount()        == count);
+
+	// パイプラインとマテリアルの切り替えはまとめても変わらない.
+	CHECK(batchedStats.PipelineChanges == singleStats.PipelineChanges);
+	CHECK(batchedStats.MaterialChanges == singleStats.MaterialChanges);
+	CHECK(batched.GetCounters().RootParameterSets < single.GetCounters().RootParameterSets);
+
+	// インスタンスバッファのテーブルはドローごとに同じ値を設定し直している.
+	CHECK(batched.GetCounters().RedundantSets == batchedStats.DrawCalls - batchedStats.PipelineChanges);
+
+	if (print)
+	{
+		printf("Batching %u objects : off %u draws %.3f ms, on %u draws %.3f ms\n",
+			count, singleStats.DrawCalls, singleTime, batchedStats.DrawCalls, batchedTime);
+	}
+
+	instances.Term();
+}
+
+//-----------------------------------------------------------------------------
+//      インスタンスバッファが足りない場合は通常の描画に切り替わることを検証します.
+//-----------------------------------------------------------------------------
+void TestBatchingOverflow(ID3D12Device* pDevice, DescriptorPool* pPool)
+{
+	const uint32_t count = 64;
+
+	BatchScene     scene(count, 7);
+	RenderQueue    queue;
+	InstanceBuffer instances;
+	CHECK(instances.Init(pDevice, pPool, count / 2));
+	queue.SetInstanceBuffer(&instances);
+	queue.SetBatching(true);
+
+	// 割り当てられなかった分もメッシュ定数バッファで描画される.
+	FakeCommandList cmd;
+	scene.Submit(queue, instances, cmd);
+	const auto& stats = queue.GetStats();
+	CHECK(stats.InstancedItems <= count / 2);
+	CHECK(stats.MeshBufferChanges == count - stats.InstancedItems);
+	CHECK(CountInstances(cmd) == count);
+
+	instances.Term();
+}
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	TestRootParameters(BINDING_TABLE);
+	TestRootParameters(BINDING_BINDLESS);
+	TestSortKey();
+	TestSortOrder(1);
+	TestSortOrder(2);
+	TestRedundantState(1);
+	TestRedundantState(2);
+	TestRadixSort(10000, false);
+	TestRadixSortUniform();
+
+	ComPtr<ID3D12Device> pDevice;
+	DescriptorPool*      pPool = nullptr;
+	CHECK(CreateTestDevice(pDevice.GetAddressOf()));
+	CHECK(pDevice != nullptr && CreateTestPool(pDevice.Get(), PoolSize, &pPool));
+
+	if (pPool != nullptr)
+	{
+		TestBatching(pDevice.Get(), pPool, 1000, false);
+		TestBatchingOverflow(pDevice.Get(), pPool);
+	}
+
+	if (IsBenchmark(argc, argv))
+	{
+		TestRadixSort(100000, true);
+		if (pPool != nullptr)
+		{ TestBatching(pDevice.Get(), pPool, 10000, true); }
+	}
+
+	if (pPool != nullptr)
+	{ pPool->Release(); }
+	return TestReport("RenderQueue");
+}
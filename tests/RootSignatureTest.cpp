@@ -0,0 +1,243 @@
+﻿//-----------------------------------------------------------------------------
+// File : RootSignatureTest.cpp
+// Desc : Root Signature Serialization And Layout Analysis Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <TestDevice.h>
+#include <RootSignature.h>
+#include <PipelineCache.h>
+#include <climits>
+#include <vector>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+//      シリアライズ結果をバイト列として取得します.
+//-----------------------------------------------------------------------------
+bool Serialize(const D3D12_ROOT_SIGNATURE_DESC* pDesc, std::vector<uint8_t>& bytes)
+{
+	ComPtr<ID3DBlob> pBlob;
+	bytes.clear();
+	if (!RootSignature::Serialize(pDesc, pBlob))
+	{ return false; }
+
+	auto ptr = static_cast<const uint8_t*>(pBlob->GetBufferPointer());
+	bytes.assign(ptr, ptr + pBlob->GetBufferSize());
+	return !bytes.empty();
+}
+
+//-----------------------------------------------------------------------------
+//      基準となる記述子を設定します.
+//-----------------------------------------------------------------------------
+void SetupBase(RootSignature::Desc& desc)
+{
+	desc.Begin(4)
+		.SetRootCBV(ShaderStage::VS, 0, 0)
+		.SetConstants(ShaderStage::ALL, 1, 1, 2)
+		.AddRange(ShaderStage::PS, 2, D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 0, 3)
+		.AddRange(ShaderStage::PS, 2, D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 2, 1)
+		.SetSRV(ShaderStage::PS, 3, 9)
+		.AddStaticSmp(ShaderStage::PS, 0, SamplerState::LinearWrap)
+		.AddStaticSmp(ShaderStage::PS, 9, SamplerState::LinearClamp)
+		.AllowIL()
+		.End();
+}
+
+//-----------------------------------------------------------------------------
+//      基準と設定順序だけが異なる記述子を設定します.
+//-----------------------------------------------------------------------------
+void SetupShuffled(RootSignature::Desc& desc)
+{
+	desc.Begin(4)
+		.AddStaticSmp(ShaderStage::PS, 9, SamplerState::LinearClamp)
+		.SetSRV(ShaderStage::PS, 3, 9)
+		.AddRange(ShaderStage::PS, 2, D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 0, 3)
+		.AddRange(ShaderStage::PS, 2, D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 2, 1)
+		.SetConstants(ShaderStage::ALL, 1, 1, 2)
+		.AddStaticSmp(ShaderStage::PS, 0, SamplerState::LinearWrap)
+		.SetRootCBV(ShaderStage::VS, 0, 0)
+		.AllowIL()
+		.End();
+}
+
+//-----------------------------------------------------------------------------
+//      基準とルートディスクリプタだけが異なる記述子を設定します.
+//-----------------------------------------------------------------------------
+void SetupDifferent(RootSignature::Desc& desc)
+{
+	desc.Begin(4)
+		.SetCBV(ShaderStage::VS, 0, 0)
+		.SetConstants(ShaderStage::ALL, 1, 1, 2)
+		.AddRange(ShaderStage::PS, 2, D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 0, 3)
+		.AddRange(ShaderStage::PS, 2, D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 2, 1)
+		.SetSRV(ShaderStage::PS, 3, 9)
+		.AddStaticSmp(ShaderStage::PS, 0, SamplerState::LinearWrap)
+		.AddStaticSmp(ShaderStage::PS, 9, SamplerState::LinearClamp)
+		.AllowIL()
+		.End();
+}
+
+//-----------------------------------------------------------------------------
+//      設定順序に依存しないシリアライズ結果を検証します.
+//-----------------------------------------------------------------------------
+void TestDeterministic()
+{
+	RootSignature::Desc a, b, c;
+	SetupBase(a);
+	SetupShuffled(b);
+	SetupDifferent(c);
+
+	std::vector<uint8_t> bytesA, bytesB, bytesC;
+	CHECK(Serialize(a.GetDesc(), bytesA));
+	CHECK(Serialize(b.GetDesc(), bytesB));
+	CHECK(Serialize(c.GetDesc(), bytesC));
+
+	// 設定する順序だけが異なれば同じ, 構成が異なれば異なる結果になること.
+	CHECK(bytesA == bytesB);
+	CHECK(bytesA != bytesC);
+
+	// 使い回した記述子は前回の設定を引き継がないこと.
+	RootSignature::Desc reused;
+	reused.Begin(6)
+		.SetCBV(ShaderStage::ALL, 5, 7)
+		.SetSRVRange(ShaderStage::PS, 2, 0, UINT_MAX, 1)
+		.AddStaticSmp(ShaderStage::VS, 3, SamplerState::PointClamp)
+		.End();
+	SetupBase(reused);
+
+	std::vector<uint8_t> bytesReused;
+	CHECK(Serialize(reused.GetDesc(), bytesReused));
+	CHECK(bytesReused == bytesA);
+}
+
+//-----------------------------------------------------------------------------
+//      複数レンジのテーブルがオフセットを明示した記述子と一致することを検証します.
+//-----------------------------------------------------------------------------
+void TestTableOffsets()
+{
+	RootSignature::Desc table;
+	table.Begin(1)
+		.AddRange(ShaderStage::PS, 0, D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 0, 3)
+		.AddRange(ShaderStage::PS, 0, D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 2, 1)
+		.End();
+
+	D3D12_DESCRIPTOR_RANGE ranges[2] = {};
+	ranges[0].RangeType                         = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+	ranges[0].NumDescriptors                    = 3;
+	ranges[0].BaseShaderRegister                = 0;
+	ranges[0].OffsetInDescriptorsFromTableStart = 0;
+	ranges[1].RangeType                         = D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
+	ranges[1].NumDescriptors                    = 1;
+	ranges[1].BaseShaderRegister                = 2;
+	ranges[1].OffsetInDescriptorsFromTableStart = 3;
+
+	D3D12_ROOT_PARAMETER param = {};
+	param.ParameterType                       = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+	param.DescriptorTable.NumDescriptorRanges = 2;
+	param.DescriptorTable.pDescriptorRanges   = ranges;
+	param.ShaderVisibility                    = D3D12_SHADER_VISIBILITY_PIXEL;
+
+	D3D12_ROOT_SIGNATURE_DESC manual = {};
+	manual.NumParameters = 1;
+	manual.pParameters   = &param;
+	manual.Flags         = D3D12_ROOT_SIGNATURE_FLAG_DENY_VERTEX_SHADER_ROOT_ACCESS
+	                     | D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS
+	                     | D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS
+	                     | D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS;
+
+	std::vector<uint8_t> bytesTable, bytesManual;
+	CHECK(Serialize(table.GetDesc(), bytesTable));
+	CHECK(Serialize(&manual, bytesManual));
+	CHECK(bytesTable == bytesManual);
+}
+
+//-----------------------------------------------------------------------------
+//      レイアウトの解析結果を検証します.
+//-----------------------------------------------------------------------------
+void TestAnalyze()
+{
+	// 定数バッファを全てテーブルで参照していた頃のモデル用レイアウト.
+	RootSignature::Desc legacy;
+	legacy.Begin(17)
+		.SetCBV(ShaderStage::ALL, 2, 3)
+		.SetCBV(ShaderStage::VS, 0, 0)
+		.SetCBV(ShaderStage::VS, 1, 1)
+		.SetCBV(ShaderStage::PS, 3, 2)
+		.SetCBV(ShaderStage::PS, 4, 4)
+		.SetSRV(ShaderStage::PS, 5, 0)
+		.SetSRV(ShaderStage::PS, 6, 1)
+		.SetSRV(ShaderStage::PS, 7, 2)
+		.SetSRV(ShaderStage::PS, 8, 3)
+		.SetSRV(ShaderStage::PS, 9, 4)
+		.SetSRV(ShaderStage::PS, 10, 5)
+		.SetSRV(ShaderStage::PS, 11, 6)
+		.SetSRV(ShaderStage::PS, 12, 9)
+		.SetSRV(ShaderStage::PS, 13, 10)
+		.SetConstants(ShaderStage::ALL, 14, 5, 1)
+		.SetSRV(ShaderStage::VS, 15, 11)
+		.SetConstants(ShaderStage::VS, 16, 6, 1)
+		.AllowIL()
+		.End();
+
+	auto legacyLayout = RootSignature::Analyze(legacy.GetDesc());
+	CHECK(legacyLayout.DWords == 17);
+	CHECK(legacyLayout.Tables == 15 && legacyLayout.SingleTables == 15 && legacyLayout.CBVTables == 5);
+	CHECK(legacyLayout.Constants == 2 && legacyLayout.RootDescriptors == 0);
+	CHECK(legacyLayout.SuggestedDWords == 17 + 5 - 8);
+	CHECK(legacyLayout.Suggestions.size() == 6);
+
+	RootSignature::Desc base;
+	SetupBase(base);
+
+	auto layout = RootSignature::Analyze(base.GetDesc());
+	CHECK(layout.DWords == 2 + 2 + 1 + 1);
+	CHECK(layout.RootDescriptors == 1 && layout.Tables == 2 && layout.SingleTables == 1 && layout.CBVTables == 1);
+	CHECK(layout.StaticSamplers == 2);
+}
+
+//-----------------------------------------------------------------------------
+//      同じシリアライズ結果のルートシグニチャを共有することを検証します.
+//-----------------------------------------------------------------------------
+void TestShare(ID3D12Device* pDevice)
+{
+	RootSignature::Desc a, b, c;
+	SetupBase(a);
+	SetupShuffled(b);
+	SetupDifferent(c);
+
+	RootSignature rootA, rootB, rootC;
+	CHECK(rootA.Init(pDevice, a.GetDesc()));
+	CHECK(rootB.Init(pDevice, b.GetDesc()));
+	CHECK(rootC.Init(pDevice, c.GetDesc()));
+	CHECK(rootA.GetPtr() != nullptr && rootA.GetPtr() == rootB.GetPtr());
+	CHECK(rootA.GetPtr() != rootC.GetPtr());
+	CHECK(rootA.GetLayout().RootDescriptors == 1);
+	CHECK(rootC.GetLayout().RootDescriptors == 0);
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main()
+{
+	TestDeterministic();
+	TestTableOffsets();
+	TestAnalyze();
+
+	ComPtr<ID3D12Device> pDevice;
+	CHECK(CreateTestDevice(pDevice.GetAddressOf()));
+	if (pDevice != nullptr)
+	{ TestShare(pDevice.Get()); }
+
+	PipelineCache::GetInstance().Term();
+	return TestReport("RootSignature");
+}
@@ -0,0 +1,314 @@
+﻿//-----------------------------------------------------------------------------
+// File : SHProjectorTest.cpp
+// Desc : Spherical Harmonics Irradiance Projection Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <SHProjector.h>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <vector>
+#include <cmath>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Type Definitions.
+//-----------------------------------------------------------------------------
+using EnvFunc = std::function<void(const float dir[3], float rgb[3])>;
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const float     Pi         = 3.14159265358979f;
+const uint32_t  Width      = 130;   // 4の倍数でない幅で端数の処理も確認します.
+const uint32_t  Height     = 65;
+const uint32_t  CubeSize   = 37;
+
+//-----------------------------------------------------------------------------
+//      一定の環境です.
+//-----------------------------------------------------------------------------
+void ConstantEnv(const float*, float rgb[3])
+{
+	rgb[0] = 0.5f;
+	rgb[1] = 1.0f;
+	rgb[2] = 2.0f;
+}
+
+//-----------------------------------------------------------------------------
+//      方向について1次の環境です.
+//-----------------------------------------------------------------------------
+void LinearEnv(const float dir[3], float rgb[3])
+{
+	auto v = 1.0f + 0.5f * dir[1] + 0.25f * dir[0] - 0.125f * dir[2];
+	rgb[0] = v;
+	rgb[1] = 2.0f * v;
+	rgb[2] = 0.5f * v;
+}
+
+//-----------------------------------------------------------------------------
+//      太陽を含む空の環境です. 3次までで表せない高周波を含みます.
+//-----------------------------------------------------------------------------
+void SkyEnv(const float dir[3], float rgb[3])
+{
+	const float sun[3] = { 0.48f, 0.64f, 0.6f };
+	auto up   = std::max(0.0f, dir[1]);
+	auto cosS = dir[0] * sun[0] + dir[1] * sun[1] + dir[2] * sun[2];
+	auto disk = 20.0f * expf(16.0f * (cosS - 1.0f));
+	rgb[0] = 0.2f + 1.0f * up * up + disk;
+	rgb[1] = 0.2f + 1.5f * up * up + disk;
+	rgb[2] = 0.3f + 2.5f * up * up + disk;
+}
+
+//-----------------------------------------------------------------------------
+//      正距円筒図法の環境マップを生成します.
+//-----------------------------------------------------------------------------
+std::vector<float> MakeEquirect(uint32_t width, uint32_t height, const EnvFunc& func)
+{
+	std::vector<float> pixels(size_t(width) * height * 4, 1.0f);
+	for (auto y = 0u; y < height; ++y)
+	{
+		auto theta = Pi * (y + 0.5f) / height;
+		for (auto x = 0u; x < width; ++x)
+		{
+			auto phi = 2.0f * Pi * (x + 0.5f) / width;
+			float dir[3] = { sinf(phi) * sinf(theta), cosf(theta), cosf(phi) * sinf(theta) };
+			func(dir, &pixels[(size_t(y) * width + x) * 4]);
+		}
+	}
+	return pixels;
+}
+
+//-----------------------------------------------------------------------------
+//      キューブマップを生成します.
+//-----------------------------------------------------------------------------
+std::vector<float> MakeCube(uint32_t size, const EnvFunc& func)
+{
+	// +X, -X, +Y, -Y, +Z, -Z の順の D3D のキューブマップの向きです.
+	const float faces[6][3][3] = {
+		{ {  1,  0,  0 }, {  0,  0, -1 }, { 0, -1,  0 } },
+		{ { -1,  0,  0 }, {  0,  0,  1 }, { 0, -1,  0 } },
+		{ {  0,  1,  0 }, {  1,  0,  0 }, { 0,  0,  1 } },
+		{ {  0, -1,  0 }, {  1,  0,  0 }, { 0,  0, -1 } },
+		{ {  0,  0,  1 }, {  1,  0,  0 }, { 0, -1,  0 } },
+		{ {  0,  0, -1 }, { -1,  0,  0 }, { 0, -1,  0 } },
+	};
+
+	std::vector<float> pixels(size_t(size) * size * 6 * 4, 1.0f);
+	for (auto f = 0u; f < 6; ++f)
+	{
+		for (auto y = 0u; y < size; ++y)
+		{
+			for (auto x = 0u; x < size; ++x)
+			{
+				auto s = 2.0f * (x + 0.5f) / size - 1.0f;
+				auto t = 2.0f * (y + 0.5f) / size - 1.0f;
+
+				float dir[3];
+				for (auto i = 0; i < 3; ++i)
+				{ dir[i] = faces[f][0][i] + faces[f][1][i] * s + faces[f][2][i] * t; }
+
+				auto invLen = 1.0f / sqrtf(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+				dir[0] *= invLen;
+				dir[1] *= invLen;
+				dir[2] *= invLen;
+				func(dir, &pixels[((size_t(f) * size + y) * size + x) * 4]);
+			}
+		}
+	}
+	return pixels;
+}
+
+//-----------------------------------------------------------------------------
+//      球面上にほぼ均等に並んだ検証用の方向を生成します.
+//-----------------------------------------------------------------------------
+std::vector<std::array<float, 3>> MakeDirections(uint32_t count)
+{
+	std::vector<std::array<float, 3>> dirs;
+	for (auto i = 0u; i < count; ++i)
+	{
+		auto z   = 1.0f - 2.0f * (i + 0.5f) / float(count);
+		auto r   = sqrtf(std::max(0.0f, 1.0f - z * z));
+		auto phi = 2.39996323f * float(i);
+		dirs.push_back({ { r * cosf(phi), z, r * sinf(phi) } });
+	}
+	return dirs;
+}
+
+//-----------------------------------------------------------------------------
+//      係数の絶対値の最大値を求めます.
+//-----------------------------------------------------------------------------
+float MaxCoeff(const SHProjector::SH9& sh)
+{
+	auto result = 0.0f;
+	for (auto k = 0u; k < SHProjector::CoeffCount; ++k)
+	{
+		for (auto c = 0; c < 3; ++c)
+		{ result = std::max(result, fabsf(sh.Coeffs[k][c])); }
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      係数の差の絶対値の最大値を求めます.
+//-----------------------------------------------------------------------------
+float DiffCoeff(const SHProjector::SH9& a, const SHProjector::SH9& b)
+{
+	auto result = 0.0f;
+	for (auto k = 0u; k < SHProjector::CoeffCount; ++k)
+	{
+		for (auto c = 0; c < 3; ++c)
+		{ result = std::max(result, fabsf(a.Coeffs[k][c] - b.Coeffs[k][c])); }
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      正距円筒図法からの射影と畳み込みを検証します.
+//-----------------------------------------------------------------------------
+void TestEquirect(const EnvFunc& env, float tolerance)
+{
+	auto pixels = MakeEquirect(Width, Height, env);
+
+	// SIMD・マルチスレッドの射影が倍精度の参照実装と一致すること.
+	SHProjector::SH9 simd, single, reference;
+	SHProjector::ProjectEquirect(pixels.data(), Width, Height, 8, simd);
+	SHProjector::ProjectEquirect(pixels.data(), Width, Height, 1, single);
+	SHProjector::ProjectEquirectReference(pixels.data(), Width, Height, reference);
+	CHECK(DiffCoeff(simd,   reference) <= 1e-4f * MaxCoeff(reference));
+	CHECK(DiffCoeff(single, reference) <= 1e-4f * MaxCoeff(reference));
+
+	// 畳み込んだ係数が総当たりの積分と一致すること. 3次までで表せる環境は誤差なく一致します.
+	// 誤差は暗い方向で相対的に大きくなるので, 最も明るい方向の値に対する割合で評価します.
+	SHProjector::ConvolveLambert(simd);
+
+	auto dirs = MakeDirections(26);
+	std::vector<std::array<float, 3>> expected(dirs.size()), actual(dirs.size());
+	auto scale = 0.0f;
+	for (size_t i = 0; i < dirs.size(); ++i)
+	{
+		SHProjector::IntegrateEquirectReference(pixels.data(), Width, Height, dirs[i].data(), expected[i].data());
+		SHProjector::Evaluate(simd, dirs[i].data(), actual[i].data());
+		for (auto c = 0; c < 3; ++c)
+		{ scale = std::max(scale, expected[i][c]); }
+	}
+
+	auto maxError = 0.0f;
+	for (size_t i = 0; i < dirs.size(); ++i)
+	{
+		for (auto c = 0; c < 3; ++c)
+		{ maxError = std::max(maxError, fabsf(actual[i][c] - expected[i][c]) / scale); }
+	}
+	CHECK(maxError <= tolerance);
+}
+
+//-----------------------------------------------------------------------------
+//      キューブマップからの射影を検証します.
+//-----------------------------------------------------------------------------
+void TestCube(const EnvFunc& env)
+{
+	// 参照実装と一致し, 同じ環境の正距円筒図法の結果とほぼ一致すること.
+	auto cube   = MakeCube(CubeSize, env);
+	auto pixels = MakeEquirect(Width, Height, env);
+
+	SHProjector::SH9 simd, single, reference, equirect;
+	SHProjector::ProjectCube(cube.data(), CubeSize, 0, simd);
+	SHProjector::ProjectCube(cube.data(), CubeSize, 1, single);
+	SHProjector::ProjectCubeReference(cube.data(), CubeSize, reference);
+	SHProjector::ProjectEquirectReference(pixels.data(), Width, Height, equirect);
+	CHECK(DiffCoeff(simd,      reference) <= 1e-4f * MaxCoeff(reference));
+	CHECK(DiffCoeff(single,    reference) <= 1e-4f * MaxCoeff(reference));
+	CHECK(DiffCoeff(reference, equirect)  <= 2e-2f * MaxCoeff(equirect));
+}
+
+//-----------------------------------------------------------------------------
+//      ランバートの畳み込みを解析解と比べて検証します.
+//-----------------------------------------------------------------------------
+void TestConvolveLambert()
+{
+	// 一定の環境では畳み込み後も同じ値になること.
+	{
+		auto pixels = MakeEquirect(Width, Height, ConstantEnv);
+		SHProjector::SH9 sh;
+		SHProjector::ProjectEquirect(pixels.data(), Width, Height, 0, sh);
+		SHProjector::ConvolveLambert(sh);
+
+		const float down[3] = { 0.0f, -1.0f, 0.0f };
+		float value[3];
+		SHProjector::Evaluate(sh, down, value);
+		CHECK(fabsf(value[0] - 0.5f) < 1e-3f);
+		CHECK(fabsf(value[1] - 1.0f) < 1e-3f);
+		CHECK(fabsf(value[2] - 2.0f) < 2e-3f);
+	}
+
+	// 1次の環境 a + b・d は a + (2/3) b・n になること.
+	{
+		auto pixels = MakeEquirect(Width, Height, LinearEnv);
+		SHProjector::SH9 sh;
+		SHProjector::ProjectEquirect(pixels.data(), Width, Height, 0, sh);
+		SHProjector::ConvolveLambert(sh);
+
+		for (const auto& dir : MakeDirections(26))
+		{
+			auto v = 1.0f + (2.0f / 3.0f) * (0.5f * dir[1] + 0.25f * dir[0] - 0.125f * dir[2]);
+
+			float value[3];
+			SHProjector::Evaluate(sh, dir.data(), value);
+			CHECK(fabsf(value[0] - v)        < 2e-3f);
+			CHECK(fabsf(value[1] - 2.0f * v) < 4e-3f);
+			CHECK(fabsf(value[2] - 0.5f * v) < 1e-3f);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      参照実装・SIMD・SIMD + マルチスレッドの射影時間を計測します.
+//-----------------------------------------------------------------------------
+void BenchmarkProject(uint32_t width, uint32_t height)
+{
+	// 内容は処理時間に影響しないので簡単な模様にします.
+	std::vector<float> pixels(size_t(width) * height * 4);
+	for (size_t i = 0; i < pixels.size(); ++i)
+	{ pixels[i] = float(uint32_t(i * 2654435761u) >> 24) / 255.0f; }
+
+	SHProjector::SH9 reference, single, multi;
+	auto timeReference = MeasureMilliSec([&]() { SHProjector::ProjectEquirectReference(pixels.data(), width, height, reference); });
+	auto timeSingle    = MeasureMilliSec([&]() { SHProjector::ProjectEquirect(pixels.data(), width, height, 1, single); });
+	auto timeMulti     = MeasureMilliSec([&]() { SHProjector::ProjectEquirect(pixels.data(), width, height, 0, multi); });
+
+	auto mpix = double(width) * height * 1e-6;
+	printf("%ux%u\n", width, height);
+	printf("Reference : %8.2f ms (%6.1f Mpix/s)\n", timeReference, mpix * 1000.0 / timeReference);
+	printf("SIMD      : %8.2f ms (%6.1f Mpix/s)\n", timeSingle,    mpix * 1000.0 / timeSingle);
+	printf("SIMD+MT   : %8.2f ms (%6.1f Mpix/s)\n", timeMulti,     mpix * 1000.0 / timeMulti);
+
+	// 射影結果が参照実装と一致していることも確認します.
+	CHECK(DiffCoeff(single, reference) <= 1e-4f * MaxCoeff(reference));
+	CHECK(DiffCoeff(multi,  reference) <= 1e-4f * MaxCoeff(reference));
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	TestEquirect(ConstantEnv, 1e-3f);
+	TestEquirect(LinearEnv,   2e-3f);
+	TestEquirect(SkyEnv,      5e-2f);
+	TestCube(ConstantEnv);
+	TestCube(LinearEnv);
+	TestCube(SkyEnv);
+	TestConvolveLambert();
+	if (IsBenchmark(argc, argv))
+	{ BenchmarkProject(4096, 2048); }
+	return TestReport("SHProjector");
+}
@@ -0,0 +1,286 @@
+﻿//-----------------------------------------------------------------------------
+// File : ShaderLibraryTest.cpp
+// Desc : Shader Library And Archive Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <ShaderLibrary.h>
+#include <RootSignature.h>
+#include <FileUtil.h>
+#include <d3dcompiler.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const char CodeA[] = "shader-a";
+const char CodeB[] = "shader-b-longer";
+
+//-----------------------------------------------------------------------------
+//      バイト列をファイルに書き出します.
+//-----------------------------------------------------------------------------
+bool WriteFile(const wchar_t* path, const void* pData, size_t size)
+{
+	std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+	if (!stream.is_open())
+	{ return false; }
+
+	stream.write(static_cast<const char*>(pData), std::streamsize(size));
+	return stream.good();
+}
+
+//-----------------------------------------------------------------------------
+//      ブロブの内容が一致するかどうかを調べます.
+//-----------------------------------------------------------------------------
+bool IsSame(const ComPtr<ID3DBlob>& pBlob, const void* pData, size_t size)
+{
+	return pBlob
+		&& pBlob->GetBufferSize() == size
+		&& memcmp(pBlob->GetBufferPointer(), pData, size) == 0;
+}
+
+//-----------------------------------------------------------------------------
+//      アーカイブの構築と解析を検証します.
+//-----------------------------------------------------------------------------
+void TestArchive()
+{
+	// 同じ内容は1つだけ格納され, 名前と内容が復元できること.
+	std::vector<ShaderLibrary::ArchiveItem> items = {
+		{ L"QuadVS.cso",  CodeA, sizeof(CodeA), 0 },
+		{ L"CopyVS.cso",  CodeA, sizeof(CodeA), 0 },
+		{ L"ToneMap.cso", CodeB, sizeof(CodeB), 0 },
+	};
+
+	std::vector<uint8_t> archive;
+	ShaderLibrary::BuildArchive(items, archive);
+
+	std::vector<ShaderLibrary::ArchiveItem> parsed;
+	CHECK(ShaderLibrary::ParseArchive(archive, parsed));
+	CHECK(parsed.size() == items.size());
+	for (size_t i = 0; i < parsed.size() && i < items.size(); ++i)
+	{
+		CHECK(parsed[i].Name == items[i].Name);
+		CHECK(parsed[i].Size == items[i].Size && memcmp(parsed[i].pData, items[i].pData, items[i].Size) == 0);
+		CHECK((static_cast<const uint8_t*>(parsed[i].pData) - archive.data()) % ShaderLibrary::DataAlignment == 0);
+	}
+	CHECK(parsed.size() == 3 && parsed[0].pData == parsed[1].pData && parsed[0].pData != parsed[2].pData);
+
+	// 壊れたデータは受け付けないこと.
+	auto broken = archive;
+	broken.back() ^= 0xFF;
+	CHECK(!ShaderLibrary::ParseArchive(broken, parsed));
+
+	broken = archive;
+	broken.pop_back();
+	CHECK(!ShaderLibrary::ParseArchive(broken, parsed));
+
+	broken = archive;
+	broken[4] ^= 0xFF;
+	CHECK(!ShaderLibrary::ParseArchive(broken, parsed));
+	CHECK(!ShaderLibrary::ParseArchive(std::vector<uint8_t>(), parsed));
+
+	ShaderLibrary::BuildArchive(std::vector<ShaderLibrary::ArchiveItem>(), broken);
+	CHECK(ShaderLibrary::ParseArchive(broken, parsed) && parsed.empty());
+}
+
+//-----------------------------------------------------------------------------
+//      アーカイブファイルを経由した読み込みを検証します.
+//-----------------------------------------------------------------------------
+void TestMountArchive()
+{
+	const wchar_t* path    = L"ShaderLibraryTest.bin";
+	const wchar_t* rewrite = L"ShaderLibraryTest2.bin";
+
+	std::vector<ShaderLibrary::ArchiveItem> items = {
+		{ L"QuadVS.cso",  CodeA, sizeof(CodeA), 0 },
+		{ L"CopyVS.cso",  CodeA, sizeof(CodeA), 0 },
+		{ L"ToneMap.cso", CodeB, sizeof(CodeB), 0 },
+	};
+
+	std::vector<uint8_t> archive;
+	ShaderLibrary::BuildArchive(items, archive);
+	CHECK(WriteFile(path, archive.data(), archive.size()));
+
+	// 個別のファイルを読まずにアーカイブから取り出し, 同じ内容は共有すること.
+	ShaderLibrary library;
+	CHECK(!library.HasArchive());
+	CHECK(library.MountArchive(path));
+	CHECK(library.HasArchive());
+
+	ComPtr<ID3DBlob> pQuad, pCopy, pToneMap, pAgain;
+	CHECK(library.Load(L"QuadVS.cso",  pQuad));
+	CHECK(library.Load(L"CopyVS.cso",  pCopy));
+	CHECK(library.Load(L"ToneMap.cso", pToneMap));
+	CHECK(library.Load(L"QuadVS.cso",  pAgain));
+	CHECK(IsSame(pQuad,    CodeA, sizeof(CodeA)));
+	CHECK(IsSame(pToneMap, CodeB, sizeof(CodeB)));
+	CHECK(pQuad.Get() == pCopy.Get() && pQuad.Get() == pAgain.Get());
+
+	const auto& stats = library.GetStats();
+	CHECK(stats.Requests    == 4);
+	CHECK(stats.ArchiveHits == 3);
+	CHECK(stats.NameHits    == 1);
+	CHECK(stats.Interned    == 1);
+	CHECK(stats.FileReads   == 0);
+	CHECK(stats.Bytes       == sizeof(CodeA) + sizeof(CodeB));
+
+	// 読み込み済みのシェーダを書き出したアーカイブから同じ内容が復元できること.
+	CHECK(library.WriteArchive(rewrite));
+
+	ShaderLibrary reloaded;
+	CHECK(reloaded.MountArchive(rewrite));
+
+	ComPtr<ID3DBlob> pBlob;
+	CHECK(reloaded.Load(L"CopyVS.cso",  pBlob) && IsSame(pBlob, CodeA, sizeof(CodeA)));
+	CHECK(reloaded.Load(L"ToneMap.cso", pBlob) && IsSame(pBlob, CodeB, sizeof(CodeB)));
+	CHECK(reloaded.GetStats().FileReads == 0);
+
+	// 壊れたアーカイブは読み込まないこと.
+	archive.back() ^= 0xFF;
+	CHECK(WriteFile(path, archive.data(), archive.size()));
+
+	ShaderLibrary broken;
+	CHECK(!broken.MountArchive(path));
+	CHECK(!broken.HasArchive());
+	CHECK(!broken.MountArchive(L"ShaderLibraryTestMissing.bin"));
+
+	_wremove(path);
+	_wremove(rewrite);
+}
+
+//-----------------------------------------------------------------------------
+//      ルートシグニチャの範囲外のリソースを検出することを検証します.
+//-----------------------------------------------------------------------------
+void TestValidateBindings()
+{
+	RootSignature::Desc desc;
+	desc.Begin(3)
+		.SetRootCBV(ShaderStage::VS, 0, 0)
+		.SetSRVRange(ShaderStage::PS, 1, 0, 4, 0)
+		.SetConstants(ShaderStage::ALL, 2, 1, 4)
+		.AddStaticSmp(ShaderStage::PS, 0, SamplerState::LinearWrap)
+		.AllowIL()
+		.End();
+
+	std::vector<ShaderLibrary::Binding> vs = {
+		{ "Transform", D3D_SIT_CBUFFER, 0, 1, 0 },
+		{ "Params",    D3D_SIT_CBUFFER, 1, 1, 0 },
+	};
+	std::vector<ShaderLibrary::Binding> ps = {
+		{ "Textures", D3D_SIT_TEXTURE, 1, 3, 0 },
+		{ "Sampler",  D3D_SIT_SAMPLER, 0, 1, 0 },
+		{ "Params",   D3D_SIT_CBUFFER, 1, 1, 0 },
+	};
+
+	std::vector<std::string> errors;
+	CHECK(ShaderLibrary::ValidateBindings(*desc.GetDesc(), D3D12_SHADER_VISIBILITY_VERTEX, vs, errors));
+	CHECK(ShaderLibrary::ValidateBindings(*desc.GetDesc(), D3D12_SHADER_VISIBILITY_PIXEL,  ps, errors));
+	CHECK(!ShaderLibrary::ValidateBindings(*desc.GetDesc(), D3D12_SHADER_VISIBILITY_PIXEL, vs, errors));
+	CHECK(errors.size() == 1);
+
+	ps.push_back({ "Overflow", D3D_SIT_TEXTURE,     3, 2, 0 });
+	ps.push_back({ "Output",   D3D_SIT_UAV_RWTYPED, 0, 1, 0 });
+	CHECK(!ShaderLibrary::ValidateBindings(*desc.GetDesc(), D3D12_SHADER_VISIBILITY_PIXEL, ps, errors));
+	CHECK(errors.size() == 2);
+}
+
+//-----------------------------------------------------------------------------
+//      多数のレンダラーを初期化する場合のシェーダ読み込み時間を比較します.
+//-----------------------------------------------------------------------------
+void BenchmarkLoad(uint32_t renderers)
+{
+	// サンプルのレンダラーと同じく, 9組のシェーダを 18KB 程度のダミーで用意します.
+	const wchar_t* names[] = {
+		L"BenchVS0.cso", L"BenchVS1.cso", L"BenchVS2.cso", L"BenchVS3.cso",
+		L"BenchPS0.cso", L"BenchPS1.cso", L"BenchPS2.cso", L"BenchPS3.cso", L"BenchPS4.cso",
+	};
+	const uint32_t nameCount = uint32_t(sizeof(names) / sizeof(names[0]));
+	const uint32_t pairCount = 9;
+
+	for (auto i = 0u; i < nameCount; ++i)
+	{
+		std::vector<uint8_t> code(18 * 1024, uint8_t(i + 1));
+		CHECK(WriteFile(names[i], code.data(), code.size()));
+	}
+
+	auto measure = [&](const std::function<bool(const std::wstring&)>& load)
+	{
+		return MeasureMilliSec([&]()
+		{
+			for (auto i = 0u; i < renderers; ++i)
+			{
+				auto pair = i % pairCount;
+				CHECK(load(names[pair % 4]));
+				CHECK(load(names[4 + pair % 5]));
+			}
+		});
+	};
+
+	// 従来通りレンダラーごとにファイルを探して読み込む.
+	auto reads = 0u;
+	auto perFile = measure([&reads](const std::wstring& name)
+	{
+		std::wstring path;
+		ComPtr<ID3DBlob> pBlob;
+		if (!SearchFilePath(name.c_str(), path))
+		{ return false; }
+		reads++;
+		return SUCCEEDED(D3DReadFileToBlob(path.c_str(), pBlob.GetAddressOf()));
+	});
+	printf("Per File : %8.3f ms (%u reads)\n", perFile, reads);
+
+	// ライブラリ経由では同じファイルを1度だけ読み込む.
+	ShaderLibrary library;
+	auto cached = measure([&library](const std::wstring& name)
+	{
+		ComPtr<ID3DBlob> pBlob;
+		return library.Load(name, pBlob);
+	});
+	printf("Library  : %8.3f ms (%u reads)\n", cached, library.GetStats().FileReads);
+	CHECK(library.GetStats().FileReads == nameCount);
+
+	// アーカイブからは1回の読み込みで全てのシェーダを取り出す.
+	const wchar_t* archivePath = L"ShaderLibraryBench.bin";
+	CHECK(library.WriteArchive(archivePath));
+
+	ShaderLibrary archived;
+	auto mounted = measure([&archived, archivePath](const std::wstring& name)
+	{
+		if (!archived.HasArchive())
+		{ archived.MountArchive(archivePath); }
+		ComPtr<ID3DBlob> pBlob;
+		return archived.Load(name, pBlob);
+	});
+	printf("Archive  : %8.3f ms (%u reads)\n", mounted, archived.GetStats().FileReads + (archived.HasArchive() ? 1 : 0));
+	CHECK(archived.GetStats().FileReads == 0);
+
+	_wremove(archivePath);
+	for (auto name : names)
+	{ _wremove(name); }
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	TestArchive();
+	TestMountArchive();
+	TestValidateBindings();
+	if (IsBenchmark(argc, argv))
+	{ BenchmarkLoad(64); }
+	return TestReport("ShaderLibrary");
+}
@@ -0,0 +1,360 @@
+﻿//-----------------------------------------------------------------------------
+// File : ShadowCacheTest.cpp
+// Desc : Static Shadow Cache Invalidation Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <ShadowCache.h>
+#include <vector>
+
+using namespace DirectX;
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const uint32_t TileSize = 1024;
+const XMFLOAT3 Extent(0.5f, 0.5f, 0.5f);
+
+//-----------------------------------------------------------------------------
+//      立っているビット数を求めます.
+//-----------------------------------------------------------------------------
+uint32_t CountBits(uint64_t mask)
+{
+	auto count = 0u;
+	for (; mask != 0; mask &= mask - 1)
+	{ count++; }
+	return count;
+}
+
+//-----------------------------------------------------------------------------
+//      真上から 32x32 の範囲を投影するカスケードを生成します. 1つの領域は 4x4 になります.
+//-----------------------------------------------------------------------------
+CascadedShadow::Cascade MakeCascade(float eyeX)
+{
+	auto eye  = XMVectorSet(eyeX, 50.0f, 0.0f, 0.0f);
+	auto at   = XMVectorSet(eyeX,  0.0f, 0.0f, 0.0f);
+	auto view = XMMatrixLookAtLH(eye, at, XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f));
+	auto proj = XMMatrixOrthographicOffCenterLH(-16.0f, 16.0f, -16.0f, 16.0f, 0.0f, 100.0f);
+
+	CascadedShadow::Cascade cascade = {};
+	XMStoreFloat4x4(&cascade.ViewProj, XMMatrixMultiply(view, proj));
+	return cascade;
+}
+
+//-----------------------------------------------------------------------------
+//      平行移動行列を生成します.
+//-----------------------------------------------------------------------------
+XMFLOAT4X4 MakeWorld(const XMFLOAT3& position)
+{
+	XMFLOAT4X4 result;
+	XMStoreFloat4x4(&result, XMMatrixTranslation(position.x, position.y, position.z));
+	return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Scene structure
+///////////////////////////////////////////////////////////////////////////////
+struct Scene
+{
+	ShadowCache                 Cache;          //!< シャドウキャッシュです.
+	CascadedShadow::Cascade     Cascade;        //!< カスケードです.
+	std::vector<XMFLOAT3>       Positions;      //!< 遮蔽物の位置です.
+	std::vector<uint32_t>       Visible;        //!< 可視な遮蔽物の番号です.
+	std::vector<uint32_t>       StaticDraws;    //!< キャッシュに描画する遮蔽物の番号です.
+	std::vector<uint32_t>       DynamicDraws;   //!< 重ねて描画する遮蔽物の番号です.
+
+	//-------------------------------------------------------------------------
+	//! @brief      4x4 個の遮蔽物を別々の領域に並べます.
+	//-------------------------------------------------------------------------
+	Scene()
+	: Cascade(MakeCascade(0.0f))
+	{
+		for (auto z = 0; z < 4; ++z)
+		{
+			for (auto x = 0; x < 4; ++x)
+			{ Positions.push_back(XMFLOAT3(-14.0f + 8.0f * x, 0.0f, -14.0f + 8.0f * z)); }
+		}
+		Cache.SetSettleFrames(3);
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      1フレーム分の更新を行います.
+	//!
+	//! @param[in]      count       遮蔽物の数です.
+	//! @param[in]      submit      フレームを提出したとみなす場合は true を指定します.
+	//-------------------------------------------------------------------------
+	ShadowCache::Stats Frame(uint32_t count, bool submit = true)
+	{
+		Cache.BeginFrame(&Cascade, 1, TileSize);
+		for (auto i = 0u; i < count; ++i)
+		{ Cache.UpdateCaster(i, MakeWorld(Positions[i]), Positions[i], Extent); }
+		Cache.EndUpdate(count);
+
+		Visible.resize(count);
+		for (auto i = 0u; i < count; ++i)
+		{ Visible[i] = i; }
+		Cache.BuildDrawList(0, Visible, StaticDraws, DynamicDraws);
+
+		auto stats = Cache.GetStats();
+		if (submit)
+		{ Cache.CommitFrame(); }
+		return stats;
+	}
+
+	//-------------------------------------------------------------------------
+	//! @brief      遮蔽物の数を取得します.
+	//-------------------------------------------------------------------------
+	uint32_t Count() const
+	{ return uint32_t(Positions.size()); }
+};
+
+//-----------------------------------------------------------------------------
+//      ワールド空間のAABBが掛かる領域の判定を検証します.
+//-----------------------------------------------------------------------------
+void TestRegionMask()
+{
+	const auto vp = MakeCascade(0.0f).ViewProj;
+
+	CHECK(CountBits(ShadowCache::CalcRegionMask(vp, XMFLOAT3(2.0f, 0.0f, 2.0f), Extent)) == 1);
+	CHECK(CountBits(ShadowCache::CalcRegionMask(vp, XMFLOAT3(4.0f, 0.0f, 2.0f), Extent)) == 2);
+	CHECK(ShadowCache::CalcRegionMask(vp, XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)) == ((3ull << 27) | (3ull << 35)));
+	CHECK(ShadowCache::CalcRegionMask(vp, XMFLOAT3(100.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f)) == 0);
+	CHECK(ShadowCache::CalcRegionMask(vp, XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(20.0f, 1.0f, 20.0f)) == ~0ull);
+}
+
+//-----------------------------------------------------------------------------
+//      初回はカスケード全体を描き, 静止していれば次のフレームから何も描かないことを検証します.
+//-----------------------------------------------------------------------------
+void TestStillScene()
+{
+	Scene scene;
+	const auto n = scene.Count();
+
+	auto stats = scene.Frame(n);
+	CHECK(stats.InvalidCascades == 1 && stats.DirtyRegions == 64 && stats.StaticDraws == n && stats.DynamicDraws == 0);
+
+	stats = scene.Frame(n, false);
+	CHECK(stats.InvalidCascades == 0 && stats.DirtyRegions == 0 && stats.StaticDraws == 0 && stats.DynamicDraws == 0);
+	CHECK(stats.UncachedDraws == n && stats.StaticCasters == n);
+	CHECK(scene.Cache.GetDirtyRect(0).Left == scene.Cache.GetDirtyRect(0).Right);
+	CHECK(!scene.Cache.NeedsCopy());
+}
+
+//-----------------------------------------------------------------------------
+//      動いた遮蔽物は動的になり, 動く前の領域だけを描き直すことを検証します.
+//-----------------------------------------------------------------------------
+void TestMovingCaster()
+{
+	Scene scene;
+	const auto n = scene.Count();
+	scene.Frame(n);
+	scene.Frame(n);
+
+	auto oldMask = ShadowCache::CalcRegionMask(scene.Cascade.ViewProj, scene.Positions[5], Extent);
+	scene.Positions[5].x += 0.25f;
+
+	auto stats = scene.Frame(n, false);
+	const auto& rect = scene.Cache.GetDirtyRect(0);
+	CHECK(!scene.Cache.IsStatic(5) && stats.DynamicCasters == 1 && stats.DynamicDraws == 1 && scene.DynamicDraws[0] == 5);
+	CHECK(scene.Cache.GetDirtyMask(0) == oldMask && stats.DirtyRegions == 1 && stats.StaticDraws == 0);
+	CHECK(rect.Right - rect.Left == 128 && rect.Bottom - rect.Top == 128);
+	scene.Cache.CommitFrame();
+
+	// 止まってもしばらくは動的なまま.
+	for (auto i = 0; i < 2; ++i)
+	{
+		stats = scene.Frame(n);
+		CHECK(!scene.Cache.IsStatic(5) && stats.DynamicDraws == 1 && stats.DirtyRegions == 0);
+	}
+
+	// 静的に戻るフレームで現在の領域を描き直すこと.
+	stats = scene.Frame(n, false);
+	CHECK(scene.Cache.IsStatic(5) && stats.DynamicDraws == 0 && stats.StaticDraws == 1 && scene.StaticDraws[0] == 5);
+	CHECK(scene.Cache.GetDirtyMask(0) == ShadowCache::CalcRegionMask(scene.Cascade.ViewProj, scene.Positions[5], Extent));
+	scene.Cache.CommitFrame();
+
+	stats = scene.Frame(n);
+	CHECK(stats.StaticDraws == 0 && stats.DynamicDraws == 0);
+}
+
+//-----------------------------------------------------------------------------
+//      ライトが変わるとカスケード全体を描き直すことを検証します.
+//-----------------------------------------------------------------------------
+void TestLightChange()
+{
+	Scene scene;
+	const auto n = scene.Count();
+	scene.Frame(n);
+	scene.Frame(n);
+
+	scene.Cascade = MakeCascade(0.5f);
+	auto stats = scene.Frame(n);
+	CHECK(stats.InvalidCascades == 1 && stats.StaticDraws == n);
+
+	stats = scene.Frame(n);
+	CHECK(stats.InvalidCascades == 0 && stats.StaticDraws == 0);
+}
+
+//-----------------------------------------------------------------------------
+//      削除された遮蔽物の領域と, 無効にした次のフレームの全体を描き直すことを検証します.
+//-----------------------------------------------------------------------------
+void TestRemoveAndInvalidate()
+{
+	Scene scene;
+	const auto n = scene.Count();
+	scene.Frame(n);
+	scene.Frame(n);
+
+	auto removedMask = ShadowCache::CalcRegionMask(scene.Cascade.ViewProj, scene.Positions[n - 1], Extent);
+	auto stats = scene.Frame(n - 1, false);
+	CHECK(scene.Cache.GetDirtyMask(0) == removedMask && stats.StaticDraws == 0 && stats.UncachedDraws == n - 1);
+	scene.Cache.CommitFrame();
+
+	scene.Cache.Invalidate();
+	stats = scene.Frame(n - 1);
+	CHECK(stats.InvalidCascades == 1 && stats.StaticDraws == n - 1);
+}
+
+//-----------------------------------------------------------------------------
+//      提出しなかったフレームの描き直す範囲が次のフレームに残ることを検証します.
+//-----------------------------------------------------------------------------
+void TestUncommittedFrame()
+{
+	Scene scene;
+	const auto n = scene.Count();
+
+	// 初回のフレームを提出しなければ, 次のフレームも全体を描き直すこと.
+	scene.Frame(n, false);
+	auto stats = scene.Frame(n);
+	CHECK(stats.DirtyRegions == 64 && stats.StaticDraws == n);
+
+	// 動き始めた遮蔽物の範囲は, 提出するまで描き直すこと.
+	auto oldMask = ShadowCache::CalcRegionMask(scene.Cascade.ViewProj, scene.Positions[5], Extent);
+	scene.Positions[5].x += 0.25f;
+	scene.Frame(n, false);
+	CHECK(scene.Cache.NeedsCopy());
+
+	stats = scene.Frame(n, false);
+	CHECK(scene.Cache.GetDirtyMask(0) == oldMask && stats.DirtyRegions == 1);
+	scene.Cache.CommitFrame();
+
+	stats = scene.Frame(n, false);
+	CHECK(scene.Cache.GetDirtyMask(0) == 0 && stats.DirtyRegions == 0);
+}
+
+//-----------------------------------------------------------------------------
+//      アトラスへの複製が必要なフレームの判定を検証します.
+//-----------------------------------------------------------------------------
+void TestNeedsCopy()
+{
+	Scene scene;
+	const auto n = scene.Count();
+
+	// 初回は全体を描き直すので複製する.
+	scene.Frame(n, false);
+	CHECK(scene.Cache.NeedsCopy());
+	scene.Cache.CommitFrame();
+
+	// 静止していればアトラスはキャッシュと同じ内容.
+	scene.Frame(n, false);
+	CHECK(!scene.Cache.NeedsCopy());
+	scene.Cache.CommitFrame();
+
+	// 動的な遮蔽物を重ねた次のフレームは, 描き直す範囲がなくても複製して消す.
+	scene.Positions[5].x += 0.25f;
+	scene.Frame(n);
+	for (auto i = 0; i < 2; ++i)
+	{
+		auto stats = scene.Frame(n, false);
+		CHECK(stats.DirtyRegions == 0 && stats.DynamicDraws == 1 && scene.Cache.NeedsCopy());
+		scene.Cache.CommitFrame();
+	}
+
+	// 静的に戻った後は, 最後に重ねたフレームの次だけ複製する.
+	scene.Frame(n);
+	scene.Frame(n, false);
+	CHECK(!scene.Cache.NeedsCopy());
+}
+
+//-----------------------------------------------------------------------------
+//      静止したシーンではキャッシュ後に描画しないことを検証します.
+//-----------------------------------------------------------------------------
+void TestStaticScene(bool print)
+{
+	ShadowCache cache;
+	CascadedShadow::Cascade cascades[CascadedShadow::MaxCascadeCount];
+	for (auto& c : cascades)
+	{ c = MakeCascade(0.5f); }
+
+	std::vector<XMFLOAT3> grid;
+	for (auto z = 0; z < 16; ++z)
+	{
+		for (auto x = 0; x < 16; ++x)
+		{ grid.push_back(XMFLOAT3(-15.0f + 2.0f * x, 0.0f, -15.0f + 2.0f * z)); }
+	}
+
+	std::vector<uint32_t> visible(grid.size());
+	std::vector<uint32_t> staticDraws;
+	std::vector<uint32_t> dynamicDraws;
+	for (auto i = 0u; i < uint32_t(grid.size()); ++i)
+	{ visible[i] = i; }
+
+	const auto frames = 60u;
+	uint64_t uncached = 0;
+	uint64_t cached   = 0;
+	auto time = MeasureMilliSec([&]()
+	{
+		for (auto f = 0u; f < frames; ++f)
+		{
+			cache.BeginFrame(cascades, CascadedShadow::MaxCascadeCount, TileSize);
+			for (auto i = 0u; i < uint32_t(grid.size()); ++i)
+			{ cache.UpdateCaster(i, MakeWorld(grid[i]), grid[i], Extent); }
+			cache.EndUpdate(uint32_t(grid.size()));
+			for (auto c = 0u; c < CascadedShadow::MaxCascadeCount; ++c)
+			{ cache.BuildDrawList(c, visible, staticDraws, dynamicDraws); }
+
+			const auto& stats = cache.GetStats();
+			uncached += stats.UncachedDraws;
+			cached   += stats.StaticDraws + stats.DynamicDraws;
+			if (f > 0)
+			{ CHECK(stats.StaticDraws + stats.DynamicDraws == 0); }
+
+			cache.CommitFrame();
+		}
+	});
+
+	CHECK(uncached == uint64_t(frames) * grid.size() * CascadedShadow::MaxCascadeCount);
+	CHECK(cached == grid.size() * CascadedShadow::MaxCascadeCount);
+
+	if (print)
+	{
+		printf("Static : %.1f draws/frame uncached -> %.1f cached, update %.3f ms/frame\n",
+			double(uncached) / frames, double(cached) / frames, time / frames);
+	}
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	TestRegionMask();
+	TestStillScene();
+	TestMovingCaster();
+	TestLightChange();
+	TestRemoveAndInvalidate();
+	TestUncommittedFrame();
+	TestNeedsCopy();
+	TestStaticScene(IsBenchmark(argc, argv));
+	return TestReport("ShadowCache");
+}
@@ -0,0 +1,55 @@
+﻿//-----------------------------------------------------------------------------
+// File : TestDevice.h
+// Desc : Test Device Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <d3d12.h>
+#include <dxgi1_4.h>
+#include <ComPtr.h>
+#include <DescriptorPool.h>
+
+//-----------------------------------------------------------------------------
+//! @brief      WARP アダプタでデバイスを生成します.
+//!
+//! @param[out]     ppDevice    デバイスの格納先です.
+//! @retval true    生成に成功.
+//! @retval false   生成に失敗.
+//! @note       GPU の無い環境でも同じ結果になるようにソフトウェア実装を使います.
+//-----------------------------------------------------------------------------
+inline bool CreateTestDevice(ID3D12Device** ppDevice)
+{
+	ComPtr<IDXGIFactory4> pFactory;
+	if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(pFactory.GetAddressOf()))))
+	{ return false; }
+
+	ComPtr<IDXGIAdapter> pAdapter;
+	if (FAILED(pFactory->EnumWarpAdapter(IID_PPV_ARGS(pAdapter.GetAddressOf()))))
+	{ return false; }
+
+	return SUCCEEDED(D3D12CreateDevice(pAdapter.Get(), D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(ppDevice)));
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      CBV_SRV_UAV 用のディスクリプタプールを生成します.
+//!
+//! @param[in]      pDevice     デバイスです.
+//! @param[in]      count       ディスクリプタ数です.
+//! @param[out]     ppPool      ディスクリプタプールの格納先です.
+//! @retval true    生成に成功.
+//! @retval false   生成に失敗.
+//-----------------------------------------------------------------------------
+inline bool CreateTestPool(ID3D12Device* pDevice, uint32_t count, DescriptorPool** ppPool)
+{
+	D3D12_DESCRIPTOR_HEAP_DESC desc = {};
+	desc.Type           = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+	desc.NumDescriptors = count;
+	desc.Flags          = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+	desc.NodeMask       = 1;
+
+	return DescriptorPool::Create(pDevice, &desc, ppPool);
+}
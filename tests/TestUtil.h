@@ -0,0 +1,101 @@
+﻿//-----------------------------------------------------------------------------
+// File : TestUtil.h
+// Desc : Test Utility Module.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+
+///////////////////////////////////////////////////////////////////////////////
+// TestResult structure
+///////////////////////////////////////////////////////////////////////////////
+struct TestResult
+{
+	uint32_t    Cases    = 0;   //!< 検証数です.
+	uint32_t    Failures = 0;   //!< 条件を満たさなかった数です.
+
+	//-------------------------------------------------------------------------
+	//! @brief      プロセスで共有する結果を取得します.
+	//-------------------------------------------------------------------------
+	static TestResult& GetInstance()
+	{
+		static TestResult s_Result;
+		return s_Result;
+	}
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      条件を検証します.
+//!
+//! @param[in]      pass        条件を満たしたかどうか.
+//! @param[in]      expr        条件式です.
+//! @param[in]      file        ファイル名です.
+//! @param[in]      line        行番号です.
+//-----------------------------------------------------------------------------
+inline void TestCheck(bool pass, const char* expr, const char* file, int line)
+{
+	auto& result = TestResult::GetInstance();
+	result.Cases++;
+	if (!pass)
+	{
+		result.Failures++;
+		printf("[File : %s, Line : %d] Check Failed : %s\n", file, line, expr);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      結果を出力します.
+//!
+//! @param[in]      name        テスト名です.
+//! @return     全て満たした場合は 0 を返却します.
+//-----------------------------------------------------------------------------
+inline int TestReport(const char* name)
+{
+	const auto& result = TestResult::GetInstance();
+	printf("%s : %u / %u passed\n", name, result.Cases - result.Failures, result.Cases);
+	return (result.Failures == 0) ? 0 : 1;
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      計測も実行するかどうか.
+//!
+//! @param[in]      argc        引数の数です.
+//! @param[in]      argv        引数です.
+//! @return     引数に --bench があれば true を返却します.
+//-----------------------------------------------------------------------------
+inline bool IsBenchmark(int argc, char** argv)
+{
+	for (auto i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--bench") == 0)
+		{ return true; }
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      関数の実行時間を計測します.
+//!
+//! @param[in]      func        計測する関数です.
+//! @return     実行時間(ミリ秒)を返却します.
+//-----------------------------------------------------------------------------
+template<typename Func>
+inline double MeasureMilliSec(Func func)
+{
+	auto t0 = std::chrono::high_resolution_clock::now();
+	func();
+	auto t1 = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+//-----------------------------------------------------------------------------
+// Macros
+//-----------------------------------------------------------------------------
+#define CHECK( x ) TestCheck( (x), #x, __FILE__, __LINE__ )
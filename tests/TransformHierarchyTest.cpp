@@ -0,0 +1,276 @@
+﻿//-----------------------------------------------------------------------------
+// File : TransformHierarchyTest.cpp
+// Desc : Hierarchical Transform Test.
+// Copyright(c) Pocol. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <TestUtil.h>
+#include <TransformHierarchy.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace DirectX;
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+const float Tolerance = 1.0e-5f;
+
+//-----------------------------------------------------------------------------
+//      Y 軸まわりの回転を表すクォータニオンを生成します.
+//-----------------------------------------------------------------------------
+XMFLOAT4 RotationY(float degree)
+{
+	auto half = XMConvertToRadians(degree) * 0.5f;
+	return XMFLOAT4(0.0f, std::sin(half), 0.0f, std::cos(half));
+}
+
+//-----------------------------------------------------------------------------
+//      ワールド行列の平行移動成分が指定した位置かどうかを調べます.
+//-----------------------------------------------------------------------------
+bool IsAt(const TransformHierarchy& hierarchy, uint32_t node, float x, float y, float z)
+{
+	const auto& m = hierarchy.GetWorld(node);
+	return std::abs(m._41 - x) < Tolerance
+		&& std::abs(m._42 - y) < Tolerance
+		&& std::abs(m._43 - z) < Tolerance;
+}
+
+//-----------------------------------------------------------------------------
+//      全てのノードのワールド行列と参照実装との最大誤差を求めます.
+//-----------------------------------------------------------------------------
+float ComputeMaxError(const TransformHierarchy& hierarchy)
+{
+	std::vector<XMFLOAT4X4> reference;
+	hierarchy.ComputeReference(reference);
+
+	auto result = 0.0f;
+	for (auto node = 0u; node < hierarchy.GetCapacity(); ++node)
+	{
+		if (!hierarchy.IsValid(node))
+		{ continue; }
+
+		const float* a = &hierarchy.GetWorld(node)._11;
+		const float* b = &reference[node]._11;
+		for (auto i = 0; i < 16; ++i)
+		{ result = std::max(result, std::abs(a[i] - b[i])); }
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//      親の回転・拡大率・位置が子に伝わることを検証します.
+//-----------------------------------------------------------------------------
+void TestWorldMatrices()
+{
+	TransformHierarchy hierarchy;
+	auto root  = hierarchy.Create();
+	auto child = hierarchy.Create(root);
+	auto leaf  = hierarchy.Create(child);
+
+	// Y 軸まわりに 90 度回すと, 子の +Z は +X になる.
+	hierarchy.SetLocal(root, XMFLOAT3(1.0f, 0.0f, 0.0f), RotationY(90.0f), XMFLOAT3(2.0f, 2.0f, 2.0f));
+	hierarchy.SetPosition(child, XMFLOAT3(0.0f, 0.0f, 1.0f));
+	hierarchy.SetPosition(leaf,  XMFLOAT3(0.0f, 1.0f, 0.0f));
+	CHECK(hierarchy.Update() == 3);
+
+	CHECK(IsAt(hierarchy, root,  1.0f, 0.0f, 0.0f));
+	CHECK(IsAt(hierarchy, child, 3.0f, 0.0f, 0.0f));
+	CHECK(IsAt(hierarchy, leaf,  3.0f, 2.0f, 0.0f));
+	CHECK(ComputeMaxError(hierarchy) < Tolerance);
+
+	// 変更が無ければ何も計算しない.
+	CHECK(hierarchy.Update() == 0);
+
+	// 葉だけの変更は葉だけを計算する.
+	hierarchy.SetPosition(leaf, XMFLOAT3(0.0f, 0.0f, 0.0f));
+	CHECK(hierarchy.Update() == 1);
+	CHECK(IsAt(hierarchy, leaf, 3.0f, 0.0f, 0.0f));
+
+	// 親の変更は部分木全体を計算する.
+	hierarchy.SetRotation(root, RotationY(0.0f));
+	CHECK(hierarchy.Update() == 3);
+	CHECK(IsAt(hierarchy, child, 1.0f, 0.0f, 2.0f));
+	CHECK(ComputeMaxError(hierarchy) < Tolerance);
+}
+
+//-----------------------------------------------------------------------------
+//      親の付け替えを検証します.
+//-----------------------------------------------------------------------------
+void TestReparent()
+{
+	TransformHierarchy hierarchy;
+	auto a  = hierarchy.Create();
+	auto b  = hierarchy.Create();
+	auto a1 = hierarchy.Create(a);
+	auto a2 = hierarchy.Create(a1);
+	hierarchy.SetPosition(a,  XMFLOAT3( 10.0f, 0.0f, 0.0f));
+	hierarchy.SetPosition(b,  XMFLOAT3(-10.0f, 0.0f, 0.0f));
+	hierarchy.SetPosition(a1, XMFLOAT3(  0.0f, 1.0f, 0.0f));
+	hierarchy.SetPosition(a2, XMFLOAT3(  0.0f, 0.0f, 1.0f));
+	hierarchy.Update();
+	CHECK(IsAt(hierarchy, a2, 10.0f, 1.0f, 1.0f));
+
+	// 自分自身や子孫は親にできない.
+	CHECK(!hierarchy.SetParent(a,  a));
+	CHECK(!hierarchy.SetParent(a,  a2));
+	CHECK(hierarchy.GetParent(a) == TransformHierarchy::NullNode);
+
+	// 部分木ごと付け替わり, 子孫のワールド行列も新しい親に従う.
+	CHECK(hierarchy.SetParent(a1, b));
+	CHECK(hierarchy.GetParent(a1) == b);
+	CHECK(hierarchy.GetParent(a2) == a1);
+	hierarchy.Update();
+	CHECK(IsAt(hierarchy, a1, -10.0f, 1.0f, 0.0f));
+	CHECK(IsAt(hierarchy, a2, -10.0f, 1.0f, 1.0f));
+	CHECK(IsAt(hierarchy, a,   10.0f, 0.0f, 0.0f));
+	CHECK(ComputeMaxError(hierarchy) < Tolerance);
+
+	// 親を外すとローカルの値がそのままワールドになる.
+	CHECK(hierarchy.SetParent(a1, TransformHierarchy::NullNode));
+	hierarchy.Update();
+	CHECK(IsAt(hierarchy, a1, 0.0f, 1.0f, 0.0f));
+	CHECK(IsAt(hierarchy, a2, 0.0f, 1.0f, 1.0f));
+	CHECK(ComputeMaxError(hierarchy) < Tolerance);
+}
+
+//-----------------------------------------------------------------------------
+//      ノードの破棄を検証します.
+//-----------------------------------------------------------------------------
+void TestDestroy()
+{
+	TransformHierarchy hierarchy;
+	auto root  = hierarchy.Create();
+	auto child = hierarchy.Create(root);
+	auto leaf  = hierarchy.Create(child);
+	auto other = hierarchy.Create();
+	CHECK(hierarchy.GetCount() == 4);
+
+	// 子孫もまとめて破棄する.
+	hierarchy.Destroy(child);
+	CHECK(hierarchy.GetCount() == 2);
+	CHECK(hierarchy.IsValid(root) && hierarchy.IsValid(other));
+	CHECK(!hierarchy.IsValid(child) && !hierarchy.IsValid(leaf));
+
+	// 無効な親を指定するとルートになる.
+	auto orphan = hierarchy.Create(leaf);
+	CHECK(hierarchy.GetParent(orphan) == TransformHierarchy::NullNode);
+
+	hierarchy.SetPosition(root, XMFLOAT3(1.0f, 2.0f, 3.0f));
+	hierarchy.Update();
+	CHECK(IsAt(hierarchy, root, 1.0f, 2.0f, 3.0f));
+	CHECK(ComputeMaxError(hierarchy) < Tolerance);
+}
+
+//-----------------------------------------------------------------------------
+//      ランダムな変更と付け替えの後のワールド行列を検証します.
+//-----------------------------------------------------------------------------
+void TestRandomEdits()
+{
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+
+	TransformHierarchy hierarchy;
+	std::vector<uint32_t> nodes;
+	for (auto i = 0u; i < 500; ++i)
+	{
+		auto parent = (i == 0) ? TransformHierarchy::NullNode : nodes[rng() % nodes.size()];
+		auto node   = hierarchy.Create(parent);
+		hierarchy.SetLocal(node, XMFLOAT3(offset(rng), offset(rng), offset(rng)), RotationY(angle(rng)), XMFLOAT3(1.0f, 1.0f, 1.0f));
+		nodes.push_back(node);
+	}
+	hierarchy.Update();
+	CHECK(ComputeMaxError(hierarchy) < Tolerance);
+
+	for (auto round = 0; round < 10; ++round)
+	{
+		for (auto i = 0; i < 20; ++i)
+		{ hierarchy.SetPosition(nodes[rng() % nodes.size()], XMFLOAT3(offset(rng), offset(rng), offset(rng))); }
+
+		// 子孫を親にする付け替えは拒否され, 階層は壊れない.
+		for (auto i = 0; i < 5; ++i)
+		{ hierarchy.SetParent(nodes[rng() % nodes.size()], nodes[rng() % nodes.size()]); }
+
+		hierarchy.Update();
+		CHECK(ComputeMaxError(hierarchy) < Tolerance);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//      変更の割合ごとの更新時間を計測します.
+//-----------------------------------------------------------------------------
+void BenchmarkUpdate(uint32_t count)
+{
+	const float       ratios[] = { 0.01f, 0.1f, 1.0f };
+	const char* const shapes[] = { "Deep", "Wide" };
+
+	for (auto shape = 0; shape < 2; ++shape)
+	{
+		std::mt19937 rng(12345);
+		std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+
+		TransformHierarchy hierarchy;
+		hierarchy.Reserve(count);
+
+		// 深い: 深さ1000の鎖を並べる. 広い: 1000個の子がそれぞれ葉を持つ.
+		std::vector<uint32_t> nodes;
+		nodes.reserve(count);
+		for (auto i = 0u; i < count; ++i)
+		{
+			auto parent = TransformHierarchy::NullNode;
+			if (shape == 0)
+			{
+				if (i % 1000 != 0)
+				{ parent = nodes[i - 1]; }
+			}
+			else if (i > 0)
+			{ parent = (i <= 1000) ? nodes[0] : nodes[1 + (i - 1001) % 1000]; }
+
+			auto node = hierarchy.Create(parent);
+			hierarchy.SetLocal(node, XMFLOAT3(offset(rng), offset(rng), offset(rng)), RotationY(offset(rng) * 180.0f), XMFLOAT3(1.0f, 1.0f, 1.0f));
+			nodes.push_back(node);
+		}
+		hierarchy.Update();
+
+		for (auto ratio : ratios)
+		{
+			auto dirty = std::max(1u, uint32_t(float(count) * ratio));
+			for (auto i = 0u; i < dirty; ++i)
+			{
+				auto node = (ratio < 1.0f) ? nodes[rng() % count] : nodes[i];
+				hierarchy.SetPosition(node, XMFLOAT3(offset(rng), offset(rng), offset(rng)));
+			}
+
+			uint32_t recomputed = 0;
+			auto time = MeasureMilliSec([&]() { recomputed = hierarchy.Update(); });
+			printf("%s %3.0f%% : %8.3f ms (%u nodes)\n", shapes[shape], ratio * 100.0f, time, recomputed);
+		}
+
+		CHECK(ComputeMaxError(hierarchy) < 1.0e-3f);
+	}
+}
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	TestWorldMatrices();
+	TestReparent();
+	TestDestroy();
+	TestRandomEdits();
+	if (IsBenchmark(argc, argv))
+	{ BenchmarkUpdate(100000); }
+	return TestReport("TransformHierarchy");
+}